@@ -39,8 +39,14 @@
 typedef struct {
   int id;
   guint32 tag;
+  gint64 sent_time;
 } BroadwayOutstandingRoundtrip;
 
+typedef struct {
+  BroadwayServer *server;
+  BroadwayInputMsg msg;
+} BroadwayDelayedRoundtrip;
+
 typedef struct BroadwayInput BroadwayInput;
 typedef struct BroadwaySurface BroadwaySurface;
 struct _BroadwayServer {
@@ -67,6 +73,9 @@ struct _BroadwayServer {
 
   guint32 next_texture_id;
   GHashTable *textures;
+  GHashTable *texture_contents; /* GBytes => BroadwayTexture */
+  GQueue unused_textures; /* Most recently released first */
+  gsize unused_textures_size;
 
   guint32 screen_scale;
 
@@ -88,6 +97,10 @@ struct _BroadwayServer {
   int future_mouse_in_surface;
 
   GList *outstanding_roundtrips;
+
+  /* Roundtrip times to the client, used for frame pacing */
+  gint64 min_roundtrip_time;
+  gint64 smoothed_roundtrip_time;
 };
 
 struct _BroadwayServerClass
@@ -133,10 +146,17 @@ struct _BroadwayTexture {
   grefcount refcount;
   guint32 id;
   GBytes *bytes;
+  GList unused_link; /* In unused_textures while the refcount is 0 */
 };
 
+/* Released textures stay alive in the client up to this size, so
+ * that the same content can be shown again without a new transfer.
+ */
+#define MAX_UNUSED_TEXTURES_SIZE (16 * 1024 * 1024)
+
 static void broadway_server_resync_surfaces (BroadwayServer *server);
 static void send_outstanding_roundtrips (BroadwayServer *server);
+static void queue_process_input_at_idle (BroadwayServer *server);
 
 static void broadway_server_ref_texture (BroadwayServer   *server,
                                          guint32           id);
@@ -265,6 +285,8 @@ broadway_server_init (BroadwayServer *server)
   server->id_counter = 0;
   server->textures = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL,
                                             (GDestroyNotify)broadway_texture_free);
+  server->texture_contents = g_hash_table_new (g_bytes_hash, g_bytes_equal);
+  g_queue_init (&server->unused_textures);
 
   root = g_new0 (BroadwaySurface, 1);
   root->id = server->id_counter++;
@@ -288,6 +310,7 @@ broadway_server_finalize (GObject *object)
   g_free (server->address);
   g_free (server->ssl_cert);
   g_free (server->ssl_key);
+  g_hash_table_destroy (server->texture_contents);
   g_hash_table_destroy (server->textures);
 
   G_OBJECT_CLASS (broadway_server_parent_class)->finalize (object);
@@ -617,6 +640,52 @@ queue_input_message (BroadwayServer *server, BroadwayInputMsg *msg)
   server->input_messages = g_list_append (server->input_messages, g_memdup2 (msg, sizeof (BroadwayInputMsg)));
 }
 
+static gboolean
+deliver_delayed_roundtrip (gpointer data)
+{
+  BroadwayDelayedRoundtrip *delayed = data;
+
+  queue_input_message (delayed->server, &delayed->msg);
+  queue_process_input_at_idle (delayed->server);
+
+  g_object_unref (delayed->server);
+  g_free (delayed);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Applications wait for the roundtrip reply after every frame before
+ * drawing the next one. If the replies take much longer than the fastest
+ * we've seen, the frames are queueing up somewhere along the way to the
+ * client, typically because the link can't keep up with the data we send.
+ * In that case, hold back the reply for the excess time, so the queue can
+ * drain instead of the applications filling it up further.
+ *
+ * Returns: the time in microseconds to delay the reply by
+ */
+static gint64
+update_roundtrip_time (BroadwayServer *server,
+                       gint64          roundtrip_time)
+{
+  gint64 queue_time;
+
+  if (server->min_roundtrip_time == 0 ||
+      roundtrip_time < server->min_roundtrip_time)
+    server->min_roundtrip_time = roundtrip_time;
+  else
+    /* Slowly forget the minimum, in case the route to the client changed */
+    server->min_roundtrip_time += (roundtrip_time - server->min_roundtrip_time) / 64;
+
+  if (server->smoothed_roundtrip_time == 0)
+    server->smoothed_roundtrip_time = roundtrip_time;
+  else
+    server->smoothed_roundtrip_time += (roundtrip_time - server->smoothed_roundtrip_time) / 8;
+
+  queue_time = server->smoothed_roundtrip_time - 2 * server->min_roundtrip_time;
+
+  return CLAMP (queue_time, 0, G_USEC_PER_SEC);
+}
+
 static void
 parse_input_message (BroadwayInput *input, const unsigned char *message)
 {
@@ -624,6 +693,7 @@ parse_input_message (BroadwayInput *input, const unsigned char *message)
   BroadwayInputMsg msg;
   guint32 *p;
   gint64 time_;
+  gint64 delay = 0;
   GList *l;
 
   memset (&msg, 0, sizeof (msg));
@@ -723,6 +793,8 @@ parse_input_message (BroadwayInput *input, const unsigned char *message)
       {
         BroadwayOutstandingRoundtrip *rt = l->data;
 
+        delay = update_roundtrip_time (server, g_get_monotonic_time () - rt->sent_time);
+
         server->outstanding_roundtrips = g_list_delete_link (server->outstanding_roundtrips, l);
         g_free (rt);
       }
@@ -740,6 +812,16 @@ parse_input_message (BroadwayInput *input, const unsigned char *message)
     break;
   }
 
+  if (delay >= 1000)
+    {
+      BroadwayDelayedRoundtrip *delayed = g_new (BroadwayDelayedRoundtrip, 1);
+
+      delayed->server = g_object_ref (server);
+      delayed->msg = msg;
+      g_timeout_add (delay / 1000, deliver_delayed_roundtrip, delayed);
+      return;
+    }
+
   queue_input_message (server, &msg);
 }
 
@@ -1018,6 +1100,7 @@ broadway_server_roundtrip (BroadwayServer *server,
       BroadwayOutstandingRoundtrip *rt = g_new0 (BroadwayOutstandingRoundtrip, 1);
       rt->id = id;
       rt->tag = tag;
+      rt->sent_time = g_get_monotonic_time ();
       server->outstanding_roundtrips = g_list_prepend (server->outstanding_roundtrips, rt);
 
       broadway_output_roundtrip (server->output, id, tag);
@@ -1931,12 +2014,60 @@ broadway_server_surface_update_nodes (BroadwayServer   *server,
   broadway_node_add_to_lookup (root, surface->node_lookup);
 }
 
+static void
+broadway_server_evict_texture (BroadwayServer  *server,
+                               BroadwayTexture *texture,
+                               gboolean         notify_client)
+{
+  guint32 id = texture->id;
+
+  g_queue_unlink (&server->unused_textures, &texture->unused_link);
+  server->unused_textures_size -= g_bytes_get_size (texture->bytes);
+  g_hash_table_remove (server->texture_contents, texture->bytes);
+  g_hash_table_remove (server->textures, GINT_TO_POINTER (id));
+
+  if (notify_client && server->output)
+    broadway_output_release_texture (server->output, id);
+}
+
+static void
+broadway_server_evict_unused_textures (BroadwayServer *server,
+                                       gsize           max_size,
+                                       gboolean        notify_client)
+{
+  while (server->unused_textures.tail &&
+         server->unused_textures_size > max_size)
+    broadway_server_evict_texture (server,
+                                   server->unused_textures.tail->data,
+                                   notify_client);
+}
+
 guint32
 broadway_server_upload_texture (BroadwayServer   *server,
                                 GBytes           *bytes)
 {
   BroadwayTexture *texture;
 
+  /* Textures are shared by content, so an icon that is uploaded
+   * again by another surface, or by another client, reuses the
+   * copy the browser already has.
+   */
+  texture = g_hash_table_lookup (server->texture_contents, bytes);
+  if (texture)
+    {
+      if (texture->unused_link.data)
+        {
+          g_queue_unlink (&server->unused_textures, &texture->unused_link);
+          texture->unused_link.data = NULL;
+          server->unused_textures_size -= g_bytes_get_size (texture->bytes);
+          g_ref_count_init (&texture->refcount);
+        }
+      else
+        g_ref_count_inc (&texture->refcount);
+
+      return texture->id;
+    }
+
   texture = g_new0 (BroadwayTexture, 1);
   g_ref_count_init (&texture->refcount);
   texture->id = ++server->next_texture_id;
@@ -1945,6 +2076,7 @@ broadway_server_upload_texture (BroadwayServer   *server,
   g_hash_table_replace (server->textures,
                         GINT_TO_POINTER (texture->id),
                         texture);
+  g_hash_table_insert (server->texture_contents, texture->bytes, texture);
 
   if (server->output)
     broadway_output_upload_texture (server->output, texture->id, texture->bytes);
@@ -1959,7 +2091,7 @@ broadway_server_ref_texture (BroadwayServer   *server,
   BroadwayTexture *texture;
 
   texture = g_hash_table_lookup (server->textures, GINT_TO_POINTER (id));
-  if (texture)
+  if (texture && texture->unused_link.data == NULL)
     g_ref_count_inc (&texture->refcount);
 }
 
@@ -1971,12 +2103,15 @@ broadway_server_release_texture (BroadwayServer   *server,
 
   texture = g_hash_table_lookup (server->textures, GINT_TO_POINTER (id));
 
-  if (texture && g_ref_count_dec (&texture->refcount))
+  if (texture && texture->unused_link.data == NULL &&
+      g_ref_count_dec (&texture->refcount))
     {
-      g_hash_table_remove (server->textures, GINT_TO_POINTER (id));
+      /* Keep it around in case the same content comes back */
+      texture->unused_link.data = texture;
+      g_queue_push_head_link (&server->unused_textures, &texture->unused_link);
+      server->unused_textures_size += g_bytes_get_size (texture->bytes);
 
-      if (server->output)
-        broadway_output_release_texture (server->output, id);
+      broadway_server_evict_unused_textures (server, MAX_UNUSED_TEXTURES_SIZE, TRUE);
     }
 }
 
@@ -2152,6 +2287,11 @@ broadway_server_resync_surfaces (BroadwayServer *server)
   if (server->output == NULL)
     return;
 
+  /* A new client has none of the unused textures, so there
+   * is no point in sending them
+   */
+  broadway_server_evict_unused_textures (server, 0, FALSE);
+
   /* First upload all textures */
   g_hash_table_iter_init (&iter, server->textures);
   while (g_hash_table_iter_next (&iter, &key, &value))
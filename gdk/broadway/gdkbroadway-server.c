@@ -16,6 +16,7 @@
 #include "gdkprivate.h"
 
 #include <gdk/gdktextureprivate.h>
+#include <gdk/loaders/gdkpngprivate.h>
 
 #include <glib.h>
 #include <glib/gprintf.h>
@@ -632,7 +633,8 @@ gdk_broadway_server_upload_texture (GdkBroadwayServer *server,
   gsize size;
   int fd;
 
-  bytes = gdk_texture_save_to_png_bytes (texture);
+  /* The daemon only passes the texture on to the browser */
+  bytes = gdk_save_png (texture, GDK_PNG_COMPRESSION_FAST);
   fd = open_shared_memory ();
   data = g_bytes_get_data (bytes, &size);
 
@@ -0,0 +1,364 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkcompressedtextureprivate.h"
+
+#include "gdkmemoryformatprivate.h"
+
+#include <string.h>
+
+/**
+ * GdkCompressedTexture:
+ *
+ * A `GdkTexture` representing block compressed image data in memory.
+ *
+ * Renderers upload the compressed data as-is if the GPU supports
+ * the format, which uses a fraction of the memory and bandwidth of
+ * uncompressed data. Otherwise, the data is decompressed when it
+ * is downloaded.
+ *
+ * Since: 4.14
+ */
+
+struct _GdkCompressedTexture
+{
+  GdkTexture parent_instance;
+
+  GdkCompressedFormat compressed_format;
+  GBytes *bytes;
+};
+
+struct _GdkCompressedTextureClass
+{
+  GdkTextureClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkCompressedTexture, gdk_compressed_texture, GDK_TYPE_TEXTURE)
+
+/* {{{ Decompression */
+
+static void
+decode_rgb565 (guint16 color,
+               guchar  rgb[3])
+{
+  guint r, g, b;
+
+  r = (color >> 11) & 0x1f;
+  g = (color >> 5) & 0x3f;
+  b = color & 0x1f;
+
+  rgb[0] = (r << 3) | (r >> 2);
+  rgb[1] = (g << 2) | (g >> 4);
+  rgb[2] = (b << 3) | (b >> 2);
+}
+
+/* Decodes the 8 byte color block shared by all BCn formats into
+ * 16 RGBA pixels. If @allow_alpha is set, the 3 color mode has a
+ * transparent fourth color, like BC1 does.
+ */
+static void
+decode_color_block (const guchar *block,
+                    gboolean      allow_alpha,
+                    guchar        pixels[16][4])
+{
+  guint16 c0, c1;
+  guint32 indices;
+  guchar colors[4][4];
+  int i;
+
+  c0 = block[0] | (block[1] << 8);
+  c1 = block[2] | (block[3] << 8);
+  indices = block[4] | (block[5] << 8) | (block[6] << 16) | ((guint32) block[7] << 24);
+
+  decode_rgb565 (c0, colors[0]);
+  decode_rgb565 (c1, colors[1]);
+  colors[0][3] = colors[1][3] = 255;
+
+  if (c0 > c1 || !allow_alpha)
+    {
+      for (i = 0; i < 3; i++)
+        {
+          colors[2][i] = (2 * colors[0][i] + colors[1][i]) / 3;
+          colors[3][i] = (colors[0][i] + 2 * colors[1][i]) / 3;
+        }
+      colors[2][3] = colors[3][3] = 255;
+    }
+  else
+    {
+      for (i = 0; i < 3; i++)
+        colors[2][i] = (colors[0][i] + colors[1][i]) / 2;
+      colors[2][3] = 255;
+      memset (colors[3], 0, 4);
+    }
+
+  for (i = 0; i < 16; i++)
+    memcpy (pixels[i], colors[(indices >> (2 * i)) & 3], 4);
+}
+
+static void
+decode_bc2_alpha (const guchar *block,
+                  guchar        pixels[16][4])
+{
+  int i;
+
+  for (i = 0; i < 16; i++)
+    {
+      guint a = (block[i / 2] >> (4 * (i % 2))) & 0xf;
+
+      pixels[i][3] = a * 17;
+    }
+}
+
+static void
+decode_bc3_alpha (const guchar *block,
+                  guchar        pixels[16][4])
+{
+  guchar alphas[8];
+  guint64 indices;
+  int i;
+
+  alphas[0] = block[0];
+  alphas[1] = block[1];
+
+  if (alphas[0] > alphas[1])
+    {
+      for (i = 1; i < 7; i++)
+        alphas[i + 1] = ((7 - i) * alphas[0] + i * alphas[1]) / 7;
+    }
+  else
+    {
+      for (i = 1; i < 5; i++)
+        alphas[i + 1] = ((5 - i) * alphas[0] + i * alphas[1]) / 5;
+      alphas[6] = 0;
+      alphas[7] = 255;
+    }
+
+  indices = 0;
+  for (i = 0; i < 6; i++)
+    indices |= (guint64) block[2 + i] << (8 * i);
+
+  for (i = 0; i < 16; i++)
+    pixels[i][3] = alphas[(indices >> (3 * i)) & 7];
+}
+
+/* The color is premultiplied, so it must not exceed the alpha */
+static void
+clamp_premultiplied (guchar pixels[16][4])
+{
+  int i, j;
+
+  for (i = 0; i < 16; i++)
+    for (j = 0; j < 3; j++)
+      pixels[i][j] = MIN (pixels[i][j], pixels[i][3]);
+}
+
+static void
+gdk_compressed_texture_decode (GdkCompressedTexture *self,
+                               guchar               *data,
+                               gsize                 stride)
+{
+  GdkTexture *texture = GDK_TEXTURE (self);
+  const guchar *block;
+  gsize block_size;
+  int x, y, bx, by;
+
+  block = g_bytes_get_data (self->bytes, NULL);
+  block_size = gdk_compressed_format_get_block_size (self->compressed_format);
+
+  for (y = 0; y < texture->height; y += 4)
+    {
+      for (x = 0; x < texture->width; x += 4)
+        {
+          guchar pixels[16][4];
+
+          switch (self->compressed_format)
+            {
+            case GDK_COMPRESSED_BC1:
+              decode_color_block (block, TRUE, pixels);
+              break;
+
+            case GDK_COMPRESSED_BC2:
+              decode_color_block (block + 8, FALSE, pixels);
+              decode_bc2_alpha (block, pixels);
+              clamp_premultiplied (pixels);
+              break;
+
+            case GDK_COMPRESSED_BC3:
+              decode_color_block (block + 8, FALSE, pixels);
+              decode_bc3_alpha (block, pixels);
+              clamp_premultiplied (pixels);
+              break;
+
+            default:
+              g_assert_not_reached ();
+            }
+
+          for (by = 0; by < MIN (4, texture->height - y); by++)
+            {
+              for (bx = 0; bx < MIN (4, texture->width - x); bx++)
+                memcpy (data + (y + by) * stride + (x + bx) * 4, pixels[4 * by + bx], 4);
+            }
+
+          block += block_size;
+        }
+    }
+}
+
+/* }}} */
+/* {{{ GdkTexture implementation */
+
+static void
+gdk_compressed_texture_dispose (GObject *object)
+{
+  GdkCompressedTexture *self = GDK_COMPRESSED_TEXTURE (object);
+
+  g_clear_pointer (&self->bytes, g_bytes_unref);
+
+  G_OBJECT_CLASS (gdk_compressed_texture_parent_class)->dispose (object);
+}
+
+static void
+gdk_compressed_texture_download (GdkTexture      *texture,
+                                 GdkMemoryFormat  format,
+                                 guchar          *data,
+                                 gsize            stride)
+{
+  GdkCompressedTexture *self = GDK_COMPRESSED_TEXTURE (texture);
+  guchar *pixels;
+  gsize pixel_stride;
+
+  if (format == texture->format)
+    {
+      gdk_compressed_texture_decode (self, data, stride);
+      return;
+    }
+
+  pixel_stride = texture->width * 4;
+  pixels = g_malloc_n (texture->height, pixel_stride);
+
+  gdk_compressed_texture_decode (self, pixels, pixel_stride);
+
+  gdk_memory_convert (data, stride,
+                      format,
+                      pixels, pixel_stride,
+                      texture->format,
+                      texture->width,
+                      texture->height);
+
+  g_free (pixels);
+}
+
+static void
+gdk_compressed_texture_class_init (GdkCompressedTextureClass *klass)
+{
+  GdkTextureClass *texture_class = GDK_TEXTURE_CLASS (klass);
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  texture_class->download = gdk_compressed_texture_download;
+
+  gobject_class->dispose = gdk_compressed_texture_dispose;
+}
+
+static void
+gdk_compressed_texture_init (GdkCompressedTexture *self)
+{
+}
+
+/* }}} */
+/* {{{ Public API */
+
+/**
+ * gdk_compressed_texture_new:
+ * @width: the width of the texture
+ * @height: the height of the texture
+ * @format: the format of the data
+ * @bytes: the `GBytes` containing the compressed data
+ *
+ * Creates a new texture for block compressed image data.
+ *
+ * The data is a sequence of 4x4 pixel blocks in row-major order.
+ * If @width or @height are not multiples of 4, the blocks at the
+ * right and bottom edges are cut off. The `GBytes` must contain
+ * at least as many blocks as are needed to cover the texture.
+ *
+ * Returns: (type GdkCompressedTexture): A newly-created `GdkTexture`
+ *
+ * Since: 4.14
+ */
+GdkTexture *
+gdk_compressed_texture_new (int                  width,
+                            int                  height,
+                            GdkCompressedFormat  format,
+                            GBytes              *bytes)
+{
+  GdkCompressedTexture *self;
+
+  g_return_val_if_fail (width > 0, NULL);
+  g_return_val_if_fail (height > 0, NULL);
+  g_return_val_if_fail (format <= GDK_COMPRESSED_BC3, NULL);
+  g_return_val_if_fail (bytes != NULL, NULL);
+  g_return_val_if_fail (g_bytes_get_size (bytes) >= (gsize) ((width + 3) / 4) * ((height + 3) / 4) *
+                                                    gdk_compressed_format_get_block_size (format), NULL);
+
+  self = g_object_new (GDK_TYPE_COMPRESSED_TEXTURE,
+                       "width", width,
+                       "height", height,
+                       NULL);
+
+  GDK_TEXTURE (self)->format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
+  self->compressed_format = format;
+  self->bytes = g_bytes_ref (bytes);
+
+  return GDK_TEXTURE (self);
+}
+
+/* }}} */
+/* {{{ Private API */
+
+gsize
+gdk_compressed_format_get_block_size (GdkCompressedFormat format)
+{
+  switch (format)
+    {
+    case GDK_COMPRESSED_BC1:
+      return 8;
+    case GDK_COMPRESSED_BC2:
+    case GDK_COMPRESSED_BC3:
+      return 16;
+    default:
+      g_assert_not_reached ();
+      return 16;
+    }
+}
+
+GdkCompressedFormat
+gdk_compressed_texture_get_compressed_format (GdkCompressedTexture *self)
+{
+  return self->compressed_format;
+}
+
+GBytes *
+gdk_compressed_texture_get_bytes (GdkCompressedTexture *self)
+{
+  return self->bytes;
+}
+
+/* }}} */
+
+/* vim:set foldmethod=marker expandtab: */
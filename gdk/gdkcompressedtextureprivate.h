@@ -0,0 +1,33 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdkcompressedtexture.h"
+
+#include "gdktextureprivate.h"
+
+G_BEGIN_DECLS
+
+gsize                   gdk_compressed_format_get_block_size    (GdkCompressedFormat   format) G_GNUC_CONST;
+
+GdkCompressedFormat     gdk_compressed_texture_get_compressed_format
+                                                                (GdkCompressedTexture *self);
+GBytes *                gdk_compressed_texture_get_bytes        (GdkCompressedTexture *self);
+
+G_END_DECLS
+
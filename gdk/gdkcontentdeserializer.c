@@ -27,6 +27,7 @@
 #include "gdkrgbaprivate.h"
 #include "gdkprivate.h"
 #include "loaders/gdkpngprivate.h"
+#include "loaders/gdkrawprivate.h"
 #include "loaders/gdktiffprivate.h"
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
@@ -663,23 +664,43 @@ texture_deserializer_finish (GObject      *source,
                              GAsyncResult *result,
                              gpointer      deserializer)
 {
-  GOutputStream *stream = G_OUTPUT_STREAM (source);
-  GBytes *bytes;
+  GdkTexture *texture;
   GError *error = NULL;
-  GdkTexture *texture = NULL;
-  gssize written;
 
-  written = g_output_stream_splice_finish (stream, result, &error);
-  if (written < 0)
+  texture = gdk_texture_new_from_stream_finish (result, &error);
+  if (texture == NULL)
     {
       gdk_content_deserializer_return_error (deserializer, error);
       return;
     }
 
-  bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (stream));
+  g_value_take_object (gdk_content_deserializer_get_value (deserializer), texture);
+  gdk_content_deserializer_return_success (deserializer);
+}
+
+static void
+texture_deserializer (GdkContentDeserializer *deserializer)
+{
+  /* PNG and JPEG are decoded while they are being read, so the
+   * encoded image is never kept in memory completely
+   */
+  gdk_texture_new_from_stream_async (gdk_content_deserializer_get_input_stream (deserializer),
+                                     gdk_content_deserializer_get_cancellable (deserializer),
+                                     NULL, NULL, NULL,
+                                     texture_deserializer_finish,
+                                     deserializer);
+}
+
+static void
+raw_texture_deserializer_finish (GObject      *source,
+                                 GAsyncResult *result,
+                                 gpointer      user_data)
+{
+  GdkContentDeserializer *deserializer = GDK_CONTENT_DESERIALIZER (source);
+  GdkTexture *texture;
+  GError *error = NULL;
 
-  texture = gdk_texture_new_from_bytes (bytes, &error);
-  g_bytes_unref (bytes);
+  texture = g_task_propagate_pointer (G_TASK (result), &error);
   if (texture == NULL)
     {
       gdk_content_deserializer_return_error (deserializer, error);
@@ -691,21 +712,35 @@ texture_deserializer_finish (GObject      *source,
 }
 
 static void
-texture_deserializer (GdkContentDeserializer *deserializer)
+deserialize_raw_texture_in_thread (GTask        *task,
+                                   gpointer      source_object,
+                                   gpointer      task_data,
+                                   GCancellable *cancellable)
 {
-  GOutputStream *output;
+  GdkContentDeserializer *deserializer = source_object;
+  GdkTexture *texture;
+  GError *error = NULL;
 
-  output = g_memory_output_stream_new_resizable ();
+  texture = gdk_load_raw_from_stream (gdk_content_deserializer_get_input_stream (deserializer),
+                                      cancellable,
+                                      &error);
+  if (texture)
+    g_task_return_pointer (task, texture, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
 
-  g_output_stream_splice_async (output,
-                                gdk_content_deserializer_get_input_stream (deserializer),
-                                G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE
-                                | G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
-                                gdk_content_deserializer_get_priority (deserializer),
-                                gdk_content_deserializer_get_cancellable (deserializer),
-                                texture_deserializer_finish,
-                                deserializer);
-  g_object_unref (output);
+static void
+raw_texture_deserializer (GdkContentDeserializer *deserializer)
+{
+  GTask *task;
+
+  task = g_task_new (deserializer,
+                     gdk_content_deserializer_get_cancellable (deserializer),
+                     raw_texture_deserializer_finish,
+                     NULL);
+  g_task_run_in_thread (task, deserialize_raw_texture_in_thread);
+  g_object_unref (task);
 }
 
 static void
@@ -916,6 +951,11 @@ init (void)
 
   initialized = TRUE;
 
+  gdk_content_register_deserializer (GDK_RAW_MIME_TYPE,
+                                     GDK_TYPE_TEXTURE,
+                                     raw_texture_deserializer,
+                                     NULL,
+                                     NULL);
   gdk_content_register_deserializer ("image/png",
                                      GDK_TYPE_TEXTURE,
                                      texture_deserializer,
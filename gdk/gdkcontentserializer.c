@@ -27,6 +27,7 @@
 #include "gdktextureprivate.h"
 #include "gdkrgba.h"
 #include "loaders/gdkpngprivate.h"
+#include "loaders/gdkrawprivate.h"
 #include "loaders/gdktiffprivate.h"
 #include "loaders/gdkjpegprivate.h"
 #include "gdkmemorytextureprivate.h"
@@ -694,8 +695,34 @@ serialize_texture_in_thread (GTask        *task,
   value = gdk_content_serializer_get_value (serializer);
   texture = g_value_get_object (value);
 
-  if (strcmp (gdk_content_serializer_get_mime_type (serializer), "image/png") == 0)
-    bytes = gdk_save_png (texture);
+  if (strcmp (gdk_content_serializer_get_mime_type (serializer), GDK_RAW_MIME_TYPE) == 0)
+    {
+      if (gdk_save_raw_to_stream (texture,
+                                  gdk_content_serializer_get_output_stream (serializer),
+                                  gdk_content_serializer_get_cancellable (serializer),
+                                  &error))
+        g_task_return_boolean (task, TRUE);
+      else
+        g_task_return_error (task, error);
+      return;
+    }
+  else if (strcmp (gdk_content_serializer_get_mime_type (serializer), "image/png") == 0)
+    {
+      /* PNG is encoded straight into the stream, so large images
+       * are not kept in memory twice, and the encoder waits for
+       * the receiver when it can't keep up. The receiver usually
+       * decodes it right away, so encode it quickly.
+       */
+      if (gdk_save_png_to_stream (texture,
+                                  GDK_PNG_COMPRESSION_FAST,
+                                  gdk_content_serializer_get_output_stream (serializer),
+                                  gdk_content_serializer_get_cancellable (serializer),
+                                  &error))
+        g_task_return_boolean (task, TRUE);
+      else
+        g_task_return_error (task, error);
+      return;
+    }
   else if (strcmp (gdk_content_serializer_get_mime_type (serializer), "image/tiff") == 0)
     bytes = gdk_save_tiff (texture);
   else if (strcmp (gdk_content_serializer_get_mime_type (serializer), "image/jpeg") == 0)
@@ -733,54 +760,113 @@ texture_serializer (GdkContentSerializer *serializer)
   g_object_unref (task);
 }
 
+/* Big strings are written in chunks, so the charset conversion
+ * doesn't need to hold a converted copy of all of the text, and
+ * so we only produce more when the receiver has read the last one
+ */
+#define STRING_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+  GOutputStream *stream;
+  const char *text;
+  gsize len;
+  gsize written;
+} StringWriter;
+
+static void
+string_writer_free (gpointer data)
+{
+  StringWriter *writer = data;
+
+  g_object_unref (writer->stream);
+  g_free (writer);
+}
+
+static void string_serializer_write_chunk (GdkContentSerializer *serializer);
+
 static void
 string_serializer_finish (GObject      *source,
                           GAsyncResult *result,
                           gpointer      serializer)
 {
   GOutputStream *stream = G_OUTPUT_STREAM (source);
+  StringWriter *writer;
   GError *error = NULL;
+  gsize written;
 
-  if (!g_output_stream_write_all_finish (stream, result, NULL, &error))
-    gdk_content_serializer_return_error (serializer, error);
+  if (!g_output_stream_write_all_finish (stream, result, &written, &error))
+    {
+      gdk_content_serializer_return_error (serializer, error);
+      return;
+    }
+
+  writer = gdk_content_serializer_get_task_data (serializer);
+  writer->written += written;
+
+  if (writer->written < writer->len)
+    string_serializer_write_chunk (serializer);
   else
     gdk_content_serializer_return_success (serializer);
 }
 
+static void
+string_serializer_write_chunk (GdkContentSerializer *serializer)
+{
+  StringWriter *writer = gdk_content_serializer_get_task_data (serializer);
+
+  g_output_stream_write_all_async (writer->stream,
+                                   writer->text + writer->written,
+                                   MIN (writer->len - writer->written, STRING_CHUNK_SIZE),
+                                   gdk_content_serializer_get_priority (serializer),
+                                   gdk_content_serializer_get_cancellable (serializer),
+                                   string_serializer_finish,
+                                   serializer);
+}
+
 static void
 string_serializer (GdkContentSerializer *serializer)
 {
+  StringWriter *writer;
   GOutputStream *filter;
-  GCharsetConverter *converter;
-  GError *error = NULL;
+  const char *charset;
   const char *text;
 
-  converter = g_charset_converter_new (gdk_content_serializer_get_user_data (serializer),
-                                       "utf-8",
-                                       &error);
-  if (converter == NULL)
+  charset = gdk_content_serializer_get_user_data (serializer);
+
+  if (g_ascii_strcasecmp (charset, "utf-8") == 0)
     {
-      gdk_content_serializer_return_error (serializer, error);
-      return;
+      /* Our strings are UTF-8 already */
+      filter = g_object_ref (gdk_content_serializer_get_output_stream (serializer));
     }
-  g_charset_converter_set_use_fallback (converter, TRUE);
+  else
+    {
+      GCharsetConverter *converter;
+      GError *error = NULL;
 
-  filter = g_converter_output_stream_new (gdk_content_serializer_get_output_stream (serializer),
-                                          G_CONVERTER (converter));
-  g_object_unref (converter);
+      converter = g_charset_converter_new (charset, "utf-8", &error);
+      if (converter == NULL)
+        {
+          gdk_content_serializer_return_error (serializer, error);
+          return;
+        }
+      g_charset_converter_set_use_fallback (converter, TRUE);
+
+      filter = g_converter_output_stream_new (gdk_content_serializer_get_output_stream (serializer),
+                                              G_CONVERTER (converter));
+      g_object_unref (converter);
+    }
 
   text = g_value_get_string (gdk_content_serializer_get_value (serializer));
   if (text == NULL)
     text = "";
 
-  g_output_stream_write_all_async (filter,
-                                   text,
-                                   strlen (text),
-                                   gdk_content_serializer_get_priority (serializer),
-                                   gdk_content_serializer_get_cancellable (serializer),
-                                   string_serializer_finish,
-                                   serializer);
-  g_object_unref (filter);
+  writer = g_new0 (StringWriter, 1);
+  writer->stream = filter;
+  writer->text = text;
+  writer->len = strlen (text);
+  gdk_content_serializer_set_task_data (serializer, writer, string_writer_free);
+
+  string_serializer_write_chunk (serializer);
 }
 
 static void
@@ -968,6 +1054,14 @@ init (void)
 
   initialized = TRUE;
 
+  /* This comes first, so that GTK applications prefer it
+   * when they exchange images
+   */
+  gdk_content_register_serializer (GDK_TYPE_TEXTURE,
+                                   GDK_RAW_MIME_TYPE,
+                                   texture_serializer,
+                                   NULL, NULL);
+
   gdk_content_register_serializer (GDK_TYPE_TEXTURE,
                                    "image/png",
                                    texture_serializer,
@@ -93,10 +93,17 @@ struct _GdkDisplayPrivate {
   GdkGLContext *gl_context;
   GError *gl_error;
 
+  /* Contexts for uploads from other threads,
+   * see gdk_display_acquire_gl_context()
+   */
+  GMutex gl_pool_lock;
+  GPtrArray *gl_pool;
+
 #ifdef HAVE_EGL
   EGLDisplay egl_display;
   EGLConfig egl_config;
   EGLConfig egl_config_high_depth;
+  EGLint egl_surface_type;
 #endif
 
   guint rgba : 1;
@@ -366,6 +373,8 @@ gdk_display_init (GdkDisplay *display)
   priv->composited = TRUE;
   priv->rgba = TRUE;
   priv->input_shapes = TRUE;
+
+  g_mutex_init (&priv->gl_pool_lock);
 }
 
 static void
@@ -378,6 +387,10 @@ gdk_display_dispose (GObject *object)
 
   g_queue_clear (&display->queued_events);
 
+  g_mutex_lock (&priv->gl_pool_lock);
+  g_clear_pointer (&priv->gl_pool, g_ptr_array_unref);
+  g_mutex_unlock (&priv->gl_pool_lock);
+
   g_clear_object (&priv->gl_context);
 #ifdef HAVE_EGL
   g_clear_pointer (&priv->egl_display, eglTerminate);
@@ -394,6 +407,7 @@ static void
 gdk_display_finalize (GObject *object)
 {
   GdkDisplay *display = GDK_DISPLAY (object);
+  GdkDisplayPrivate *priv = gdk_display_get_instance_private (display);
 
   g_hash_table_foreach_remove (display->device_grabs,
                                free_device_grabs_foreach,
@@ -404,6 +418,8 @@ gdk_display_finalize (GObject *object)
 
   g_list_free_full (display->seats, g_object_unref);
 
+  g_mutex_clear (&priv->gl_pool_lock);
+
   G_OBJECT_CLASS (gdk_display_parent_class)->finalize (object);
 }
 
@@ -1388,6 +1404,124 @@ gdk_display_create_gl_context (GdkDisplay  *self,
   return gdk_gl_context_new (self, NULL);
 }
 
+/* Contexts beyond this are freed when they are released */
+#define MAX_POOLED_GL_CONTEXTS 4
+
+/**
+ * gdk_display_acquire_gl_context:
+ * @self: a `GdkDisplay`
+ * @error: return location for an error
+ *
+ * Takes a realized `GdkGLContext` from a pool kept by @self, or
+ * creates one if the pool is empty, and makes it current in the
+ * calling thread.
+ *
+ * This is meant for uploading textures from worker threads. The
+ * contexts share their resources with the contexts that GTK renders
+ * with, so textures created in them can be wrapped with a
+ * [class@Gdk.GLTextureBuilder] and handed to the main thread. Use
+ * [method@Gdk.GLTextureBuilder.set_sync] with a fence created after
+ * the upload, so the renderer does not sample an incomplete texture.
+ *
+ * This function may be called from any thread, but
+ * [method@Gdk.Display.prepare_gl] must have succeeded on the
+ * main thread before.
+ *
+ * When done, give the context back with
+ * [method@Gdk.Display.release_gl_context] from the same thread.
+ *
+ * Returns: (transfer full) (nullable): a current `GdkGLContext`
+ *
+ * Since: 4.14
+ */
+GdkGLContext *
+gdk_display_acquire_gl_context (GdkDisplay  *self,
+                                GError     **error)
+{
+  GdkDisplayPrivate *priv = gdk_display_get_instance_private (self);
+  GdkGLContext *context = NULL;
+
+  g_return_val_if_fail (GDK_IS_DISPLAY (self), NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  g_mutex_lock (&priv->gl_pool_lock);
+
+  if (priv->gl_pool != NULL && priv->gl_pool->len > 0)
+    context = g_ptr_array_steal_index_fast (priv->gl_pool, priv->gl_pool->len - 1);
+
+  g_mutex_unlock (&priv->gl_pool_lock);
+
+  if (context == NULL)
+    {
+      if (priv->gl_context == NULL)
+        {
+          if (priv->gl_error)
+            {
+              if (error)
+                *error = g_error_copy (priv->gl_error);
+            }
+          else
+            g_set_error_literal (error, GDK_GL_ERROR, GDK_GL_ERROR_NOT_AVAILABLE,
+                                 _("OpenGL has not been initialized"));
+          return NULL;
+        }
+
+      context = gdk_gl_context_new (self, NULL);
+      if (!gdk_gl_context_realize (context, error))
+        {
+          g_object_unref (context);
+          return NULL;
+        }
+    }
+
+  gdk_gl_context_make_current (context);
+
+  return context;
+}
+
+/**
+ * gdk_display_release_gl_context:
+ * @self: a `GdkDisplay`
+ * @context: (transfer full): a context returned by
+ *   [method@Gdk.Display.acquire_gl_context]
+ *
+ * Returns @context to the pool of @self, so that it can be reused
+ * by a later call to [method@Gdk.Display.acquire_gl_context].
+ *
+ * This must be called from the thread that acquired @context.
+ * The context is no longer current afterwards.
+ *
+ * Since: 4.14
+ */
+void
+gdk_display_release_gl_context (GdkDisplay   *self,
+                                GdkGLContext *context)
+{
+  GdkDisplayPrivate *priv = gdk_display_get_instance_private (self);
+
+  g_return_if_fail (GDK_IS_DISPLAY (self));
+  g_return_if_fail (GDK_IS_GL_CONTEXT (context));
+  g_return_if_fail (gdk_gl_context_get_display (context) == self);
+
+  if (gdk_gl_context_get_current () == context)
+    gdk_gl_context_clear_current ();
+
+  g_mutex_lock (&priv->gl_pool_lock);
+
+  if (priv->gl_pool == NULL)
+    priv->gl_pool = g_ptr_array_new_with_free_func (g_object_unref);
+
+  if (priv->gl_pool->len < MAX_POOLED_GL_CONTEXTS)
+    {
+      g_ptr_array_add (priv->gl_pool, context);
+      context = NULL;
+    }
+
+  g_mutex_unlock (&priv->gl_pool_lock);
+
+  g_clear_object (&context);
+}
+
 /*< private >
  * gdk_display_get_gl_context:
  * @self: the `GdkDisplay`
@@ -1545,7 +1679,7 @@ gdk_display_create_egl_config (GdkDisplay               *self,
   int i = 0;
 
   attrs[i++] = EGL_SURFACE_TYPE;
-  attrs[i++] = EGL_WINDOW_BIT;
+  attrs[i++] = priv->egl_surface_type;
 
   attrs[i++] = EGL_COLOR_BUFFER_TYPE;
   attrs[i++] = EGL_RGB_BUFFER;
@@ -1699,6 +1833,14 @@ gdk_display_init_egl (GdkDisplay  *self,
 
   priv->egl_display = gdk_display_create_egl_display (platform, native_display);
 
+  /* Surfaceless platforms have no window configs */
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  if (platform == EGL_PLATFORM_SURFACELESS_MESA)
+    priv->egl_surface_type = EGL_PBUFFER_BIT;
+  else
+#endif
+    priv->egl_surface_type = EGL_WINDOW_BIT;
+
   if (priv->egl_display == NULL)
     {
       g_set_error_literal (error, GDK_GL_ERROR,
@@ -1756,6 +1898,8 @@ gdk_display_init_egl (GdkDisplay  *self,
     epoxy_has_egl_extension (priv->egl_display, "EGL_KHR_no_config_context");
   self->have_egl_pixel_format_float =
     epoxy_has_egl_extension (priv->egl_display, "EGL_EXT_pixel_format_float");
+  self->have_egl_direct_composition =
+    epoxy_has_egl_extension (priv->egl_display, "EGL_ANGLE_direct_composition");
 
   if (self->have_egl_no_config_context)
     priv->egl_config_high_depth = gdk_display_create_egl_config (self,
@@ -72,6 +72,12 @@ gboolean    gdk_display_prepare_gl         (GdkDisplay  *self,
 GDK_AVAILABLE_IN_4_6
 GdkGLContext *gdk_display_create_gl_context(GdkDisplay  *self,
                                             GError     **error);
+GDK_AVAILABLE_IN_4_14
+GdkGLContext *gdk_display_acquire_gl_context (GdkDisplay   *self,
+                                              GError      **error);
+GDK_AVAILABLE_IN_4_14
+void          gdk_display_release_gl_context (GdkDisplay   *self,
+                                              GdkGLContext *context);
 
 GDK_AVAILABLE_IN_ALL
 GdkDisplay *gdk_display_get_default (void);
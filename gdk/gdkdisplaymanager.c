@@ -28,6 +28,7 @@
 #include "gdkdisplaymanagerprivate.h"
 #include "gdkdisplayprivate.h"
 #include "gdkkeysprivate.h"
+#include "gdkprofilerprivate.h"
 #include <glib/gi18n-lib.h>
 
 #ifdef GDK_WINDOWING_X11
@@ -52,6 +53,10 @@
 #include "wayland/gdkprivate-wayland.h"
 #endif
 
+#ifdef GDK_WINDOWING_SURFACELESS
+#include "surfaceless/gdkprivate-surfaceless.h"
+#endif
+
 /**
  * GdkDisplayManager:
  *
@@ -234,8 +239,11 @@ static const char *allowed_backends;
  *   - `wayland`.
  *   - `win32`
  *   - `x11`
+ *   - `surfaceless`
  *
  * You can also include a `*` in the list to try all remaining backends.
+ * The `surfaceless` backend is not included in `*`, as it can not show
+ * any surfaces. It has to be named explicitly.
  *
  * This call must happen prior to functions that open a display, such
  * as [func@Gdk.Display.open], `gtk_init()`, or `gtk_init_check()`
@@ -252,6 +260,7 @@ typedef struct _GdkBackend GdkBackend;
 struct _GdkBackend {
   const char *name;
   GdkDisplay * (* open_display) (const char *name);
+  gboolean explicit_only;
 };
 
 static GdkBackend gdk_backends[] = {
@@ -269,6 +278,9 @@ static GdkBackend gdk_backends[] = {
 #endif
 #ifdef GDK_WINDOWING_BROADWAY
   { "broadway", _gdk_broadway_display_open },
+#endif
+#ifdef GDK_WINDOWING_SURFACELESS
+  { "surfaceless", _gdk_surfaceless_display_open, TRUE },
 #endif
   /* NULL-terminating this array so we can use commas above */
   { NULL, NULL }
@@ -423,12 +435,19 @@ gdk_display_manager_open_display (GdkDisplayManager *manager,
           if (g_str_equal (backend, gdk_backends[j].name))
             found = TRUE;
 
+          if (any && gdk_backends[j].explicit_only)
+            continue;
+
           if ((any && allow_any) ||
               (any && strstr (allowed_backends, gdk_backends[j].name)) ||
               g_str_equal (backend, gdk_backends[j].name))
             {
+              gint64 before G_GNUC_UNUSED;
+
               GDK_DEBUG (MISC, "Trying %s backend", gdk_backends[j].name);
+              before = GDK_PROFILER_CURRENT_TIME;
               display = gdk_backends[j].open_display (name);
+              gdk_profiler_end_mark (before, "open display", gdk_backends[j].name);
               if (display)
                 {
                   GDK_DEBUG (MISC, "Using %s display %s", gdk_backends[j].name, gdk_display_get_name (display));
@@ -0,0 +1,371 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdmabufprivate.h"
+
+#include "gdkdebugprivate.h"
+#include "gdkmemoryformatprivate.h"
+
+#ifdef HAVE_SYS_MMAN_H
+#include <sys/mman.h>
+#endif
+#ifdef HAVE_LINUX_DMA_BUF_H
+#include <linux/dma-buf.h>
+#include <sys/ioctl.h>
+#endif
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct _GdkDmabufFormat GdkDmabufFormat;
+
+typedef void (* GdkDmabufDownloadFunc) (guchar                *dst_data,
+                                        gsize                  dst_stride,
+                                        GdkMemoryFormat        dst_format,
+                                        gsize                  width,
+                                        gsize                  height,
+                                        GdkMemoryFormat        src_format,
+                                        const GdkDmabuf       *dmabuf,
+                                        const guchar          *src_data[GDK_DMABUF_MAX_PLANES]);
+
+struct _GdkDmabufFormat
+{
+  guint32 fourcc;
+  unsigned int n_planes;
+  GdkMemoryFormat premultiplied_memory_format;
+  GdkMemoryFormat unpremultiplied_memory_format;
+  GdkDmabufDownloadFunc download;
+};
+
+static void
+download_memcpy (guchar          *dst_data,
+                 gsize            dst_stride,
+                 GdkMemoryFormat  dst_format,
+                 gsize            width,
+                 gsize            height,
+                 GdkMemoryFormat  src_format,
+                 const GdkDmabuf *dmabuf,
+                 const guchar    *src_data[GDK_DMABUF_MAX_PLANES])
+{
+  gdk_memory_convert (dst_data, dst_stride, dst_format,
+                      src_data[0] + dmabuf->planes[0].offset, dmabuf->planes[0].stride, src_format,
+                      width, height);
+}
+
+/* For the X formats, the alpha byte is undefined and must be ignored */
+static void
+download_x8 (guchar          *dst_data,
+             gsize            dst_stride,
+             GdkMemoryFormat  dst_format,
+             gsize            width,
+             gsize            height,
+             GdkMemoryFormat  src_format,
+             const GdkDmabuf *dmabuf,
+             const guchar    *src_data[GDK_DMABUF_MAX_PLANES])
+{
+  guchar *row;
+  gsize x, y;
+
+  row = g_malloc (width * 4);
+
+  for (y = 0; y < height; y++)
+    {
+      memcpy (row, src_data[0] + dmabuf->planes[0].offset + y * dmabuf->planes[0].stride, width * 4);
+      for (x = 0; x < width; x++)
+        row[4 * x + 3] = 0xFF;
+
+      gdk_memory_convert (dst_data + y * dst_stride, dst_stride, dst_format,
+                          row, width * 4, src_format,
+                          width, 1);
+    }
+
+  g_free (row);
+}
+
+/* BT.601 limited range, which is what cameras and video decoders
+ * produce unless told otherwise.
+ */
+static inline void
+yuv_to_rgb (guchar  y,
+            guchar  u,
+            guchar  v,
+            guchar *rgb)
+{
+  int c = (int) y - 16;
+  int d = (int) u - 128;
+  int e = (int) v - 128;
+
+  rgb[0] = CLAMP ((298 * c + 409 * e + 128) >> 8, 0, 255);
+  rgb[1] = CLAMP ((298 * c - 100 * d - 208 * e + 128) >> 8, 0, 255);
+  rgb[2] = CLAMP ((298 * c + 516 * d + 128) >> 8, 0, 255);
+}
+
+static void
+download_nv12 (guchar          *dst_data,
+               gsize            dst_stride,
+               GdkMemoryFormat  dst_format,
+               gsize            width,
+               gsize            height,
+               GdkMemoryFormat  src_format,
+               const GdkDmabuf *dmabuf,
+               const guchar    *src_data[GDK_DMABUF_MAX_PLANES])
+{
+  const guchar *y_plane, *uv_plane;
+  guchar *row;
+  gsize x, y;
+
+  y_plane = src_data[0] + dmabuf->planes[0].offset;
+  uv_plane = src_data[1] + dmabuf->planes[1].offset;
+  row = g_malloc (width * 3);
+
+  for (y = 0; y < height; y++)
+    {
+      const guchar *y_row = y_plane + y * dmabuf->planes[0].stride;
+      const guchar *uv_row = uv_plane + (y / 2) * dmabuf->planes[1].stride;
+
+      for (x = 0; x < width; x++)
+        yuv_to_rgb (y_row[x], uv_row[x / 2 * 2], uv_row[x / 2 * 2 + 1], &row[3 * x]);
+
+      gdk_memory_convert (dst_data + y * dst_stride, dst_stride, dst_format,
+                          row, width * 3, src_format,
+                          width, 1);
+    }
+
+  g_free (row);
+}
+
+static void
+download_yuyv (guchar          *dst_data,
+               gsize            dst_stride,
+               GdkMemoryFormat  dst_format,
+               gsize            width,
+               gsize            height,
+               GdkMemoryFormat  src_format,
+               const GdkDmabuf *dmabuf,
+               const guchar    *src_data[GDK_DMABUF_MAX_PLANES])
+{
+  guchar *row;
+  gsize x, y;
+
+  row = g_malloc (width * 3);
+
+  for (y = 0; y < height; y++)
+    {
+      const guchar *src_row = src_data[0] + dmabuf->planes[0].offset + y * dmabuf->planes[0].stride;
+
+      for (x = 0; x < width; x++)
+        yuv_to_rgb (src_row[2 * x], src_row[x / 2 * 4 + 1], src_row[x / 2 * 4 + 3], &row[3 * x]);
+
+      gdk_memory_convert (dst_data + y * dst_stride, dst_stride, dst_format,
+                          row, width * 3, src_format,
+                          width, 1);
+    }
+
+  g_free (row);
+}
+
+static const GdkDmabufFormat supported_formats[] = {
+  { DRM_FORMAT_ARGB8888, 1, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED, GDK_MEMORY_B8G8R8A8, download_memcpy },
+  { DRM_FORMAT_BGRA8888, 1, GDK_MEMORY_A8R8G8B8_PREMULTIPLIED, GDK_MEMORY_A8R8G8B8, download_memcpy },
+  { DRM_FORMAT_ABGR8888, 1, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, GDK_MEMORY_R8G8B8A8, download_memcpy },
+  { DRM_FORMAT_XRGB8888, 1, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED, download_x8 },
+  { DRM_FORMAT_XBGR8888, 1, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, download_x8 },
+  { DRM_FORMAT_RGB888, 1, GDK_MEMORY_B8G8R8, GDK_MEMORY_B8G8R8, download_memcpy },
+  { DRM_FORMAT_BGR888, 1, GDK_MEMORY_R8G8B8, GDK_MEMORY_R8G8B8, download_memcpy },
+  { DRM_FORMAT_ABGR16161616F, 1, GDK_MEMORY_R16G16B16A16_FLOAT_PREMULTIPLIED, GDK_MEMORY_R16G16B16A16_FLOAT, download_memcpy },
+  { DRM_FORMAT_NV12, 2, GDK_MEMORY_R8G8B8, GDK_MEMORY_R8G8B8, download_nv12 },
+  { DRM_FORMAT_YUYV, 1, GDK_MEMORY_R8G8B8, GDK_MEMORY_R8G8B8, download_yuyv },
+};
+
+static const GdkDmabufFormat *
+gdk_dmabuf_find_format (guint32 fourcc)
+{
+  for (gsize i = 0; i < G_N_ELEMENTS (supported_formats); i++)
+    {
+      if (supported_formats[i].fourcc == fourcc)
+        return &supported_formats[i];
+    }
+
+  return NULL;
+}
+
+/*
+ * gdk_dmabuf_get_memory_format:
+ * @fourcc: a DRM fourcc
+ * @premultiplied: whether the data is premultiplied
+ * @out_format: (out): return location for the memory format
+ *
+ * Finds the memory format that matches the pixel data of a dmabuf
+ * with the given @fourcc after it has been downloaded or imported.
+ * YUV formats are converted to RGB.
+ *
+ * Returns: %TRUE if @fourcc is known to GTK
+ */
+gboolean
+gdk_dmabuf_get_memory_format (guint32          fourcc,
+                              gboolean         premultiplied,
+                              GdkMemoryFormat *out_format)
+{
+  const GdkDmabufFormat *format = gdk_dmabuf_find_format (fourcc);
+
+  if (format == NULL)
+    return FALSE;
+
+  *out_format = premultiplied ? format->premultiplied_memory_format
+                              : format->unpremultiplied_memory_format;
+  return TRUE;
+}
+
+/*
+ * gdk_dmabuf_get_n_planes:
+ * @fourcc: a DRM fourcc
+ *
+ * Returns: the number of planes a linear buffer of this format has,
+ *   or 0 if the format is unknown
+ */
+unsigned int
+gdk_dmabuf_get_n_planes (guint32 fourcc)
+{
+  const GdkDmabufFormat *format = gdk_dmabuf_find_format (fourcc);
+
+  if (format == NULL)
+    return 0;
+
+  return format->n_planes;
+}
+
+/*
+ * gdk_dmabuf_can_mmap:
+ * @dmabuf: a dmabuf
+ *
+ * Checks if the contents of @dmabuf can be read by mapping it into
+ * memory. This is only possible for linear buffers of known formats.
+ *
+ * Returns: %TRUE if gdk_dmabuf_download_mmap() can be used
+ */
+gboolean
+gdk_dmabuf_can_mmap (const GdkDmabuf *dmabuf)
+{
+#ifdef HAVE_SYS_MMAN_H
+  const GdkDmabufFormat *format = gdk_dmabuf_find_format (dmabuf->fourcc);
+
+  return format != NULL &&
+         dmabuf->modifier == DRM_FORMAT_MOD_LINEAR &&
+         dmabuf->n_planes == format->n_planes;
+#else
+  return FALSE;
+#endif
+}
+
+#ifdef HAVE_SYS_MMAN_H
+static void
+gdk_dmabuf_sync (int      fd,
+                 gboolean start)
+{
+#ifdef HAVE_LINUX_DMA_BUF_H
+  struct dma_buf_sync sync = {
+    .flags = (start ? DMA_BUF_SYNC_START : DMA_BUF_SYNC_END) | DMA_BUF_SYNC_READ,
+  };
+
+  while (ioctl (fd, DMA_BUF_IOCTL_SYNC, &sync) == -1 &&
+         (errno == EINTR || errno == EAGAIN));
+#endif
+}
+#endif
+
+/*
+ * gdk_dmabuf_download_mmap:
+ * @dmabuf: a dmabuf that gdk_dmabuf_can_mmap() returned %TRUE for
+ * @width: the width of the image
+ * @height: the height of the image
+ * @premultiplied: whether the data is premultiplied
+ * @format: the format to download into
+ * @data: the memory to download into
+ * @stride: the stride of @data
+ *
+ * Maps the planes of @dmabuf and converts their contents into @data.
+ *
+ * Returns: %TRUE on success, %FALSE if the buffer could not be mapped
+ */
+gboolean
+gdk_dmabuf_download_mmap (const GdkDmabuf *dmabuf,
+                          gsize            width,
+                          gsize            height,
+                          gboolean         premultiplied,
+                          GdkMemoryFormat  format,
+                          guchar          *data,
+                          gsize            stride)
+{
+#ifdef HAVE_SYS_MMAN_H
+  const GdkDmabufFormat *dmabuf_format;
+  const guchar *src_data[GDK_DMABUF_MAX_PLANES] = { NULL, };
+  gsize sizes[GDK_DMABUF_MAX_PLANES] = { 0, };
+  gboolean success = FALSE;
+  unsigned int i;
+
+  g_return_val_if_fail (gdk_dmabuf_can_mmap (dmabuf), FALSE);
+
+  dmabuf_format = gdk_dmabuf_find_format (dmabuf->fourcc);
+
+  for (i = 0; i < dmabuf->n_planes; i++)
+    {
+      off_t size = lseek (dmabuf->planes[i].fd, 0, SEEK_END);
+      gsize plane_height = (dmabuf->fourcc == DRM_FORMAT_NV12 && i == 1) ? (height + 1) / 2 : height;
+
+      if (size < 0 ||
+          (gsize) size < dmabuf->planes[i].offset + (gsize) dmabuf->planes[i].stride * plane_height)
+        {
+          GDK_DEBUG (MISC, "Dmabuf plane %u is too small to map", i);
+          goto out;
+        }
+
+      src_data[i] = mmap (NULL, size, PROT_READ, MAP_SHARED, dmabuf->planes[i].fd, 0);
+      if (src_data[i] == MAP_FAILED)
+        {
+          GDK_DEBUG (MISC, "Failed to map dmabuf plane %u: %s", i, g_strerror (errno));
+          src_data[i] = NULL;
+          goto out;
+        }
+
+      sizes[i] = size;
+      gdk_dmabuf_sync (dmabuf->planes[i].fd, TRUE);
+    }
+
+  dmabuf_format->download (data, stride, format,
+                           width, height,
+                           premultiplied ? dmabuf_format->premultiplied_memory_format
+                                         : dmabuf_format->unpremultiplied_memory_format,
+                           dmabuf, src_data);
+  success = TRUE;
+
+out:
+  for (i = 0; i < dmabuf->n_planes; i++)
+    {
+      if (src_data[i] == NULL)
+        continue;
+
+      gdk_dmabuf_sync (dmabuf->planes[i].fd, FALSE);
+      munmap ((gpointer) src_data[i], sizes[i]);
+    }
+
+  return success;
+#else
+  return FALSE;
+#endif
+}
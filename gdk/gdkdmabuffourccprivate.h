@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/* The subset of drm_fourcc.h that we use, so we don't need libdrm */
+
+#define fourcc_code(a, b, c, d) ((guint32)(a) | ((guint32)(b) << 8) | \
+                                 ((guint32)(c) << 16) | ((guint32)(d) << 24))
+
+#ifndef DRM_FORMAT_ARGB8888
+#define DRM_FORMAT_ARGB8888          fourcc_code ('A', 'R', '2', '4')
+#endif
+#ifndef DRM_FORMAT_XRGB8888
+#define DRM_FORMAT_XRGB8888          fourcc_code ('X', 'R', '2', '4')
+#endif
+#ifndef DRM_FORMAT_ABGR8888
+#define DRM_FORMAT_ABGR8888          fourcc_code ('A', 'B', '2', '4')
+#endif
+#ifndef DRM_FORMAT_XBGR8888
+#define DRM_FORMAT_XBGR8888          fourcc_code ('X', 'B', '2', '4')
+#endif
+#ifndef DRM_FORMAT_BGRA8888
+#define DRM_FORMAT_BGRA8888          fourcc_code ('B', 'A', '2', '4')
+#endif
+#ifndef DRM_FORMAT_RGB888
+#define DRM_FORMAT_RGB888            fourcc_code ('R', 'G', '2', '4')
+#endif
+#ifndef DRM_FORMAT_BGR888
+#define DRM_FORMAT_BGR888            fourcc_code ('B', 'G', '2', '4')
+#endif
+#ifndef DRM_FORMAT_ABGR16161616F
+#define DRM_FORMAT_ABGR16161616F     fourcc_code ('A', 'B', '4', 'H')
+#endif
+#ifndef DRM_FORMAT_NV12
+#define DRM_FORMAT_NV12              fourcc_code ('N', 'V', '1', '2')
+#endif
+#ifndef DRM_FORMAT_YUYV
+#define DRM_FORMAT_YUYV              fourcc_code ('Y', 'U', 'Y', 'V')
+#endif
+
+#ifndef DRM_FORMAT_MOD_LINEAR
+#define DRM_FORMAT_MOD_LINEAR        0ULL
+#endif
+#ifndef DRM_FORMAT_MOD_INVALID
+#define DRM_FORMAT_MOD_INVALID       ((1ULL << 56) - 1)
+#endif
@@ -0,0 +1,56 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdktypes.h"
+
+#include "gdkdmabuffourccprivate.h"
+
+G_BEGIN_DECLS
+
+#define GDK_DMABUF_MAX_PLANES 4
+
+typedef struct _GdkDmabuf GdkDmabuf;
+
+struct _GdkDmabuf
+{
+  guint32 fourcc;
+  guint64 modifier;
+  unsigned int n_planes;
+  struct {
+    int fd;
+    unsigned int stride;
+    unsigned int offset;
+  } planes[GDK_DMABUF_MAX_PLANES];
+};
+
+gboolean                gdk_dmabuf_get_memory_format    (guint32                 fourcc,
+                                                         gboolean                premultiplied,
+                                                         GdkMemoryFormat        *out_format);
+unsigned int            gdk_dmabuf_get_n_planes         (guint32                 fourcc);
+gboolean                gdk_dmabuf_can_mmap             (const GdkDmabuf        *dmabuf);
+
+gboolean                gdk_dmabuf_download_mmap        (const GdkDmabuf        *dmabuf,
+                                                         gsize                   width,
+                                                         gsize                   height,
+                                                         gboolean                premultiplied,
+                                                         GdkMemoryFormat         format,
+                                                         guchar                 *data,
+                                                         gsize                   stride);
+
+G_END_DECLS
@@ -0,0 +1,297 @@
+/* gdkdmabuftexture.c
+ *
+ * Copyright 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdmabuftextureprivate.h"
+
+#include "gdkdisplayprivate.h"
+#include "gdkglcontextprivate.h"
+#include "gdkgltexturebuilder.h"
+#include "gdkmemoryformatprivate.h"
+#include <glib/gi18n-lib.h>
+
+#include <epoxy/gl.h>
+#include <string.h>
+
+/**
+ * GdkDmabufTexture:
+ *
+ * A `GdkTexture` representing a DMA buffer.
+ *
+ * To create a `GdkDmabufTexture`, use the auxiliary
+ * [class@Gdk.DmabufTextureBuilder] object.
+ *
+ * Dma-buf textures can only be created on Linux.
+ *
+ * Since: 4.14
+ */
+
+struct _GdkDmabufTexture
+{
+  GdkTexture parent_instance;
+
+  GdkDisplay *display;
+
+  GdkDmabuf dmabuf;
+
+  GDestroyNotify destroy;
+  gpointer data;
+};
+
+struct _GdkDmabufTextureClass
+{
+  GdkTextureClass parent_class;
+};
+
+G_DEFINE_TYPE (GdkDmabufTexture, gdk_dmabuf_texture, GDK_TYPE_TEXTURE)
+
+static void
+gdk_dmabuf_texture_dispose (GObject *object)
+{
+  GdkDmabufTexture *self = GDK_DMABUF_TEXTURE (object);
+
+  if (self->destroy)
+    {
+      self->destroy (self->data);
+      self->destroy = NULL;
+      self->data = NULL;
+    }
+
+  g_clear_object (&self->display);
+
+  G_OBJECT_CLASS (gdk_dmabuf_texture_parent_class)->dispose (object);
+}
+
+static void
+gdk_dmabuf_texture_delete_gl_texture (gpointer data)
+{
+  guint texture_id = GPOINTER_TO_UINT (data);
+
+  glDeleteTextures (1, &texture_id);
+}
+
+typedef struct _Download Download;
+
+struct _Download
+{
+  GdkDmabufTexture *self;
+  GdkMemoryFormat format;
+  guchar *data;
+  gsize stride;
+  volatile int spinlock;
+};
+
+/* GL calls have to happen on the main thread, so we
+ * import the buffer there and let GdkGLTexture deal
+ * with getting the pixels out.
+ */
+static gboolean
+gdk_dmabuf_texture_invoke_download (gpointer data)
+{
+  Download *download = data;
+  GdkDmabufTexture *self = download->self;
+  GdkTexture *texture = GDK_TEXTURE (self);
+  GdkGLContext *context;
+  guint texture_id = 0;
+
+  context = gdk_display_get_gl_context (self->display);
+  if (context)
+    {
+      gdk_gl_context_make_current (context);
+      texture_id = gdk_gl_context_import_dmabuf (context,
+                                                 texture->width, texture->height,
+                                                 &self->dmabuf);
+    }
+
+  if (texture_id != 0)
+    {
+      GdkGLTextureBuilder *builder;
+      GdkTexture *gl_texture;
+
+      builder = gdk_gl_texture_builder_new ();
+      gdk_gl_texture_builder_set_context (builder, context);
+      gdk_gl_texture_builder_set_id (builder, texture_id);
+      gdk_gl_texture_builder_set_width (builder, texture->width);
+      gdk_gl_texture_builder_set_height (builder, texture->height);
+      gdk_gl_texture_builder_set_format (builder, texture->format);
+      gl_texture = gdk_gl_texture_builder_build (builder,
+                                                 gdk_dmabuf_texture_delete_gl_texture,
+                                                 GUINT_TO_POINTER (texture_id));
+
+      gdk_texture_do_download (gl_texture, download->format, download->data, download->stride);
+
+      g_object_unref (gl_texture);
+      g_object_unref (builder);
+    }
+  else
+    {
+      g_warning ("Failed to download dmabuf texture");
+
+      for (gsize y = 0; y < texture->height; y++)
+        memset (download->data + y * download->stride, 0,
+                texture->width * gdk_memory_format_bytes_per_pixel (download->format));
+    }
+
+  g_atomic_int_set (&download->spinlock, 1);
+
+  return FALSE;
+}
+
+static void
+gdk_dmabuf_texture_download (GdkTexture      *texture,
+                             GdkMemoryFormat  format,
+                             guchar          *data,
+                             gsize            stride)
+{
+  GdkDmabufTexture *self = GDK_DMABUF_TEXTURE (texture);
+  Download download = { self, format, data, stride, 0 };
+
+  if (gdk_dmabuf_can_mmap (&self->dmabuf) &&
+      gdk_dmabuf_download_mmap (&self->dmabuf,
+                                texture->width, texture->height,
+                                gdk_memory_format_alpha (texture->format) != GDK_MEMORY_ALPHA_STRAIGHT,
+                                format, data, stride))
+    return;
+
+  g_main_context_invoke (NULL, gdk_dmabuf_texture_invoke_download, &download);
+
+  while (g_atomic_int_get (&download.spinlock) == 0);
+}
+
+static void
+gdk_dmabuf_texture_class_init (GdkDmabufTextureClass *klass)
+{
+  GdkTextureClass *texture_class = GDK_TEXTURE_CLASS (klass);
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
+
+  texture_class->download = gdk_dmabuf_texture_download;
+
+  gobject_class->dispose = gdk_dmabuf_texture_dispose;
+}
+
+static void
+gdk_dmabuf_texture_init (GdkDmabufTexture *self)
+{
+}
+
+static gboolean
+gdk_dmabuf_texture_can_import (GdkDisplay      *display,
+                               int              width,
+                               int              height,
+                               const GdkDmabuf *dmabuf)
+{
+  GdkGLContext *context;
+  guint texture_id;
+
+  if (!gdk_display_prepare_gl (display, NULL))
+    return FALSE;
+
+  context = gdk_display_get_gl_context (display);
+  gdk_gl_context_make_current (context);
+
+  texture_id = gdk_gl_context_import_dmabuf (context, width, height, dmabuf);
+  if (texture_id == 0)
+    return FALSE;
+
+  glDeleteTextures (1, &texture_id);
+
+  return TRUE;
+}
+
+GdkTexture *
+gdk_dmabuf_texture_new_from_builder (GdkDmabufTextureBuilder *builder,
+                                     GDestroyNotify           destroy,
+                                     gpointer                 data,
+                                     GError                 **error)
+{
+  GdkDmabufTexture *self;
+  GdkTexture *update_texture;
+  GdkDisplay *display;
+  const GdkDmabuf *dmabuf;
+  GdkMemoryFormat format;
+  gboolean premultiplied;
+  int width, height;
+
+  display = gdk_dmabuf_texture_builder_get_display (builder);
+  width = gdk_dmabuf_texture_builder_get_width (builder);
+  height = gdk_dmabuf_texture_builder_get_height (builder);
+  premultiplied = gdk_dmabuf_texture_builder_get_premultiplied (builder);
+  dmabuf = gdk_dmabuf_texture_builder_get_dmabuf (builder);
+
+  if (!gdk_dmabuf_can_mmap (dmabuf) &&
+      !gdk_dmabuf_texture_can_import (display, width, height, dmabuf))
+    {
+      g_set_error (error,
+                   GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_UNSUPPORTED_FORMAT,
+                   _("Unsupported dmabuf format %.4s:%#" G_GINT64_MODIFIER "x"),
+                   (char *) &dmabuf->fourcc, dmabuf->modifier);
+      return NULL;
+    }
+
+  if (!gdk_dmabuf_get_memory_format (dmabuf->fourcc, premultiplied, &format))
+    format = premultiplied ? GDK_MEMORY_R8G8B8A8_PREMULTIPLIED : GDK_MEMORY_R8G8B8A8;
+
+  self = g_object_new (GDK_TYPE_DMABUF_TEXTURE,
+                       "width", width,
+                       "height", height,
+                       NULL);
+
+  GDK_TEXTURE (self)->format = format;
+  self->display = g_object_ref (display);
+  self->dmabuf = *dmabuf;
+  self->destroy = destroy;
+  self->data = data;
+
+  GDK_DISPLAY_DEBUG (display, MISC,
+                     "Creating dmabuf texture, format %.4s:%#" G_GINT64_MODIFIER "x, %s%u planes, memory format %u",
+                     (char *) &dmabuf->fourcc, dmabuf->modifier,
+                     premultiplied ? " premultiplied, " : "",
+                     dmabuf->n_planes,
+                     format);
+
+  update_texture = gdk_dmabuf_texture_builder_get_update_texture (builder);
+  if (update_texture)
+    {
+      cairo_region_t *update_region = gdk_dmabuf_texture_builder_get_update_region (builder);
+      if (update_region)
+        {
+          update_region = cairo_region_copy (update_region);
+          cairo_region_intersect_rectangle (update_region,
+                                            &(cairo_rectangle_int_t) {
+                                              0, 0,
+                                              update_texture->width, update_texture->height
+                                            });
+          gdk_texture_set_diff (GDK_TEXTURE (self), update_texture, update_region);
+        }
+    }
+
+  return GDK_TEXTURE (self);
+}
+
+GdkDisplay *
+gdk_dmabuf_texture_get_display (GdkDmabufTexture *self)
+{
+  return self->display;
+}
+
+const GdkDmabuf *
+gdk_dmabuf_texture_get_dmabuf (GdkDmabufTexture *self)
+{
+  return &self->dmabuf;
+}
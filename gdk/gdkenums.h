@@ -370,4 +370,26 @@ typedef enum {
   GDK_MEMORY_N_FORMATS
 } GdkMemoryFormat;
 
+/**
+ * GdkCompressedFormat:
+ * @GDK_COMPRESSED_BC1: 4x4 pixel blocks of 8 bytes, with 1 bit of
+ *   alpha. Also known as DXT1.
+ * @GDK_COMPRESSED_BC2: 4x4 pixel blocks of 16 bytes, with 4 bits of
+ *   explicit alpha per pixel. Also known as DXT2.
+ * @GDK_COMPRESSED_BC3: 4x4 pixel blocks of 16 bytes, with
+ *   interpolated alpha. Also known as DXT4.
+ *
+ * `GdkCompressedFormat` describes the block compressed formats
+ * that can be used with [class@Gdk.CompressedTexture].
+ *
+ * The color values are always premultiplied with the alpha value.
+ *
+ * Since: 4.14
+ */
+typedef enum {
+  GDK_COMPRESSED_BC1,
+  GDK_COMPRESSED_BC2,
+  GDK_COMPRESSED_BC3,
+} GdkCompressedFormat;
+
 G_END_DECLS
@@ -731,6 +731,101 @@ gdk_event_queue_handle_scroll_compression (GdkDisplay *display)
     }
 }
 
+static void
+gdk_touchpad_event_push_history (GdkEvent *event,
+                                 GdkEvent *history_event)
+{
+  GdkTouchpadEvent *self = (GdkTouchpadEvent *) event;
+  GdkTouchpadEvent *other = (GdkTouchpadEvent *) history_event;
+  GdkTimeCoord hist;
+
+  if (G_UNLIKELY (!self->history))
+    self->history = g_array_new (FALSE, TRUE, sizeof (GdkTimeCoord));
+
+  if (other->history)
+    g_array_append_vals (self->history, other->history->data, other->history->len);
+
+  memset (&hist, 0, sizeof (GdkTimeCoord));
+  hist.time = gdk_event_get_time (history_event);
+  hist.flags = GDK_AXIS_FLAG_X | GDK_AXIS_FLAG_Y |
+               GDK_AXIS_FLAG_DELTA_X | GDK_AXIS_FLAG_DELTA_Y;
+  hist.axes[GDK_AXIS_X] = other->x;
+  hist.axes[GDK_AXIS_Y] = other->y;
+  hist.axes[GDK_AXIS_DELTA_X] = other->dx;
+  hist.axes[GDK_AXIS_DELTA_Y] = other->dy;
+
+  g_array_append_val (self->history, hist);
+}
+
+/*
+ * If the last N events in the event queue are update events of the
+ * same touchpad swipe or pinch gesture, drop all but the last.
+ *
+ * The remaining event gets the dropped events as history, and its
+ * deltas and pinch angle are the sums over all of them. Positions
+ * and the pinch scale are absolute, so they are taken from the last
+ * event as they are.
+ */
+void
+gdk_event_queue_handle_touchpad_compression (GdkDisplay *display)
+{
+  GList *l;
+  GList *pending = NULL;
+  GdkTouchpadEvent *last = NULL;
+
+  l = g_queue_peek_tail_link (&display->queued_events);
+
+  while (l)
+    {
+      GdkEvent *event = l->data;
+      GdkTouchpadEvent *touchpad_event = (GdkTouchpadEvent *) event;
+
+      if (event->flags & GDK_EVENT_PENDING)
+        break;
+
+      if (event->event_type != GDK_TOUCHPAD_SWIPE &&
+          event->event_type != GDK_TOUCHPAD_PINCH)
+        break;
+
+      if (touchpad_event->phase != GDK_TOUCHPAD_GESTURE_PHASE_UPDATE)
+        break;
+
+      if (last != NULL &&
+          (event->event_type != ((GdkEvent *) last)->event_type ||
+           event->surface != ((GdkEvent *) last)->surface ||
+           event->device != ((GdkEvent *) last)->device ||
+           touchpad_event->sequence != last->sequence ||
+           touchpad_event->n_fingers != last->n_fingers))
+        break;
+
+      if (!last)
+        last = touchpad_event;
+
+      pending = l;
+
+      l = l->prev;
+    }
+
+  if (pending == NULL || pending->next == NULL)
+    return;
+
+  /* The last event is only held by the queue, so update it in place */
+  while (pending->next != NULL)
+    {
+      GdkTouchpadEvent *event = pending->data;
+      GList *next = pending->next;
+
+      gdk_touchpad_event_push_history ((GdkEvent *) last, (GdkEvent *) event);
+      last->dx += event->dx;
+      last->dy += event->dy;
+      last->angle_delta += event->angle_delta;
+
+      gdk_event_unref ((GdkEvent *) event);
+      g_queue_delete_link (&display->queued_events, pending);
+      pending = next;
+    }
+}
+
 static void
 gdk_motion_event_push_history (GdkEvent *event,
                                GdkEvent *history_event)
@@ -2609,6 +2704,17 @@ gdk_scroll_event_get_unit (GdkEvent *event)
  * processed by the system, resulting in these events.
  */
 
+static void
+gdk_touchpad_event_finalize (GdkEvent *event)
+{
+  GdkTouchpadEvent *self = (GdkTouchpadEvent *) event;
+
+  if (self->history)
+    g_array_free (self->history, TRUE);
+
+  GDK_EVENT_SUPER (self)->finalize (event);
+}
+
 static GdkModifierType
 gdk_touchpad_event_get_state (GdkEvent *event)
 {
@@ -2641,7 +2747,7 @@ gdk_touchpad_event_get_position (GdkEvent *event,
 static const GdkEventTypeInfo gdk_touchpad_event_info = {
   sizeof (GdkTouchpadEvent),
   NULL,
-  NULL,
+  gdk_touchpad_event_finalize,
   gdk_touchpad_event_get_state,
   gdk_touchpad_event_get_position,
   gdk_touchpad_event_get_sequence,
@@ -3133,7 +3239,7 @@ gdk_motion_event_new (GdkSurface      *surface,
 
 /**
  * gdk_event_get_history:
- * @event: a motion or scroll event
+ * @event: a motion, scroll or touchpad gesture event
  * @out_n_coords: (out): Return location for the length of the returned array
  *
  * Retrieves the history of the device that @event is for, as a list of
@@ -3142,9 +3248,10 @@ gdk_motion_event_new (GdkSurface      *surface,
  * The history includes positions that are not delivered as separate events
  * to the application because they occurred in the same frame as @event.
  *
- * Note that only motion and scroll events record history, and motion
- * events do it only if one of the mouse buttons is down, or the device
- * has a tool.
+ * Note that only motion, scroll and touchpad swipe and pinch events
+ * record history, and motion events do it only if one of the mouse
+ * buttons is down, or the device has a tool. For touchpad events,
+ * the history contains the position and the deltas of each update.
  *
  * Returns: (transfer container) (array length=out_n_coords) (nullable): an
  *   array of time and coordinates
@@ -3157,7 +3264,9 @@ gdk_event_get_history (GdkEvent *event,
 
   g_return_val_if_fail (GDK_IS_EVENT (event), NULL);
   g_return_val_if_fail (GDK_IS_EVENT_TYPE (event, GDK_MOTION_NOTIFY) ||
-                        GDK_IS_EVENT_TYPE (event, GDK_SCROLL), NULL);
+                        GDK_IS_EVENT_TYPE (event, GDK_SCROLL) ||
+                        GDK_IS_EVENT_TYPE (event, GDK_TOUCHPAD_SWIPE) ||
+                        GDK_IS_EVENT_TYPE (event, GDK_TOUCHPAD_PINCH), NULL);
   g_return_val_if_fail (out_n_coords != NULL, NULL);
 
   if (GDK_IS_EVENT_TYPE (event, GDK_MOTION_NOTIFY))
@@ -3165,6 +3274,12 @@ gdk_event_get_history (GdkEvent *event,
       GdkMotionEvent *self = (GdkMotionEvent *) event;
       history = self->history;
     }
+  else if (GDK_IS_EVENT_TYPE (event, GDK_TOUCHPAD_SWIPE) ||
+           GDK_IS_EVENT_TYPE (event, GDK_TOUCHPAD_PINCH))
+    {
+      GdkTouchpadEvent *self = (GdkTouchpadEvent *) event;
+      history = self->history;
+    }
   else
     {
       GdkScrollEvent *self = (GdkScrollEvent *) event;
@@ -414,6 +414,7 @@ struct _GdkTouchpadEvent
   double dy;
   double angle_delta;
   double scale;
+  GArray *history; /* <GdkTimeCoord> */
 };
 
 struct _GdkPadEvent
@@ -628,6 +629,7 @@ GList* _gdk_event_queue_append       (GdkDisplay *display,
 
 void    _gdk_event_queue_handle_motion_compression (GdkDisplay *display);
 void    gdk_event_queue_handle_scroll_compression  (GdkDisplay *display);
+void    gdk_event_queue_handle_touchpad_compression (GdkDisplay *display);
 void    _gdk_event_queue_flush                     (GdkDisplay       *display);
 
 double * gdk_event_dup_axes (GdkEvent *event);
@@ -78,6 +78,12 @@ enum {
 static guint signals[LAST_SIGNAL];
 
 static guint fps_counter;
+static guint update_counter;
+static guint layout_counter;
+static guint paint_counter;
+static guint latency_counter;
+static guint layout_allocations_counter;
+static guint paint_allocations_counter;
 
 #define FRAME_HISTORY_MAX_LENGTH 128
 
@@ -258,7 +264,15 @@ gdk_frame_clock_init (GdkFrameClock *clock)
   priv->current = FRAME_HISTORY_MAX_LENGTH - 1;
 
   if (fps_counter == 0)
-    fps_counter = gdk_profiler_define_counter ("fps", "Frames per Second");
+    {
+      fps_counter = gdk_profiler_define_counter ("fps", "Frames per Second");
+      update_counter = gdk_profiler_define_counter ("frame update", "Time from frame start to layout in ms");
+      layout_counter = gdk_profiler_define_counter ("frame layout", "Time spent in layout in ms");
+      paint_counter = gdk_profiler_define_counter ("frame paint", "Time spent in paint in ms");
+      latency_counter = gdk_profiler_define_counter ("frame latency", "Time from frame start to presentation in ms");
+      layout_allocations_counter = gdk_profiler_define_int_counter ("frame layout allocations", "Objects allocated during layout");
+      paint_allocations_counter = gdk_profiler_define_int_counter ("frame paint allocations", "Objects allocated during paint");
+    }
 }
 
 /**
@@ -575,6 +589,12 @@ _gdk_frame_clock_debug_print_timings (GdkFrameClock   *clock,
     g_string_append_printf (str, " predicted=%-4.1f", (timings->predicted_presentation_time - timings->frame_time) / 1000.);
   if (timings->refresh_interval != 0)
     g_string_append_printf (str, " refresh_interval=%-4.1f", timings->refresh_interval / 1000.);
+  if (timings->layout_start_time != 0 && timings->paint_start_time != 0)
+    g_string_append_printf (str, " layout_allocs=%" G_GUINT64_FORMAT,
+                            timings->paint_start_allocations - timings->layout_start_allocations);
+  if (timings->paint_start_time != 0 && timings->frame_end_time != 0)
+    g_string_append_printf (str, " paint_allocs=%" G_GUINT64_FORMAT,
+                            timings->frame_end_allocations - timings->paint_start_allocations);
 
   g_message ("%s", str->str);
   g_string_free (str, TRUE);
@@ -813,7 +833,28 @@ _gdk_frame_clock_add_timings_to_profiler (GdkFrameClock   *clock,
   if (timings->presentation_time != 0)
     {
       gdk_profiler_add_mark (1000 * timings->presentation_time, 0, "presented window", NULL);
+      gdk_profiler_set_counter (latency_counter, (timings->presentation_time - timings->frame_time) / 1000.);
     }
 
+#ifdef G_ENABLE_DEBUG
+  /* Per-phase durations, so frame time distributions can be
+   * compared from a capture. Phases that did not run in this
+   * frame are skipped.
+   */
+  if (timings->layout_start_time != 0)
+    gdk_profiler_set_counter (update_counter, (timings->layout_start_time - timings->frame_time) / 1000.);
+  if (timings->layout_start_time != 0 && timings->paint_start_time != 0)
+    gdk_profiler_set_counter (layout_counter, (timings->paint_start_time - timings->layout_start_time) / 1000.);
+  if (timings->paint_start_time != 0 && timings->frame_end_time != 0)
+    gdk_profiler_set_counter (paint_counter, (timings->frame_end_time - timings->paint_start_time) / 1000.);
+
+  if (timings->layout_start_time != 0 && timings->paint_start_time != 0)
+    gdk_profiler_set_int_counter (layout_allocations_counter,
+                                  timings->paint_start_allocations - timings->layout_start_allocations);
+  if (timings->paint_start_time != 0 && timings->frame_end_time != 0)
+    gdk_profiler_set_int_counter (paint_allocations_counter,
+                                  timings->frame_end_allocations - timings->paint_start_allocations);
+#endif
+
   gdk_profiler_set_counter (fps_counter, gdk_frame_clock_get_fps (clock));
 }
@@ -36,6 +36,7 @@
 #endif
 
 #define FRAME_INTERVAL 16667 /* microseconds */
+#define LATENCY_MARGIN 2000 /* microseconds */
 
 typedef enum {
   SMOOTH_PHASE_STATE_VALID = 0,    /* explicit, since we count on zero-init */
@@ -58,6 +59,7 @@ struct _GdkFrameClockIdlePrivate
 
   gint64 sleep_serial;
   gint64 freeze_time; /* in microseconds */
+  gint64 cycle_duration;               /* Recent maximum of the time from starting a frame to the end of ::after-paint, decaying slowly */
 
   guint flush_idle_id;
   guint paint_idle_id;
@@ -69,6 +71,7 @@ struct _GdkFrameClockIdlePrivate
 
   guint in_paint_idle : 1;
   guint paint_is_thaw : 1;
+  guint variable_refresh : 1;          /* The output presents frames when they arrive, reported by the backend */
 #ifdef G_OS_WIN32
   guint begin_period : 1;
 #endif
@@ -255,6 +258,10 @@ gdk_frame_clock_idle_get_frame_time (GdkFrameClock *clock)
       (priv->phase != GDK_FRAME_CLOCK_PHASE_BEFORE_PAINT || priv->in_paint_idle))
     return priv->smoothed_frame_time_base;
 
+  /* With a fixed frame time, time only advances with frames */
+  if (GDK_DEBUG_CHECK (FIXED_FRAME_TIME) && priv->smoothed_frame_time_base != 0)
+    return priv->smoothed_frame_time_base;
+
   /* Outside a paint, pick something smoothed close to now */
   now = g_get_monotonic_time ();
 
@@ -280,7 +287,7 @@ gdk_frame_clock_idle_is_frozen (GdkFrameClockIdle *self)
 {
   GdkFrameClockIdlePrivate *priv = self->priv;
 
-  if (GDK_DEBUG_CHECK (NO_VSYNC))
+  if (GDK_DEBUG_CHECK (NO_VSYNC) || GDK_DEBUG_CHECK (FIXED_FRAME_TIME))
     return FALSE;
 
   return priv->freeze_count > 0;
@@ -310,6 +317,31 @@ should_run_paint_idle (GdkFrameClockIdle *self)
           priv->updating_count > 0);
 }
 
+/* In low latency mode, frames that are paced by the refresh cycle
+ * are started as late as the recent frame durations allow, so that
+ * input arriving in the meantime still makes it into the frame.
+ */
+static gint64
+compute_latency_delay (GdkFrameClockIdle *self)
+{
+  GdkFrameClockIdlePrivate *priv = self->priv;
+  gint64 period, delay;
+
+  if (!GDK_DEBUG_CHECK (LOW_LATENCY))
+    return 0;
+
+  period = priv->smoothed_frame_time_period;
+  if (period == 0)
+    period = FRAME_INTERVAL;
+
+  /* Never wait for more than half a frame, we don't know how
+   * long the compositor needs after we commit.
+   */
+  delay = period - priv->cycle_duration - LATENCY_MARGIN;
+
+  return CLAMP (delay, 0, period / 2);
+}
+
 static void
 maybe_start_idle (GdkFrameClockIdle *self,
                   gboolean           caused_by_thaw)
@@ -320,11 +352,15 @@ maybe_start_idle (GdkFrameClockIdle *self,
     {
       guint min_interval = 0;
 
-      if (priv->min_next_frame_time != 0 &&
-          !GDK_DEBUG_CHECK (NO_VSYNC))
+      if ((priv->min_next_frame_time != 0 || caused_by_thaw) &&
+          !GDK_DEBUG_CHECK (NO_VSYNC) &&
+          !GDK_DEBUG_CHECK (FIXED_FRAME_TIME))
         {
           gint64 now = g_get_monotonic_time ();
-          gint64 min_interval_us = MAX (priv->min_next_frame_time, now) - now;
+          gint64 min_interval_us;
+
+          min_interval_us = MAX (priv->min_next_frame_time, now) - now;
+          min_interval_us += compute_latency_delay (self);
           min_interval = (min_interval_us + 500) / 1000;
         }
 
@@ -421,6 +457,20 @@ positive_modulo (int i, int n)
   return (i % n + n) % n;
 }
 
+static void
+gdk_frame_clock_idle_update_cycle_duration (GdkFrameClockIdle *self)
+{
+  GdkFrameClockIdlePrivate *priv = self->priv;
+  gint64 duration;
+
+  duration = g_get_monotonic_time () - priv->frame_time;
+
+  /* Follow spikes right away, but forget them only slowly, so
+   * that a single fast frame doesn't make us miss the next one.
+   */
+  priv->cycle_duration = MAX (duration, priv->cycle_duration - priv->cycle_duration / 16);
+}
+
 static gboolean
 gdk_frame_clock_paint_idle (void *data)
 {
@@ -512,37 +562,65 @@ gdk_frame_clock_paint_idle (void *data)
                * adjusted times    |       *   |       *   |       +   |       +   |       +   |...
                * phase                                      ^------^
                */
-              if (priv->smooth_phase_state == SMOOTH_PHASE_STATE_AWAIT_FIRST)
-                {
-                  /* First animation cycle - usually unrelated to vsync */
-                  priv->smoothed_frame_time_base = 0;
-                  priv->smoothed_frame_time_phase = 0;
-                  priv->smooth_phase_state = SMOOTH_PHASE_STATE_AWAIT_DRAWN;
-                }
-              else if (priv->smooth_phase_state == SMOOTH_PHASE_STATE_AWAIT_DRAWN &&
-                       priv->paint_is_thaw)
-                {
-                  /* First vsync-related animation cycle, we can now compute the phase. We want the phase to satisfy
-                     0 <= phase < frame_interval */
-                  priv->smoothed_frame_time_phase =
-                      positive_modulo (priv->smoothed_frame_time_base - priv->frame_time,
-                                       frame_interval);
-                  priv->smooth_phase_state = SMOOTH_PHASE_STATE_VALID;
-                }
-
-              if (priv->smoothed_frame_time_base == 0)
+              if (GDK_DEBUG_CHECK (FIXED_FRAME_TIME))
                 {
-                  /* First frame ever, or first cycle in a new animation sequence. Ensure monotonicity */
-                  priv->smoothed_frame_time_base = MAX (priv->frame_time, priv->smoothed_frame_time_reported);
+                  /* Virtual time: every frame is exactly one interval after
+                   * the previous one, no matter how long it took, so that
+                   * animations progress the same way on every run.
+                   */
+                  frame_interval = FRAME_INTERVAL;
+                  if (priv->smoothed_frame_time_base == 0)
+                    priv->smoothed_frame_time_base = MAX (priv->frame_time, priv->smoothed_frame_time_reported);
+                  else
+                    priv->smoothed_frame_time_base += frame_interval;
                 }
               else
                 {
-                  /* compute_smooth_frame_time() ensures monotonicity */
-                  priv->smoothed_frame_time_base =
-                      compute_smooth_frame_time (clock, priv->frame_time + priv->smoothed_frame_time_phase,
-                                                 priv->paint_is_thaw,
-                                                 priv->smoothed_frame_time_base,
-                                                 priv->smoothed_frame_time_period);
+                  if (priv->variable_refresh)
+                    {
+                      /* With a variable refresh rate, frames are shown when they
+                       * are committed instead of at the next vblank, so snapping
+                       * frame times to a refresh grid would only add judder to
+                       * content that doesn't run at the nominal refresh rate,
+                       * like video. Report the real time, and let the content
+                       * pace itself.
+                       */
+                      priv->smoothed_frame_time_base = 0;
+                      priv->smoothed_frame_time_phase = 0;
+                      priv->smooth_phase_state = SMOOTH_PHASE_STATE_AWAIT_FIRST;
+                    }
+                  else if (priv->smooth_phase_state == SMOOTH_PHASE_STATE_AWAIT_FIRST)
+                    {
+                      /* First animation cycle - usually unrelated to vsync */
+                      priv->smoothed_frame_time_base = 0;
+                      priv->smoothed_frame_time_phase = 0;
+                      priv->smooth_phase_state = SMOOTH_PHASE_STATE_AWAIT_DRAWN;
+                    }
+                  else if (priv->smooth_phase_state == SMOOTH_PHASE_STATE_AWAIT_DRAWN &&
+                           priv->paint_is_thaw)
+                    {
+                      /* First vsync-related animation cycle, we can now compute the phase. We want the phase to satisfy
+                         0 <= phase < frame_interval */
+                      priv->smoothed_frame_time_phase =
+                          positive_modulo (priv->smoothed_frame_time_base - priv->frame_time,
+                                           frame_interval);
+                      priv->smooth_phase_state = SMOOTH_PHASE_STATE_VALID;
+                    }
+
+                  if (priv->smoothed_frame_time_base == 0)
+                    {
+                      /* First frame ever, or first cycle in a new animation sequence. Ensure monotonicity */
+                      priv->smoothed_frame_time_base = MAX (priv->frame_time, priv->smoothed_frame_time_reported);
+                    }
+                  else
+                    {
+                      /* compute_smooth_frame_time() ensures monotonicity */
+                      priv->smoothed_frame_time_base =
+                          compute_smooth_frame_time (clock, priv->frame_time + priv->smoothed_frame_time_phase,
+                                                     priv->paint_is_thaw,
+                                                     priv->smoothed_frame_time_base,
+                                                     priv->smoothed_frame_time_period);
+                    }
                 }
 
               priv->smoothed_frame_time_period = frame_interval;
@@ -586,11 +664,14 @@ gdk_frame_clock_paint_idle (void *data)
             {
 	      int iter;
 #ifdef G_ENABLE_DEBUG
-              if (GDK_DEBUG_CHECK (FRAMES))
+              if (GDK_DEBUG_CHECK (FRAMES) || GDK_PROFILER_IS_RUNNING)
                 {
                   if (priv->phase != GDK_FRAME_CLOCK_PHASE_LAYOUT &&
                       (priv->requested & GDK_FRAME_CLOCK_PHASE_LAYOUT))
-                    timings->layout_start_time = g_get_monotonic_time ();
+                    {
+                      timings->layout_start_time = g_get_monotonic_time ();
+                      timings->layout_start_allocations = gdk_profiler_get_n_allocations ();
+                    }
                 }
 #endif
 
@@ -617,11 +698,14 @@ gdk_frame_clock_paint_idle (void *data)
           if (!gdk_frame_clock_idle_is_frozen (clock_idle))
             {
 #ifdef G_ENABLE_DEBUG
-              if (GDK_DEBUG_CHECK (FRAMES))
+              if (GDK_DEBUG_CHECK (FRAMES) || GDK_PROFILER_IS_RUNNING)
                 {
                   if (priv->phase != GDK_FRAME_CLOCK_PHASE_PAINT &&
                       (priv->requested & GDK_FRAME_CLOCK_PHASE_PAINT))
-                    timings->paint_start_time = g_get_monotonic_time ();
+                    {
+                      timings->paint_start_time = g_get_monotonic_time ();
+                      timings->paint_start_allocations = gdk_profiler_get_n_allocations ();
+                    }
                 }
 #endif
 
@@ -639,15 +723,21 @@ gdk_frame_clock_paint_idle (void *data)
             {
               priv->requested &= ~GDK_FRAME_CLOCK_PHASE_AFTER_PAINT;
               _gdk_frame_clock_emit_after_paint (clock);
+              gdk_frame_clock_idle_update_cycle_duration (clock_idle);
               /* the ::after-paint phase doesn't get repeated on freeze/thaw,
                */
               priv->phase = GDK_FRAME_CLOCK_PHASE_NONE;
             }
 #ifdef G_ENABLE_DEBUG
-          if (GDK_DEBUG_CHECK (FRAMES))
+          if (GDK_DEBUG_CHECK (FRAMES) || GDK_PROFILER_IS_RUNNING)
             {
               if (timings)
-                timings->frame_end_time = g_get_monotonic_time ();
+                {
+                  timings->frame_end_time = g_get_monotonic_time ();
+                  timings->frame_end_allocations = gdk_profiler_get_n_allocations ();
+                }
+              if (GDK_PROFILER_IS_RUNNING)
+                gdk_profiler_flush_allocation_counters ();
             }
 #endif /* G_ENABLE_DEBUG */
           G_GNUC_FALLTHROUGH;
@@ -832,3 +922,29 @@ _gdk_frame_clock_idle_new (void)
 
   return GDK_FRAME_CLOCK (clock);
 }
+
+/*< private >
+ * _gdk_frame_clock_idle_set_variable_refresh:
+ * @self: a `GdkFrameClockIdle`
+ * @variable_refresh: whether frames are presented as soon as they are ready
+ *
+ * Tells the frame clock whether the output that the surface is on
+ * has a variable refresh rate. In that case, frame times are not
+ * aligned to the refresh interval anymore, the refresh interval
+ * only limits how often frames are drawn.
+ */
+void
+_gdk_frame_clock_idle_set_variable_refresh (GdkFrameClockIdle *self,
+                                            gboolean           variable_refresh)
+{
+  GdkFrameClockIdlePrivate *priv = self->priv;
+
+  variable_refresh = !!variable_refresh;
+  if (priv->variable_refresh == variable_refresh)
+    return;
+
+  priv->variable_refresh = variable_refresh;
+
+  /* Start over with the vblank phase detection either way */
+  priv->smooth_phase_state = SMOOTH_PHASE_STATE_AWAIT_FIRST;
+}
@@ -59,5 +59,8 @@ GType           gdk_frame_clock_idle_get_type       (void) G_GNUC_CONST;
 
 GdkFrameClock *_gdk_frame_clock_idle_new            (void);
 
+void           _gdk_frame_clock_idle_set_variable_refresh (GdkFrameClockIdle *self,
+                                                           gboolean           variable_refresh);
+
 G_END_DECLS
 
@@ -99,6 +99,9 @@ struct _GdkFrameTimings
   gint64 layout_start_time;
   gint64 paint_start_time;
   gint64 frame_end_time;
+  guint64 layout_start_allocations;
+  guint64 paint_start_allocations;
+  guint64 frame_end_allocations;
 #endif /* G_ENABLE_DEBUG */
 
   guint complete : 1;
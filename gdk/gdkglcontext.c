@@ -107,6 +107,8 @@ typedef struct {
   guint use_khr_debug : 1;
   guint has_half_float : 1;
   guint has_sync : 1;
+  guint has_program_binary : 1;
+  guint has_texture_compression_s3tc : 1;
   guint has_unpack_subimage : 1;
   guint has_debug_output : 1;
   guint extensions_checked : 1;
@@ -573,7 +575,7 @@ gdk_gl_context_get_scale (GdkGLContext *self)
   scale = gdk_surface_get_scale (surface);
 
   display = gdk_gl_context_get_display (self);
-  if (!(gdk_display_get_debug_flags (display) & GDK_DEBUG_GL_FRACTIONAL))
+  if (gdk_display_get_debug_flags (display) & GDK_DEBUG_GL_NO_FRACTIONAL)
     scale = ceil (scale);
 
   return scale;
@@ -1555,6 +1557,11 @@ gdk_gl_context_check_extensions (GdkGLContext *context)
                    epoxy_has_gl_extension ("GL_ARB_sync") ||
                    epoxy_has_gl_extension ("GL_APPLE_sync");
 
+  priv->has_program_binary = gdk_gl_context_check_version (context, "4.1", "3.0") ||
+                             epoxy_has_gl_extension ("GL_ARB_get_program_binary");
+
+  priv->has_texture_compression_s3tc = epoxy_has_gl_extension ("GL_EXT_texture_compression_s3tc");
+
 #ifdef G_ENABLE_DEBUG
   {
     int max_texture_size;
@@ -1567,7 +1574,9 @@ gdk_gl_context_check_extensions (GdkGLContext *context)
                        " - GL_KHR_debug: %s\n"
                        " - GL_EXT_unpack_subimage: %s\n"
                        " - half float: %s\n"
-                       " - sync: %s",
+                       " - sync: %s\n"
+                       " - program binary: %s\n"
+                       " - GL_EXT_texture_compression_s3tc: %s",
                        gdk_gl_context_get_use_es (context) ? "OpenGL ES" : "OpenGL",
                        gdk_gl_version_get_major (&priv->gl_version), gdk_gl_version_get_minor (&priv->gl_version),
                        priv->is_legacy ? "legacy" : "core",
@@ -1576,7 +1585,9 @@ gdk_gl_context_check_extensions (GdkGLContext *context)
                        priv->has_khr_debug ? "yes" : "no",
                        priv->has_unpack_subimage ? "yes" : "no",
                        priv->has_half_float ? "yes" : "no",
-                       priv->has_sync ? "yes" : "no");
+                       priv->has_sync ? "yes" : "no",
+                       priv->has_program_binary ? "yes" : "no",
+                       priv->has_texture_compression_s3tc ? "yes" : "no");
   }
 #endif
 
@@ -1812,6 +1823,186 @@ gdk_gl_context_has_sync (GdkGLContext *self)
   return priv->has_sync;
 }
 
+gboolean
+gdk_gl_context_has_program_binary (GdkGLContext *self)
+{
+  GdkGLContextPrivate *priv = gdk_gl_context_get_instance_private (self);
+
+  return priv->has_program_binary;
+}
+
+gboolean
+gdk_gl_context_has_texture_compression_s3tc (GdkGLContext *self)
+{
+  GdkGLContextPrivate *priv = gdk_gl_context_get_instance_private (self);
+
+  return priv->has_texture_compression_s3tc;
+}
+
+#ifdef HAVE_EGL
+static const EGLint plane_attribs[GDK_DMABUF_MAX_PLANES][5] = {
+  { EGL_DMA_BUF_PLANE0_FD_EXT, EGL_DMA_BUF_PLANE0_OFFSET_EXT, EGL_DMA_BUF_PLANE0_PITCH_EXT,
+    EGL_DMA_BUF_PLANE0_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE0_MODIFIER_HI_EXT },
+  { EGL_DMA_BUF_PLANE1_FD_EXT, EGL_DMA_BUF_PLANE1_OFFSET_EXT, EGL_DMA_BUF_PLANE1_PITCH_EXT,
+    EGL_DMA_BUF_PLANE1_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE1_MODIFIER_HI_EXT },
+  { EGL_DMA_BUF_PLANE2_FD_EXT, EGL_DMA_BUF_PLANE2_OFFSET_EXT, EGL_DMA_BUF_PLANE2_PITCH_EXT,
+    EGL_DMA_BUF_PLANE2_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE2_MODIFIER_HI_EXT },
+  { EGL_DMA_BUF_PLANE3_FD_EXT, EGL_DMA_BUF_PLANE3_OFFSET_EXT, EGL_DMA_BUF_PLANE3_PITCH_EXT,
+    EGL_DMA_BUF_PLANE3_MODIFIER_LO_EXT, EGL_DMA_BUF_PLANE3_MODIFIER_HI_EXT },
+};
+
+/* Formats that the driver can only sample via GL_TEXTURE_EXTERNAL_OES
+ * are of no use to us, as our shaders only sample GL_TEXTURE_2D.
+ */
+static gboolean
+gdk_gl_context_is_external_only (EGLDisplay  egl_display,
+                                 guint32     fourcc,
+                                 guint64     modifier)
+{
+  EGLuint64KHR *modifiers;
+  EGLBoolean *external_only;
+  EGLint n_modifiers, i;
+  gboolean result = FALSE;
+
+  if (!epoxy_has_egl_extension (egl_display, "EGL_EXT_image_dma_buf_import_modifiers"))
+    return FALSE;
+
+  if (!eglQueryDmaBufModifiersEXT (egl_display, fourcc, 0, NULL, NULL, &n_modifiers) ||
+      n_modifiers == 0)
+    return FALSE;
+
+  modifiers = g_new (EGLuint64KHR, n_modifiers);
+  external_only = g_new (EGLBoolean, n_modifiers);
+  eglQueryDmaBufModifiersEXT (egl_display, fourcc, n_modifiers, modifiers, external_only, &n_modifiers);
+
+  for (i = 0; i < n_modifiers; i++)
+    {
+      if (modifiers[i] == modifier)
+        {
+          result = external_only[i];
+          break;
+        }
+    }
+
+  g_free (modifiers);
+  g_free (external_only);
+
+  return result;
+}
+#endif
+
+/*
+ * gdk_gl_context_import_dmabuf:
+ * @self: a current `GdkGLContext`
+ * @width: the width of the buffer
+ * @height: the height of the buffer
+ * @dmabuf: the dmabuf to import
+ *
+ * Imports @dmabuf into a new GL_TEXTURE_2D via EGLImage, without
+ * copying the contents.
+ *
+ * The texture keeps the buffer alive on its own, so the caller is
+ * free to close the file descriptors afterwards.
+ *
+ * Returns: the new texture id or 0 if the buffer could not be
+ *   imported
+ */
+guint
+gdk_gl_context_import_dmabuf (GdkGLContext    *self,
+                              int              width,
+                              int              height,
+                              const GdkDmabuf *dmabuf)
+{
+#ifdef HAVE_EGL
+  GdkDisplay *display = gdk_gl_context_get_display (self);
+  EGLDisplay egl_display = gdk_display_get_egl_display (display);
+  EGLint attribs[6 + 10 * GDK_DMABUF_MAX_PLANES + 1];
+  gboolean use_modifiers;
+  EGLImageKHR image;
+  guint texture_id;
+  unsigned int i;
+  int n;
+
+  if (egl_display == EGL_NO_DISPLAY ||
+      !epoxy_has_egl_extension (egl_display, "EGL_EXT_image_dma_buf_import") ||
+      !epoxy_has_gl_extension ("GL_OES_EGL_image"))
+    {
+      GDK_DISPLAY_DEBUG (display, OPENGL, "Dmabuf import is not supported by EGL");
+      return 0;
+    }
+
+  if (dmabuf->modifier != DRM_FORMAT_MOD_INVALID &&
+      dmabuf->modifier != DRM_FORMAT_MOD_LINEAR &&
+      !epoxy_has_egl_extension (egl_display, "EGL_EXT_image_dma_buf_import_modifiers"))
+    {
+      GDK_DISPLAY_DEBUG (display, OPENGL, "Dmabuf modifiers are not supported by EGL");
+      return 0;
+    }
+
+  if (gdk_gl_context_is_external_only (egl_display, dmabuf->fourcc, dmabuf->modifier))
+    {
+      GDK_DISPLAY_DEBUG (display, OPENGL,
+                         "Dmabuf format %.4s:%#" G_GINT64_MODIFIER "x is external-only",
+                         (char *) &dmabuf->fourcc, dmabuf->modifier);
+      return 0;
+    }
+
+  use_modifiers = dmabuf->modifier != DRM_FORMAT_MOD_INVALID &&
+                  epoxy_has_egl_extension (egl_display, "EGL_EXT_image_dma_buf_import_modifiers");
+
+  n = 0;
+  attribs[n++] = EGL_WIDTH;
+  attribs[n++] = width;
+  attribs[n++] = EGL_HEIGHT;
+  attribs[n++] = height;
+  attribs[n++] = EGL_LINUX_DRM_FOURCC_EXT;
+  attribs[n++] = dmabuf->fourcc;
+
+  for (i = 0; i < dmabuf->n_planes; i++)
+    {
+      attribs[n++] = plane_attribs[i][0];
+      attribs[n++] = dmabuf->planes[i].fd;
+      attribs[n++] = plane_attribs[i][1];
+      attribs[n++] = dmabuf->planes[i].offset;
+      attribs[n++] = plane_attribs[i][2];
+      attribs[n++] = dmabuf->planes[i].stride;
+      if (use_modifiers)
+        {
+          attribs[n++] = plane_attribs[i][3];
+          attribs[n++] = dmabuf->modifier & 0xFFFFFFFF;
+          attribs[n++] = plane_attribs[i][4];
+          attribs[n++] = dmabuf->modifier >> 32;
+        }
+    }
+
+  attribs[n++] = EGL_NONE;
+
+  image = eglCreateImageKHR (egl_display,
+                             EGL_NO_CONTEXT,
+                             EGL_LINUX_DMA_BUF_EXT,
+                             (EGLClientBuffer) NULL,
+                             attribs);
+  if (image == EGL_NO_IMAGE_KHR)
+    {
+      GDK_DISPLAY_DEBUG (display, OPENGL, "Creating EGLImage for dmabuf failed: %#x", eglGetError ());
+      return 0;
+    }
+
+  glGenTextures (1, &texture_id);
+  glBindTexture (GL_TEXTURE_2D, texture_id);
+  glEGLImageTargetTexture2DOES (GL_TEXTURE_2D, image);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+  glTexParameteri (GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+  /* The texture holds its own reference on the buffer */
+  eglDestroyImageKHR (egl_display, image);
+
+  return texture_id;
+#else
+  return 0;
+#endif
+}
+
 /* This is currently private! */
 /* When using GL/ES, don't flip the 'R' and 'B' bits on Windows/ANGLE for glReadPixels() */
 gboolean
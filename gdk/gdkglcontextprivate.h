@@ -21,6 +21,7 @@
 #pragma once
 
 #include "gdkglcontext.h"
+#include "gdkdmabufprivate.h"
 #include "gdkdrawcontextprivate.h"
 #include "gdkglversionprivate.h"
 
@@ -155,7 +156,17 @@ gboolean                gdk_gl_context_has_vertex_half_float    (GdkGLContext
 
 gboolean                gdk_gl_context_has_sync                 (GdkGLContext    *self) G_GNUC_PURE;
 
+gboolean                gdk_gl_context_has_program_binary       (GdkGLContext    *self) G_GNUC_PURE;
+
+gboolean                gdk_gl_context_has_texture_compression_s3tc
+                                                                (GdkGLContext    *self) G_GNUC_PURE;
+
 double                  gdk_gl_context_get_scale                (GdkGLContext    *self);
 
+guint                   gdk_gl_context_import_dmabuf            (GdkGLContext    *self,
+                                                                 int              width,
+                                                                 int              height,
+                                                                 const GdkDmabuf *dmabuf);
+
 G_END_DECLS
 
@@ -166,6 +166,120 @@ gdk_gl_texture_find_format (gboolean         use_es,
   return FALSE;
 }
 
+/* Queries the format that glReadPixels() can give us for the currently
+ * bound framebuffer, falls back to RGBA8 if that's not one of ours.
+ */
+static GdkMemoryFormat
+gdk_gl_texture_get_read_format (GdkGLContext    *context,
+                                GdkMemoryFormat  format,
+                                GLint           *out_gl_format,
+                                GLint           *out_gl_type)
+{
+  GdkMemoryFormat actual_format;
+  int major, minor;
+
+  gdk_gl_context_get_version (context, &major, &minor);
+
+  if (gdk_gl_context_check_version (context, "4.3", "3.1"))
+    {
+      glGetFramebufferParameteriv (GL_FRAMEBUFFER, GL_IMPLEMENTATION_COLOR_READ_FORMAT, out_gl_format);
+      glGetFramebufferParameteriv (GL_FRAMEBUFFER, GL_IMPLEMENTATION_COLOR_READ_TYPE, out_gl_type);
+      if (gdk_gl_texture_find_format (TRUE, major, minor, gdk_memory_format_alpha (format), *out_gl_format, *out_gl_type, &actual_format))
+        return actual_format;
+    }
+
+  *out_gl_format = GL_RGBA;
+  *out_gl_type = GL_UNSIGNED_BYTE;
+  if (gdk_memory_format_alpha (format) == GDK_MEMORY_ALPHA_PREMULTIPLIED)
+    return GDK_MEMORY_R8G8B8A8_PREMULTIPLIED; /* pray */
+  else
+    return GDK_MEMORY_R8G8B8A8;
+}
+
+/* Fix up gles inadequacies */
+static void
+gdk_gl_texture_fixup_read_pixels (GdkMemoryFormat  format,
+                                  GLint            gl_read_format,
+                                  GLint            gl_read_type,
+                                  guchar          *pixels,
+                                  gsize            stride,
+                                  gsize            actual_bpp,
+                                  int              width,
+                                  int              height)
+{
+  if (gl_read_format == GL_RGBA &&
+      gl_read_type == GL_UNSIGNED_BYTE &&
+      (format == GDK_MEMORY_G8A8 ||
+       format == GDK_MEMORY_G8A8_PREMULTIPLIED ||
+       format == GDK_MEMORY_G8 ||
+       format == GDK_MEMORY_A8))
+    {
+      for (unsigned int y = 0; y < height; y++)
+        {
+          for (unsigned int x = 0; x < width; x++)
+            {
+              guchar *data = &pixels[y * stride + x * actual_bpp];
+              if (format == GDK_MEMORY_G8A8 ||
+                  format == GDK_MEMORY_G8A8_PREMULTIPLIED)
+                {
+                  data[3] = data[1];
+                  data[1] = data[0];
+                  data[2] = data[0];
+                }
+              else if (format == GDK_MEMORY_G8)
+                {
+                  data[1] = data[0];
+                  data[2] = data[0];
+                  data[3] = 0xff;
+                }
+              else if (format == GDK_MEMORY_A8)
+                {
+                  data[3] = data[0];
+                  data[0] = 0;
+                  data[1] = 0;
+                  data[2] = 0;
+                }
+            }
+        }
+    }
+
+  if (gl_read_format == GL_RGBA &&
+      gl_read_type == GL_UNSIGNED_SHORT &&
+      (format == GDK_MEMORY_G16A16 ||
+       format == GDK_MEMORY_G16A16_PREMULTIPLIED ||
+       format == GDK_MEMORY_G16 ||
+       format == GDK_MEMORY_A16))
+    {
+      for (unsigned int y = 0; y < height; y++)
+        {
+          for (unsigned int x = 0; x < width; x++)
+            {
+              guint16 *data = (guint16 *) &pixels[y * stride + x * actual_bpp];
+              if (format == GDK_MEMORY_G16A16 ||
+                  format == GDK_MEMORY_G16A16_PREMULTIPLIED)
+                {
+                  data[3] = data[1];
+                  data[1] = data[0];
+                  data[2] = data[0];
+                }
+              else if (format == GDK_MEMORY_G16)
+                {
+                  data[1] = data[0];
+                  data[2] = data[0];
+                  data[3] = 0xffff;
+                }
+              else if (format == GDK_MEMORY_A16)
+                {
+                  data[3] = data[0];
+                  data[0] = 0;
+                  data[1] = 0;
+                  data[2] = 0;
+                }
+            }
+        }
+    }
+}
+
 static inline void
 gdk_gl_texture_do_download (GdkGLTexture *self,
                             GdkGLContext *context,
@@ -233,29 +347,7 @@ gdk_gl_texture_do_download (GdkGLTexture *self,
       glGenFramebuffers (1, &fbo);
       glBindFramebuffer (GL_FRAMEBUFFER, fbo);
       glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->id, 0);
-      if (gdk_gl_context_check_version (context, "4.3", "3.1"))
-        {
-          glGetFramebufferParameteriv (GL_FRAMEBUFFER, GL_IMPLEMENTATION_COLOR_READ_FORMAT, &gl_read_format);
-          glGetFramebufferParameteriv (GL_FRAMEBUFFER, GL_IMPLEMENTATION_COLOR_READ_TYPE, &gl_read_type);
-          if (!gdk_gl_texture_find_format (TRUE, major, minor, gdk_memory_format_alpha (format), gl_read_format, gl_read_type, &actual_format))
-            {
-              gl_read_format = GL_RGBA;
-              gl_read_type = GL_UNSIGNED_BYTE;
-              if (gdk_memory_format_alpha (format) == GDK_MEMORY_ALPHA_PREMULTIPLIED)
-                actual_format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED; /* pray */
-              else
-                actual_format = GDK_MEMORY_R8G8B8A8;
-            }
-        }
-      else
-        {
-          gl_read_format = GL_RGBA;
-          gl_read_type = GL_UNSIGNED_BYTE;
-          if (gdk_memory_format_alpha (format) == GDK_MEMORY_ALPHA_PREMULTIPLIED)
-            actual_format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED; /* pray */
-          else
-            actual_format = GDK_MEMORY_R8G8B8A8;
-        }
+      actual_format = gdk_gl_texture_get_read_format (context, format, &gl_read_format, &gl_read_type);
 
       if (download->format == actual_format &&
           (download->stride == expected_stride))
@@ -279,79 +371,10 @@ gdk_gl_texture_do_download (GdkGLTexture *self,
                         gl_read_type,
                         pixels);
 
-          /* Fix up gles inadequacies */
-
-          if (gl_read_format == GL_RGBA &&
-              gl_read_type == GL_UNSIGNED_BYTE &&
-              (format == GDK_MEMORY_G8A8 ||
-               format == GDK_MEMORY_G8A8_PREMULTIPLIED ||
-               format == GDK_MEMORY_G8 ||
-               format == GDK_MEMORY_A8))
-            {
-              for (unsigned int y = 0; y < texture->height; y++)
-                {
-                  for (unsigned int x = 0; x < texture->width; x++)
-                    {
-                      guchar *data = &pixels[y * stride + x * actual_bpp];
-                      if (format == GDK_MEMORY_G8A8 ||
-                          format == GDK_MEMORY_G8A8_PREMULTIPLIED)
-                        {
-                          data[3] = data[1];
-                          data[1] = data[0];
-                          data[2] = data[0];
-                        }
-                      else if (format == GDK_MEMORY_G8)
-                        {
-                          data[1] = data[0];
-                          data[2] = data[0];
-                          data[3] = 0xff;
-                        }
-                      else if (format == GDK_MEMORY_A8)
-                        {
-                          data[3] = data[0];
-                          data[0] = 0;
-                          data[1] = 0;
-                          data[2] = 0;
-                        }
-                    }
-                }
-            }
-
-          if (gl_read_format == GL_RGBA &&
-              gl_read_type == GL_UNSIGNED_SHORT &&
-              (format == GDK_MEMORY_G16A16 ||
-               format == GDK_MEMORY_G16A16_PREMULTIPLIED ||
-               format == GDK_MEMORY_G16 ||
-               format == GDK_MEMORY_A16))
-            {
-              for (unsigned int y = 0; y < texture->height; y++)
-                {
-                  for (unsigned int x = 0; x < texture->width; x++)
-                    {
-                      guint16 *data = (guint16 *) &pixels[y * stride + x * actual_bpp];
-                      if (format == GDK_MEMORY_G16A16 ||
-                          format == GDK_MEMORY_G16A16_PREMULTIPLIED)
-                        {
-                          data[3] = data[1];
-                          data[1] = data[0];
-                          data[2] = data[0];
-                        }
-                      else if (format == GDK_MEMORY_G16)
-                        {
-                          data[1] = data[0];
-                          data[2] = data[0];
-                          data[3] = 0xffff;
-                        }
-                      else if (format == GDK_MEMORY_A16)
-                        {
-                          data[3] = data[0];
-                          data[0] = 0;
-                          data[1] = 0;
-                          data[2] = 0;
-                        }
-                    }
-                }
-            }
+          gdk_gl_texture_fixup_read_pixels (format,
+                                            gl_read_format, gl_read_type,
+                                            pixels, stride, actual_bpp,
+                                            texture->width, texture->height);
 
           gdk_memory_convert (download->data,
                               download->stride,
@@ -391,6 +414,192 @@ gdk_gl_texture_download (GdkTexture      *texture,
   gdk_gl_texture_run (self, gdk_gl_texture_do_download, &download);
 }
 
+typedef struct _AsyncDownload AsyncDownload;
+
+struct _AsyncDownload
+{
+  GdkMemoryFormat format;
+  GdkMemoryFormat actual_format;
+  GLint gl_read_format;
+  GLint gl_read_type;
+  GLuint buffer;
+  GLsync sync;
+};
+
+static gboolean
+gdk_gl_texture_download_poll (gpointer data)
+{
+  GTask *task = data;
+  GdkTexture *texture = g_task_get_source_object (task);
+  GdkGLTexture *self = GDK_GL_TEXTURE (texture);
+  AsyncDownload *async = g_task_get_task_data (task);
+  GdkGLContext *context;
+  gsize actual_bpp, actual_stride, stride;
+  guchar *pixels, *data_out;
+
+  context = gdk_display_get_gl_context (gdk_gl_context_get_display (self->context));
+  gdk_gl_context_make_current (context);
+
+  if (g_task_return_error_if_cancelled (task))
+    goto out;
+
+  if (glClientWaitSync (async->sync, 0, 0) == GL_TIMEOUT_EXPIRED)
+    return G_SOURCE_CONTINUE;
+
+  actual_bpp = gdk_memory_format_bytes_per_pixel (async->actual_format);
+  actual_stride = actual_bpp * texture->width;
+  stride = texture->width * gdk_memory_format_bytes_per_pixel (async->format);
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, async->buffer);
+  pixels = glMapBufferRange (GL_PIXEL_PACK_BUFFER, 0, actual_stride * texture->height, GL_MAP_READ_BIT);
+  if (pixels == NULL)
+    {
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+      g_task_return_new_error (task, G_IO_ERROR, G_IO_ERROR_FAILED,
+                               "Failed to map download buffer");
+      goto out;
+    }
+
+  data_out = g_malloc_n (stride, texture->height);
+
+  if (async->actual_format != gdk_texture_get_format (texture))
+    {
+      /* The fixups work in place, and the mapping is read-only */
+      guchar *copy = g_memdup2 (pixels, actual_stride * texture->height);
+
+      gdk_gl_texture_fixup_read_pixels (gdk_texture_get_format (texture),
+                                        async->gl_read_format, async->gl_read_type,
+                                        copy, actual_stride, actual_bpp,
+                                        texture->width, texture->height);
+      gdk_memory_convert (data_out, stride, async->format,
+                          copy, actual_stride, async->actual_format,
+                          texture->width, texture->height);
+      g_free (copy);
+    }
+  else
+    {
+      gdk_memory_convert (data_out, stride, async->format,
+                          pixels, actual_stride, async->actual_format,
+                          texture->width, texture->height);
+    }
+
+  glUnmapBuffer (GL_PIXEL_PACK_BUFFER);
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+  g_task_return_pointer (task,
+                         g_bytes_new_take (data_out, stride * texture->height),
+                         (GDestroyNotify) g_bytes_unref);
+
+out:
+  glDeleteSync (async->sync);
+  glDeleteBuffers (1, &async->buffer);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gdk_gl_texture_do_download_async (GdkGLTexture *self,
+                                  GdkGLContext *context,
+                                  gpointer      task_)
+{
+  GTask *task = task_;
+  GdkTexture *texture = GDK_TEXTURE (self);
+  AsyncDownload *async = g_task_get_task_data (task);
+  GLenum gl_internal_format, gl_format, gl_type;
+  GLint gl_swizzle[4];
+  int major, minor;
+  GSource *source;
+
+  gdk_gl_context_get_version (context, &major, &minor);
+
+  if (!gdk_gl_context_get_use_es (context) &&
+      gdk_memory_format_gl_format (texture->format,
+                                   FALSE,
+                                   major, minor,
+                                   &gl_internal_format,
+                                   &gl_format, &gl_type, gl_swizzle))
+    {
+      async->actual_format = texture->format;
+      async->gl_read_format = gl_format;
+      async->gl_read_type = gl_type;
+
+      glGenBuffers (1, &async->buffer);
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, async->buffer);
+      glBufferData (GL_PIXEL_PACK_BUFFER,
+                    gdk_memory_format_bytes_per_pixel (async->actual_format) * texture->width * texture->height,
+                    NULL,
+                    GL_STREAM_READ);
+      glPixelStorei (GL_PACK_ALIGNMENT, 1);
+      glGetTexImage (GL_TEXTURE_2D, 0, gl_format, gl_type, NULL);
+    }
+  else
+    {
+      GLuint fbo;
+
+      glGenFramebuffers (1, &fbo);
+      glBindFramebuffer (GL_FRAMEBUFFER, fbo);
+      glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, self->id, 0);
+      async->actual_format = gdk_gl_texture_get_read_format (context,
+                                                             texture->format,
+                                                             &async->gl_read_format,
+                                                             &async->gl_read_type);
+
+      glGenBuffers (1, &async->buffer);
+      glBindBuffer (GL_PIXEL_PACK_BUFFER, async->buffer);
+      glBufferData (GL_PIXEL_PACK_BUFFER,
+                    gdk_memory_format_bytes_per_pixel (async->actual_format) * texture->width * texture->height,
+                    NULL,
+                    GL_STREAM_READ);
+      glPixelStorei (GL_PACK_ALIGNMENT, 1);
+      glReadPixels (0, 0,
+                    texture->width, texture->height,
+                    async->gl_read_format,
+                    async->gl_read_type,
+                    NULL);
+
+      glBindFramebuffer (GL_FRAMEBUFFER, 0);
+      glDeleteFramebuffers (1, &fbo);
+    }
+
+  glBindBuffer (GL_PIXEL_PACK_BUFFER, 0);
+
+  async->sync = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+  glFlush ();
+
+  /* Polling happens in the main context, where the GL context is used */
+  source = g_timeout_source_new (1);
+  g_source_set_callback (source, gdk_gl_texture_download_poll, g_object_ref (task), g_object_unref);
+  g_source_set_static_name (source, "[gtk] GL texture download");
+  g_source_attach (source, NULL);
+  g_source_unref (source);
+}
+
+static void
+gdk_gl_texture_download_async (GdkTexture      *texture,
+                               GdkMemoryFormat  format,
+                               GTask           *task)
+{
+  GdkGLTexture *self = GDK_GL_TEXTURE (texture);
+  AsyncDownload *async;
+
+  /* Without fences and mapped buffers there's nothing to overlap with,
+   * so fall back to a synchronous download in a thread.
+   */
+  if (self->saved ||
+      !gdk_gl_context_check_version (self->context, "3.0", "3.0") ||
+      !gdk_gl_context_has_sync (self->context))
+    {
+      GDK_TEXTURE_CLASS (gdk_gl_texture_parent_class)->download_async (texture, format, task);
+      return;
+    }
+
+  async = g_new0 (AsyncDownload, 1);
+  async->format = format;
+  g_task_set_task_data (task, async, g_free);
+
+  gdk_gl_texture_run (self, gdk_gl_texture_do_download_async, task);
+}
+
 static void
 gdk_gl_texture_class_init (GdkGLTextureClass *klass)
 {
@@ -398,6 +607,7 @@ gdk_gl_texture_class_init (GdkGLTextureClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   texture_class->download = gdk_gl_texture_download;
+  texture_class->download_async = gdk_gl_texture_download_async;
 
   gobject_class->dispose = gdk_gl_texture_dispose;
 }
@@ -21,10 +21,20 @@
 
 #include "gdkmemoryformatprivate.h"
 
+#include "gdkmemoryformatavx2private.h"
+#include "gdkparalleltaskprivate.h"
 #include "gsk/gl/fp16private.h"
 
 #include <epoxy/gl.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define USE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON 1
+#endif
+
 typedef struct _GdkMemoryFormatDescription GdkMemoryFormatDescription;
 
 #define TYPED_FUNCS(name, T, R, G, B, A, bpp, scale) \
@@ -267,11 +277,260 @@ a32_float_from_float (guchar      *dest_data,
     }
 }
 
-#define PREMULTIPLY_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+/* The 8-bit conversions below are the ones used when uploading and
+ * downloading images, so they have SIMD versions. The SIMD versions
+ * handle blocks of pixels and return how many they did, the rest is
+ * done by the C version.
+ *
+ * SSE2 and NEON are part of the baseline of x86_64 and aarch64, so
+ * they are used unconditionally. AVX2 is checked for at runtime.
+ */
+typedef gsize (* SimdFunc) (guchar *dest, const guchar *src, gsize n);
+typedef void (* ScalarFunc) (guchar *dest, const guchar *src, gsize n);
+
+#ifdef HAVE_AVX2
+static gboolean
+have_avx2 (void)
+{
+  static gboolean result = FALSE;
+  static gsize inited = 0;
+
+  if (g_once_init_enter (&inited))
+    {
+      __builtin_cpu_init ();
+      result = __builtin_cpu_supports ("avx2");
+
+      g_once_init_leave (&inited, 1);
+    }
+
+  return result;
+}
+#define AVX2_FUNC(name) name##_avx2
+#else
+#define AVX2_FUNC(name) NULL
+#endif
+
+#if defined(USE_SSE2) || defined(USE_NEON)
+#define SIMD_FUNC(name) name##_simd
+#else
+#define SIMD_FUNC(name) NULL
+#endif
+
+static inline void
+convert_pixels (guchar       *dest,
+                gsize         dest_bpp,
+                const guchar *src,
+                gsize         src_bpp,
+                gsize         n,
+                SimdFunc      avx2_func,
+                SimdFunc      simd_func,
+                ScalarFunc    func)
+{
+  gsize done;
+
+#ifdef HAVE_AVX2
+  if (avx2_func && have_avx2 ())
+    {
+      done = avx2_func (dest, src, n);
+      dest += done * dest_bpp;
+      src += done * src_bpp;
+      n -= done;
+    }
+#endif
+
+  if (simd_func)
+    {
+      done = simd_func (dest, src, n);
+      dest += done * dest_bpp;
+      src += done * src_bpp;
+      n -= done;
+    }
+
+  func (dest, src, n);
+}
+
+#define CONVERT_FUNC(name, dest_bpp, src_bpp, avx2_func, simd_func) \
 static void \
 name (guchar *dest, \
       const guchar *src, \
       gsize n) \
+{ \
+  convert_pixels (dest, dest_bpp, src, src_bpp, n, avx2_func, simd_func, name##_c); \
+}
+
+#ifdef USE_SSE2
+/* SSE2 has no byte shuffle, so pixels are widened to 16 bits per
+ * channel and reordered with word shuffles.
+ */
+#define SHUFFLE(R1, G1, B1, A1, R2, G2, B2, A2) \
+  (((R1) << (2 * (R2))) | ((G1) << (2 * (G2))) | ((B1) << (2 * (B2))) | ((A1) << (2 * (A2))))
+
+#define SHUFFLE_EPI16(x, imm) _mm_shufflehi_epi16 (_mm_shufflelo_epi16 ((x), (imm)), (imm))
+
+#define ALPHA_MASK(A) \
+  _mm_set_epi16 ((A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0, \
+                 (A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0)
+
+#define PREMULTIPLY_EPI16(x, A) G_STMT_START { \
+  __m128i a_ = SHUFFLE_EPI16 ((x), (A) * 0x55); \
+  __m128i t_ = _mm_add_epi16 (_mm_mullo_epi16 ((x), a_), _mm_set1_epi16 (127)); \
+  t_ = _mm_add_epi16 (t_, _mm_add_epi16 (_mm_srli_epi16 (t_, 8), _mm_set1_epi16 (1))); \
+  t_ = _mm_srli_epi16 (t_, 8); \
+  (x) = _mm_or_si128 (_mm_and_si128 (alpha_mask, (x)), _mm_andnot_si128 (alpha_mask, t_)); \
+} G_STMT_END
+
+#define PREMULTIPLY_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static gsize \
+name##_simd (guchar       *dest, \
+             const guchar *src, \
+             gsize         n) \
+{ \
+  const __m128i zero = _mm_setzero_si128 (); \
+  const __m128i alpha_mask = ALPHA_MASK (A1); \
+  gsize i; \
+\
+  for (i = 0; i + 4 <= n; i += 4) \
+    { \
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (src + 4 * i)); \
+      __m128i lo = _mm_unpacklo_epi8 (v, zero); \
+      __m128i hi = _mm_unpackhi_epi8 (v, zero); \
+\
+      PREMULTIPLY_EPI16 (lo, A1); \
+      PREMULTIPLY_EPI16 (hi, A1); \
+      lo = SHUFFLE_EPI16 (lo, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+      hi = SHUFFLE_EPI16 (hi, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+\
+      _mm_storeu_si128 ((__m128i *) (dest + 4 * i), _mm_packus_epi16 (lo, hi)); \
+    } \
+\
+  return i; \
+}
+
+#define SWIZZLE_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static gsize \
+name##_simd (guchar       *dest, \
+             const guchar *src, \
+             gsize         n) \
+{ \
+  const __m128i zero = _mm_setzero_si128 (); \
+  gsize i; \
+\
+  for (i = 0; i + 4 <= n; i += 4) \
+    { \
+      __m128i v = _mm_loadu_si128 ((const __m128i *) (src + 4 * i)); \
+      __m128i lo = _mm_unpacklo_epi8 (v, zero); \
+      __m128i hi = _mm_unpackhi_epi8 (v, zero); \
+\
+      lo = SHUFFLE_EPI16 (lo, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+      hi = SHUFFLE_EPI16 (hi, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+\
+      _mm_storeu_si128 ((__m128i *) (dest + 4 * i), _mm_packus_epi16 (lo, hi)); \
+    } \
+\
+  return i; \
+}
+
+/* 3-byte pixels don't fit SSE2 well, leave them to the C code */
+#define ADD_ALPHA_SIMD_FUNC(name, R1, G1, B1, R2, G2, B2, A2)
+#define ADD_ALPHA_SIMD(name) NULL
+
+#elif defined(USE_NEON)
+/* NEON loads and stores can (de)interleave channels for us */
+static inline uint8x16_t
+premultiply_neon (uint8x16_t c,
+                  uint8x16_t a)
+{
+  uint16x8_t lo = vmlal_u8 (vdupq_n_u16 (127), vget_low_u8 (c), vget_low_u8 (a));
+  uint16x8_t hi = vmlal_u8 (vdupq_n_u16 (127), vget_high_u8 (c), vget_high_u8 (a));
+
+  lo = vaddq_u16 (lo, vaddq_u16 (vshrq_n_u16 (lo, 8), vdupq_n_u16 (1)));
+  hi = vaddq_u16 (hi, vaddq_u16 (vshrq_n_u16 (hi, 8), vdupq_n_u16 (1)));
+
+  return vcombine_u8 (vshrn_n_u16 (lo, 8), vshrn_n_u16 (hi, 8));
+}
+
+#define PREMULTIPLY_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static gsize \
+name##_simd (guchar       *dest, \
+             const guchar *src, \
+             gsize         n) \
+{ \
+  gsize i; \
+\
+  for (i = 0; i + 16 <= n; i += 16) \
+    { \
+      uint8x16x4_t s = vld4q_u8 (src + 4 * i); \
+      uint8x16x4_t d; \
+\
+      d.val[R2] = premultiply_neon (s.val[R1], s.val[A1]); \
+      d.val[G2] = premultiply_neon (s.val[G1], s.val[A1]); \
+      d.val[B2] = premultiply_neon (s.val[B1], s.val[A1]); \
+      d.val[A2] = s.val[A1]; \
+      vst4q_u8 (dest + 4 * i, d); \
+    } \
+\
+  return i; \
+}
+
+#define SWIZZLE_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static gsize \
+name##_simd (guchar       *dest, \
+             const guchar *src, \
+             gsize         n) \
+{ \
+  gsize i; \
+\
+  for (i = 0; i + 16 <= n; i += 16) \
+    { \
+      uint8x16x4_t s = vld4q_u8 (src + 4 * i); \
+      uint8x16x4_t d; \
+\
+      d.val[R2] = s.val[R1]; \
+      d.val[G2] = s.val[G1]; \
+      d.val[B2] = s.val[B1]; \
+      d.val[A2] = s.val[A1]; \
+      vst4q_u8 (dest + 4 * i, d); \
+    } \
+\
+  return i; \
+}
+
+#define ADD_ALPHA_SIMD_FUNC(name, R1, G1, B1, R2, G2, B2, A2) \
+static gsize \
+name##_simd (guchar       *dest, \
+             const guchar *src, \
+             gsize         n) \
+{ \
+  gsize i; \
+\
+  for (i = 0; i + 16 <= n; i += 16) \
+    { \
+      uint8x16x3_t s = vld3q_u8 (src + 3 * i); \
+      uint8x16x4_t d; \
+\
+      d.val[R2] = s.val[R1]; \
+      d.val[G2] = s.val[G1]; \
+      d.val[B2] = s.val[B1]; \
+      d.val[A2] = vdupq_n_u8 (255); \
+      vst4q_u8 (dest + 4 * i, d); \
+    } \
+\
+  return i; \
+}
+#define ADD_ALPHA_SIMD(name) name##_simd
+
+#else
+#define PREMULTIPLY_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2)
+#define SWIZZLE_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2)
+#define ADD_ALPHA_SIMD_FUNC(name, R1, G1, B1, R2, G2, B2, A2)
+#define ADD_ALPHA_SIMD(name) NULL
+#endif
+
+#define PREMULTIPLY_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static void \
+name##_c (guchar *dest, \
+          const guchar *src, \
+          gsize n) \
 { \
   for (; n > 0; n--) \
     { \
@@ -286,18 +545,45 @@ name (guchar *dest, \
       dest += 4; \
       src += 4; \
     } \
-}
+} \
+PREMULTIPLY_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+CONVERT_FUNC(name, 4, 4, AVX2_FUNC (name), SIMD_FUNC (name))
 
 PREMULTIPLY_FUNC(r8g8b8a8_to_r8g8b8a8_premultiplied, 0, 1, 2, 3, 0, 1, 2, 3)
 PREMULTIPLY_FUNC(r8g8b8a8_to_b8g8r8a8_premultiplied, 0, 1, 2, 3, 2, 1, 0, 3)
 PREMULTIPLY_FUNC(r8g8b8a8_to_a8r8g8b8_premultiplied, 0, 1, 2, 3, 1, 2, 3, 0)
 PREMULTIPLY_FUNC(r8g8b8a8_to_a8b8g8r8_premultiplied, 0, 1, 2, 3, 3, 2, 1, 0)
 
+#define SWIZZLE_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+static void \
+name##_c (guchar *dest, \
+          const guchar *src, \
+          gsize n) \
+{ \
+  for (; n > 0; n--) \
+    { \
+      guchar r = src[R1], g = src[G1], b = src[B1], a = src[A1]; \
+      dest[R2] = r; \
+      dest[G2] = g; \
+      dest[B2] = b; \
+      dest[A2] = a; \
+      dest += 4; \
+      src += 4; \
+    } \
+} \
+SWIZZLE_SIMD_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+CONVERT_FUNC(name, 4, 4, AVX2_FUNC (name), SIMD_FUNC (name))
+
+SWIZZLE_FUNC(r8g8b8a8_to_b8g8r8a8, 0, 1, 2, 3, 2, 1, 0, 3)
+SWIZZLE_FUNC(r8g8b8a8_to_a8b8g8r8, 0, 1, 2, 3, 3, 2, 1, 0)
+SWIZZLE_FUNC(r8g8b8a8_to_a8r8g8b8, 0, 1, 2, 3, 1, 2, 3, 0)
+SWIZZLE_FUNC(a8r8g8b8_to_r8g8b8a8, 1, 2, 3, 0, 0, 1, 2, 3)
+
 #define ADD_ALPHA_FUNC(name, R1, G1, B1, R2, G2, B2, A2) \
 static void \
-name (guchar *dest, \
-      const guchar *src, \
-      gsize n) \
+name##_c (guchar *dest, \
+          const guchar *src, \
+          gsize n) \
 { \
   for (; n > 0; n--) \
     { \
@@ -308,7 +594,9 @@ name (guchar *dest, \
       dest += 4; \
       src += 3; \
     } \
-}
+} \
+ADD_ALPHA_SIMD_FUNC(name, R1, G1, B1, R2, G2, B2, A2) \
+CONVERT_FUNC(name, 4, 3, NULL, ADD_ALPHA_SIMD (name))
 
 ADD_ALPHA_FUNC(r8g8b8_to_r8g8b8a8, 0, 1, 2, 0, 1, 2, 3)
 ADD_ALPHA_FUNC(r8g8b8_to_b8g8r8a8, 0, 1, 2, 2, 1, 0, 3)
@@ -793,15 +1081,15 @@ unpremultiply (float *rgba,
     }
 }
 
-void
-gdk_memory_convert (guchar              *dest_data,
-                    gsize                dest_stride,
-                    GdkMemoryFormat      dest_format,
-                    const guchar        *src_data,
-                    gsize                src_stride,
-                    GdkMemoryFormat      src_format,
-                    gsize                width,
-                    gsize                height)
+static void
+gdk_memory_convert_rows (guchar              *dest_data,
+                         gsize                dest_stride,
+                         GdkMemoryFormat      dest_format,
+                         const guchar        *src_data,
+                         gsize                src_stride,
+                         GdkMemoryFormat      src_format,
+                         gsize                width,
+                         gsize                height)
 {
   const GdkMemoryFormatDescription *dest_desc = &memory_formats[dest_format];
   const GdkMemoryFormatDescription *src_desc = &memory_formats[src_format];
@@ -868,6 +1156,38 @@ gdk_memory_convert (guchar              *dest_data,
     func = r8g8b8_to_a8r8g8b8;
   else if (src_format == GDK_MEMORY_B8G8R8 && dest_format == GDK_MEMORY_A8R8G8B8)
     func = r8g8b8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_R8G8B8A8_PREMULTIPLIED && dest_format == GDK_MEMORY_B8G8R8A8_PREMULTIPLIED)
+    func = r8g8b8a8_to_b8g8r8a8;
+  else if (src_format == GDK_MEMORY_B8G8R8A8_PREMULTIPLIED && dest_format == GDK_MEMORY_R8G8B8A8_PREMULTIPLIED)
+    func = r8g8b8a8_to_b8g8r8a8;
+  else if (src_format == GDK_MEMORY_B8G8R8A8_PREMULTIPLIED && dest_format == GDK_MEMORY_A8R8G8B8_PREMULTIPLIED)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_A8R8G8B8_PREMULTIPLIED && dest_format == GDK_MEMORY_B8G8R8A8_PREMULTIPLIED)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_R8G8B8A8_PREMULTIPLIED && dest_format == GDK_MEMORY_A8R8G8B8_PREMULTIPLIED)
+    func = r8g8b8a8_to_a8r8g8b8;
+  else if (src_format == GDK_MEMORY_A8R8G8B8_PREMULTIPLIED && dest_format == GDK_MEMORY_R8G8B8A8_PREMULTIPLIED)
+    func = a8r8g8b8_to_r8g8b8a8;
+  else if (src_format == GDK_MEMORY_R8G8B8A8 && dest_format == GDK_MEMORY_B8G8R8A8)
+    func = r8g8b8a8_to_b8g8r8a8;
+  else if (src_format == GDK_MEMORY_B8G8R8A8 && dest_format == GDK_MEMORY_R8G8B8A8)
+    func = r8g8b8a8_to_b8g8r8a8;
+  else if (src_format == GDK_MEMORY_B8G8R8A8 && dest_format == GDK_MEMORY_A8R8G8B8)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_A8R8G8B8 && dest_format == GDK_MEMORY_B8G8R8A8)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_R8G8B8A8 && dest_format == GDK_MEMORY_A8R8G8B8)
+    func = r8g8b8a8_to_a8r8g8b8;
+  else if (src_format == GDK_MEMORY_A8R8G8B8 && dest_format == GDK_MEMORY_R8G8B8A8)
+    func = a8r8g8b8_to_r8g8b8a8;
+  else if (src_format == GDK_MEMORY_R8G8B8A8 && dest_format == GDK_MEMORY_A8B8G8R8)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_A8B8G8R8 && dest_format == GDK_MEMORY_R8G8B8A8)
+    func = r8g8b8a8_to_a8b8g8r8;
+  else if (src_format == GDK_MEMORY_B8G8R8A8 && dest_format == GDK_MEMORY_A8B8G8R8)
+    func = r8g8b8a8_to_a8r8g8b8;
+  else if (src_format == GDK_MEMORY_A8B8G8R8 && dest_format == GDK_MEMORY_B8G8R8A8)
+    func = a8r8g8b8_to_r8g8b8a8;
 
   if (func != NULL)
     {
@@ -880,6 +1200,41 @@ gdk_memory_convert (guchar              *dest_data,
       return;
     }
 
+  /* If one side already is RGBA floats, convert straight to or from
+   * it instead of going through a temporary row.
+   */
+  if (dest_desc->from_float == r32g32b32a32_float_from_float &&
+      (gsize) dest_data % G_ALIGNOF (float) == 0 &&
+      dest_stride % G_ALIGNOF (float) == 0)
+    {
+      for (y = 0; y < height; y++)
+        {
+          src_desc->to_float ((float *) dest_data, src_data, width);
+          if (src_desc->alpha == GDK_MEMORY_ALPHA_PREMULTIPLIED && dest_desc->alpha == GDK_MEMORY_ALPHA_STRAIGHT)
+            unpremultiply ((float *) dest_data, width);
+          else if (src_desc->alpha == GDK_MEMORY_ALPHA_STRAIGHT && dest_desc->alpha != GDK_MEMORY_ALPHA_STRAIGHT)
+            premultiply ((float *) dest_data, width);
+          src_data += src_stride;
+          dest_data += dest_stride;
+        }
+      return;
+    }
+
+  if (src_desc->to_float == r32g32b32a32_float_to_float &&
+      !(src_desc->alpha == GDK_MEMORY_ALPHA_PREMULTIPLIED && dest_desc->alpha == GDK_MEMORY_ALPHA_STRAIGHT) &&
+      !(src_desc->alpha == GDK_MEMORY_ALPHA_STRAIGHT && dest_desc->alpha != GDK_MEMORY_ALPHA_STRAIGHT) &&
+      (gsize) src_data % G_ALIGNOF (float) == 0 &&
+      src_stride % G_ALIGNOF (float) == 0)
+    {
+      for (y = 0; y < height; y++)
+        {
+          dest_desc->from_float (dest_data, (const float *) src_data, width);
+          src_data += src_stride;
+          dest_data += dest_stride;
+        }
+      return;
+    }
+
   tmp = g_new (float, width * 4);
 
   for (y = 0; y < height; y++)
@@ -896,3 +1251,89 @@ gdk_memory_convert (guchar              *dest_data,
 
   g_free (tmp);
 }
+
+/* Images smaller than this are converted on the calling thread */
+#define PARALLEL_CONVERT_MIN_PIXELS (1024 * 1024)
+/* How many pixels each task converts at a time */
+#define PARALLEL_CONVERT_CHUNK_PIXELS (128 * 1024)
+
+typedef struct _MemoryConvert MemoryConvert;
+
+struct _MemoryConvert
+{
+  guchar              *dest_data;
+  gsize                dest_stride;
+  GdkMemoryFormat      dest_format;
+  const guchar        *src_data;
+  gsize                src_stride;
+  GdkMemoryFormat      src_format;
+  gsize                width;
+  gsize                height;
+  gsize                rows_per_chunk;
+
+  /* atomic */ int     next_chunk;
+};
+
+static void
+gdk_memory_convert_task (gpointer data)
+{
+  MemoryConvert *mc = data;
+  gsize y, n_rows;
+
+  for (y = g_atomic_int_add (&mc->next_chunk, 1) * mc->rows_per_chunk;
+       y < mc->height;
+       y = g_atomic_int_add (&mc->next_chunk, 1) * mc->rows_per_chunk)
+    {
+      n_rows = MIN (mc->rows_per_chunk, mc->height - y);
+
+      gdk_memory_convert_rows (mc->dest_data + y * mc->dest_stride,
+                               mc->dest_stride,
+                               mc->dest_format,
+                               mc->src_data + y * mc->src_stride,
+                               mc->src_stride,
+                               mc->src_format,
+                               mc->width,
+                               n_rows);
+    }
+}
+
+void
+gdk_memory_convert (guchar              *dest_data,
+                    gsize                dest_stride,
+                    GdkMemoryFormat      dest_format,
+                    const guchar        *src_data,
+                    gsize                src_stride,
+                    GdkMemoryFormat      src_format,
+                    gsize                width,
+                    gsize                height)
+{
+  MemoryConvert mc;
+  gsize n_chunks;
+
+  g_assert (dest_format < GDK_MEMORY_N_FORMATS);
+  g_assert (src_format < GDK_MEMORY_N_FORMATS);
+
+  if (width * height < PARALLEL_CONVERT_MIN_PIXELS)
+    {
+      gdk_memory_convert_rows (dest_data, dest_stride, dest_format,
+                               src_data, src_stride, src_format,
+                               width, height);
+      return;
+    }
+
+  mc = (MemoryConvert) {
+    .dest_data = dest_data,
+    .dest_stride = dest_stride,
+    .dest_format = dest_format,
+    .src_data = src_data,
+    .src_stride = src_stride,
+    .src_format = src_format,
+    .width = width,
+    .height = height,
+    .rows_per_chunk = MAX (1, PARALLEL_CONVERT_CHUNK_PIXELS / width),
+    .next_chunk = 0,
+  };
+  n_chunks = (height + mc.rows_per_chunk - 1) / mc.rows_per_chunk;
+
+  gdk_parallel_task_run (gdk_memory_convert_task, &mc, MIN (n_chunks, G_MAXUINT));
+}
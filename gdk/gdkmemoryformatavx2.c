@@ -0,0 +1,123 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkmemoryformatavx2private.h"
+
+#ifdef HAVE_AVX2
+#include <immintrin.h>
+
+/* This file is compiled with -mavx2, the functions in here must
+ * only be called after checking the CPU supports it.
+ */
+
+/* Selector for word shuffles: dest channel X2 comes from source channel X1 */
+#define SHUFFLE(R1, G1, B1, A1, R2, G2, B2, A2) \
+  (((R1) << (2 * (R2))) | ((G1) << (2 * (G2))) | ((B1) << (2 * (B2))) | ((A1) << (2 * (A2))))
+
+#define SHUFFLE_EPI16(x, imm) _mm256_shufflehi_epi16 (_mm256_shufflelo_epi16 ((x), (imm)), (imm))
+
+#define ALPHA_MASK(A) \
+  _mm256_set_epi16 ((A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0, \
+                    (A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0, \
+                    (A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0, \
+                    (A) == 3 ? -1 : 0, (A) == 2 ? -1 : 0, (A) == 1 ? -1 : 0, (A) == 0 ? -1 : 0)
+
+/* For premultiplying, pixels are widened to 16 bits per channel and
+ * alpha is broadcast with in-lane word shuffles. Unpacking and packing
+ * are in-lane too, so the pixel order is preserved.
+ *
+ * This uses the same rounding as the C version.
+ */
+#define PREMULTIPLY_EPI16(x, A) G_STMT_START { \
+  __m256i a_ = SHUFFLE_EPI16 ((x), (A) * 0x55); \
+  __m256i t_ = _mm256_add_epi16 (_mm256_mullo_epi16 ((x), a_), _mm256_set1_epi16 (127)); \
+  t_ = _mm256_add_epi16 (t_, _mm256_add_epi16 (_mm256_srli_epi16 (t_, 8), _mm256_set1_epi16 (1))); \
+  t_ = _mm256_srli_epi16 (t_, 8); \
+  (x) = _mm256_or_si256 (_mm256_and_si256 (alpha_mask, (x)), _mm256_andnot_si256 (alpha_mask, t_)); \
+} G_STMT_END
+
+#define PREMULTIPLY_FUNC(name, R1, G1, B1, A1, R2, G2, B2, A2) \
+gsize \
+name (guchar       *dest, \
+      const guchar *src, \
+      gsize         n) \
+{ \
+  const __m256i zero = _mm256_setzero_si256 (); \
+  const __m256i alpha_mask = ALPHA_MASK (A1); \
+  gsize i; \
+\
+  for (i = 0; i + 8 <= n; i += 8) \
+    { \
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (src + 4 * i)); \
+      __m256i lo = _mm256_unpacklo_epi8 (v, zero); \
+      __m256i hi = _mm256_unpackhi_epi8 (v, zero); \
+\
+      PREMULTIPLY_EPI16 (lo, A1); \
+      PREMULTIPLY_EPI16 (hi, A1); \
+      lo = SHUFFLE_EPI16 (lo, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+      hi = SHUFFLE_EPI16 (hi, SHUFFLE (R1, G1, B1, A1, R2, G2, B2, A2)); \
+\
+      _mm256_storeu_si256 ((__m256i *) (dest + 4 * i), _mm256_packus_epi16 (lo, hi)); \
+    } \
+\
+  return i; \
+}
+
+PREMULTIPLY_FUNC(r8g8b8a8_to_r8g8b8a8_premultiplied_avx2, 0, 1, 2, 3, 0, 1, 2, 3)
+PREMULTIPLY_FUNC(r8g8b8a8_to_b8g8r8a8_premultiplied_avx2, 0, 1, 2, 3, 2, 1, 0, 3)
+PREMULTIPLY_FUNC(r8g8b8a8_to_a8r8g8b8_premultiplied_avx2, 0, 1, 2, 3, 1, 2, 3, 0)
+PREMULTIPLY_FUNC(r8g8b8a8_to_a8b8g8r8_premultiplied_avx2, 0, 1, 2, 3, 3, 2, 1, 0)
+
+/* Source byte for dest channel c, for byte shuffles */
+#define SEL(c, R1, G1, B1, A1, R2, G2, B2, A2) \
+  ((R2) == (c) ? (R1) : (G2) == (c) ? (G1) : (B2) == (c) ? (B1) : (A1))
+
+#define PIXEL_SEL(p, ...) \
+  4 * (p) + SEL (0, __VA_ARGS__), 4 * (p) + SEL (1, __VA_ARGS__), \
+  4 * (p) + SEL (2, __VA_ARGS__), 4 * (p) + SEL (3, __VA_ARGS__)
+
+/* Channel reordering doesn't need widening, a byte shuffle does it */
+#define SWIZZLE_FUNC(name, ...) \
+gsize \
+name (guchar       *dest, \
+      const guchar *src, \
+      gsize         n) \
+{ \
+  const __m256i mask = _mm256_setr_epi8 (PIXEL_SEL (0, __VA_ARGS__), PIXEL_SEL (1, __VA_ARGS__), \
+                                         PIXEL_SEL (2, __VA_ARGS__), PIXEL_SEL (3, __VA_ARGS__), \
+                                         PIXEL_SEL (0, __VA_ARGS__), PIXEL_SEL (1, __VA_ARGS__), \
+                                         PIXEL_SEL (2, __VA_ARGS__), PIXEL_SEL (3, __VA_ARGS__)); \
+  gsize i; \
+\
+  for (i = 0; i + 8 <= n; i += 8) \
+    { \
+      __m256i v = _mm256_loadu_si256 ((const __m256i *) (src + 4 * i)); \
+\
+      _mm256_storeu_si256 ((__m256i *) (dest + 4 * i), _mm256_shuffle_epi8 (v, mask)); \
+    } \
+\
+  return i; \
+}
+
+SWIZZLE_FUNC(r8g8b8a8_to_b8g8r8a8_avx2, 0, 1, 2, 3, 2, 1, 0, 3)
+SWIZZLE_FUNC(r8g8b8a8_to_a8b8g8r8_avx2, 0, 1, 2, 3, 3, 2, 1, 0)
+SWIZZLE_FUNC(r8g8b8a8_to_a8r8g8b8_avx2, 0, 1, 2, 3, 1, 2, 3, 0)
+SWIZZLE_FUNC(a8r8g8b8_to_r8g8b8a8_avx2, 1, 2, 3, 0, 0, 1, 2, 3)
+
+#endif
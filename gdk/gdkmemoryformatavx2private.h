@@ -0,0 +1,41 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+#ifdef HAVE_AVX2
+
+/* These convert as many pixels as they can in blocks of 8 and
+ * return the number of pixels they converted.
+ */
+gsize   r8g8b8a8_to_r8g8b8a8_premultiplied_avx2 (guchar *dest, const guchar *src, gsize n);
+gsize   r8g8b8a8_to_b8g8r8a8_premultiplied_avx2 (guchar *dest, const guchar *src, gsize n);
+gsize   r8g8b8a8_to_a8r8g8b8_premultiplied_avx2 (guchar *dest, const guchar *src, gsize n);
+gsize   r8g8b8a8_to_a8b8g8r8_premultiplied_avx2 (guchar *dest, const guchar *src, gsize n);
+
+gsize   r8g8b8a8_to_b8g8r8a8_avx2               (guchar *dest, const guchar *src, gsize n);
+gsize   r8g8b8a8_to_a8b8g8r8_avx2               (guchar *dest, const guchar *src, gsize n);
+gsize   r8g8b8a8_to_a8r8g8b8_avx2               (guchar *dest, const guchar *src, gsize n);
+gsize   a8r8g8b8_to_r8g8b8a8_avx2               (guchar *dest, const guchar *src, gsize n);
+
+#endif
+
+G_END_DECLS
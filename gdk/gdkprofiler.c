@@ -160,3 +160,83 @@ void
   sysprof_collector_set_counters (&id, &value, 1);
 #endif
 }
+
+typedef struct {
+  guint counter_id;
+  guint64 flushed;
+} AllocationCounter;
+
+/* Slot 0 is never used, so that an unset id doesn't count
+ * into a defined counter.
+ */
+guint64 gdk_profiler_allocations[GDK_PROFILER_MAX_ALLOCATION_COUNTERS];
+static AllocationCounter allocation_counters[GDK_PROFILER_MAX_ALLOCATION_COUNTERS];
+static guint n_allocation_counters = 1;
+
+/*< private >
+ * gdk_profiler_define_allocation_counter:
+ * @name: (not nullable): a static string naming the allocated objects
+ * @description: a description for the profiler counter
+ *
+ * Defines a counter for allocations of a kind of object. Allocations
+ * are counted with gdk_profiler_count_allocation(), and reported per
+ * frame as profiler counters.
+ *
+ * Returns: the id to pass to gdk_profiler_count_allocation()
+ */
+guint
+gdk_profiler_define_allocation_counter (const char *name,
+                                        const char *description)
+{
+  AllocationCounter *counter;
+
+  g_return_val_if_fail (n_allocation_counters < GDK_PROFILER_MAX_ALLOCATION_COUNTERS, 0);
+
+  counter = &allocation_counters[n_allocation_counters];
+  counter->counter_id = gdk_profiler_define_int_counter (name, description);
+
+  return n_allocation_counters++;
+}
+
+/*< private >
+ * gdk_profiler_get_n_allocations:
+ *
+ * Gets the number of allocations that have been counted so far,
+ * for all kinds of objects. Subtracting two values gives the number
+ * of allocations in between.
+ *
+ * Returns: the number of allocations
+ */
+guint64
+gdk_profiler_get_n_allocations (void)
+{
+  guint64 total = 0;
+  guint i;
+
+  for (i = 1; i < n_allocation_counters; i++)
+    total += gdk_profiler_allocations[i];
+
+  return total;
+}
+
+/*< private >
+ * gdk_profiler_flush_allocation_counters:
+ *
+ * Sets the profiler counter of every kind of object to the number
+ * of its allocations since the last flush. This is called at the
+ * end of every frame.
+ */
+void
+gdk_profiler_flush_allocation_counters (void)
+{
+  guint i;
+
+  for (i = 1; i < n_allocation_counters; i++)
+    {
+      AllocationCounter *counter = &allocation_counters[i];
+      guint64 value = gdk_profiler_allocations[i];
+
+      gdk_profiler_set_int_counter (counter->counter_id, value - counter->flushed);
+      counter->flushed = value;
+    }
+}
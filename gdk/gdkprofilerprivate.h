@@ -71,6 +71,24 @@ void    gdk_profiler_set_counter        (guint  id,
 void    gdk_profiler_set_int_counter    (guint  id,
                                          gint64 value);
 
+/* Allocation counters count how often frequently created objects
+ * are allocated, so allocations per frame can be tracked. Counting
+ * only happens in debug builds.
+ */
+#define GDK_PROFILER_MAX_ALLOCATION_COUNTERS 8
+
+guint   gdk_profiler_define_allocation_counter (const char *name,
+                                                const char *description);
+guint64 gdk_profiler_get_n_allocations         (void);
+void    gdk_profiler_flush_allocation_counters (void);
+
+#ifdef G_ENABLE_DEBUG
+extern guint64 gdk_profiler_allocations[GDK_PROFILER_MAX_ALLOCATION_COUNTERS];
+#define gdk_profiler_count_allocation(id) (gdk_profiler_allocations[(id)]++)
+#else
+#define gdk_profiler_count_allocation(id) G_STMT_START {} G_STMT_END
+#endif
+
 #ifndef HAVE_SYSPROF
 #define gdk_profiler_add_mark(b, d, n, m) G_STMT_START {} G_STMT_END
 #define gdk_profiler_end_mark(b, n, m) G_STMT_START {} G_STMT_END
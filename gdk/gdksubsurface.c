@@ -0,0 +1,132 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdksubsurfaceprivate.h"
+
+#include "gdksurfaceprivate.h"
+
+/* A GdkSubsurface is a child surface that the windowing system
+ * composites on top of its parent. Renderers use it to hand a texture
+ * to the compositor directly instead of drawing it themselves.
+ *
+ * Changes to a subsurface take effect when the parent surface presents
+ * its next frame.
+ */
+
+G_DEFINE_ABSTRACT_TYPE (GdkSubsurface, gdk_subsurface, G_TYPE_OBJECT)
+
+static void
+gdk_subsurface_init (GdkSubsurface *self)
+{
+}
+
+static void
+gdk_subsurface_class_init (GdkSubsurfaceClass *class)
+{
+}
+
+/*< private >
+ * gdk_subsurface_get_parent:
+ * @subsurface: a `GdkSubsurface`
+ *
+ * Returns the surface that @subsurface is stacked on.
+ *
+ * Returns: (transfer none): the parent surface
+ */
+GdkSurface *
+gdk_subsurface_get_parent (GdkSubsurface *subsurface)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), NULL);
+
+  return subsurface->parent;
+}
+
+/*< private >
+ * gdk_subsurface_attach:
+ * @subsurface: a `GdkSubsurface`
+ * @texture: the texture to show
+ * @rect: the area to show it in, in surface coordinates of the parent
+ *
+ * Makes @subsurface show @texture in @rect.
+ *
+ * Backends only accept textures they can hand to the compositor
+ * as-is, and rectangles they can position exactly. If this function
+ * returns %FALSE, the subsurface is detached and the caller needs
+ * to draw the texture itself.
+ *
+ * Returns: %TRUE if @texture was attached
+ */
+gboolean
+gdk_subsurface_attach (GdkSubsurface         *subsurface,
+                       GdkTexture            *texture,
+                       const graphene_rect_t *rect)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), FALSE);
+  g_return_val_if_fail (GDK_IS_TEXTURE (texture), FALSE);
+  g_return_val_if_fail (rect != NULL, FALSE);
+
+  return GDK_SUBSURFACE_GET_CLASS (subsurface)->attach (subsurface, texture, rect);
+}
+
+/*< private >
+ * gdk_subsurface_detach:
+ * @subsurface: a `GdkSubsurface`
+ *
+ * Hides @subsurface and releases its texture.
+ */
+void
+gdk_subsurface_detach (GdkSubsurface *subsurface)
+{
+  g_return_if_fail (GDK_IS_SUBSURFACE (subsurface));
+
+  GDK_SUBSURFACE_GET_CLASS (subsurface)->detach (subsurface);
+}
+
+/*< private >
+ * gdk_subsurface_get_texture:
+ * @subsurface: a `GdkSubsurface`
+ *
+ * Returns the texture that is currently attached.
+ *
+ * Returns: (nullable) (transfer none): the attached texture
+ */
+GdkTexture *
+gdk_subsurface_get_texture (GdkSubsurface *subsurface)
+{
+  g_return_val_if_fail (GDK_IS_SUBSURFACE (subsurface), NULL);
+
+  return GDK_SUBSURFACE_GET_CLASS (subsurface)->get_texture (subsurface);
+}
+
+/*< private >
+ * gdk_subsurface_get_rect:
+ * @subsurface: a `GdkSubsurface`
+ * @rect: (out caller-allocates): return location for the rectangle
+ *
+ * Returns the area that the attached texture is shown in.
+ */
+void
+gdk_subsurface_get_rect (GdkSubsurface   *subsurface,
+                         graphene_rect_t *rect)
+{
+  g_return_if_fail (GDK_IS_SUBSURFACE (subsurface));
+  g_return_if_fail (rect != NULL);
+
+  GDK_SUBSURFACE_GET_CLASS (subsurface)->get_rect (subsurface, rect);
+}
@@ -48,6 +48,11 @@
 
 #ifdef HAVE_EGL
 #include <epoxy/egl.h>
+
+/* from EGL_ANGLE_direct_composition */
+#ifndef EGL_DIRECT_COMPOSITION_ANGLE
+#define EGL_DIRECT_COMPOSITION_ANGLE 0x33A5
+#endif
 #endif
 
 /**
@@ -954,6 +959,8 @@ _gdk_surface_destroy_hierarchy (GdkSurface *surface,
   if (GDK_SURFACE_DESTROYED (surface))
     return;
 
+  g_clear_object (&surface->subsurface);
+
   GDK_SURFACE_GET_CLASS (surface)->destroy (surface, foreign_destroy);
 
   /* backend must have unset this */
@@ -1143,11 +1150,32 @@ gdk_surface_ensure_egl_surface (GdkSurface *self,
 
   if (priv->egl_surface == NULL)
     {
-      priv->egl_surface = eglCreateWindowSurface (gdk_display_get_egl_display (display),
-                                                  high_depth ? gdk_display_get_egl_config_high_depth (display)
-                                                             : gdk_display_get_egl_config (display),
-                                                  (EGLNativeWindowType) priv->egl_native_window,
-                                                  NULL);
+      EGLConfig config = high_depth ? gdk_display_get_egl_config_high_depth (display)
+                                    : gdk_display_get_egl_config (display);
+
+      /* With ANGLE, present through a DirectComposition visual. That uses a
+       * flip model swap chain, which avoids a copy and a frame of latency
+       * compared to the default blit model. Not all windows can be targeted
+       * by DirectComposition, so fall back to a regular surface on failure.
+       */
+      if (display->have_egl_direct_composition)
+        {
+          const EGLint attribs[] = {
+            EGL_DIRECT_COMPOSITION_ANGLE, EGL_TRUE,
+            EGL_NONE
+          };
+
+          priv->egl_surface = eglCreateWindowSurface (gdk_display_get_egl_display (display),
+                                                      config,
+                                                      (EGLNativeWindowType) priv->egl_native_window,
+                                                      attribs);
+        }
+
+      if (priv->egl_surface == NULL)
+        priv->egl_surface = eglCreateWindowSurface (gdk_display_get_egl_display (display),
+                                                    config,
+                                                    (EGLNativeWindowType) priv->egl_native_window,
+                                                    NULL);
       priv->egl_surface_high_depth = high_depth;
     }
 #endif
@@ -2281,6 +2309,7 @@ _gdk_windowing_got_event (GdkDisplay *display,
    */
   _gdk_event_queue_handle_motion_compression (display);
   gdk_event_queue_handle_scroll_compression (display);
+  gdk_event_queue_handle_touchpad_compression (display);
 
   if (event_surface)
     {
@@ -2341,6 +2370,31 @@ gdk_surface_create_similar_surface (GdkSurface      *surface,
   return similar_surface;
 }
 
+/*< private >
+ * gdk_surface_get_subsurface:
+ * @surface: a `GdkSurface`
+ *
+ * Returns the subsurface stacked on top of @surface, creating it
+ * the first time this is called.
+ *
+ * Returns: (nullable) (transfer none): the subsurface, or %NULL
+ *   if the backend does not support subsurfaces
+ */
+GdkSubsurface *
+gdk_surface_get_subsurface (GdkSurface *surface)
+{
+  g_return_val_if_fail (GDK_IS_SURFACE (surface), NULL);
+
+  if (GDK_SURFACE_DESTROYED (surface))
+    return NULL;
+
+  if (surface->subsurface == NULL &&
+      GDK_SURFACE_GET_CLASS (surface)->create_subsurface)
+    surface->subsurface = GDK_SURFACE_GET_CLASS (surface)->create_subsurface (surface);
+
+  return surface->subsurface;
+}
+
 /* This function is called when the XWindow is really gone.
  */
 void
@@ -23,6 +23,7 @@
 #include "gdkenumtypes.h"
 #include "gdksurface.h"
 #include "gdktoplevel.h"
+#include "gdksubsurfaceprivate.h"
 
 G_BEGIN_DECLS
 
@@ -92,6 +93,8 @@ struct _GdkSurface
   cairo_region_t *opaque_region;
 
   GdkSeat *current_shortcuts_inhibited_seat;
+
+  GdkSubsurface *subsurface;
 };
 
 struct _GdkSurfaceClass
@@ -146,6 +149,9 @@ struct _GdkSurfaceClass
                                            cairo_region_t *region);
   void         (* request_layout)         (GdkSurface     *surface);
   gboolean     (* compute_size)           (GdkSurface     *surface);
+
+  GdkSubsurface *
+               (* create_subsurface)      (GdkSurface     *surface);
 };
 
 #define GDK_SURFACE_DESTROYED(d) (((GdkSurface *)(d))->destroyed)
@@ -258,6 +264,8 @@ void       gdk_surface_leave_monitor (GdkSurface *surface,
 
 void gdk_surface_destroy_notify       (GdkSurface *surface);
 
+GdkSubsurface * gdk_surface_get_subsurface (GdkSurface *surface);
+
 void gdk_synthesize_surface_state (GdkSurface     *surface,
                                    GdkToplevelState unset_flags,
                                    GdkToplevelState set_flags);
@@ -41,6 +41,7 @@
 #include "gdktextureprivate.h"
 
 #include <glib/gi18n-lib.h>
+#include "gdkmemoryformatprivate.h"
 #include "gdkmemorytextureprivate.h"
 #include "gdkpaintable.h"
 #include "gdksnapshot.h"
@@ -230,6 +231,39 @@ gdk_texture_default_download (GdkTexture      *texture,
   GDK_TEXTURE_WARN_NOT_IMPLEMENTED_METHOD (texture, download);
 }
 
+static void
+gdk_texture_download_thread (GTask        *task,
+                             gpointer      source_object,
+                             gpointer      task_data,
+                             GCancellable *cancellable)
+{
+  GdkTexture *texture = source_object;
+  GdkMemoryFormat format = GPOINTER_TO_UINT (task_data);
+  gsize stride;
+  guchar *data;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  stride = texture->width * gdk_memory_format_bytes_per_pixel (format);
+  data = g_malloc_n (stride, texture->height);
+
+  gdk_texture_do_download (texture, format, data, stride);
+
+  g_task_return_pointer (task,
+                         g_bytes_new_take (data, stride * texture->height),
+                         (GDestroyNotify) g_bytes_unref);
+}
+
+static void
+gdk_texture_default_download_async (GdkTexture      *texture,
+                                    GdkMemoryFormat  format,
+                                    GTask           *task)
+{
+  g_task_set_task_data (task, GUINT_TO_POINTER (format), NULL);
+  g_task_run_in_thread (task, gdk_texture_download_thread);
+}
+
 static void
 gdk_texture_set_property (GObject      *gobject,
                           guint         prop_id,
@@ -296,6 +330,7 @@ gdk_texture_class_init (GdkTextureClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   klass->download = gdk_texture_default_download;
+  klass->download_async = gdk_texture_default_download_async;
 
   gobject_class->set_property = gdk_texture_set_property;
   gobject_class->get_property = gdk_texture_get_property;
@@ -507,6 +542,8 @@ gdk_texture_can_load (GBytes *bytes)
 
 static GdkTexture *
 gdk_texture_new_from_bytes_internal (GBytes  *bytes,
+                                     int      width,
+                                     int      height,
                                      GError **error)
 {
   if (gdk_is_png (bytes))
@@ -515,7 +552,7 @@ gdk_texture_new_from_bytes_internal (GBytes  *bytes,
     }
   else if (gdk_is_jpeg (bytes))
     {
-      return gdk_load_jpeg (bytes, error);
+      return gdk_load_jpeg_at_size (bytes, width, height, error);
     }
   else if (gdk_is_tiff (bytes))
     {
@@ -574,6 +611,34 @@ gdk_texture_new_from_bytes_pixbuf (GBytes  *bytes,
 GdkTexture *
 gdk_texture_new_from_bytes (GBytes  *bytes,
                             GError **error)
+{
+  g_return_val_if_fail (bytes != NULL, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  return gdk_texture_new_from_bytes_at_size (bytes, 0, 0, error);
+}
+
+/*<private>
+ * gdk_texture_new_from_bytes_at_size:
+ * @bytes: a `GBytes` containing the data to load
+ * @width: the width the texture will be drawn at, or 0
+ * @height: the height the texture will be drawn at, or 0
+ * @error: Return location for an error
+ *
+ * Like [ctor@Gdk.Texture.new_from_bytes], but allows the loader
+ * to decode the image at a reduced size, as long as the result is
+ * at least @width x @height. Loaders that can't do this ignore
+ * the size.
+ *
+ * Currently, this is only done for JPEG.
+ *
+ * Return value: A newly-created `GdkTexture`
+ */
+GdkTexture *
+gdk_texture_new_from_bytes_at_size (GBytes  *bytes,
+                                    int      width,
+                                    int      height,
+                                    GError **error)
 {
   GdkTexture *texture;
   GError *internal_error = NULL;
@@ -581,7 +646,7 @@ gdk_texture_new_from_bytes (GBytes  *bytes,
   g_return_val_if_fail (bytes != NULL, NULL);
   g_return_val_if_fail (error == NULL || *error == NULL, NULL);
 
-  texture = gdk_texture_new_from_bytes_internal (bytes, &internal_error);
+  texture = gdk_texture_new_from_bytes_internal (bytes, width, height, &internal_error);
   if (texture)
     return texture;
 
@@ -597,6 +662,239 @@ gdk_texture_new_from_bytes (GBytes  *bytes,
   return gdk_texture_new_from_bytes_pixbuf (bytes, error);
 }
 
+typedef struct
+{
+  GInputStream *stream;
+  GdkTextureProgressFunc progress;
+  gpointer progress_data;
+  GDestroyNotify progress_destroy;
+} StreamLoad;
+
+typedef struct
+{
+  GTask *task;
+  GdkTexture *texture;
+} StreamLoadProgress;
+
+static void
+stream_load_free (gpointer data)
+{
+  StreamLoad *load = data;
+
+  if (load->progress_destroy)
+    load->progress_destroy (load->progress_data);
+
+  g_object_unref (load->stream);
+  g_free (load);
+}
+
+static void
+stream_load_progress_free (gpointer data)
+{
+  StreamLoadProgress *progress = data;
+
+  g_object_unref (progress->task);
+  g_object_unref (progress->texture);
+  g_free (progress);
+}
+
+static gboolean
+stream_load_progress_dispatch (gpointer data)
+{
+  StreamLoadProgress *progress = data;
+  StreamLoad *load = g_task_get_task_data (progress->task);
+
+  /* Don't report partial textures once the result is out */
+  if (!g_task_get_completed (progress->task) &&
+      !g_cancellable_is_cancelled (g_task_get_cancellable (progress->task)))
+    load->progress (progress->texture, load->progress_data);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Called in the loading thread */
+static void
+stream_load_progress (GdkTexture *texture,
+                      gpointer    data)
+{
+  GTask *task = data;
+  StreamLoadProgress *progress;
+  GSource *source;
+
+  progress = g_new (StreamLoadProgress, 1);
+  progress->task = g_object_ref (task);
+  progress->texture = g_object_ref (texture);
+
+  source = g_idle_source_new ();
+  g_source_set_priority (source, g_task_get_priority (task));
+  g_source_set_callback (source,
+                         stream_load_progress_dispatch,
+                         progress,
+                         stream_load_progress_free);
+  g_source_set_static_name (source, "[gtk] texture load progress");
+  g_source_attach (source, g_task_get_context (task));
+  g_source_unref (source);
+}
+
+static void
+stream_load_thread (GTask        *task,
+                    gpointer      source_object,
+                    gpointer      task_data,
+                    GCancellable *cancellable)
+{
+  StreamLoad *load = task_data;
+  GBufferedInputStream *buffered;
+  GdkTextureProgressFunc progress;
+  GdkTexture *texture = NULL;
+  GBytes *header;
+  const guchar *data;
+  gsize size;
+  GError *error = NULL;
+
+  buffered = G_BUFFERED_INPUT_STREAM (g_buffered_input_stream_new (load->stream));
+
+  /* Read enough to sniff the format */
+  while (g_buffered_input_stream_get_available (buffered) < 16)
+    {
+      gssize n_read;
+
+      n_read = g_buffered_input_stream_fill (buffered,
+                                             16 - g_buffered_input_stream_get_available (buffered),
+                                             cancellable,
+                                             &error);
+      if (n_read < 0)
+        goto out;
+      if (n_read == 0)
+        break;
+    }
+
+  data = g_buffered_input_stream_peek_buffer (buffered, &size);
+  header = g_bytes_new_static (data, size);
+
+  progress = load->progress ? stream_load_progress : NULL;
+
+  if (gdk_is_png (header))
+    {
+      texture = gdk_load_png_from_stream (G_INPUT_STREAM (buffered), cancellable,
+                                          progress, task,
+                                          &error);
+    }
+  else if (gdk_is_jpeg (header))
+    {
+      texture = gdk_load_jpeg_from_stream (G_INPUT_STREAM (buffered), cancellable,
+                                           progress, task,
+                                           &error);
+    }
+  else
+    {
+      /* Other formats can't be decoded incrementally */
+      GOutputStream *output;
+      GBytes *bytes;
+
+      output = g_memory_output_stream_new_resizable ();
+      if (g_output_stream_splice (output,
+                                  G_INPUT_STREAM (buffered),
+                                  G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET,
+                                  cancellable,
+                                  &error) >= 0)
+        {
+          bytes = g_memory_output_stream_steal_as_bytes (G_MEMORY_OUTPUT_STREAM (output));
+          texture = gdk_texture_new_from_bytes (bytes, &error);
+          g_bytes_unref (bytes);
+        }
+
+      g_object_unref (output);
+    }
+
+  g_bytes_unref (header);
+
+out:
+  g_object_unref (buffered);
+
+  if (texture)
+    g_task_return_pointer (task, texture, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
+
+/**
+ * gdk_texture_new_from_stream_async:
+ * @stream: the `GInputStream` to read the image from
+ * @cancellable: (nullable): optional `GCancellable` object
+ * @progress: (nullable) (scope notified) (closure progress_data) (destroy progress_destroy):
+ *   function to call with partially loaded textures
+ * @progress_data: data for @progress
+ * @progress_destroy: (nullable): destroy notify for @progress_data
+ * @callback: (scope async): callback to call when the texture is loaded
+ * @user_data: (closure callback): data for @callback
+ *
+ * Asynchronously creates a new texture by loading an image from
+ * a stream.
+ *
+ * The stream is read and decoded in a thread, so that loading
+ * large or slowly arriving images does not block the main thread.
+ *
+ * For PNG and JPEG images, @progress is called in the thread-default
+ * main context of the caller with textures showing the part of the
+ * image that has been decoded so far. This is after every scan of a
+ * progressive JPEG, after every pass of an interlaced PNG, and after
+ * every eighth of the rows otherwise. Other formats are read completely
+ * before they are decoded, and don't report progress.
+ *
+ * Since: 4.14
+ */
+void
+gdk_texture_new_from_stream_async (GInputStream           *stream,
+                                   GCancellable           *cancellable,
+                                   GdkTextureProgressFunc  progress,
+                                   gpointer                progress_data,
+                                   GDestroyNotify          progress_destroy,
+                                   GAsyncReadyCallback     callback,
+                                   gpointer                user_data)
+{
+  StreamLoad *load;
+  GTask *task;
+
+  g_return_if_fail (G_IS_INPUT_STREAM (stream));
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  load = g_new (StreamLoad, 1);
+  load->stream = g_object_ref (stream);
+  load->progress = progress;
+  load->progress_data = progress_data;
+  load->progress_destroy = progress_destroy;
+
+  task = g_task_new (NULL, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gdk_texture_new_from_stream_async);
+  g_task_set_task_data (task, load, stream_load_free);
+  g_task_run_in_thread (task, stream_load_thread);
+  g_object_unref (task);
+}
+
+/**
+ * gdk_texture_new_from_stream_finish:
+ * @result: a `GAsyncResult`
+ * @error: Return location for an error
+ *
+ * Finishes an asynchronous load started with
+ * [func@Gdk.Texture.new_from_stream_async].
+ *
+ * If %NULL is returned, then @error will be set.
+ *
+ * Returns: (transfer full) (nullable): the loaded texture
+ *
+ * Since: 4.14
+ */
+GdkTexture *
+gdk_texture_new_from_stream_finish (GAsyncResult  *result,
+                                    GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, NULL), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gdk_texture_new_from_stream_async, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
 /**
  * gdk_texture_new_from_filename:
  * @path: (type filename): the filename to load
@@ -636,6 +934,44 @@ gdk_texture_new_from_filename (const char  *path,
   return texture;
 }
 
+/*<private>
+ * gdk_texture_new_from_filename_at_size:
+ * @path: (type filename): the filename to load
+ * @width: the width the texture will be drawn at, or 0
+ * @height: the height the texture will be drawn at, or 0
+ * @error: Return location for an error
+ *
+ * Like [ctor@Gdk.Texture.new_from_filename], with the size hint
+ * of [func@Gdk.Texture.new_from_bytes_at_size].
+ *
+ * Return value: A newly-created `GdkTexture`
+ */
+GdkTexture *
+gdk_texture_new_from_filename_at_size (const char  *path,
+                                       int          width,
+                                       int          height,
+                                       GError     **error)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+  GFile *file;
+
+  g_return_val_if_fail (path, NULL);
+  g_return_val_if_fail (error == NULL || *error == NULL, NULL);
+
+  file = g_file_new_for_path (path);
+  bytes = g_file_load_bytes (file, NULL, NULL, error);
+  g_object_unref (file);
+  if (bytes == NULL)
+    return NULL;
+
+  texture = gdk_texture_new_from_bytes_at_size (bytes, width, height, error);
+
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
 /**
  * gdk_texture_get_width: (attributes org.gtk.Method.get_property=width)
  * @texture: a `GdkTexture`
@@ -677,6 +1013,34 @@ gdk_texture_do_download (GdkTexture      *texture,
   GDK_TEXTURE_GET_CLASS (texture)->download (texture, format, data, stride);
 }
 
+void
+gdk_texture_do_download_async (GdkTexture          *texture,
+                               GdkMemoryFormat      format,
+                               GCancellable        *cancellable,
+                               GAsyncReadyCallback  callback,
+                               gpointer             user_data)
+{
+  GTask *task;
+
+  task = g_task_new (texture, cancellable, callback, user_data);
+  g_task_set_source_tag (task, gdk_texture_do_download_async);
+
+  GDK_TEXTURE_GET_CLASS (texture)->download_async (texture, format, task);
+
+  g_object_unref (task);
+}
+
+GBytes *
+gdk_texture_do_download_finish (GdkTexture    *texture,
+                                GAsyncResult  *result,
+                                GError       **error)
+{
+  g_return_val_if_fail (g_task_is_valid (result, texture), NULL);
+  g_return_val_if_fail (g_task_get_source_tag (G_TASK (result)) == gdk_texture_do_download_async, NULL);
+
+  return g_task_propagate_pointer (G_TASK (result), error);
+}
+
 void
 gdk_texture_diff (GdkTexture     *self,
                   GdkTexture     *other,
@@ -876,7 +1240,7 @@ gdk_texture_save_to_png (GdkTexture *texture,
   g_return_val_if_fail (GDK_IS_TEXTURE (texture), FALSE);
   g_return_val_if_fail (filename != NULL, FALSE);
 
-  bytes = gdk_save_png (texture);
+  bytes = gdk_save_png (texture, GDK_PNG_COMPRESSION_DEFAULT);
   result = g_file_set_contents (filename,
                                 g_bytes_get_data (bytes, NULL),
                                 g_bytes_get_size (bytes),
@@ -914,7 +1278,7 @@ gdk_texture_save_to_png_bytes (GdkTexture *texture)
 {
   g_return_val_if_fail (GDK_IS_TEXTURE (texture), NULL);
 
-  return gdk_save_png (texture);
+  return gdk_save_png (texture, GDK_PNG_COMPRESSION_DEFAULT);
 }
 
 /**
@@ -59,6 +59,19 @@ typedef enum
   GDK_TEXTURE_ERROR_UNSUPPORTED_FORMAT,
 } GdkTextureError;
 
+/**
+ * GdkTextureProgressFunc:
+ * @texture: a partially loaded texture
+ * @user_data: (closure): user data
+ *
+ * The type of the function that is called with partially loaded
+ * textures by [func@Gdk.Texture.new_from_stream_async].
+ *
+ * Since: 4.14
+ */
+typedef void (* GdkTextureProgressFunc) (GdkTexture *texture,
+                                         gpointer    user_data);
+
 GDK_AVAILABLE_IN_ALL
 GType                   gdk_texture_get_type                   (void) G_GNUC_CONST;
 
@@ -75,6 +88,17 @@ GdkTexture *            gdk_texture_new_from_filename          (const char
 GDK_AVAILABLE_IN_4_6
 GdkTexture *            gdk_texture_new_from_bytes             (GBytes          *bytes,
                                                                 GError         **error);
+GDK_AVAILABLE_IN_4_14
+void                    gdk_texture_new_from_stream_async      (GInputStream           *stream,
+                                                                GCancellable           *cancellable,
+                                                                GdkTextureProgressFunc  progress,
+                                                                gpointer                progress_data,
+                                                                GDestroyNotify          progress_destroy,
+                                                                GAsyncReadyCallback     callback,
+                                                                gpointer                user_data);
+GDK_AVAILABLE_IN_4_14
+GdkTexture *            gdk_texture_new_from_stream_finish     (GAsyncResult           *result,
+                                                                GError                **error);
 
 GDK_AVAILABLE_IN_ALL
 int                     gdk_texture_get_width                  (GdkTexture      *texture) G_GNUC_PURE;
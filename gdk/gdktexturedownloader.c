@@ -266,3 +266,78 @@ gdk_texture_downloader_download_bytes (const GdkTextureDownloader *self,
   return g_bytes_new_take (data, stride * self->texture->height);
 }
 
+/**
+ * gdk_texture_downloader_download_bytes_async:
+ * @self: the downloader
+ * @cancellable: (nullable): a `GCancellable`
+ * @callback: (scope async): callback to call when the download is done
+ * @user_data: (closure): data to pass to @callback
+ *
+ * Asynchronously downloads the given texture pixels into a `GBytes`.
+ *
+ * Unlike [method@Gdk.TextureDownloader.download_bytes], this function
+ * does not block while the GPU finishes rendering and copying the
+ * texture, so it can be used to read back the result of one render
+ * while the next one is being prepared.
+ *
+ * When the download is done, @callback will be called and you can use
+ * [method@Gdk.TextureDownloader.download_bytes_finish] to get the result.
+ *
+ * The texture and format are captured when this function is called,
+ * changing them afterwards does not affect the download.
+ *
+ * Since: 4.14
+ **/
+void
+gdk_texture_downloader_download_bytes_async (const GdkTextureDownloader *self,
+                                             GCancellable               *cancellable,
+                                             GAsyncReadyCallback         callback,
+                                             gpointer                    user_data)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (cancellable == NULL || G_IS_CANCELLABLE (cancellable));
+
+  gdk_texture_do_download_async (self->texture,
+                                 self->format,
+                                 cancellable,
+                                 callback,
+                                 user_data);
+}
+
+/**
+ * gdk_texture_downloader_download_bytes_finish:
+ * @self: the downloader
+ * @result: a `GAsyncResult`
+ * @out_stride: (out): The stride of the resulting data in bytes
+ * @error: return location for an error
+ *
+ * Finishes a download started with
+ * [method@Gdk.TextureDownloader.download_bytes_async].
+ *
+ * Returns: (nullable) (transfer full): The downloaded pixels
+ *
+ * Since: 4.14
+ **/
+GBytes *
+gdk_texture_downloader_download_bytes_finish (const GdkTextureDownloader  *self,
+                                              GAsyncResult                *result,
+                                              gsize                       *out_stride,
+                                              GError                     **error)
+{
+  GdkTexture *texture;
+  GBytes *bytes;
+
+  g_return_val_if_fail (self != NULL, NULL);
+  g_return_val_if_fail (G_IS_TASK (result), NULL);
+  g_return_val_if_fail (out_stride != NULL, NULL);
+
+  texture = g_task_get_source_object (G_TASK (result));
+  bytes = gdk_texture_do_download_finish (texture, result, error);
+  if (bytes == NULL)
+    return NULL;
+
+  /* Downloads always use the tightest stride */
+  *out_stride = g_bytes_get_size (bytes) / texture->height;
+
+  return bytes;
+}
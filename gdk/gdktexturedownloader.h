@@ -57,6 +57,18 @@ void                    gdk_texture_downloader_download_into    (const GdkTextur
 GDK_AVAILABLE_IN_4_10
 GBytes *                gdk_texture_downloader_download_bytes   (const GdkTextureDownloader     *self,
                                                                  gsize                          *out_stride);
+GDK_AVAILABLE_IN_4_14
+void                    gdk_texture_downloader_download_bytes_async
+                                                                (const GdkTextureDownloader     *self,
+                                                                 GCancellable                   *cancellable,
+                                                                 GAsyncReadyCallback             callback,
+                                                                 gpointer                        user_data);
+GDK_AVAILABLE_IN_4_14
+GBytes *                gdk_texture_downloader_download_bytes_finish
+                                                                (const GdkTextureDownloader     *self,
+                                                                 GAsyncResult                   *result,
+                                                                 gsize                          *out_stride,
+                                                                 GError                        **error);
 
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GdkTextureDownloader, gdk_texture_downloader_free)
 
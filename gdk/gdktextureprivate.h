@@ -37,9 +37,24 @@ struct _GdkTextureClass {
                                                          GdkMemoryFormat         format,
                                                          guchar                 *data,
                                                          gsize                   stride);
+  /* optional: Download in the given format without blocking, the task
+   * returns a GBytes with the minimal stride for the format */
+  void                  (* download_async)              (GdkTexture             *texture,
+                                                         GdkMemoryFormat         format,
+                                                         GTask                  *task);
 };
 
 gboolean                gdk_texture_can_load            (GBytes                 *bytes);
+GdkTexture *            gdk_texture_new_from_bytes_at_size
+                                                        (GBytes                 *bytes,
+                                                         int                     width,
+                                                         int                     height,
+                                                         GError                **error);
+GdkTexture *            gdk_texture_new_from_filename_at_size
+                                                        (const char             *path,
+                                                         int                     width,
+                                                         int                     height,
+                                                         GError                **error);
 
 GdkTexture *            gdk_texture_new_for_surface     (cairo_surface_t        *surface);
 cairo_surface_t *       gdk_texture_download_surface    (GdkTexture             *texture);
@@ -48,6 +63,14 @@ void                    gdk_texture_do_download         (GdkTexture
                                                          GdkMemoryFormat         format,
                                                          guchar                 *data,
                                                          gsize                   stride);
+void                    gdk_texture_do_download_async   (GdkTexture             *texture,
+                                                         GdkMemoryFormat         format,
+                                                         GCancellable           *cancellable,
+                                                         GAsyncReadyCallback     callback,
+                                                         gpointer                user_data);
+GBytes *                gdk_texture_do_download_finish  (GdkTexture             *texture,
+                                                         GAsyncResult           *result,
+                                                         GError                **error);
 void                    gdk_texture_diff                (GdkTexture             *self,
                                                          GdkTexture             *other,
                                                          cairo_region_t         *region);
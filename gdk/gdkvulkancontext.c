@@ -959,7 +959,7 @@ gdk_vulkan_get_pipeline_cache_file (GdkDisplay *display)
 
   dirname = gdk_vulkan_get_pipeline_cache_dirname ();
   basename = g_strdup_printf ("%02x%02x%02x%02x-%02x%02x-%02x%02x-%02x%02x"
-                              "-%02x%02x%02x%02x%02x%02x.%u",
+                              "-%02x%02x%02x%02x%02x%02x.%u.%u.%u.%u",
                               props.pipelineCacheUUID[0], props.pipelineCacheUUID[1],
                               props.pipelineCacheUUID[2], props.pipelineCacheUUID[3],
                               props.pipelineCacheUUID[4], props.pipelineCacheUUID[5],
@@ -968,7 +968,8 @@ gdk_vulkan_get_pipeline_cache_file (GdkDisplay *display)
                               props.pipelineCacheUUID[10], props.pipelineCacheUUID[11],
                               props.pipelineCacheUUID[12], props.pipelineCacheUUID[13],
                               props.pipelineCacheUUID[14], props.pipelineCacheUUID[15],
-                              props.driverVersion);
+                              props.driverVersion,
+                              GDK_MAJOR_VERSION, GDK_MINOR_VERSION, GDK_MICRO_VERSION);
 
   path = g_build_filename (dirname, basename, NULL);
   result = g_file_new_for_path (path);
@@ -131,21 +131,212 @@ convert_cmyk_to_rgba (guchar *data,
     }
 }
 
- /* }}} */
-/* {{{ Public API */
+/* }}} */
+/* {{{ Stream source */
 
-GdkTexture *
-gdk_load_jpeg (GBytes  *input_bytes,
-               GError **error)
+typedef struct {
+  struct jpeg_source_mgr pub;
+  GInputStream *stream;
+  GCancellable *cancellable;
+  JOCTET buffer[4096];
+} stream_source_mgr;
+
+static void
+stream_init_source (j_decompress_ptr cinfo)
+{
+}
+
+static boolean
+stream_fill_input_buffer (j_decompress_ptr cinfo)
+{
+  stream_source_mgr *src = (stream_source_mgr *) cinfo->src;
+  struct error_handler_data *errmgr = (struct error_handler_data *) cinfo->err;
+  gssize n_read;
+
+  n_read = g_input_stream_read (src->stream,
+                                src->buffer, sizeof (src->buffer),
+                                src->cancellable,
+                                errmgr->error);
+  if (n_read < 0)
+    ERREXIT (cinfo, JERR_FILE_READ);
+
+  if (n_read == 0)
+    {
+      /* Insert a fake EOI marker, like jpeg_mem_src() does */
+      WARNMS (cinfo, JWRN_JPEG_EOF);
+      src->buffer[0] = (JOCTET) 0xFF;
+      src->buffer[1] = (JOCTET) JPEG_EOI;
+      n_read = 2;
+    }
+
+  src->pub.next_input_byte = src->buffer;
+  src->pub.bytes_in_buffer = n_read;
+
+  return TRUE;
+}
+
+static void
+stream_skip_input_data (j_decompress_ptr cinfo,
+                        long             num_bytes)
+{
+  stream_source_mgr *src = (stream_source_mgr *) cinfo->src;
+
+  if (num_bytes <= 0)
+    return;
+
+  while (num_bytes > (long) src->pub.bytes_in_buffer)
+    {
+      num_bytes -= (long) src->pub.bytes_in_buffer;
+      stream_fill_input_buffer (cinfo);
+    }
+
+  src->pub.next_input_byte += num_bytes;
+  src->pub.bytes_in_buffer -= num_bytes;
+}
+
+static void
+stream_term_source (j_decompress_ptr cinfo)
+{
+}
+
+static void
+jpeg_stream_src (j_decompress_ptr  cinfo,
+                 stream_source_mgr *src,
+                 GInputStream      *stream,
+                 GCancellable      *cancellable)
+{
+  src->pub.init_source = stream_init_source;
+  src->pub.fill_input_buffer = stream_fill_input_buffer;
+  src->pub.skip_input_data = stream_skip_input_data;
+  src->pub.resync_to_restart = jpeg_resync_to_restart;
+  src->pub.term_source = stream_term_source;
+  src->pub.bytes_in_buffer = 0;
+  src->pub.next_input_byte = NULL;
+  src->stream = stream;
+  src->cancellable = cancellable;
+
+  cinfo->src = &src->pub;
+}
+
+/* }}} */
+/* {{{ Loading */
+
+static void
+read_scanlines (j_decompress_ptr cinfo,
+                guchar          *data,
+                gsize            stride)
+{
+  unsigned char *row[1];
+
+  while (cinfo->output_scanline < cinfo->output_height)
+    {
+       row[0] = (unsigned char *)(&data[stride * cinfo->output_scanline]);
+       jpeg_read_scanlines (cinfo, row, 1);
+    }
+}
+
+/* Takes ownership of data */
+static GdkTexture *
+texture_from_scanlines (guchar       *data,
+                        guint         width,
+                        guint         height,
+                        gsize         stride,
+                        J_COLOR_SPACE color_space)
+{
+  GdkMemoryFormat format;
+  GBytes *bytes;
+  GdkTexture *texture;
+
+  switch ((int)color_space)
+    {
+    case JCS_GRAYSCALE:
+      convert_grayscale_to_rgb (data, width, height, stride);
+      format = GDK_MEMORY_R8G8B8;
+      break;
+    case JCS_RGB:
+      format = GDK_MEMORY_R8G8B8;
+      break;
+    case JCS_CMYK:
+      convert_cmyk_to_rgba (data, width, height, stride);
+      format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
+      break;
+    default:
+      g_assert_not_reached ();
+    }
+
+  bytes = g_bytes_new_take (data, stride * height);
+
+  texture = gdk_memory_texture_new (width, height,
+                                    format,
+                                    bytes, stride);
+
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static void
+emit_partial_texture (j_decompress_ptr        cinfo,
+                      const guchar           *data,
+                      gsize                   stride,
+                      GdkTextureProgressFunc  progress,
+                      gpointer                progress_data)
+{
+  GdkTexture *texture;
+
+  texture = texture_from_scanlines (g_memdup2 (data, stride * cinfo->output_height),
+                                    cinfo->output_width,
+                                    cinfo->output_height,
+                                    stride,
+                                    cinfo->out_color_space);
+
+  progress (texture, progress_data);
+
+  g_object_unref (texture);
+}
+
+/* Returns the largest DCT scale that keeps the image at
+ * least as large as the requested size. Only power-of-two
+ * scales are used, as those are supported by all libjpeg
+ * versions.
+ */
+static guint
+get_scale_denom (guint image_width,
+                 guint image_height,
+                 int   width,
+                 int   height)
+{
+  guint denom;
+
+  if (width <= 0 || height <= 0)
+    return 1;
+
+  for (denom = 8; denom > 1; denom /= 2)
+    {
+      if ((image_width + denom - 1) / denom >= width &&
+          (image_height + denom - 1) / denom >= height)
+        break;
+    }
+
+  return denom;
+}
+
+static GdkTexture *
+gdk_load_jpeg_internal (GBytes                  *input_bytes,
+                        GInputStream            *stream,
+                        GCancellable            *cancellable,
+                        int                      target_width,
+                        int                      target_height,
+                        GdkTextureProgressFunc   progress,
+                        gpointer                 progress_data,
+                        GError                 **error)
 {
   struct jpeg_decompress_struct info;
   struct error_handler_data jerr;
+  stream_source_mgr src;
   guint width, height, stride;
   unsigned char *data = NULL;
-  unsigned char *row[1];
-  GBytes *bytes;
   GdkTexture *texture;
-  GdkMemoryFormat format;
   G_GNUC_UNUSED guint64 before = GDK_PROFILER_CURRENT_TIME;
 
   info.err = jpeg_std_error (&jerr.pub);
@@ -165,11 +356,25 @@ gdk_load_jpeg (GBytes  *input_bytes,
   /* Limit to 1GB to avoid OOM with large images */
   info.mem->max_memory_to_use = 1024 * 1024 * 1024;
 
-  jpeg_mem_src (&info,
-                g_bytes_get_data (input_bytes, NULL),
-                g_bytes_get_size (input_bytes));
+  if (stream)
+    jpeg_stream_src (&info, &src, stream, cancellable);
+  else
+    jpeg_mem_src (&info,
+                  g_bytes_get_data (input_bytes, NULL),
+                  g_bytes_get_size (input_bytes));
 
   jpeg_read_header (&info, TRUE);
+
+  info.scale_num = 1;
+  info.scale_denom = get_scale_denom (info.image_width, info.image_height,
+                                      target_width, target_height);
+
+  /* Progressive images are decoded scan by scan, so each
+   * scan can be shown while the next one is being read.
+   */
+  if (progress && jpeg_has_multiple_scans (&info))
+    info.buffered_image = TRUE;
+
   jpeg_start_decompress (&info);
 
   width = info.output_width;
@@ -180,13 +385,9 @@ gdk_load_jpeg (GBytes  *input_bytes,
     case JCS_GRAYSCALE:
     case JCS_RGB:
       stride = 3 * width;
-      data = g_try_malloc_n (stride, height);
-      format = GDK_MEMORY_R8G8B8;
       break;
     case JCS_CMYK:
       stride = 4 * width;
-      data = g_try_malloc_n (stride, height);
-      format = GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
       break;
     default:
       g_set_error (error,
@@ -196,6 +397,12 @@ gdk_load_jpeg (GBytes  *input_bytes,
       return NULL;
     }
 
+  /* Partial textures show the rows that have not arrived yet */
+  if (progress)
+    data = g_try_malloc0_n (stride, height);
+  else
+    data = g_try_malloc_n (stride, height);
+
   if (!data)
     {
       g_set_error (error,
@@ -205,43 +412,113 @@ gdk_load_jpeg (GBytes  *input_bytes,
       return NULL;
     }
 
-  while (info.output_scanline < info.output_height)
+  if (info.buffered_image)
     {
-       row[0] = (unsigned char *)(&data[stride * info.output_scanline]);
-       jpeg_read_scanlines (&info, row, 1);
+      while (TRUE)
+        {
+          jpeg_start_output (&info, info.input_scan_number);
+          read_scanlines (&info, data, stride);
+          jpeg_finish_output (&info);
+
+          if (jpeg_input_complete (&info) &&
+              info.output_scan_number == info.input_scan_number)
+            break;
+
+          emit_partial_texture (&info, data, stride, progress, progress_data);
+        }
     }
+  else if (progress)
+    {
+      guint step = MAX (height / 8, 1);
 
-  switch ((int)info.out_color_space)
+      while (info.output_scanline < info.output_height)
+        {
+          unsigned char *row[1];
+
+          row[0] = (unsigned char *)(&data[stride * info.output_scanline]);
+          jpeg_read_scanlines (&info, row, 1);
+
+          if (info.output_scanline % step == 0 &&
+              info.output_scanline < info.output_height)
+            emit_partial_texture (&info, data, stride, progress, progress_data);
+        }
+    }
+  else
     {
-    case JCS_GRAYSCALE:
-      convert_grayscale_to_rgb (data, width, height, stride);
-      format = GDK_MEMORY_R8G8B8;
-      break;
-    case JCS_RGB:
-      break;
-    case JCS_CMYK:
-      convert_cmyk_to_rgba (data, width, height, stride);
-      break;
-    default:
-      g_assert_not_reached ();
+      read_scanlines (&info, data, stride);
     }
 
   jpeg_finish_decompress (&info);
-  jpeg_destroy_decompress (&info);
 
-  bytes = g_bytes_new_take (data, stride * height);
-
-  texture = gdk_memory_texture_new (width, height,
-                                    format,
-                                    bytes, stride);
+  texture = texture_from_scanlines (data, width, height, stride, info.out_color_space);
 
-  g_bytes_unref (bytes);
+  jpeg_destroy_decompress (&info);
 
   gdk_profiler_end_mark (before, "jpeg load", NULL);
  
   return texture;
 }
 
+/* }}} */
+/* {{{ Public API */
+
+GdkTexture *
+gdk_load_jpeg (GBytes  *input_bytes,
+               GError **error)
+{
+  return gdk_load_jpeg_internal (input_bytes, NULL, NULL, 0, 0, NULL, NULL, error);
+}
+
+/*<private>
+ * gdk_load_jpeg_at_size:
+ * @bytes: the data to load
+ * @width: the width the image will be displayed at
+ * @height: the height the image will be displayed at
+ * @error: return location for an error
+ *
+ * Loads a jpeg image, using DCT scaling to decode it at a
+ * reduced size that is still at least @width x @height.
+ *
+ * This is considerably faster and uses less memory than
+ * decoding at full size and downscaling.
+ *
+ * Returns: (nullable): the loaded texture
+ */
+GdkTexture *
+gdk_load_jpeg_at_size (GBytes  *input_bytes,
+                       int      width,
+                       int      height,
+                       GError **error)
+{
+  return gdk_load_jpeg_internal (input_bytes, NULL, NULL, width, height, NULL, NULL, error);
+}
+
+/*<private>
+ * gdk_load_jpeg_from_stream:
+ * @stream: the stream to read from
+ * @cancellable: (nullable): a `GCancellable`
+ * @progress: (nullable): function to call with partially loaded textures
+ * @progress_data: data for @progress
+ * @error: return location for an error
+ *
+ * Loads a jpeg image by reading @stream with blocking reads.
+ *
+ * If @progress is not %NULL, it is called from the calling
+ * thread after every scan of a progressive jpeg, and after
+ * every eighth of the rows of a baseline jpeg.
+ *
+ * Returns: (nullable): the loaded texture
+ */
+GdkTexture *
+gdk_load_jpeg_from_stream (GInputStream            *stream,
+                           GCancellable            *cancellable,
+                           GdkTextureProgressFunc   progress,
+                           gpointer                 progress_data,
+                           GError                 **error)
+{
+  return gdk_load_jpeg_internal (NULL, stream, cancellable, 0, 0, progress, progress_data, error);
+}
+
 GBytes *
 gdk_save_jpeg (GdkTexture *texture)
 {
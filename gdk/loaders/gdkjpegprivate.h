@@ -24,6 +24,16 @@
 
 GdkTexture *gdk_load_jpeg         (GBytes           *bytes,
                                    GError          **error);
+GdkTexture *gdk_load_jpeg_at_size (GBytes           *bytes,
+                                   int               width,
+                                   int               height,
+                                   GError          **error);
+GdkTexture *gdk_load_jpeg_from_stream
+                                  (GInputStream     *stream,
+                                   GCancellable     *cancellable,
+                                   GdkTextureProgressFunc progress,
+                                   gpointer          progress_data,
+                                   GError          **error);
 
 GBytes     *gdk_save_jpeg         (GdkTexture     *texture);
 
@@ -48,6 +48,9 @@ typedef struct
   guchar *data;
   gsize size;
   gsize position;
+  GInputStream *stream;
+  GOutputStream *output;
+  GCancellable *cancellable;
 } png_io;
 
 
@@ -60,6 +63,20 @@ png_read_func (png_structp png,
 
   io = png_get_io_ptr (png);
 
+  if (io->stream)
+    {
+      GError **error = png_get_error_ptr (png);
+      gsize n_read;
+
+      if (!g_input_stream_read_all (io->stream, data, size, &n_read, io->cancellable, error))
+        png_error (png, "Read error");
+
+      if (n_read < size)
+        png_error (png, "Read past EOF");
+
+      return;
+    }
+
   if (io->position + size > io->size)
     png_error (png, "Read past EOF");
 
@@ -76,6 +93,19 @@ png_write_func (png_structp png,
 
   io = png_get_io_ptr (png);
 
+  if (io->output)
+    {
+      GError **error = png_get_error_ptr (png);
+
+      /* This blocks when the reader is slower than the encoder,
+       * so the encoded image never piles up in memory
+       */
+      if (!g_output_stream_write_all (io->output, data, size, NULL, io->cancellable, error))
+        png_error (png, "Write error");
+
+      return;
+    }
+
   if (io->position > io->size ||
       io->size - io->position  < size)
     {
@@ -126,19 +156,42 @@ png_simple_warning_callback (png_structp     png,
 {
 }
 
+static void
+emit_partial_texture (int                     width,
+                      int                     height,
+                      GdkMemoryFormat         format,
+                      const guchar           *buffer,
+                      gsize                   stride,
+                      GdkTextureProgressFunc  progress,
+                      gpointer                progress_data)
+{
+  GBytes *bytes;
+  GdkTexture *texture;
+
+  bytes = g_bytes_new (buffer, height * stride);
+  texture = gdk_memory_texture_new (width, height, format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  progress (texture, progress_data);
+
+  g_object_unref (texture);
+}
+
 /* }}} */
-/* {{{ Public API */ 
+/* {{{ Loading */
 
-GdkTexture *
-gdk_load_png (GBytes  *bytes,
-              GError **error)
+static GdkTexture *
+gdk_load_png_from_io (png_io                  *io,
+                      GdkTextureProgressFunc   progress,
+                      gpointer                 progress_data,
+                      GError                 **error)
 {
-  png_io io;
   png_struct *png = NULL;
   png_info *info;
   guint width, height;
   int depth, color_type;
   int interlace, stride;
+  int n_passes;
   GdkMemoryFormat format;
   guchar *buffer = NULL;
   guchar **row_pointers = NULL;
@@ -147,9 +200,6 @@ gdk_load_png (GBytes  *bytes,
   int bpp;
   G_GNUC_UNUSED gint64 before = GDK_PROFILER_CURRENT_TIME;
 
-  io.data = (guchar *)g_bytes_get_data (bytes, &io.size);
-  io.position = 0;
-
   png = png_create_read_struct_2 (PNG_LIBPNG_VER_STRING,
                                   error,
                                   png_simple_error_callback,
@@ -164,7 +214,7 @@ gdk_load_png (GBytes  *bytes,
   if (info == NULL)
     g_error ("Out of memory");
 
-  png_set_read_fn (png, &io, png_read_func);
+  png_set_read_fn (png, io, png_read_func);
 
   if (sigsetjmp (png_jmpbuf (png), 1))
     {
@@ -193,7 +243,9 @@ gdk_load_png (GBytes  *bytes,
     png_set_packing (png);
 
   if (interlace != PNG_INTERLACE_NONE)
-    png_set_interlace_handling (png);
+    n_passes = png_set_interlace_handling (png);
+  else
+    n_passes = 1;
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
   png_set_swap (png);
@@ -267,7 +319,11 @@ gdk_load_png (GBytes  *bytes,
   if (stride % 8)
     stride += 8 - stride % 8;
 
-  buffer = g_try_malloc_n (height, stride);
+  /* Partial textures show the rows that have not arrived yet */
+  if (progress)
+    buffer = g_try_malloc0_n (height, stride);
+  else
+    buffer = g_try_malloc_n (height, stride);
   row_pointers = g_try_malloc_n (height, sizeof (char *));
 
   if (!buffer || !row_pointers)
@@ -284,7 +340,30 @@ gdk_load_png (GBytes  *bytes,
   for (int i = 0; i < height; i++)
     row_pointers[i] = &buffer[i * stride];
 
-  png_read_image (png, row_pointers);
+  if (progress == NULL)
+    {
+      png_read_image (png, row_pointers);
+    }
+  else
+    {
+      /* Emit a partial texture after every pass for interlaced
+       * images, and after every eighth of the rows otherwise.
+       */
+      int step = MAX (height / 8, 1);
+
+      for (int pass = 0; pass < n_passes; pass++)
+        {
+          for (int y = 0; y < height; y++)
+            {
+              png_read_row (png, row_pointers[y], NULL);
+
+              if (n_passes > 1 ? (y + 1 == height && pass + 1 < n_passes)
+                               : ((y + 1) % step == 0 && y + 1 < height))
+                emit_partial_texture (width, height, format, buffer, stride, progress, progress_data);
+            }
+        }
+    }
+
   png_read_end (png, info);
 
   out_bytes = g_bytes_new_take (buffer, height * stride);
@@ -304,12 +383,59 @@ gdk_load_png (GBytes  *bytes,
   return texture;
 }
 
-GBytes *
-gdk_save_png (GdkTexture *texture)
+/* }}} */
+/* {{{ Public API */
+
+GdkTexture *
+gdk_load_png (GBytes  *bytes,
+              GError **error)
+{
+  png_io io = { NULL, };
+
+  io.data = (guchar *)g_bytes_get_data (bytes, &io.size);
+
+  return gdk_load_png_from_io (&io, NULL, NULL, error);
+}
+
+/*<private>
+ * gdk_load_png_from_stream:
+ * @stream: the stream to read from
+ * @cancellable: (nullable): a `GCancellable`
+ * @progress: (nullable): function to call with partially loaded textures
+ * @progress_data: data for @progress
+ * @error: return location for an error
+ *
+ * Loads a png image by reading @stream with blocking reads.
+ *
+ * If @progress is not %NULL, it is called from the calling
+ * thread whenever a significant part of the image has been
+ * decoded.
+ *
+ * Returns: (nullable): the loaded texture
+ */
+GdkTexture *
+gdk_load_png_from_stream (GInputStream            *stream,
+                          GCancellable            *cancellable,
+                          GdkTextureProgressFunc   progress,
+                          gpointer                 progress_data,
+                          GError                 **error)
+{
+  png_io io = { NULL, };
+
+  io.stream = stream;
+  io.cancellable = cancellable;
+
+  return gdk_load_png_from_io (&io, progress, progress_data, error);
+}
+
+static gboolean
+save_png (GdkTexture         *texture,
+          GdkPngCompression   compression,
+          png_io             *io,
+          GError            **error)
 {
   png_struct *png = NULL;
   png_info *info;
-  png_io io = { NULL, 0, 0 };
   int width, height;
   int y;
   GdkMemoryFormat format;
@@ -399,20 +525,24 @@ gdk_save_png (GdkTexture *texture)
       g_assert_not_reached ();
     }
 
-  png = png_create_write_struct_2 (PNG_LIBPNG_VER_STRING, NULL,
+  png = png_create_write_struct_2 (PNG_LIBPNG_VER_STRING, error,
                                    png_simple_error_callback,
                                    png_simple_warning_callback,
                                    NULL,
                                    png_malloc_callback,
                                    png_free_callback);
   if (!png)
-    return NULL;
+    {
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to create png writer");
+      return FALSE;
+    }
 
   info = png_create_info_struct (png);
   if (!info)
     {
-      png_destroy_read_struct (&png, NULL, NULL);
-      return NULL;
+      png_destroy_write_struct (&png, NULL);
+      g_set_error_literal (error, G_IO_ERROR, G_IO_ERROR_FAILED, "Failed to create png writer");
+      return FALSE;
     }
 
   gdk_texture_downloader_init (&downloader, texture);
@@ -424,12 +554,11 @@ gdk_save_png (GdkTexture *texture)
   if (sigsetjmp (png_jmpbuf (png), 1))
     {
       g_bytes_unref (bytes);
-      g_free (io.data);
-      png_destroy_read_struct (&png, &info, NULL);
-      return NULL;
+      png_destroy_write_struct (&png, &info);
+      return FALSE;
     }
 
-  png_set_write_fn (png, &io, png_write_func, png_flush_func);
+  png_set_write_fn (png, io, png_write_func, png_flush_func);
 
   png_set_IHDR (png, info, width, height, depth,
                 png_format,
@@ -437,6 +566,16 @@ gdk_save_png (GdkTexture *texture)
                 PNG_COMPRESSION_TYPE_DEFAULT,
                 PNG_FILTER_TYPE_DEFAULT);
 
+  if (compression == GDK_PNG_COMPRESSION_FAST)
+    {
+      /* Trying all filters per row and the default zlib level
+       * take most of the time, and the result is only going to
+       * be decoded again soon, so skip that
+       */
+      png_set_filter (png, PNG_FILTER_TYPE_BASE, PNG_FILTER_NONE);
+      png_set_compression_level (png, 1);
+    }
+
   png_write_info (png, info);
 
 #if G_BYTE_ORDER == G_LITTLE_ENDIAN
@@ -452,9 +591,43 @@ gdk_save_png (GdkTexture *texture)
 
   g_bytes_unref (bytes);
 
+  return TRUE;
+}
+
+GBytes *
+gdk_save_png (GdkTexture        *texture,
+              GdkPngCompression  compression)
+{
+  png_io io = { NULL, };
+
+  if (!save_png (texture, compression, &io, NULL))
+    {
+      g_free (io.data);
+      return NULL;
+    }
+
   return g_bytes_new_take (io.data, io.size);
 }
 
+/* Encodes @texture directly into @stream, without keeping the
+ * encoded image in memory. The writes are blocking, so this
+ * should be called from a thread.
+ */
+gboolean
+gdk_save_png_to_stream (GdkTexture         *texture,
+                        GdkPngCompression   compression,
+                        GOutputStream      *stream,
+                        GCancellable       *cancellable,
+                        GError            **error)
+{
+  png_io io = { NULL, };
+
+  io.output = stream;
+  io.cancellable = cancellable;
+
+  return save_png (texture, compression, &io, error);
+}
+
 /* }}} */
 
 /* vim:set foldmethod=marker expandtab: */
@@ -24,8 +24,27 @@
 
 GdkTexture *gdk_load_png        (GBytes         *bytes,
                                  GError        **error);
+GdkTexture *gdk_load_png_from_stream
+                                (GInputStream   *stream,
+                                 GCancellable   *cancellable,
+                                 GdkTextureProgressFunc progress,
+                                 gpointer        progress_data,
+                                 GError        **error);
 
-GBytes     *gdk_save_png        (GdkTexture     *texture);
+/* How much effort to spend on making the file small */
+typedef enum {
+  GDK_PNG_COMPRESSION_DEFAULT,
+  GDK_PNG_COMPRESSION_FAST
+} GdkPngCompression;
+
+GBytes     *gdk_save_png        (GdkTexture     *texture,
+                                 GdkPngCompression compression);
+gboolean    gdk_save_png_to_stream
+                                (GdkTexture     *texture,
+                                 GdkPngCompression compression,
+                                 GOutputStream  *stream,
+                                 GCancellable   *cancellable,
+                                 GError        **error);
 
 static inline gboolean
 gdk_is_png (GBytes *bytes)
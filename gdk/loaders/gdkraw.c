@@ -0,0 +1,197 @@
+/* GDK - The GIMP Drawing Kit
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkrawprivate.h"
+
+#include <glib/gi18n-lib.h>
+#include "gdkmemoryformatprivate.h"
+#include "gdkmemorytexture.h"
+#include "gdktexturedownloaderprivate.h"
+
+/* Copying images between GTK applications does not need a compressed
+ * format: both sides understand our memory formats, and encoding and
+ * decoding a large PNG takes a lot longer than moving the pixels.
+ *
+ * The data is a header followed by the rows of the image, without
+ * padding after the last row. All header fields are little-endian
+ * 32-bit integers. As 16-bit and float formats are stored in native
+ * byte order, the byte order of the sender is part of the header,
+ * and the receiver refuses data it can't use.
+ */
+
+#define RAW_MAGIC 0x544B5447 /* "GTKT" */
+#define RAW_VERSION 1
+
+/* {{{ Header */
+
+enum {
+  RAW_MAGIC_FIELD,
+  RAW_VERSION_FIELD,
+  RAW_BYTE_ORDER_FIELD,
+  RAW_FORMAT_FIELD,
+  RAW_WIDTH_FIELD,
+  RAW_HEIGHT_FIELD,
+  RAW_STRIDE_FIELD,
+  RAW_N_FIELDS
+};
+
+/* }}} */
+/* {{{ Public API */
+
+GdkTexture *
+gdk_load_raw_from_stream (GInputStream  *stream,
+                          GCancellable  *cancellable,
+                          GError       **error)
+{
+  guint32 header[RAW_N_FIELDS];
+  GdkMemoryFormat format;
+  gsize width, height, stride, size, n_read;
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar *data;
+  int i;
+
+  if (!g_input_stream_read_all (stream, header, sizeof (header), &n_read, cancellable, error))
+    return NULL;
+
+  for (i = 0; i < RAW_N_FIELDS; i++)
+    header[i] = GUINT32_FROM_LE (header[i]);
+
+  if (n_read < sizeof (header) ||
+      header[RAW_MAGIC_FIELD] != RAW_MAGIC ||
+      header[RAW_VERSION_FIELD] != RAW_VERSION)
+    {
+      g_set_error_literal (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_UNSUPPORTED_FORMAT,
+                           _("Not a raw texture"));
+      return NULL;
+    }
+
+  if (header[RAW_BYTE_ORDER_FIELD] != G_BYTE_ORDER ||
+      header[RAW_FORMAT_FIELD] >= GDK_MEMORY_N_FORMATS)
+    {
+      g_set_error_literal (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_UNSUPPORTED_CONTENT,
+                           _("Unsupported raw texture format"));
+      return NULL;
+    }
+
+  format = header[RAW_FORMAT_FIELD];
+  width = header[RAW_WIDTH_FIELD];
+  height = header[RAW_HEIGHT_FIELD];
+  stride = header[RAW_STRIDE_FIELD];
+
+  if (width == 0 || height == 0 ||
+      width > G_MAXINT || height > G_MAXINT ||
+      stride < width * gdk_memory_format_bytes_per_pixel (format) ||
+      stride % gdk_memory_format_alignment (format) != 0 ||
+      !g_size_checked_mul (&size, stride, height - 1) ||
+      !g_size_checked_add (&size, size, width * gdk_memory_format_bytes_per_pixel (format)))
+    {
+      g_set_error_literal (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_CORRUPT_IMAGE,
+                           _("Invalid raw texture size"));
+      return NULL;
+    }
+
+  data = g_try_malloc (size);
+  if (data == NULL)
+    {
+      g_set_error (error,
+                   GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_TOO_LARGE,
+                   _("Not enough memory for image size %ux%u"), (guint) width, (guint) height);
+      return NULL;
+    }
+
+  if (!g_input_stream_read_all (stream, data, size, &n_read, cancellable, error))
+    {
+      g_free (data);
+      return NULL;
+    }
+
+  if (n_read < size)
+    {
+      g_free (data);
+      g_set_error_literal (error,
+                           GDK_TEXTURE_ERROR, GDK_TEXTURE_ERROR_CORRUPT_IMAGE,
+                           _("Raw texture data is truncated"));
+      return NULL;
+    }
+
+  bytes = g_bytes_new_take (data, size);
+  texture = gdk_memory_texture_new (width, height, format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+/* The writes are blocking, so this should be called from a thread */
+gboolean
+gdk_save_raw_to_stream (GdkTexture     *texture,
+                        GOutputStream  *stream,
+                        GCancellable   *cancellable,
+                        GError        **error)
+{
+  GdkTextureDownloader downloader;
+  guint32 header[RAW_N_FIELDS];
+  GdkMemoryFormat format;
+  GBytes *bytes;
+  gsize stride, size;
+  gboolean result;
+  int i;
+
+  format = gdk_texture_get_format (texture);
+
+  /* For memory textures in their own format, this does not copy */
+  gdk_texture_downloader_init (&downloader, texture);
+  gdk_texture_downloader_set_format (&downloader, format);
+  bytes = gdk_texture_downloader_download_bytes (&downloader, &stride);
+  gdk_texture_downloader_finish (&downloader);
+
+  header[RAW_MAGIC_FIELD] = RAW_MAGIC;
+  header[RAW_VERSION_FIELD] = RAW_VERSION;
+  header[RAW_BYTE_ORDER_FIELD] = G_BYTE_ORDER;
+  header[RAW_FORMAT_FIELD] = format;
+  header[RAW_WIDTH_FIELD] = gdk_texture_get_width (texture);
+  header[RAW_HEIGHT_FIELD] = gdk_texture_get_height (texture);
+  header[RAW_STRIDE_FIELD] = stride;
+
+  for (i = 0; i < RAW_N_FIELDS; i++)
+    header[i] = GUINT32_TO_LE (header[i]);
+
+  /* The last row has no padding */
+  size = stride * (gdk_texture_get_height (texture) - 1) +
+         gdk_texture_get_width (texture) * gdk_memory_format_bytes_per_pixel (format);
+
+  result = g_output_stream_write_all (stream, header, sizeof (header), NULL, cancellable, error) &&
+           g_output_stream_write_all (stream,
+                                      g_bytes_get_data (bytes, NULL),
+                                      size,
+                                      NULL,
+                                      cancellable,
+                                      error);
+
+  g_bytes_unref (bytes);
+
+  return result;
+}
+
+/* }}} */
+
+/* vim:set foldmethod=marker expandtab: */
@@ -0,0 +1,35 @@
+/* GDK - The GIMP Drawing Kit
+ * Copyright (C) 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdktexture.h"
+#include <gio/gio.h>
+
+/* Uncompressed texture data, for transfers between GTK applications */
+#define GDK_RAW_MIME_TYPE "application/x-gtk-memory-texture"
+
+GdkTexture *gdk_load_raw_from_stream
+                                (GInputStream   *stream,
+                                 GCancellable   *cancellable,
+                                 GError        **error);
+
+gboolean    gdk_save_raw_to_stream
+                                (GdkTexture     *texture,
+                                 GOutputStream  *stream,
+                                 GCancellable   *cancellable,
+                                 GError        **error);
@@ -125,6 +125,16 @@ gdk_display_link_source_frame_cb (CVDisplayLinkRef   display_link,
 
   presentation_time = host_to_frame_clock_time (inOutputTime->hostTime);
 
+  /* The nominal refresh rate of the mode is not necessarily what the
+   * display runs at, e.g. with ProMotion, so follow what the display
+   * link reports for the upcoming frame.
+   */
+  if ((inOutputTime->flags & kCVTimeStampVideoRefreshPeriodValid) != 0 &&
+      inOutputTime->videoTimeScale != 0 &&
+      inOutputTime->videoRefreshPeriod != 0)
+    impl->refresh_interval = (gint64) inOutputTime->videoRefreshPeriod * G_USEC_PER_SEC
+                             / inOutputTime->videoTimeScale;
+
   impl->presentation_time = presentation_time;
   impl->needs_dispatch = TRUE;
 
@@ -242,10 +252,14 @@ host_to_frame_clock_time (gint64 val)
 {
   /* NOTE: Code adapted from GLib's g_get_monotonic_time(). */
 
-  mach_timebase_info_data_t timebase_info;
+  static mach_timebase_info_data_t timebase_info;
 
-  /* we get nanoseconds from mach_absolute_time() using timebase_info */
-  mach_timebase_info (&timebase_info);
+  /* we get nanoseconds from mach_absolute_time() using timebase_info,
+   * which doesn't change, so only query it once. This is called from
+   * the display link thread for every frame.
+   */
+  if (G_UNLIKELY (timebase_info.denom == 0))
+    mach_timebase_info (&timebase_info);
 
   if (timebase_info.numer != timebase_info.denom)
     {
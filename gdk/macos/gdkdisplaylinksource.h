@@ -33,7 +33,7 @@ typedef struct
 
   CGDirectDisplayID display_id;
   CVDisplayLinkRef  display_link;
-  gint64            refresh_interval;
+  volatile gint64   refresh_interval;
   guint             refresh_rate;
   guint             paused : 1;
 
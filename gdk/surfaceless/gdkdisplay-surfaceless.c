@@ -0,0 +1,215 @@
+/* GDK - The GIMP Drawing Kit
+ *
+ * gdkdisplay-surfaceless.c: Display without any windowing system
+ *
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkprivate-surfaceless.h"
+
+#include "gdkmonitor.h"
+
+#include <glib/gi18n-lib.h>
+
+#include <epoxy/egl.h>
+
+/*< private >
+ * GdkSurfacelessDisplay:
+ *
+ * A display that is not connected to any windowing system.
+ *
+ * It has no monitors, seats or keymap and cannot create surfaces.
+ * It is meant for offscreen rendering with gsk_renderer_render_texture(),
+ * using an EGL display on the EGL_MESA_platform_surfaceless platform
+ * or a Vulkan instance with VK_EXT_headless_surface.
+ *
+ * It is never picked automatically, it has to be requested with
+ * `GDK_BACKEND=surfaceless` or gdk_set_allowed_backends().
+ */
+struct _GdkSurfacelessDisplay
+{
+  GdkDisplay parent_instance;
+
+  GListStore *monitors;
+  gulong serial;
+};
+
+G_DEFINE_TYPE (GdkSurfacelessDisplay, gdk_surfaceless_display, GDK_TYPE_DISPLAY)
+
+GdkDisplay *
+_gdk_surfaceless_display_open (const char *display_name)
+{
+  GdkDisplay *display;
+
+  display = g_object_new (GDK_TYPE_SURFACELESS_DISPLAY, NULL);
+
+  g_signal_emit_by_name (display, "opened");
+
+  return display;
+}
+
+static const char *
+gdk_surfaceless_display_get_name (GdkDisplay *display)
+{
+  return "Surfaceless";
+}
+
+static void
+gdk_surfaceless_display_beep (GdkDisplay *display)
+{
+}
+
+static void
+gdk_surfaceless_display_sync (GdkDisplay *display)
+{
+}
+
+static void
+gdk_surfaceless_display_flush (GdkDisplay *display)
+{
+}
+
+static gboolean
+gdk_surfaceless_display_has_pending (GdkDisplay *display)
+{
+  return FALSE;
+}
+
+static void
+gdk_surfaceless_display_queue_events (GdkDisplay *display)
+{
+}
+
+static gulong
+gdk_surfaceless_display_get_next_serial (GdkDisplay *display)
+{
+  GdkSurfacelessDisplay *self = GDK_SURFACELESS_DISPLAY (display);
+
+  return ++self->serial;
+}
+
+static void
+gdk_surfaceless_display_notify_startup_complete (GdkDisplay *display,
+                                                 const char *startup_id)
+{
+}
+
+static GdkKeymap *
+gdk_surfaceless_display_get_keymap (GdkDisplay *display)
+{
+  return NULL;
+}
+
+static GListModel *
+gdk_surfaceless_display_get_monitors (GdkDisplay *display)
+{
+  GdkSurfacelessDisplay *self = GDK_SURFACELESS_DISPLAY (display);
+
+  return G_LIST_MODEL (self->monitors);
+}
+
+static GdkMonitor *
+gdk_surfaceless_display_get_monitor_at_surface (GdkDisplay *display,
+                                                GdkSurface *surface)
+{
+  return NULL;
+}
+
+static gboolean
+gdk_surfaceless_display_get_setting (GdkDisplay *display,
+                                     const char *name,
+                                     GValue     *value)
+{
+  return FALSE;
+}
+
+GdkGLContext *
+gdk_surfaceless_display_init_gl (GdkDisplay  *display,
+                                 GError     **error)
+{
+#ifdef EGL_PLATFORM_SURFACELESS_MESA
+  if (!epoxy_has_egl_extension (NULL, "EGL_MESA_platform_surfaceless"))
+    {
+      g_set_error_literal (error, GDK_GL_ERROR, GDK_GL_ERROR_NOT_AVAILABLE,
+                           _("EGL implementation is missing extension EGL_MESA_platform_surfaceless"));
+      return NULL;
+    }
+
+  if (!gdk_display_init_egl (display,
+                             EGL_PLATFORM_SURFACELESS_MESA,
+                             EGL_DEFAULT_DISPLAY,
+                             TRUE,
+                             error))
+    return NULL;
+
+  return g_object_new (GDK_TYPE_SURFACELESS_GL_CONTEXT,
+                       "display", display,
+                       NULL);
+#else
+  g_set_error_literal (error, GDK_GL_ERROR, GDK_GL_ERROR_NOT_AVAILABLE,
+                       _("The current backend does not support OpenGL"));
+  return NULL;
+#endif
+}
+
+static void
+gdk_surfaceless_display_finalize (GObject *object)
+{
+  GdkSurfacelessDisplay *self = GDK_SURFACELESS_DISPLAY (object);
+
+  g_clear_object (&self->monitors);
+
+  G_OBJECT_CLASS (gdk_surfaceless_display_parent_class)->finalize (object);
+}
+
+static void
+gdk_surfaceless_display_class_init (GdkSurfacelessDisplayClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+  GdkDisplayClass *display_class = GDK_DISPLAY_CLASS (class);
+
+  object_class->finalize = gdk_surfaceless_display_finalize;
+
+  /* Surfaces are not supported, so toplevel_type, popup_type and
+   * cairo_context_type are left unset.
+   */
+#ifdef GDK_RENDERING_VULKAN
+  display_class->vk_context_type = GDK_TYPE_SURFACELESS_VULKAN_CONTEXT;
+  display_class->vk_extension_name = VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME;
+#endif
+
+  display_class->get_name = gdk_surfaceless_display_get_name;
+  display_class->beep = gdk_surfaceless_display_beep;
+  display_class->sync = gdk_surfaceless_display_sync;
+  display_class->flush = gdk_surfaceless_display_flush;
+  display_class->has_pending = gdk_surfaceless_display_has_pending;
+  display_class->queue_events = gdk_surfaceless_display_queue_events;
+  display_class->get_next_serial = gdk_surfaceless_display_get_next_serial;
+  display_class->notify_startup_complete = gdk_surfaceless_display_notify_startup_complete;
+  display_class->get_keymap = gdk_surfaceless_display_get_keymap;
+  display_class->init_gl = gdk_surfaceless_display_init_gl;
+  display_class->get_monitors = gdk_surfaceless_display_get_monitors;
+  display_class->get_monitor_at_surface = gdk_surfaceless_display_get_monitor_at_surface;
+  display_class->get_setting = gdk_surfaceless_display_get_setting;
+}
+
+static void
+gdk_surfaceless_display_init (GdkSurfacelessDisplay *self)
+{
+  self->monitors = g_list_store_new (GDK_TYPE_MONITOR);
+}
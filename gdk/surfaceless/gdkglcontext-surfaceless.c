@@ -0,0 +1,47 @@
+/* GDK - The GIMP Drawing Kit
+ *
+ * gdkglcontext-surfaceless.c: Surfaceless EGL context
+ *
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkprivate-surfaceless.h"
+
+/* Contexts of a GdkSurfacelessDisplay never have a surface, so
+ * GdkGLContext's EGL implementation always makes them current
+ * with EGL_NO_SURFACE and we only need to pick the backend.
+ */
+struct _GdkSurfacelessGLContext
+{
+  GdkGLContext parent_instance;
+};
+
+G_DEFINE_TYPE (GdkSurfacelessGLContext, gdk_surfaceless_gl_context, GDK_TYPE_GL_CONTEXT)
+
+static void
+gdk_surfaceless_gl_context_class_init (GdkSurfacelessGLContextClass *klass)
+{
+  GdkGLContextClass *context_class = GDK_GL_CONTEXT_CLASS (klass);
+
+  context_class->backend_type = GDK_GL_EGL;
+}
+
+static void
+gdk_surfaceless_gl_context_init (GdkSurfacelessGLContext *self)
+{
+}
@@ -0,0 +1,45 @@
+/* GDK - The GIMP Drawing Kit
+ *
+ * gdkprivate-surfaceless.h: Surfaceless backend for offscreen rendering
+ *
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "gdkdisplayprivate.h"
+#include "gdkglcontextprivate.h"
+#include "gdkvulkancontextprivate.h"
+
+G_BEGIN_DECLS
+
+#define GDK_TYPE_SURFACELESS_DISPLAY (gdk_surfaceless_display_get_type ())
+G_DECLARE_FINAL_TYPE (GdkSurfacelessDisplay, gdk_surfaceless_display, GDK, SURFACELESS_DISPLAY, GdkDisplay)
+
+#define GDK_TYPE_SURFACELESS_GL_CONTEXT (gdk_surfaceless_gl_context_get_type ())
+G_DECLARE_FINAL_TYPE (GdkSurfacelessGLContext, gdk_surfaceless_gl_context, GDK, SURFACELESS_GL_CONTEXT, GdkGLContext)
+
+#ifdef GDK_RENDERING_VULKAN
+#define GDK_TYPE_SURFACELESS_VULKAN_CONTEXT (gdk_surfaceless_vulkan_context_get_type ())
+G_DECLARE_FINAL_TYPE (GdkSurfacelessVulkanContext, gdk_surfaceless_vulkan_context, GDK, SURFACELESS_VULKAN_CONTEXT, GdkVulkanContext)
+#endif
+
+GdkDisplay *    _gdk_surfaceless_display_open                   (const char     *display_name);
+
+GdkGLContext *  gdk_surfaceless_display_init_gl                 (GdkDisplay     *display,
+                                                                 GError        **error);
+
+G_END_DECLS
@@ -0,0 +1,63 @@
+/* GDK - The GIMP Drawing Kit
+ *
+ * gdkvulkancontext-surfaceless.c: Headless Vulkan context
+ *
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Library General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Library General Public License for more details.
+ *
+ * You should have received a copy of the GNU Library General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkconfig.h"
+
+#ifdef GDK_RENDERING_VULKAN
+
+#include "gdkprivate-surfaceless.h"
+
+struct _GdkSurfacelessVulkanContext
+{
+  GdkVulkanContext parent_instance;
+};
+
+G_DEFINE_TYPE (GdkSurfacelessVulkanContext, gdk_surfaceless_vulkan_context, GDK_TYPE_VULKAN_CONTEXT)
+
+static VkResult
+gdk_surfaceless_vulkan_context_create_surface (GdkVulkanContext *context,
+                                               VkSurfaceKHR     *surface)
+{
+  return GDK_VK_CHECK (vkCreateHeadlessSurfaceEXT, gdk_vulkan_context_get_instance (context),
+                                                   &(VkHeadlessSurfaceCreateInfoEXT) {
+                                                       VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+                                                       NULL,
+                                                       0
+                                                   },
+                                                   NULL,
+                                                   surface);
+}
+
+static void
+gdk_surfaceless_vulkan_context_class_init (GdkSurfacelessVulkanContextClass *klass)
+{
+  GdkVulkanContextClass *context_class = GDK_VULKAN_CONTEXT_CLASS (klass);
+
+  context_class->create_surface = gdk_surfaceless_vulkan_context_create_surface;
+}
+
+static void
+gdk_surfaceless_vulkan_context_init (GdkSurfacelessVulkanContext *self)
+{
+}
+
+#endif /* GDK_RENDERING_VULKAN */
@@ -129,9 +129,11 @@ gdk_wayland_cairo_context_create_surface (GdkWaylandCairoContext *self)
 
   width = gdk_surface_get_width (surface);
   height = gdk_surface_get_height (surface);
-  cairo_surface = gdk_wayland_display_create_shm_surface (display_wayland,
-                                                          width, height,
-                                                          &GDK_WAYLAND_SURFACE (surface)->scale);
+  cairo_surface = gdk_wayland_display_create_shm_surface_reusing (display_wayland,
+                                                                  width, height,
+                                                                  &GDK_WAYLAND_SURFACE (surface)->scale,
+                                                                  self->spare_surface);
+  g_clear_pointer (&self->spare_surface, cairo_surface_destroy);
   buffer = _gdk_wayland_shm_surface_get_wl_buffer (cairo_surface);
   wl_buffer_add_listener (buffer, &buffer_listener, cairo_surface);
   gdk_wayland_cairo_context_add_surface (self, cairo_surface);
@@ -207,6 +209,16 @@ gdk_wayland_cairo_context_surface_resized (GdkDrawContext *draw_context)
 {
   GdkWaylandCairoContext *self = GDK_WAYLAND_CAIRO_CONTEXT (draw_context);
 
+  /* Keep the memory of a surface that the compositor released,
+   * the next one can often use it when the size changes a bit.
+   */
+  if (self->cached_surface)
+    {
+      g_clear_pointer (&self->spare_surface, cairo_surface_destroy);
+      self->spare_surface = g_steal_pointer (&self->cached_surface);
+      gdk_wayland_cairo_context_remove_surface (self, self->spare_surface);
+    }
+
   gdk_wayland_cairo_context_clear_all_cairo_surfaces (self);
 }
 
@@ -224,6 +236,7 @@ gdk_wayland_cairo_context_dispose (GObject *object)
   GdkWaylandCairoContext *self = GDK_WAYLAND_CAIRO_CONTEXT (object);
 
   gdk_wayland_cairo_context_clear_all_cairo_surfaces (self);
+  g_clear_pointer (&self->spare_surface, cairo_surface_destroy);
   g_assert (self->cached_surface == NULL);
   g_assert (self->paint_surface == NULL);
 
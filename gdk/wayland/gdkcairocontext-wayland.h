@@ -41,6 +41,8 @@ struct _GdkWaylandCairoContext
   GSList *surfaces;
   cairo_surface_t *cached_surface;
   cairo_surface_t *paint_surface;
+  /* released surface of the previous size, for reusing its memory */
+  cairo_surface_t *spare_surface;
 };
 
 struct _GdkWaylandCairoContextClass
@@ -322,6 +322,40 @@ static const struct org_kde_kwin_server_decoration_manager_listener server_decor
   .default_mode = server_decoration_manager_default_mode
 };
 
+static void
+linux_dmabuf_format (void                       *data,
+                     struct zwp_linux_dmabuf_v1 *linux_dmabuf,
+                     uint32_t                    format)
+{
+  /* Deprecated in favor of the modifier event */
+}
+
+static void
+linux_dmabuf_modifier (void                       *data,
+                       struct zwp_linux_dmabuf_v1 *linux_dmabuf,
+                       uint32_t                    format,
+                       uint32_t                    modifier_hi,
+                       uint32_t                    modifier_lo)
+{
+  GdkWaylandDisplay *display_wayland = data;
+  GdkWaylandDmabufFormat dmabuf_format;
+
+  if (display_wayland->linux_dmabuf_formats == NULL)
+    display_wayland->linux_dmabuf_formats = g_array_new (FALSE, FALSE, sizeof (GdkWaylandDmabufFormat));
+
+  dmabuf_format.fourcc = format;
+  dmabuf_format.modifier = ((guint64) modifier_hi << 32) | modifier_lo;
+  g_array_append_val (display_wayland->linux_dmabuf_formats, dmabuf_format);
+
+  GDK_DISPLAY_DEBUG (GDK_DISPLAY (data), MISC, "Compositor supports dmabuf format %.4s:%#" G_GINT64_MODIFIER "x",
+                     (char *) &dmabuf_format.fourcc, dmabuf_format.modifier);
+}
+
+static const struct zwp_linux_dmabuf_v1_listener linux_dmabuf_listener = {
+  linux_dmabuf_format,
+  linux_dmabuf_modifier,
+};
+
 /*
  * gdk_wayland_display_prefers_ssd:
  * @display: (type GdkWaylandDisplay): a `GdkDisplay`
@@ -352,6 +386,20 @@ static void gdk_wayland_display_remove_output     (GdkWaylandDisplay *display_wa
 static void gdk_wayland_display_init_xdg_output   (GdkWaylandDisplay *display_wayland);
 static void gdk_wayland_display_get_xdg_output    (GdkWaylandMonitor *monitor);
 
+static void
+presentation_handle_clock_id (void                   *data,
+                              struct wp_presentation *presentation,
+                              uint32_t                clock_id)
+{
+  GdkWaylandDisplay *display_wayland = data;
+
+  display_wayland->presentation_clock_id = clock_id;
+}
+
+static const struct wp_presentation_listener presentation_listener = {
+  presentation_handle_clock_id,
+};
+
 static void
 gdk_registry_handle_global (void               *data,
                             struct wl_registry *registry,
@@ -523,6 +571,26 @@ gdk_registry_handle_global (void               *data,
                           &wp_viewporter_interface,
                           MIN (version, 1));
     }
+  else if (strcmp (interface, "wp_presentation") == 0)
+    {
+      display_wayland->presentation =
+        wl_registry_bind (display_wayland->wl_registry, id,
+                          &wp_presentation_interface,
+                          MIN (version, 1));
+      wp_presentation_add_listener (display_wayland->presentation,
+                                    &presentation_listener,
+                                    display_wayland);
+    }
+  else if (strcmp (interface, "zwp_linux_dmabuf_v1") == 0 && version >= 3)
+    {
+      display_wayland->linux_dmabuf =
+        wl_registry_bind (display_wayland->wl_registry, id,
+                          &zwp_linux_dmabuf_v1_interface, 3);
+      zwp_linux_dmabuf_v1_add_listener (display_wayland->linux_dmabuf,
+                                        &linux_dmabuf_listener,
+                                        display_wayland);
+      _gdk_wayland_display_async_roundtrip (display_wayland);
+    }
 
 
   g_hash_table_insert (display_wayland->known_globals,
@@ -719,6 +787,9 @@ gdk_wayland_display_dispose (GObject *object)
   g_clear_pointer (&display_wayland->xdg_activation, xdg_activation_v1_destroy);
   g_clear_pointer (&display_wayland->fractional_scale, wp_fractional_scale_manager_v1_destroy);
   g_clear_pointer (&display_wayland->viewporter, wp_viewporter_destroy);
+  g_clear_pointer (&display_wayland->presentation, wp_presentation_destroy);
+  g_clear_pointer (&display_wayland->linux_dmabuf, zwp_linux_dmabuf_v1_destroy);
+  g_clear_pointer (&display_wayland->linux_dmabuf_formats, g_array_unref);
 
   g_clear_pointer (&display_wayland->shm, wl_shm_destroy);
   g_clear_pointer (&display_wayland->wl_registry, wl_registry_destroy);
@@ -1333,21 +1404,25 @@ gdk_wayland_cairo_surface_destroy (void *p)
   if (data->pool)
     wl_shm_pool_destroy (data->pool);
 
-  munmap (data->buf, data->buf_length);
+  if (data->buf)
+    munmap (data->buf, data->buf_length);
   g_free (data);
 }
 
-cairo_surface_t *
-gdk_wayland_display_create_shm_surface (GdkWaylandDisplay        *display,
-                                        int                       width,
-                                        int                       height,
-                                        const GdkFractionalScale *scale)
+static cairo_surface_t *
+create_shm_surface (GdkWaylandDisplay        *display,
+                    int                       width,
+                    int                       height,
+                    const GdkFractionalScale *scale,
+                    cairo_surface_t          *reuse,
+                    gboolean                  headroom)
 {
   GdkWaylandCairoSurfaceData *data;
   cairo_surface_t *surface = NULL;
   cairo_status_t status;
   int scaled_width, scaled_height;
   int stride;
+  size_t size;
 
   data = g_new (GdkWaylandCairoSurfaceData, 1);
   data->display = display;
@@ -1357,13 +1432,41 @@ gdk_wayland_display_create_shm_surface (GdkWaylandDisplay        *display,
   scaled_width = gdk_fractional_scale_scale (scale, width);
   scaled_height = gdk_fractional_scale_scale (scale, height);
   stride = cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, scaled_width);
+  size = (size_t) scaled_height * stride;
 
-  data->pool = create_shm_pool (display->shm,
-                                scaled_height * stride,
-                                &data->buf_length,
-                                &data->buf);
-  if (G_UNLIKELY (data->pool == NULL))
-    g_error ("Unable to create shared memory pool");
+  if (reuse)
+    {
+      GdkWaylandCairoSurfaceData *old = cairo_surface_get_user_data (reuse, &gdk_wayland_shm_surface_cairo_key);
+
+      /* Take over the memory of the old surface, it is destroyed
+       * without unmapping it.
+       */
+      if (old && old->pool && old->buf_length >= size)
+        {
+          data->pool = g_steal_pointer (&old->pool);
+          data->buf = g_steal_pointer (&old->buf);
+          data->buf_length = old->buf_length;
+          old->buf_length = 0;
+        }
+      else
+        reuse = NULL;
+    }
+
+  if (!reuse)
+    {
+      /* Leave room for growing a bit, so interactive resizes
+       * don't need a new pool for every configure.
+       */
+      if (headroom)
+        size += size / 4;
+
+      data->pool = create_shm_pool (display->shm,
+                                    size,
+                                    &data->buf_length,
+                                    &data->buf);
+      if (G_UNLIKELY (data->pool == NULL))
+        g_error ("Unable to create shared memory pool");
+    }
 
   surface = cairo_image_surface_create_for_data (data->buf,
                                                  CAIRO_FORMAT_ARGB32,
@@ -1392,6 +1495,40 @@ gdk_wayland_display_create_shm_surface (GdkWaylandDisplay        *display,
   return surface;
 }
 
+cairo_surface_t *
+gdk_wayland_display_create_shm_surface (GdkWaylandDisplay        *display,
+                                        int                       width,
+                                        int                       height,
+                                        const GdkFractionalScale *scale)
+{
+  return create_shm_surface (display, width, height, scale, NULL, FALSE);
+}
+
+/*
+ * gdk_wayland_display_create_shm_surface_reusing:
+ * @display: the display
+ * @width: the width
+ * @height: the height
+ * @scale: the scale
+ * @reuse: (nullable): a shm surface that is no longer used
+ *
+ * Creates a shm surface like gdk_wayland_display_create_shm_surface(),
+ * for surfaces that are expected to change size.
+ *
+ * If the memory of @reuse is large enough, it is taken over by the new
+ * surface, and @reuse must not be used for anything but destroying it
+ * afterwards. Otherwise new memory is allocated, with room to grow.
+ */
+cairo_surface_t *
+gdk_wayland_display_create_shm_surface_reusing (GdkWaylandDisplay        *display,
+                                                int                       width,
+                                                int                       height,
+                                                const GdkFractionalScale *scale,
+                                                cairo_surface_t          *reuse)
+{
+  return create_shm_surface (display, width, height, scale, reuse, TRUE);
+}
+
 struct wl_buffer *
 _gdk_wayland_shm_surface_get_wl_buffer (cairo_surface_t *surface)
 {
@@ -39,6 +39,8 @@
 #include <gdk/wayland/xdg-activation-v1-client-protocol.h>
 #include <gdk/wayland/fractional-scale-v1-client-protocol.h>
 #include <gdk/wayland/viewporter-client-protocol.h>
+#include <gdk/wayland/presentation-time-client-protocol.h>
+#include <gdk/wayland/linux-dmabuf-unstable-v1-client-protocol.h>
 
 #include <glib.h>
 #include <gdk/gdkkeys.h>
@@ -71,6 +73,12 @@ typedef enum _GdkWaylandShellVariant
   GDK_WAYLAND_SHELL_VARIANT_ZXDG_SHELL_V6
 } GdkWaylandShellVariant;
 
+typedef struct
+{
+  guint32 fourcc;
+  guint64 modifier;
+} GdkWaylandDmabufFormat;
+
 struct _GdkWaylandDisplay
 {
   GdkDisplay parent_instance;
@@ -114,6 +122,11 @@ struct _GdkWaylandDisplay
   struct xdg_activation_v1 *xdg_activation;
   struct wp_fractional_scale_manager_v1 *fractional_scale;
   struct wp_viewporter *viewporter;
+  struct wp_presentation *presentation;
+  guint32 presentation_clock_id;
+  struct zwp_linux_dmabuf_v1 *linux_dmabuf;
+
+  GArray *linux_dmabuf_formats; /* GdkWaylandDmabufFormat */
 
   GList *async_roundtrips;
 
@@ -203,6 +203,11 @@ cairo_surface_t * gdk_wayland_display_create_shm_surface  (GdkWaylandDisplay
                                                            int                       width,
                                                            int                       height,
                                                            const GdkFractionalScale *scale);
+cairo_surface_t * gdk_wayland_display_create_shm_surface_reusing (GdkWaylandDisplay        *display,
+                                                                  int                       width,
+                                                                  int                       height,
+                                                                  const GdkFractionalScale *scale,
+                                                                  cairo_surface_t          *reuse);
 struct wl_buffer *_gdk_wayland_shm_surface_get_wl_buffer (cairo_surface_t *surface);
 gboolean _gdk_wayland_is_shm_surface (cairo_surface_t *surface);
 
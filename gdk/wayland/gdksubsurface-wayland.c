@@ -0,0 +1,347 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gdkdisplay-wayland.h"
+#include "gdkprivate-wayland.h"
+#include "gdksubsurfaceprivate.h"
+#include "gdksurface-wayland-private.h"
+
+#include "gdkdmabuftextureprivate.h"
+#include "gdkmemorytextureprivate.h"
+#include "gdktextureprivate.h"
+
+#include <math.h>
+
+typedef struct _GdkWaylandSubsurface GdkWaylandSubsurface;
+typedef struct _GdkWaylandSubsurfaceClass GdkWaylandSubsurfaceClass;
+
+#define GDK_TYPE_WAYLAND_SUBSURFACE (gdk_wayland_subsurface_get_type ())
+#define GDK_WAYLAND_SUBSURFACE(obj) (G_TYPE_CHECK_INSTANCE_CAST ((obj), GDK_TYPE_WAYLAND_SUBSURFACE, GdkWaylandSubsurface))
+
+struct _GdkWaylandSubsurface
+{
+  GdkSubsurface parent_instance;
+
+  struct wl_surface *surface;
+  struct wl_subsurface *subsurface;
+  struct wp_viewport *viewport;
+
+  GdkTexture *texture;
+  graphene_rect_t rect;
+};
+
+struct _GdkWaylandSubsurfaceClass
+{
+  GdkSubsurfaceClass parent_class;
+};
+
+GType gdk_wayland_subsurface_get_type (void) G_GNUC_CONST;
+
+G_DEFINE_TYPE (GdkWaylandSubsurface, gdk_wayland_subsurface, GDK_TYPE_SUBSURFACE)
+
+static void
+gdk_wayland_subsurface_init (GdkWaylandSubsurface *self)
+{
+}
+
+static void
+gdk_wayland_subsurface_finalize (GObject *object)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (object);
+
+  g_clear_object (&self->texture);
+  g_clear_pointer (&self->viewport, wp_viewport_destroy);
+  g_clear_pointer (&self->subsurface, wl_subsurface_destroy);
+  g_clear_pointer (&self->surface, wl_surface_destroy);
+
+  G_OBJECT_CLASS (gdk_wayland_subsurface_parent_class)->finalize (object);
+}
+
+static void
+shm_buffer_release (void             *data,
+                    struct wl_buffer *buffer)
+{
+  cairo_surface_t *surface = data;
+
+  /* Release the reference the compositor held to this surface */
+  cairo_surface_destroy (surface);
+}
+
+static const struct wl_buffer_listener shm_buffer_listener = {
+  shm_buffer_release,
+};
+
+static void
+dmabuf_buffer_release (void             *data,
+                       struct wl_buffer *buffer)
+{
+  GdkTexture *texture = data;
+
+  /* The compositor is done reading from the dmabuf */
+  g_object_unref (texture);
+  wl_buffer_destroy (buffer);
+}
+
+static const struct wl_buffer_listener dmabuf_buffer_listener = {
+  dmabuf_buffer_release,
+};
+
+static gboolean
+gdk_wayland_display_supports_dmabuf (GdkWaylandDisplay *display,
+                                     const GdkDmabuf   *dmabuf)
+{
+  if (display->linux_dmabuf == NULL || display->linux_dmabuf_formats == NULL)
+    return FALSE;
+
+  for (guint i = 0; i < display->linux_dmabuf_formats->len; i++)
+    {
+      const GdkWaylandDmabufFormat *format = &g_array_index (display->linux_dmabuf_formats, GdkWaylandDmabufFormat, i);
+
+      if (format->fourcc == dmabuf->fourcc && format->modifier == dmabuf->modifier)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static struct wl_buffer *
+gdk_wayland_subsurface_create_dmabuf_buffer (GdkWaylandSubsurface *self,
+                                             GdkTexture           *texture)
+{
+  GdkSurface *parent = GDK_SUBSURFACE (self)->parent;
+  GdkWaylandDisplay *display = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (parent));
+  const GdkDmabuf *dmabuf = gdk_dmabuf_texture_get_dmabuf (GDK_DMABUF_TEXTURE (texture));
+  struct zwp_linux_buffer_params_v1 *params;
+  struct wl_buffer *buffer;
+
+  /* Compositors expect premultiplied alpha */
+  if (gdk_memory_format_alpha (gdk_texture_get_format (texture)) == GDK_MEMORY_ALPHA_STRAIGHT)
+    return NULL;
+
+  if (!gdk_wayland_display_supports_dmabuf (display, dmabuf))
+    {
+      GDK_DISPLAY_DEBUG (GDK_DISPLAY (display), OFFLOAD,
+                         "Compositor does not support dmabuf format %.4s:%#" G_GINT64_MODIFIER "x",
+                         (char *) &dmabuf->fourcc, dmabuf->modifier);
+      return NULL;
+    }
+
+  params = zwp_linux_dmabuf_v1_create_params (display->linux_dmabuf);
+
+  for (unsigned int i = 0; i < dmabuf->n_planes; i++)
+    zwp_linux_buffer_params_v1_add (params,
+                                    dmabuf->planes[i].fd,
+                                    i,
+                                    dmabuf->planes[i].offset,
+                                    dmabuf->planes[i].stride,
+                                    dmabuf->modifier >> 32,
+                                    dmabuf->modifier & 0xffffffff);
+
+  buffer = zwp_linux_buffer_params_v1_create_immed (params,
+                                                    gdk_texture_get_width (texture),
+                                                    gdk_texture_get_height (texture),
+                                                    dmabuf->fourcc,
+                                                    0);
+  zwp_linux_buffer_params_v1_destroy (params);
+
+  /* The texture owns the file descriptors, so it must outlive the buffer */
+  wl_buffer_add_listener (buffer, &dmabuf_buffer_listener, g_object_ref (texture));
+
+  return buffer;
+}
+
+static struct wl_buffer *
+gdk_wayland_subsurface_create_buffer (GdkWaylandSubsurface *self,
+                                      GdkTexture           *texture)
+{
+  GdkSurface *parent = GDK_SUBSURFACE (self)->parent;
+  GdkWaylandDisplay *display = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (parent));
+  cairo_surface_t *surface;
+  struct wl_buffer *buffer;
+
+  /* Dmabufs can be handed to the compositor as they are */
+  if (GDK_IS_DMABUF_TEXTURE (texture))
+    return gdk_wayland_subsurface_create_dmabuf_buffer (self, texture);
+
+  /* Memory textures have to be copied once, into memory the
+   * compositor can read. That is still cheaper than drawing them,
+   * and the copy is skipped when the same texture is shown again.
+   */
+  if (!GDK_IS_MEMORY_TEXTURE (texture))
+    return NULL;
+
+  surface = gdk_wayland_display_create_shm_surface (display,
+                                                    gdk_texture_get_width (texture),
+                                                    gdk_texture_get_height (texture),
+                                                    &GDK_FRACTIONAL_SCALE_INIT_INT (1));
+  gdk_texture_download (texture,
+                        cairo_image_surface_get_data (surface),
+                        cairo_image_surface_get_stride (surface));
+  cairo_surface_mark_dirty (surface);
+
+  buffer = _gdk_wayland_shm_surface_get_wl_buffer (surface);
+  wl_buffer_add_listener (buffer, &shm_buffer_listener, surface);
+
+  return buffer;
+}
+
+static gboolean
+gdk_wayland_subsurface_attach (GdkSubsurface         *sub,
+                               GdkTexture            *texture,
+                               const graphene_rect_t *rect)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (sub);
+  GdkWaylandDisplay *display = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (sub->parent));
+
+  /* Subsurfaces are positioned in integer surface coordinates */
+  if (rect->origin.x != floorf (rect->origin.x) ||
+      rect->origin.y != floorf (rect->origin.y) ||
+      rect->size.width != floorf (rect->size.width) ||
+      rect->size.height != floorf (rect->size.height) ||
+      rect->size.width < 1 || rect->size.height < 1)
+    goto fail;
+
+  if (self->texture != texture)
+    {
+      struct wl_buffer *buffer;
+
+      buffer = gdk_wayland_subsurface_create_buffer (self, texture);
+      if (buffer == NULL)
+        goto fail;
+
+      wl_surface_attach (self->surface, buffer, 0, 0);
+      wl_surface_damage (self->surface, 0, 0, rect->size.width, rect->size.height);
+
+      if (gdk_memory_format_alpha (gdk_texture_get_format (texture)) == GDK_MEMORY_ALPHA_OPAQUE)
+        {
+          struct wl_region *region;
+
+          region = wl_compositor_create_region (display->compositor);
+          wl_region_add (region, 0, 0, rect->size.width, rect->size.height);
+          wl_surface_set_opaque_region (self->surface, region);
+          wl_region_destroy (region);
+        }
+      else
+        wl_surface_set_opaque_region (self->surface, NULL);
+
+      g_set_object (&self->texture, texture);
+    }
+
+  if (!graphene_rect_equal (&self->rect, rect))
+    {
+      wl_subsurface_set_position (self->subsurface, rect->origin.x, rect->origin.y);
+      wp_viewport_set_destination (self->viewport, rect->size.width, rect->size.height);
+      self->rect = *rect;
+    }
+
+  /* The subsurface is synchronized, so this only takes effect
+   * once the parent surface commits its next frame.
+   */
+  wl_surface_commit (self->surface);
+
+  return TRUE;
+
+fail:
+  gdk_subsurface_detach (sub);
+  return FALSE;
+}
+
+static void
+gdk_wayland_subsurface_detach (GdkSubsurface *sub)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (sub);
+
+  if (self->texture == NULL)
+    return;
+
+  wl_surface_attach (self->surface, NULL, 0, 0);
+  wl_surface_commit (self->surface);
+
+  g_clear_object (&self->texture);
+  self->rect = GRAPHENE_RECT_INIT (0, 0, 0, 0);
+}
+
+static GdkTexture *
+gdk_wayland_subsurface_get_texture (GdkSubsurface *sub)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (sub);
+
+  return self->texture;
+}
+
+static void
+gdk_wayland_subsurface_get_rect (GdkSubsurface   *sub,
+                                 graphene_rect_t *rect)
+{
+  GdkWaylandSubsurface *self = GDK_WAYLAND_SUBSURFACE (sub);
+
+  *rect = self->rect;
+}
+
+static void
+gdk_wayland_subsurface_class_init (GdkWaylandSubsurfaceClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+  GdkSubsurfaceClass *subsurface_class = GDK_SUBSURFACE_CLASS (class);
+
+  object_class->finalize = gdk_wayland_subsurface_finalize;
+
+  subsurface_class->attach = gdk_wayland_subsurface_attach;
+  subsurface_class->detach = gdk_wayland_subsurface_detach;
+  subsurface_class->get_texture = gdk_wayland_subsurface_get_texture;
+  subsurface_class->get_rect = gdk_wayland_subsurface_get_rect;
+}
+
+GdkSubsurface *
+gdk_wayland_surface_create_subsurface (GdkSurface *surface)
+{
+  GdkWaylandSurface *impl = GDK_WAYLAND_SURFACE (surface);
+  GdkDisplay *display = gdk_surface_get_display (surface);
+  GdkWaylandDisplay *disp = GDK_WAYLAND_DISPLAY (display);
+  GdkWaylandSubsurface *sub;
+  struct wl_region *region;
+
+  /* Without a viewport, we could only show textures at buffer scale */
+  if (disp->subcompositor == NULL || disp->viewporter == NULL)
+    {
+      GDK_DISPLAY_DEBUG (display, OFFLOAD, "Can't use subsurfaces without subcompositor and viewporter");
+      return NULL;
+    }
+
+  sub = g_object_new (GDK_TYPE_WAYLAND_SUBSURFACE, NULL);
+  sub->parent_instance.parent = surface;
+
+  sub->surface = wl_compositor_create_surface (disp->compositor);
+
+  /* Let input go through to the parent */
+  region = wl_compositor_create_region (disp->compositor);
+  wl_surface_set_input_region (sub->surface, region);
+  wl_region_destroy (region);
+
+  sub->subsurface = wl_subcompositor_get_subsurface (disp->subcompositor,
+                                                     sub->surface,
+                                                     impl->display_server.wl_surface);
+  wl_subsurface_place_above (sub->subsurface, impl->display_server.wl_surface);
+  sub->viewport = wp_viewporter_get_viewport (disp->viewporter, sub->surface);
+
+  GDK_DISPLAY_DEBUG (display, OFFLOAD, "Subsurface %p of wl_surface %u created",
+                     sub, wl_proxy_get_id ((struct wl_proxy *) impl->display_server.wl_surface));
+
+  return GDK_SUBSURFACE (sub);
+}
@@ -33,6 +33,7 @@ struct _GdkWaylandSurface
 
   struct {
     GSList *outputs;
+    struct wl_output *presentation_output; /* the output the last frame was shown on */
     struct wl_surface *wl_surface;
     struct xdg_surface *xdg_surface;
     struct zxdg_surface_v6 *zxdg_surface_v6;
@@ -43,6 +44,7 @@ struct _GdkWaylandSurface
 
   struct wl_event_queue *event_queue;
   struct wl_callback *frame_callback;
+  GList *presentation_feedbacks; /* PresentationFeedback */
 
   unsigned int initial_configure_received : 1;
   unsigned int has_uncommitted_ack_configure : 1;
@@ -122,6 +124,8 @@ void gdk_wayland_surface_get_window_geometry (GdkSurface   *surface,
 void gdk_wayland_surface_freeze_state (GdkSurface *surface);
 void gdk_wayland_surface_thaw_state   (GdkSurface *surface);
 
+GdkSubsurface * gdk_wayland_surface_create_subsurface (GdkSurface *surface);
+
 
 #define GDK_TYPE_WAYLAND_DRAG_SURFACE (gdk_wayland_drag_surface_get_type ())
 GType gdk_wayland_drag_surface_get_type (void) G_GNUC_CONST;
@@ -43,6 +43,7 @@
 #include <errno.h>
 
 #include <netinet/in.h>
+#include <time.h>
 #include <unistd.h>
 
 #include "gdksurface-wayland-private.h"
@@ -193,19 +194,19 @@ get_egl_window_size (GdkSurface *surface,
   GdkDisplay *display = gdk_surface_get_display (surface);
   GdkWaylandSurface *impl = GDK_WAYLAND_SURFACE (surface);
 
-  if (gdk_display_get_debug_flags (display) & GDK_DEBUG_GL_FRACTIONAL)
+  if (gdk_display_get_debug_flags (display) & GDK_DEBUG_GL_NO_FRACTIONAL)
     {
-      GDK_DISPLAY_DEBUG (display, OPENGL, "Using fractional scale %g for EGL window", gdk_fractional_scale_to_double (&impl->scale));
+      GDK_DISPLAY_DEBUG (display, OPENGL, "Using integer scale %d for EGL window", gdk_fractional_scale_to_int (&impl->scale));
 
-      *width = gdk_fractional_scale_scale (&impl->scale, surface->width),
-      *height = gdk_fractional_scale_scale (&impl->scale, surface->height);
+      *width = surface->width * gdk_fractional_scale_to_int (&impl->scale);
+      *height = surface->height * gdk_fractional_scale_to_int (&impl->scale);
     }
   else
     {
-      GDK_DISPLAY_DEBUG (display, OPENGL, "Using integer scale %d for EGL window", gdk_fractional_scale_to_int (&impl->scale));
+      GDK_DISPLAY_DEBUG (display, OPENGL, "Using fractional scale %g for EGL window", gdk_fractional_scale_to_double (&impl->scale));
 
-      *width = surface->width * gdk_fractional_scale_to_int (&impl->scale);
-      *height = surface->height * gdk_fractional_scale_to_int (&impl->scale);
+      *width = gdk_fractional_scale_scale (&impl->scale, surface->width);
+      *height = gdk_fractional_scale_scale (&impl->scale, surface->height);
     }
 }
 
@@ -258,6 +259,176 @@ gdk_wayland_surface_update_size (GdkSurface               *surface,
   _gdk_surface_update_size (surface);
 }
 
+typedef struct {
+  GdkSurface *surface;
+  gint64 frame_counter;
+  struct wp_presentation_feedback *feedback;
+} PresentationFeedback;
+
+static void
+presentation_feedback_free (PresentationFeedback *self)
+{
+  wp_presentation_feedback_destroy (self->feedback);
+  g_free (self);
+}
+
+static PresentationFeedback *
+find_presentation_feedback (GdkWaylandSurface *impl,
+                            gint64             frame_counter)
+{
+  GList *l;
+
+  for (l = impl->presentation_feedbacks; l; l = l->next)
+    {
+      PresentationFeedback *feedback = l->data;
+
+      if (feedback->frame_counter == frame_counter)
+        return feedback;
+    }
+
+  return NULL;
+}
+
+static void
+complete_timings (GdkFrameClock   *clock,
+                  GdkFrameTimings *timings)
+{
+  timings->complete = TRUE;
+
+#ifdef G_ENABLE_DEBUG
+  if ((_gdk_debug_flags & GDK_DEBUG_FRAMES) != 0)
+    _gdk_frame_clock_debug_print_timings (clock, timings);
+#endif
+
+  if (GDK_PROFILER_IS_RUNNING)
+    _gdk_frame_clock_add_timings_to_profiler (clock, timings);
+}
+
+static void
+presentation_feedback_done (PresentationFeedback *self,
+                            gboolean              presented,
+                            gint64                presentation_time,
+                            gint64                refresh_interval)
+{
+  GdkSurface *surface = self->surface;
+  GdkWaylandSurface *impl = GDK_WAYLAND_SURFACE (surface);
+  GdkFrameClock *clock = gdk_surface_get_frame_clock (surface);
+  GdkFrameTimings *timings;
+
+  timings = gdk_frame_clock_get_timings (clock, self->frame_counter);
+
+  impl->presentation_feedbacks = g_list_remove (impl->presentation_feedbacks, self);
+  presentation_feedback_free (self);
+
+  if (timings == NULL || timings->complete)
+    return;
+
+  if (presented)
+    {
+      if (presentation_time != 0)
+        timings->presentation_time = presentation_time;
+      if (refresh_interval != 0)
+        timings->refresh_interval = refresh_interval;
+    }
+
+  complete_timings (clock, timings);
+}
+
+static void
+presentation_feedback_sync_output (void                            *data,
+                                   struct wp_presentation_feedback *feedback,
+                                   struct wl_output                *output)
+{
+  PresentationFeedback *self = data;
+  GdkWaylandSurface *impl = GDK_WAYLAND_SURFACE (self->surface);
+
+  impl->display_server.presentation_output = output;
+}
+
+static void
+presentation_feedback_presented (void                            *data,
+                                 struct wp_presentation_feedback *feedback,
+                                 uint32_t                         tv_sec_hi,
+                                 uint32_t                         tv_sec_lo,
+                                 uint32_t                         tv_nsec,
+                                 uint32_t                         refresh,
+                                 uint32_t                         seq_hi,
+                                 uint32_t                         seq_lo,
+                                 uint32_t                         flags)
+{
+  PresentationFeedback *self = data;
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (self->surface));
+  GdkFrameClock *clock = gdk_surface_get_frame_clock (self->surface);
+  gint64 presentation_time = 0;
+
+  /* The protocol requires refresh to be zero for outputs that don't
+   * have a constant refresh rate, which is how we learn about VRR.
+   * Only trust this for frames that were actually synced to the output.
+   */
+  if (GDK_IS_FRAME_CLOCK_IDLE (clock) &&
+      (flags & WP_PRESENTATION_FEEDBACK_KIND_VSYNC) != 0)
+    _gdk_frame_clock_idle_set_variable_refresh (GDK_FRAME_CLOCK_IDLE (clock), refresh == 0);
+
+  /* Frame times are CLOCK_MONOTONIC, so other clocks are useless to us */
+  if (display_wayland->presentation_clock_id == CLOCK_MONOTONIC)
+    {
+      guint64 tv_sec = ((guint64) tv_sec_hi << 32) | tv_sec_lo;
+
+      presentation_time = tv_sec * G_USEC_PER_SEC + tv_nsec / 1000;
+    }
+
+  presentation_feedback_done (self, TRUE, presentation_time, refresh / 1000);
+}
+
+static void
+presentation_feedback_discarded (void                            *data,
+                                 struct wp_presentation_feedback *feedback)
+{
+  presentation_feedback_done (data, FALSE, 0, 0);
+}
+
+static const struct wp_presentation_feedback_listener presentation_feedback_listener = {
+  presentation_feedback_sync_output,
+  presentation_feedback_presented,
+  presentation_feedback_discarded,
+};
+
+static void
+clear_presentation_feedbacks (GdkWaylandSurface *impl)
+{
+  g_list_free_full (impl->presentation_feedbacks, (GDestroyNotify) presentation_feedback_free);
+  impl->presentation_feedbacks = NULL;
+}
+
+/* Returns the refresh rate, in milli-hertz, that the compositor
+ * most likely paces our frame callbacks with. That is the output
+ * that the last frame was presented on, if we know it. Otherwise,
+ * surfaces spanning multiple outputs are usually repainted along
+ * with the fastest one, so don't let a slow output throttle us.
+ */
+static int
+get_refresh_rate (GdkWaylandSurface *impl)
+{
+  GdkWaylandDisplay *display_wayland =
+    GDK_WAYLAND_DISPLAY (gdk_surface_get_display (GDK_SURFACE (impl)));
+  GSList *l;
+  int refresh_rate = 0;
+
+  if (impl->display_server.presentation_output)
+    {
+      refresh_rate = gdk_wayland_display_get_output_refresh_rate (display_wayland,
+                                                                  impl->display_server.presentation_output);
+      if (refresh_rate != 0)
+        return refresh_rate;
+    }
+
+  for (l = impl->display_server.outputs; l; l = l->next)
+    refresh_rate = MAX (refresh_rate,
+                        gdk_wayland_display_get_output_refresh_rate (display_wayland, l->data));
+
+  return refresh_rate;
+}
+
 static void
 frame_callback (void               *data,
                 struct wl_callback *callback,
@@ -269,6 +440,7 @@ frame_callback (void               *data,
     GDK_WAYLAND_DISPLAY (gdk_surface_get_display (surface));
   GdkFrameClock *clock = gdk_surface_get_frame_clock (surface);
   GdkFrameTimings *timings;
+  int refresh_rate;
 
   gdk_profiler_add_mark (GDK_PROFILER_CURRENT_TIME, 0, "wayland", "frame event");
   GDK_DISPLAY_DEBUG (GDK_DISPLAY (display_wayland), EVENTS, "frame %p", surface);
@@ -293,28 +465,19 @@ frame_callback (void               *data,
     return;
 
   timings->refresh_interval = 16667; /* default to 1/60th of a second */
-  if (impl->display_server.outputs)
-    {
-      /* We pick a random output out of the outputs that the surface touches
-       * The rate here is in milli-hertz */
-      int refresh_rate =
-        gdk_wayland_display_get_output_refresh_rate (display_wayland,
-                                                     impl->display_server.outputs->data);
-      if (refresh_rate != 0)
-        timings->refresh_interval = G_GINT64_CONSTANT(1000000000) / refresh_rate;
-    }
+  refresh_rate = get_refresh_rate (impl);
+  if (refresh_rate != 0)
+    timings->refresh_interval = G_GINT64_CONSTANT(1000000000) / refresh_rate;
 
   fill_presentation_time_from_frame_time (timings, time);
 
-  timings->complete = TRUE;
-
-#ifdef G_ENABLE_DEBUG
-  if ((_gdk_debug_flags & GDK_DEBUG_FRAMES) != 0)
-    _gdk_frame_clock_debug_print_timings (clock, timings);
-#endif
+  /* With presentation feedback, the timings are completed with
+   * the actual values once the frame has been presented.
+   */
+  if (find_presentation_feedback (impl, timings->frame_counter))
+    return;
 
-  if (GDK_PROFILER_IS_RUNNING)
-    _gdk_frame_clock_add_timings_to_profiler (clock, timings);
+  complete_timings (clock, timings);
 }
 
 static const struct wl_callback_listener frame_listener = {
@@ -368,6 +531,7 @@ void
 gdk_wayland_surface_request_frame (GdkSurface *surface)
 {
   GdkWaylandSurface *self = GDK_WAYLAND_SURFACE (surface);
+  GdkWaylandDisplay *display_wayland = GDK_WAYLAND_DISPLAY (gdk_surface_get_display (surface));
   GdkFrameClock *clock;
 
   if (self->frame_callback != NULL)
@@ -379,6 +543,22 @@ gdk_wayland_surface_request_frame (GdkSurface *surface)
   wl_proxy_set_queue ((struct wl_proxy *) self->frame_callback, NULL);
   wl_callback_add_listener (self->frame_callback, &frame_listener, surface);
   self->pending_frame_counter = gdk_frame_clock_get_frame_counter (clock);
+
+  if (display_wayland->presentation)
+    {
+      PresentationFeedback *feedback;
+
+      feedback = g_new (PresentationFeedback, 1);
+      feedback->surface = surface;
+      feedback->frame_counter = self->pending_frame_counter;
+      feedback->feedback = wp_presentation_feedback (display_wayland->presentation,
+                                                     self->display_server.wl_surface);
+      wl_proxy_set_queue ((struct wl_proxy *) feedback->feedback, NULL);
+      wp_presentation_feedback_add_listener (feedback->feedback,
+                                             &presentation_feedback_listener,
+                                             feedback);
+      self->presentation_feedbacks = g_list_prepend (self->presentation_feedbacks, feedback);
+    }
 }
 
 gboolean
@@ -752,6 +932,8 @@ surface_leave (void              *data,
                      "surface leave, surface %p output %p", surface, output);
 
   impl->display_server.outputs = g_slist_remove (impl->display_server.outputs, output);
+  if (impl->display_server.presentation_output == output)
+    impl->display_server.presentation_output = NULL;
 
   if (impl->display_server.outputs)
     gdk_wayland_surface_update_scale (surface);
@@ -834,6 +1016,8 @@ gdk_wayland_surface_constructed (GObject *object)
 static void
 gdk_wayland_surface_destroy_wl_surface (GdkWaylandSurface *self)
 {
+  clear_presentation_feedbacks (self);
+
   if (self->display_server.egl_window)
     {
       gdk_surface_set_egl_native_window (GDK_SURFACE (self), NULL);
@@ -846,6 +1030,7 @@ gdk_wayland_surface_destroy_wl_surface (GdkWaylandSurface *self)
   g_clear_pointer (&self->display_server.wl_surface, wl_surface_destroy);
 
   g_clear_pointer (&self->display_server.outputs, g_slist_free);
+  self->display_server.presentation_output = NULL;
 }
 
 static void
@@ -981,6 +1166,7 @@ gdk_wayland_surface_hide_surface (GdkSurface *surface)
   unmap_popups_for_surface (surface);
 
   g_clear_pointer (&impl->frame_callback, wl_callback_destroy);
+  clear_presentation_feedbacks (impl);
   if (impl->awaiting_frame_frozen)
     {
       impl->awaiting_frame_frozen = FALSE;
@@ -1230,6 +1416,7 @@ gdk_wayland_surface_class_init (GdkWaylandSurfaceClass *klass)
   surface_class->get_scale = gdk_wayland_surface_get_scale;
   surface_class->set_opaque_region = gdk_wayland_surface_set_opaque_region;
   surface_class->request_layout = gdk_wayland_surface_request_layout;
+  surface_class->create_subsurface = gdk_wayland_surface_create_subsurface;
 
   klass->handle_configure = gdk_wayland_surface_default_handle_configure;
   klass->handle_frame = gdk_wayland_surface_default_handle_frame;
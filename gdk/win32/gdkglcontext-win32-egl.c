@@ -84,15 +84,12 @@ gdk_win32_gl_context_egl_end_frame (GdkDrawContext *draw_context,
 {
   GdkGLContext *context = GDK_GL_CONTEXT (draw_context);
   GdkSurface *surface = gdk_gl_context_get_surface (context);
-  GdkDisplay *display = gdk_gl_context_get_display (context);
-  EGLSurface egl_surface;
 
+  /* This swaps the buffers, passing the painted region as damage
+   * if EGL_KHR_swap_buffers_with_damage is available
+   */
   GDK_DRAW_CONTEXT_CLASS (gdk_win32_gl_context_egl_parent_class)->end_frame (draw_context, painted);
 
-  gdk_gl_context_make_current (context);
-
-  egl_surface = gdk_surface_get_egl_surface (surface);
-
   if (is_egl_force_redraw (surface))
     {
       GdkRectangle rect = {0, 0, gdk_surface_get_width (surface), gdk_surface_get_height (surface)};
@@ -103,8 +100,6 @@ gdk_win32_gl_context_egl_end_frame (GdkDrawContext *draw_context,
       gdk_surface_invalidate_rect (surface, &rect);
       reset_egl_force_redraw (surface);
     }
-
-  eglSwapBuffers (gdk_display_get_egl_display (display), egl_surface);
 }
 
 static void
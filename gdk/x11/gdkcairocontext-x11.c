@@ -29,8 +29,223 @@
 
 #include <X11/Xlib.h>
 
+#ifdef HAVE_XSHM
+#include <X11/extensions/XShm.h>
+#include <sys/ipc.h>
+#include <sys/shm.h>
+#endif
+
+/* With MIT-SHM, we paint into an image that is shared with the
+ * X server and persists across frames, and only the damaged parts
+ * are copied to the window. That avoids both the server side
+ * rendering and the transfer of the pixels through the socket.
+ */
+#ifdef HAVE_XSHM
+struct _GdkX11ShmImage
+{
+  GdkDisplay *display;
+  XShmSegmentInfo info;
+  XImage *ximage;
+  GC gc;
+  cairo_surface_t *surface;
+  /* The server may still be reading from the image */
+  gboolean pending;
+};
+#endif
+
 G_DEFINE_TYPE (GdkX11CairoContext, gdk_x11_cairo_context, GDK_TYPE_CAIRO_CONTEXT)
 
+#ifdef HAVE_XSHM
+static void
+gdk_x11_shm_image_free (GdkX11ShmImage *image)
+{
+  Display *xdisplay = gdk_x11_display_get_xdisplay (image->display);
+
+  if (image->pending)
+    XSync (xdisplay, False);
+
+  cairo_surface_finish (image->surface);
+  cairo_surface_destroy (image->surface);
+  XFreeGC (xdisplay, image->gc);
+  XShmDetach (xdisplay, &image->info);
+  XDestroyImage (image->ximage);
+  shmdt (image->info.shmaddr);
+
+  g_free (image);
+}
+
+static cairo_format_t
+get_shm_format (GdkX11Display *display_x11)
+{
+  Visual *visual = gdk_x11_display_get_window_visual (display_x11);
+
+  if (visual->class != TrueColor ||
+      visual->red_mask != 0xff0000 ||
+      visual->green_mask != 0xff00 ||
+      visual->blue_mask != 0xff)
+    return CAIRO_FORMAT_INVALID;
+
+  switch (gdk_x11_display_get_window_depth (display_x11))
+    {
+    case 24:
+      return CAIRO_FORMAT_RGB24;
+    case 32:
+      return CAIRO_FORMAT_ARGB32;
+    default:
+      return CAIRO_FORMAT_INVALID;
+    }
+}
+
+static GdkX11ShmImage *
+gdk_x11_shm_image_new (GdkSurface *surface,
+                       int         width,
+                       int         height)
+{
+  GdkDisplay *display = gdk_surface_get_display (surface);
+  GdkX11Display *display_x11 = GDK_X11_DISPLAY (display);
+  Display *xdisplay = gdk_x11_display_get_xdisplay (display);
+  GdkX11ShmImage *image;
+  cairo_format_t format;
+  int error;
+
+  if (!XShmQueryExtension (xdisplay))
+    return NULL;
+
+  format = get_shm_format (display_x11);
+  if (format == CAIRO_FORMAT_INVALID)
+    return NULL;
+
+  image = g_new0 (GdkX11ShmImage, 1);
+  image->display = display;
+  image->ximage = XShmCreateImage (xdisplay,
+                                   gdk_x11_display_get_window_visual (display_x11),
+                                   gdk_x11_display_get_window_depth (display_x11),
+                                   ZPixmap, NULL, &image->info,
+                                   width, height);
+  if (image->ximage == NULL)
+    goto fail;
+
+  /* cairo wants native endian 32bit pixels */
+  if (image->ximage->bits_per_pixel != 32 ||
+      image->ximage->byte_order != (G_BYTE_ORDER == G_LITTLE_ENDIAN ? LSBFirst : MSBFirst))
+    goto fail_image;
+
+  image->info.shmid = shmget (IPC_PRIVATE, image->ximage->bytes_per_line * height, IPC_CREAT | 0600);
+  if (image->info.shmid < 0)
+    goto fail_image;
+
+  image->info.shmaddr = image->ximage->data = shmat (image->info.shmid, NULL, 0);
+  image->info.readOnly = False;
+  if (image->info.shmaddr == (char *) -1)
+    {
+      shmctl (image->info.shmid, IPC_RMID, NULL);
+      goto fail_image;
+    }
+
+  /* Attaching fails for remote servers */
+  gdk_x11_display_error_trap_push (display);
+  XShmAttach (xdisplay, &image->info);
+  XSync (xdisplay, False);
+  error = gdk_x11_display_error_trap_pop (display);
+
+  /* The segment goes away once both sides have detached */
+  shmctl (image->info.shmid, IPC_RMID, NULL);
+
+  if (error)
+    {
+      shmdt (image->info.shmaddr);
+      goto fail_image;
+    }
+
+  image->gc = XCreateGC (xdisplay, GDK_SURFACE_XID (surface), 0, NULL);
+  image->surface = cairo_image_surface_create_for_data ((guchar *) image->ximage->data,
+                                                        format,
+                                                        width, height,
+                                                        image->ximage->bytes_per_line);
+
+  return image;
+
+fail_image:
+  XDestroyImage (image->ximage);
+fail:
+  g_free (image);
+  return NULL;
+}
+
+static gboolean
+gdk_x11_cairo_context_ensure_shm_image (GdkX11CairoContext *self,
+                                        GdkSurface         *surface)
+{
+  int scale, width, height;
+
+  if (self->shm_failed)
+    return FALSE;
+
+  scale = gdk_surface_get_scale_factor (surface);
+  width = MAX (gdk_surface_get_width (surface) * scale, 1);
+  height = MAX (gdk_surface_get_height (surface) * scale, 1);
+
+  if (self->shm_image &&
+      (cairo_image_surface_get_width (self->shm_image->surface) != width ||
+       cairo_image_surface_get_height (self->shm_image->surface) != height))
+    g_clear_pointer (&self->shm_image, gdk_x11_shm_image_free);
+
+  if (self->shm_image == NULL)
+    {
+      self->shm_image = gdk_x11_shm_image_new (surface, width, height);
+      if (self->shm_image == NULL)
+        {
+          GDK_DISPLAY_DEBUG (gdk_surface_get_display (surface), MISC,
+                             "MIT-SHM not available, using Xlib surfaces");
+          self->shm_failed = TRUE;
+          return FALSE;
+        }
+    }
+
+  if (self->shm_image->pending)
+    {
+      XSync (gdk_x11_display_get_xdisplay (gdk_surface_get_display (surface)), False);
+      self->shm_image->pending = FALSE;
+    }
+
+  cairo_surface_set_device_scale (self->shm_image->surface, scale, scale);
+
+  return TRUE;
+}
+
+static void
+gdk_x11_cairo_context_put_shm_image (GdkX11CairoContext *self,
+                                     GdkSurface         *surface,
+                                     cairo_region_t     *painted)
+{
+  Display *xdisplay = gdk_x11_display_get_xdisplay (gdk_surface_get_display (surface));
+  int i, n_rects, scale;
+
+  cairo_surface_flush (self->shm_image->surface);
+
+  /* The painted region is in application pixels */
+  scale = gdk_surface_get_scale_factor (surface);
+  n_rects = cairo_region_num_rectangles (painted);
+  for (i = 0; i < n_rects; i++)
+    {
+      cairo_rectangle_int_t rect;
+
+      cairo_region_get_rectangle (painted, i, &rect);
+      XShmPutImage (xdisplay,
+                    GDK_SURFACE_XID (surface),
+                    self->shm_image->gc,
+                    self->shm_image->ximage,
+                    rect.x * scale, rect.y * scale,
+                    rect.x * scale, rect.y * scale,
+                    rect.width * scale, rect.height * scale,
+                    False);
+    }
+  XFlush (xdisplay);
+
+  self->shm_image->pending = TRUE;
+}
+#endif
+
 static cairo_surface_t *
 create_cairo_surface_for_surface (GdkSurface *surface)
 {
@@ -64,6 +279,24 @@ gdk_x11_cairo_context_begin_frame (GdkDrawContext *draw_context,
   double sx, sy;
 
   surface = gdk_draw_context_get_surface (draw_context);
+
+#ifdef HAVE_XSHM
+  if (gdk_x11_cairo_context_ensure_shm_image (self, surface))
+    {
+      cairo_t *cr;
+
+      self->paint_surface = cairo_surface_reference (self->shm_image->surface);
+
+      /* clear the repaint area, the image keeps the previous frame */
+      cr = cairo_create (self->paint_surface);
+      cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+      gdk_cairo_region (cr, region);
+      cairo_fill (cr);
+      cairo_destroy (cr);
+      return;
+    }
+#endif
+
   cairo_region_get_extents (region, &clip_box);
 
   self->window_surface = create_cairo_surface_for_surface (surface);
@@ -87,6 +320,17 @@ gdk_x11_cairo_context_end_frame (GdkDrawContext *draw_context,
   GdkX11CairoContext *self = GDK_X11_CAIRO_CONTEXT (draw_context);
   cairo_t *cr;
 
+#ifdef HAVE_XSHM
+  if (self->shm_image)
+    {
+      gdk_x11_cairo_context_put_shm_image (self,
+                                           gdk_draw_context_get_surface (draw_context),
+                                           painted);
+      g_clear_pointer (&self->paint_surface, cairo_surface_destroy);
+      return;
+    }
+#endif
+
   cr = cairo_create (self->window_surface);
 
   cairo_set_source_surface (cr, self->paint_surface, 0, 0);
@@ -112,12 +356,27 @@ gdk_x11_cairo_context_cairo_create (GdkCairoContext *context)
   return cairo_create (self->paint_surface);
 }
 
+static void
+gdk_x11_cairo_context_dispose (GObject *object)
+{
+#ifdef HAVE_XSHM
+  GdkX11CairoContext *self = GDK_X11_CAIRO_CONTEXT (object);
+
+  g_clear_pointer (&self->shm_image, gdk_x11_shm_image_free);
+#endif
+
+  G_OBJECT_CLASS (gdk_x11_cairo_context_parent_class)->dispose (object);
+}
+
 static void
 gdk_x11_cairo_context_class_init (GdkX11CairoContextClass *klass)
 {
+  GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
   GdkDrawContextClass *draw_context_class = GDK_DRAW_CONTEXT_CLASS (klass);
   GdkCairoContextClass *cairo_context_class = GDK_CAIRO_CONTEXT_CLASS (klass);
 
+  gobject_class->dispose = gdk_x11_cairo_context_dispose;
+
   draw_context_class->begin_frame = gdk_x11_cairo_context_begin_frame;
   draw_context_class->end_frame = gdk_x11_cairo_context_end_frame;
 
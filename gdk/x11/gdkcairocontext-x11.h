@@ -35,6 +35,7 @@ G_BEGIN_DECLS
 
 typedef struct _GdkX11CairoContext GdkX11CairoContext;
 typedef struct _GdkX11CairoContextClass GdkX11CairoContextClass;
+typedef struct _GdkX11ShmImage GdkX11ShmImage;
 
 struct _GdkX11CairoContext
 {
@@ -42,6 +43,9 @@ struct _GdkX11CairoContext
 
   cairo_surface_t *window_surface;
   cairo_surface_t *paint_surface;
+
+  GdkX11ShmImage *shm_image;
+  guint shm_failed : 1;
 };
 
 struct _GdkX11CairoContextClass
@@ -124,8 +124,16 @@ struct _GdkEventTypeX11
 /* Note that we never *directly* use WM_LOCALE_NAME, WM_PROTOCOLS,
  * but including them here has the side-effect of getting them
  * into the internal Xlib cache
+ *
+ * Every atom that is needed until the first window is shown should
+ * be listed here, each one that is missing costs a round trip.
  */
 static const char *const precache_atoms[] = {
+  "CLIPBOARD",
+  "CLIPBOARD_MANAGER",
+  "MANAGER",
+  "SAVE_TARGETS",
+  "SM_CLIENT_ID",
   "UTF8_STRING",
   "WM_CLIENT_LEADER",
   "WM_DELETE_WINDOW",
@@ -140,7 +148,6 @@ static const char *const precache_atoms[] = {
   "_NET_CURRENT_DESKTOP",
   "_NET_FRAME_EXTENTS",
   "_NET_STARTUP_ID",
-  "_NET_WM_CM_S0",
   "_NET_WM_DESKTOP",
   "_NET_WM_ICON",
   "_NET_WM_ICON_NAME",
@@ -160,6 +167,10 @@ static const char *const precache_atoms[] = {
   "_NET_WM_STATE_STICKY",
   "_NET_WM_SYNC_REQUEST",
   "_NET_WM_SYNC_REQUEST_COUNTER",
+  "_NET_WM_FRAME_DRAWN",
+  "_NET_WM_FRAME_TIMINGS",
+  "_NET_WM_MOVERESIZE",
+  "_NET_WM_OPAQUE_REGION",
   "_NET_WM_WINDOW_TYPE",
   "_NET_WM_WINDOW_TYPE_COMBO",
   "_NET_WM_WINDOW_TYPE_DIALOG",
@@ -173,6 +184,15 @@ static const char *const precache_atoms[] = {
   "_NET_WM_USER_TIME",
   "_NET_WM_USER_TIME_WINDOW",
   "_NET_VIRTUAL_ROOTS",
+  "_NET_SUPPORTED",
+  "_NET_SUPPORTING_WM_CHECK",
+  "_NET_WORKAREA",
+  "_GTK_EDGE_CONSTRAINTS",
+  "_GTK_FRAME_EXTENTS",
+  "_GTK_SHOW_WINDOW_MENU",
+  "_GTK_WORKAREAS",
+  "_MOTIF_WM_HINTS",
+  "_XSETTINGS_SETTINGS",
   "GDK_SELECTION",
   "_NET_WM_STATE_FOCUSED",
   "GDK_VISUALS",
@@ -1382,6 +1402,29 @@ gdk_x11_display_query_default_visual (GdkX11Display  *self,
   *out_depth = DefaultDepth (dpy, self->screen->screen_num);
 }
 
+static void
+precache_display_atoms (GdkDisplay *display)
+{
+  const char *atom_names[G_N_ELEMENTS (precache_atoms) + 2];
+  int screen_num = DefaultScreen (GDK_DISPLAY_XDISPLAY (display));
+  char *cm_name, *xsettings_name;
+  int n_atoms;
+
+  /* The per-screen selections go into the same request */
+  cm_name = g_strdup_printf ("_NET_WM_CM_S%d", screen_num);
+  xsettings_name = g_strdup_printf ("_XSETTINGS_S%d", screen_num);
+
+  memcpy (atom_names, precache_atoms, sizeof (precache_atoms));
+  n_atoms = G_N_ELEMENTS (precache_atoms);
+  atom_names[n_atoms++] = cm_name;
+  atom_names[n_atoms++] = xsettings_name;
+
+  _gdk_x11_precache_atoms (display, atom_names, n_atoms);
+
+  g_free (cm_name);
+  g_free (xsettings_name);
+}
+
 static void
 gdk_x11_display_init_leader_surface (GdkX11Display *self)
 {
@@ -1448,7 +1491,7 @@ gdk_x11_display_open (const char *display_name)
   /* Set up handlers for Xlib internal connections */
   XAddConnectionWatch (xdisplay, gdk_internal_connection_watch, NULL);
 
-  _gdk_x11_precache_atoms (display, precache_atoms, G_N_ELEMENTS (precache_atoms));
+  precache_display_atoms (display);
 
   /* RandR must be initialized before we initialize the screens */
   display_x11->have_randr12 = FALSE;
@@ -150,6 +150,7 @@ struct _GdkX11Display
   guint has_glx_texture_from_pixmap : 1;
   guint has_glx_video_sync : 1;
   guint has_glx_buffer_age : 1;
+  guint has_glx_copy_sub_buffer : 1;
   guint has_glx_sync_control : 1;
   guint has_glx_multisample : 1;
   guint has_glx_visual_rating : 1;
@@ -27,6 +27,8 @@
 
 #include <cairo-xlib.h>
 
+#include <math.h>
+
 #include <epoxy/glx.h>
 
 struct _GdkX11GLContextGLX
@@ -40,6 +42,13 @@ struct _GdkX11GLContextGLX
   Damage xdamage;
 #endif
 
+  /* Size of the surface when the last frame was presented with
+   * glXCopySubBufferMESA(), which leaves the back buffer intact,
+   * or 0x0 if the back buffer contents are undefined.
+   */
+  int copied_width;
+  int copied_height;
+
   guint do_frame_sync : 1;
 };
 
@@ -118,6 +127,38 @@ gdk_x11_gl_context_glx_get_drawable (GdkX11GLContextGLX *self)
   return gdk_x11_surface_get_glx_drawable (surface);
 }
 
+/* Without GLX_EXT_buffer_age every frame has to repaint the whole
+ * surface, because the back buffer is undefined after a swap. When
+ * only part of the surface changed, we can instead copy that part to
+ * the front buffer and keep the back buffer, so that the next frame
+ * only needs to repaint what changed.
+ *
+ * We don't do this when the driver syncs swaps to the vblank, as the
+ * copy is not synchronized and would tear.
+ */
+static gboolean
+gdk_x11_gl_context_glx_can_copy_sub_buffer (GdkX11GLContextGLX   *self,
+                                            const cairo_region_t *painted)
+{
+  GdkDrawContext *draw_context = GDK_DRAW_CONTEXT (self);
+  GdkX11Display *display_x11 = GDK_X11_DISPLAY (gdk_draw_context_get_display (draw_context));
+  GdkSurface *surface = gdk_draw_context_get_surface (draw_context);
+
+  if (!display_x11->has_glx_copy_sub_buffer || display_x11->has_glx_buffer_age)
+    return FALSE;
+
+  if (self->do_frame_sync &&
+      (display_x11->has_glx_sgi_swap_control || display_x11->has_glx_swap_control))
+    return FALSE;
+
+  return cairo_region_contains_rectangle (painted,
+                                          &(cairo_rectangle_int_t) {
+                                              0, 0,
+                                              gdk_surface_get_width (surface),
+                                              gdk_surface_get_height (surface)
+                                          }) != CAIRO_REGION_OVERLAP_IN;
+}
+
 static void
 gdk_x11_gl_context_glx_end_frame (GdkDrawContext *draw_context,
                                   cairo_region_t *painted)
@@ -194,7 +235,36 @@ gdk_x11_gl_context_glx_end_frame (GdkDrawContext *draw_context,
     }
 #endif
 
-  glXSwapBuffers (dpy, drawable);
+  if (gdk_x11_gl_context_glx_can_copy_sub_buffer (self, painted))
+    {
+      double scale = gdk_gl_context_get_scale (context);
+      int surface_height = gdk_surface_get_height (surface);
+      int i, n_rects;
+
+      n_rects = cairo_region_num_rectangles (painted);
+      for (i = 0; i < n_rects; i++)
+        {
+          cairo_rectangle_int_t rect;
+          int x0, y0, x1, y1;
+
+          cairo_region_get_rectangle (painted, i, &rect);
+          x0 = (int) floor (rect.x * scale);
+          y0 = (int) floor ((surface_height - rect.height - rect.y) * scale);
+          x1 = (int) ceil ((rect.x + rect.width) * scale);
+          y1 = (int) ceil ((surface_height - rect.y) * scale);
+          glXCopySubBufferMESA (dpy, drawable, x0, y0, x1 - x0, y1 - y0);
+        }
+
+      self->copied_width = gdk_surface_get_width (surface);
+      self->copied_height = surface_height;
+    }
+  else
+    {
+      glXSwapBuffers (dpy, drawable);
+
+      self->copied_width = 0;
+      self->copied_height = 0;
+    }
 
   if (self->do_frame_sync && display_x11->has_glx_video_sync)
     glXGetVideoSyncSGI (&x11_surface->glx_frame_counter);
@@ -324,6 +394,17 @@ gdk_x11_gl_context_glx_get_damage (GdkGLContext *context)
           return damage;
         }
     }
+  else if (display_x11->has_glx_copy_sub_buffer)
+    {
+      GdkX11GLContextGLX *self = GDK_X11_GL_CONTEXT_GLX (context);
+      GdkSurface *surface = gdk_draw_context_get_surface (GDK_DRAW_CONTEXT (context));
+
+      /* The back buffer still holds the last frame */
+      if (self->copied_width == gdk_surface_get_width (surface) &&
+          self->copied_height == gdk_surface_get_height (surface) &&
+          self->copied_width > 0 && self->copied_height > 0)
+        return cairo_region_create ();
+    }
 
   return GDK_GL_CONTEXT_CLASS (gdk_x11_gl_context_glx_parent_class)->get_damage (context);
 }
@@ -976,6 +1057,8 @@ gdk_x11_display_init_glx (GdkX11Display  *display_x11,
     epoxy_has_glx_extension (dpy, screen_num, "GLX_SGI_video_sync");
   display_x11->has_glx_buffer_age =
     epoxy_has_glx_extension (dpy, screen_num, "GLX_EXT_buffer_age");
+  display_x11->has_glx_copy_sub_buffer =
+    epoxy_has_glx_extension (dpy, screen_num, "GLX_MESA_copy_sub_buffer");
   display_x11->has_glx_sync_control =
     epoxy_has_glx_extension (dpy, screen_num, "GLX_OML_sync_control");
   display_x11->has_glx_multisample =
@@ -1034,6 +1117,7 @@ gdk_x11_display_init_glx (GdkX11Display  *display_x11,
                        "\t* GLX_EXT_texture_from_pixmap: %s\n"
                        "\t* GLX_SGI_video_sync: %s\n"
                        "\t* GLX_EXT_buffer_age: %s\n"
+                       "\t* GLX_MESA_copy_sub_buffer: %s\n"
                        "\t* GLX_OML_sync_control: %s\n"
                        "\t* GLX_ARB_multisample: %s\n"
                        "\t* GLX_EXT_visual_rating: %s",
@@ -1047,6 +1131,7 @@ gdk_x11_display_init_glx (GdkX11Display  *display_x11,
                      display_x11->has_glx_texture_from_pixmap ? "yes" : "no",
                      display_x11->has_glx_video_sync ? "yes" : "no",
                      display_x11->has_glx_buffer_age ? "yes" : "no",
+                     display_x11->has_glx_copy_sub_buffer ? "yes" : "no",
                      display_x11->has_glx_sync_control ? "yes" : "no",
                      display_x11->has_glx_multisample ? "yes" : "no",
                      display_x11->has_glx_visual_rating ? "yes" : "no");
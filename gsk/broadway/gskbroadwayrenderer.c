@@ -20,10 +20,14 @@ struct _GskBroadwayRenderer
   GArray *nodes;              /* Owned by draw_contex */
   GPtrArray *node_textures;   /* Owned by draw_contex */
   GHashTable *node_lookup;
+  GHashTable *fallback_textures;
 
   /* Kept from last frame */
   GHashTable *last_node_lookup;
   GskRenderNode *last_root; /* Owning refs to the things in last_node_lookup */
+  /* Fallback textures by content hash, so nodes that were recreated
+   * with the same content don't need to be rendered and uploaded again */
+  GHashTable *last_fallback_textures;
 };
 
 struct _GskBroadwayRendererClass
@@ -869,31 +873,57 @@ gsk_broadway_renderer_add_node (GskRenderer *renderer,
 
   if (add_new_node (renderer, node, BROADWAY_NODE_TEXTURE, clip_bounds))
     {
-      GdkTexture *texture;
-      cairo_surface_t *surface;
-      cairo_t *cr;
+      GdkTexture *texture = NULL;
       guint32 texture_id;
       int x = floorf (node->bounds.origin.x);
       int y = floorf (node->bounds.origin.y);
       int width = ceil (node->bounds.origin.x + node->bounds.size.width) - x;
       int height = ceil (node->bounds.origin.y + node->bounds.size.height) - y;
       int scale = broadway_display->scale_factor;
+      guint64 hash;
+
+      hash = gsk_render_node_get_hash (node);
+      if (hash != 0)
+        {
+          hash = gsk_hash_value (hash, scale);
+
+          texture = g_hash_table_lookup (self->fallback_textures, &hash);
+          if (texture == NULL && self->last_fallback_textures)
+            texture = g_hash_table_lookup (self->last_fallback_textures, &hash);
+        }
+
+      if (texture)
+        {
+          g_object_ref (texture);
+        }
+      else
+        {
+          cairo_surface_t *surface;
+          cairo_t *cr;
 
 #define MAX_IMAGE_SIZE 32767
 
-      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
-                                            MIN (width * scale, MAX_IMAGE_SIZE),
-                                            MIN (height * scale, MAX_IMAGE_SIZE));
+          surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                                MIN (width * scale, MAX_IMAGE_SIZE),
+                                                MIN (height * scale, MAX_IMAGE_SIZE));
 
 #undef MAX_IMAGE_SIZE
 
-      cr = cairo_create (surface);
-      cairo_scale (cr, scale, scale);
-      cairo_translate (cr, -x, -y);
-      gsk_render_node_draw (node, cr);
-      cairo_destroy (cr);
+          cr = cairo_create (surface);
+          cairo_scale (cr, scale, scale);
+          cairo_translate (cr, -x, -y);
+          gsk_render_node_draw (node, cr);
+          cairo_destroy (cr);
+
+          texture = gdk_texture_new_for_surface (surface);
+          cairo_surface_destroy (surface);
+        }
+
+      if (hash != 0 && !g_hash_table_contains (self->fallback_textures, &hash))
+        g_hash_table_insert (self->fallback_textures,
+                             g_memdup2 (&hash, sizeof (hash)),
+                             g_object_ref (texture));
 
-      texture = gdk_texture_new_for_surface (surface);
       g_ptr_array_add (self->node_textures, texture); /* Transfers ownership to node_textures */
 
       texture_id = gdk_broadway_display_ensure_texture (display, texture);
@@ -913,6 +943,8 @@ gsk_broadway_renderer_render (GskRenderer          *renderer,
   GskBroadwayRenderer *self = GSK_BROADWAY_RENDERER (renderer);
 
   self->node_lookup = g_hash_table_new (g_direct_hash, g_direct_equal);
+  self->fallback_textures = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+                                                   g_free, g_object_unref);
 
   gdk_draw_context_begin_frame (GDK_DRAW_CONTEXT (self->draw_context), update_area);
 
@@ -937,6 +969,11 @@ gsk_broadway_renderer_render (GskRenderer          *renderer,
     gsk_render_node_unref (self->last_root);
   self->last_root = gsk_render_node_ref (root);
 
+  if (self->last_fallback_textures)
+    g_hash_table_unref (self->last_fallback_textures);
+  self->last_fallback_textures = self->fallback_textures;
+  self->fallback_textures = NULL;
+
   if (self->next_node_id > G_MAXUINT32 / 2)
     {
       /* We're "near" a wrap of the ids, lets avoid reusing any of
@@ -948,11 +985,26 @@ gsk_broadway_renderer_render (GskRenderer          *renderer,
     }
 }
 
+static void
+gsk_broadway_renderer_finalize (GObject *object)
+{
+  GskBroadwayRenderer *self = GSK_BROADWAY_RENDERER (object);
+
+  g_clear_pointer (&self->last_node_lookup, g_hash_table_unref);
+  g_clear_pointer (&self->last_root, gsk_render_node_unref);
+  g_clear_pointer (&self->last_fallback_textures, g_hash_table_unref);
+
+  G_OBJECT_CLASS (gsk_broadway_renderer_parent_class)->finalize (object);
+}
+
 static void
 gsk_broadway_renderer_class_init (GskBroadwayRendererClass *klass)
 {
+  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GskRendererClass *renderer_class = GSK_RENDERER_CLASS (klass);
 
+  object_class->finalize = gsk_broadway_renderer_finalize;
+
   renderer_class->realize = gsk_broadway_renderer_realize;
   renderer_class->unrealize = gsk_broadway_renderer_unrealize;
   renderer_class->render = gsk_broadway_renderer_render;
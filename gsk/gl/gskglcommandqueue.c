@@ -25,6 +25,7 @@
 
 #include <string.h>
 
+#include <gdk/gdkcompressedtextureprivate.h>
 #include <gdk/gdkglcontextprivate.h>
 #include <gdk/gdkmemoryformatprivate.h>
 #include <gdk/gdkprofilerprivate.h>
@@ -166,7 +167,7 @@ gsk_gl_command_queue_print_batch (GskGLCommandQueue       *self,
   if (batch->any.kind == GSK_GL_COMMAND_KIND_DRAW)
     {
       g_printerr ("      Program: %d\n", batch->any.program);
-      g_printerr ("     Vertices: %d\n", batch->draw.vbo_count);
+      g_printerr ("    %s: %d\n", batch->any.instanced ? "Instances" : " Vertices", batch->draw.vbo_count);
 
       for (guint i = 0; i < batch->draw.bind_count; i++)
         {
@@ -429,9 +430,21 @@ gsk_gl_command_queue_dispose (GObject *object)
   gsk_gl_command_batches_clear (&self->batches);
   gsk_gl_command_binds_clear (&self->batch_binds);
   gsk_gl_command_uniforms_clear (&self->batch_uniforms);
+  gsk_gl_command_bounds_array_clear (&self->batch_bounds);
   gsk_gl_syncs_clear (&self->syncs);
 
+  for (guint i = 0; i < G_N_ELEMENTS (self->upload_buffers); i++)
+    {
+      GskGLUploadBuffer *buffer = &self->upload_buffers[i];
+
+      if (buffer->fence != NULL)
+        glDeleteSync (buffer->fence);
+      if (buffer->id != 0)
+        glDeleteBuffers (1, &buffer->id);
+    }
+
   gsk_gl_buffer_destroy (&self->vertices);
+  gsk_gl_buffer_destroy (&self->instances);
 
   G_OBJECT_CLASS (gsk_gl_command_queue_parent_class)->dispose (object);
 }
@@ -452,9 +465,11 @@ gsk_gl_command_queue_init (GskGLCommandQueue *self)
   gsk_gl_command_batches_init (&self->batches, 128);
   gsk_gl_command_binds_init (&self->batch_binds, 1024);
   gsk_gl_command_uniforms_init (&self->batch_uniforms, 2048);
+  gsk_gl_command_bounds_array_init (&self->batch_bounds, 128);
   gsk_gl_syncs_init (&self->syncs, 10);
 
   gsk_gl_buffer_init (&self->vertices, GL_ARRAY_BUFFER, sizeof (GskGLDrawVertex));
+  gsk_gl_buffer_init (&self->instances, GL_ARRAY_BUFFER, sizeof (GskGLDrawInstance));
 }
 
 GskGLCommandQueue *
@@ -497,6 +512,14 @@ gsk_gl_command_queue_new (GdkGLContext      *context,
 
   self->has_samplers = gdk_gl_context_check_version (context, "3.3", "3.0");
 
+  /* Instanced programs need glVertexAttribDivisor() and gl_VertexID */
+  self->has_instancing = gdk_gl_context_check_version (context, "3.3", "3.0") &&
+                         !gdk_gl_context_is_legacy (context);
+
+  /* Staging uploads needs glMapBufferRange() and fences */
+  self->has_upload_buffers = gdk_gl_context_check_version (context, "3.0", "3.0") &&
+                             gdk_gl_context_has_sync (context);
+
   /* create the samplers */
   if (self->has_samplers)
     {
@@ -537,6 +560,10 @@ begin_next_batch (GskGLCommandQueue *self)
   batch->any.next_batch_index = -1;
   batch->any.prev_batch_index = self->tail_batch_index;
 
+  *gsk_gl_command_bounds_array_append (&self->batch_bounds) = (GskGLCommandBounds) {
+    G_MAXFLOAT, G_MAXFLOAT, -G_MAXFLOAT, -G_MAXFLOAT, 0
+  };
+
   return batch;
 }
 
@@ -577,6 +604,7 @@ discard_batch (GskGLCommandQueue *self)
   g_assert (self->batches.len > 0);
 
   self->batches.len--;
+  self->batch_bounds.len--;
 }
 
 gboolean
@@ -602,6 +630,7 @@ gsk_gl_command_queue_begin_draw (GskGLCommandQueue   *self,
 
   batch = begin_next_batch (self);
   batch->any.kind = GSK_GL_COMMAND_KIND_DRAW;
+  batch->any.instanced = program->instanced;
   batch->any.program = program->program_id;
   batch->any.next_batch_index = -1;
   batch->any.viewport.width = width;
@@ -612,7 +641,10 @@ gsk_gl_command_queue_begin_draw (GskGLCommandQueue   *self,
   batch->draw.bind_count = 0;
   batch->draw.bind_offset = self->batch_binds.len;
   batch->draw.vbo_count = 0;
-  batch->draw.vbo_offset = gsk_gl_buffer_get_offset (&self->vertices);
+  if (program->instanced)
+    batch->draw.vbo_offset = gsk_gl_buffer_get_offset (&self->instances);
+  else
+    batch->draw.vbo_offset = gsk_gl_buffer_get_offset (&self->vertices);
 
   self->fbo_max = MAX (self->fbo_max, batch->draw.framebuffer);
 
@@ -687,7 +719,17 @@ gsk_gl_command_queue_end_draw (GskGLCommandQueue *self)
       last_batch->draw.vbo_count + batch->draw.vbo_count <= 0xffff &&
       snapshots_equal (self, last_batch, batch))
     {
+      const GskGLCommandBounds *bounds = gsk_gl_command_bounds_array_tail (&self->batch_bounds);
+      GskGLCommandBounds *last_bounds = &self->batch_bounds.items[self->batch_bounds.len - 2];
+
       last_batch->draw.vbo_count += batch->draw.vbo_count;
+
+      last_bounds->x1 = MIN (last_bounds->x1, bounds->x1);
+      last_bounds->y1 = MIN (last_bounds->y1, bounds->y1);
+      last_bounds->x2 = MAX (last_bounds->x2, bounds->x2);
+      last_bounds->y2 = MAX (last_bounds->y2, bounds->y2);
+      last_bounds->count += bounds->count;
+
       discard_batch (self);
     }
   else
@@ -760,6 +802,7 @@ gsk_gl_command_queue_clear (GskGLCommandQueue     *self,
 
   batch = begin_next_batch (self);
   batch->any.kind = GSK_GL_COMMAND_KIND_CLEAR;
+  batch->any.instanced = FALSE;
   batch->any.viewport.width = viewport->size.width;
   batch->any.viewport.height = viewport->size.height;
   batch->clear.bits = clear_bits;
@@ -999,6 +1042,143 @@ gsk_gl_command_queue_sort_batches (GskGLCommandQueue *self)
   g_free (seen_free);
 }
 
+/* How many batches a batch may move across to be merged with an
+ * earlier one, to keep the cost of the search bounded.
+ */
+#define MAX_REORDER_DISTANCE 32
+
+static inline gboolean
+batch_is_bounded (GskGLCommandQueue *self,
+                  int                index)
+{
+  const GskGLCommandBatch *batch = &self->batches.items[index];
+  const GskGLCommandBounds *bounds = &self->batch_bounds.items[index];
+
+  return batch->any.kind == GSK_GL_COMMAND_KIND_DRAW &&
+         bounds->count > 0 &&
+         bounds->count == batch->draw.vbo_count;
+}
+
+static inline gboolean
+bounds_intersect (const GskGLCommandBounds *a,
+                  const GskGLCommandBounds *b)
+{
+  return a->x1 < b->x2 && b->x1 < a->x2 &&
+         a->y1 < b->y2 && b->y1 < a->y2;
+}
+
+static inline gboolean
+batches_can_merge (GskGLCommandQueue *self,
+                   GskGLCommandBatch *first,
+                   GskGLCommandBatch *second)
+{
+  return first->any.kind == GSK_GL_COMMAND_KIND_DRAW &&
+         first->any.program == second->any.program &&
+         first->any.viewport.width == second->any.viewport.width &&
+         first->any.viewport.height == second->any.viewport.height &&
+         first->draw.framebuffer == second->draw.framebuffer &&
+         first->draw.vbo_count + second->draw.vbo_count <= 0xffff &&
+         snapshots_equal (self, first, second);
+}
+
+/* Appends the vertices (or instances) of @second to those of @first,
+ * copying them to the end of the buffer if they are not adjacent, and
+ * removes @second from the list of batches.
+ */
+static void
+gsk_gl_command_queue_merge_batches (GskGLCommandQueue *self,
+                                    GskGLCommandBatch *first,
+                                    GskGLCommandBatch *second)
+{
+  GskGLBuffer *buffer = first->any.instanced ? &self->instances : &self->vertices;
+  GskGLCommandBounds *first_bounds;
+  GskGLCommandBounds *second_bounds;
+  guint8 *dest;
+
+  if (first->draw.vbo_offset + first->draw.vbo_count != second->draw.vbo_offset)
+    {
+      if (first->draw.vbo_offset + first->draw.vbo_count != buffer->count)
+        {
+          dest = gsk_gl_buffer_advance (buffer, first->draw.vbo_count);
+          memcpy (dest,
+                  buffer->buffer + first->draw.vbo_offset * buffer->element_size,
+                  first->draw.vbo_count * buffer->element_size);
+          first->draw.vbo_offset = buffer->count - first->draw.vbo_count;
+        }
+
+      dest = gsk_gl_buffer_advance (buffer, second->draw.vbo_count);
+      memcpy (dest,
+              buffer->buffer + second->draw.vbo_offset * buffer->element_size,
+              second->draw.vbo_count * buffer->element_size);
+    }
+
+  first->draw.vbo_count += second->draw.vbo_count;
+
+  first_bounds = &self->batch_bounds.items[gsk_gl_command_batches_index_of (&self->batches, first)];
+  second_bounds = &self->batch_bounds.items[gsk_gl_command_batches_index_of (&self->batches, second)];
+  first_bounds->x1 = MIN (first_bounds->x1, second_bounds->x1);
+  first_bounds->y1 = MIN (first_bounds->y1, second_bounds->y1);
+  first_bounds->x2 = MAX (first_bounds->x2, second_bounds->x2);
+  first_bounds->y2 = MAX (first_bounds->y2, second_bounds->y2);
+  first_bounds->count += second_bounds->count;
+
+  gsk_gl_command_queue_unlink (self, second);
+}
+
+/* Merges draws into earlier compatible draws on the same framebuffer
+ * when no batch in between touches any of the same pixels, so that
+ * interleaved programs don't defeat batching. Painter's order is kept,
+ * as a batch only moves across batches it does not overlap with.
+ */
+static void
+gsk_gl_command_queue_reorder_batches (GskGLCommandQueue *self)
+{
+  G_GNUC_UNUSED guint n_merges = 0;
+  int index;
+
+  index = self->head_batch_index;
+
+  while (index >= 0)
+    {
+      GskGLCommandBatch *batch = &self->batches.items[index];
+      int next_index = batch->any.next_batch_index;
+
+      if (batch_is_bounded (self, index))
+        {
+          const GskGLCommandBounds *bounds = &self->batch_bounds.items[index];
+          int candidate_index = batch->any.prev_batch_index;
+
+          for (guint i = 0; candidate_index >= 0 && i < MAX_REORDER_DISTANCE; i++)
+            {
+              GskGLCommandBatch *candidate = &self->batches.items[candidate_index];
+
+              if (batches_can_merge (self, candidate, batch))
+                {
+                  gsk_gl_command_queue_merge_batches (self, candidate, batch);
+                  n_merges++;
+                  break;
+                }
+
+              if (!batch_is_bounded (self, candidate_index) ||
+                  candidate->draw.framebuffer != batch->draw.framebuffer ||
+                  candidate->any.viewport.width != batch->any.viewport.width ||
+                  candidate->any.viewport.height != batch->any.viewport.height ||
+                  bounds_intersect (&self->batch_bounds.items[candidate_index], bounds))
+                break;
+
+              candidate_index = candidate->any.prev_batch_index;
+            }
+        }
+
+      index = next_index;
+    }
+
+#ifdef G_ENABLE_DEBUG
+  if (self->profiler != NULL)
+    gsk_profiler_counter_add (self->profiler, self->metrics.n_batch_merges, n_merges);
+#endif
+}
+
 /**
  * gsk_gl_command_queue_execute:
  * @self: a `GskGLCommandQueue`
@@ -1036,6 +1216,7 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
   G_GNUC_UNUSED unsigned int n_programs = 0;
   guint vao_id;
   guint vbo_id;
+  guint instance_vbo_id = 0;
   int textures[GSK_GL_MAX_TEXTURES_PER_PROGRAM];
   int samplers[GSK_GL_MAX_TEXTURES_PER_PROGRAM];
   int framebuffer = -1;
@@ -1055,6 +1236,9 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
 
   gsk_gl_command_queue_sort_batches (self);
 
+  if (self->has_batch_bounds)
+    gsk_gl_command_queue_reorder_batches (self);
+
   gsk_gl_command_queue_make_current (self);
 
 #ifdef G_ENABLE_DEBUG
@@ -1102,6 +1286,20 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
                          sizeof (GskGLDrawVertex),
                          (void *) G_STRUCT_OFFSET (GskGLDrawVertex, color2));
 
+  if (self->instances.count > 0)
+    {
+      /* 4, 5, 6 = instance rect, uv and color locations. The pointers
+       * are set up per batch, as we can't rely on having base instances.
+       */
+      instance_vbo_id = gsk_gl_buffer_submit (&self->instances);
+
+      for (guint i = 4; i <= 6; i++)
+        {
+          glEnableVertexAttribArray (i);
+          glVertexAttribDivisor (i, 1);
+        }
+    }
+
   /* Setup initial scissor clip */
   if (scissor != NULL)
     {
@@ -1227,7 +1425,26 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
               n_uniforms += batch->draw.uniform_count;
             }
 
-          glDrawArrays (GL_TRIANGLES, batch->draw.vbo_offset, batch->draw.vbo_count);
+          if (batch->any.instanced)
+            {
+              gsize offset = batch->draw.vbo_offset * sizeof (GskGLDrawInstance);
+
+              glVertexAttribPointer (4, 4, GL_FLOAT, GL_FALSE,
+                                     sizeof (GskGLDrawInstance),
+                                     (void *) (offset + G_STRUCT_OFFSET (GskGLDrawInstance, rect)));
+              glVertexAttribPointer (5, 4, GL_FLOAT, GL_FALSE,
+                                     sizeof (GskGLDrawInstance),
+                                     (void *) (offset + G_STRUCT_OFFSET (GskGLDrawInstance, uv)));
+              glVertexAttribPointer (6, 4, GL_HALF_FLOAT, GL_FALSE,
+                                     sizeof (GskGLDrawInstance),
+                                     (void *) (offset + G_STRUCT_OFFSET (GskGLDrawInstance, color)));
+
+              glDrawArraysInstanced (GL_TRIANGLES, 0, GSK_GL_N_VERTICES, batch->draw.vbo_count);
+            }
+          else
+            {
+              glDrawArrays (GL_TRIANGLES, batch->draw.vbo_offset, batch->draw.vbo_count);
+            }
 
         break;
 
@@ -1257,6 +1474,17 @@ gsk_gl_command_queue_execute (GskGLCommandQueue    *self,
     }
 
   glDeleteBuffers (1, &vbo_id);
+  if (instance_vbo_id != 0)
+    {
+      /* Without a VAO of our own, don't leak the state into other users */
+      for (guint i = 4; i <= 6; i++)
+        {
+          glVertexAttribDivisor (i, 0);
+          glDisableVertexAttribArray (i);
+        }
+
+      glDeleteBuffers (1, &instance_vbo_id);
+    }
   if (!gdk_gl_context_get_use_es (self->context))
     glDeleteVertexArrays (1, &vao_id);
 
@@ -1335,6 +1563,8 @@ gsk_gl_command_queue_end_frame (GskGLCommandQueue *self)
   self->batches.len = 0;
   self->batch_binds.len = 0;
   self->batch_uniforms.len = 0;
+  self->batch_bounds.len = 0;
+  self->has_batch_bounds = FALSE;
   self->syncs.len = 0;
   self->n_uploads = 0;
   self->tail_batch_index = -1;
@@ -1544,6 +1774,105 @@ memory_format_gl_format (GdkMemoryFormat  data_format,
   return data_format;
 }
 
+/* Uploads smaller than this go straight from client memory, the
+ * staging copy is not worth it for glyphs and icons.
+ */
+#define UPLOAD_BUFFER_MIN_SIZE (256 * 1024)
+
+/*<private>
+ * gsk_gl_command_queue_upload_through_buffer:
+ *
+ * Copies the pixels into the next buffer of the upload ring and
+ * sources the currently bound texture from it, so the driver can
+ * perform the transfer asynchronously instead of copying from
+ * client memory before glTexSubImage2D() returns.
+ *
+ * A buffer whose fence has not signaled yet is orphaned instead of
+ * waited on, so this never stalls on the GPU.
+ *
+ * Returns: %FALSE if the buffer could not be mapped
+ */
+static gboolean
+gsk_gl_command_queue_upload_through_buffer (GskGLCommandQueue *self,
+                                            int                x,
+                                            int                y,
+                                            int                width,
+                                            int                height,
+                                            GLenum             gl_format,
+                                            GLenum             gl_type,
+                                            const guchar      *data,
+                                            gsize              stride,
+                                            gsize              bpp)
+{
+  GskGLUploadBuffer *buffer;
+  gsize row_size, size;
+  gboolean busy = FALSE;
+  GLbitfield flags;
+  guchar *mapped;
+
+  row_size = width * bpp;
+  size = row_size * height;
+
+  buffer = &self->upload_buffers[self->upload_buffer_index];
+  self->upload_buffer_index = (self->upload_buffer_index + 1) % G_N_ELEMENTS (self->upload_buffers);
+
+  if (buffer->id == 0)
+    glGenBuffers (1, &buffer->id);
+
+  glBindBuffer (GL_PIXEL_UNPACK_BUFFER, buffer->id);
+
+  if (buffer->fence != NULL)
+    {
+      GLenum status = glClientWaitSync (buffer->fence, 0, 0);
+
+      busy = status != GL_ALREADY_SIGNALED && status != GL_CONDITION_SATISFIED;
+      glDeleteSync (buffer->fence);
+      buffer->fence = NULL;
+    }
+
+  if (busy || buffer->size < size)
+    {
+      buffer->size = MAX (buffer->size, size);
+      glBufferData (GL_PIXEL_UNPACK_BUFFER, buffer->size, NULL, GL_STREAM_DRAW);
+      flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT;
+    }
+  else
+    {
+      /* The GPU is done with the previous contents */
+      flags = GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT;
+    }
+
+  mapped = glMapBufferRange (GL_PIXEL_UNPACK_BUFFER, 0, size, flags);
+  if (mapped == NULL)
+    {
+      glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+      return FALSE;
+    }
+
+  if (stride == row_size)
+    {
+      memcpy (mapped, data, size);
+    }
+  else
+    {
+      for (int i = 0; i < height; i++)
+        memcpy (mapped + i * row_size, data + i * stride, row_size);
+    }
+
+  if (!glUnmapBuffer (GL_PIXEL_UNPACK_BUFFER))
+    {
+      glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+      return FALSE;
+    }
+
+  glTexSubImage2D (GL_TEXTURE_2D, 0, x, y, width, height, gl_format, gl_type, NULL);
+  buffer->fence = glFenceSync (GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  glBindBuffer (GL_PIXEL_UNPACK_BUFFER, 0);
+
+  return TRUE;
+}
+
 static void
 gsk_gl_command_queue_do_upload_texture_chunk (GskGLCommandQueue *self,
                                               GdkTexture        *texture,
@@ -1591,7 +1920,15 @@ gsk_gl_command_queue_do_upload_texture_chunk (GskGLCommandQueue *self,
   /* GL_UNPACK_ROW_LENGTH is available on desktop GL, OpenGL ES >= 3.0, or if
    * the GL_EXT_unpack_subimage extension for OpenGL ES 2.0 is available
    */
-  if (stride == width * bpp)
+  if (self->has_upload_buffers &&
+      (gsize) width * height * bpp >= UPLOAD_BUFFER_MIN_SIZE &&
+      gsk_gl_command_queue_upload_through_buffer (self, x, y, width, height,
+                                                  gl_format, gl_type,
+                                                  data, stride, bpp))
+    {
+      /* Staged through the upload ring */
+    }
+  else if (stride == width * bpp)
     {
       glTexSubImage2D (GL_TEXTURE_2D, 0, x, y, width, height, gl_format, gl_type, data);
     }
@@ -1713,6 +2050,76 @@ gsk_gl_command_queue_upload_texture (GskGLCommandQueue *self,
   return gsk_gl_command_queue_upload_texture_chunks (self, 1, &(GskGLTextureChunk){ texture, 0, 0});
 }
 
+/*
+ * gsk_gl_command_queue_upload_compressed_texture:
+ *
+ * Uploads the blocks of @texture without decompressing them.
+ *
+ * Returns: the texture id, or -1 if the GL context does not
+ *   support the compressed format or the texture is too large
+ */
+int
+gsk_gl_command_queue_upload_compressed_texture (GskGLCommandQueue    *self,
+                                                GdkCompressedTexture *texture)
+{
+  G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
+  GBytes *bytes;
+  GLenum gl_format;
+  int width, height;
+  int texture_id;
+
+  g_assert (GSK_IS_GL_COMMAND_QUEUE (self));
+
+  if (!gdk_gl_context_has_texture_compression_s3tc (self->context))
+    return -1;
+
+  switch (gdk_compressed_texture_get_compressed_format (texture))
+    {
+    case GDK_COMPRESSED_BC1:
+      gl_format = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+      break;
+    case GDK_COMPRESSED_BC2:
+      gl_format = GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;
+      break;
+    case GDK_COMPRESSED_BC3:
+      gl_format = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+      break;
+    default:
+      return -1;
+    }
+
+  width = gdk_texture_get_width (GDK_TEXTURE (texture));
+  height = gdk_texture_get_height (GDK_TEXTURE (texture));
+
+  texture_id = gsk_gl_command_queue_create_texture (self, width, height, GL_RGBA8);
+  if (texture_id == -1)
+    return texture_id;
+
+  self->n_uploads++;
+
+  glActiveTexture (GL_TEXTURE0);
+  glBindTexture (GL_TEXTURE_2D, texture_id);
+
+  bytes = gdk_compressed_texture_get_bytes (texture);
+  glCompressedTexImage2D (GL_TEXTURE_2D, 0, gl_format,
+                          width, height, 0,
+                          ((width + 3) / 4) * ((height + 3) / 4) *
+                          gdk_compressed_format_get_block_size (gdk_compressed_texture_get_compressed_format (texture)),
+                          g_bytes_get_data (bytes, NULL));
+
+  /* Restore previous texture state if any */
+  if (self->attachments->textures[0].id > 0)
+    glBindTexture (self->attachments->textures[0].target,
+                   self->attachments->textures[0].id);
+
+  if (gdk_profiler_is_running ())
+    gdk_profiler_add_markf (start_time, GDK_PROFILER_CURRENT_TIME-start_time,
+                            "Upload Compressed Texture",
+                            "Size %dx%d", width, height);
+
+  return texture_id;
+}
+
 void
 gsk_gl_command_queue_set_profiler (GskGLCommandQueue *self,
                                    GskProfiler       *profiler)
@@ -1728,6 +2135,9 @@ gsk_gl_command_queue_set_profiler (GskGLCommandQueue *self,
       self->metrics.n_frames = gsk_profiler_add_counter (profiler, "frames", "Frames", FALSE);
       self->metrics.cpu_time = gsk_profiler_add_timer (profiler, "cpu-time", "CPU Time", FALSE, TRUE);
       self->metrics.gpu_time = gsk_profiler_add_timer (profiler, "gpu-time", "GPU Time", FALSE, TRUE);
+      self->metrics.n_offscreen_hits = gsk_profiler_add_counter (profiler, "offscreen-hits", "Offscreens reused by content", TRUE);
+      self->metrics.n_offscreen_misses = gsk_profiler_add_counter (profiler, "offscreen-misses", "Offscreens not reused by content", TRUE);
+      self->metrics.n_batch_merges = gsk_profiler_add_counter (profiler, "batch-merges", "Batches merged by reordering", TRUE);
 
       self->metrics.n_binds = gdk_profiler_define_int_counter ("attachments", "Number of texture attachments");
       self->metrics.n_fbos = gdk_profiler_define_int_counter ("fbos", "Number of framebuffers attached");
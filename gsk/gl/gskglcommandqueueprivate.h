@@ -65,7 +65,12 @@ G_STATIC_ASSERT (sizeof (GskGLCommandBind) == 4);
 typedef struct _GskGLCommandBatchAny
 {
   /* A GskGLCommandKind indicating what the batch will do */
-  guint kind : 8;
+  guint kind : 7;
+
+  /* If the draw uses an instanced program, in which case vbo_offset and
+   * vbo_count refer to GskGLDrawInstance records instead of vertices.
+   */
+  guint instanced : 1;
 
   /* The program's identifier to use for determining if we can merge two
    * batches together into a single set of draw operations. We put this
@@ -168,14 +173,40 @@ typedef union _GskGLCommandBatch
 
 G_STATIC_ASSERT (sizeof (GskGLCommandBatch) == 32);
 
+typedef struct _GskGLCommandBounds
+{
+  /* The area of the framebuffer touched by the batch */
+  float x1;
+  float y1;
+  float x2;
+  float y2;
+
+  /* How much of the batch's vbo_count is covered by the area. Batches
+   * containing quads whose bounds were not reported can't be reordered.
+   */
+  guint count;
+} GskGLCommandBounds;
+
 typedef struct _GskGLSync {
   guint id;
   gpointer sync;
 } GskGLSync;
 
+/* Number of pixel buffer objects that texture uploads cycle through
+ * so that filling one does not wait for the GPU to consume another.
+ */
+#define GSK_GL_N_UPLOAD_BUFFERS 4
+
+typedef struct _GskGLUploadBuffer {
+  guint id;
+  gsize size;
+  gpointer fence;
+} GskGLUploadBuffer;
+
 DEFINE_INLINE_ARRAY (GskGLCommandBatches, gsk_gl_command_batches, GskGLCommandBatch)
 DEFINE_INLINE_ARRAY (GskGLCommandBinds, gsk_gl_command_binds, GskGLCommandBind)
 DEFINE_INLINE_ARRAY (GskGLCommandUniforms, gsk_gl_command_uniforms, GskGLCommandUniform)
+DEFINE_INLINE_ARRAY (GskGLCommandBoundsArray, gsk_gl_command_bounds_array, GskGLCommandBounds)
 DEFINE_INLINE_ARRAY (GskGLSyncs, gsk_gl_syncs, GskGLSync)
 
 struct _GskGLCommandQueue
@@ -198,6 +229,9 @@ struct _GskGLCommandQueue
    */
   GskGLBuffer vertices;
 
+  /* One GskGLDrawInstance per quad drawn by instanced programs */
+  GskGLBuffer instances;
+
   /* The GskGLAttachmentState contains information about our FBO and texture
    * attachments as we process incoming operations. We snapshot them into
    * various batches so that we can compare differences between merge
@@ -232,6 +266,12 @@ struct _GskGLCommandQueue
    */
   GskGLCommandUniforms batch_uniforms;
 
+  /* Array of GskGLCommandBounds with one element per batch in @batches, at
+   * the same index. These are only filled in when the render job reports
+   * the bounds of its quads, and are used to reorder batches.
+   */
+  GskGLCommandBoundsArray batch_bounds;
+
   /* Array of samplers that we use for mag/min filter handling. It is indexed
    * by the sampler_index() function.
    * Note that when samplers are not supported (hello GLES), we fall back to
@@ -243,6 +283,13 @@ struct _GskGLCommandQueue
    */
   GskGLSyncs syncs;
 
+  /* Ring of pixel buffer objects used to stage texture uploads. Each
+   * buffer carries a fence so we only reuse it once the GPU has pulled
+   * the pixels out of it.
+   */
+  GskGLUploadBuffer upload_buffers[GSK_GL_N_UPLOAD_BUFFERS];
+  guint upload_buffer_index;
+
   /* Discovered max texture size when loading the command queue so that we
    * can either scale down or slice textures to fit within this size. Assumed
    * to be both height and width.
@@ -264,6 +311,9 @@ struct _GskGLCommandQueue
     GQuark n_frames;
     GQuark cpu_time;
     GQuark gpu_time;
+    GQuark n_offscreen_hits;
+    GQuark n_offscreen_misses;
+    GQuark n_batch_merges;
     guint n_binds;
     guint n_fbos;
     guint n_uniforms;
@@ -278,6 +328,12 @@ struct _GskGLCommandQueue
   /* If the GL context is new enough for sampler support */
   guint has_samplers : 1;
 
+  /* If the GL context can do instanced draws with gl_VertexID */
+  guint has_instancing : 1;
+
+  /* If large texture uploads can be staged through pixel buffer objects */
+  guint has_upload_buffers : 1;
+
   /* If we're inside a begin/end_frame pair */
   guint in_frame : 1;
 
@@ -286,6 +342,9 @@ struct _GskGLCommandQueue
 
   /* If we've warned about truncating batches */
   guint have_truncated : 1;
+
+  /* If any bounds were reported to @batch_bounds in this frame */
+  guint has_batch_bounds : 1;
 };
 
 GskGLCommandQueue *gsk_gl_command_queue_new                   (GdkGLContext         *context,
@@ -303,6 +362,9 @@ void                gsk_gl_command_queue_execute              (GskGLCommandQueue
                                                                guint                 default_framebuffer);
 int                 gsk_gl_command_queue_upload_texture       (GskGLCommandQueue    *self,
                                                                GdkTexture           *texture);
+int                 gsk_gl_command_queue_upload_compressed_texture
+                                                              (GskGLCommandQueue    *self,
+                                                               GdkCompressedTexture *texture);
 int                 gsk_gl_command_queue_create_texture       (GskGLCommandQueue    *self,
                                                                int                   width,
                                                                int                   height,
@@ -372,6 +434,52 @@ gsk_gl_command_queue_retract_n_vertices (GskGLCommandQueue *self,
   gsk_gl_buffer_retract (&self->vertices, GSK_GL_N_VERTICES * count);
 }
 
+static inline GskGLDrawInstance *
+gsk_gl_command_queue_add_instance (GskGLCommandQueue *self)
+{
+  gsk_gl_command_queue_get_batch (self)->draw.vbo_count += 1;
+  return gsk_gl_buffer_advance (&self->instances, 1);
+}
+
+static inline GskGLDrawInstance *
+gsk_gl_command_queue_add_n_instances (GskGLCommandQueue *self,
+                                      guint              count)
+{
+  /* Like gsk_gl_command_queue_add_n_vertices(), this does not tweak
+   * the draw vbo_count.
+   */
+  return gsk_gl_buffer_advance (&self->instances, count);
+}
+
+static inline void
+gsk_gl_command_queue_retract_n_instances (GskGLCommandQueue *self,
+                                          guint              count)
+{
+  gsk_gl_buffer_retract (&self->instances, count);
+}
+
+/* Reports that @count units of the current batch's vbo_count cover the
+ * given area of the framebuffer, in framebuffer coordinates.
+ */
+static inline void
+gsk_gl_command_queue_add_bounds (GskGLCommandQueue *self,
+                                 float              x1,
+                                 float              y1,
+                                 float              x2,
+                                 float              y2,
+                                 guint              count)
+{
+  GskGLCommandBounds *bounds = gsk_gl_command_bounds_array_tail (&self->batch_bounds);
+
+  bounds->x1 = MIN (bounds->x1, x1);
+  bounds->y1 = MIN (bounds->y1, y1);
+  bounds->x2 = MAX (bounds->x2, x2);
+  bounds->y2 = MAX (bounds->y2, y2);
+  bounds->count += count;
+
+  self->has_batch_bounds = TRUE;
+}
+
 static inline guint
 gsk_gl_command_queue_bind_framebuffer (GskGLCommandQueue *self,
                                        guint              framebuffer)
@@ -20,8 +20,11 @@
 
 #include "config.h"
 
+#include <gdk/gdkglcontextprivate.h>
 #include <gsk/gskdebugprivate.h>
 #include <gio/gio.h>
+#include <glib/gstdio.h>
+#include <errno.h>
 #include <string.h>
 
 #include "gskglcommandqueueprivate.h"
@@ -52,6 +55,11 @@ struct _GskGLCompiler
 
   const char *glsl_version;
 
+  /* Where linked program binaries are stored, or %NULL if
+   * the context can't give us program binaries.
+   */
+  char *binary_cache_dir;
+
   guint gl3 : 1;
   guint gles : 1;
   guint legacy : 1;
@@ -81,6 +89,7 @@ gsk_gl_compiler_finalize (GObject *object)
   g_clear_pointer (&self->fragment_suffix, g_bytes_unref);
   g_clear_pointer (&self->vertex_source, g_bytes_unref);
   g_clear_pointer (&self->attrib_locations, g_array_unref);
+  g_clear_pointer (&self->binary_cache_dir, g_free);
   g_clear_object (&self->driver);
 
   G_OBJECT_CLASS (gsk_gl_compiler_parent_class)->finalize (object);
@@ -163,6 +172,24 @@ gsk_gl_compiler_new (GskGLDriver *driver,
 
   gsk_gl_command_queue_make_current (self->driver->shared_command_queue);
 
+  /* Skip the program binary cache when debugging shaders, so that they
+   * are always compiled and can be printed.
+   */
+  if (gdk_gl_context_has_program_binary (context) &&
+      !self->debug_shaders &&
+      !GSK_DEBUG_CHECK (SHADERS))
+    {
+      int n_formats = 0;
+
+      glGetIntegerv (GL_NUM_PROGRAM_BINARY_FORMATS, &n_formats);
+
+      if (n_formats > 0)
+        self->binary_cache_dir = g_build_filename (g_get_user_cache_dir (),
+                                                   "gtk-4.0",
+                                                   "gl-program-cache",
+                                                   NULL);
+    }
+
   return g_steal_pointer (&self);
 }
 
@@ -532,6 +559,150 @@ get_shader_string (GBytes *bytes)
   return str ? str : "";
 }
 
+static void
+checksum_update_bytes (GChecksum *checksum,
+                       GBytes    *bytes)
+{
+  gsize len;
+  const guchar *data = g_bytes_get_data (bytes, &len);
+
+  g_checksum_update (checksum, (const guchar *)&len, sizeof len);
+  if (len > 0)
+    g_checksum_update (checksum, data, len);
+}
+
+static void
+checksum_update_string (GChecksum  *checksum,
+                        const char *str)
+{
+  /* include the terminating nul, so that adjacent strings can't collide */
+  g_checksum_update (checksum, (const guchar *)(str ? str : ""), str ? strlen (str) + 1 : 1);
+}
+
+/* Returns the path of the file a binary for the program that @clip and
+ * the current sources would produce is cached in. Everything that can
+ * change the result of compiling and linking is hashed, including the
+ * driver's identification strings, so that a driver update does not
+ * pick up stale binaries.
+ */
+static char *
+gsk_gl_compiler_get_binary_path (GskGLCompiler *self,
+                                 const char    *clip)
+{
+  GChecksum *checksum;
+  char *path;
+
+  checksum = g_checksum_new (G_CHECKSUM_SHA256);
+
+  checksum_update_string (checksum, (const char *) glGetString (GL_VENDOR));
+  checksum_update_string (checksum, (const char *) glGetString (GL_RENDERER));
+  checksum_update_string (checksum, (const char *) glGetString (GL_VERSION));
+  checksum_update_string (checksum, G_STRINGIFY (GDK_MAJOR_VERSION) "."
+                                    G_STRINGIFY (GDK_MINOR_VERSION) "."
+                                    G_STRINGIFY (GDK_MICRO_VERSION));
+  checksum_update_string (checksum, self->glsl_version);
+  g_checksum_update (checksum, (const guchar *) (guint[]) { self->gl3, self->gles, self->legacy }, 3 * sizeof (guint));
+  checksum_update_string (checksum, clip);
+
+  checksum_update_bytes (checksum, self->all_preamble);
+  checksum_update_bytes (checksum, self->vertex_preamble);
+  checksum_update_bytes (checksum, self->vertex_source);
+  checksum_update_bytes (checksum, self->vertex_suffix);
+  checksum_update_bytes (checksum, self->fragment_preamble);
+  checksum_update_bytes (checksum, self->fragment_source);
+  checksum_update_bytes (checksum, self->fragment_suffix);
+
+  for (guint i = 0; i < self->attrib_locations->len; i++)
+    {
+      const GskGLProgramAttrib *attrib;
+
+      attrib = &g_array_index (self->attrib_locations, GskGLProgramAttrib, i);
+      checksum_update_string (checksum, attrib->name);
+      g_checksum_update (checksum, (const guchar *)&attrib->location, sizeof attrib->location);
+    }
+
+  path = g_build_filename (self->binary_cache_dir, g_checksum_get_string (checksum), NULL);
+
+  g_checksum_free (checksum);
+
+  return path;
+}
+
+/* The cache files contain the binary format as a guint32 in host byte
+ * order followed by the data returned from glGetProgramBinary().
+ */
+static int
+gsk_gl_compiler_load_binary (GskGLCompiler *self,
+                             const char    *path,
+                             const char    *name)
+{
+  char *contents;
+  gsize len;
+  guint32 format;
+  int program_id;
+  int status;
+
+  if (!g_file_get_contents (path, &contents, &len, NULL))
+    return 0;
+
+  if (len <= sizeof format)
+    {
+      g_free (contents);
+      g_unlink (path);
+      return 0;
+    }
+
+  memcpy (&format, contents, sizeof format);
+
+  program_id = glCreateProgram ();
+  glProgramBinary (program_id, format, contents + sizeof format, len - sizeof format);
+  glGetProgramiv (program_id, GL_LINK_STATUS, &status);
+
+  g_free (contents);
+
+  if (status == GL_FALSE)
+    {
+      /* The driver may reject binaries at any time, recompile */
+      GSK_DEBUG (SHADERS, "Rejected cached binary for program %s", name);
+      glDeleteProgram (program_id);
+      g_unlink (path);
+      return 0;
+    }
+
+  return program_id;
+}
+
+static void
+gsk_gl_compiler_save_binary (GskGLCompiler *self,
+                             const char    *path,
+                             int            program_id)
+{
+  GError *error = NULL;
+  char *contents;
+  int len = 0;
+  GLenum format = 0;
+  guint32 format32;
+
+  glGetProgramiv (program_id, GL_PROGRAM_BINARY_LENGTH, &len);
+  if (len <= 0)
+    return;
+
+  contents = g_malloc (sizeof format32 + len);
+  glGetProgramBinary (program_id, len, &len, &format, contents + sizeof format32);
+  format32 = format;
+  memcpy (contents, &format32, sizeof format32);
+
+  if (g_mkdir_with_parents (self->binary_cache_dir, 0755) != 0 ||
+      !g_file_set_contents (path, contents, sizeof format32 + len, &error))
+    {
+      GSK_DEBUG (OPENGL, "Failed to save program binary to %s: %s",
+                 path, error ? error->message : g_strerror (errno));
+      g_clear_error (&error);
+    }
+
+  g_free (contents);
+}
+
 GskGLProgram *
 gsk_gl_compiler_compile (GskGLCompiler  *self,
                          const char     *name,
@@ -543,6 +714,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
   const char *legacy = "";
   const char *gl3 = "";
   const char *gles = "";
+  char *binary_path = NULL;
   int program_id;
   int vertex_id;
   int fragment_id;
@@ -558,6 +730,18 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
 
   gsk_gl_command_queue_make_current (self->driver->command_queue);
 
+  if (self->binary_cache_dir != NULL)
+    {
+      binary_path = gsk_gl_compiler_get_binary_path (self, clip);
+      program_id = gsk_gl_compiler_load_binary (self, binary_path, name);
+
+      if (program_id != 0)
+        {
+          g_free (binary_path);
+          return gsk_gl_program_new (self->driver, name, program_id);
+        }
+    }
+
   g_snprintf (version, sizeof version, "#version %s\n", self->glsl_version);
 
   if (self->debug_shaders)
@@ -600,6 +784,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
   if (!check_shader_error (vertex_id, error))
     {
       glDeleteShader (vertex_id);
+      g_free (binary_path);
       return NULL;
     }
 
@@ -634,6 +819,7 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
     {
       glDeleteShader (vertex_id);
       glDeleteShader (fragment_id);
+      g_free (binary_path);
       return NULL;
     }
 
@@ -651,6 +837,9 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
       glBindAttribLocation (program_id, attrib->location, attrib->name);
     }
 
+  if (binary_path != NULL)
+    glProgramParameteri (program_id, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+
   glLinkProgram (program_id);
 
   glGetProgramiv (program_id, GL_LINK_STATUS, &status);
@@ -687,9 +876,16 @@ gsk_gl_compiler_compile (GskGLCompiler  *self,
       g_free (buffer);
 
       glDeleteProgram (program_id);
+      g_free (binary_path);
 
       return NULL;
     }
 
+  if (binary_path != NULL)
+    {
+      gsk_gl_compiler_save_binary (self, binary_path, program_id);
+      g_free (binary_path);
+    }
+
   return gsk_gl_program_new (self->driver, name, program_id);
 }
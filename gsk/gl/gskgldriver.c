@@ -27,7 +27,9 @@
 
 #include <gsk/gskdebugprivate.h>
 #include <gsk/gskglshaderprivate.h>
+#include <gsk/gskgpumemoryprivate.h>
 #include <gsk/gskrendererprivate.h>
+#include <gsk/gskrendernodeprivate.h>
 
 #include "gskglcommandqueueprivate.h"
 #include "gskglcompilerprivate.h"
@@ -39,6 +41,7 @@
 
 #include <gdk/gdkglcontextprivate.h>
 #include <gdk/gdkdisplayprivate.h>
+#include <gdk/gdkdmabuftextureprivate.h>
 #include <gdk/gdkmemorytextureprivate.h>
 #include <gdk/gdkprofilerprivate.h>
 #include <gdk/gdktextureprivate.h>
@@ -47,6 +50,32 @@
 
 G_DEFINE_TYPE (GskGLDriver, gsk_gl_driver, G_TYPE_OBJECT)
 
+static GdkMemoryFormat
+memory_format_for_gl_format (int format)
+{
+  switch (format)
+    {
+    case GL_RGBA16F:
+      return GDK_MEMORY_R16G16B16A16_FLOAT_PREMULTIPLIED;
+    case GL_RGBA32F:
+      return GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED;
+    case GL_RGBA8:
+    default:
+      return GDK_MEMORY_R8G8B8A8_PREMULTIPLIED;
+    }
+}
+
+/* GL does not tell us how much memory a texture uses, so this
+ * is an estimate from its size and format.
+ */
+static gsize
+gl_format_get_n_bytes (int format,
+                       int width,
+                       int height)
+{
+  return (gsize) width * height * gdk_memory_format_bytes_per_pixel (memory_format_for_gl_format (format));
+}
+
 static guint
 texture_key_hash (gconstpointer v)
 {
@@ -79,11 +108,91 @@ texture_key_equal (gconstpointer v1,
          (!k1->pointer_is_child || memcmp (&k1->parent_rect, &k2->parent_rect, sizeof k1->parent_rect) == 0);
 }
 
+/* Offscreens may also be found by content, see
+ * gsk_gl_driver_lookup_texture_by_content(). The entries are hashed
+ * by everything but the node pointer, so that a new node with the same
+ * type and geometry finds the node that produced the texture, which we
+ * then compare to the new node using gsk_render_node_diff().
+ */
+typedef struct _GskGLContentEntry
+{
+  GskTextureKey key;
+  guint texture_id;
+  gsize size;
+} GskGLContentEntry;
+
+/* Keep the memory referenced by the content cache bounded, as it holds
+ * on to render nodes and their offscreens for as long as they are used.
+ */
+#define MAX_CONTENT_CACHE_SIZE (64 * 1024 * 1024)
+
+static guint
+content_key_hash (gconstpointer v)
+{
+  const GskTextureKey *k = (const GskTextureKey *)v;
+  const GskRenderNode *node = k->pointer;
+  guint h;
+
+  h = gsk_render_node_get_node_type (node);
+  h = (h << 5) - h + (int) node->bounds.origin.x;
+  h = (h << 5) - h + (int) node->bounds.origin.y;
+  h = (h << 5) - h + (int) node->bounds.size.width;
+  h = (h << 5) - h + (int) node->bounds.size.height;
+  h = (h << 5) - h + (int) (k->scale_x * 16);
+  h = (h << 5) - h + (int) (k->scale_y * 16);
+
+  return h ^ k->pointer_is_child;
+}
+
+static gboolean
+content_key_equal (gconstpointer v1,
+                   gconstpointer v2)
+{
+  const GskTextureKey *k1 = (const GskTextureKey *)v1;
+  const GskTextureKey *k2 = (const GskTextureKey *)v2;
+  const GskRenderNode *n1 = k1->pointer;
+  const GskRenderNode *n2 = k2->pointer;
+
+  return gsk_render_node_get_node_type (n1) == gsk_render_node_get_node_type (n2) &&
+         graphene_rect_equal (&n1->bounds, &n2->bounds) &&
+         k1->scale_x == k2->scale_x &&
+         k1->scale_y == k2->scale_y &&
+         k1->pointer_is_child == k2->pointer_is_child &&
+         (!k1->pointer_is_child || memcmp (&k1->parent_rect, &k2->parent_rect, sizeof k1->parent_rect) == 0);
+}
+
+static void
+gsk_gl_content_entry_free (gpointer data)
+{
+  GskGLContentEntry *entry = data;
+
+  gsk_render_node_unref ((GskRenderNode *) entry->key.pointer);
+  g_free (entry);
+}
+
+static void
+remove_content_entry_for_id (GskGLDriver *self,
+                             guint        texture_id)
+{
+  GskGLContentEntry *entry;
+
+  /* g_hash_table_remove() will cause @entry to be freed */
+  if (g_hash_table_steal_extended (self->texture_id_to_content,
+                                   GUINT_TO_POINTER (texture_id),
+                                   NULL,
+                                   (gpointer *)&entry))
+    {
+      self->content_cache_size -= entry->size;
+      g_hash_table_remove (self->content_cache, entry);
+    }
+}
+
 static void
 remove_texture_key_for_id (GskGLDriver *self,
                            guint        texture_id)
 {
   GskTextureKey *key;
+  guint64 *mask_key;
 
   g_assert (GSK_IS_GL_DRIVER (self));
   g_assert (texture_id > 0);
@@ -94,6 +203,14 @@ remove_texture_key_for_id (GskGLDriver *self,
                                    NULL,
                                    (gpointer *)&key))
     g_hash_table_remove (self->key_to_texture_id, key);
+
+  remove_content_entry_for_id (self, texture_id);
+
+  if (g_hash_table_steal_extended (self->texture_id_to_mask,
+                                   GUINT_TO_POINTER (texture_id),
+                                   NULL,
+                                   (gpointer *)&mask_key))
+    g_hash_table_remove (self->mask_cache, mask_key);
 }
 
 static void
@@ -230,7 +347,9 @@ gsk_gl_driver_dispose (GObject *object)
       gsk_gl_program_delete (self->name);               \
     g_clear_object (&self->name);                       \
   } G_STMT_END;
+#define GSK_GL_DEFINE_INSTANCED_PROGRAM GSK_GL_DEFINE_PROGRAM
 # include "gskglprograms.defs"
+#undef GSK_GL_DEFINE_INSTANCED_PROGRAM
 #undef GSK_GL_NO_UNIFORMS
 #undef GSK_GL_SHADER_RESOURCE
 #undef GSK_GL_SHADER_STRING
@@ -283,6 +402,10 @@ gsk_gl_driver_dispose (GObject *object)
   g_clear_pointer (&self->textures, g_hash_table_unref);
   g_clear_pointer (&self->key_to_texture_id, g_hash_table_unref);
   g_clear_pointer (&self->texture_id_to_key, g_hash_table_unref);
+  g_clear_pointer (&self->texture_id_to_content, g_hash_table_unref);
+  g_clear_pointer (&self->content_cache, g_hash_table_unref);
+  g_clear_pointer (&self->texture_id_to_mask, g_hash_table_unref);
+  g_clear_pointer (&self->mask_cache, g_hash_table_unref);
   g_clear_pointer (&self->render_targets, g_ptr_array_unref);
   g_clear_pointer (&self->shader_cache, g_hash_table_unref);
 
@@ -311,6 +434,13 @@ gsk_gl_driver_init (GskGLDriver *self)
                                                    texture_key_equal,
                                                    g_free,
                                                    NULL);
+  self->content_cache = g_hash_table_new_full (content_key_hash,
+                                               content_key_equal,
+                                               NULL,
+                                               gsk_gl_content_entry_free);
+  self->texture_id_to_content = g_hash_table_new (NULL, NULL);
+  self->mask_cache = g_hash_table_new_full (g_int64_hash, g_int64_equal, g_free, NULL);
+  self->texture_id_to_mask = g_hash_table_new (NULL, NULL);
   self->shader_cache = g_hash_table_new_full (NULL, NULL, NULL, remove_program);
   self->texture_pool = g_array_new (FALSE, FALSE, sizeof (guint));
   self->render_targets = g_ptr_array_new ();
@@ -345,6 +475,9 @@ gsk_gl_driver_load_programs (GskGLDriver  *self,
   gsk_gl_compiler_bind_attribute (compiler, "aUv", 1);
   gsk_gl_compiler_bind_attribute (compiler, "aColor", 2);
   gsk_gl_compiler_bind_attribute (compiler, "aColor2", 3);
+  gsk_gl_compiler_bind_attribute (compiler, "aInstanceRect", 4);
+  gsk_gl_compiler_bind_attribute (compiler, "aInstanceUv", 5);
+  gsk_gl_compiler_bind_attribute (compiler, "aInstanceColor", 6);
 
   /* Use XMacros to register all of our programs and their uniforms */
 #define GSK_GL_NO_UNIFORMS
@@ -373,7 +506,25 @@ gsk_gl_driver_load_programs (GskGLDriver  *self,
   GSK_GL_COMPILE_PROGRAM(name ## _no_clip, uniforms, "#define NO_CLIP 1\n");                    \
   GSK_GL_COMPILE_PROGRAM(name ## _rect_clip, uniforms, "#define RECT_CLIP 1\n");                \
   GSK_GL_COMPILE_PROGRAM(name, uniforms, "");
+/* Instanced programs get a variant for each clip that reads one
+ * GskGLDrawInstance per quad instead of its vertices, which the render
+ * job switches to in gsk_gl_render_job_begin_draw() if available.
+ */
+#define GSK_GL_DEFINE_INSTANCED_PROGRAM(name, sources, uniforms)                                \
+  GSK_GL_DEFINE_PROGRAM(name, sources, uniforms)                                                \
+  if (self->command_queue->has_instancing)                                                      \
+    {                                                                                           \
+      GSK_GL_COMPILE_PROGRAM_INTO(self->name ## _no_clip->instanced, name ## _no_clip, TRUE,    \
+                                  uniforms, "#define NO_CLIP 1\n#define GSK_INSTANCED 1\n");   \
+      GSK_GL_COMPILE_PROGRAM_INTO(self->name ## _rect_clip->instanced, name ## _rect_clip, TRUE,\
+                                  uniforms, "#define RECT_CLIP 1\n#define GSK_INSTANCED 1\n"); \
+      GSK_GL_COMPILE_PROGRAM_INTO(self->name->instanced, name, TRUE,                            \
+                                  uniforms, "#define GSK_INSTANCED 1\n");                      \
+    }
 #define GSK_GL_COMPILE_PROGRAM(name, uniforms, clip)                                            \
+  GSK_GL_COMPILE_PROGRAM_INTO(*(GskGLProgram **)(((guint8 *)self) + G_STRUCT_OFFSET (GskGLDriver, name)), \
+                              name, FALSE, uniforms, clip)
+#define GSK_GL_COMPILE_PROGRAM_INTO(dest, name, instanced, uniforms, clip)                      \
   G_STMT_START {                                                                                \
     GskGLProgram *program;                                                                      \
     gboolean have_alpha;                                                                        \
@@ -392,13 +543,16 @@ gsk_gl_driver_load_programs (GskGLDriver  *self,
     uniforms                                                                                    \
                                                                                                 \
     gsk_gl_program_uniforms_added (program, have_source);                                       \
+    program->program_info->instanced = instanced;                                               \
     if (have_alpha)                                                                             \
       gsk_gl_program_set_uniform1f (program, UNIFORM_SHARED_ALPHA, 0, 1.0f);                    \
                                                                                                 \
-    *(GskGLProgram **)(((guint8 *)self) + G_STRUCT_OFFSET (GskGLDriver, name)) =                \
-         g_steal_pointer (&program);                                                            \
+    dest = g_steal_pointer (&program);                                                          \
   } G_STMT_END;
 # include "gskglprograms.defs"
+#undef GSK_GL_COMPILE_PROGRAM_INTO
+#undef GSK_GL_COMPILE_PROGRAM
+#undef GSK_GL_DEFINE_INSTANCED_PROGRAM
 #undef GSK_GL_DEFINE_PROGRAM_CLIP
 #undef GSK_GL_DEFINE_PROGRAM
 #undef GSK_GL_ADD_UNIFORM
@@ -630,6 +784,10 @@ gsk_gl_driver_after_frame (GskGLDriver *self)
 
       gsk_gl_driver_autorelease_framebuffer (self, render_target->framebuffer_id);
       gsk_gl_driver_autorelease_texture (self, render_target->texture_id);
+      gsk_gpu_memory_add (GSK_GPU_MEMORY_OFFSCREENS,
+                          - (gssize) gl_format_get_n_bytes (render_target->format,
+                                                            render_target->width,
+                                                            render_target->height));
       g_free (render_target);
 
       self->render_targets->len--;
@@ -658,6 +816,36 @@ gsk_gl_driver_after_frame (GskGLDriver *self)
   g_set_object (&self->command_queue, self->shared_command_queue);
 }
 
+/**
+ * gsk_gl_driver_trim:
+ * @self: a `GskGLDriver`
+ *
+ * Releases the atlases, shadows and cached textures that are not in use
+ * by a `GdkTexture`, to free GPU memory when the system runs low on it.
+ * They are recreated when they are needed again.
+ *
+ * This must not be called while drawing a frame.
+ */
+void
+gsk_gl_driver_trim (GskGLDriver *self)
+{
+  g_return_if_fail (GSK_IS_GL_DRIVER (self));
+  g_return_if_fail (self->in_frame == FALSE);
+
+  gsk_gl_command_queue_make_current (self->command_queue);
+
+  gsk_gl_texture_library_trim (GSK_GL_TEXTURE_LIBRARY (self->icons_library));
+  gsk_gl_texture_library_trim (GSK_GL_TEXTURE_LIBRARY (self->glyphs_library));
+  gsk_gl_shadow_library_trim (self->shadows_library);
+
+  gsk_gl_driver_collect_unused_textures (self, self->current_frame_id);
+
+  /* Delete the released textures right away instead of waiting for
+   * the next frame.
+   */
+  gsk_gl_driver_after_frame (self);
+}
+
 GdkGLContext *
 gsk_gl_driver_get_context (GskGLDriver *self)
 {
@@ -703,6 +891,185 @@ gsk_gl_driver_cache_texture (GskGLDriver         *self,
     }
 }
 
+/**
+ * gsk_gl_driver_lookup_texture_by_content:
+ * @self: a `GskGLDriver`
+ * @key: the key for the texture
+ *
+ * Looks up a texture that was cached with
+ * gsk_gl_driver_cache_texture_by_content() for a render node that
+ * renders identically to the node in @key.
+ *
+ * This is much more expensive than gsk_gl_driver_lookup_texture(),
+ * as it has to compare the contents of the nodes, so it should only
+ * be used for textures which are expensive to recreate.
+ *
+ * On success, the node in @key replaces the one that the texture
+ * was cached for.
+ *
+ * Returns: a positive integer if the texture was found; otherwise 0.
+ */
+guint
+gsk_gl_driver_lookup_texture_by_content (GskGLDriver         *self,
+                                         const GskTextureKey *key)
+{
+  GskGLContentEntry *entry;
+  GskGLTexture *texture;
+  cairo_region_t *region;
+  gboolean identical;
+
+  g_assert (GSK_IS_GL_DRIVER (self));
+  g_assert (key != NULL);
+
+  entry = g_hash_table_lookup (self->content_cache, key);
+  if (entry == NULL)
+    return 0;
+
+  texture = g_hash_table_lookup (self->textures, GUINT_TO_POINTER (entry->texture_id));
+  if (texture == NULL)
+    return 0;
+
+  if (entry->key.pointer != key->pointer)
+    {
+      region = cairo_region_create ();
+      gsk_render_node_diff ((GskRenderNode *) entry->key.pointer,
+                            (GskRenderNode *) key->pointer,
+                            region);
+      identical = cairo_region_is_empty (region);
+      cairo_region_destroy (region);
+
+      if (!identical)
+        return 0;
+
+      /* Keep the most recent node, as that is the one the next
+       * frame is most likely to be compared with.
+       */
+      gsk_render_node_ref ((GskRenderNode *) key->pointer);
+      gsk_render_node_unref ((GskRenderNode *) entry->key.pointer);
+      entry->key.pointer = key->pointer;
+    }
+
+  texture->last_used_in_frame = self->current_frame_id;
+
+  return entry->texture_id;
+}
+
+/**
+ * gsk_gl_driver_cache_texture_by_content:
+ * @self: a `GskGLDriver`
+ * @key: the key for the texture
+ * @texture_id: the id of the texture to be cached
+ *
+ * Makes @texture_id available to gsk_gl_driver_lookup_texture_by_content()
+ * for render nodes that render identically to the node in @key.
+ *
+ * The render node in @key is kept alive until the texture is purged
+ * from the texture cache.
+ */
+void
+gsk_gl_driver_cache_texture_by_content (GskGLDriver         *self,
+                                        const GskTextureKey *key,
+                                        guint                texture_id)
+{
+  GskGLContentEntry *entry;
+  GskGLTexture *texture;
+  gsize size;
+
+  g_assert (GSK_IS_GL_DRIVER (self));
+  g_assert (key != NULL);
+  g_assert (texture_id > 0);
+
+  texture = g_hash_table_lookup (self->textures, GUINT_TO_POINTER (texture_id));
+  g_assert (texture != NULL);
+
+  if (g_hash_table_contains (self->texture_id_to_content, GUINT_TO_POINTER (texture_id)))
+    return;
+
+  /* Replace any older entry for a node of the same shape */
+  entry = g_hash_table_lookup (self->content_cache, key);
+  if (entry != NULL)
+    remove_content_entry_for_id (self, entry->texture_id);
+
+  size = (gsize) texture->width * texture->height * 4;
+  if (self->content_cache_size + size > MAX_CONTENT_CACHE_SIZE)
+    return;
+
+  entry = g_new0 (GskGLContentEntry, 1);
+  entry->key = *key;
+  entry->texture_id = texture_id;
+  entry->size = size;
+  gsk_render_node_ref ((GskRenderNode *) key->pointer);
+
+  self->content_cache_size += size;
+  g_hash_table_add (self->content_cache, entry);
+  g_hash_table_insert (self->texture_id_to_content, GUINT_TO_POINTER (texture_id), entry);
+}
+
+/**
+ * gsk_gl_driver_lookup_mask:
+ * @self: a `GskGLDriver`
+ * @hash: the content hash of the mask
+ *
+ * Looks up a mask texture that was cached with
+ * gsk_gl_driver_cache_mask().
+ *
+ * Returns: a positive integer if the texture was found; otherwise 0.
+ */
+guint
+gsk_gl_driver_lookup_mask (GskGLDriver *self,
+                           guint64      hash)
+{
+  gpointer id;
+
+  g_assert (GSK_IS_GL_DRIVER (self));
+
+  if (g_hash_table_lookup_extended (self->mask_cache, &hash, NULL, &id))
+    {
+      GskGLTexture *texture = g_hash_table_lookup (self->textures, id);
+
+      if (texture != NULL)
+        texture->last_used_in_frame = self->current_frame_id;
+
+      return GPOINTER_TO_UINT (id);
+    }
+
+  return 0;
+}
+
+/**
+ * gsk_gl_driver_cache_mask:
+ * @self: a `GskGLDriver`
+ * @hash: the content hash of the mask
+ * @texture_id: the id of the texture to be cached
+ *
+ * Inserts @texture_id into the mask cache, so that it can be
+ * found with gsk_gl_driver_lookup_mask().
+ *
+ * Unlike the texture cache, which is keyed by render node, masks
+ * are found by content, so that the coverage of a path only needs
+ * to be computed once, even if the nodes using it are recreated.
+ * Masks are purged along with the texture cache.
+ */
+void
+gsk_gl_driver_cache_mask (GskGLDriver *self,
+                          guint64      hash,
+                          guint        texture_id)
+{
+  guint64 *k;
+
+  g_assert (GSK_IS_GL_DRIVER (self));
+  g_assert (texture_id > 0);
+  g_assert (g_hash_table_contains (self->textures, GUINT_TO_POINTER (texture_id)));
+
+  if (g_hash_table_contains (self->mask_cache, &hash) ||
+      g_hash_table_contains (self->texture_id_to_mask, GUINT_TO_POINTER (texture_id)))
+    return;
+
+  k = g_memdup2 (&hash, sizeof hash);
+  g_hash_table_insert (self->mask_cache, k, GUINT_TO_POINTER (texture_id));
+  g_hash_table_insert (self->texture_id_to_mask, GUINT_TO_POINTER (texture_id), k);
+}
+
 /**
  * gsk_gl_driver_load_texture:
  * @self: a `GdkTexture`
@@ -754,6 +1121,7 @@ gsk_gl_driver_load_texture (GskGLDriver *self,
           glBindTexture (GL_TEXTURE_2D, t->texture_id);
           glGenerateMipmap (GL_TEXTURE_2D);
           t->has_mipmap = TRUE;
+          gsk_gl_texture_set_n_bytes (t, t->n_bytes + t->n_bytes / 3);
         }
 
       return t->texture_id;
@@ -772,6 +1140,27 @@ gsk_gl_driver_load_texture (GskGLDriver *self,
           return gdk_gl_texture_get_id (gl_texture);
         }
     }
+  else if (GDK_IS_COMPRESSED_TEXTURE (texture) && !ensure_mipmap)
+    {
+      /* glGenerateMipmap() doesn't work on compressed textures, so
+       * those go through the decompressing download below.
+       */
+      int id = gsk_gl_command_queue_upload_compressed_texture (self->command_queue,
+                                                               GDK_COMPRESSED_TEXTURE (texture));
+      if (id > 0)
+        texture_id = id;
+    }
+  else if (GDK_IS_DMABUF_TEXTURE (texture) &&
+           gdk_memory_format_alpha (gdk_texture_get_format (texture)) != GDK_MEMORY_ALPHA_STRAIGHT)
+    {
+      /* Import the dmabuf directly instead of going through system memory.
+       * The texture id is owned by the GskGLTexture below and freed with it.
+       */
+      texture_id = gdk_gl_context_import_dmabuf (context,
+                                                 gdk_texture_get_width (texture),
+                                                 gdk_texture_get_height (texture),
+                                                 gdk_dmabuf_texture_get_dmabuf (GDK_DMABUF_TEXTURE (texture)));
+    }
 
   if (texture_id == 0)
     {
@@ -791,11 +1180,15 @@ gsk_gl_driver_load_texture (GskGLDriver *self,
   t = gsk_gl_texture_new (texture_id,
                           width, height,
                           self->current_frame_id);
+  /* Imported dmabufs are allocated by their producer */
+  if (!GDK_IS_DMABUF_TEXTURE (texture) || downloaded_texture != NULL)
+    gsk_gl_texture_set_n_bytes (t, (gsize) width * height * gdk_memory_format_bytes_per_pixel (gdk_texture_get_format (texture)));
   if (ensure_mipmap)
     {
       glBindTexture (GL_TEXTURE_2D, t->texture_id);
       glGenerateMipmap (GL_TEXTURE_2D);
       t->has_mipmap = TRUE;
+      gsk_gl_texture_set_n_bytes (t, t->n_bytes + t->n_bytes / 3);
     }
 
   g_hash_table_insert (self->textures, GUINT_TO_POINTER (texture_id), t);
@@ -847,6 +1240,7 @@ gsk_gl_driver_create_texture (GskGLDriver *self,
   texture = gsk_gl_texture_new (texture_id,
                                 width, height,
                                 self->current_frame_id);
+  gsk_gl_texture_set_n_bytes (texture, gl_format_get_n_bytes (format, width, height));
   g_hash_table_insert (self->textures,
                        GUINT_TO_POINTER (texture->texture_id),
                        texture);
@@ -952,6 +1346,8 @@ gsk_gl_driver_create_render_target (GskGLDriver        *self,
       render_target->framebuffer_id = framebuffer_id;
       render_target->texture_id = texture_id;
 
+      gsk_gpu_memory_add (GSK_GPU_MEMORY_OFFSCREENS, gl_format_get_n_bytes (format, width, height));
+
       *out_render_target = render_target;
 
       return TRUE;
@@ -1007,6 +1403,10 @@ gsk_gl_driver_release_render_target (GskGLDriver       *self,
                                      render_target->width,
                                      render_target->height,
                                      self->current_frame_id);
+      gsk_gl_texture_set_n_bytes (texture, gl_format_get_n_bytes (render_target->format,
+                                                                  render_target->width,
+                                                                  render_target->height));
+      gsk_gpu_memory_add (GSK_GPU_MEMORY_OFFSCREENS, - (gssize) texture->n_bytes);
       g_hash_table_insert (self->textures,
                            GUINT_TO_POINTER (texture_id),
                            g_steal_pointer (&texture));
@@ -1536,6 +1936,7 @@ gsk_gl_driver_add_texture_slices (GskGLDriver        *self,
                           tex_width, tex_height,
                           self->current_frame_id);
   t->has_mipmap = ensure_mipmap;
+  gsk_gl_texture_set_n_bytes (t, (gsize) tex_width * tex_height * gdk_memory_format_bytes_per_pixel (gdk_texture_get_format (texture)));
 
   /* Use gsk_gl_texture_free() as destroy notify here since we are
    * not inserting this GskGLTexture into self->textures!
@@ -1602,7 +2003,8 @@ create_texture_from_texture_destroy (gpointer data)
 
 GdkTexture *
 gsk_gl_driver_create_gdk_texture (GskGLDriver *self,
-                                  guint        texture_id)
+                                  guint        texture_id,
+                                  int          format)
 {
   GskGLTextureState *state;
   GdkGLTextureBuilder *builder;
@@ -1632,6 +2034,7 @@ gsk_gl_driver_create_gdk_texture (GskGLDriver *self,
   gdk_gl_texture_builder_set_id (builder, texture_id);
   gdk_gl_texture_builder_set_width (builder, texture->width);
   gdk_gl_texture_builder_set_height (builder, texture->height);
+  gdk_gl_texture_builder_set_format (builder, memory_format_for_gl_format (format));
   gdk_gl_texture_builder_set_sync (builder, state->sync);
 
   result = gdk_gl_texture_builder_build (builder,
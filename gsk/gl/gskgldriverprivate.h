@@ -69,7 +69,9 @@ typedef struct {
 #define CONCAT_EXPANDED2(a,b) a##b
 #define GSK_GL_ADD_UNIFORM(pos, KEY, name) UNIFORM_##KEY = UNIFORM_SHARED_LAST + pos,
 #define GSK_GL_DEFINE_PROGRAM(name, resource, uniforms) enum { uniforms };
+#define GSK_GL_DEFINE_INSTANCED_PROGRAM GSK_GL_DEFINE_PROGRAM
 # include "gskglprograms.defs"
+#undef GSK_GL_DEFINE_INSTANCED_PROGRAM
 #undef GSK_GL_DEFINE_PROGRAM
 #undef GSK_GL_ADD_UNIFORM
 #undef GSK_GL_NO_UNIFORMS
@@ -105,6 +107,13 @@ struct _GskGLDriver
   GHashTable *key_to_texture_id;
   GHashTable *texture_id_to_key;
 
+  GHashTable *content_cache;
+  GHashTable *texture_id_to_content;
+  gsize content_cache_size;
+
+  GHashTable *mask_cache;
+  GHashTable *texture_id_to_mask;
+
   GHashTable *shader_cache;
 
   GArray *autorelease_framebuffers;
@@ -116,9 +125,11 @@ struct _GskGLDriver
   GskGLProgram *name ## _no_clip; \
   GskGLProgram *name ## _rect_clip; \
   GskGLProgram *name;
+#define GSK_GL_DEFINE_INSTANCED_PROGRAM GSK_GL_DEFINE_PROGRAM
 # include "gskglprograms.defs"
 #undef GSK_GL_NO_UNIFORMS
 #undef GSK_GL_ADD_UNIFORM
+#undef GSK_GL_DEFINE_INSTANCED_PROGRAM
 #undef GSK_GL_DEFINE_PROGRAM
 
   gint64 current_frame_id;
@@ -148,11 +159,23 @@ void                gsk_gl_driver_begin_frame            (GskGLDriver         *s
                                                           GskGLCommandQueue   *command_queue);
 void                gsk_gl_driver_end_frame              (GskGLDriver         *self);
 void                gsk_gl_driver_after_frame            (GskGLDriver         *self);
+void                gsk_gl_driver_trim                   (GskGLDriver         *self);
 GdkTexture        * gsk_gl_driver_create_gdk_texture     (GskGLDriver         *self,
-                                                          guint                texture_id);
+                                                          guint                texture_id,
+                                                          int                  format);
 void                gsk_gl_driver_cache_texture          (GskGLDriver         *self,
                                                           const GskTextureKey *key,
                                                           guint                texture_id);
+guint               gsk_gl_driver_lookup_texture_by_content (GskGLDriver         *self,
+                                                             const GskTextureKey *key);
+void                gsk_gl_driver_cache_texture_by_content  (GskGLDriver         *self,
+                                                             const GskTextureKey *key,
+                                                             guint                texture_id);
+guint               gsk_gl_driver_lookup_mask            (GskGLDriver         *self,
+                                                          guint64              hash);
+void                gsk_gl_driver_cache_mask             (GskGLDriver         *self,
+                                                          guint64              hash,
+                                                          guint                texture_id);
 guint               gsk_gl_driver_load_texture           (GskGLDriver         *self,
                                                           GdkTexture          *texture,
                                                           gboolean             ensure_mipmap);
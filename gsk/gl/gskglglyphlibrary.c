@@ -29,9 +29,17 @@
 #include "gskglglyphlibraryprivate.h"
 
 #include "gskdebugprivate.h"
+#include "gskglyphtileprivate.h"
 
 #define MAX_GLYPH_SIZE 128
 
+/* Glyphs of fonts that are at least SDF_MIN_SIZE pixels high on screen
+ * are drawn from a single distance field, in which the font is
+ * SDF_SIZE texels high.
+ */
+#define SDF_MIN_SIZE 48
+#define SDF_SIZE 64
+
 G_DEFINE_TYPE (GskGLGlyphLibrary, gsk_gl_glyph_library, GSK_TYPE_GL_TEXTURE_LIBRARY)
 
 GskGLGlyphLibrary *
@@ -60,6 +68,7 @@ gsk_gl_glyph_key_hash (gconstpointer data)
          key->glyph ^
          (key->xshift << 24) ^
          (key->yshift << 26) ^
+         (key->sdf << 28) ^
          key->scale;
 }
 
@@ -144,24 +153,11 @@ gsk_gl_glyph_library_init_atlas (GskGLTextureLibrary *self,
 }
 
 
-static void
-gsk_gl_glyph_library_finalize (GObject *object)
-{
-  GskGLGlyphLibrary *self = (GskGLGlyphLibrary *)object;
-
-  g_clear_pointer (&self->surface_data, g_free);
-
-  G_OBJECT_CLASS (gsk_gl_glyph_library_parent_class)->finalize (object);
-}
-
 static void
 gsk_gl_glyph_library_class_init (GskGLGlyphLibraryClass *klass)
 {
-  GObjectClass *object_class = G_OBJECT_CLASS (klass);
   GskGLTextureLibraryClass *library_class = GSK_GL_TEXTURE_LIBRARY_CLASS (klass);
 
-  object_class->finalize = gsk_gl_glyph_library_finalize;
-
   library_class->clear_cache = gsk_gl_glyph_library_clear_cache;
   library_class->init_atlas = gsk_gl_glyph_library_init_atlas;
 }
@@ -179,66 +175,6 @@ gsk_gl_glyph_library_init (GskGLGlyphLibrary *self)
                                     gsk_gl_glyph_value_free);
 }
 
-static cairo_surface_t *
-gsk_gl_glyph_library_create_surface (GskGLGlyphLibrary *self,
-                                     int                stride,
-                                     int                width,
-                                     int                height,
-                                     int                uwidth,
-                                     int                uheight)
-{
-  cairo_surface_t *surface;
-  gsize n_bytes;
-
-  g_assert (GSK_IS_GL_GLYPH_LIBRARY (self));
-  g_assert (width > 0);
-  g_assert (height > 0);
-
-  n_bytes = stride * height;
-
-  if G_LIKELY (n_bytes > self->surface_data_len)
-    {
-      self->surface_data = g_realloc (self->surface_data, n_bytes);
-      self->surface_data_len = n_bytes;
-    }
-
-  memset (self->surface_data, 0, n_bytes);
-  surface = cairo_image_surface_create_for_data (self->surface_data,
-                                                 CAIRO_FORMAT_ARGB32,
-                                                 width, height, stride);
-  cairo_surface_set_device_scale (surface, width / (double)uwidth, height / (double)uheight);
-
-  return surface;
-}
-
-static void
-render_glyph (cairo_surface_t           *surface,
-              const GskGLGlyphKey       *key,
-              const GskGLGlyphValue     *value)
-{
-  cairo_t *cr;
-  PangoGlyphString glyph_string;
-  PangoGlyphInfo glyph_info;
-
-  g_assert (surface != NULL);
-
-  cr = cairo_create (surface);
-  cairo_set_source_rgba (cr, 1, 1, 1, 1);
-
-  glyph_info.glyph = key->glyph;
-  glyph_info.geometry.width = value->ink_rect.width * 1024;
-  glyph_info.geometry.x_offset = (0.25 * key->xshift - value->ink_rect.x) * 1024;
-  glyph_info.geometry.y_offset = (0.25 * key->yshift - value->ink_rect.y) * 1024;
-
-  glyph_string.num_glyphs = 1;
-  glyph_string.glyphs = &glyph_info;
-
-  pango_cairo_show_glyph_string (cr, key->font, &glyph_string);
-  cairo_destroy (cr);
-
-  cairo_surface_flush (surface);
-}
-
 static void
 gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
                                    const GskGLGlyphKey   *key,
@@ -246,13 +182,11 @@ gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
                                    int                    packed_x,
                                    int                    packed_y,
                                    int                    width,
-                                   int                    height,
-                                   int                    uwidth,
-                                   int                    uheight)
+                                   int                    height)
 {
   GskGLTextureLibrary *tl = (GskGLTextureLibrary *)self;
   G_GNUC_UNUSED gint64 start_time = GDK_PROFILER_CURRENT_TIME;
-  cairo_surface_t *surface;
+  GskGlyphTile *tile;
   guchar *pixel_data;
   guchar *free_data = NULL;
   guint gl_format;
@@ -264,25 +198,40 @@ gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
   g_assert (key != NULL);
   g_assert (value != NULL);
 
-  stride = cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, width);
-
   gdk_gl_context_push_debug_group_printf (gdk_gl_context_get_current (),
                                           "Uploading glyph %d",
                                           key->glyph);
 
-  surface = gsk_gl_glyph_library_create_surface (self, stride, width, height, uwidth, uheight);
-  render_glyph (surface, key, value);
+  tile = gsk_glyph_tile_lookup_phased (key->font,
+                                       key->glyph,
+                                       &value->ink_rect,
+                                       key->xshift,
+                                       key->yshift,
+                                       key->scale);
+  g_assert (tile->key.width == width && tile->key.height == height);
+  stride = tile->stride;
 
   texture_id = GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (value);
 
   g_assert (texture_id > 0);
 
-  if G_UNLIKELY (gdk_gl_context_get_use_es (gdk_gl_context_get_current ()))
+  if (key->sdf)
+    {
+      /* The same value goes into all channels, so the byte order
+       * does not matter.
+       */
+      pixel_data = free_data = g_malloc (width * height * 4);
+      stride = width * 4;
+      gsk_glyph_tile_compute_sdf (tile, GSK_GL_GLYPH_SDF_SPREAD, pixel_data, stride);
+      gl_format = GL_RGBA;
+      gl_type = GL_UNSIGNED_BYTE;
+    }
+  else if G_UNLIKELY (gdk_gl_context_get_use_es (gdk_gl_context_get_current ()))
     {
       pixel_data = free_data = g_malloc (width * height * 4);
       gdk_memory_convert (pixel_data, width * 4,
                           GDK_MEMORY_R8G8B8A8_PREMULTIPLIED,
-                          cairo_image_surface_get_data (surface),
+                          tile->data,
                           stride,
                           GDK_MEMORY_DEFAULT,
                           width, height);
@@ -292,7 +241,7 @@ gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
     }
   else
     {
-      pixel_data = cairo_image_surface_get_data (surface);
+      pixel_data = tile->data;
       gl_format = GL_BGRA;
       gl_type = GL_UNSIGNED_INT_8_8_8_8_REV;
     }
@@ -366,7 +315,7 @@ gsk_gl_glyph_library_upload_glyph (GskGLGlyphLibrary     *self,
   glPixelStorei (GL_UNPACK_ROW_LENGTH, 0);
   glPixelStorei (GL_UNPACK_SKIP_ROWS, 0);
 
-  cairo_surface_destroy (surface);
+  gsk_glyph_tile_unref (tile);
   g_free (free_data);
 
   gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
@@ -398,13 +347,18 @@ gsk_gl_glyph_library_add (GskGLGlyphLibrary      *self,
   g_assert (key != NULL);
   g_assert (out_value != NULL);
 
-  pango_font_get_glyph_extents (key->font, key->glyph, &ink_rect, NULL);
-  pango_extents_to_pixels (&ink_rect, NULL);
+  gsk_glyph_tile_get_ink_rect (key->font, key->glyph, &ink_rect);
 
-  ink_rect.x -= 1;
-  ink_rect.width += 2;
-  ink_rect.y -= 1;
-  ink_rect.height += 2;
+  if (key->sdf && key->scale > 0)
+    {
+      /* Make room for the distance field around the outline */
+      int pad = ceil (GSK_GL_GLYPH_SDF_SPREAD * 1024.0 / key->scale);
+
+      ink_rect.x -= pad;
+      ink_rect.width += 2 * pad;
+      ink_rect.y -= pad;
+      ink_rect.height += 2 * pad;
+    }
 
   width = (int) ceil (ink_rect.width * key->scale / 1024.0);
   height = (int) ceil (ink_rect.height * key->scale / 1024.0);
@@ -428,11 +382,47 @@ gsk_gl_glyph_library_add (GskGLGlyphLibrary      *self,
                                        packed_x,
                                        packed_y,
                                        width,
-                                       height,
-                                       ink_rect.width,
-                                       ink_rect.height);
+                                       height);
 
   *out_value = value;
 
   return GSK_GL_TEXTURE_ATLAS_ENTRY_TEXTURE (value) != 0;
 }
+
+/**
+ * gsk_gl_glyph_library_get_sdf_scale:
+ * @self: a `GskGLGlyphLibrary`
+ * @font: the font to draw with
+ * @scale: the scale that text is drawn at
+ * @sdf_scale: (out): return location for the scale of the distance
+ *   field to use in the glyph key, times 1024
+ *
+ * Checks whether text in @font is large enough at @scale to be
+ * drawn from distance fields. Distance fields are rendered at a
+ * fixed size per font, so one atlas entry serves all scales.
+ *
+ * Returns: %TRUE if distance fields should be used
+ */
+gboolean
+gsk_gl_glyph_library_get_sdf_scale (GskGLGlyphLibrary *self,
+                                    PangoFont         *font,
+                                    float              scale,
+                                    guint             *sdf_scale)
+{
+  PangoFontMetrics *metrics;
+  float height;
+
+  g_assert (GSK_IS_GL_GLYPH_LIBRARY (self));
+
+  metrics = pango_font_get_metrics (font, NULL);
+  height = (float) (pango_font_metrics_get_ascent (metrics) +
+                    pango_font_metrics_get_descent (metrics)) / PANGO_SCALE;
+  pango_font_metrics_unref (metrics);
+
+  if (height <= 0 || height * scale < SDF_MIN_SIZE)
+    return FALSE;
+
+  *sdf_scale = (guint) ceil (SDF_SIZE * 1024 / height);
+
+  return *sdf_scale < (1 << 27);
+}
@@ -34,9 +34,13 @@ typedef struct _GskGLGlyphKey
   PangoGlyph glyph;
   guint xshift : 2;
   guint yshift : 2;
-  guint scale  : 28; /* times 1024 */
+  guint sdf    : 1; /* scale is the scale of the distance field */
+  guint scale  : 27; /* times 1024 */
 } GskGLGlyphKey;
 
+/* How far, in texels, distance fields extend beyond the outline */
+#define GSK_GL_GLYPH_SDF_SPREAD 6
+
 typedef struct _GskGLGlyphValue
 {
   GskGLTextureAtlasEntry entry;
@@ -54,8 +58,6 @@ G_DECLARE_FINAL_TYPE (GskGLGlyphLibrary, gsk_gl_glyph_library, GSK, GL_GLYPH_LIB
 struct _GskGLGlyphLibrary
 {
   GskGLTextureLibrary parent_instance;
-  guint8 *surface_data;
-  gsize surface_data_len;
   struct {
     GskGLGlyphKey key;
     const GskGLGlyphValue *value;
@@ -66,6 +68,11 @@ GskGLGlyphLibrary *gsk_gl_glyph_library_new (GskGLDriver            *driver);
 gboolean           gsk_gl_glyph_library_add (GskGLGlyphLibrary      *self,
                                              GskGLGlyphKey          *key,
                                              const GskGLGlyphValue **out_value);
+gboolean           gsk_gl_glyph_library_get_sdf_scale
+                                            (GskGLGlyphLibrary      *self,
+                                             PangoFont              *font,
+                                             float                   scale,
+                                             guint                  *sdf_scale);
 
 static inline guint
 gsk_gl_glyph_library_lookup_or_add (GskGLGlyphLibrary      *self,
@@ -56,6 +56,7 @@ gsk_gl_program_finalize (GObject *object)
                self->name ? self->name : "");
 
   g_clear_pointer (&self->name, g_free);
+  g_clear_object (&self->instanced);
   g_clear_object (&self->driver);
 
   G_OBJECT_CLASS (gsk_gl_program_parent_class)->finalize (object);
@@ -136,7 +137,7 @@ gsk_gl_program_add_uniform (GskGLProgram *self,
  * gsk_gl_program_delete:
  * @self: a `GskGLProgram`
  *
- * Deletes the GLSL program.
+ * Deletes the GLSL program, along with its instanced variant.
  */
 void
 gsk_gl_program_delete (GskGLProgram *self)
@@ -146,6 +147,12 @@ gsk_gl_program_delete (GskGLProgram *self)
 
   gsk_gl_command_queue_delete_program (self->driver->command_queue, self->id);
   self->id = -1;
+
+  if (self->instanced)
+    {
+      gsk_gl_program_delete (self->instanced);
+      g_clear_object (&self->instanced);
+    }
 }
 
 /**
@@ -49,6 +49,9 @@ struct _GskGLProgram
   /* Static array for key->location transforms */
   GskGLUniformMapping mappings[32];
   guint n_mappings;
+
+  /* The variant drawing one GskGLDrawInstance per quad, if any */
+  GskGLProgram *instanced;
 };
 
 GskGLProgram * gsk_gl_program_new            (GskGLDriver  *driver,
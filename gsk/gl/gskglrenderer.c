@@ -179,6 +179,17 @@ gsk_gl_renderer_unrealize (GskRenderer *renderer)
   g_clear_object (&self->context);
 }
 
+static void
+gsk_gl_renderer_trim (GskRenderer *renderer)
+{
+  GskGLRenderer *self = (GskGLRenderer *)renderer;
+
+  g_assert (GSK_IS_GL_RENDERER (renderer));
+
+  if (self->driver != NULL)
+    gsk_gl_driver_trim (self->driver);
+}
+
 static cairo_region_t *
 get_render_region (GdkSurface   *surface,
                    GdkGLContext *context)
@@ -310,6 +321,10 @@ gsk_gl_renderer_render (GskRenderer          *renderer,
 #ifdef G_ENABLE_DEBUG
   if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), FALLBACK))
     gsk_gl_render_job_set_debug_fallback (job, TRUE);
+  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), SDF_GLYPHS))
+    gsk_gl_render_job_set_sdf_glyphs (job, TRUE);
+  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), REORDER_BATCHES))
+    gsk_gl_render_job_set_reorder_batches (job, TRUE);
 #endif
   gsk_gl_render_job_render (job, root);
   gsk_gl_driver_end_frame (self->driver);
@@ -322,6 +337,49 @@ gsk_gl_renderer_render (GskRenderer          *renderer,
   cairo_region_destroy (render_region);
 }
 
+static int
+gsk_gl_renderer_get_texture_format (GskGLRenderer *self,
+                                    GskRenderNode *root)
+{
+  if (!gdk_gl_context_check_version (self->context, "3.0", "3.0"))
+    return GL_RGBA8;
+
+  /* Half floats are enough for half float content, and downloading
+   * them doesn't need a conversion to and from 32 bit floats.
+   */
+  switch (gsk_render_node_get_preferred_depth (root))
+    {
+    case GDK_MEMORY_U8:
+      return GL_RGBA8;
+    case GDK_MEMORY_FLOAT16:
+      return GL_RGBA16F;
+    case GDK_MEMORY_U16:
+    case GDK_MEMORY_FLOAT32:
+    default:
+      return GL_RGBA32F;
+    }
+}
+
+static GskGLRenderJob *
+gsk_gl_renderer_create_texture_job (GskGLRenderer         *self,
+                                    const graphene_rect_t *viewport,
+                                    GskGLRenderTarget     *render_target)
+{
+  GskGLRenderJob *job;
+
+  job = gsk_gl_render_job_new (self->driver, viewport, 1, NULL, render_target->framebuffer_id, TRUE);
+#ifdef G_ENABLE_DEBUG
+  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), FALLBACK))
+    gsk_gl_render_job_set_debug_fallback (job, TRUE);
+  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), SDF_GLYPHS))
+    gsk_gl_render_job_set_sdf_glyphs (job, TRUE);
+  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), REORDER_BATCHES))
+    gsk_gl_render_job_set_reorder_batches (job, TRUE);
+#endif
+
+  return job;
+}
+
 static GdkTexture *
 gsk_gl_renderer_render_texture (GskRenderer           *renderer,
                                 GskRenderNode         *root,
@@ -373,11 +431,7 @@ gsk_gl_renderer_render_texture (GskRenderer           *renderer,
       return texture;
     }
 
-  if (gsk_render_node_get_preferred_depth (root) != GDK_MEMORY_U8 &&
-      gdk_gl_context_check_version (self->context, "3.0", "3.0"))
-    format = GL_RGBA32F;
-  else 
-    format = GL_RGBA8;
+  format = gsk_gl_renderer_get_texture_format (self, root);
 
   gdk_gl_context_make_current (self->context);
 
@@ -387,14 +441,10 @@ gsk_gl_renderer_render_texture (GskRenderer           *renderer,
                                           &render_target))
     {
       gsk_gl_driver_begin_frame (self->driver, self->command_queue);
-      job = gsk_gl_render_job_new (self->driver, viewport, 1, NULL, render_target->framebuffer_id, TRUE);
-#ifdef G_ENABLE_DEBUG
-      if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), FALLBACK))
-        gsk_gl_render_job_set_debug_fallback (job, TRUE);
-#endif
+      job = gsk_gl_renderer_create_texture_job (self, viewport, render_target);
       gsk_gl_render_job_render_flipped (job, root);
       texture_id = gsk_gl_driver_release_render_target (self->driver, render_target, FALSE);
-      texture = gsk_gl_driver_create_gdk_texture (self->driver, texture_id);
+      texture = gsk_gl_driver_create_gdk_texture (self->driver, texture_id, format);
       gsk_gl_driver_end_frame (self->driver);
       gsk_gl_render_job_free (job);
 
@@ -408,6 +458,101 @@ gsk_gl_renderer_render_texture (GskRenderer           *renderer,
   return g_steal_pointer (&texture);
 }
 
+/* Limits how much memory the render targets of a single batch in
+ * gsk_gl_renderer_render_textures() may use, in pixels.
+ */
+#define MAX_BATCH_PIXELS (4096 * 4096)
+
+/* Builds the commands for as many nodes as fit into a batch and executes
+ * them together, so that all of them share a single frame and a single
+ * submission to the GPU.
+ */
+static void
+gsk_gl_renderer_render_textures (GskRenderer            *renderer,
+                                 GskRenderNode         **roots,
+                                 const graphene_rect_t  *viewports,
+                                 gsize                   n_roots,
+                                 GdkTexture            **textures)
+{
+  GskGLRenderer *self = (GskGLRenderer *)renderer;
+  GskGLRenderTarget **render_targets;
+  int max_size;
+  gsize i, j;
+
+  g_assert (GSK_IS_GL_RENDERER (renderer));
+
+  max_size = self->command_queue->max_texture_size;
+
+  /* Nodes that need to be tiled are rendered on their own */
+  for (i = 0; i < n_roots; i++)
+    {
+      if (ceilf (viewports[i].size.width) > max_size ||
+          ceilf (viewports[i].size.height) > max_size)
+        textures[i] = gsk_gl_renderer_render_texture (renderer, roots[i], &viewports[i]);
+      else
+        textures[i] = NULL;
+    }
+
+  render_targets = g_new0 (GskGLRenderTarget *, n_roots);
+
+  gdk_gl_context_make_current (self->context);
+
+  i = 0;
+  while (i < n_roots)
+    {
+      gsize first = i;
+      gsize n_pixels = 0;
+
+      gsk_gl_driver_begin_frame (self->driver, self->command_queue);
+
+      for (; i < n_roots && n_pixels < MAX_BATCH_PIXELS; i++)
+        {
+          GskGLRenderJob *job;
+          int width, height;
+
+          if (textures[i] != NULL)
+            continue;
+
+          width = ceilf (viewports[i].size.width);
+          height = ceilf (viewports[i].size.height);
+
+          if (!gsk_gl_driver_create_render_target (self->driver,
+                                                   width, height,
+                                                   gsk_gl_renderer_get_texture_format (self, roots[i]),
+                                                   &render_targets[i]))
+            g_assert_not_reached ();
+
+          job = gsk_gl_renderer_create_texture_job (self, &viewports[i], render_targets[i]);
+          gsk_gl_render_job_prepare_flipped (job, roots[i]);
+          gsk_gl_render_job_free (job);
+
+          n_pixels += (gsize) width * height;
+        }
+
+      gdk_gl_context_push_debug_group (self->context, "Executing command queue");
+      gsk_gl_command_queue_execute (self->command_queue, 0, 1, NULL, 0);
+      gdk_gl_context_pop_debug_group (self->context);
+
+      for (j = first; j < i; j++)
+        {
+          guint texture_id;
+          int format;
+
+          if (render_targets[j] == NULL)
+            continue;
+
+          format = render_targets[j]->format;
+          texture_id = gsk_gl_driver_release_render_target (self->driver, render_targets[j], FALSE);
+          textures[j] = gsk_gl_driver_create_gdk_texture (self->driver, texture_id, format);
+        }
+
+      gsk_gl_driver_end_frame (self->driver);
+      gsk_gl_driver_after_frame (self->driver);
+    }
+
+  g_free (render_targets);
+}
+
 static void
 gsk_gl_renderer_dispose (GObject *object)
 {
@@ -432,6 +577,8 @@ gsk_gl_renderer_class_init (GskGLRendererClass *klass)
   renderer_class->unrealize = gsk_gl_renderer_unrealize;
   renderer_class->render = gsk_gl_renderer_render;
   renderer_class->render_texture = gsk_gl_renderer_render_texture;
+  renderer_class->render_textures = gsk_gl_renderer_render_textures;
+  renderer_class->trim = gsk_gl_renderer_trim;
 }
 
 static void
@@ -23,9 +23,12 @@
 
 #include "config.h"
 
+#include <gdk/gdkdebugprivate.h>
 #include <gdk/gdkglcontextprivate.h>
+#include <gdk/gdkparalleltaskprivate.h>
 #include <gdk/gdkprofilerprivate.h>
 #include <gdk/gdkrgbaprivate.h>
+#include <gsk/gskenumtypes.h>
 #include <gsk/gskrendernodeprivate.h>
 #include <gsk/gskglshaderprivate.h>
 #include <gdk/gdktextureprivate.h>
@@ -77,6 +80,17 @@ typedef struct _GskGLRenderModelview
   graphene_matrix_t matrix;
 } GskGLRenderModelview;
 
+typedef struct _GskGLNodeCost
+{
+  guint draws;
+  guint vertices;
+  guint offscreens;
+  guint uploads;
+  guint program_switches;
+} GskGLNodeCost;
+
+#define N_NODE_COST_TYPES (GSK_STROKE_NODE + 1)
+
 struct _GskGLRenderJob
 {
   /* The context containing the framebuffer we are drawing to. Generally this
@@ -145,6 +159,14 @@ struct _GskGLRenderJob
   /* If we should be rendering red zones over fallback nodes */
   guint debug_fallback : 1;
 
+  /* If large text should be drawn from distance fields */
+  guint sdf_glyphs : 1;
+
+  /* If the bounds of quads are reported to the command queue,
+   * so it can reorder batches.
+   */
+  guint reorder_batches : 1;
+
   /* In some cases we might want to avoid clearing the framebuffer
    * because we're going to render over the existing contents.
    */
@@ -154,8 +176,44 @@ struct _GskGLRenderJob
    * looking at the format of the framebuffer we are rendering on.
    */
   int target_format;
+
+  /* Format for offscreens that need more than 8 bits, this is at least
+   * the target format, and half floats in high depth mode.
+   */
+  int offscreen_format;
+
+  /* If GDK_DEBUG=high-depth is set, we never drop to 8 bit offscreens */
+  guint high_depth : 1;
+
+  /* Fallback nodes that have been rasterized ahead of time by worker
+   * threads, mapping GskRenderNode to GskGLPrerendered.
+   */
+  GHashTable *prerendered;
+
+#ifdef G_ENABLE_DEBUG
+  /* Costs of the frame by node type, indexed by GskRenderNodeType.
+   * Only collected when the command queue has a profiler.
+   */
+  GskGLNodeCost *node_costs;
+
+  /* The type of the node being visited, its own work is accounted
+   * to it, while the work of its children is accounted to theirs.
+   */
+  GskRenderNodeType cost_node_type;
+  guint cost_vertices;
+  guint cost_uploads;
+  GskGLProgram *last_program;
+#endif
 };
 
+typedef struct _GskGLPrerendered
+{
+  const GskRenderNode *node;
+  float scale_x;
+  float scale_y;
+  cairo_surface_t *surface;
+} GskGLPrerendered;
+
 typedef struct _GskGLRenderOffscreen
 {
   /* The bounds to render */
@@ -190,17 +248,126 @@ static void     gsk_gl_render_job_visit_node                (GskGLRenderJob
 static gboolean gsk_gl_render_job_visit_node_with_offscreen (GskGLRenderJob       *job,
                                                              const GskRenderNode  *node,
                                                              GskGLRenderOffscreen *offscreen);
+static void     gsk_gl_render_job_finish_prerendered        (GskGLRenderJob       *job,
+                                                             GPtrArray            *items);
 
 static inline int
 get_target_format (GskGLRenderJob      *job,
                    const GskRenderNode *node)
 {
-  if (gsk_render_node_get_preferred_depth (node) != GDK_MEMORY_U8)
-    return job->target_format;
+  if (job->high_depth ||
+      gsk_render_node_get_preferred_depth (node) != GDK_MEMORY_U8)
+    return job->offscreen_format;
 
   return GL_RGBA8;
 }
 
+/* Looks for an offscreen that was rendered for a different node with
+ * identical contents, such as a widget that snapshotted the same blurred
+ * background again.
+ */
+static inline guint
+gsk_gl_render_job_lookup_texture_by_content (GskGLRenderJob      *job,
+                                             const GskTextureKey *key)
+{
+  guint texture_id = gsk_gl_driver_lookup_texture_by_content (job->driver, key);
+
+#ifdef G_ENABLE_DEBUG
+  if (job->command_queue->profiler != NULL)
+    gsk_profiler_counter_inc (job->command_queue->profiler,
+                              texture_id != 0 ? job->command_queue->metrics.n_offscreen_hits
+                                              : job->command_queue->metrics.n_offscreen_misses);
+#endif
+
+  return texture_id;
+}
+
+#ifdef G_ENABLE_DEBUG
+static inline guint
+gsk_gl_render_job_count_vertices (GskGLRenderJob *job)
+{
+  return job->command_queue->vertices.count +
+         GSK_GL_N_VERTICES * job->command_queue->instances.count;
+}
+
+/* Called before visiting the root node, so that work queued
+ * by other jobs is not accounted to this one.
+ */
+static inline void
+gsk_gl_render_job_start_costs (GskGLRenderJob *job)
+{
+  job->cost_node_type = GSK_NOT_A_RENDER_NODE;
+  job->cost_vertices = gsk_gl_render_job_count_vertices (job);
+  job->cost_uploads = job->command_queue->n_uploads;
+}
+
+/* Adds the vertices and uploads since the last call to the costs
+ * of the node type being visited.
+ */
+static inline void
+gsk_gl_render_job_account_costs (GskGLRenderJob *job)
+{
+  GskGLNodeCost *cost;
+  guint n_vertices;
+
+  if (job->node_costs == NULL)
+    return;
+
+  cost = &job->node_costs[job->cost_node_type];
+  n_vertices = gsk_gl_render_job_count_vertices (job);
+
+  /* Vertices that were retracted after visiting a child
+   * are not taken off again.
+   */
+  if (n_vertices > job->cost_vertices)
+    cost->vertices += n_vertices - job->cost_vertices;
+  cost->uploads += job->command_queue->n_uploads - job->cost_uploads;
+
+  job->cost_vertices = n_vertices;
+  job->cost_uploads = job->command_queue->n_uploads;
+}
+
+static void
+gsk_gl_render_job_report_costs (GskGLRenderJob *job)
+{
+  GEnumClass *enum_class;
+  GString *string;
+  guint i;
+
+  if (job->node_costs == NULL)
+    return;
+
+  gsk_gl_render_job_account_costs (job);
+
+  enum_class = g_type_class_ref (GSK_TYPE_RENDER_NODE_TYPE);
+  string = g_string_new ("\nCosts by node type (draws, vertices, offscreens, uploads, program switches):\n");
+
+  for (i = 0; i < N_NODE_COST_TYPES; i++)
+    {
+      const GskGLNodeCost *cost = &job->node_costs[i];
+      GEnumValue *value;
+
+      if (cost->draws == 0 && cost->vertices == 0 && cost->offscreens == 0 &&
+          cost->uploads == 0 && cost->program_switches == 0)
+        continue;
+
+      value = g_enum_get_value (enum_class, i);
+      g_string_append_printf (string, "%s: %u, %u, %u, %u, %u\n",
+                              i == GSK_NOT_A_RENDER_NODE ? "other" : value->value_nick,
+                              cost->draws,
+                              cost->vertices,
+                              cost->offscreens,
+                              cost->uploads,
+                              cost->program_switches);
+    }
+
+  gsk_profiler_set_details (job->command_queue->profiler, string->str);
+
+  g_string_free (string, TRUE);
+  g_type_class_unref (enum_class);
+}
+#endif
+
 static inline void
 init_full_texture_region (GskGLRenderOffscreen *offscreen)
 {
@@ -956,6 +1123,34 @@ rgba_to_half (const GdkRGBA *rgba,
   float_to_half4 ((const float *)rgba, h);
 }
 
+/* The coordinates are in the space of the current modelview,
+ * with the job offset already applied.
+ */
+static inline void
+gsk_gl_render_job_add_bounds (GskGLRenderJob *job,
+                              float           min_x,
+                              float           min_y,
+                              float           max_x,
+                              float           max_y,
+                              guint           count)
+{
+  graphene_rect_t bounds;
+
+  gsk_gl_render_job_transform_bounds (job,
+                                      &GRAPHENE_RECT_INIT (min_x - job->offset_x,
+                                                           min_y - job->offset_y,
+                                                           max_x - min_x,
+                                                           max_y - min_y),
+                                      &bounds);
+
+  gsk_gl_command_queue_add_bounds (job->command_queue,
+                                   bounds.origin.x,
+                                   bounds.origin.y,
+                                   bounds.origin.x + bounds.size.width,
+                                   bounds.origin.y + bounds.size.height,
+                                   count);
+}
+
 /* fill_vertex_data */
 static void
 gsk_gl_render_job_draw_coords (GskGLRenderJob *job,
@@ -969,7 +1164,21 @@ gsk_gl_render_job_draw_coords (GskGLRenderJob *job,
                                float           max_v,
                                guint16         c[4])
 {
-  GskGLDrawVertex *vertices = gsk_gl_command_queue_add_vertices (job->command_queue);
+  GskGLDrawVertex *vertices;
+
+  if G_UNLIKELY (job->reorder_batches)
+    gsk_gl_render_job_add_bounds (job, min_x, min_y, max_x, max_y,
+                                  job->current_program->program_info->instanced ? 1 : GSK_GL_N_VERTICES);
+
+  if (job->current_program->program_info->instanced)
+    {
+      GskGLDrawInstance *instance = gsk_gl_command_queue_add_instance (job->command_queue);
+
+      *instance = (GskGLDrawInstance) { .rect = { min_x, min_y, max_x, max_y }, .uv = { min_u, min_v, max_u, max_v }, .color = { c[0], c[1], c[2], c[3] } };
+      return;
+    }
+
+  vertices = gsk_gl_command_queue_add_vertices (job->command_queue);
 
   vertices[0] = (GskGLDrawVertex) { .position = { min_x, min_y }, .uv = { min_u, min_v }, .color = { c[0], c[1], c[2], c[3] } };
   vertices[1] = (GskGLDrawVertex) { .position = { min_x, max_y }, .uv = { min_u, max_v }, .color = { c[0], c[1], c[2], c[3] } };
@@ -1081,6 +1290,12 @@ static inline gboolean
 gsk_gl_render_job_begin_draw (GskGLRenderJob *job,
                               GskGLProgram   *program)
 {
+  /* All quads of the programs that have one are drawn as plain
+   * rectangles, so we can always use the instanced variant.
+   */
+  if (program->instanced)
+    program = program->instanced;
+
   job->current_program = program;
 
   if (!gsk_gl_command_queue_begin_draw (job->command_queue,
@@ -1089,6 +1304,16 @@ gsk_gl_render_job_begin_draw (GskGLRenderJob *job,
                                         job->viewport.size.height))
     return FALSE;
 
+#ifdef G_ENABLE_DEBUG
+  if (job->node_costs != NULL)
+    {
+      job->node_costs[job->cost_node_type].draws++;
+      if (program != job->last_program)
+        job->node_costs[job->cost_node_type].program_switches++;
+      job->last_program = program;
+    }
+#endif
+
   gsk_gl_uniform_state_set4fv (program->uniforms,
                                program->program_info,
                                UNIFORM_SHARED_VIEWPORT,
@@ -1144,33 +1369,21 @@ gsk_gl_render_job_end_draw (GskGLRenderJob *job)
   job->current_program = NULL;
 }
 
-static inline void
-gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
-                                     const GskRenderNode *node)
+/* Rasterizes @node with cairo into an upside-down image surface so that
+ * it matches what GL expects. This does not touch any job or driver
+ * state, so it is safe to call from worker threads.
+ */
+static cairo_surface_t *
+render_fallback_surface (const GskRenderNode *node,
+                         float                scale_x,
+                         float                scale_y,
+                         gboolean             debug_fallback)
 {
-  float scale_x = job->scale_x;
-  float scale_y = job->scale_y;
   int surface_width = ceilf (node->bounds.size.width * fabs (scale_x));
   int surface_height = ceilf (node->bounds.size.height * fabs (scale_y));
-  GdkTexture *texture;
   cairo_surface_t *surface;
   cairo_surface_t *rendered_surface;
   cairo_t *cr;
-  int texture_id;
-  GskTextureKey key;
-
-  if (surface_width <= 0 || surface_height <= 0)
-    return;
-
-  key.pointer = node;
-  key.pointer_is_child = FALSE;
-  key.scale_x = scale_x;
-  key.scale_y = scale_y;
-
-  texture_id = gsk_gl_driver_lookup_texture (job->driver, &key);
-
-  if (texture_id != 0)
-    goto done;
 
   /* We first draw the recording surface on an image surface,
    * just because the scaleY(-1) later otherwise screws up the
@@ -1208,7 +1421,7 @@ gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
   cairo_restore (cr);
 
 #ifdef G_ENABLE_DEBUG
-  if (job->debug_fallback)
+  if (debug_fallback)
     {
       cairo_move_to (cr, 0, 0);
       cairo_rectangle (cr, 0, 0, node->bounds.size.width, node->bounds.size.height);
@@ -1226,6 +1439,53 @@ gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
 #endif
   cairo_destroy (cr);
 
+  cairo_surface_destroy (rendered_surface);
+
+  return surface;
+}
+
+static inline void
+gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
+                                     const GskRenderNode *node)
+{
+  float scale_x = job->scale_x;
+  float scale_y = job->scale_y;
+  int surface_width = ceilf (node->bounds.size.width * fabs (scale_x));
+  int surface_height = ceilf (node->bounds.size.height * fabs (scale_y));
+  GdkTexture *texture;
+  cairo_surface_t *surface = NULL;
+  int texture_id;
+  GskTextureKey key;
+
+  if (surface_width <= 0 || surface_height <= 0)
+    return;
+
+  key.pointer = node;
+  key.pointer_is_child = FALSE;
+  key.scale_x = scale_x;
+  key.scale_y = scale_y;
+
+  texture_id = gsk_gl_driver_lookup_texture (job->driver, &key);
+
+  if (texture_id != 0)
+    goto done;
+
+  /* The surface may have been rasterized already by a worker thread
+   * while preparing the children of a container node.
+   */
+  if (job->prerendered != NULL)
+    {
+      GskGLPrerendered *prerendered = g_hash_table_lookup (job->prerendered, node);
+
+      if (prerendered != NULL &&
+          prerendered->scale_x == scale_x &&
+          prerendered->scale_y == scale_y)
+        surface = g_steal_pointer (&prerendered->surface);
+    }
+
+  if (surface == NULL)
+    surface = render_fallback_surface (node, scale_x, scale_y, job->debug_fallback);
+
   /* Create texture to upload */
   texture = gdk_texture_new_for_surface (surface);
   texture_id = gsk_gl_driver_load_texture (job->driver, texture, FALSE);
@@ -1238,7 +1498,6 @@ gsk_gl_render_job_visit_as_fallback (GskGLRenderJob      *job,
 
   g_object_unref (texture);
   cairo_surface_destroy (surface);
-  cairo_surface_destroy (rendered_surface);
 
   gsk_gl_driver_cache_texture (job->driver, &key, texture_id);
 
@@ -1268,6 +1527,204 @@ out:
     gsk_gl_render_job_pop_modelview (job);
 }
 
+typedef struct
+{
+  GPtrArray *items;
+  float scale_x;
+  float scale_y;
+  gboolean debug_fallback;
+  int next_item;
+} PrerenderData;
+
+static void
+prerender_fallbacks_task (gpointer user_data)
+{
+  PrerenderData *data = user_data;
+
+  for (;;)
+    {
+      int i = g_atomic_int_add (&data->next_item, 1);
+      GskGLPrerendered *prerendered;
+
+      if (i >= (int) data->items->len)
+        break;
+
+      prerendered = g_ptr_array_index (data->items, i);
+      prerendered->surface = render_fallback_surface (prerendered->node,
+                                                      data->scale_x,
+                                                      data->scale_y,
+                                                      data->debug_fallback);
+    }
+}
+
+static void
+gsk_gl_prerendered_free (gpointer data)
+{
+  GskGLPrerendered *prerendered = data;
+
+  g_clear_pointer (&prerendered->surface, cairo_surface_destroy);
+  g_free (prerendered);
+}
+
+/* Finds the last child of a container that covers everything visible
+ * of the container with opaque pixels. Children before it would be
+ * painted over entirely, so they need not be drawn at all.
+ *
+ * Returns: the index of the first child that needs to be drawn
+ */
+static guint
+gsk_gl_render_job_get_first_visible_child (GskGLRenderJob       *job,
+                                           const GskRenderNode  *node,
+                                           GskRenderNode *const *children,
+                                           guint                 n_children)
+{
+  graphene_rect_t visible;
+
+  if (n_children < 2)
+    return 0;
+
+  /* For anything else, transformed bounds are not exact */
+  if (gsk_transform_get_category (job->current_modelview->transform) < GSK_TRANSFORM_CATEGORY_2D_AFFINE)
+    return 0;
+
+  gsk_gl_render_job_transform_bounds (job, &node->bounds, &visible);
+  if (!graphene_rect_intersection (&visible, &job->current_clip->rect.bounds, &visible))
+    return 0;
+
+  for (guint i = n_children - 1; i > 0; i--)
+    {
+      graphene_rect_t opaque, transformed_opaque;
+
+      if (!gsk_render_node_get_opaque_rect (children[i], &opaque))
+        continue;
+
+      gsk_gl_render_job_transform_bounds (job, &opaque, &transformed_opaque);
+      if (gsk_rect_contains_rect (&transformed_opaque, &visible))
+        return i;
+    }
+
+  return 0;
+}
+
+/* Whether @node ends up in gsk_gl_render_job_visit_as_fallback() and can
+ * be drawn with cairo from a worker thread. We stay away from anything
+ * that may end up drawing text, as fonts are not meant to be shared
+ * across threads.
+ */
+static inline gboolean
+node_can_prerender (const GskRenderNode *node)
+{
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_CAIRO_NODE:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/* Rasterizes the fallback children of a container node in parallel
+ * before the children are visited. Fallback rasterization only depends
+ * on the node and the current scale, both of which are identical for
+ * all direct children of the container, so it can run independently
+ * of the (single-threaded) command recording.
+ *
+ * Returns: (nullable): the prerendered children, to be passed to
+ *   gsk_gl_render_job_finish_prerendered() after visiting
+ */
+static GPtrArray *
+gsk_gl_render_job_prerender_fallbacks (GskGLRenderJob       *job,
+                                       GskRenderNode *const *children,
+                                       guint                 n_children)
+{
+  PrerenderData data;
+  GPtrArray *items = NULL;
+  float scale_x = job->scale_x;
+  float scale_y = job->scale_y;
+
+  if (n_children < 2)
+    return NULL;
+
+  for (guint i = 0; i < n_children; i++)
+    {
+      const GskRenderNode *child = children[i];
+      GskGLPrerendered *prerendered;
+      GskTextureKey key;
+
+      if (!node_can_prerender (child) ||
+          ceilf (child->bounds.size.width * fabs (scale_x)) <= 0 ||
+          ceilf (child->bounds.size.height * fabs (scale_y)) <= 0)
+        continue;
+
+      if (!job->current_clip->is_fully_contained)
+        {
+          graphene_rect_t transformed_bounds;
+
+          gsk_gl_render_job_transform_bounds (job, &child->bounds, &transformed_bounds);
+          if (!gsk_rect_intersects (&job->current_clip->rect.bounds, &transformed_bounds))
+            continue;
+        }
+
+      key.pointer = child;
+      key.pointer_is_child = FALSE;
+      key.scale_x = scale_x;
+      key.scale_y = scale_y;
+
+      if (gsk_gl_driver_lookup_texture (job->driver, &key) != 0)
+        continue;
+
+      if (job->prerendered == NULL)
+        job->prerendered = g_hash_table_new (NULL, NULL);
+      else if (g_hash_table_contains (job->prerendered, child))
+        continue;
+
+      if (items == NULL)
+        items = g_ptr_array_new_with_free_func (gsk_gl_prerendered_free);
+
+      prerendered = g_new0 (GskGLPrerendered, 1);
+      prerendered->node = child;
+      prerendered->scale_x = scale_x;
+      prerendered->scale_y = scale_y;
+      g_ptr_array_add (items, prerendered);
+      g_hash_table_insert (job->prerendered, (gpointer) child, prerendered);
+    }
+
+  if (items == NULL)
+    return NULL;
+
+  /* A single fallback is just rasterized when it is visited */
+  if (items->len < 2)
+    {
+      gsk_gl_render_job_finish_prerendered (job, items);
+      return NULL;
+    }
+
+  data.items = items;
+  data.scale_x = scale_x;
+  data.scale_y = scale_y;
+  data.debug_fallback = job->debug_fallback;
+  data.next_item = 0;
+
+  gdk_parallel_task_run (prerender_fallbacks_task, &data, items->len);
+
+  return items;
+}
+
+static void
+gsk_gl_render_job_finish_prerendered (GskGLRenderJob *job,
+                                      GPtrArray      *items)
+{
+  for (guint i = 0; i < items->len; i++)
+    {
+      GskGLPrerendered *prerendered = g_ptr_array_index (items, i);
+
+      g_hash_table_remove (job->prerendered, prerendered->node);
+    }
+
+  g_ptr_array_unref (items);
+}
+
 static guint
 blur_offscreen (GskGLRenderJob       *job,
                 GskGLRenderOffscreen *offscreen,
@@ -1292,7 +1749,7 @@ blur_offscreen (GskGLRenderJob       *job,
   if (!gsk_gl_driver_create_render_target (job->driver,
                                            MAX (texture_to_blur_width, 1),
                                            MAX (texture_to_blur_height, 1),
-                                           job->target_format,
+                                           job->offscreen_format,
                                            &pass1))
     return 0;
 
@@ -1302,7 +1759,7 @@ blur_offscreen (GskGLRenderJob       *job,
   if (!gsk_gl_driver_create_render_target (job->driver,
                                            texture_to_blur_width,
                                            texture_to_blur_height,
-                                           job->target_format,
+                                           job->offscreen_format,
                                            &pass2))
     return gsk_gl_driver_release_render_target (job->driver, pass1, FALSE);
 
@@ -1458,6 +1915,8 @@ gsk_gl_render_job_visit_color_node (GskGLRenderJob      *job,
    * rendering a solid color.
    */
   program = CHOOSE_PROGRAM (job, coloring);
+  if (program->instanced)
+    program = program->instanced;
   batch = gsk_gl_command_queue_get_batch (job->command_queue);
 
   /* Limit the size, or we end up with a coordinate overflow somewhere. */
@@ -1691,16 +2150,25 @@ gsk_gl_render_job_visit_rounded_clip_node (GskGLRenderJob      *job,
   const GskRenderNode *child = gsk_rounded_clip_node_get_child (node);
   const GskRoundedRect *clip = gsk_rounded_clip_node_get_clip (node);
   GskRoundedRect transformed_clip;
-  gboolean need_offscreen;
+  GskRoundedRect intersected_clip;
+  GskGLRenderOffscreen offscreen = {0};
+  graphene_rect_t child_bounds;
 
   if (node_is_invisible (child))
     return;
 
   gsk_gl_render_job_transform_rounded_rect (job, clip, &transformed_clip);
+  gsk_gl_render_job_transform_bounds (job, &child->bounds, &child_bounds);
+
+  /* The child does not reach the rounded corners */
+  if (gsk_rounded_rect_contains_rect (&transformed_clip, &child_bounds))
+    {
+      gsk_gl_render_job_visit_node (job, child);
+      return;
+    }
 
   if (job->current_clip->is_rectilinear)
     {
-      GskRoundedRect intersected_clip;
       GskRoundedRectIntersection result;
 
       result = gsk_rounded_rect_intersect_with_rect (&transformed_clip,
@@ -1720,47 +2188,57 @@ gsk_gl_render_job_visit_rounded_clip_node (GskGLRenderJob      *job,
     }
 
   /* After this point we are really working with a new and a current clip
-   * which both have rounded corners.
+   * which both have rounded corners. The shaders can only evaluate one
+   * of them, so we try hard to find a single rounded rect that gives the
+   * same result for the child before resorting to an offscreen.
    */
 
-  if (job->clip->len <= 1)
-    need_offscreen = FALSE;
-  else if (gsk_rounded_rect_contains_rect (&job->current_clip->rect, &transformed_clip.bounds))
-    need_offscreen = FALSE;
-  else
-    need_offscreen = TRUE;
-
-  if (!need_offscreen)
+  if (job->clip->len <= 1 ||
+      gsk_rounded_rect_contains_rect (&job->current_clip->rect, &transformed_clip.bounds) ||
+      gsk_rounded_rect_contains_rect (&job->current_clip->rect, &child_bounds))
     {
       gsk_gl_render_job_push_clip (job, &transformed_clip);
       gsk_gl_render_job_visit_node (job, child);
       gsk_gl_render_job_pop_clip (job);
+      return;
     }
-  else
-    {
-      GskGLRenderOffscreen offscreen = {0};
 
-      offscreen.bounds = &node->bounds;
-      offscreen.force_offscreen = TRUE;
-      offscreen.reset_clip = FALSE;
+  switch (gsk_rounded_rect_intersection (&job->current_clip->rect, &transformed_clip, &intersected_clip))
+    {
+    case GSK_INTERSECTION_EMPTY:
+      return;
 
-      gsk_gl_render_job_push_clip (job, &transformed_clip);
-      if (!gsk_gl_render_job_visit_node_with_offscreen (job, child, &offscreen))
-        g_assert_not_reached ();
+    case GSK_INTERSECTION_NONEMPTY:
+      gsk_gl_render_job_push_clip (job, &intersected_clip);
+      gsk_gl_render_job_visit_node (job, child);
       gsk_gl_render_job_pop_clip (job);
+      return;
 
-      g_assert (offscreen.texture_id);
+    case GSK_INTERSECTION_NOT_REPRESENTABLE:
+    default:
+      break;
+    }
 
-      if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, blit)))
-        {
-          gsk_gl_program_set_uniform_texture (job->current_program,
-                                              UNIFORM_SHARED_SOURCE, 0,
-                                              GL_TEXTURE_2D,
-                                              GL_TEXTURE0,
-                                              offscreen.texture_id);
-          gsk_gl_render_job_draw_offscreen (job, &node->bounds, &offscreen);
-          gsk_gl_render_job_end_draw (job);
-        }
+  offscreen.bounds = &node->bounds;
+  offscreen.force_offscreen = TRUE;
+  offscreen.reset_clip = FALSE;
+
+  gsk_gl_render_job_push_clip (job, &transformed_clip);
+  if (!gsk_gl_render_job_visit_node_with_offscreen (job, child, &offscreen))
+    g_assert_not_reached ();
+  gsk_gl_render_job_pop_clip (job);
+
+  g_assert (offscreen.texture_id);
+
+  if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, blit)))
+    {
+      gsk_gl_program_set_uniform_texture (job->current_program,
+                                          UNIFORM_SHARED_SOURCE, 0,
+                                          GL_TEXTURE_2D,
+                                          GL_TEXTURE0,
+                                          offscreen.texture_id);
+      gsk_gl_render_job_draw_offscreen (job, &node->bounds, &offscreen);
+      gsk_gl_render_job_end_draw (job);
     }
 }
 
@@ -2017,6 +2495,39 @@ result_is_axis_aligned (GskTransform          *transform,
   return TRUE;
 }
 
+/* Finds the part of a transformed child that can be seen through the
+ * current clip, so that offscreens only need to cover that part.
+ * Offscreens for the whole child can be reused across frames, so we
+ * only crop when most of the child is invisible.
+ *
+ * Returns FALSE if the child is not visible at all.
+ */
+static gboolean
+gsk_gl_render_job_get_visible_child_bounds (GskGLRenderJob        *job,
+                                            GskTransform          *transform,
+                                            const graphene_rect_t *child_bounds,
+                                            graphene_rect_t       *out_visible)
+{
+  graphene_rect_t clip;
+
+  *out_visible = *child_bounds;
+
+  /* Leave room for linear filtering at the edges */
+  graphene_rect_inset_r (&job->current_clip->rect.bounds, -1, -1, &clip);
+  gsk_gl_render_job_untransform_bounds (job, &clip, &clip);
+
+  if (!gsk_transform_untransform_bounds (transform, &clip, &clip))
+    return TRUE;
+
+  if (!graphene_rect_intersection (child_bounds, &clip, &clip))
+    return FALSE;
+
+  if (graphene_rect_get_area (&clip) < graphene_rect_get_area (child_bounds) / 2)
+    *out_visible = clip;
+
+  return TRUE;
+}
+
 static inline void
 gsk_gl_render_job_visit_transform_node (GskGLRenderJob      *job,
                                         const GskRenderNode *node)
@@ -2071,10 +2582,14 @@ gsk_gl_render_job_visit_transform_node (GskGLRenderJob      *job,
       else
         {
           GskGLRenderOffscreen offscreen = {0};
+          graphene_rect_t visible;
           float sx = 1, sy  = 1;
           gboolean linear_filter = FALSE;
 
-          offscreen.bounds = &child->bounds;
+          if (!gsk_gl_render_job_get_visible_child_bounds (job, transform, &child->bounds, &visible))
+            return;
+
+          offscreen.bounds = &visible;
           offscreen.force_offscreen = FALSE;
           offscreen.reset_clip = TRUE;
 
@@ -2123,7 +2638,7 @@ gsk_gl_render_job_visit_transform_node (GskGLRenderJob      *job,
                                                                   offscreen.texture_id,
                                                                   linear_filter ? GL_LINEAR : GL_NEAREST,
                                                                   linear_filter ? GL_LINEAR : GL_NEAREST);
-                  gsk_gl_render_job_draw_offscreen (job, &child->bounds, &offscreen);
+                  gsk_gl_render_job_draw_offscreen (job, &visible, &offscreen);
                   gsk_gl_render_job_end_draw (job);
                 }
 
@@ -2956,12 +3471,17 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
   int x_position = 0;
   GskGLGlyphKey lookup;
   guint last_texture = 0;
-  GskGLDrawVertex *vertices;
+  GskGLDrawVertex *vertices = NULL;
+  GskGLDrawInstance *instances = NULL;
   guint used = 0;
   guint16 nc[4] = { FP16_MINUS_ONE, FP16_MINUS_ONE, FP16_MINUS_ONE, FP16_MINUS_ONE };
   guint16 cc[4];
   const guint16 *c;
   const PangoGlyphInfo *gi;
+  GskGLProgram *program;
+  guint sdf_scale = 0;
+  guint quad_count;
+  gboolean sdf;
   guint i;
   int yshift;
   float ypos;
@@ -2975,15 +3495,42 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
 
   rgba_to_half (color, cc);
 
+  /* Distance fields only have coverage, so they can't do color glyphs */
+  sdf = job->sdf_glyphs &&
+        !gsk_text_node_has_color_glyphs (node) &&
+        gsk_gl_glyph_library_get_sdf_scale (library, (PangoFont *)font, text_scale, &sdf_scale);
+
   lookup.font = (PangoFont *)font;
-  lookup.scale = (guint) (text_scale * 1024);
+  lookup.sdf = sdf;
+  lookup.scale = sdf ? sdf_scale : (guint) (text_scale * 1024);
 
   yshift = compute_phase_and_pos (y, &ypos);
 
-  if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, coloring)))
+  if (sdf)
+    program = CHOOSE_PROGRAM (job, sdf_glyph);
+  else
+    program = CHOOSE_PROGRAM (job, coloring);
+
+  if (gsk_gl_render_job_begin_draw (job, program))
     {
+      if (sdf)
+        gsk_gl_program_set_uniform1f (job->current_program,
+                                      UNIFORM_SDF_GLYPH_FACTOR, 0,
+                                      2 * GSK_GL_GLYPH_SDF_SPREAD * text_scale * 1024 / sdf_scale);
+
       batch = gsk_gl_command_queue_get_batch (job->command_queue);
-      vertices = gsk_gl_command_queue_add_n_vertices (job->command_queue, num_glyphs);
+
+      /* What a glyph adds to the batch's vbo_count */
+      if (job->current_program->program_info->instanced)
+        {
+          instances = gsk_gl_command_queue_add_n_instances (job->command_queue, num_glyphs);
+          quad_count = 1;
+        }
+      else
+        {
+          vertices = gsk_gl_command_queue_add_n_vertices (job->command_queue, num_glyphs);
+          quad_count = GSK_GL_N_VERTICES;
+        }
 
       /* We use one quad per character */
       for (i = 0, gi = glyphs; i < num_glyphs; i++, gi++)
@@ -3006,17 +3553,29 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
             c = cc;
 
           cx = (float)(x_position + gi->geometry.x_offset) / PANGO_SCALE;
-          lookup.xshift = compute_phase_and_pos (x + cx, &cx);
 
-          if G_UNLIKELY (gi->geometry.y_offset != 0)
+          if G_UNLIKELY (sdf)
             {
-              cy = (float)(gi->geometry.y_offset) / PANGO_SCALE;
-              lookup.yshift = compute_phase_and_pos (y + cy, &cy);
+              /* Distance fields scale freely, so there is no need
+               * to snap to the pixel grid */
+              lookup.xshift = lookup.yshift = 0;
+              cx += x;
+              cy = y + (float)(gi->geometry.y_offset) / PANGO_SCALE;
             }
           else
             {
-              lookup.yshift = yshift;
-              cy = ypos;
+              lookup.xshift = compute_phase_and_pos (x + cx, &cx);
+
+              if G_UNLIKELY (gi->geometry.y_offset != 0)
+                {
+                  cy = (float)(gi->geometry.y_offset) / PANGO_SCALE;
+                  lookup.yshift = compute_phase_and_pos (y + cy, &cy);
+                }
+              else
+                {
+                  lookup.yshift = yshift;
+                  cy = ypos;
+                }
             }
 
           x_position += gi->geometry.width;
@@ -3025,7 +3584,7 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
           if G_UNLIKELY (texture_id == 0)
             continue;
 
-          if G_UNLIKELY (last_texture != texture_id || batch->draw.vbo_count + GSK_GL_N_VERTICES > 0xffff)
+          if G_UNLIKELY (last_texture != texture_id || batch->draw.vbo_count + quad_count > 0xffff)
             {
               if G_LIKELY (last_texture != 0)
                 {
@@ -3059,20 +3618,35 @@ gsk_gl_render_job_visit_text_node (GskGLRenderJob      *job,
           glyph_x2 = glyph_x + glyph->ink_rect.width;
           glyph_y2 = glyph_y + glyph->ink_rect.height;
 
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y  }, .uv = { tx,  ty  }, .color = { c[0], c[1], c[2], c[3] } };
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
+          if (instances != NULL)
+            {
+              *(instances++) = (GskGLDrawInstance) { .rect = { glyph_x, glyph_y, glyph_x2, glyph_y2 }, .uv = { tx, ty, tx2, ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+            }
+          else
+            {
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y  }, .uv = { tx,  ty  }, .color = { c[0], c[1], c[2], c[3] } };
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
 
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y2 }, .uv = { tx2, ty2 }, .color = { c[0], c[1], c[2], c[3] } };
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
-          *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y2 }, .uv = { tx2, ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x,  glyph_y2 }, .uv = { tx,  ty2 }, .color = { c[0], c[1], c[2], c[3] } };
+              *(vertices++) = (GskGLDrawVertex) { .position = { glyph_x2, glyph_y  }, .uv = { tx2, ty  }, .color = { c[0], c[1], c[2], c[3] } };
+            }
 
-          batch->draw.vbo_count += GSK_GL_N_VERTICES;
+          batch->draw.vbo_count += quad_count;
           used++;
+
+          if G_UNLIKELY (job->reorder_batches)
+            gsk_gl_render_job_add_bounds (job, glyph_x, glyph_y, glyph_x2, glyph_y2, quad_count);
         }
 
       if (used != num_glyphs)
-        gsk_gl_command_queue_retract_n_vertices (job->command_queue, num_glyphs - used);
+        {
+          if (instances != NULL)
+            gsk_gl_command_queue_retract_n_instances (job->command_queue, num_glyphs - used);
+          else
+            gsk_gl_command_queue_retract_n_vertices (job->command_queue, num_glyphs - used);
+        }
 
       gsk_gl_render_job_end_draw (job);
     }
@@ -3204,6 +3778,12 @@ gsk_gl_render_job_visit_blur_node (GskGLRenderJob      *job,
   offscreen.texture_id = gsk_gl_driver_lookup_texture (job->driver, &key);
   cache_texture = offscreen.texture_id == 0;
 
+  if (cache_texture)
+    {
+      offscreen.texture_id = gsk_gl_render_job_lookup_texture_by_content (job, &key);
+      cache_texture = offscreen.texture_id == 0;
+    }
+
   blur_node (job,
              &offscreen,
              child,
@@ -3213,7 +3793,10 @@ gsk_gl_render_job_visit_blur_node (GskGLRenderJob      *job,
   g_assert (offscreen.texture_id != 0);
 
   if (cache_texture)
-    gsk_gl_driver_cache_texture (job->driver, &key, offscreen.texture_id);
+    {
+      gsk_gl_driver_cache_texture (job->driver, &key, offscreen.texture_id);
+      gsk_gl_driver_cache_texture_by_content (job->driver, &key, offscreen.texture_id);
+    }
 
   if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, blit)))
     {
@@ -3364,6 +3947,178 @@ gsk_gl_render_job_visit_mask_node (GskGLRenderJob      *job,
     }
 }
 
+/* Rasterizes the coverage of a node created with
+ * gsk_render_node_create_path_mask() into @rect, which must be
+ * aligned to the pixel grid.
+ */
+static cairo_surface_t *
+render_path_mask_surface (const GskRenderNode   *mask,
+                          const graphene_rect_t *rect,
+                          float                  scale_x,
+                          float                  scale_y)
+{
+  int surface_width = roundf (rect->size.width * scale_x);
+  int surface_height = roundf (rect->size.height * scale_y);
+  cairo_surface_t *surface;
+  cairo_t *cr;
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                        surface_width,
+                                        surface_height);
+  cairo_surface_set_device_scale (surface, scale_x, scale_y);
+  cr = cairo_create (surface);
+
+  /* We draw upside down here, so it matches what GL does. */
+  cairo_scale (cr, 1, -1);
+  cairo_translate (cr,
+                   - rect->origin.x,
+                   - rect->origin.y - surface_height / scale_y);
+  gsk_render_node_draw ((GskRenderNode *) mask, cr);
+  cairo_destroy (cr);
+
+  return surface;
+}
+
+/* Path masks are cached by content rather than by node, so a static
+ * path only gets rasterized once, even if the nodes drawing it are
+ * recreated every frame.
+ *
+ * The mask covers @node's bounds rounded out to the pixel grid and is
+ * keyed relative to that origin. Paths that are only translated by
+ * whole pixels, like a map that is being panned, keep hitting the
+ * cache. Subpixel offsets change the rasterization, so they are part
+ * of the key via the path coordinates.
+ */
+static guint
+gsk_gl_render_job_get_path_mask (GskGLRenderJob      *job,
+                                 const GskRenderNode *node,
+                                 graphene_rect_t     *mask_rect)
+{
+  float scale_x = fabs (job->scale_x);
+  float scale_y = fabs (job->scale_y);
+  cairo_surface_t *surface;
+  GskRenderNode *mask;
+  GdkTexture *texture;
+  guint64 hash;
+  guint texture_id;
+  float x0, y0, x1, y1;
+
+  x0 = floorf (node->bounds.origin.x * scale_x) / scale_x;
+  y0 = floorf (node->bounds.origin.y * scale_y) / scale_y;
+  x1 = ceilf ((node->bounds.origin.x + node->bounds.size.width) * scale_x) / scale_x;
+  y1 = ceilf ((node->bounds.origin.y + node->bounds.size.height) * scale_y) / scale_y;
+  graphene_rect_init (mask_rect, x0, y0, x1 - x0, y1 - y0);
+
+  hash = gsk_render_node_get_path_mask_hash (node, &mask_rect->origin);
+  hash = gsk_hash_value (hash, mask_rect->size);
+  hash = gsk_hash_value (hash, scale_x);
+  hash = gsk_hash_value (hash, scale_y);
+
+  texture_id = gsk_gl_driver_lookup_mask (job->driver, hash);
+  if (texture_id != 0)
+    return texture_id;
+
+  mask = gsk_render_node_create_path_mask (node);
+  surface = render_path_mask_surface (mask, mask_rect, scale_x, scale_y);
+  gsk_render_node_unref (mask);
+  texture = gdk_texture_new_for_surface (surface);
+  texture_id = gsk_gl_driver_load_texture (job->driver, texture, FALSE);
+
+  if (gdk_gl_context_has_debug (job->command_queue->context))
+    gdk_gl_context_label_object_printf (job->command_queue->context, GL_TEXTURE, texture_id,
+                                        "Path mask %d", texture_id);
+
+  g_object_unref (texture);
+  cairo_surface_destroy (surface);
+
+  gsk_gl_driver_cache_mask (job->driver, hash, texture_id);
+
+  return texture_id;
+}
+
+/* Fill and stroke nodes are drawn by applying the coverage mask of
+ * the path to the child. Only the mask is rasterized on the CPU, the
+ * child is rendered like any other node.
+ */
+static inline void
+gsk_gl_render_job_visit_path_node (GskGLRenderJob      *job,
+                                   const GskRenderNode *node,
+                                   const GskRenderNode *child)
+{
+  GskGLRenderOffscreen child_offscreen = {0};
+  graphene_rect_t mask_rect;
+  guint mask_id;
+
+  if (ceilf (node->bounds.size.width * fabs (job->scale_x)) <= 0 ||
+      ceilf (node->bounds.size.height * fabs (job->scale_y)) <= 0)
+    return;
+
+  mask_id = gsk_gl_render_job_get_path_mask (job, node, &mask_rect);
+
+  if (gsk_render_node_get_node_type (child) == GSK_COLOR_NODE &&
+      gsk_rect_contains_rect (&child->bounds, &node->bounds))
+    {
+      float min_x = job->offset_x + mask_rect.origin.x;
+      float min_y = job->offset_y + mask_rect.origin.y;
+      float max_x = min_x + mask_rect.size.width;
+      float max_y = min_y + mask_rect.size.height;
+      guint16 color[4];
+
+      if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, coloring)))
+        {
+          gsk_gl_program_set_uniform_texture (job->current_program,
+                                              UNIFORM_SHARED_SOURCE, 0,
+                                              GL_TEXTURE_2D,
+                                              GL_TEXTURE0,
+                                              mask_id);
+          rgba_to_half (gsk_color_node_get_color (child), color);
+          gsk_gl_render_job_draw_coords (job,
+                                         min_x, min_y, max_x, max_y,
+                                         0, 1, 1, 0,
+                                         color);
+          gsk_gl_render_job_end_draw (job);
+        }
+
+      return;
+    }
+
+  child_offscreen.bounds = &mask_rect;
+  child_offscreen.force_offscreen = TRUE;
+  child_offscreen.reset_clip = TRUE;
+
+  gsk_gl_render_job_set_modelview (job, gsk_transform_scale (NULL, fabs (job->scale_x), fabs (job->scale_y)));
+
+  if (!gsk_gl_render_job_visit_node_with_offscreen (job, child, &child_offscreen))
+    {
+      gsk_gl_render_job_pop_modelview (job);
+      gsk_gl_render_job_visit_as_fallback (job, node);
+      return;
+    }
+
+  g_assert (child_offscreen.was_offscreen);
+
+  gsk_gl_render_job_pop_modelview (job);
+
+  if (gsk_gl_render_job_begin_draw (job, CHOOSE_PROGRAM (job, mask)))
+    {
+      gsk_gl_program_set_uniform_texture (job->current_program,
+                                          UNIFORM_SHARED_SOURCE, 0,
+                                          GL_TEXTURE_2D,
+                                          GL_TEXTURE0,
+                                          child_offscreen.texture_id);
+      gsk_gl_program_set_uniform_texture (job->current_program,
+                                          UNIFORM_MASK_SOURCE, 0,
+                                          GL_TEXTURE_2D,
+                                          GL_TEXTURE1,
+                                          mask_id);
+      gsk_gl_program_set_uniform1i (job->current_program,
+                                    UNIFORM_MASK_MODE, 0,
+                                    GSK_MASK_MODE_ALPHA);
+      gsk_gl_render_job_draw_offscreen_rect (job, &mask_rect);
+      gsk_gl_render_job_end_draw (job);
+    }
+}
+
 static inline void
 gsk_gl_render_job_visit_color_matrix_node (GskGLRenderJob      *job,
                                            const GskRenderNode *node)
@@ -3910,6 +4665,9 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
                               const GskRenderNode *node)
 {
   gboolean has_clip;
+#ifdef G_ENABLE_DEBUG
+  GskRenderNodeType parent_cost_node_type;
+#endif
 
   g_assert (job != NULL);
   g_assert (node != NULL);
@@ -3922,6 +4680,12 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
   if (!gsk_gl_render_job_update_clip (job, &node->bounds, &has_clip))
     return;
 
+#ifdef G_ENABLE_DEBUG
+  parent_cost_node_type = job->cost_node_type;
+  gsk_gl_render_job_account_costs (job);
+  job->cost_node_type = gsk_render_node_get_node_type (node);
+#endif
+
   switch (gsk_render_node_get_node_type (node))
     {
     case GSK_BLEND_NODE:
@@ -3966,10 +4730,14 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
       {
         GskRenderNode **children;
         guint n_children;
+        GPtrArray *prerendered;
+        guint first;
 
         children = gsk_container_node_get_children (node, &n_children);
+        first = gsk_gl_render_job_get_first_visible_child (job, node, children, n_children);
+        prerendered = gsk_gl_render_job_prerender_fallbacks (job, children + first, n_children - first);
 
-        for (guint i = 0; i < n_children; i++)
+        for (guint i = first; i < n_children; i++)
           {
             const GskRenderNode *child = children[i];
 
@@ -3993,6 +4761,9 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
 
             gsk_gl_render_job_visit_node (job, child);
           }
+
+        if (prerendered != NULL)
+          gsk_gl_render_job_finish_prerendered (job, prerendered);
       }
     break;
 
@@ -4094,11 +4865,11 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
     break;
 
     case GSK_FILL_NODE:
-      gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_path_node (job, node, gsk_fill_node_get_child (node));
     break;
 
     case GSK_STROKE_NODE:
-      gsk_gl_render_job_visit_as_fallback (job, node);
+      gsk_gl_render_job_visit_path_node (job, node, gsk_stroke_node_get_child (node));
     break;
 
     case GSK_NOT_A_RENDER_NODE:
@@ -4107,6 +4878,11 @@ gsk_gl_render_job_visit_node (GskGLRenderJob      *job,
     break;
     }
 
+#ifdef G_ENABLE_DEBUG
+  gsk_gl_render_job_account_costs (job);
+  job->cost_node_type = parent_cost_node_type;
+#endif
+
   if (has_clip)
     gsk_gl_render_job_pop_clip (job);
 }
@@ -4237,6 +5013,12 @@ gsk_gl_render_job_visit_node_with_offscreen (GskGLRenderJob       *job,
   /* Check if we've already cached the drawn texture. */
   cached_id = gsk_gl_driver_lookup_texture (job->driver, &key);
 
+  /* Offscreens which don't depend on the clip can also be reused
+   * for nodes with the same contents.
+   */
+  if (cached_id == 0 && offscreen->reset_clip && !offscreen->do_not_cache)
+    cached_id = gsk_gl_render_job_lookup_texture_by_content (job, &key);
+
   if (cached_id != 0)
     {
       if (downscale_x != 1 || downscale_y != 1)
@@ -4261,6 +5043,11 @@ gsk_gl_render_job_visit_node_with_offscreen (GskGLRenderJob       *job,
                                            &render_target))
     g_assert_not_reached ();
 
+#ifdef G_ENABLE_DEBUG
+  if (job->node_costs != NULL)
+    job->node_costs[job->cost_node_type].offscreens++;
+#endif
+
   if (gdk_gl_context_has_debug (job->command_queue->context))
     {
       gdk_gl_context_label_object_printf (job->command_queue->context,
@@ -4326,26 +5113,33 @@ gsk_gl_render_job_visit_node_with_offscreen (GskGLRenderJob       *job,
                                                                FALSE);
 
   if (!offscreen->do_not_cache)
-    gsk_gl_driver_cache_texture (job->driver, &key, offscreen->texture_id);
+    {
+      gsk_gl_driver_cache_texture (job->driver, &key, offscreen->texture_id);
+      if (offscreen->reset_clip)
+        gsk_gl_driver_cache_texture_by_content (job->driver, &key, offscreen->texture_id);
+    }
 
   return TRUE;
 }
 
+/* Builds the batches to render @root flipped into the job's framebuffer,
+ * without executing them. This allows to put multiple jobs into the
+ * command queue and execute them at once with
+ * gsk_gl_command_queue_execute().
+ *
+ * The intermediate render target is released with the frame.
+ */
 void
-gsk_gl_render_job_render_flipped (GskGLRenderJob *job,
-                                  GskRenderNode  *root)
+gsk_gl_render_job_prepare_flipped (GskGLRenderJob *job,
+                                   GskRenderNode  *root)
 {
+  GskGLRenderTarget *render_target;
   graphene_matrix_t proj;
-  guint framebuffer_id;
-  guint texture_id;
-  guint surface_height;
 
   g_return_if_fail (job != NULL);
   g_return_if_fail (root != NULL);
   g_return_if_fail (GSK_IS_GL_DRIVER (job->driver));
 
-  surface_height = job->viewport.size.height;
-
   graphene_matrix_init_ortho (&proj,
                               job->viewport.origin.x,
                               job->viewport.origin.x + job->viewport.size.width,
@@ -4355,19 +5149,22 @@ gsk_gl_render_job_render_flipped (GskGLRenderJob *job,
                               ORTHO_FAR_PLANE);
   graphene_matrix_scale (&proj, 1, -1, 1);
 
-  if (!gsk_gl_command_queue_create_render_target (job->command_queue,
-                                                  MAX (1, job->viewport.size.width),
-                                                  MAX (1, job->viewport.size.height),
-                                                  job->target_format,
-                                                  &framebuffer_id, &texture_id))
+  if (!gsk_gl_driver_create_render_target (job->driver,
+                                           MAX (1, job->viewport.size.width),
+                                           MAX (1, job->viewport.size.height),
+                                           job->target_format,
+                                           &render_target))
     return;
 
   /* Setup drawing to our offscreen texture/framebuffer which is flipped */
-  gsk_gl_command_queue_bind_framebuffer (job->command_queue, framebuffer_id);
+  gsk_gl_command_queue_bind_framebuffer (job->command_queue, render_target->framebuffer_id);
   gsk_gl_command_queue_clear (job->command_queue, 0, &job->viewport);
 
   /* Visit all nodes creating batches */
   gdk_gl_context_push_debug_group (job->command_queue->context, "Building command queue");
+#ifdef G_ENABLE_DEBUG
+  gsk_gl_render_job_start_costs (job);
+#endif
   gsk_gl_render_job_visit_node (job, root);
   gdk_gl_context_pop_debug_group (job->command_queue->context);
 
@@ -4381,17 +5178,26 @@ gsk_gl_render_job_render_flipped (GskGLRenderJob *job,
                                           UNIFORM_SHARED_SOURCE, 0,
                                           GL_TEXTURE_2D,
                                           GL_TEXTURE0,
-                                          texture_id);
+                                          render_target->texture_id);
       gsk_gl_render_job_draw_rect (job, &job->viewport);
       gsk_gl_render_job_end_draw (job);
     }
 
+  gsk_gl_driver_release_render_target (job->driver, render_target, TRUE);
+}
+
+void
+gsk_gl_render_job_render_flipped (GskGLRenderJob *job,
+                                  GskRenderNode  *root)
+{
+  g_return_if_fail (job != NULL);
+  g_return_if_fail (root != NULL);
+
+  gsk_gl_render_job_prepare_flipped (job, root);
+
   gdk_gl_context_push_debug_group (job->command_queue->context, "Executing command queue");
-  gsk_gl_command_queue_execute (job->command_queue, surface_height, 1, NULL, job->default_framebuffer);
+  gsk_gl_command_queue_execute (job->command_queue, job->viewport.size.height, 1, NULL, job->default_framebuffer);
   gdk_gl_context_pop_debug_group (job->command_queue->context);
-
-  glDeleteFramebuffers (1, &framebuffer_id);
-  glDeleteTextures (1, &texture_id);
 }
 
 void
@@ -4419,10 +5225,17 @@ gsk_gl_render_job_render (GskGLRenderJob *job,
   gsk_gl_command_queue_bind_framebuffer (job->command_queue, job->framebuffer);
   if (job->clear_framebuffer)
     gsk_gl_command_queue_clear (job->command_queue, 0, &job->viewport);
+#ifdef G_ENABLE_DEBUG
+  gsk_gl_render_job_start_costs (job);
+#endif
   gsk_gl_render_job_visit_node (job, root);
   gdk_gl_context_pop_debug_group (job->command_queue->context);
   gdk_profiler_add_mark (start_time, GDK_PROFILER_CURRENT_TIME-start_time, "Build GL command queue", "");
 
+#ifdef G_ENABLE_DEBUG
+  gsk_gl_render_job_report_costs (job);
+#endif
+
 #if 0
   /* At this point the atlases have uploaded content while we processed
    * nodes but have not necessarily been used by the commands in the queue.
@@ -4451,6 +5264,24 @@ gsk_gl_render_job_set_debug_fallback (GskGLRenderJob *job,
   job->debug_fallback = !!debug_fallback;
 }
 
+void
+gsk_gl_render_job_set_sdf_glyphs (GskGLRenderJob *job,
+                                  gboolean        sdf_glyphs)
+{
+  g_return_if_fail (job != NULL);
+
+  job->sdf_glyphs = !!sdf_glyphs;
+}
+
+void
+gsk_gl_render_job_set_reorder_batches (GskGLRenderJob *job,
+                                       gboolean        reorder_batches)
+{
+  g_return_if_fail (job != NULL);
+
+  job->reorder_batches = !!reorder_batches;
+}
+
 static int
 get_framebuffer_format (GdkGLContext *context,
                         guint         framebuffer)
@@ -4475,6 +5306,23 @@ get_framebuffer_format (GdkGLContext *context,
     return GL_RGBA8;
 }
 
+/* Even when the framebuffer only has 8 bits, high depth mode renders
+ * offscreens with half floats, so effects like blurs and gradients
+ * don't band before being composited.
+ */
+static int
+get_offscreen_format (GdkGLContext *context,
+                      int           target_format,
+                      gboolean      high_depth)
+{
+  if (high_depth &&
+      target_format == GL_RGBA8 &&
+      gdk_gl_context_check_version (context, "3.0", "3.2"))
+    return GL_RGBA16F;
+
+  return target_format;
+}
+
 GskGLRenderJob *
 gsk_gl_render_job_new (GskGLDriver           *driver,
                        const graphene_rect_t *viewport,
@@ -4517,6 +5365,13 @@ gsk_gl_render_job_new (GskGLDriver           *driver,
   job->scale_y = scale;
   job->viewport = *viewport;
   job->target_format = get_framebuffer_format (job->command_queue->context, framebuffer);
+  job->high_depth = (gdk_display_get_debug_flags (gdk_gl_context_get_display (context)) & GDK_DEBUG_HIGH_DEPTH) != 0;
+  job->offscreen_format = get_offscreen_format (context, job->target_format, job->high_depth);
+
+#ifdef G_ENABLE_DEBUG
+  if (job->command_queue->profiler != NULL)
+    job->node_costs = g_new0 (GskGLNodeCost, N_NODE_COST_TYPES);
+#endif
 
   gsk_gl_render_job_set_alpha (job, 1.0f);
   gsk_gl_render_job_set_projection_from_rect (job, viewport, NULL);
@@ -4568,5 +5423,9 @@ gsk_gl_render_job_free (GskGLRenderJob *job)
   g_clear_pointer (&job->region, cairo_region_destroy);
   g_clear_pointer (&job->modelview, g_array_unref);
   g_clear_pointer (&job->clip, g_array_unref);
+  g_clear_pointer (&job->prerendered, g_hash_table_unref);
+#ifdef G_ENABLE_DEBUG
+  g_free (job->node_costs);
+#endif
   g_free (job);
 }
@@ -33,6 +33,12 @@ void            gsk_gl_render_job_render             (GskGLRenderJob        *job
                                                       GskRenderNode         *root);
 void            gsk_gl_render_job_render_flipped     (GskGLRenderJob        *job,
                                                       GskRenderNode         *root);
+void            gsk_gl_render_job_prepare_flipped    (GskGLRenderJob        *job,
+                                                      GskRenderNode         *root);
 void            gsk_gl_render_job_set_debug_fallback (GskGLRenderJob        *job,
                                                       gboolean               debug_fallback);
+void            gsk_gl_render_job_set_sdf_glyphs     (GskGLRenderJob        *job,
+                                                      gboolean               sdf_glyphs);
+void            gsk_gl_render_job_set_reorder_batches (GskGLRenderJob       *job,
+                                                       gboolean              reorder_batches);
 
@@ -254,3 +254,19 @@ gsk_gl_shadow_library_begin_frame (GskGLShadowLibrary *self)
         }
     }
 }
+
+/* Releases all shadows, they are rendered again when they are needed */
+void
+gsk_gl_shadow_library_trim (GskGLShadowLibrary *self)
+{
+  g_return_if_fail (GSK_IS_GL_SHADOW_LIBRARY (self));
+
+  for (guint i = 0; i < self->shadows->len; i++)
+    {
+      const Shadow *shadow = &g_array_index (self->shadows, Shadow, i);
+
+      gsk_gl_driver_release_texture_by_id (self->driver, shadow->texture_id);
+    }
+
+  g_array_set_size (self->shadows, 0);
+}
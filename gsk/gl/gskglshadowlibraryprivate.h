@@ -30,6 +30,7 @@ G_DECLARE_FINAL_TYPE (GskGLShadowLibrary, gsk_gl_shadow_library, GSK, GL_SHADOW_
 
 GskGLShadowLibrary * gsk_gl_shadow_library_new         (GskGLDriver          *driver);
 void                 gsk_gl_shadow_library_begin_frame (GskGLShadowLibrary   *self);
+void                 gsk_gl_shadow_library_trim        (GskGLShadowLibrary   *self);
 guint                gsk_gl_shadow_library_lookup      (GskGLShadowLibrary   *self,
                                                         const GskRoundedRect *outline,
                                                         float                 blur_radius);
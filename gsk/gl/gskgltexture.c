@@ -21,6 +21,7 @@
 #include "config.h"
 
 #include <gdk/gdktextureprivate.h>
+#include <gsk/gskgpumemoryprivate.h>
 
 #include "gskgltextureprivate.h"
 #include "ninesliceprivate.h"
@@ -51,6 +52,8 @@ gsk_gl_texture_free (GskGLTexture *texture)
       g_clear_pointer (&texture->slices, g_free);
       g_clear_pointer (&texture->nine_slice, g_free);
 
+      gsk_gpu_memory_add (GSK_GPU_MEMORY_TEXTURES, - (gssize) texture->n_bytes);
+
       g_free (texture);
     }
 }
@@ -73,6 +76,17 @@ gsk_gl_texture_new (guint  texture_id,
   return texture;
 }
 
+/* Sets the GPU memory used by @texture. It is freed
+ * together with the texture.
+ */
+void
+gsk_gl_texture_set_n_bytes (GskGLTexture *texture,
+                            gsize         n_bytes)
+{
+  gsk_gpu_memory_add (GSK_GPU_MEMORY_TEXTURES, (gssize) n_bytes - (gssize) texture->n_bytes);
+  texture->n_bytes = n_bytes;
+}
+
 const GskGLTextureNineSlice *
 gsk_gl_texture_get_nine_slice (GskGLTexture         *texture,
                                const GskRoundedRect *outline,
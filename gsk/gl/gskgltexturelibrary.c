@@ -22,6 +22,7 @@
 
 #include <gdk/gdkglcontextprivate.h>
 #include <gsk/gskdebugprivate.h>
+#include <gsk/gskgpumemoryprivate.h>
 
 #include "gskglcommandqueueprivate.h"
 #include "gskgldriverprivate.h"
@@ -49,12 +50,129 @@ gsk_gl_texture_atlas_free (GskGLTextureAtlas *atlas)
     {
       glDeleteTextures (1, &atlas->texture_id);
       atlas->texture_id = 0;
+      gsk_gpu_memory_add (GSK_GPU_MEMORY_ATLASES, - (gssize) atlas->width * atlas->height * 4);
     }
 
   g_clear_pointer (&atlas->nodes, g_free);
   g_free (atlas);
 }
 
+/* Copies the entries of the @removed atlases that are still in use
+ * into new atlases, so they don't have to be rendered and uploaded
+ * again. Entries that could not be moved are still in one of the
+ * @removed atlases afterwards.
+ */
+static guint
+gsk_gl_texture_library_repack (GskGLTextureLibrary *self,
+                               GPtrArray           *removed)
+{
+  GskGLTextureAtlasEntry *entry;
+  GHashTableIter iter;
+  GPtrArray *entries;
+  stbrp_rect *rects;
+  guint n_rects;
+  guint fbo_id;
+  guint attached = 0;
+  guint moved = 0;
+
+  entries = g_ptr_array_new ();
+
+  g_hash_table_iter_init (&iter, self->hash_table);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&entry))
+    {
+      if (entry->is_atlased && entry->used &&
+          g_ptr_array_find (removed, entry->atlas, NULL))
+        g_ptr_array_add (entries, entry);
+    }
+
+  if (entries->len == 0)
+    {
+      g_ptr_array_unref (entries);
+      return 0;
+    }
+
+  n_rects = entries->len;
+  rects = g_new (stbrp_rect, n_rects);
+  for (guint i = 0; i < n_rects; i++)
+    {
+      entry = g_ptr_array_index (entries, i);
+      rects[i].id = i;
+      rects[i].w = entry->packed.width;
+      rects[i].h = entry->packed.height;
+    }
+
+  gdk_gl_context_push_debug_group_printf (gdk_gl_context_get_current (),
+                                          "Repacking %u atlas entries", n_rects);
+
+  /* The old atlases are read through a framebuffer, this works with
+   * all GL and GLES versions, unlike glCopyImageSubData()
+   */
+  glGenFramebuffers (1, &fbo_id);
+  glBindFramebuffer (GL_FRAMEBUFFER, fbo_id);
+
+  while (n_rects > 0)
+    {
+      GskGLTextureAtlas *atlas = gsk_gl_texture_library_acquire_atlas (self);
+      guint n_left = 0;
+
+      stbrp_pack_rects (&atlas->context, rects, n_rects);
+
+      glBindTexture (GL_TEXTURE_2D, atlas->texture_id);
+
+      for (guint i = 0; i < n_rects; i++)
+        {
+          entry = g_ptr_array_index (entries, rects[i].id);
+
+          if (!rects[i].was_packed)
+            {
+              rects[n_left++] = rects[i];
+              continue;
+            }
+
+          if (attached != entry->atlas->texture_id)
+            {
+              attached = entry->atlas->texture_id;
+              glFramebufferTexture2D (GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, attached, 0);
+            }
+
+          glCopyTexSubImage2D (GL_TEXTURE_2D, 0,
+                               rects[i].x, rects[i].y,
+                               entry->packed.x, entry->packed.y,
+                               entry->packed.width, entry->packed.height);
+
+          entry->area.x = (entry->area.x * entry->atlas->width + rects[i].x - entry->packed.x) / atlas->width;
+          entry->area.y = (entry->area.y * entry->atlas->height + rects[i].y - entry->packed.y) / atlas->height;
+          entry->area.x2 = (entry->area.x2 * entry->atlas->width + rects[i].x - entry->packed.x) / atlas->width;
+          entry->area.y2 = (entry->area.y2 * entry->atlas->height + rects[i].y - entry->packed.y) / atlas->height;
+          entry->packed.x = rects[i].x;
+          entry->packed.y = rects[i].y;
+          entry->atlas = atlas;
+
+          moved++;
+        }
+
+      /* Not even an empty atlas had room, give up on the rest */
+      if (n_left == n_rects)
+        break;
+
+      n_rects = n_left;
+    }
+
+  glDeleteFramebuffers (1, &fbo_id);
+
+  gdk_gl_context_pop_debug_group (gdk_gl_context_get_current ());
+
+  GSK_DEBUG (GLYPH_CACHE, "%s: Moved %u items into %u atlases",
+                          G_OBJECT_TYPE_NAME (self),
+                          moved,
+                          self->atlases->len);
+
+  g_free (rects);
+  g_ptr_array_unref (entries);
+
+  return moved;
+}
+
 static gboolean
 gsk_gl_texture_library_real_compact (GskGLTextureLibrary *self,
                                      gint64               frame_id)
@@ -75,7 +193,7 @@ gsk_gl_texture_library_real_compact (GskGLTextureLibrary *self,
       if (gsk_gl_texture_atlas_get_unused_ratio (atlas) > MAX_OLD_RATIO)
         {
           GSK_DEBUG (GLYPH_CACHE,
-                     "Dropping atlas %d (%g.2%% old)", i,
+                     "Compacting atlas %d (%g.2%% old)", i,
                      100.0 * gsk_gl_texture_atlas_get_unused_ratio (atlas));
           if (removed == NULL)
             removed = g_ptr_array_new_with_free_func ((GDestroyNotify)gsk_gl_texture_atlas_free);
@@ -90,6 +208,9 @@ gsk_gl_texture_library_real_compact (GskGLTextureLibrary *self,
       guint dropped = 0;
       G_GNUC_UNUSED guint atlased = 0;
 
+      if (removed != NULL)
+        gsk_gl_texture_library_repack (self, removed);
+
       g_hash_table_iter_init (&iter, self->hash_table);
       while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&entry))
         {
@@ -430,6 +551,10 @@ gsk_gl_texture_library_pack (GskGLTextureLibrary *self,
       entry->area.y = (packed_y + padding) / (float)atlas->height;
       entry->area.x2 = (packed_x + padding + width) / (float)atlas->width;
       entry->area.y2 = (packed_y + padding + height) / (float)atlas->height;
+      entry->packed.x = packed_x;
+      entry->packed.y = packed_y;
+      entry->packed.width = padding + width + padding;
+      entry->packed.height = padding + height + padding;
 
       *out_packed_x = packed_x;
       *out_packed_y = packed_y;
@@ -507,6 +632,33 @@ gsk_gl_texture_library_reset (GskGLTextureLibrary *self)
     g_ptr_array_remove_range (self->atlases, 0, self->atlases->len);
 }
 
+/*
+ * gsk_gl_texture_library_trim:
+ *
+ * Releases all atlases and the textures of items that did not
+ * fit into an atlas. They are uploaded again when they are needed.
+ */
+void
+gsk_gl_texture_library_trim (GskGLTextureLibrary *self)
+{
+  GskGLTextureAtlasEntry *entry;
+  GHashTableIter iter;
+
+  g_return_if_fail (GSK_IS_GL_TEXTURE_LIBRARY (self));
+
+  g_hash_table_iter_init (&iter, self->hash_table);
+  while (g_hash_table_iter_next (&iter, NULL, (gpointer *)&entry))
+    {
+      if (!entry->is_atlased && entry->texture)
+        {
+          gsk_gl_driver_release_texture (self->driver, entry->texture);
+          entry->texture = NULL;
+        }
+    }
+
+  gsk_gl_texture_library_reset (self);
+}
+
 void
 gsk_gl_texture_library_set_atlas_size (GskGLTextureLibrary *self,
                                        int                  width,
@@ -554,6 +706,7 @@ gsk_gl_texture_library_acquire_atlas (GskGLTextureLibrary *self)
                                                            atlas->width,
                                                            atlas->height,
                                                            GL_RGBA8);
+  gsk_gpu_memory_add (GSK_GPU_MEMORY_ATLASES, (gssize) atlas->width * atlas->height * 4);
 
   gdk_gl_context_label_object_printf (gdk_gl_context_get_current (),
                                       GL_TEXTURE, atlas->texture_id,
@@ -70,6 +70,14 @@ typedef struct _GskGLTextureAtlasEntry
     float y2;
   } area;
 
+  /* The area within the atlas in pixels, including padding */
+  struct {
+    int x;
+    int y;
+    int width;
+    int height;
+  } packed;
+
   /* Number of pixels in the entry, used to calculate usage
    * of an atlas while processing.
    */
@@ -123,6 +131,7 @@ gboolean           gsk_gl_texture_library_compact        (GskGLTextureLibrary *s
                                                           gint64               frame_id);
 void               gsk_gl_texture_library_clear_cache    (GskGLTextureLibrary *self);
 void               gsk_gl_texture_library_reset          (GskGLTextureLibrary *self);
+void               gsk_gl_texture_library_trim           (GskGLTextureLibrary *self);
 void               gsk_gl_texture_library_set_atlas_size (GskGLTextureLibrary *self,
                                                           int                  width,
                                                           int                  height);
@@ -71,6 +71,9 @@ struct _GskGLTexture
   int width;
   int height;
 
+  /* The GPU memory accounted for the texture and its slices */
+  gsize n_bytes;
+
   /* Set when used by an atlas so we don't drop the texture */
   guint              permanent : 1;
   /* we called glGenerateMipmap() for this texture */
@@ -85,6 +88,8 @@ const GskGLTextureNineSlice * gsk_gl_texture_get_nine_slice (GskGLTexture
                                                              const GskRoundedRect *outline,
                                                              float                 extra_pixels_x,
                                                              float                 extra_pixels_y);
+void                          gsk_gl_texture_set_n_bytes    (GskGLTexture         *texture,
+                                                             gsize                 n_bytes);
 void                          gsk_gl_texture_free           (GskGLTexture         *texture);
 
 G_END_DECLS
@@ -33,6 +33,7 @@ typedef struct _GskGLAttachmentState GskGLAttachmentState;
 typedef struct _GskGLBuffer GskGLBuffer;
 typedef struct _GskGLCommandQueue GskGLCommandQueue;
 typedef struct _GskGLCompiler GskGLCompiler;
+typedef struct _GskGLDrawInstance GskGLDrawInstance;
 typedef struct _GskGLDrawVertex GskGLDrawVertex;
 typedef struct _GskGLRenderTarget GskGLRenderTarget;
 typedef struct _GskGLGlyphLibrary GskGLGlyphLibrary;
@@ -60,5 +61,15 @@ struct _GskGLDrawVertex
   guint16 color[4];
 };
 
+/* Used instead of GSK_GL_N_VERTICES vertices for a quad by instanced
+ * programs, which expand it to two triangles in the vertex shader.
+ */
+struct _GskGLDrawInstance
+{
+  float rect[4];
+  float uv[4];
+  guint16 color[4];
+};
+
 G_END_DECLS
 
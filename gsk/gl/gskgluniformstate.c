@@ -227,7 +227,11 @@ gsk_gl_uniform_state_end_frame (GskGLUniformState *state)
       state->values_buf = g_realloc (state->values_buf, state->values_len);
     }
 
-  memset (state->apply_hash, 0, sizeof state->apply_hash);
+  /* Only forget where the values were stored, the values themselves
+   * are still set on the programs
+   */
+  for (guint i = 0; i < G_N_ELEMENTS (state->apply_hash); i++)
+    *(guint *)&state->apply_hash[i].info = 0;
 }
 
 gsize
@@ -263,6 +267,9 @@ gsk_gl_uniform_state_get_program (GskGLUniformState         *state,
       memcpy (ret->mappings, mappings, n_mappings * sizeof *mappings);
 
       g_hash_table_insert (state->programs, GUINT_TO_POINTER (program), ret);
+
+      /* The id may have belonged to a program that was deleted */
+      memset (state->apply_hash, 0, sizeof state->apply_hash);
     }
 
   return ret;
@@ -63,17 +63,30 @@ typedef struct _GskGLUniformProgram
   guint program_id;
   guint n_uniforms : 12;
   guint has_attachments : 1;
+  guint instanced : 1;
   guint n_mappings;
   GskGLUniformMapping mappings[32];
 } GskGLUniformProgram;
 
+/* Large enough for a matrix, bigger arrays are not remembered */
+#define GSK_GL_UNIFORM_APPLIED_MAX_SIZE 64
+
+typedef struct _GskGLUniformApplied
+{
+  guint program;
+  int location;
+  GskGLUniformInfo info;
+  guint size;
+  guint8 value[GSK_GL_UNIFORM_APPLIED_MAX_SIZE];
+} GskGLUniformApplied;
+
 typedef struct _GskGLUniformState
 {
   GHashTable *programs;
   guint8 *values_buf;
   guint values_pos;
   guint values_len;
-  GskGLUniformInfo apply_hash[512];
+  GskGLUniformApplied apply_hash[512];
 } GskGLUniformState;
 
 typedef enum _GskGLUniformKind
@@ -735,17 +748,44 @@ gsk_gl_uniform_state_apply (GskGLUniformState *state,
                             GskGLUniformInfo   info)
 {
   guint index = gsk_gl_uniform_state_fmix (program, location) % G_N_ELEMENTS (state->apply_hash);
+  GskGLUniformApplied *applied = &state->apply_hash[index];
   gconstpointer dataptr = GSK_GL_UNIFORM_VALUE (state->values_buf, info.offset);
+  guint size;
 
-  /* aligned, can treat as unsigned */
-  if (*(guint *)&info == *(guint *)&state->apply_hash[index])
-    return;
+  if (applied->program == program && applied->location == location)
+    {
+      /* aligned, can treat as unsigned */
+      if (*(guint *)&info == *(guint *)&applied->info)
+        return;
 
-  state->apply_hash[index] = info;
+      /* The program keeps its uniform values, so a value that is
+       * stored at a new offset, like after the start of a new frame,
+       * does not need to be uploaded again if it did not change.
+       */
+      size = gsk_gl_uniform_format_size (info.format) * MAX (1, info.array_count);
+      if (size == applied->size && memcmp (applied->value, dataptr, size) == 0)
+        {
+          applied->info = info;
+          return;
+        }
+    }
+  else
+    {
+      size = gsk_gl_uniform_format_size (info.format) * MAX (1, info.array_count);
+    }
 
-  /* TODO: We could do additional comparisons here to make sure we are
-   *       changing state.
-   */
+  applied->program = program;
+  applied->location = location;
+  applied->info = info;
+  if (size <= sizeof applied->value)
+    {
+      applied->size = size;
+      memcpy (applied->value, dataptr, size);
+    }
+  else
+    {
+      applied->size = 0;
+    }
 
   switch (info.format)
     {
@@ -2,7 +2,21 @@ uniform mat4 u_projection;
 uniform mat4 u_modelview;
 uniform float u_alpha;
 
-#if defined(GSK_GLES) || defined(GSK_LEGACY)
+#if defined(GSK_INSTANCED)
+// One record per quad, the corner comes from the vertex index
+_IN_ vec4 aInstanceRect;
+_IN_ vec4 aInstanceUv;
+_IN_ vec4 aInstanceColor;
+_OUT_ vec2 vUv;
+
+const vec2 gsk_instance_corners[6] = vec2[6](vec2(0.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 0.0),
+                                             vec2(1.0, 1.0), vec2(0.0, 1.0), vec2(1.0, 0.0));
+
+#define aPosition mix(aInstanceRect.xy, aInstanceRect.zw, gsk_instance_corners[gl_VertexID])
+#define aUv mix(aInstanceUv.xy, aInstanceUv.zw, gsk_instance_corners[gl_VertexID])
+#define aColor aInstanceColor
+#define aColor2 vec4(0.0)
+#elif defined(GSK_GLES) || defined(GSK_LEGACY)
 attribute vec2 aPosition;
 attribute vec2 aUv;
 attribute vec4 aColor;
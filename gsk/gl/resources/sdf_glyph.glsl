@@ -0,0 +1,27 @@
+// VERTEX_SHADER:
+// sdf_glyph.glsl
+
+_OUT_ vec4 final_color;
+
+void main() {
+  gl_Position = u_projection * u_modelview * vec4(aPosition, 0.0, 1.0);
+
+  vUv = vec2(aUv.x, aUv.y);
+
+  final_color = gsk_scaled_premultiply(aColor, u_alpha);
+}
+
+// FRAGMENT_SHADER:
+// sdf_glyph.glsl
+
+// The renderer sets this to the number of pixels on screen
+// that the full range of the distance field covers.
+uniform float u_sdf_factor;
+
+_IN_ vec4 final_color;
+
+void main() {
+  float dist = (GskTexture(u_source, vUv).a - 0.5) * u_sdf_factor;
+
+  gskSetOutputColor(final_color * clamp(dist + 0.5, 0.0, 1.0));
+}
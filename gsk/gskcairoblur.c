@@ -20,11 +20,23 @@
  *     Owen Taylor <otaylor@redhat.com>
  */
 
+#include "config.h"
+
 #include "gskcairoblurprivate.h"
 
+#include "gdk/gdkparalleltaskprivate.h"
+
 #include <math.h>
 #include <string.h>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define USE_SSE2 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define USE_NEON 1
+#endif
+
 /*
  * Gets the size for a single box blur.
  *
@@ -185,6 +197,361 @@ flip_buffer (guchar *dst_buffer,
 #undef BLOCK_SIZE
 }
 
+#if defined(USE_SSE2) || defined(USE_NEON)
+/* The SIMD code blurs columns: it slides the box down the rows of a
+ * strip of 16 columns, so every step loads and stores one row of the
+ * strip and all columns are blurred at once. Horizontal blurs flip
+ * the buffer and blur its columns.
+ *
+ * The sums are kept in 16 bits, which limits the filter size.
+ */
+#define STRIP_WIDTH 16
+#define MAX_SIMD_FILTER_SIZE 256
+
+/* Surfaces with more pixels than this are blurred by several threads */
+#define MIN_THREADED_PIXELS (512 * 512)
+
+/* Unsigned 16-bit division by an invariant integer using a multiply
+ * and shifts, see figure 4.1 of Granlund and Montgomery,
+ * "Division by Invariant Integers using Multiplication".
+ * This gives the same results as the integer division in blur_xspan().
+ */
+typedef struct
+{
+  guint16 m;
+  int sh1;
+  int sh2;
+} Divisor;
+
+static void
+divisor_init (Divisor *div,
+              int      d)
+{
+  int l = 0;
+
+  while ((1 << l) < d)
+    l++;
+
+  div->m = (((guint32) 1 << 16) * ((1 << l) - d)) / d + 1;
+  div->sh1 = MIN (l, 1);
+  div->sh2 = MAX (l - 1, 0);
+}
+
+#ifdef USE_SSE2
+static inline __m128i
+divide_epu16 (__m128i        n,
+              const Divisor *div)
+{
+  __m128i t = _mm_mulhi_epu16 (n, _mm_set1_epi16 (div->m));
+
+  t = _mm_add_epi16 (t, _mm_srl_epi16 (_mm_sub_epi16 (n, t), _mm_cvtsi32_si128 (div->sh1)));
+
+  return _mm_srl_epi16 (t, _mm_cvtsi32_si128 (div->sh2));
+}
+
+/* Same as blur_xspan(), but for the columns of a strip */
+static void
+blur_strip (guchar       *dst,
+            const guchar *src,
+            int           height,
+            int           d,
+            int           shift)
+{
+  const __m128i zero = _mm_setzero_si128 ();
+  const __m128i half = _mm_set1_epi16 (d / 2);
+  __m128i sum_lo = zero, sum_hi = zero;
+  Divisor div;
+  int offset;
+  int i;
+
+  if (d % 2 == 1)
+    offset = d / 2;
+  else
+    offset = (d - shift) / 2;
+
+  divisor_init (&div, d);
+
+  /* Nothing happens for i < 0, so start there */
+  for (i = 0; i < height + offset; i++)
+    {
+      __m128i v;
+
+      if (i < height)
+        {
+          v = _mm_loadu_si128 ((const __m128i *) (src + STRIP_WIDTH * i));
+          sum_lo = _mm_add_epi16 (sum_lo, _mm_unpacklo_epi8 (v, zero));
+          sum_hi = _mm_add_epi16 (sum_hi, _mm_unpackhi_epi8 (v, zero));
+        }
+
+      if (i >= offset)
+        {
+          if (i >= d)
+            {
+              v = _mm_loadu_si128 ((const __m128i *) (src + STRIP_WIDTH * (i - d)));
+              sum_lo = _mm_sub_epi16 (sum_lo, _mm_unpacklo_epi8 (v, zero));
+              sum_hi = _mm_sub_epi16 (sum_hi, _mm_unpackhi_epi8 (v, zero));
+            }
+
+          v = _mm_packus_epi16 (divide_epu16 (_mm_add_epi16 (sum_lo, half), &div),
+                                divide_epu16 (_mm_add_epi16 (sum_hi, half), &div));
+          _mm_storeu_si128 ((__m128i *) (dst + STRIP_WIDTH * (i - offset)), v);
+        }
+    }
+}
+#else
+static inline uint16x8_t
+divide_u16 (uint16x8_t     n,
+            const Divisor *div)
+{
+  uint32x4_t lo = vmull_u16 (vget_low_u16 (n), vdup_n_u16 (div->m));
+  uint32x4_t hi = vmull_u16 (vget_high_u16 (n), vdup_n_u16 (div->m));
+  uint16x8_t t = vcombine_u16 (vshrn_n_u32 (lo, 16), vshrn_n_u32 (hi, 16));
+
+  t = vaddq_u16 (t, vshlq_u16 (vsubq_u16 (n, t), vdupq_n_s16 (-div->sh1)));
+
+  return vshlq_u16 (t, vdupq_n_s16 (-div->sh2));
+}
+
+/* Same as blur_xspan(), but for the columns of a strip */
+static void
+blur_strip (guchar       *dst,
+            const guchar *src,
+            int           height,
+            int           d,
+            int           shift)
+{
+  const uint16x8_t half = vdupq_n_u16 (d / 2);
+  uint16x8_t sum_lo = vdupq_n_u16 (0), sum_hi = vdupq_n_u16 (0);
+  Divisor div;
+  int offset;
+  int i;
+
+  if (d % 2 == 1)
+    offset = d / 2;
+  else
+    offset = (d - shift) / 2;
+
+  divisor_init (&div, d);
+
+  /* Nothing happens for i < 0, so start there */
+  for (i = 0; i < height + offset; i++)
+    {
+      uint8x16_t v;
+
+      if (i < height)
+        {
+          v = vld1q_u8 (src + STRIP_WIDTH * i);
+          sum_lo = vaddw_u8 (sum_lo, vget_low_u8 (v));
+          sum_hi = vaddw_u8 (sum_hi, vget_high_u8 (v));
+        }
+
+      if (i >= offset)
+        {
+          if (i >= d)
+            {
+              v = vld1q_u8 (src + STRIP_WIDTH * (i - d));
+              sum_lo = vsubw_u8 (sum_lo, vget_low_u8 (v));
+              sum_hi = vsubw_u8 (sum_hi, vget_high_u8 (v));
+            }
+
+          v = vcombine_u8 (vmovn_u16 (divide_u16 (vaddq_u16 (sum_lo, half), &div)),
+                           vmovn_u16 (divide_u16 (vaddq_u16 (sum_hi, half), &div)));
+          vst1q_u8 (dst + STRIP_WIDTH * (i - offset), v);
+        }
+    }
+}
+#endif
+
+/* Transposes a 16x16 block by interleaving rows i and i + 8 four times */
+static inline void
+transpose_block (guchar       *dst,
+                 int           dst_stride,
+                 const guchar *src,
+                 int           src_stride)
+{
+#ifdef USE_SSE2
+  __m128i r[16], t[16];
+  int i, n;
+
+  for (i = 0; i < 16; i++)
+    r[i] = _mm_loadu_si128 ((const __m128i *) (src + src_stride * i));
+
+  for (n = 0; n < 4; n++)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          t[2 * i] = _mm_unpacklo_epi8 (r[i], r[i + 8]);
+          t[2 * i + 1] = _mm_unpackhi_epi8 (r[i], r[i + 8]);
+        }
+      memcpy (r, t, sizeof (r));
+    }
+
+  for (i = 0; i < 16; i++)
+    _mm_storeu_si128 ((__m128i *) (dst + dst_stride * i), r[i]);
+#else
+  uint8x16_t r[16], t[16];
+  int i, n;
+
+  for (i = 0; i < 16; i++)
+    r[i] = vld1q_u8 (src + src_stride * i);
+
+  for (n = 0; n < 4; n++)
+    {
+      for (i = 0; i < 8; i++)
+        {
+          uint8x16x2_t z = vzipq_u8 (r[i], r[i + 8]);
+
+          t[2 * i] = z.val[0];
+          t[2 * i + 1] = z.val[1];
+        }
+      memcpy (r, t, sizeof (r));
+    }
+
+  for (i = 0; i < 16; i++)
+    vst1q_u8 (dst + dst_stride * i, r[i]);
+#endif
+}
+
+/* Same as flip_buffer() */
+static void
+flip_buffer_simd (guchar *dst_buffer,
+                  guchar *src_buffer,
+                  int     width,
+                  int     height)
+{
+  int full_width = width - width % STRIP_WIDTH;
+  int full_height = height - height % STRIP_WIDTH;
+  int i, j;
+
+  for (j = 0; j < full_height; j += STRIP_WIDTH)
+    for (i = 0; i < full_width; i += STRIP_WIDTH)
+      transpose_block (dst_buffer + i * height + j, height,
+                       src_buffer + j * width + i, width);
+
+  /* The partial blocks at the right and bottom edges */
+  for (i = full_width; i < width; i++)
+    for (j = 0; j < height; j++)
+      dst_buffer[i * height + j] = src_buffer[j * width + i];
+
+  for (i = 0; i < full_width; i++)
+    for (j = full_height; j < height; j++)
+      dst_buffer[i * height + j] = src_buffer[j * width + i];
+}
+
+typedef struct
+{
+  guchar *buffer;
+  int width;
+  int height;
+  int d;
+  int n_strips;
+  int next_strip;
+} BlurColumnsData;
+
+static void
+blur_columns_task (gpointer user_data)
+{
+  BlurColumnsData *data = user_data;
+  guchar *strip, *tmp;
+  int d = data->d;
+
+  strip = g_malloc (2 * STRIP_WIDTH * data->height);
+  tmp = strip + STRIP_WIDTH * data->height;
+
+  for (;;)
+    {
+      int i = g_atomic_int_add (&data->next_strip, 1);
+      int x, skip, y;
+
+      if (i >= data->n_strips)
+        break;
+
+      /* The last strip overlaps the previous one if the width isn't
+       * a multiple of the strip width. Columns are independent, so
+       * we just don't store the columns that are done already.
+       */
+      x = MIN (i * STRIP_WIDTH, data->width - STRIP_WIDTH);
+      skip = i * STRIP_WIDTH - x;
+
+      for (y = 0; y < data->height; y++)
+        memcpy (strip + STRIP_WIDTH * y, data->buffer + data->width * y + x, STRIP_WIDTH);
+
+      /* See blur_rows() for why even sizes are done like this */
+      if (d % 2 == 1)
+        {
+          blur_strip (tmp, strip, data->height, d, 0);
+          blur_strip (strip, tmp, data->height, d, 0);
+          blur_strip (tmp, strip, data->height, d, 0);
+        }
+      else
+        {
+          blur_strip (tmp, strip, data->height, d, 1);
+          blur_strip (strip, tmp, data->height, d, -1);
+          blur_strip (tmp, strip, data->height, d + 1, 0);
+        }
+
+      for (y = 0; y < data->height; y++)
+        memcpy (data->buffer + data->width * y + x + skip,
+                tmp + STRIP_WIDTH * y + skip,
+                STRIP_WIDTH - skip);
+    }
+
+  g_free (strip);
+}
+
+static void
+blur_columns (guchar   *buffer,
+              int       width,
+              int       height,
+              int       d,
+              gboolean  threaded)
+{
+  BlurColumnsData data = {
+    .buffer = buffer,
+    .width = width,
+    .height = height,
+    .d = d,
+    .n_strips = (width + STRIP_WIDTH - 1) / STRIP_WIDTH,
+    .next_strip = 0,
+  };
+
+  gdk_parallel_task_run (blur_columns_task, &data, threaded ? data.n_strips : 1);
+}
+
+static gboolean
+_boxblur_simd (guchar       *buffer,
+               guchar       *flipped_buffer,
+               int           width,
+               int           height,
+               int           d,
+               GskBlurFlags  flags)
+{
+  gboolean threaded;
+
+  if (flags & GSK_BLUR_NO_SIMD)
+    return FALSE;
+
+  if (d + 1 > MAX_SIMD_FILTER_SIZE ||
+      width < STRIP_WIDTH || height < STRIP_WIDTH)
+    return FALSE;
+
+  threaded = (flags & GSK_BLUR_NO_THREADS) == 0 &&
+             (gsize) width * height >= MIN_THREADED_PIXELS;
+
+  if (flags & GSK_BLUR_Y)
+    blur_columns (buffer, width, height, d, threaded);
+
+  if (flags & GSK_BLUR_X)
+    {
+      flip_buffer_simd (flipped_buffer, buffer, width, height);
+      blur_columns (flipped_buffer, height, width, d, threaded);
+      flip_buffer_simd (buffer, flipped_buffer, height, width);
+    }
+
+  return TRUE;
+}
+#endif
+
 static void
 _boxblur (guchar      *buffer,
           int          width,
@@ -197,6 +564,14 @@ _boxblur (guchar      *buffer,
 
   flipped_buffer = g_malloc (width * height);
 
+#if defined(USE_SSE2) || defined(USE_NEON)
+  if (_boxblur_simd (buffer, flipped_buffer, width, height, d, flags))
+    {
+      g_free (flipped_buffer);
+      return;
+    }
+#endif
+
   if (flags & GSK_BLUR_Y)
     {
       /* Step 1: swap rows and columns */
@@ -32,7 +32,10 @@ typedef enum {
   GSK_BLUR_NONE = 0,
   GSK_BLUR_X = 1<<0,
   GSK_BLUR_Y = 1<<1,
-  GSK_BLUR_REPEAT = 1<<2
+  GSK_BLUR_REPEAT = 1<<2,
+  /* for testing and benchmarking */
+  GSK_BLUR_NO_SIMD = 1<<3,
+  GSK_BLUR_NO_THREADS = 1<<4
 } GskBlurFlags;
 
 void            gsk_cairo_blur_surface          (cairo_surface_t *surface,
@@ -26,6 +26,15 @@
 #include "gskrendererprivate.h"
 #include "gskrendernodeprivate.h"
 #include "gdk/gdktextureprivate.h"
+#include "gdk/gdkparalleltaskprivate.h"
+
+#include <pango/pangocairo.h>
+
+/* Large redraws are split into tiles of this size (in device pixels)
+ * that are rasterized by worker threads and composited afterwards.
+ */
+#define TILE_SIZE 256
+#define MIN_TILES 4
 
 #ifdef G_ENABLE_DEBUG
 typedef struct {
@@ -73,6 +82,269 @@ gsk_cairo_renderer_unrealize (GskRenderer *renderer)
   g_clear_object (&self->cairo_context);
 }
 
+/* Checks that @node can be drawn from several threads at once,
+ * and that drawing it clipped to a tile gives the same pixels as
+ * drawing it in one go.
+ */
+static gboolean
+gsk_cairo_renderer_can_render_tiled (GskRenderNode *node)
+{
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_CONTAINER_NODE:
+      for (guint i = 0; i < gsk_container_node_get_n_children (node); i++)
+        {
+          if (!gsk_cairo_renderer_can_render_tiled (gsk_container_node_get_child (node, i)))
+            return FALSE;
+        }
+      return TRUE;
+
+    case GSK_COLOR_NODE:
+    case GSK_LINEAR_GRADIENT_NODE:
+    case GSK_REPEATING_LINEAR_GRADIENT_NODE:
+    case GSK_RADIAL_GRADIENT_NODE:
+    case GSK_REPEATING_RADIAL_GRADIENT_NODE:
+    case GSK_CONIC_GRADIENT_NODE:
+    case GSK_BORDER_NODE:
+    case GSK_INSET_SHADOW_NODE:
+    case GSK_OUTSET_SHADOW_NODE:
+    case GSK_GL_SHADER_NODE:
+      return TRUE;
+
+    case GSK_TEXTURE_NODE:
+      /* Other textures may need a GL context to download */
+      return GDK_IS_MEMORY_TEXTURE (gsk_texture_node_get_texture (node));
+
+    case GSK_TEXTURE_SCALE_NODE:
+      return GDK_IS_MEMORY_TEXTURE (gsk_texture_scale_node_get_texture (node));
+
+    case GSK_TEXT_NODE:
+      /* Pango creates the scaled font lazily, do that before the threads race for it */
+      pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (gsk_text_node_get_font (node)));
+      return TRUE;
+
+    case GSK_TRANSFORM_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_transform_node_get_child (node));
+
+    case GSK_OPACITY_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_opacity_node_get_child (node));
+
+    case GSK_COLOR_MATRIX_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_color_matrix_node_get_child (node));
+
+    case GSK_REPEAT_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_repeat_node_get_child (node));
+
+    case GSK_CLIP_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_clip_node_get_child (node));
+
+    case GSK_ROUNDED_CLIP_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_rounded_clip_node_get_child (node));
+
+    case GSK_FILL_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_fill_node_get_child (node));
+
+    case GSK_STROKE_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_stroke_node_get_child (node));
+
+    case GSK_DEBUG_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_debug_node_get_child (node));
+
+    case GSK_BLEND_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_blend_node_get_bottom_child (node)) &&
+             gsk_cairo_renderer_can_render_tiled (gsk_blend_node_get_top_child (node));
+
+    case GSK_CROSS_FADE_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_cross_fade_node_get_start_child (node)) &&
+             gsk_cairo_renderer_can_render_tiled (gsk_cross_fade_node_get_end_child (node));
+
+    case GSK_MASK_NODE:
+      return gsk_cairo_renderer_can_render_tiled (gsk_mask_node_get_source (node)) &&
+             gsk_cairo_renderer_can_render_tiled (gsk_mask_node_get_mask (node));
+
+    /* Blurs and shadows draw their child into a group limited by the clip,
+     * so tile edges would show. Cairo nodes replay a shared recording surface.
+     */
+    case GSK_BLUR_NODE:
+    case GSK_SHADOW_NODE:
+    case GSK_CAIRO_NODE:
+    case GSK_NOT_A_RENDER_NODE:
+    default:
+      return FALSE;
+    }
+}
+
+typedef struct
+{
+  GskRenderNode *root;
+  cairo_matrix_t ctm;
+  double scale_x;
+  double scale_y;
+  cairo_region_t *clip;
+  GArray *tiles;
+  cairo_surface_t **surfaces;
+  int next_tile;
+} TileData;
+
+static void
+gsk_cairo_renderer_render_tiles_task (gpointer user_data)
+{
+  TileData *data = user_data;
+
+  for (;;)
+    {
+      int i = g_atomic_int_add (&data->next_tile, 1);
+      const cairo_rectangle_int_t *tile;
+      cairo_region_t *region;
+      cairo_surface_t *surface;
+      cairo_t *cr;
+
+      if (i >= (int) data->tiles->len)
+        break;
+
+      tile = &g_array_index (data->tiles, cairo_rectangle_int_t, i);
+
+      surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, tile->width, tile->height);
+      cairo_surface_set_device_scale (surface, data->scale_x, data->scale_y);
+      cr = cairo_create (surface);
+      cairo_translate (cr, - tile->x / data->scale_x, - tile->y / data->scale_y);
+
+      region = cairo_region_copy (data->clip);
+      cairo_region_intersect_rectangle (region, tile);
+      for (int j = 0; j < cairo_region_num_rectangles (region); j++)
+        {
+          cairo_rectangle_int_t rect;
+
+          cairo_region_get_rectangle (region, j, &rect);
+          cairo_rectangle (cr,
+                           rect.x / data->scale_x, rect.y / data->scale_y,
+                           rect.width / data->scale_x, rect.height / data->scale_y);
+        }
+      cairo_clip (cr);
+      cairo_region_destroy (region);
+
+      cairo_transform (cr, &data->ctm);
+      gsk_render_node_draw (data->root, cr);
+      cairo_destroy (cr);
+
+      data->surfaces[i] = surface;
+    }
+}
+
+/* Returns the clip of @cr in device pixels */
+static cairo_region_t *
+get_device_clip (cairo_t *cr,
+                 double   scale_x,
+                 double   scale_y)
+{
+  cairo_rectangle_list_t *list;
+  cairo_region_t *region;
+
+  cairo_save (cr);
+  cairo_identity_matrix (cr);
+
+  region = cairo_region_create ();
+  list = cairo_copy_clip_rectangle_list (cr);
+  if (list->status == CAIRO_STATUS_SUCCESS)
+    {
+      for (int i = 0; i < list->num_rectangles; i++)
+        {
+          const cairo_rectangle_t *r = &list->rectangles[i];
+          int x1 = floor (r->x * scale_x);
+          int y1 = floor (r->y * scale_y);
+          int x2 = ceil ((r->x + r->width) * scale_x);
+          int y2 = ceil ((r->y + r->height) * scale_y);
+
+          cairo_region_union_rectangle (region, &(cairo_rectangle_int_t) { x1, y1, x2 - x1, y2 - y1 });
+        }
+    }
+  else
+    {
+      double x1, y1, x2, y2;
+
+      cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+      x1 = floor (x1 * scale_x);
+      y1 = floor (y1 * scale_y);
+      x2 = ceil (x2 * scale_x);
+      y2 = ceil (y2 * scale_y);
+      cairo_region_union_rectangle (region, &(cairo_rectangle_int_t) { x1, y1, x2 - x1, y2 - y1 });
+    }
+  cairo_rectangle_list_destroy (list);
+
+  cairo_restore (cr);
+
+  return region;
+}
+
+static gboolean
+gsk_cairo_renderer_render_tiled (cairo_t       *cr,
+                                 GskRenderNode *root)
+{
+  TileData data;
+  cairo_rectangle_int_t extents;
+  int x, y;
+
+  /* Unbounded targets have no sensible extents to tile */
+  if (g_get_num_processors () < 2 ||
+      cairo_surface_get_type (cairo_get_target (cr)) == CAIRO_SURFACE_TYPE_RECORDING)
+    return FALSE;
+
+  cairo_surface_get_device_scale (cairo_get_target (cr), &data.scale_x, &data.scale_y);
+  data.clip = get_device_clip (cr, data.scale_x, data.scale_y);
+  cairo_region_get_extents (data.clip, &extents);
+
+  if ((gsize) extents.width * extents.height < MIN_TILES * TILE_SIZE * TILE_SIZE ||
+      !gsk_cairo_renderer_can_render_tiled (root))
+    {
+      cairo_region_destroy (data.clip);
+      return FALSE;
+    }
+
+  data.tiles = g_array_new (FALSE, FALSE, sizeof (cairo_rectangle_int_t));
+  for (y = extents.y; y < extents.y + extents.height; y += TILE_SIZE)
+    {
+      for (x = extents.x; x < extents.x + extents.width; x += TILE_SIZE)
+        {
+          cairo_rectangle_int_t tile = {
+            x, y,
+            MIN (TILE_SIZE, extents.x + extents.width - x),
+            MIN (TILE_SIZE, extents.y + extents.height - y)
+          };
+
+          if (cairo_region_contains_rectangle (data.clip, &tile) != CAIRO_REGION_OVERLAP_OUT)
+            g_array_append_val (data.tiles, tile);
+        }
+    }
+
+  data.root = root;
+  cairo_get_matrix (cr, &data.ctm);
+  data.surfaces = g_new0 (cairo_surface_t *, data.tiles->len);
+  data.next_tile = 0;
+
+  gdk_parallel_task_run (gsk_cairo_renderer_render_tiles_task, &data, data.tiles->len);
+
+  cairo_save (cr);
+  cairo_identity_matrix (cr);
+  for (guint i = 0; i < data.tiles->len; i++)
+    {
+      const cairo_rectangle_int_t *tile = &g_array_index (data.tiles, cairo_rectangle_int_t, i);
+
+      cairo_set_source_surface (cr, data.surfaces[i], tile->x / data.scale_x, tile->y / data.scale_y);
+      cairo_rectangle (cr,
+                       tile->x / data.scale_x, tile->y / data.scale_y,
+                       tile->width / data.scale_x, tile->height / data.scale_y);
+      cairo_fill (cr);
+      cairo_surface_destroy (data.surfaces[i]);
+    }
+  cairo_restore (cr);
+
+  g_free (data.surfaces);
+  g_array_unref (data.tiles);
+  cairo_region_destroy (data.clip);
+
+  return TRUE;
+}
+
 static void
 gsk_cairo_renderer_do_render (GskRenderer   *renderer,
                               cairo_t       *cr,
@@ -89,7 +361,8 @@ gsk_cairo_renderer_do_render (GskRenderer   *renderer,
   gsk_profiler_timer_begin (profiler, self->profile_timers.cpu_time);
 #endif
 
-  gsk_render_node_draw (root, cr);
+  if (!gsk_cairo_renderer_render_tiled (cr, root))
+    gsk_render_node_draw (root, cr);
 
 #ifdef G_ENABLE_DEBUG
   cpu_time = gsk_profiler_timer_end (profiler, self->profile_timers.cpu_time);
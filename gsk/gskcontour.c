@@ -82,6 +82,15 @@ struct _GskContourClass
                                                  gboolean                emit_move_to,
                                                  GskRealPathPoint       *start,
                                                  GskRealPathPoint       *end);
+  gpointer              (* init_measure)        (const GskContour       *contour,
+                                                 float                   tolerance,
+                                                 float                  *out_length);
+  void                  (* free_measure)        (const GskContour       *contour,
+                                                 gpointer                measure_data);
+  void                  (* get_point)           (const GskContour       *contour,
+                                                 gpointer                measure_data,
+                                                 float                   distance,
+                                                 GskRealPathPoint       *result);
 };
 
 /* {{{ Utilities */
@@ -609,6 +618,121 @@ gsk_standard_contour_add_segment (const GskContour *contour,
     }
 }
 
+/* The measure is a table with one entry per line of the
+ * decomposition, sorted by length, so looking up a distance
+ * is a binary search.
+ */
+typedef struct
+{
+  float end_length;
+  float start_progress;
+  float end_progress;
+  gsize idx;
+} GskStandardContourMeasure;
+
+typedef struct
+{
+  GArray *array;
+  float length;
+  gsize idx;
+} MeasureDecompose;
+
+static gboolean
+add_measure_line (const graphene_point_t *from,
+                  const graphene_point_t *to,
+                  float                   from_progress,
+                  float                   to_progress,
+                  GskCurveLineReason      reason,
+                  gpointer                user_data)
+{
+  MeasureDecompose *decomp = user_data;
+  GskStandardContourMeasure measure;
+
+  decomp->length += graphene_point_distance (from, to, NULL, NULL);
+
+  measure.end_length = decomp->length;
+  measure.start_progress = from_progress;
+  measure.end_progress = to_progress;
+  measure.idx = decomp->idx;
+  g_array_append_val (decomp->array, measure);
+
+  return TRUE;
+}
+
+static gpointer
+gsk_standard_contour_init_measure (const GskContour *contour,
+                                   float             tolerance,
+                                   float            *out_length)
+{
+  const GskStandardContour *self = (const GskStandardContour *) contour;
+  MeasureDecompose decomp;
+
+  decomp.array = g_array_new (FALSE, FALSE, sizeof (GskStandardContourMeasure));
+  decomp.length = 0;
+
+  for (gsize i = 1; i < self->n_ops; i++)
+    {
+      GskCurve curve;
+
+      decomp.idx = i;
+      gsk_curve_init (&curve, self->ops[i]);
+      gsk_curve_decompose (&curve, tolerance, add_measure_line, &decomp);
+    }
+
+  *out_length = decomp.length;
+
+  return decomp.array;
+}
+
+static void
+gsk_standard_contour_free_measure (const GskContour *contour,
+                                   gpointer          measure_data)
+{
+  g_array_unref (measure_data);
+}
+
+static void
+gsk_standard_contour_get_point (const GskContour *contour,
+                                gpointer          measure_data,
+                                float             distance,
+                                GskRealPathPoint *result)
+{
+  GArray *array = measure_data;
+  const GskStandardContourMeasure *measure;
+  float start_length, fraction;
+  guint lo, hi;
+
+  if (array->len == 0)
+    {
+      result->idx = 0;
+      result->t = 0;
+      return;
+    }
+
+  lo = 0;
+  hi = array->len - 1;
+  while (lo < hi)
+    {
+      guint mid = (lo + hi) / 2;
+
+      if (g_array_index (array, GskStandardContourMeasure, mid).end_length < distance)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  measure = &g_array_index (array, GskStandardContourMeasure, lo);
+  start_length = lo > 0 ? g_array_index (array, GskStandardContourMeasure, lo - 1).end_length : 0;
+
+  if (measure->end_length > start_length)
+    fraction = CLAMP ((distance - start_length) / (measure->end_length - start_length), 0, 1);
+  else
+    fraction = 0;
+
+  result->idx = measure->idx;
+  result->t = measure->start_progress + fraction * (measure->end_progress - measure->start_progress);
+}
+
 static const GskContourClass GSK_STANDARD_CONTOUR_CLASS =
 {
   sizeof (GskStandardContour),
@@ -629,6 +753,9 @@ static const GskContourClass GSK_STANDARD_CONTOUR_CLASS =
   gsk_standard_contour_get_tangent,
   gsk_standard_contour_get_curvature,
   gsk_standard_contour_add_segment,
+  gsk_standard_contour_init_measure,
+  gsk_standard_contour_free_measure,
+  gsk_standard_contour_get_point,
 };
 
 /* You must ensure the contour has enough size allocated,
@@ -817,6 +944,30 @@ gsk_contour_add_segment (const GskContour *self,
   self->klass->add_segment (self, builder, emit_move_to, start, end);
 }
 
+gpointer
+gsk_contour_init_measure (const GskContour *self,
+                          float             tolerance,
+                          float            *out_length)
+{
+  return self->klass->init_measure (self, tolerance, out_length);
+}
+
+void
+gsk_contour_free_measure (const GskContour *self,
+                          gpointer          data)
+{
+  self->klass->free_measure (self, data);
+}
+
+void
+gsk_contour_get_point (const GskContour *self,
+                       gpointer          measure_data,
+                       float             distance,
+                       GskRealPathPoint *result)
+{
+  self->klass->get_point (self, measure_data, distance, result);
+}
+
 /* }}} */
 
 /* vim:set foldmethod=marker expandtab: */
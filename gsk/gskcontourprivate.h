@@ -79,5 +79,15 @@ void                    gsk_contour_add_segment                 (const GskContou
                                                                  GskRealPathPoint       *start,
                                                                  GskRealPathPoint       *end);
 
+gpointer                gsk_contour_init_measure                (const GskContour       *self,
+                                                                 float                   tolerance,
+                                                                 float                  *out_length);
+void                    gsk_contour_free_measure                (const GskContour       *self,
+                                                                 gpointer                data);
+void                    gsk_contour_get_point                   (const GskContour       *self,
+                                                                 gpointer                measure_data,
+                                                                 float                   distance,
+                                                                 GskRealPathPoint       *result);
+
 
 G_END_DECLS
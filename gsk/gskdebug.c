@@ -17,6 +17,9 @@ static const GdkDebugKey gsk_debug_keys[] = {
   { "full-redraw", GSK_DEBUG_FULL_REDRAW, "Force full redraws" },
   { "sync", GSK_DEBUG_SYNC, "Sync after each frame" },
   { "staging", GSK_DEBUG_STAGING, "Use a staging image for texture upload (Vulkan only)" },
+  { "sdf-glyphs", GSK_DEBUG_SDF_GLYPHS, "Use distance fields for large glyphs (OpenGL only)" },
+  { "reorder-batches", GSK_DEBUG_REORDER_BATCHES, "Merge non-overlapping draws across other draws (OpenGL only)" },
+  { "node-arena", GSK_DEBUG_NODE_ARENA, "Allocate render nodes of a frame from an arena" },
 };
 
 static guint gsk_debug_flags;
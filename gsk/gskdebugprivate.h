@@ -19,10 +19,13 @@ typedef enum {
   GSK_DEBUG_GEOMETRY              = 1 <<  9,
   GSK_DEBUG_FULL_REDRAW           = 1 << 10,
   GSK_DEBUG_SYNC                  = 1 << 11,
-  GSK_DEBUG_STAGING               = 1 << 12
+  GSK_DEBUG_STAGING               = 1 << 12,
+  GSK_DEBUG_SDF_GLYPHS            = 1 << 13,
+  GSK_DEBUG_REORDER_BATCHES       = 1 << 14,
+  GSK_DEBUG_NODE_ARENA            = 1 << 15
 } GskDebugFlags;
 
-#define GSK_DEBUG_ANY ((1 << 13) - 1)
+#define GSK_DEBUG_ANY ((1 << 16) - 1)
 
 GskDebugFlags gsk_get_debug_flags (void);
 void          gsk_set_debug_flags (GskDebugFlags flags);
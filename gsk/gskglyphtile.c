@@ -0,0 +1,676 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskglyphtileprivate.h"
+
+#include "gskdebugprivate.h"
+
+#include <pango/pangocairo.h>
+#include <math.h>
+
+/* The renderers keep glyphs in GPU atlases, which get dropped when they
+ * fill up with old glyphs, and each GL driver or Vulkan renderer builds
+ * its own atlases. To avoid rasterizing the same glyph over and over,
+ * we keep the most recently used CPU-side renderings around here, up to
+ * MAX_CACHE_SIZE bytes of pixel data.
+ *
+ * The cache is protected by a lock, so glyphs can be rendered from any
+ * thread. Glyphs that are being rendered are tracked in a separate table,
+ * so that a second lookup waits for the first rendering instead of doing
+ * the work again. gsk_glyph_tile_prefetch() uses this to render glyphs
+ * on a thread pool before the renderer asks for them.
+ */
+
+#define MAX_CACHE_SIZE (4 * 1024 * 1024)
+
+static GMutex glyph_tiles_lock;
+static GCond glyph_tiles_cond;
+static GHashTable *glyph_tiles;
+static GHashTable *glyph_tiles_pending;
+static GQueue glyph_tiles_lru = G_QUEUE_INIT;
+static gsize glyph_tiles_size;
+static GThreadPool *glyph_tiles_pool;
+
+static guint
+gsk_glyph_tile_key_hash (gconstpointer data)
+{
+  const GskGlyphTileKey *key = data;
+
+  return GPOINTER_TO_UINT (key->font) ^
+         key->glyph ^
+         ((guint) key->x_offset << 20) ^
+         ((guint) key->y_offset << 24) ^
+         ((guint) key->width << 8) ^
+         (guint) key->height;
+}
+
+static gboolean
+gsk_glyph_tile_key_equal (gconstpointer v1,
+                          gconstpointer v2)
+{
+  const GskGlyphTileKey *key1 = v1;
+  const GskGlyphTileKey *key2 = v2;
+
+  return key1->font == key2->font &&
+         key1->glyph == key2->glyph &&
+         key1->x_offset == key2->x_offset &&
+         key1->y_offset == key2->y_offset &&
+         key1->width == key2->width &&
+         key1->height == key2->height &&
+         key1->scale_x == key2->scale_x &&
+         key1->scale_y == key2->scale_y;
+}
+
+static void
+gsk_glyph_tile_clear (gpointer data)
+{
+  GskGlyphTile *tile = data;
+
+  g_object_unref (tile->key.font);
+  g_free (tile->data);
+}
+
+GskGlyphTile *
+gsk_glyph_tile_ref (GskGlyphTile *tile)
+{
+  return g_atomic_rc_box_acquire (tile);
+}
+
+void
+gsk_glyph_tile_unref (GskGlyphTile *tile)
+{
+  g_atomic_rc_box_release_full (tile, gsk_glyph_tile_clear);
+}
+
+
+static GskGlyphTile *
+gsk_glyph_tile_new (const GskGlyphTileKey *key,
+                    const PangoGlyphInfo  *glyph_info)
+{
+  GskGlyphTile *tile;
+
+  tile = g_atomic_rc_box_new0 (GskGlyphTile);
+  tile->key = *key;
+  g_object_ref (tile->key.font);
+  tile->link.data = tile;
+  tile->glyph_info = *glyph_info;
+  tile->stride = cairo_format_stride_for_width (CAIRO_FORMAT_ARGB32, key->width);
+
+  return tile;
+}
+
+static void
+gsk_glyph_tile_render (GskGlyphTile *tile)
+{
+  cairo_surface_t *surface;
+  cairo_t *cr;
+
+  tile->data = g_malloc0 (tile->stride * tile->key.height);
+
+  surface = cairo_image_surface_create_for_data (tile->data,
+                                                 CAIRO_FORMAT_ARGB32,
+                                                 tile->key.width, tile->key.height,
+                                                 tile->stride);
+  cairo_surface_set_device_scale (surface, tile->key.scale_x, tile->key.scale_y);
+
+  cr = cairo_create (surface);
+  cairo_set_source_rgba (cr, 1, 1, 1, 1);
+  pango_cairo_show_glyph_string (cr,
+                                 tile->key.font,
+                                 &(PangoGlyphString) {
+                                   .num_glyphs = 1,
+                                   .glyphs = &tile->glyph_info
+                                 });
+  cairo_destroy (cr);
+
+  cairo_surface_finish (surface);
+  cairo_surface_destroy (surface);
+
+  GSK_DEBUG (GLYPH_CACHE, "font %p glyph %u: rendered %d x %d tile",
+             tile->key.font, tile->key.glyph, tile->key.width, tile->key.height);
+}
+
+/* Must be called with the lock held */
+static void
+gsk_glyph_tile_cache_ensure (void)
+{
+  if (glyph_tiles != NULL)
+    return;
+
+  glyph_tiles = g_hash_table_new_full (gsk_glyph_tile_key_hash,
+                                       gsk_glyph_tile_key_equal,
+                                       NULL,
+                                       (GDestroyNotify) gsk_glyph_tile_unref);
+  glyph_tiles_pending = g_hash_table_new (gsk_glyph_tile_key_hash,
+                                          gsk_glyph_tile_key_equal);
+}
+
+/* Must be called with the lock held */
+static void
+gsk_glyph_tile_cache_trim (gsize max_size)
+{
+  while (glyph_tiles_size > max_size)
+    {
+      GskGlyphTile *tile = g_queue_peek_tail (&glyph_tiles_lru);
+
+      g_queue_unlink (&glyph_tiles_lru, &tile->link);
+      glyph_tiles_size -= tile->stride * tile->key.height;
+      /* drops the cache's reference */
+      g_hash_table_remove (glyph_tiles, &tile->key);
+    }
+}
+
+/* Moves a rendered tile from the pending table into the cache,
+ * and wakes up everybody waiting for it.
+ */
+static void
+gsk_glyph_tile_finish (GskGlyphTile *tile)
+{
+  gsize size = tile->stride * tile->key.height;
+
+  g_mutex_lock (&glyph_tiles_lock);
+
+  g_hash_table_remove (glyph_tiles_pending, &tile->key);
+
+  if (size <= MAX_CACHE_SIZE)
+    {
+      g_hash_table_add (glyph_tiles, gsk_glyph_tile_ref (tile));
+      g_queue_push_head_link (&glyph_tiles_lru, &tile->link);
+      glyph_tiles_size += size;
+
+      gsk_glyph_tile_cache_trim (MAX_CACHE_SIZE);
+    }
+
+  g_cond_broadcast (&glyph_tiles_cond);
+
+  g_mutex_unlock (&glyph_tiles_lock);
+}
+
+static GskGlyphTile *
+gsk_glyph_tile_lookup_key (const GskGlyphTileKey *key,
+                           const PangoGlyphInfo  *glyph_info)
+{
+  GskGlyphTile *tile;
+
+  g_mutex_lock (&glyph_tiles_lock);
+
+  gsk_glyph_tile_cache_ensure ();
+
+  while (TRUE)
+    {
+      tile = g_hash_table_lookup (glyph_tiles, key);
+      if (tile)
+        {
+          /* Move to the front of the LRU */
+          g_queue_unlink (&glyph_tiles_lru, &tile->link);
+          g_queue_push_head_link (&glyph_tiles_lru, &tile->link);
+          gsk_glyph_tile_ref (tile);
+
+          g_mutex_unlock (&glyph_tiles_lock);
+
+          return tile;
+        }
+
+      /* Somebody else is rendering it already */
+      if (!g_hash_table_contains (glyph_tiles_pending, key))
+        break;
+
+      g_cond_wait (&glyph_tiles_cond, &glyph_tiles_lock);
+    }
+
+  tile = gsk_glyph_tile_new (key, glyph_info);
+  g_hash_table_add (glyph_tiles_pending, &tile->key);
+
+  g_mutex_unlock (&glyph_tiles_lock);
+
+  /* Render without holding the lock, so other threads can proceed */
+  gsk_glyph_tile_render (tile);
+  gsk_glyph_tile_finish (tile);
+
+  return tile;
+}
+
+/**
+ * gsk_glyph_tile_lookup:
+ * @font: the font to render with
+ * @glyph_info: the glyph to render, including its offsets
+ * @width: width of the tile in pixels
+ * @height: height of the tile in pixels
+ * @scale_x: horizontal device scale to render with
+ * @scale_y: vertical device scale to render with
+ *
+ * Gets a rendering of a single glyph in white, using
+ * pango_cairo_show_glyph_string(). If the glyph has been rendered
+ * with the same parameters recently, the existing rendering is
+ * returned. Otherwise, the glyph is rendered.
+ *
+ * This function is thread-safe.
+ *
+ * Returns: (transfer full): the glyph tile. Use gsk_glyph_tile_unref()
+ *   when done with it
+ */
+GskGlyphTile *
+gsk_glyph_tile_lookup (PangoFont            *font,
+                       const PangoGlyphInfo *glyph_info,
+                       int                   width,
+                       int                   height,
+                       double                scale_x,
+                       double                scale_y)
+{
+  GskGlyphTileKey key;
+
+  g_return_val_if_fail (PANGO_IS_FONT (font), NULL);
+  g_return_val_if_fail (width > 0 && height > 0, NULL);
+
+  key.font = font;
+  key.glyph = glyph_info->glyph;
+  key.x_offset = glyph_info->geometry.x_offset;
+  key.y_offset = glyph_info->geometry.y_offset;
+  key.width = width;
+  key.height = height;
+  key.scale_x = scale_x;
+  key.scale_y = scale_y;
+
+  return gsk_glyph_tile_lookup_key (&key, glyph_info);
+}
+
+/**
+ * gsk_glyph_tile_get_ink_rect:
+ * @font: a font
+ * @glyph: a glyph
+ * @ink_rect: (out): return location for the ink rectangle
+ *
+ * Gets the ink rectangle of @glyph in pixels, grown by one
+ * pixel on every side to leave room for antialiasing.
+ */
+void
+gsk_glyph_tile_get_ink_rect (PangoFont      *font,
+                             PangoGlyph      glyph,
+                             PangoRectangle *ink_rect)
+{
+  pango_font_get_glyph_extents (font, glyph, ink_rect, NULL);
+  pango_extents_to_pixels (ink_rect, NULL);
+
+  ink_rect->x -= 1;
+  ink_rect->width += 2;
+  ink_rect->y -= 1;
+  ink_rect->height += 2;
+}
+
+static gboolean
+gsk_glyph_tile_init_phased (GskGlyphTileKey      *key,
+                            PangoGlyphInfo       *glyph_info,
+                            PangoFont            *font,
+                            PangoGlyph            glyph,
+                            const PangoRectangle *ink_rect,
+                            guint                 xshift,
+                            guint                 yshift,
+                            guint                 scale)
+{
+  int width, height;
+
+  width = (int) ceil (ink_rect->width * scale / 1024.0);
+  height = (int) ceil (ink_rect->height * scale / 1024.0);
+
+  if (width <= 0 || height <= 0)
+    return FALSE;
+
+  *glyph_info = (PangoGlyphInfo) {
+    .glyph = glyph,
+    .geometry.width = ink_rect->width * 1024,
+    .geometry.x_offset = (0.25 * xshift - ink_rect->x) * 1024,
+    .geometry.y_offset = (0.25 * yshift - ink_rect->y) * 1024
+  };
+
+  key->font = font;
+  key->glyph = glyph;
+  key->x_offset = glyph_info->geometry.x_offset;
+  key->y_offset = glyph_info->geometry.y_offset;
+  key->width = width;
+  key->height = height;
+  key->scale_x = width / (double) ink_rect->width;
+  key->scale_y = height / (double) ink_rect->height;
+
+  return TRUE;
+}
+
+/**
+ * gsk_glyph_tile_lookup_phased:
+ * @font: the font to render with
+ * @glyph: the glyph to render
+ * @ink_rect: the ink rectangle, as returned by gsk_glyph_tile_get_ink_rect()
+ * @xshift: horizontal subpixel position, in quarter pixels
+ * @yshift: vertical subpixel position, in quarter pixels
+ * @scale: the scale to render at, multiplied by 1024
+ *
+ * Like gsk_glyph_tile_lookup(), but computes the tile size and offsets
+ * the way the GL renderer lays out glyphs in its atlas. This is what
+ * gsk_glyph_tile_prefetch() renders.
+ *
+ * Returns: (transfer full) (nullable): the glyph tile, or %NULL if
+ *   the glyph is empty at this scale
+ */
+GskGlyphTile *
+gsk_glyph_tile_lookup_phased (PangoFont            *font,
+                              PangoGlyph            glyph,
+                              const PangoRectangle *ink_rect,
+                              guint                 xshift,
+                              guint                 yshift,
+                              guint                 scale)
+{
+  GskGlyphTileKey key;
+  PangoGlyphInfo glyph_info;
+
+  g_return_val_if_fail (PANGO_IS_FONT (font), NULL);
+
+  if (!gsk_glyph_tile_init_phased (&key, &glyph_info, font, glyph, ink_rect, xshift, yshift, scale))
+    return NULL;
+
+  return gsk_glyph_tile_lookup_key (&key, &glyph_info);
+}
+
+/* Keep in sync with the GL renderer */
+static int
+compute_phase_and_pos (float  value,
+                       float *pos)
+{
+  float v;
+
+  *pos = floorf (value);
+
+  v = value - *pos;
+
+  if (v < 0.125)
+    return 0;
+  else if (v < 0.375)
+    return 1;
+  else if (v < 0.625)
+    return 2;
+  else if (v < 0.875)
+    return 3;
+  else
+    {
+      *pos += 1;
+      return 0;
+    }
+}
+
+static void
+gsk_glyph_tile_prefetch_func (gpointer data,
+                              gpointer user_data)
+{
+  GskGlyphTile *tile = data;
+
+  gsk_glyph_tile_render (tile);
+  gsk_glyph_tile_finish (tile);
+  gsk_glyph_tile_unref (tile);
+}
+
+/**
+ * gsk_glyph_tile_prefetch:
+ * @font: the font to render with
+ * @glyphs: the glyphs to render
+ * @x: the horizontal position of the glyph string
+ * @y: the baseline position of the glyph string
+ * @scale: the scale that the text will be rendered at
+ *
+ * Queues the glyphs for rendering on a thread pool, so that their
+ * tiles are ready when the renderer gets to them. Glyphs that are
+ * already cached or being rendered are skipped.
+ *
+ * The subpixel positions are computed as if @x and @y were the final
+ * position of the text in the renderer, so text that ends up at a
+ * different fractional offset will miss the prefetched tiles. That
+ * only costs the wasted work.
+ *
+ * This must be called from the main thread.
+ */
+void
+gsk_glyph_tile_prefetch (PangoFont              *font,
+                         const PangoGlyphString *glyphs,
+                         float                   x,
+                         float                   y,
+                         float                   scale)
+{
+  guint uscale = (guint) (scale * 1024);
+  int x_position = 0;
+  float ypos;
+  int yshift;
+  int i;
+
+  g_return_if_fail (PANGO_IS_FONT (font));
+
+  if (glyphs->num_glyphs == 0 || uscale == 0)
+    return;
+
+  /* Creating the scaled font is not thread-safe, so make sure it exists */
+  if (PANGO_IS_CAIRO_FONT (font) &&
+      pango_cairo_font_get_scaled_font (PANGO_CAIRO_FONT (font)) == NULL)
+    return;
+
+  yshift = compute_phase_and_pos (y, &ypos);
+
+  for (i = 0; i < glyphs->num_glyphs; i++)
+    {
+      const PangoGlyphInfo *gi = &glyphs->glyphs[i];
+      PangoRectangle ink_rect;
+      PangoGlyphInfo glyph_info;
+      GskGlyphTileKey key;
+      int xshift, gyshift;
+      float cx, cy;
+
+      cx = (float) (x_position + gi->geometry.x_offset) / PANGO_SCALE;
+      xshift = compute_phase_and_pos (x + cx, &cx);
+
+      if G_UNLIKELY (gi->geometry.y_offset != 0)
+        {
+          cy = (float) (gi->geometry.y_offset) / PANGO_SCALE;
+          gyshift = compute_phase_and_pos (y + cy, &cy);
+        }
+      else
+        gyshift = yshift;
+
+      x_position += gi->geometry.width;
+
+      if (gi->glyph == PANGO_GLYPH_EMPTY)
+        continue;
+
+      gsk_glyph_tile_get_ink_rect (font, gi->glyph, &ink_rect);
+
+      if (!gsk_glyph_tile_init_phased (&key, &glyph_info, font, gi->glyph, &ink_rect, xshift, gyshift, uscale))
+        continue;
+
+      g_mutex_lock (&glyph_tiles_lock);
+
+      gsk_glyph_tile_cache_ensure ();
+
+      if (!g_hash_table_contains (glyph_tiles, &key) &&
+          !g_hash_table_contains (glyph_tiles_pending, &key))
+        {
+          GskGlyphTile *tile = gsk_glyph_tile_new (&key, &glyph_info);
+
+          if (glyph_tiles_pool == NULL)
+            glyph_tiles_pool = g_thread_pool_new (gsk_glyph_tile_prefetch_func,
+                                                  NULL,
+                                                  MAX (1, (int) g_get_num_processors () - 1),
+                                                  FALSE,
+                                                  NULL);
+
+          g_hash_table_add (glyph_tiles_pending, &tile->key);
+          g_thread_pool_push (glyph_tiles_pool, tile, NULL);
+        }
+
+      g_mutex_unlock (&glyph_tiles_lock);
+    }
+}
+
+#define SDF_INF 1e20f
+
+/* One pass of the squared euclidean distance transform from
+ * Felzenszwalb and Huttenlocher, "Distance Transforms of Sampled
+ * Functions", on @length values of @grid that are @step apart.
+ */
+static void
+edt_1d (float *grid,
+        gsize  step,
+        int    length,
+        float *f,
+        int   *v,
+        float *z)
+{
+  int q, k, r;
+  float s;
+
+  for (q = 0; q < length; q++)
+    f[q] = grid[q * step];
+
+  v[0] = 0;
+  z[0] = -SDF_INF;
+  z[1] = SDF_INF;
+
+  for (q = 1, k = 0; q < length; q++)
+    {
+      do
+        {
+          r = v[k];
+          s = (f[q] - f[r] + q * q - r * r) / (q - r) / 2;
+        }
+      while (s <= z[k] && --k > -1);
+
+      k++;
+      v[k] = q;
+      z[k] = s;
+      z[k + 1] = SDF_INF;
+    }
+
+  for (q = 0, k = 0; q < length; q++)
+    {
+      while (z[k + 1] < q)
+        k++;
+      r = v[k];
+      grid[q * step] = f[r] + (q - r) * (q - r);
+    }
+}
+
+static void
+edt_2d (float *grid,
+        int    width,
+        int    height,
+        float *f,
+        int   *v,
+        float *z)
+{
+  int x, y;
+
+  for (x = 0; x < width; x++)
+    edt_1d (grid + x, width, height, f, v, z);
+
+  for (y = 0; y < height; y++)
+    edt_1d (grid + y * width, 1, width, f, v, z);
+}
+
+/**
+ * gsk_glyph_tile_compute_sdf:
+ * @tile: a glyph tile
+ * @spread: how far the distance field extends beyond the outline, in pixels
+ * @data: memory for the tile size in RGBA pixels
+ * @stride: the stride of @data
+ *
+ * Computes a signed distance field of the glyph outline in @tile.
+ *
+ * The distance is stored in all four channels, mapping the outline
+ * to 0.5 and @spread pixels inside or outside of it to 1 or 0.
+ * Antialiased edge pixels are used to place the outline between
+ * pixels, like TinySDF does.
+ */
+void
+gsk_glyph_tile_compute_sdf (const GskGlyphTile *tile,
+                            int                 spread,
+                            guchar             *data,
+                            gsize               stride)
+{
+  int width = tile->key.width;
+  int height = tile->key.height;
+  int n = MAX (width, height);
+  float *outer, *inner, *f, *z;
+  int *v;
+  int x, y;
+
+  g_return_if_fail (spread > 0);
+
+  outer = g_new (float, width * height);
+  inner = g_new (float, width * height);
+  f = g_new (float, n);
+  z = g_new (float, n + 1);
+  v = g_new (int, n);
+
+  for (y = 0; y < height; y++)
+    {
+      const guint32 *row = (const guint32 *) (tile->data + y * tile->stride);
+
+      for (x = 0; x < width; x++)
+        {
+          float a = (row[x] >> 24) / 255.f;
+          int i = y * width + x;
+
+          if (a >= 1)
+            {
+              outer[i] = 0;
+              inner[i] = SDF_INF;
+            }
+          else if (a <= 0)
+            {
+              outer[i] = SDF_INF;
+              inner[i] = 0;
+            }
+          else
+            {
+              outer[i] = a < 0.5f ? (0.5f - a) * (0.5f - a) : 0;
+              inner[i] = a > 0.5f ? (a - 0.5f) * (a - 0.5f) : 0;
+            }
+        }
+    }
+
+  edt_2d (outer, width, height, f, v, z);
+  edt_2d (inner, width, height, f, v, z);
+
+  for (y = 0; y < height; y++)
+    {
+      guchar *row = data + y * stride;
+
+      for (x = 0; x < width; x++)
+        {
+          int i = y * width + x;
+          float d = sqrtf (outer[i]) - sqrtf (inner[i]);
+          float value = CLAMP (0.5f - d / (2 * spread), 0.f, 1.f);
+          guchar b = (guchar) (value * 255 + 0.5f);
+
+          row[4 * x + 0] = b;
+          row[4 * x + 1] = b;
+          row[4 * x + 2] = b;
+          row[4 * x + 3] = b;
+        }
+    }
+
+  g_free (outer);
+  g_free (inner);
+  g_free (f);
+  g_free (z);
+  g_free (v);
+}
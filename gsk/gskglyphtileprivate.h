@@ -0,0 +1,87 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <pango/pango.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GskGlyphTile GskGlyphTile;
+
+typedef struct _GskGlyphTileKey
+{
+  PangoFont *font;
+  PangoGlyph glyph;
+  int x_offset;
+  int y_offset;
+  int width;
+  int height;
+  double scale_x;
+  double scale_y;
+} GskGlyphTileKey;
+
+/* A CPU-side rendering of a single glyph in CAIRO_FORMAT_ARGB32,
+ * shared between all renderers.
+ */
+struct _GskGlyphTile
+{
+  GskGlyphTileKey key;
+
+  /*< private >*/
+  GList link;
+  PangoGlyphInfo glyph_info;
+
+  /*< public >*/
+  gsize stride;
+  guchar *data;
+};
+
+GskGlyphTile *          gsk_glyph_tile_lookup           (PangoFont              *font,
+                                                         const PangoGlyphInfo   *glyph_info,
+                                                         int                     width,
+                                                         int                     height,
+                                                         double                  scale_x,
+                                                         double                  scale_y);
+
+GskGlyphTile *          gsk_glyph_tile_lookup_phased    (PangoFont              *font,
+                                                         PangoGlyph              glyph,
+                                                         const PangoRectangle   *ink_rect,
+                                                         guint                   xshift,
+                                                         guint                   yshift,
+                                                         guint                   scale);
+
+void                    gsk_glyph_tile_get_ink_rect     (PangoFont              *font,
+                                                         PangoGlyph              glyph,
+                                                         PangoRectangle         *ink_rect);
+
+void                    gsk_glyph_tile_prefetch         (PangoFont              *font,
+                                                         const PangoGlyphString *glyphs,
+                                                         float                   x,
+                                                         float                   y,
+                                                         float                   scale);
+
+void                    gsk_glyph_tile_compute_sdf      (const GskGlyphTile     *tile,
+                                                         int                     spread,
+                                                         guchar                 *data,
+                                                         gsize                   stride);
+
+GskGlyphTile *          gsk_glyph_tile_ref              (GskGlyphTile           *tile);
+void                    gsk_glyph_tile_unref            (GskGlyphTile           *tile);
+
+G_END_DECLS
+
@@ -0,0 +1,117 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskgpumemoryprivate.h"
+
+#include "gdk/gdkprofilerprivate.h"
+
+/* Keeps track of the GPU memory that renderers hold, so it can be
+ * shown in the inspector and in sysprof.
+ *
+ * The numbers are what the renderers asked for. Drivers add padding
+ * and alignment, and GL does not tell us about that, so for GL they
+ * are estimates based on the size and format of the textures.
+ *
+ * The accounting is per process, textures and atlases are shared
+ * between all renderers of a display anyway.
+ */
+
+static const struct {
+  const char *name;
+  const char *description;
+} categories[GSK_GPU_MEMORY_N_CATEGORIES] = {
+  [GSK_GPU_MEMORY_TEXTURES] = { "gpu-textures", "GPU memory used by textures" },
+  [GSK_GPU_MEMORY_OFFSCREENS] = { "gpu-offscreens", "GPU memory used by offscreens" },
+  [GSK_GPU_MEMORY_ATLASES] = { "gpu-atlases", "GPU memory used by glyph and icon atlases" },
+};
+
+static gssize memory[GSK_GPU_MEMORY_N_CATEGORIES];
+
+#ifdef HAVE_SYSPROF
+static guint counters[GSK_GPU_MEMORY_N_CATEGORIES];
+
+static void
+define_counters (void)
+{
+  static gsize initialized = 0;
+
+  if (g_once_init_enter (&initialized))
+    {
+      for (guint i = 0; i < GSK_GPU_MEMORY_N_CATEGORIES; i++)
+        counters[i] = gdk_profiler_define_int_counter (categories[i].name, categories[i].description);
+
+      g_once_init_leave (&initialized, 1);
+    }
+}
+#endif
+
+/*< private >
+ * gsk_gpu_memory_add:
+ * @category: the category of the memory
+ * @n_bytes: the number of bytes that were allocated, or a
+ *   negative number for bytes that were freed
+ *
+ * Records an allocation or release of GPU memory. This may be
+ * called from any thread.
+ */
+void
+gsk_gpu_memory_add (GskGpuMemoryCategory category,
+                    gssize               n_bytes)
+{
+  G_GNUC_UNUSED gssize old_value;
+
+  g_return_if_fail (category < GSK_GPU_MEMORY_N_CATEGORIES);
+
+  if (n_bytes == 0)
+    return;
+
+  old_value = g_atomic_pointer_add (&memory[category], n_bytes);
+
+#ifdef HAVE_SYSPROF
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      define_counters ();
+      gdk_profiler_set_int_counter (counters[category], old_value + n_bytes);
+    }
+#endif
+}
+
+/*< private >
+ * gsk_gpu_memory_get:
+ * @category: the category of the memory
+ *
+ * Returns the GPU memory that is currently allocated in @category.
+ *
+ * Returns: the number of bytes
+ */
+gsize
+gsk_gpu_memory_get (GskGpuMemoryCategory category)
+{
+  g_return_val_if_fail (category < GSK_GPU_MEMORY_N_CATEGORIES, 0);
+
+  return MAX (g_atomic_pointer_get (&memory[category]), 0);
+}
+
+const char *
+gsk_gpu_memory_get_category_name (GskGpuMemoryCategory category)
+{
+  g_return_val_if_fail (category < GSK_GPU_MEMORY_N_CATEGORIES, NULL);
+
+  return categories[category].name;
+}
@@ -0,0 +1,37 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+typedef enum {
+  GSK_GPU_MEMORY_TEXTURES,
+  GSK_GPU_MEMORY_OFFSCREENS,
+  GSK_GPU_MEMORY_ATLASES,
+
+  GSK_GPU_MEMORY_N_CATEGORIES
+} GskGpuMemoryCategory;
+
+void            gsk_gpu_memory_add                      (GskGpuMemoryCategory    category,
+                                                         gssize                  n_bytes);
+gsize           gsk_gpu_memory_get                      (GskGpuMemoryCategory    category);
+const char *    gsk_gpu_memory_get_category_name        (GskGpuMemoryCategory    category);
+
+G_END_DECLS
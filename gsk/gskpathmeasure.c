@@ -0,0 +1,327 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskpathmeasure.h"
+
+#include "gskcontourprivate.h"
+#include "gskpathprivate.h"
+#include "gskpathpointprivate.h"
+
+/**
+ * GskPathMeasure:
+ *
+ * `GskPathMeasure` is an object that allows measurements
+ * on `GskPath`s such as determining the length of the path.
+ *
+ * Many measuring operations require sampling the path length
+ * at intermediate points. Therefore, a `GskPathMeasure` has
+ * a tolerance that determines what precision is required
+ * for such approximations.
+ *
+ * The measurements of each contour are computed the first time
+ * they are needed and kept for the lifetime of the `GskPathMeasure`,
+ * so repeated queries, such as when animating a point along a path,
+ * are cheap.
+ *
+ * A `GskPathMeasure` struct is a reference counted struct
+ * and should be treated as opaque.
+ *
+ * Since: 4.14
+ */
+
+typedef struct _GskContourMeasure GskContourMeasure;
+
+struct _GskContourMeasure
+{
+  float start;   /* distance from the start of the path */
+  float length;
+  gpointer contour_data;
+};
+
+struct _GskPathMeasure
+{
+  /*< private >*/
+  guint ref_count;
+  GskPath *path;
+  float tolerance;
+
+  gsize n_measured; /* The first n_measured contours have been measured */
+  gsize n_contours;
+  GskContourMeasure measures[];
+};
+
+G_DEFINE_BOXED_TYPE (GskPathMeasure, gsk_path_measure,
+                     gsk_path_measure_ref,
+                     gsk_path_measure_unref)
+
+/**
+ * gsk_path_measure_new:
+ * @path: the path to measure
+ *
+ * Creates a measure object for the given @path with the
+ * default tolerance.
+ *
+ * Returns: a new `GskPathMeasure` representing @path
+ *
+ * Since: 4.14
+ */
+GskPathMeasure *
+gsk_path_measure_new (GskPath *path)
+{
+  return gsk_path_measure_new_with_tolerance (path, GSK_PATH_TOLERANCE_DEFAULT);
+}
+
+/**
+ * gsk_path_measure_new_with_tolerance:
+ * @path: the path to measure
+ * @tolerance: the tolerance for measuring operations
+ *
+ * Creates a measure object for the given @path and @tolerance.
+ *
+ * Returns: a new `GskPathMeasure` representing @path
+ *
+ * Since: 4.14
+ */
+GskPathMeasure *
+gsk_path_measure_new_with_tolerance (GskPath *path,
+                                     float    tolerance)
+{
+  GskPathMeasure *self;
+  gsize n_contours;
+
+  g_return_val_if_fail (path != NULL, NULL);
+  g_return_val_if_fail (tolerance > 0, NULL);
+
+  n_contours = gsk_path_get_n_contours (path);
+
+  self = g_malloc0 (sizeof (GskPathMeasure) + n_contours * sizeof (GskContourMeasure));
+
+  self->ref_count = 1;
+  self->path = gsk_path_ref (path);
+  self->tolerance = tolerance;
+  self->n_contours = n_contours;
+  self->n_measured = 0;
+
+  return self;
+}
+
+/**
+ * gsk_path_measure_ref:
+ * @self: a `GskPathMeasure`
+ *
+ * Increases the reference count of a `GskPathMeasure` by one.
+ *
+ * Returns: the passed in `GskPathMeasure`.
+ *
+ * Since: 4.14
+ */
+GskPathMeasure *
+gsk_path_measure_ref (GskPathMeasure *self)
+{
+  g_return_val_if_fail (self != NULL, NULL);
+
+  self->ref_count++;
+
+  return self;
+}
+
+/**
+ * gsk_path_measure_unref:
+ * @self: a `GskPathMeasure`
+ *
+ * Decreases the reference count of a `GskPathMeasure` by one.
+ *
+ * If the resulting reference count is zero, frees the object.
+ *
+ * Since: 4.14
+ */
+void
+gsk_path_measure_unref (GskPathMeasure *self)
+{
+  g_return_if_fail (self != NULL);
+  g_return_if_fail (self->ref_count > 0);
+
+  self->ref_count--;
+  if (self->ref_count > 0)
+    return;
+
+  for (gsize i = 0; i < self->n_measured; i++)
+    {
+      gsk_contour_free_measure (gsk_path_get_contour (self->path, i),
+                                self->measures[i].contour_data);
+    }
+
+  gsk_path_unref (self->path);
+  g_free (self);
+}
+
+/**
+ * gsk_path_measure_get_path:
+ * @self: a `GskPathMeasure`
+ *
+ * Returns the path that the measure was created for.
+ *
+ * Returns: (transfer none): the path of @self
+ *
+ * Since: 4.14
+ */
+GskPath *
+gsk_path_measure_get_path (GskPathMeasure *self)
+{
+  return self->path;
+}
+
+/**
+ * gsk_path_measure_get_tolerance:
+ * @self: a `GskPathMeasure`
+ *
+ * Returns the tolerance that the measure was created with.
+ *
+ * Returns: the tolerance of @self
+ *
+ * Since: 4.14
+ */
+float
+gsk_path_measure_get_tolerance (GskPathMeasure *self)
+{
+  return self->tolerance;
+}
+
+/* Measures contours until the one containing @distance is
+ * known, or all of them are.
+ */
+static void
+gsk_path_measure_ensure (GskPathMeasure *self,
+                         float           distance)
+{
+  while (self->n_measured < self->n_contours)
+    {
+      GskContourMeasure *measure = &self->measures[self->n_measured];
+
+      if (self->n_measured > 0)
+        {
+          GskContourMeasure *prev = measure - 1;
+
+          if (prev->start + prev->length >= distance)
+            return;
+
+          measure->start = prev->start + prev->length;
+        }
+      else
+        measure->start = 0;
+
+      measure->contour_data = gsk_contour_init_measure (gsk_path_get_contour (self->path, self->n_measured),
+                                                        self->tolerance,
+                                                        &measure->length);
+      self->n_measured++;
+    }
+}
+
+/**
+ * gsk_path_measure_get_length:
+ * @self: a `GskPathMeasure`
+ *
+ * Gets the length of the path being measured.
+ *
+ * This measures all contours that have not been measured yet,
+ * later calls are cheap.
+ *
+ * Returns: The length of the path measured by @self
+ *
+ * Since: 4.14
+ */
+float
+gsk_path_measure_get_length (GskPathMeasure *self)
+{
+  GskContourMeasure *last;
+
+  g_return_val_if_fail (self != NULL, 0);
+
+  if (self->n_contours == 0)
+    return 0;
+
+  gsk_path_measure_ensure (self, G_MAXFLOAT);
+
+  last = &self->measures[self->n_contours - 1];
+
+  return last->start + last->length;
+}
+
+/**
+ * gsk_path_measure_get_point:
+ * @self: a `GskPathMeasure`
+ * @distance: the distance
+ * @result: (out caller-allocates): return location for the result
+ *
+ * Gets the point at the given distance into the path.
+ *
+ * An empty path has no points, so `FALSE` is returned in that case.
+ * Distances outside of the path's length are clamped to the start
+ * or end of the path.
+ *
+ * Finding the point takes time logarithmic in the size of the path,
+ * once the contour containing it has been measured.
+ *
+ * Returns: `TRUE` if @result was set
+ *
+ * Since: 4.14
+ */
+gboolean
+gsk_path_measure_get_point (GskPathMeasure *self,
+                            float           distance,
+                            GskPathPoint   *result)
+{
+  GskRealPathPoint *res = (GskRealPathPoint *) result;
+  GskContourMeasure *measure;
+  gsize lo, hi;
+
+  g_return_val_if_fail (self != NULL, FALSE);
+  g_return_val_if_fail (result != NULL, FALSE);
+
+  if (self->n_contours == 0)
+    return FALSE;
+
+  distance = MAX (distance, 0);
+
+  gsk_path_measure_ensure (self, distance);
+
+  /* Find the first contour that ends at or after distance */
+  lo = 0;
+  hi = self->n_measured - 1;
+  while (lo < hi)
+    {
+      gsize mid = (lo + hi) / 2;
+
+      if (self->measures[mid].start + self->measures[mid].length < distance)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+
+  measure = &self->measures[lo];
+  distance = CLAMP (distance - measure->start, 0, measure->length);
+
+  gsk_contour_get_point (gsk_path_get_contour (self->path, lo),
+                         measure->contour_data,
+                         distance,
+                         res);
+  res->contour = lo;
+
+  return TRUE;
+}
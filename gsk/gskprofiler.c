@@ -2,6 +2,8 @@
 
 #include "gskprofilerprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 #define MAX_SAMPLES     32
 
 typedef struct {
@@ -21,6 +23,7 @@ typedef struct {
   gint64 max_value;
   gint64 avg_value;
   gint64 n_samples;
+  guint counter_id;
   unsigned int in_flight : 1;
   unsigned int can_reset : 1;
   unsigned int invert : 1;
@@ -40,6 +43,8 @@ struct _GskProfiler
 
   Sample timer_samples[MAX_SAMPLES];
   guint last_sample;
+
+  char *details;
 };
 
 G_DEFINE_TYPE (GskProfiler, gsk_profiler, G_TYPE_OBJECT)
@@ -75,6 +80,7 @@ gsk_profiler_finalize (GObject *gobject)
 
   g_clear_pointer (&self->counters, g_hash_table_unref);
   g_clear_pointer (&self->timers, g_hash_table_unref);
+  g_clear_pointer (&self->details, g_free);
 
   G_OBJECT_CLASS (gsk_profiler_parent_class)->finalize (gobject);
 }
@@ -161,6 +167,24 @@ named_timer_new (GQuark      id,
   res->invert = invert;
   res->can_reset = can_reset;
 
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      static GHashTable *counter_ids;
+
+      /* Renderers come and go with their surfaces, so share one
+       * sysprof counter for all timers with the same name.
+       */
+      if (counter_ids == NULL)
+        counter_ids = g_hash_table_new (NULL, NULL);
+
+      res->counter_id = GPOINTER_TO_UINT (g_hash_table_lookup (counter_ids, GUINT_TO_POINTER (id)));
+      if (res->counter_id == 0)
+        {
+          res->counter_id = gdk_profiler_define_counter (g_quark_to_string (id), description);
+          g_hash_table_insert (counter_ids, GUINT_TO_POINTER (id), GUINT_TO_POINTER (res->counter_id));
+        }
+    }
+
   return res;
 }
 
@@ -341,6 +365,15 @@ gsk_profiler_counter_get (GskProfiler *profiler,
   return counter->value;
 }
 
+gboolean
+gsk_profiler_has_timer (GskProfiler *profiler,
+                        GQuark       timer_id)
+{
+  g_return_val_if_fail (GSK_IS_PROFILER (profiler), FALSE);
+
+  return gsk_profiler_get_timer (profiler, timer_id) != NULL;
+}
+
 gint64
 gsk_profiler_timer_get (GskProfiler *profiler,
                         GQuark       timer_id)
@@ -409,6 +442,8 @@ gsk_profiler_reset (GskProfiler *profiler)
     }
 
   profiler->last_sample = 0;
+
+  g_clear_pointer (&profiler->details, g_free);
 }
 
 void
@@ -438,6 +473,9 @@ gsk_profiler_push_samples (GskProfiler *profiler)
         s->value = (gint64) (1000000.0 / (double) timer->value);
       else
         s->value = timer->value;
+
+      if (timer->counter_id != 0)
+        gdk_profiler_set_counter (timer->counter_id, s->value);
     }
 }
 
@@ -462,6 +500,35 @@ gsk_profiler_append_counters (GskProfiler *profiler,
     }
 }
 
+/*< private >
+ * gsk_profiler_set_details:
+ * @profiler: a `GskProfiler`
+ * @details: (nullable): free-form text about the last frame
+ *
+ * Sets text that renderers want to show along with the counters
+ * and timers, such as a breakdown of the frame's costs.
+ */
+void
+gsk_profiler_set_details (GskProfiler *profiler,
+                          const char  *details)
+{
+  g_return_if_fail (GSK_IS_PROFILER (profiler));
+
+  g_free (profiler->details);
+  profiler->details = g_strdup (details);
+}
+
+void
+gsk_profiler_append_details (GskProfiler *profiler,
+                             GString     *buffer)
+{
+  g_return_if_fail (GSK_IS_PROFILER (profiler));
+  g_return_if_fail (buffer != NULL);
+
+  if (profiler->details)
+    g_string_append (buffer, profiler->details);
+}
+
 void
 gsk_profiler_append_timers (GskProfiler *profiler,
                             GString     *buffer)
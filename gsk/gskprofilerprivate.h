@@ -41,6 +41,8 @@ gint64          gsk_profiler_timer_get          (GskProfiler *profiler,
                                                  GQuark       timer_id);
 gint64          gsk_profiler_timer_get_start    (GskProfiler *profiler,
                                                  GQuark       timer_id);
+gboolean        gsk_profiler_has_timer          (GskProfiler *profiler,
+                                                 GQuark       timer_id);
 
 void            gsk_profiler_reset              (GskProfiler *profiler);
 
@@ -49,6 +51,10 @@ void            gsk_profiler_append_counters    (GskProfiler *profiler,
                                                  GString     *buffer);
 void            gsk_profiler_append_timers      (GskProfiler *profiler,
                                                  GString     *buffer);
+void            gsk_profiler_set_details        (GskProfiler *profiler,
+                                                 const char  *details);
+void            gsk_profiler_append_details     (GskProfiler *profiler,
+                                                 GString     *buffer);
 
 G_END_DECLS
 
@@ -26,6 +26,75 @@ gsk_rect_intersects (const graphene_rect_t *r1,
     return TRUE;
 }
 
+/**
+ * gsk_rect_coverage:
+ * @r1: a rectangle
+ * @r2: another rectangle
+ * @res: (out caller-allocates): the result
+ *
+ * Computes a rectangle that is fully covered by the union of
+ * @r1 and @r2. This is not generally the largest such rectangle,
+ * but it is at least as large as either of the two inputs.
+ *
+ * Empty rectangles are ignored.
+ */
+static inline void
+gsk_rect_coverage (const graphene_rect_t *r1,
+                   const graphene_rect_t *r2,
+                   graphene_rect_t       *res)
+{
+  graphene_rect_t r;
+  float x1, y1, x2, y2, area;
+
+  if (r1->size.width <= 0 || r1->size.height <= 0)
+    {
+      *res = *r2;
+      return;
+    }
+  if (r2->size.width <= 0 || r2->size.height <= 0 ||
+      gsk_rect_contains_rect (r1, r2))
+    {
+      *res = *r1;
+      return;
+    }
+  if (gsk_rect_contains_rect (r2, r1))
+    {
+      *res = *r2;
+      return;
+    }
+
+  if (r1->size.width * r1->size.height >= r2->size.width * r2->size.height)
+    r = *r1;
+  else
+    r = *r2;
+  area = r.size.width * r.size.height;
+
+  /* The band spanning both rects horizontally where they overlap vertically */
+  x1 = MIN (r1->origin.x, r2->origin.x);
+  x2 = MAX (r1->origin.x + r1->size.width, r2->origin.x + r2->size.width);
+  y1 = MAX (r1->origin.y, r2->origin.y);
+  y2 = MIN (r1->origin.y + r1->size.height, r2->origin.y + r2->size.height);
+  if (r1->origin.x <= r2->origin.x + r2->size.width &&
+      r2->origin.x <= r1->origin.x + r1->size.width &&
+      y2 > y1 && (x2 - x1) * (y2 - y1) > area)
+    {
+      graphene_rect_init (&r, x1, y1, x2 - x1, y2 - y1);
+      area = r.size.width * r.size.height;
+    }
+
+  /* The band spanning both rects vertically where they overlap horizontally */
+  x1 = MAX (r1->origin.x, r2->origin.x);
+  x2 = MIN (r1->origin.x + r1->size.width, r2->origin.x + r2->size.width);
+  y1 = MIN (r1->origin.y, r2->origin.y);
+  y2 = MAX (r1->origin.y + r1->size.height, r2->origin.y + r2->size.height);
+  if (r1->origin.y <= r2->origin.y + r2->size.height &&
+      r2->origin.y <= r1->origin.y + r1->size.height &&
+      x2 > x1 && (x2 - x1) * (y2 - y1) > area)
+    graphene_rect_init (&r, x1, y1, x2 - x1, y2 - y1);
+
+  *res = r;
+}
+
 static inline void
 gsk_rect_to_float (const graphene_rect_t *rect,
                    float                  values[4])
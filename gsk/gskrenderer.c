@@ -40,13 +40,17 @@
 #include "gskdebugprivate.h"
 #include "gl/gskglrenderer.h"
 #include "gskprofilerprivate.h"
+#include "gskrectprivate.h"
 #include "gskrendernodeprivate.h"
+#include "gskshadowcacheprivate.h"
 
 #include "gskenumtypes.h"
 
 #include <graphene-gobject.h>
 #include <cairo-gobject.h>
+#include <string.h>
 #include <gdk/gdk.h>
+#include <gdk/gdksurfaceprivate.h>
 
 #ifdef GDK_WINDOWING_X11
 #include <gdk/x11/gdkx.h>
@@ -125,6 +129,19 @@ gsk_renderer_real_render_texture (GskRenderer           *self,
   return NULL;
 }
 
+static void
+gsk_renderer_real_render_textures (GskRenderer            *self,
+                                   GskRenderNode         **roots,
+                                   const graphene_rect_t  *viewports,
+                                   gsize                   n_roots,
+                                   GdkTexture            **textures)
+{
+  gsize i;
+
+  for (i = 0; i < n_roots; i++)
+    textures[i] = GSK_RENDERER_GET_CLASS (self)->render_texture (self, roots[i], &viewports[i]);
+}
+
 static void
 gsk_renderer_real_render (GskRenderer          *self,
                           GskRenderNode        *root,
@@ -182,6 +199,7 @@ gsk_renderer_class_init (GskRendererClass *klass)
   klass->unrealize = gsk_renderer_real_unrealize;
   klass->render = gsk_renderer_real_render;
   klass->render_texture = gsk_renderer_real_render_texture;
+  klass->render_textures = gsk_renderer_real_render_textures;
 
   gobject_class->get_property = gsk_renderer_get_property;
   gobject_class->dispose = gsk_renderer_dispose;
@@ -322,6 +340,9 @@ gsk_renderer_unrealize (GskRenderer *renderer)
 
   has_surface = priv->surface != NULL;
 
+  if (has_surface && priv->surface->subsurface)
+    gdk_subsurface_detach (priv->surface->subsurface);
+
   GSK_RENDERER_GET_CLASS (renderer)->unrealize (renderer);
 
   g_clear_object (&priv->surface);
@@ -334,6 +355,32 @@ gsk_renderer_unrealize (GskRenderer *renderer)
     g_object_notify (G_OBJECT (renderer), "surface");
 }
 
+/*< private >
+ * gsk_renderer_trim:
+ * @renderer: a `GskRenderer`
+ *
+ * Releases the cached resources that @renderer can recreate, such as
+ * textures, atlases and shadows, to free memory on the GPU.
+ *
+ * GTK calls this when the system warns about low memory, and when
+ * the application has had no mapped windows for a while.
+ */
+void
+gsk_renderer_trim (GskRenderer *renderer)
+{
+  GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
+
+  g_return_if_fail (GSK_IS_RENDERER (renderer));
+
+  if (!priv->is_realized)
+    return;
+
+  gsk_shadow_cache_trim ();
+
+  if (GSK_RENDERER_GET_CLASS (renderer)->trim)
+    GSK_RENDERER_GET_CLASS (renderer)->trim (renderer);
+}
+
 /**
  * gsk_renderer_render_texture:
  * @renderer: a realized `GskRenderer`
@@ -399,6 +446,250 @@ gsk_renderer_render_texture (GskRenderer           *renderer,
   return texture;
 }
 
+/**
+ * gsk_renderer_render_textures:
+ * @renderer: a realized `GskRenderer`
+ * @roots: (array length=n_roots): the `GskRenderNode`s to render
+ * @viewports: (nullable) (array length=n_roots): the section to draw
+ *   for each node or %NULL to use each node's bounds
+ * @n_roots: the number of nodes
+ * @textures: (out caller-allocates) (array length=n_roots) (transfer full):
+ *   return location for the rendered textures
+ *
+ * Renders multiple scene graphs to textures at once.
+ *
+ * This is equivalent to calling [method@Gsk.Renderer.render_texture]
+ * for each node, but renderers can share the per-frame setup and
+ * submit all the work to the GPU together, which is a lot faster
+ * when rendering many small nodes.
+ *
+ * Since: 4.14
+ */
+void
+gsk_renderer_render_textures (GskRenderer            *renderer,
+                              GskRenderNode         **roots,
+                              const graphene_rect_t  *viewports,
+                              gsize                   n_roots,
+                              GdkTexture            **textures)
+{
+  GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
+  graphene_rect_t *real_viewports;
+  gsize i;
+
+  g_return_if_fail (GSK_IS_RENDERER (renderer));
+  g_return_if_fail (priv->is_realized);
+  g_return_if_fail (priv->root_node == NULL);
+  g_return_if_fail (n_roots == 0 || roots != NULL);
+  g_return_if_fail (n_roots == 0 || textures != NULL);
+
+  for (i = 0; i < n_roots; i++)
+    g_return_if_fail (GSK_IS_RENDER_NODE (roots[i]));
+
+  if (n_roots == 0)
+    return;
+
+  real_viewports = g_new (graphene_rect_t, n_roots);
+  for (i = 0; i < n_roots; i++)
+    {
+      if (viewports)
+        real_viewports[i] = viewports[i];
+      else
+        gsk_render_node_get_bounds (roots[i], &real_viewports[i]);
+
+      if (real_viewports[i].size.width <= 0 || real_viewports[i].size.height <= 0)
+        {
+          g_critical ("%s: viewport %" G_GSIZE_FORMAT " is empty", G_STRFUNC, i);
+          g_free (real_viewports);
+          return;
+        }
+    }
+
+  GSK_RENDERER_GET_CLASS (renderer)->render_textures (renderer, roots, real_viewports, n_roots, textures);
+
+#ifdef G_ENABLE_DEBUG
+  if (GSK_RENDERER_DEBUG_CHECK (renderer, RENDERER))
+    {
+      GString *buf = g_string_new ("*** Texture stats ***\n\n");
+
+      gsk_profiler_append_counters (priv->profiler, buf);
+      g_string_append_c (buf, '\n');
+
+      gsk_profiler_append_timers (priv->profiler, buf);
+      g_string_append_c (buf, '\n');
+
+      g_print ("%s\n***\n\n", buf->str);
+
+      g_string_free (buf, TRUE);
+    }
+#endif
+
+  g_free (real_viewports);
+}
+
+/* Returns a copy of @node without its topmost texture node, if that
+ * node can be shown in a subsurface instead of being drawn: nothing
+ * may be drawn on top of it, and it may only be translated and clipped
+ * by clips that don't cut into it. @dx and @dy are the offset of
+ * @node's coordinate system in the surface.
+ *
+ * Returns: (nullable) (transfer full): the stripped node or %NULL
+ *   if there is no texture node to offload
+ */
+static GskRenderNode *
+gsk_renderer_strip_offload_node (GskRenderNode    *node,
+                                 float             dx,
+                                 float             dy,
+                                 GskRenderNode   **texture_node,
+                                 graphene_rect_t  *texture_rect)
+{
+  GskRenderNode *stripped, *result;
+
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_TEXTURE_NODE:
+      *texture_node = node;
+      graphene_rect_offset_r (&node->bounds, dx, dy, texture_rect);
+      return gsk_container_node_new (NULL, 0);
+
+    case GSK_CONTAINER_NODE:
+      {
+        GskRenderNode **children, **new_children;
+        guint n_children;
+
+        children = gsk_container_node_get_children (node, &n_children);
+        if (n_children == 0)
+          return NULL;
+
+        stripped = gsk_renderer_strip_offload_node (children[n_children - 1], dx, dy, texture_node, texture_rect);
+        if (stripped == NULL || n_children == 1)
+          return stripped;
+
+        new_children = g_new (GskRenderNode *, n_children);
+        memcpy (new_children, children, sizeof (GskRenderNode *) * (n_children - 1));
+        new_children[n_children - 1] = stripped;
+        result = gsk_container_node_new (new_children, n_children);
+        g_free (new_children);
+      }
+      break;
+
+    case GSK_TRANSFORM_NODE:
+      {
+        GskTransform *transform = gsk_transform_node_get_transform (node);
+        float tx, ty;
+
+        if (gsk_transform_get_category (transform) < GSK_TRANSFORM_CATEGORY_2D_TRANSLATE)
+          return NULL;
+
+        gsk_transform_to_translate (transform, &tx, &ty);
+        stripped = gsk_renderer_strip_offload_node (gsk_transform_node_get_child (node), dx + tx, dy + ty, texture_node, texture_rect);
+        if (stripped == NULL)
+          return NULL;
+
+        result = gsk_transform_node_new (stripped, transform);
+      }
+      break;
+
+    case GSK_CLIP_NODE:
+      {
+        graphene_rect_t clip;
+
+        stripped = gsk_renderer_strip_offload_node (gsk_clip_node_get_child (node), dx, dy, texture_node, texture_rect);
+        if (stripped == NULL)
+          return NULL;
+
+        graphene_rect_offset_r (gsk_clip_node_get_clip (node), dx, dy, &clip);
+        if (!gsk_rect_contains_rect (&clip, texture_rect))
+          {
+            gsk_render_node_unref (stripped);
+            return NULL;
+          }
+
+        result = gsk_clip_node_new (stripped, gsk_clip_node_get_clip (node));
+      }
+      break;
+
+    case GSK_DEBUG_NODE:
+      stripped = gsk_renderer_strip_offload_node (gsk_debug_node_get_child (node), dx, dy, texture_node, texture_rect);
+      if (stripped == NULL)
+        return NULL;
+
+      result = gsk_debug_node_new (stripped, g_strdup (gsk_debug_node_get_message (node)));
+      break;
+
+    default:
+      return NULL;
+    }
+
+  gsk_render_node_unref (stripped);
+
+  return result;
+}
+
+/* Hands the topmost texture of @root to the surface's subsurface if
+ * possible, and detaches the subsurface otherwise. @changed is set if
+ * the subsurface needs the surface to present a new frame.
+ *
+ * Returns: (transfer full): the node to draw
+ */
+static GskRenderNode *
+gsk_renderer_offload (GskRenderer   *renderer,
+                      GskRenderNode *root,
+                      gboolean      *changed)
+{
+  GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
+  GdkSubsurface *subsurface;
+  GskRenderNode *stripped, *texture_node = NULL;
+  GdkTexture *old_texture;
+  graphene_rect_t rect, old_rect;
+
+  *changed = FALSE;
+
+  if (gdk_display_get_debug_flags (gdk_surface_get_display (priv->surface)) & GDK_DEBUG_NO_OFFLOAD)
+    {
+      if (priv->surface->subsurface &&
+          gdk_subsurface_get_texture (priv->surface->subsurface) != NULL)
+        {
+          gdk_subsurface_detach (priv->surface->subsurface);
+          *changed = TRUE;
+        }
+      return gsk_render_node_ref (root);
+    }
+
+  subsurface = gdk_surface_get_subsurface (priv->surface);
+  if (subsurface == NULL)
+    return gsk_render_node_ref (root);
+
+  old_texture = gdk_subsurface_get_texture (subsurface);
+  gdk_subsurface_get_rect (subsurface, &old_rect);
+
+  stripped = gsk_renderer_strip_offload_node (root, 0, 0, &texture_node, &rect);
+  if (stripped != NULL)
+    {
+      GdkTexture *texture = gsk_texture_node_get_texture (texture_node);
+
+      if (gdk_subsurface_attach (subsurface, texture, &rect))
+        {
+          *changed = old_texture != texture || !graphene_rect_equal (&old_rect, &rect);
+          if (old_texture == NULL)
+            {
+              GSK_RENDERER_DEBUG (renderer, RENDERER, "Offloading %dx%d texture to subsurface",
+                                  gdk_texture_get_width (texture), gdk_texture_get_height (texture));
+            }
+          return stripped;
+        }
+
+      gsk_render_node_unref (stripped);
+    }
+
+  if (old_texture != NULL)
+    {
+      gdk_subsurface_detach (subsurface);
+      *changed = TRUE;
+    }
+
+  return gsk_render_node_ref (root);
+}
+
 /**
  * gsk_renderer_render:
  * @renderer: a realized `GskRenderer`
@@ -426,6 +717,7 @@ gsk_renderer_render (GskRenderer          *renderer,
 {
   GskRendererPrivate *priv = gsk_renderer_get_instance_private (renderer);
   cairo_region_t *clip;
+  gboolean offload_changed;
 
   g_return_if_fail (GSK_IS_RENDERER (renderer));
   g_return_if_fail (priv->is_realized);
@@ -435,6 +727,8 @@ gsk_renderer_render (GskRenderer          *renderer,
   if (priv->surface == NULL)
     return;
 
+  root = gsk_renderer_offload (renderer, root, &offload_changed);
+
   if (region == NULL || priv->prev_node == NULL || GSK_RENDERER_DEBUG_CHECK (renderer, FULL_REDRAW))
     {
       clip = cairo_region_create_rectangle (&(GdkRectangle) {
@@ -448,14 +742,21 @@ gsk_renderer_render (GskRenderer          *renderer,
       clip = cairo_region_copy (region);
       gsk_render_node_diff (priv->prev_node, root, clip);
 
+      /* Subsurface changes only show up when the surface presents
+       * a new frame, so make sure there is one.
+       */
+      if (offload_changed && cairo_region_is_empty (clip))
+        cairo_region_union_rectangle (clip, &(GdkRectangle) { 0, 0, 1, 1 });
+
       if (cairo_region_is_empty (clip))
         {
           cairo_region_destroy (clip);
+          gsk_render_node_unref (root);
           return;
         }
     }
 
-  priv->root_node = gsk_render_node_ref (root);
+  priv->root_node = root;
 
   GSK_RENDERER_GET_CLASS (renderer)->render (renderer, root, clip);
 
@@ -57,6 +57,13 @@ GdkTexture *            gsk_renderer_render_texture             (GskRenderer
                                                                  GskRenderNode           *root,
                                                                  const graphene_rect_t   *viewport);
 
+GDK_AVAILABLE_IN_4_14
+void                    gsk_renderer_render_textures            (GskRenderer             *renderer,
+                                                                 GskRenderNode          **roots,
+                                                                 const graphene_rect_t   *viewports,
+                                                                 gsize                    n_roots,
+                                                                 GdkTexture             **textures);
+
 GDK_AVAILABLE_IN_ALL
 void                    gsk_renderer_render                     (GskRenderer             *renderer,
                                                                  GskRenderNode           *root,
@@ -45,13 +45,21 @@ struct _GskRendererClass
   GdkTexture *         (* render_texture)                       (GskRenderer            *renderer,
                                                                  GskRenderNode          *root,
                                                                  const graphene_rect_t  *viewport);
+  void                 (* render_textures)                      (GskRenderer            *renderer,
+                                                                 GskRenderNode         **roots,
+                                                                 const graphene_rect_t  *viewports,
+                                                                 gsize                   n_roots,
+                                                                 GdkTexture            **textures);
   void                 (* render)                               (GskRenderer            *renderer,
                                                                  GskRenderNode          *root,
                                                                  const cairo_region_t   *invalid);
+  void                 (* trim)                                 (GskRenderer            *renderer);
 };
 
 GskProfiler *           gsk_renderer_get_profiler               (GskRenderer    *renderer);
 
+void                    gsk_renderer_trim                       (GskRenderer    *renderer);
+
 GskDebugFlags           gsk_renderer_get_debug_flags            (GskRenderer    *renderer);
 void                    gsk_renderer_set_debug_flags            (GskRenderer    *renderer,
                                                                  GskDebugFlags   flags);
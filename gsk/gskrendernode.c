@@ -40,8 +40,12 @@
 
 #include "gskdebugprivate.h"
 #include "gskrendererprivate.h"
+#include "gskrendernodearenaprivate.h"
+#include "gskrendernodebinaryprivate.h"
 #include "gskrendernodeparserprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 #include <graphene-gobject.h>
 
 #include <math.h>
@@ -135,7 +139,10 @@ value_render_node_lcopy_value (const GValue *value,
 static void
 gsk_render_node_finalize (GskRenderNode *self)
 {
-  g_type_free_instance ((GTypeInstance *) self);
+  if (self->arena_allocated)
+    gsk_render_node_arena_free (self);
+  else
+    g_type_free_instance ((GTypeInstance *) self);
 }
 
 static void
@@ -159,6 +166,19 @@ gsk_render_node_real_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static gboolean
+gsk_render_node_real_get_opaque_rect (GskRenderNode   *node,
+                                      graphene_rect_t *out_opaque)
+{
+  return FALSE;
+}
+
+static guint64
+gsk_render_node_real_hash (GskRenderNode *node)
+{
+  return 0;
+}
+
 static void
 gsk_render_node_class_init (GskRenderNodeClass *klass)
 {
@@ -167,6 +187,8 @@ gsk_render_node_class_init (GskRenderNodeClass *klass)
   klass->draw = gsk_render_node_real_draw;
   klass->can_diff = gsk_render_node_real_can_diff;
   klass->diff = gsk_render_node_real_diff;
+  klass->get_opaque_rect = gsk_render_node_real_get_opaque_rect;
+  klass->hash = gsk_render_node_real_hash;
 }
 
 static void
@@ -260,6 +282,39 @@ gsk_render_node_type_register_static (const char     *node_name,
   return g_type_register_static (GSK_TYPE_RENDER_NODE, node_name, &info, 0);
 }
 
+static GskRenderNode *
+gsk_render_node_alloc_from_arena (GskRenderNodeType node_type)
+{
+  static gsize instance_sizes[GSK_RENDER_NODE_TYPE_N_TYPES];
+  GTypeClass *klass;
+  GskRenderNode *node;
+
+  /* Only nodes whose class exists already, so we don't need
+   * to go through the type system to create it.
+   */
+  klass = g_type_class_peek (gsk_render_node_types[node_type]);
+  if (klass == NULL)
+    return NULL;
+
+  if (G_UNLIKELY (instance_sizes[node_type] == 0))
+    {
+      GTypeQuery query;
+
+      g_type_query (gsk_render_node_types[node_type], &query);
+      instance_sizes[node_type] = query.instance_size;
+    }
+
+  node = gsk_render_node_arena_alloc (instance_sizes[node_type]);
+  if (node == NULL)
+    return NULL;
+
+  node->parent_instance.g_class = klass;
+  gsk_render_node_init (node);
+  node->arena_allocated = TRUE;
+
+  return node;
+}
+
 /*< private >
  * gsk_render_node_alloc:
  * @node_type: the `GskRenderNode`Type to instantiate
@@ -271,10 +326,27 @@ gsk_render_node_type_register_static (const char     *node_name,
 gpointer
 gsk_render_node_alloc (GskRenderNodeType node_type)
 {
+  GskRenderNode *node;
+
   g_return_val_if_fail (node_type > GSK_NOT_A_RENDER_NODE, NULL);
   g_return_val_if_fail (node_type < GSK_RENDER_NODE_TYPE_N_TYPES, NULL);
 
   g_assert (gsk_render_node_types[node_type] != G_TYPE_INVALID);
+
+#ifdef G_ENABLE_DEBUG
+  {
+    static guint allocation_counter;
+
+    if (G_UNLIKELY (allocation_counter == 0))
+      allocation_counter = gdk_profiler_define_allocation_counter ("render node allocations", "Render nodes created per frame");
+    gdk_profiler_count_allocation (allocation_counter);
+  }
+#endif
+
+  node = gsk_render_node_alloc_from_arena (node_type);
+  if (node)
+    return node;
+
   return g_type_create_instance (gsk_render_node_types[node_type]);
 }
 
@@ -451,6 +523,45 @@ rectangle_init_from_graphene (cairo_rectangle_int_t *cairo,
   cairo->height = ceilf (graphene->origin.y + graphene->size.height) - cairo->y;
 }
 
+/*<private>
+ * gsk_render_node_get_hash:
+ * @node: a `GskRenderNode`
+ *
+ * Gets a hash of everything that influences the rendering of @node,
+ * including its children. Nodes that render the same content, such
+ * as the result of snapshotting an unchanged widget again, have the
+ * same hash.
+ *
+ * The hash is computed on first use and cached, so for containers
+ * reusing subtrees from previous frames this is cheap.
+ *
+ * Returns: the hash, or 0 if the content of @node can not be hashed
+ */
+guint64
+gsk_render_node_get_hash (GskRenderNode *node)
+{
+  if (!node->hash_valid)
+    {
+      guint64 hash;
+
+      hash = GSK_RENDER_NODE_GET_CLASS (node)->hash (node);
+      if (hash != 0)
+        {
+          GskRenderNodeType type = _gsk_render_node_get_node_type (node);
+
+          hash = gsk_hash_value (hash, type);
+          hash = gsk_hash_value (hash, node->bounds);
+          if (hash == 0)
+            hash = 1;
+        }
+
+      node->hash = hash;
+      node->hash_valid = TRUE;
+    }
+
+  return node->hash;
+}
+
 void
 gsk_render_node_diff_impossible (GskRenderNode  *node1,
                                  GskRenderNode  *node2,
@@ -487,9 +598,16 @@ gsk_render_node_diff (GskRenderNode  *node1,
                       GskRenderNode  *node2,
                       cairo_region_t *region)
 {
+  guint64 hash;
+
   if (node1 == node2)
     return;
 
+  /* Same content snapshotted into different nodes */
+  hash = gsk_render_node_get_hash (node1);
+  if (hash != 0 && hash == gsk_render_node_get_hash (node2))
+    return;
+
   if (_gsk_render_node_get_node_type (node1) == _gsk_render_node_get_node_type (node2))
     GSK_RENDER_NODE_GET_CLASS (node1)->diff (node1, node2, region);
 
@@ -539,13 +657,41 @@ gsk_render_node_write_to_file (GskRenderNode *node,
   return result;
 }
 
+/**
+ * gsk_render_node_serialize_binary:
+ * @node: a `GskRenderNode`
+ *
+ * Serializes the @node in a compact binary format.
+ *
+ * The result can be loaded with [func@Gsk.RenderNode.deserialize],
+ * which detects the format automatically. The same restrictions as
+ * for [method@Gsk.RenderNode.serialize] apply, but the binary format
+ * is considerably smaller and faster to load, which makes it better
+ * suited for recording long traces.
+ *
+ * Textures and glyphs in the result are stored only once, no matter
+ * how often they are used.
+ *
+ * Returns: a `GBytes` representing the node.
+ *
+ * Since: 4.14
+ */
+GBytes *
+gsk_render_node_serialize_binary (GskRenderNode *node)
+{
+  g_return_val_if_fail (GSK_IS_RENDER_NODE (node), NULL);
+
+  return gsk_render_node_binary_serialize (node);
+}
+
 /**
  * gsk_render_node_deserialize:
  * @bytes: the bytes containing the data
  * @error_func: (nullable) (scope call): Callback on parsing errors
  * @user_data: (closure error_func): user_data for @error_func
  *
- * Loads data previously created via [method@Gsk.RenderNode.serialize].
+ * Loads data previously created via [method@Gsk.RenderNode.serialize]
+ * or [method@Gsk.RenderNode.serialize_binary].
  *
  * For a discussion of the supported format, see that function.
  *
@@ -558,7 +704,10 @@ gsk_render_node_deserialize (GBytes            *bytes,
 {
   GskRenderNode *node = NULL;
 
-  node = gsk_render_node_deserialize_from_bytes (bytes, error_func, user_data);
+  if (gsk_render_node_binary_is_binary (bytes))
+    node = gsk_render_node_binary_deserialize (bytes, error_func, user_data);
+  else
+    node = gsk_render_node_deserialize_from_bytes (bytes, error_func, user_data);
 
   return node;
 }
@@ -693,3 +842,27 @@ gsk_render_node_use_offscreen_for_opacity (const GskRenderNode *node)
 {
   return node->offscreen_for_opacity;
 }
+
+/*
+ * gsk_render_node_get_opaque_rect:
+ * @node: a `GskRenderNode`
+ * @out_opaque: (out): return location for the opaque rect
+ *
+ * Computes a rectangle that is fully covered by opaque pixels when
+ * @node is drawn. Renderers can use it to skip drawing nodes that
+ * will be painted over anyway.
+ *
+ * The result is conservative: it may be smaller than the actual
+ * opaque region, but it is never larger.
+ *
+ * Returns: %TRUE if an opaque rect was found
+ */
+gboolean
+gsk_render_node_get_opaque_rect (GskRenderNode   *node,
+                                 graphene_rect_t *out_opaque)
+{
+  if (node->bounds.size.width <= 0 || node->bounds.size.height <= 0)
+    return FALSE;
+
+  return GSK_RENDER_NODE_GET_CLASS (node)->get_opaque_rect (node, out_opaque);
+}
@@ -0,0 +1,180 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskrendernodearenaprivate.h"
+
+#include "gskdebugprivate.h"
+
+/* Nodes created while an arena is pushed are carved out of large
+ * chunks with a bump pointer instead of being allocated one by one.
+ *
+ * Nodes are refcounted and shared by pointer (widgets keep their
+ * nodes around between frames, and the previous frame is kept for
+ * diffing), so they cannot be moved out of the arena when they are
+ * retained. Instead, every chunk counts the nodes that are still
+ * alive in it, and the chunk is freed in one go when the last of
+ * them is gone. Freeing a node is then just a decrement.
+ *
+ * Chunks are aligned to their size, so the chunk of a node can be
+ * found from its address.
+ */
+
+#define CHUNK_SIZE (32 * 1024)
+#define CHUNK_ALIGN 16
+#define MAX_ALLOC_SIZE (CHUNK_SIZE / 8)
+
+typedef struct _Chunk Chunk;
+typedef struct _ArenaState ArenaState;
+
+struct _Chunk
+{
+  /* one for every live node, plus one while the arena allocates from it */
+  int n_users;
+  gsize used;
+};
+
+struct _ArenaState
+{
+  guint depth;
+  guint enabled : 1;
+  Chunk *chunk;
+};
+
+#define CHUNK_HEADER_SIZE ((sizeof (Chunk) + CHUNK_ALIGN - 1) & ~(CHUNK_ALIGN - 1))
+
+static void
+chunk_release (Chunk *chunk)
+{
+  if (g_atomic_int_dec_and_test (&chunk->n_users))
+    g_aligned_free (chunk);
+}
+
+static Chunk *
+chunk_new (void)
+{
+  Chunk *chunk;
+
+  chunk = g_aligned_alloc0 (1, CHUNK_SIZE, CHUNK_SIZE);
+  chunk->n_users = 1;
+  chunk->used = CHUNK_HEADER_SIZE;
+
+  return chunk;
+}
+
+static void
+arena_state_free (gpointer data)
+{
+  ArenaState *state = data;
+
+  g_clear_pointer (&state->chunk, chunk_release);
+  g_free (state);
+}
+
+static GPrivate arena_state = G_PRIVATE_INIT (arena_state_free);
+
+/*< private >
+ * gsk_render_node_arena_push:
+ *
+ * Makes render nodes created on the current thread come from
+ * the node arena, until the matching call to
+ * gsk_render_node_arena_pop().
+ *
+ * This only has an effect when `GSK_DEBUG=node-arena` is set.
+ */
+void
+gsk_render_node_arena_push (void)
+{
+  ArenaState *state = g_private_get (&arena_state);
+
+  if (state == NULL)
+    {
+      state = g_new0 (ArenaState, 1);
+      g_private_set (&arena_state, state);
+    }
+
+  if (state->depth++ == 0)
+    state->enabled = gsk_check_debug_flags (GSK_DEBUG_NODE_ARENA);
+}
+
+/*< private >
+ * gsk_render_node_arena_pop:
+ *
+ * Undoes the effect of gsk_render_node_arena_push().
+ *
+ * Nodes that were allocated from the arena stay valid.
+ */
+void
+gsk_render_node_arena_pop (void)
+{
+  ArenaState *state = g_private_get (&arena_state);
+
+  g_return_if_fail (state != NULL && state->depth > 0);
+
+  if (--state->depth == 0)
+    {
+      g_clear_pointer (&state->chunk, chunk_release);
+      state->enabled = FALSE;
+    }
+}
+
+/*< private >
+ * gsk_render_node_arena_alloc:
+ * @size: the number of bytes to allocate
+ *
+ * Allocates zeroed memory from the current thread's arena.
+ *
+ * Returns: (nullable): the memory, or %NULL if no arena is active
+ *   or @size is too large
+ */
+gpointer
+gsk_render_node_arena_alloc (gsize size)
+{
+  ArenaState *state = g_private_get (&arena_state);
+  gpointer mem;
+
+  if (state == NULL || !state->enabled || size > MAX_ALLOC_SIZE)
+    return NULL;
+
+  size = (size + CHUNK_ALIGN - 1) & ~(CHUNK_ALIGN - 1);
+
+  if (state->chunk == NULL || state->chunk->used + size > CHUNK_SIZE)
+    {
+      g_clear_pointer (&state->chunk, chunk_release);
+      state->chunk = chunk_new ();
+    }
+
+  mem = (guchar *) state->chunk + state->chunk->used;
+  state->chunk->used += size;
+  g_atomic_int_inc (&state->chunk->n_users);
+
+  return mem;
+}
+
+/*< private >
+ * gsk_render_node_arena_free:
+ * @mem: memory returned by gsk_render_node_arena_alloc()
+ *
+ * Releases memory allocated from an arena. This may happen
+ * on any thread.
+ */
+void
+gsk_render_node_arena_free (gpointer mem)
+{
+  chunk_release ((Chunk *) ((guintptr) mem & ~((guintptr) CHUNK_SIZE - 1)));
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+#include <glib.h>
+
+G_BEGIN_DECLS
+
+void            gsk_render_node_arena_push              (void);
+void            gsk_render_node_arena_pop               (void);
+
+gpointer        gsk_render_node_arena_alloc             (gsize     size);
+void            gsk_render_node_arena_free              (gpointer  mem);
+
+G_END_DECLS
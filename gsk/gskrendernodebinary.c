@@ -0,0 +1,1727 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskrendernodebinaryprivate.h"
+
+#include "gskpath.h"
+#include "gskrendernodeprivate.h"
+#include "gskstroke.h"
+#include "gsktransformprivate.h"
+#include "gdk/gdkmemoryformatprivate.h"
+#include "gdk/gdktextureprivate.h"
+
+#include <pango/pangocairo.h>
+#include <math.h>
+#include <string.h>
+
+/* The binary format starts with a magic and a version number, followed
+ * by a sequence of records. A record is only ever referred to by records
+ * following it, so loading is a single pass over the data.
+ *
+ * Records refer to earlier records of the same kind by index, which is
+ * how nodes, textures, strings and glyph data are deduplicated. The last
+ * node record is the root node.
+ *
+ * All values are stored little-endian. The pixel data of textures is
+ * aligned to TEXTURE_ALIGNMENT bytes and is not copied when loading,
+ * so data obtained via g_mapped_file_get_bytes() is used in place.
+ */
+
+static const guchar magic[8] = { 0x89, 'G', 'S', 'K', '\r', '\n', 0x1a, '\n' };
+
+#define BINARY_VERSION 1
+#define TEXTURE_ALIGNMENT 16
+#define NO_INDEX G_MAXUINT32
+
+typedef enum {
+  RECORD_NODE = 1,
+  RECORD_TEXTURE,
+  RECORD_STRING,
+  RECORD_BLOB,
+} RecordType;
+
+gboolean
+gsk_render_node_binary_is_binary (GBytes *bytes)
+{
+  gsize size;
+  const guchar *data = g_bytes_get_data (bytes, &size);
+
+  return size >= sizeof (magic) && memcmp (data, magic, sizeof (magic)) == 0;
+}
+
+/* {{{ Writing */
+
+typedef struct
+{
+  GByteArray *data;
+  GHashTable *nodes;
+  GHashTable *textures;
+  GHashTable *strings;
+  GHashTable *blobs;
+} Writer;
+
+static void
+write_u8 (Writer  *writer,
+          guint8   value)
+{
+  g_byte_array_append (writer->data, &value, 1);
+}
+
+static void
+write_u32 (Writer  *writer,
+           guint32  value)
+{
+  value = GUINT32_TO_LE (value);
+  g_byte_array_append (writer->data, (guchar *) &value, 4);
+}
+
+static void
+write_float (Writer *writer,
+             float   value)
+{
+  union { float f; guint32 u; } u = { .f = value };
+
+  write_u32 (writer, u.u);
+}
+
+static void
+write_point (Writer                 *writer,
+             const graphene_point_t *point)
+{
+  write_float (writer, point->x);
+  write_float (writer, point->y);
+}
+
+static void
+write_rect (Writer                *writer,
+            const graphene_rect_t *rect)
+{
+  write_float (writer, rect->origin.x);
+  write_float (writer, rect->origin.y);
+  write_float (writer, rect->size.width);
+  write_float (writer, rect->size.height);
+}
+
+static void
+write_rounded_rect (Writer               *writer,
+                    const GskRoundedRect *rect)
+{
+  write_rect (writer, &rect->bounds);
+  for (int i = 0; i < 4; i++)
+    {
+      write_float (writer, rect->corner[i].width);
+      write_float (writer, rect->corner[i].height);
+    }
+}
+
+static void
+write_rgba (Writer        *writer,
+            const GdkRGBA *rgba)
+{
+  write_float (writer, rgba->red);
+  write_float (writer, rgba->green);
+  write_float (writer, rgba->blue);
+  write_float (writer, rgba->alpha);
+}
+
+static void
+write_stops (Writer             *writer,
+             const GskColorStop *stops,
+             gsize               n_stops)
+{
+  write_u32 (writer, n_stops);
+  for (gsize i = 0; i < n_stops; i++)
+    {
+      write_float (writer, stops[i].offset);
+      write_rgba (writer, &stops[i].color);
+    }
+}
+
+static void
+write_align (Writer *writer,
+             gsize   alignment)
+{
+  static const guchar zeros[TEXTURE_ALIGNMENT] = { 0, };
+  gsize pad;
+
+  pad = (alignment - writer->data->len % alignment) % alignment;
+  g_byte_array_append (writer->data, zeros, pad);
+}
+
+static guint32
+writer_add_string (Writer     *writer,
+                   const char *string)
+{
+  gpointer value;
+  guint32 index;
+
+  if (string == NULL)
+    return NO_INDEX;
+
+  if (g_hash_table_lookup_extended (writer->strings, string, NULL, &value))
+    return GPOINTER_TO_UINT (value);
+
+  index = g_hash_table_size (writer->strings);
+  g_hash_table_insert (writer->strings, g_strdup (string), GUINT_TO_POINTER (index));
+
+  write_u8 (writer, RECORD_STRING);
+  write_u32 (writer, strlen (string));
+  g_byte_array_append (writer->data, (const guchar *) string, strlen (string));
+
+  return index;
+}
+
+static guint32
+writer_add_blob (Writer *writer,
+                 GBytes *bytes)
+{
+  gpointer value;
+  guint32 index;
+  gsize size;
+  const guchar *data;
+
+  if (g_hash_table_lookup_extended (writer->blobs, bytes, NULL, &value))
+    {
+      g_bytes_unref (bytes);
+      return GPOINTER_TO_UINT (value);
+    }
+
+  index = g_hash_table_size (writer->blobs);
+  g_hash_table_insert (writer->blobs, bytes, GUINT_TO_POINTER (index));
+
+  data = g_bytes_get_data (bytes, &size);
+  write_u8 (writer, RECORD_BLOB);
+  write_u32 (writer, size);
+  g_byte_array_append (writer->data, data, size);
+
+  return index;
+}
+
+static guint32
+writer_add_texture (Writer     *writer,
+                    GdkTexture *texture)
+{
+  GdkTextureDownloader downloader;
+  GdkMemoryFormat format;
+  gpointer value;
+  guint32 index;
+  GBytes *bytes;
+  gsize stride;
+  int width, height;
+
+  if (g_hash_table_lookup_extended (writer->textures, texture, NULL, &value))
+    return GPOINTER_TO_UINT (value);
+
+  index = g_hash_table_size (writer->textures);
+  g_hash_table_insert (writer->textures, g_object_ref (texture), GUINT_TO_POINTER (index));
+
+  width = gdk_texture_get_width (texture);
+  height = gdk_texture_get_height (texture);
+  format = gdk_texture_get_format (texture);
+
+  gdk_texture_downloader_init (&downloader, texture);
+  gdk_texture_downloader_set_format (&downloader, format);
+  bytes = gdk_texture_downloader_download_bytes (&downloader, &stride);
+  gdk_texture_downloader_finish (&downloader);
+
+  write_u8 (writer, RECORD_TEXTURE);
+  write_u32 (writer, width);
+  write_u32 (writer, height);
+  write_u32 (writer, format);
+  write_u32 (writer, stride);
+  write_align (writer, TEXTURE_ALIGNMENT);
+  g_byte_array_append (writer->data, g_bytes_get_data (bytes, NULL), stride * height);
+
+  g_bytes_unref (bytes);
+
+  return index;
+}
+
+static guint32
+writer_add_cairo_surface (Writer                *writer,
+                          cairo_surface_t       *surface,
+                          const graphene_rect_t *bounds)
+{
+  GdkTexture *texture;
+  guint32 index;
+
+  if (cairo_surface_get_type (surface) == CAIRO_SURFACE_TYPE_IMAGE)
+    {
+      texture = gdk_texture_new_for_surface (surface);
+    }
+  else
+    {
+      cairo_surface_t *image;
+      cairo_t *cr;
+
+      image = cairo_image_surface_create (CAIRO_FORMAT_ARGB32,
+                                          MAX (1, ceil (bounds->size.width)),
+                                          MAX (1, ceil (bounds->size.height)));
+      cr = cairo_create (image);
+      cairo_set_source_surface (cr, surface, 0, 0);
+      cairo_paint (cr);
+      cairo_destroy (cr);
+
+      texture = gdk_texture_new_for_surface (image);
+      cairo_surface_destroy (image);
+    }
+
+  index = writer_add_texture (writer, texture);
+  g_object_unref (texture);
+
+  return index;
+}
+
+static guint32
+writer_add_glyphs (Writer                *writer,
+                   const PangoGlyphInfo  *glyphs,
+                   guint                  n_glyphs)
+{
+  GByteArray *array;
+  guint32 values[5];
+
+  array = g_byte_array_sized_new (n_glyphs * sizeof (values));
+  for (guint i = 0; i < n_glyphs; i++)
+    {
+      values[0] = GUINT32_TO_LE (glyphs[i].glyph);
+      values[1] = GUINT32_TO_LE ((guint32) glyphs[i].geometry.width);
+      values[2] = GUINT32_TO_LE ((guint32) glyphs[i].geometry.x_offset);
+      values[3] = GUINT32_TO_LE ((guint32) glyphs[i].geometry.y_offset);
+      values[4] = GUINT32_TO_LE ((glyphs[i].attr.is_cluster_start ? 1 : 0) |
+                                 (glyphs[i].attr.is_color ? 2 : 0));
+      g_byte_array_append (array, (guchar *) values, sizeof (values));
+    }
+
+  return writer_add_blob (writer, g_byte_array_free_to_bytes (array));
+}
+
+static guint32 writer_add_node (Writer        *writer,
+                                GskRenderNode *node);
+
+static void
+write_node_header (Writer            *writer,
+                   GskRenderNodeType  type)
+{
+  write_u8 (writer, RECORD_NODE);
+  write_u32 (writer, type);
+}
+
+static guint32
+writer_add_node (Writer        *writer,
+                 GskRenderNode *node)
+{
+  GskRenderNodeType type;
+  gpointer value;
+  guint32 index;
+
+  if (g_hash_table_lookup_extended (writer->nodes, node, NULL, &value))
+    return GPOINTER_TO_UINT (value);
+
+  type = gsk_render_node_get_node_type (node);
+
+  /* Referenced records must be written first, so every case adds
+   * those before writing the node itself.
+   */
+  switch (type)
+    {
+    case GSK_CONTAINER_NODE:
+      {
+        guint n = gsk_container_node_get_n_children (node);
+        guint32 *children = g_new (guint32, MAX (n, 1));
+
+        for (guint i = 0; i < n; i++)
+          children[i] = writer_add_node (writer, gsk_container_node_get_child (node, i));
+
+        write_node_header (writer, type);
+        write_u32 (writer, n);
+        for (guint i = 0; i < n; i++)
+          write_u32 (writer, children[i]);
+
+        g_free (children);
+      }
+      break;
+
+    case GSK_CAIRO_NODE:
+      {
+        cairo_surface_t *surface = gsk_cairo_node_get_surface (node);
+        guint32 pixels = NO_INDEX;
+
+        if (surface != NULL)
+          pixels = writer_add_cairo_surface (writer, surface, &node->bounds);
+
+        write_node_header (writer, type);
+        write_rect (writer, &node->bounds);
+        write_u32 (writer, pixels);
+      }
+      break;
+
+    case GSK_COLOR_NODE:
+      write_node_header (writer, type);
+      write_rect (writer, &node->bounds);
+      write_rgba (writer, gsk_color_node_get_color (node));
+      break;
+
+    case GSK_LINEAR_GRADIENT_NODE:
+    case GSK_REPEATING_LINEAR_GRADIENT_NODE:
+      write_node_header (writer, type);
+      write_rect (writer, &node->bounds);
+      write_point (writer, gsk_linear_gradient_node_get_start (node));
+      write_point (writer, gsk_linear_gradient_node_get_end (node));
+      write_stops (writer,
+                   gsk_linear_gradient_node_get_color_stops (node, NULL),
+                   gsk_linear_gradient_node_get_n_color_stops (node));
+      break;
+
+    case GSK_RADIAL_GRADIENT_NODE:
+    case GSK_REPEATING_RADIAL_GRADIENT_NODE:
+      write_node_header (writer, type);
+      write_rect (writer, &node->bounds);
+      write_point (writer, gsk_radial_gradient_node_get_center (node));
+      write_float (writer, gsk_radial_gradient_node_get_hradius (node));
+      write_float (writer, gsk_radial_gradient_node_get_vradius (node));
+      write_float (writer, gsk_radial_gradient_node_get_start (node));
+      write_float (writer, gsk_radial_gradient_node_get_end (node));
+      write_stops (writer,
+                   gsk_radial_gradient_node_get_color_stops (node, NULL),
+                   gsk_radial_gradient_node_get_n_color_stops (node));
+      break;
+
+    case GSK_CONIC_GRADIENT_NODE:
+      write_node_header (writer, type);
+      write_rect (writer, &node->bounds);
+      write_point (writer, gsk_conic_gradient_node_get_center (node));
+      write_float (writer, gsk_conic_gradient_node_get_rotation (node));
+      write_stops (writer,
+                   gsk_conic_gradient_node_get_color_stops (node, NULL),
+                   gsk_conic_gradient_node_get_n_color_stops (node));
+      break;
+
+    case GSK_BORDER_NODE:
+      {
+        const float *widths = gsk_border_node_get_widths (node);
+        const GdkRGBA *colors = gsk_border_node_get_colors (node);
+
+        write_node_header (writer, type);
+        write_rounded_rect (writer, gsk_border_node_get_outline (node));
+        for (int i = 0; i < 4; i++)
+          write_float (writer, widths[i]);
+        for (int i = 0; i < 4; i++)
+          write_rgba (writer, &colors[i]);
+      }
+      break;
+
+    case GSK_TEXTURE_NODE:
+      {
+        guint32 texture = writer_add_texture (writer, gsk_texture_node_get_texture (node));
+
+        write_node_header (writer, type);
+        write_rect (writer, &node->bounds);
+        write_u32 (writer, texture);
+      }
+      break;
+
+    case GSK_TEXTURE_SCALE_NODE:
+      {
+        guint32 texture = writer_add_texture (writer, gsk_texture_scale_node_get_texture (node));
+
+        write_node_header (writer, type);
+        write_rect (writer, &node->bounds);
+        write_u32 (writer, texture);
+        write_u32 (writer, gsk_texture_scale_node_get_filter (node));
+      }
+      break;
+
+    case GSK_INSET_SHADOW_NODE:
+      write_node_header (writer, type);
+      write_rounded_rect (writer, gsk_inset_shadow_node_get_outline (node));
+      write_rgba (writer, gsk_inset_shadow_node_get_color (node));
+      write_float (writer, gsk_inset_shadow_node_get_dx (node));
+      write_float (writer, gsk_inset_shadow_node_get_dy (node));
+      write_float (writer, gsk_inset_shadow_node_get_spread (node));
+      write_float (writer, gsk_inset_shadow_node_get_blur_radius (node));
+      break;
+
+    case GSK_OUTSET_SHADOW_NODE:
+      write_node_header (writer, type);
+      write_rounded_rect (writer, gsk_outset_shadow_node_get_outline (node));
+      write_rgba (writer, gsk_outset_shadow_node_get_color (node));
+      write_float (writer, gsk_outset_shadow_node_get_dx (node));
+      write_float (writer, gsk_outset_shadow_node_get_dy (node));
+      write_float (writer, gsk_outset_shadow_node_get_spread (node));
+      write_float (writer, gsk_outset_shadow_node_get_blur_radius (node));
+      break;
+
+    case GSK_TRANSFORM_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_transform_node_get_child (node));
+        char *str = gsk_transform_to_string (gsk_transform_node_get_transform (node));
+        guint32 transform = writer_add_string (writer, str);
+
+        g_free (str);
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_u32 (writer, transform);
+      }
+      break;
+
+    case GSK_OPACITY_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_opacity_node_get_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_float (writer, gsk_opacity_node_get_opacity (node));
+      }
+      break;
+
+    case GSK_COLOR_MATRIX_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_color_matrix_node_get_child (node));
+        float matrix[16], offset[4];
+
+        graphene_matrix_to_float (gsk_color_matrix_node_get_color_matrix (node), matrix);
+        graphene_vec4_to_float (gsk_color_matrix_node_get_color_offset (node), offset);
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        for (int i = 0; i < 16; i++)
+          write_float (writer, matrix[i]);
+        for (int i = 0; i < 4; i++)
+          write_float (writer, offset[i]);
+      }
+      break;
+
+    case GSK_REPEAT_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_repeat_node_get_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_rect (writer, &node->bounds);
+        write_rect (writer, gsk_repeat_node_get_child_bounds (node));
+      }
+      break;
+
+    case GSK_CLIP_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_clip_node_get_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_rect (writer, gsk_clip_node_get_clip (node));
+      }
+      break;
+
+    case GSK_ROUNDED_CLIP_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_rounded_clip_node_get_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_rounded_rect (writer, gsk_rounded_clip_node_get_clip (node));
+      }
+      break;
+
+    case GSK_FILL_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_fill_node_get_child (node));
+        char *str = gsk_path_to_string (gsk_fill_node_get_path (node));
+        guint32 path = writer_add_string (writer, str);
+
+        g_free (str);
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_u32 (writer, path);
+        write_u32 (writer, gsk_fill_node_get_fill_rule (node));
+      }
+      break;
+
+    case GSK_STROKE_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_stroke_node_get_child (node));
+        char *str = gsk_path_to_string (gsk_stroke_node_get_path (node));
+        guint32 path = writer_add_string (writer, str);
+        const GskStroke *stroke = gsk_stroke_node_get_stroke (node);
+        const float *dash;
+        gsize n_dash;
+
+        g_free (str);
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_u32 (writer, path);
+        write_float (writer, gsk_stroke_get_line_width (stroke));
+        write_u32 (writer, gsk_stroke_get_line_cap (stroke));
+        write_u32 (writer, gsk_stroke_get_line_join (stroke));
+        write_float (writer, gsk_stroke_get_miter_limit (stroke));
+        write_float (writer, gsk_stroke_get_dash_offset (stroke));
+        dash = gsk_stroke_get_dash (stroke, &n_dash);
+        write_u32 (writer, n_dash);
+        for (gsize i = 0; i < n_dash; i++)
+          write_float (writer, dash[i]);
+      }
+      break;
+
+    case GSK_SHADOW_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_shadow_node_get_child (node));
+        gsize n = gsk_shadow_node_get_n_shadows (node);
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_u32 (writer, n);
+        for (gsize i = 0; i < n; i++)
+          {
+            const GskShadow *shadow = gsk_shadow_node_get_shadow (node, i);
+
+            write_rgba (writer, &shadow->color);
+            write_float (writer, shadow->dx);
+            write_float (writer, shadow->dy);
+            write_float (writer, shadow->radius);
+          }
+      }
+      break;
+
+    case GSK_BLEND_NODE:
+      {
+        guint32 bottom = writer_add_node (writer, gsk_blend_node_get_bottom_child (node));
+        guint32 top = writer_add_node (writer, gsk_blend_node_get_top_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, bottom);
+        write_u32 (writer, top);
+        write_u32 (writer, gsk_blend_node_get_blend_mode (node));
+      }
+      break;
+
+    case GSK_CROSS_FADE_NODE:
+      {
+        guint32 start = writer_add_node (writer, gsk_cross_fade_node_get_start_child (node));
+        guint32 end = writer_add_node (writer, gsk_cross_fade_node_get_end_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, start);
+        write_u32 (writer, end);
+        write_float (writer, gsk_cross_fade_node_get_progress (node));
+      }
+      break;
+
+    case GSK_TEXT_NODE:
+      {
+        PangoFontDescription *desc;
+        const PangoGlyphInfo *glyphs;
+        guint32 font, glyph_data;
+        guint n_glyphs;
+        char *str;
+
+        desc = pango_font_describe (gsk_text_node_get_font (node));
+        str = pango_font_description_to_string (desc);
+        font = writer_add_string (writer, str);
+        g_free (str);
+        pango_font_description_free (desc);
+
+        glyphs = gsk_text_node_get_glyphs (node, &n_glyphs);
+        glyph_data = writer_add_glyphs (writer, glyphs, n_glyphs);
+
+        write_node_header (writer, type);
+        write_u32 (writer, font);
+        write_u32 (writer, glyph_data);
+        write_rgba (writer, gsk_text_node_get_color (node));
+        write_point (writer, gsk_text_node_get_offset (node));
+      }
+      break;
+
+    case GSK_BLUR_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_blur_node_get_child (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_float (writer, gsk_blur_node_get_radius (node));
+      }
+      break;
+
+    case GSK_MASK_NODE:
+      {
+        guint32 source = writer_add_node (writer, gsk_mask_node_get_source (node));
+        guint32 mask = writer_add_node (writer, gsk_mask_node_get_mask (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, source);
+        write_u32 (writer, mask);
+        write_u32 (writer, gsk_mask_node_get_mask_mode (node));
+      }
+      break;
+
+    case GSK_DEBUG_NODE:
+      {
+        guint32 child = writer_add_node (writer, gsk_debug_node_get_child (node));
+        guint32 message = writer_add_string (writer, gsk_debug_node_get_message (node));
+
+        write_node_header (writer, type);
+        write_u32 (writer, child);
+        write_u32 (writer, message);
+      }
+      break;
+
+    case GSK_GL_SHADER_NODE:
+      {
+        GskGLShader *shader = gsk_gl_shader_node_get_shader (node);
+        guint n = gsk_gl_shader_node_get_n_children (node);
+        guint32 *children = g_newa (guint32, MAX (n, 1));
+        guint32 source, args;
+        char *str;
+
+        for (guint i = 0; i < n; i++)
+          children[i] = writer_add_node (writer, gsk_gl_shader_node_get_child (node, i));
+
+        str = g_strndup (g_bytes_get_data (gsk_gl_shader_get_source (shader), NULL),
+                         g_bytes_get_size (gsk_gl_shader_get_source (shader)));
+        source = writer_add_string (writer, str);
+        g_free (str);
+        args = writer_add_blob (writer, g_bytes_ref (gsk_gl_shader_node_get_args (node)));
+
+        write_node_header (writer, type);
+        write_rect (writer, &node->bounds);
+        write_u32 (writer, source);
+        write_u32 (writer, args);
+        write_u32 (writer, n);
+        for (guint i = 0; i < n; i++)
+          write_u32 (writer, children[i]);
+      }
+      break;
+
+    case GSK_NOT_A_RENDER_NODE:
+    default:
+      g_assert_not_reached ();
+      break;
+    }
+
+  index = g_hash_table_size (writer->nodes);
+  g_hash_table_insert (writer->nodes, gsk_render_node_ref (node), GUINT_TO_POINTER (index));
+
+  return index;
+}
+
+GBytes *
+gsk_render_node_binary_serialize (GskRenderNode *node)
+{
+  Writer writer;
+
+  writer.data = g_byte_array_new ();
+  writer.nodes = g_hash_table_new_full (NULL, NULL, (GDestroyNotify) gsk_render_node_unref, NULL);
+  writer.textures = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  writer.strings = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  writer.blobs = g_hash_table_new_full (g_bytes_hash, g_bytes_equal, (GDestroyNotify) g_bytes_unref, NULL);
+
+  g_byte_array_append (writer.data, magic, sizeof (magic));
+  write_u32 (&writer, BINARY_VERSION);
+
+  writer_add_node (&writer, node);
+
+  g_hash_table_unref (writer.nodes);
+  g_hash_table_unref (writer.textures);
+  g_hash_table_unref (writer.strings);
+  g_hash_table_unref (writer.blobs);
+
+  return g_byte_array_free_to_bytes (writer.data);
+}
+
+/* }}} */
+/* {{{ Reading */
+
+typedef struct
+{
+  GBytes *bytes;
+  const guchar *data;
+  gsize size;
+  gsize pos;
+
+  GPtrArray *nodes;
+  GPtrArray *textures;
+  GPtrArray *strings;
+  GPtrArray *blobs;
+  GHashTable *fonts;
+
+  GskParseErrorFunc error_func;
+  gpointer user_data;
+  gboolean failed;
+} Reader;
+
+static void G_GNUC_PRINTF (3, 4)
+reader_error (Reader     *reader,
+              int         code,
+              const char *format,
+              ...)
+{
+  GskParseLocation location = { 0, };
+  GError *error;
+  va_list args;
+
+  if (reader->failed)
+    return;
+
+  reader->failed = TRUE;
+
+  if (reader->error_func == NULL)
+    return;
+
+  va_start (args, format);
+  error = g_error_new_valist (GSK_SERIALIZATION_ERROR, code, format, args);
+  va_end (args);
+
+  location.bytes = reader->pos;
+  location.chars = reader->pos;
+  location.line_bytes = reader->pos;
+  location.line_chars = reader->pos;
+
+  reader->error_func (&location, &location, error, reader->user_data);
+
+  g_error_free (error);
+}
+
+static const guchar *
+read_data (Reader *reader,
+           gsize   size)
+{
+  const guchar *data;
+
+  if (reader->failed)
+    return NULL;
+
+  if (size > reader->size - reader->pos)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Unexpected end of data");
+      return NULL;
+    }
+
+  data = reader->data + reader->pos;
+  reader->pos += size;
+
+  return data;
+}
+
+static guint8
+read_u8 (Reader *reader)
+{
+  const guchar *data = read_data (reader, 1);
+
+  return data ? data[0] : 0;
+}
+
+static guint32
+read_u32 (Reader *reader)
+{
+  const guchar *data = read_data (reader, 4);
+  guint32 value;
+
+  if (data == NULL)
+    return 0;
+
+  memcpy (&value, data, 4);
+
+  return GUINT32_FROM_LE (value);
+}
+
+static float
+read_float (Reader *reader)
+{
+  union { float f; guint32 u; } u = { .u = read_u32 (reader) };
+
+  return u.f;
+}
+
+static guint32
+read_enum (Reader     *reader,
+           guint32     max,
+           const char *name)
+{
+  guint32 value = read_u32 (reader);
+
+  if (value > max)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid %s %u", name, value);
+      return 0;
+    }
+
+  return value;
+}
+
+static void
+read_point (Reader           *reader,
+            graphene_point_t *point)
+{
+  point->x = read_float (reader);
+  point->y = read_float (reader);
+}
+
+static void
+read_rect (Reader          *reader,
+           graphene_rect_t *rect)
+{
+  rect->origin.x = read_float (reader);
+  rect->origin.y = read_float (reader);
+  rect->size.width = read_float (reader);
+  rect->size.height = read_float (reader);
+}
+
+static void
+read_rounded_rect (Reader         *reader,
+                   GskRoundedRect *rect)
+{
+  read_rect (reader, &rect->bounds);
+  for (int i = 0; i < 4; i++)
+    {
+      rect->corner[i].width = read_float (reader);
+      rect->corner[i].height = read_float (reader);
+    }
+}
+
+static void
+read_rgba (Reader  *reader,
+           GdkRGBA *rgba)
+{
+  rgba->red = read_float (reader);
+  rgba->green = read_float (reader);
+  rgba->blue = read_float (reader);
+  rgba->alpha = read_float (reader);
+}
+
+static guint32
+read_count (Reader *reader,
+            gsize   element_size)
+{
+  guint32 n = read_u32 (reader);
+
+  /* Catch bogus counts before allocating for them */
+  if (element_size > 0 && n > (reader->size - reader->pos) / element_size)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid count %u", n);
+      return 0;
+    }
+
+  return n;
+}
+
+static GskColorStop *
+read_stops (Reader *reader,
+            gsize  *n_stops)
+{
+  GskColorStop *stops;
+  guint32 n;
+
+  n = read_count (reader, 5 * 4);
+  if (!reader->failed && n < 2)
+    reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Gradients need at least 2 color stops");
+  if (reader->failed)
+    return NULL;
+
+  stops = g_new (GskColorStop, n);
+  for (guint32 i = 0; i < n; i++)
+    {
+      stops[i].offset = read_float (reader);
+      read_rgba (reader, &stops[i].color);
+    }
+
+  *n_stops = n;
+
+  return stops;
+}
+
+static gpointer
+read_ref (Reader     *reader,
+          GPtrArray  *array,
+          const char *name)
+{
+  guint32 index = read_u32 (reader);
+
+  if (reader->failed)
+    return NULL;
+
+  if (index >= array->len)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid %s reference %u", name, index);
+      return NULL;
+    }
+
+  return g_ptr_array_index (array, index);
+}
+
+static GskRenderNode *
+read_node_ref (Reader *reader)
+{
+  return read_ref (reader, reader->nodes, "node");
+}
+
+static const char *
+read_string_ref (Reader   *reader,
+                 gboolean  nullable)
+{
+  if (nullable)
+    {
+      guint32 index;
+
+      /* Peek for the null reference */
+      if (reader->pos + 4 <= reader->size)
+        {
+          memcpy (&index, reader->data + reader->pos, 4);
+          if (GUINT32_FROM_LE (index) == NO_INDEX)
+            {
+              reader->pos += 4;
+              return NULL;
+            }
+        }
+    }
+
+  return read_ref (reader, reader->strings, "string");
+}
+
+static void
+read_texture_record (Reader *reader)
+{
+  guint32 width, height, format, stride;
+  const guchar *data;
+  GdkTexture *texture;
+  GBytes *bytes;
+  gsize offset;
+
+  width = read_u32 (reader);
+  height = read_u32 (reader);
+  format = read_enum (reader, GDK_MEMORY_N_FORMATS - 1, "memory format");
+  stride = read_u32 (reader);
+  if (reader->failed)
+    return;
+
+  if (width == 0 || height == 0 || width > G_MAXINT || height > G_MAXINT ||
+      stride / gdk_memory_format_bytes_per_pixel (format) < width)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA,
+                    "Invalid texture of size %ux%u with stride %u", width, height, stride);
+      return;
+    }
+
+  offset = (TEXTURE_ALIGNMENT - reader->pos % TEXTURE_ALIGNMENT) % TEXTURE_ALIGNMENT;
+  if (read_data (reader, offset) == NULL)
+    return;
+
+  if (height > (reader->size - reader->pos) / stride)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Unexpected end of texture data");
+      return;
+    }
+
+  offset = reader->pos;
+  data = read_data (reader, (gsize) stride * height);
+  if (data == NULL)
+    return;
+
+  bytes = g_bytes_new_from_bytes (reader->bytes, offset, (gsize) stride * height);
+  texture = gdk_memory_texture_new (width, height, format, bytes, stride);
+  g_bytes_unref (bytes);
+
+  g_ptr_array_add (reader->textures, texture);
+}
+
+static void
+read_string_record (Reader *reader)
+{
+  guint32 size = read_count (reader, 1);
+  const guchar *data = read_data (reader, size);
+
+  if (data == NULL)
+    return;
+
+  g_ptr_array_add (reader->strings, g_strndup ((const char *) data, size));
+}
+
+static void
+read_blob_record (Reader *reader)
+{
+  guint32 size = read_count (reader, 1);
+  gsize offset = reader->pos;
+
+  if (read_data (reader, size) == NULL)
+    return;
+
+  g_ptr_array_add (reader->blobs, g_bytes_new_from_bytes (reader->bytes, offset, size));
+}
+
+static PangoFont *
+reader_get_font (Reader     *reader,
+                 const char *name)
+{
+  PangoFontDescription *desc;
+  PangoFontMap *font_map;
+  PangoContext *context;
+  PangoFont *font;
+
+  font = g_hash_table_lookup (reader->fonts, name);
+  if (font)
+    return font;
+
+  desc = pango_font_description_from_string (name);
+  font_map = pango_cairo_font_map_get_default ();
+  context = pango_font_map_create_context (font_map);
+  font = pango_font_map_load_font (font_map, context, desc);
+  pango_font_description_free (desc);
+  g_object_unref (context);
+
+  if (font)
+    g_hash_table_insert (reader->fonts, (gpointer) name, font);
+
+  return font;
+}
+
+static GskRenderNode *
+read_text_node (Reader *reader)
+{
+  const char *font_name;
+  PangoFont *font;
+  PangoGlyphString *glyphs;
+  GskRenderNode *node;
+  const guint32 *values;
+  GBytes *glyph_data;
+  graphene_point_t offset;
+  GdkRGBA color;
+  gsize size;
+
+  font_name = read_string_ref (reader, FALSE);
+  glyph_data = read_ref (reader, reader->blobs, "glyph data");
+  read_rgba (reader, &color);
+  read_point (reader, &offset);
+  if (reader->failed)
+    return NULL;
+
+  values = g_bytes_get_data (glyph_data, &size);
+  if (size == 0 || size % (5 * 4) != 0)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid glyph data");
+      return NULL;
+    }
+
+  font = reader_get_font (reader, font_name);
+  if (font == NULL)
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "The font \"%s\" does not exist", font_name);
+      return NULL;
+    }
+
+  glyphs = pango_glyph_string_new ();
+  pango_glyph_string_set_size (glyphs, size / (5 * 4));
+  for (int i = 0; i < glyphs->num_glyphs; i++)
+    {
+      guint32 v[5];
+
+      memcpy (v, values + 5 * i, sizeof (v));
+      glyphs->glyphs[i].glyph = GUINT32_FROM_LE (v[0]);
+      glyphs->glyphs[i].geometry.width = (gint32) GUINT32_FROM_LE (v[1]);
+      glyphs->glyphs[i].geometry.x_offset = (gint32) GUINT32_FROM_LE (v[2]);
+      glyphs->glyphs[i].geometry.y_offset = (gint32) GUINT32_FROM_LE (v[3]);
+      glyphs->glyphs[i].attr.is_cluster_start = (GUINT32_FROM_LE (v[4]) & 1) ? 1 : 0;
+      glyphs->glyphs[i].attr.is_color = (GUINT32_FROM_LE (v[4]) & 2) ? 1 : 0;
+    }
+
+  node = gsk_text_node_new (font, glyphs, &color, &offset);
+  pango_glyph_string_free (glyphs);
+
+  /* The glyphs may be empty with different fonts, return something */
+  if (node == NULL)
+    node = gsk_container_node_new (NULL, 0);
+
+  return node;
+}
+
+static GskRenderNode *
+read_gl_shader_node (Reader *reader)
+{
+  GskRenderNode *children[4];
+  GskRenderNode *node;
+  GskGLShader *shader;
+  graphene_rect_t bounds;
+  const char *source;
+  GBytes *args, *bytes;
+  guint32 n;
+
+  read_rect (reader, &bounds);
+  source = read_string_ref (reader, FALSE);
+  args = read_ref (reader, reader->blobs, "shader arguments");
+  n = read_u32 (reader);
+  if (!reader->failed && n > G_N_ELEMENTS (children))
+    reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Too many shader children");
+  for (guint32 i = 0; i < n && !reader->failed; i++)
+    children[i] = read_node_ref (reader);
+  if (reader->failed)
+    return NULL;
+
+  bytes = g_bytes_new (source, strlen (source));
+  shader = gsk_gl_shader_new_from_bytes (bytes);
+  g_bytes_unref (bytes);
+
+  if (gsk_gl_shader_get_args_size (shader) != g_bytes_get_size (args))
+    {
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Shader arguments don't match the shader");
+      g_object_unref (shader);
+      return NULL;
+    }
+
+  node = gsk_gl_shader_node_new (shader, &bounds, args, children, n);
+  g_object_unref (shader);
+
+  return node;
+}
+
+static GskRenderNode *
+read_node (Reader *reader)
+{
+  GskRenderNodeType type;
+  GskRenderNode *node = NULL;
+
+  type = read_enum (reader, GSK_RENDER_NODE_TYPE_N_TYPES - 1, "node type");
+  if (reader->failed)
+    return NULL;
+
+  switch (type)
+    {
+    case GSK_CONTAINER_NODE:
+      {
+        guint32 n = read_count (reader, 4);
+        GskRenderNode **children = g_new (GskRenderNode *, MAX (n, 1));
+
+        for (guint32 i = 0; i < n; i++)
+          children[i] = read_node_ref (reader);
+        if (!reader->failed)
+          node = gsk_container_node_new (children, n);
+        g_free (children);
+      }
+      break;
+
+    case GSK_CAIRO_NODE:
+      {
+        graphene_rect_t bounds;
+        GdkTexture *pixels = NULL;
+        guint32 index;
+
+        read_rect (reader, &bounds);
+        index = read_u32 (reader);
+        if (reader->failed)
+          break;
+
+        if (index != NO_INDEX)
+          {
+            if (index >= reader->textures->len)
+              {
+                reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid texture reference %u", index);
+                break;
+              }
+            pixels = g_ptr_array_index (reader->textures, index);
+          }
+
+        node = gsk_cairo_node_new (&bounds);
+        if (pixels)
+          {
+            cairo_t *cr = gsk_cairo_node_get_draw_context (node);
+            cairo_surface_t *surface = gdk_texture_download_surface (pixels);
+
+            cairo_set_source_surface (cr, surface, 0, 0);
+            cairo_paint (cr);
+            cairo_destroy (cr);
+            cairo_surface_destroy (surface);
+          }
+      }
+      break;
+
+    case GSK_COLOR_NODE:
+      {
+        graphene_rect_t bounds;
+        GdkRGBA color;
+
+        read_rect (reader, &bounds);
+        read_rgba (reader, &color);
+        if (!reader->failed)
+          node = gsk_color_node_new (&color, &bounds);
+      }
+      break;
+
+    case GSK_LINEAR_GRADIENT_NODE:
+    case GSK_REPEATING_LINEAR_GRADIENT_NODE:
+      {
+        graphene_rect_t bounds;
+        graphene_point_t start, end;
+        GskColorStop *stops;
+        gsize n_stops;
+
+        read_rect (reader, &bounds);
+        read_point (reader, &start);
+        read_point (reader, &end);
+        stops = read_stops (reader, &n_stops);
+        if (reader->failed)
+          break;
+
+        if (type == GSK_LINEAR_GRADIENT_NODE)
+          node = gsk_linear_gradient_node_new (&bounds, &start, &end, stops, n_stops);
+        else
+          node = gsk_repeating_linear_gradient_node_new (&bounds, &start, &end, stops, n_stops);
+        g_free (stops);
+      }
+      break;
+
+    case GSK_RADIAL_GRADIENT_NODE:
+    case GSK_REPEATING_RADIAL_GRADIENT_NODE:
+      {
+        graphene_rect_t bounds;
+        graphene_point_t center;
+        float hradius, vradius, start, end;
+        GskColorStop *stops;
+        gsize n_stops;
+
+        read_rect (reader, &bounds);
+        read_point (reader, &center);
+        hradius = read_float (reader);
+        vradius = read_float (reader);
+        start = read_float (reader);
+        end = read_float (reader);
+        stops = read_stops (reader, &n_stops);
+        if (reader->failed)
+          break;
+
+        if (type == GSK_RADIAL_GRADIENT_NODE)
+          node = gsk_radial_gradient_node_new (&bounds, &center, hradius, vradius, start, end, stops, n_stops);
+        else
+          node = gsk_repeating_radial_gradient_node_new (&bounds, &center, hradius, vradius, start, end, stops, n_stops);
+        g_free (stops);
+      }
+      break;
+
+    case GSK_CONIC_GRADIENT_NODE:
+      {
+        graphene_rect_t bounds;
+        graphene_point_t center;
+        GskColorStop *stops;
+        gsize n_stops;
+        float rotation;
+
+        read_rect (reader, &bounds);
+        read_point (reader, &center);
+        rotation = read_float (reader);
+        stops = read_stops (reader, &n_stops);
+        if (reader->failed)
+          break;
+
+        node = gsk_conic_gradient_node_new (&bounds, &center, rotation, stops, n_stops);
+        g_free (stops);
+      }
+      break;
+
+    case GSK_BORDER_NODE:
+      {
+        GskRoundedRect outline;
+        float widths[4];
+        GdkRGBA colors[4];
+
+        read_rounded_rect (reader, &outline);
+        for (int i = 0; i < 4; i++)
+          widths[i] = read_float (reader);
+        for (int i = 0; i < 4; i++)
+          read_rgba (reader, &colors[i]);
+        if (!reader->failed)
+          node = gsk_border_node_new (&outline, widths, colors);
+      }
+      break;
+
+    case GSK_TEXTURE_NODE:
+      {
+        graphene_rect_t bounds;
+        GdkTexture *texture;
+
+        read_rect (reader, &bounds);
+        texture = read_ref (reader, reader->textures, "texture");
+        if (!reader->failed)
+          node = gsk_texture_node_new (texture, &bounds);
+      }
+      break;
+
+    case GSK_TEXTURE_SCALE_NODE:
+      {
+        graphene_rect_t bounds;
+        GdkTexture *texture;
+        GskScalingFilter filter;
+
+        read_rect (reader, &bounds);
+        texture = read_ref (reader, reader->textures, "texture");
+        filter = read_enum (reader, GSK_SCALING_FILTER_TRILINEAR, "scaling filter");
+        if (!reader->failed)
+          node = gsk_texture_scale_node_new (texture, &bounds, filter);
+      }
+      break;
+
+    case GSK_INSET_SHADOW_NODE:
+    case GSK_OUTSET_SHADOW_NODE:
+      {
+        GskRoundedRect outline;
+        GdkRGBA color;
+        float dx, dy, spread, blur_radius;
+
+        read_rounded_rect (reader, &outline);
+        read_rgba (reader, &color);
+        dx = read_float (reader);
+        dy = read_float (reader);
+        spread = read_float (reader);
+        blur_radius = read_float (reader);
+        if (reader->failed)
+          break;
+
+        if (type == GSK_INSET_SHADOW_NODE)
+          node = gsk_inset_shadow_node_new (&outline, &color, dx, dy, spread, blur_radius);
+        else
+          node = gsk_outset_shadow_node_new (&outline, &color, dx, dy, spread, blur_radius);
+      }
+      break;
+
+    case GSK_TRANSFORM_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        const char *str = read_string_ref (reader, FALSE);
+        GskTransform *transform;
+
+        if (reader->failed)
+          break;
+
+        if (!gsk_transform_parse (str, &transform))
+          {
+            reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid transform \"%s\"", str);
+            break;
+          }
+
+        node = gsk_transform_node_new (child, transform);
+        gsk_transform_unref (transform);
+      }
+      break;
+
+    case GSK_OPACITY_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        float opacity = read_float (reader);
+
+        if (!reader->failed)
+          node = gsk_opacity_node_new (child, opacity);
+      }
+      break;
+
+    case GSK_COLOR_MATRIX_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        graphene_matrix_t matrix;
+        graphene_vec4_t offset;
+        float m[16], o[4];
+
+        for (int i = 0; i < 16; i++)
+          m[i] = read_float (reader);
+        for (int i = 0; i < 4; i++)
+          o[i] = read_float (reader);
+        if (reader->failed)
+          break;
+
+        graphene_matrix_init_from_float (&matrix, m);
+        graphene_vec4_init_from_float (&offset, o);
+        node = gsk_color_matrix_node_new (child, &matrix, &offset);
+      }
+      break;
+
+    case GSK_REPEAT_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        graphene_rect_t bounds, child_bounds;
+
+        read_rect (reader, &bounds);
+        read_rect (reader, &child_bounds);
+        if (!reader->failed)
+          node = gsk_repeat_node_new (&bounds, child, &child_bounds);
+      }
+      break;
+
+    case GSK_CLIP_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        graphene_rect_t clip;
+
+        read_rect (reader, &clip);
+        if (!reader->failed)
+          node = gsk_clip_node_new (child, &clip);
+      }
+      break;
+
+    case GSK_ROUNDED_CLIP_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        GskRoundedRect clip;
+
+        read_rounded_rect (reader, &clip);
+        if (!reader->failed)
+          node = gsk_rounded_clip_node_new (child, &clip);
+      }
+      break;
+
+    case GSK_FILL_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        const char *str = read_string_ref (reader, FALSE);
+        GskFillRule fill_rule = read_enum (reader, GSK_FILL_RULE_EVEN_ODD, "fill rule");
+        GskPath *path;
+
+        if (reader->failed)
+          break;
+
+        path = gsk_path_parse (str);
+        if (path == NULL)
+          {
+            reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid path");
+            break;
+          }
+
+        node = gsk_fill_node_new (child, path, fill_rule);
+        gsk_path_unref (path);
+      }
+      break;
+
+    case GSK_STROKE_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        const char *str = read_string_ref (reader, FALSE);
+        float line_width = read_float (reader);
+        GskLineCap line_cap = read_enum (reader, GSK_LINE_CAP_SQUARE, "line cap");
+        GskLineJoin line_join = read_enum (reader, GSK_LINE_JOIN_BEVEL, "line join");
+        float miter_limit = read_float (reader);
+        float dash_offset = read_float (reader);
+        guint32 n_dash = read_count (reader, 4);
+        float *dash = g_new (float, MAX (n_dash, 1));
+        GskStroke *stroke;
+        GskPath *path;
+
+        for (guint32 i = 0; i < n_dash; i++)
+          dash[i] = read_float (reader);
+
+        if (!reader->failed)
+          {
+            path = gsk_path_parse (str);
+            if (path == NULL)
+              {
+                reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid path");
+              }
+            else
+              {
+                stroke = gsk_stroke_new (line_width);
+                gsk_stroke_set_line_cap (stroke, line_cap);
+                gsk_stroke_set_line_join (stroke, line_join);
+                gsk_stroke_set_miter_limit (stroke, miter_limit);
+                gsk_stroke_set_dash (stroke, dash, n_dash);
+                gsk_stroke_set_dash_offset (stroke, dash_offset);
+
+                node = gsk_stroke_node_new (child, path, stroke);
+
+                gsk_stroke_free (stroke);
+                gsk_path_unref (path);
+              }
+          }
+
+        g_free (dash);
+      }
+      break;
+
+    case GSK_SHADOW_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        guint32 n = read_count (reader, 7 * 4);
+        GskShadow *shadows;
+
+        if (!reader->failed && n == 0)
+          reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Shadow nodes need at least one shadow");
+        if (reader->failed)
+          break;
+
+        shadows = g_new (GskShadow, n);
+        for (guint32 i = 0; i < n; i++)
+          {
+            read_rgba (reader, &shadows[i].color);
+            shadows[i].dx = read_float (reader);
+            shadows[i].dy = read_float (reader);
+            shadows[i].radius = read_float (reader);
+          }
+
+        if (!reader->failed)
+          node = gsk_shadow_node_new (child, shadows, n);
+        g_free (shadows);
+      }
+      break;
+
+    case GSK_BLEND_NODE:
+      {
+        GskRenderNode *bottom = read_node_ref (reader);
+        GskRenderNode *top = read_node_ref (reader);
+        GskBlendMode mode = read_enum (reader, GSK_BLEND_MODE_LUMINOSITY, "blend mode");
+
+        if (!reader->failed)
+          node = gsk_blend_node_new (bottom, top, mode);
+      }
+      break;
+
+    case GSK_CROSS_FADE_NODE:
+      {
+        GskRenderNode *start = read_node_ref (reader);
+        GskRenderNode *end = read_node_ref (reader);
+        float progress = read_float (reader);
+
+        if (!reader->failed)
+          node = gsk_cross_fade_node_new (start, end, progress);
+      }
+      break;
+
+    case GSK_TEXT_NODE:
+      node = read_text_node (reader);
+      break;
+
+    case GSK_BLUR_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        float radius = read_float (reader);
+
+        if (!reader->failed)
+          node = gsk_blur_node_new (child, radius);
+      }
+      break;
+
+    case GSK_MASK_NODE:
+      {
+        GskRenderNode *source = read_node_ref (reader);
+        GskRenderNode *mask = read_node_ref (reader);
+        GskMaskMode mode = read_enum (reader, GSK_MASK_MODE_INVERTED_LUMINANCE, "mask mode");
+
+        if (!reader->failed)
+          node = gsk_mask_node_new (source, mask, mode);
+      }
+      break;
+
+    case GSK_DEBUG_NODE:
+      {
+        GskRenderNode *child = read_node_ref (reader);
+        const char *message = read_string_ref (reader, TRUE);
+
+        if (!reader->failed)
+          node = gsk_debug_node_new (child, g_strdup (message));
+      }
+      break;
+
+    case GSK_GL_SHADER_NODE:
+      node = read_gl_shader_node (reader);
+      break;
+
+    case GSK_NOT_A_RENDER_NODE:
+    default:
+      reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid node type %u", type);
+      break;
+    }
+
+  if (node == NULL && !reader->failed)
+    reader_error (reader, GSK_SERIALIZATION_INVALID_DATA, "Failed to create node");
+
+  return node;
+}
+
+GskRenderNode *
+gsk_render_node_binary_deserialize (GBytes            *bytes,
+                                    GskParseErrorFunc  error_func,
+                                    gpointer           user_data)
+{
+  Reader reader = { 0, };
+  GskRenderNode *root = NULL;
+  guint32 version;
+
+  reader.bytes = bytes;
+  reader.data = g_bytes_get_data (bytes, &reader.size);
+  reader.error_func = error_func;
+  reader.user_data = user_data;
+  reader.nodes = g_ptr_array_new_with_free_func ((GDestroyNotify) gsk_render_node_unref);
+  reader.textures = g_ptr_array_new_with_free_func (g_object_unref);
+  reader.strings = g_ptr_array_new_with_free_func (g_free);
+  reader.blobs = g_ptr_array_new_with_free_func ((GDestroyNotify) g_bytes_unref);
+  reader.fonts = g_hash_table_new_full (NULL, NULL, NULL, g_object_unref);
+
+  if (!gsk_render_node_binary_is_binary (bytes))
+    {
+      reader_error (&reader, GSK_SERIALIZATION_UNSUPPORTED_FORMAT, "Not a binary render node file");
+      goto out;
+    }
+
+  reader.pos = sizeof (magic);
+  version = read_u32 (&reader);
+  if (!reader.failed && version != BINARY_VERSION)
+    reader_error (&reader, GSK_SERIALIZATION_UNSUPPORTED_VERSION, "Unsupported version %u", version);
+
+  while (!reader.failed && reader.pos < reader.size)
+    {
+      switch (read_u8 (&reader))
+        {
+        case RECORD_NODE:
+          {
+            GskRenderNode *node = read_node (&reader);
+
+            if (node)
+              g_ptr_array_add (reader.nodes, node);
+          }
+          break;
+
+        case RECORD_TEXTURE:
+          read_texture_record (&reader);
+          break;
+
+        case RECORD_STRING:
+          read_string_record (&reader);
+          break;
+
+        case RECORD_BLOB:
+          read_blob_record (&reader);
+          break;
+
+        default:
+          reader.pos--;
+          reader_error (&reader, GSK_SERIALIZATION_INVALID_DATA, "Invalid record");
+          break;
+        }
+    }
+
+  if (!reader.failed && reader.nodes->len == 0)
+    reader_error (&reader, GSK_SERIALIZATION_INVALID_DATA, "No render node found");
+
+  if (!reader.failed)
+    root = gsk_render_node_ref (g_ptr_array_index (reader.nodes, reader.nodes->len - 1));
+
+out:
+  g_ptr_array_unref (reader.nodes);
+  g_ptr_array_unref (reader.textures);
+  g_ptr_array_unref (reader.strings);
+  g_ptr_array_unref (reader.blobs);
+  g_hash_table_unref (reader.fonts);
+
+  return root;
+}
+
+/* }}} */
+
+/* vim:set foldmethod=marker expandtab: */
@@ -0,0 +1,13 @@
+#pragma once
+
+#include "gskrendernode.h"
+
+G_BEGIN_DECLS
+
+gboolean        gsk_render_node_binary_is_binary        (GBytes            *bytes);
+GBytes *        gsk_render_node_binary_serialize        (GskRenderNode     *node);
+GskRenderNode * gsk_render_node_binary_deserialize      (GBytes            *bytes,
+                                                         GskParseErrorFunc  error_func,
+                                                         gpointer           user_data);
+
+G_END_DECLS
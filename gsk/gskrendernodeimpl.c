@@ -138,6 +138,30 @@ gsk_color_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static gboolean
+gsk_color_node_get_opaque_rect (GskRenderNode   *node,
+                                graphene_rect_t *out_opaque)
+{
+  GskColorNode *self = (GskColorNode *) node;
+
+  if (self->color.alpha < 1.0)
+    return FALSE;
+
+  *out_opaque = node->bounds;
+  return TRUE;
+}
+
+static guint64
+gsk_color_node_hash (GskRenderNode *node)
+{
+  GskColorNode *self = (GskColorNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->color);
+
+  return hash;
+}
+
 static void
 gsk_color_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -148,6 +172,8 @@ gsk_color_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_color_node_draw;
   node_class->diff = gsk_color_node_diff;
+  node_class->hash = gsk_color_node_hash;
+  node_class->get_opaque_rect = gsk_color_node_get_opaque_rect;
 }
 
 /**
@@ -298,6 +324,19 @@ gsk_linear_gradient_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_linear_gradient_node_hash (GskRenderNode *node)
+{
+  GskLinearGradientNode *self = (GskLinearGradientNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->start);
+  hash = gsk_hash_value (hash, self->end);
+  hash = gsk_hash_bytes (hash, self->stops, self->n_stops * sizeof (GskColorStop));
+
+  return hash;
+}
+
 static void
 gsk_linear_gradient_node_class_init (gpointer g_class,
                                      gpointer class_data)
@@ -309,6 +348,7 @@ gsk_linear_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_linear_gradient_node_finalize;
   node_class->draw = gsk_linear_gradient_node_draw;
   node_class->diff = gsk_linear_gradient_node_diff;
+  node_class->hash = gsk_linear_gradient_node_hash;
 }
 
 static void
@@ -322,6 +362,7 @@ gsk_repeating_linear_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_linear_gradient_node_finalize;
   node_class->draw = gsk_linear_gradient_node_draw;
   node_class->diff = gsk_linear_gradient_node_diff;
+  node_class->hash = gsk_linear_gradient_node_hash;
 }
 
 /**
@@ -614,6 +655,22 @@ gsk_radial_gradient_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_radial_gradient_node_hash (GskRenderNode *node)
+{
+  GskRadialGradientNode *self = (GskRadialGradientNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->center);
+  hash = gsk_hash_value (hash, self->hradius);
+  hash = gsk_hash_value (hash, self->vradius);
+  hash = gsk_hash_value (hash, self->start);
+  hash = gsk_hash_value (hash, self->end);
+  hash = gsk_hash_bytes (hash, self->stops, self->n_stops * sizeof (GskColorStop));
+
+  return hash;
+}
+
 static void
 gsk_radial_gradient_node_class_init (gpointer g_class,
                                      gpointer class_data)
@@ -625,6 +682,7 @@ gsk_radial_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_radial_gradient_node_finalize;
   node_class->draw = gsk_radial_gradient_node_draw;
   node_class->diff = gsk_radial_gradient_node_diff;
+  node_class->hash = gsk_radial_gradient_node_hash;
 }
 
 static void
@@ -638,6 +696,7 @@ gsk_repeating_radial_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_radial_gradient_node_finalize;
   node_class->draw = gsk_radial_gradient_node_draw;
   node_class->diff = gsk_radial_gradient_node_diff;
+  node_class->hash = gsk_radial_gradient_node_hash;
 }
 
 /**
@@ -1100,6 +1159,19 @@ gsk_conic_gradient_node_diff (GskRenderNode  *node1,
     }
 }
 
+static guint64
+gsk_conic_gradient_node_hash (GskRenderNode *node)
+{
+  GskConicGradientNode *self = (GskConicGradientNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->center);
+  hash = gsk_hash_value (hash, self->rotation);
+  hash = gsk_hash_bytes (hash, self->stops, self->n_stops * sizeof (GskColorStop));
+
+  return hash;
+}
+
 static void
 gsk_conic_gradient_node_class_init (gpointer g_class,
                                     gpointer class_data)
@@ -1111,6 +1183,7 @@ gsk_conic_gradient_node_class_init (gpointer g_class,
   node_class->finalize = gsk_conic_gradient_node_finalize;
   node_class->draw = gsk_conic_gradient_node_draw;
   node_class->diff = gsk_conic_gradient_node_diff;
+  node_class->hash = gsk_conic_gradient_node_hash;
 }
 
 /**
@@ -1459,6 +1532,19 @@ gsk_border_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_border_node_hash (GskRenderNode *node)
+{
+  GskBorderNode *self = (GskBorderNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->outline);
+  hash = gsk_hash_value (hash, self->border_width);
+  hash = gsk_hash_value (hash, self->border_color);
+
+  return hash;
+}
+
 static void
 gsk_border_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -1469,6 +1555,7 @@ gsk_border_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_border_node_draw;
   node_class->diff = gsk_border_node_diff;
+  node_class->hash = gsk_border_node_hash;
 }
 
 /**
@@ -1677,6 +1764,31 @@ gsk_texture_node_diff (GskRenderNode  *node1,
   cairo_region_destroy (sub);
 }
 
+static gboolean
+gsk_texture_node_get_opaque_rect (GskRenderNode   *node,
+                                  graphene_rect_t *out_opaque)
+{
+  GskTextureNode *self = (GskTextureNode *) node;
+
+  if (gdk_memory_format_alpha (gdk_texture_get_format (self->texture)) != GDK_MEMORY_ALPHA_OPAQUE)
+    return FALSE;
+
+  *out_opaque = node->bounds;
+  return TRUE;
+}
+
+static guint64
+gsk_texture_node_hash (GskRenderNode *node)
+{
+  GskTextureNode *self = (GskTextureNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  /* Textures are immutable, and both nodes hold a reference */
+  hash = gsk_hash_value (hash, self->texture);
+
+  return hash;
+}
+
 static void
 gsk_texture_node_class_init (gpointer g_class,
                              gpointer class_data)
@@ -1688,6 +1800,8 @@ gsk_texture_node_class_init (gpointer g_class,
   node_class->finalize = gsk_texture_node_finalize;
   node_class->draw = gsk_texture_node_draw;
   node_class->diff = gsk_texture_node_diff;
+  node_class->hash = gsk_texture_node_hash;
+  node_class->get_opaque_rect = gsk_texture_node_get_opaque_rect;
 }
 
 /**
@@ -1872,6 +1986,31 @@ gsk_texture_scale_node_diff (GskRenderNode  *node1,
   cairo_region_destroy (sub);
 }
 
+static gboolean
+gsk_texture_scale_node_get_opaque_rect (GskRenderNode   *node,
+                                        graphene_rect_t *out_opaque)
+{
+  GskTextureScaleNode *self = (GskTextureScaleNode *) node;
+
+  if (gdk_memory_format_alpha (gdk_texture_get_format (self->texture)) != GDK_MEMORY_ALPHA_OPAQUE)
+    return FALSE;
+
+  *out_opaque = node->bounds;
+  return TRUE;
+}
+
+static guint64
+gsk_texture_scale_node_hash (GskRenderNode *node)
+{
+  GskTextureScaleNode *self = (GskTextureScaleNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->texture);
+  hash = gsk_hash_value (hash, self->filter);
+
+  return hash;
+}
+
 static void
 gsk_texture_scale_node_class_init (gpointer g_class,
                                    gpointer class_data)
@@ -1883,6 +2022,8 @@ gsk_texture_scale_node_class_init (gpointer g_class,
   node_class->finalize = gsk_texture_scale_node_finalize;
   node_class->draw = gsk_texture_scale_node_draw;
   node_class->diff = gsk_texture_scale_node_diff;
+  node_class->hash = gsk_texture_scale_node_hash;
+  node_class->get_opaque_rect = gsk_texture_scale_node_get_opaque_rect;
 }
 
 /**
@@ -2385,6 +2526,22 @@ gsk_inset_shadow_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_inset_shadow_node_hash (GskRenderNode *node)
+{
+  GskInsetShadowNode *self = (GskInsetShadowNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->outline);
+  hash = gsk_hash_value (hash, self->color);
+  hash = gsk_hash_value (hash, self->dx);
+  hash = gsk_hash_value (hash, self->dy);
+  hash = gsk_hash_value (hash, self->spread);
+  hash = gsk_hash_value (hash, self->blur_radius);
+
+  return hash;
+}
+
 static void
 gsk_inset_shadow_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -2395,6 +2552,7 @@ gsk_inset_shadow_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_inset_shadow_node_draw;
   node_class->diff = gsk_inset_shadow_node_diff;
+  node_class->hash = gsk_inset_shadow_node_hash;
 }
 
 /**
@@ -2698,6 +2856,22 @@ gsk_outset_shadow_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_outset_shadow_node_hash (GskRenderNode *node)
+{
+  GskOutsetShadowNode *self = (GskOutsetShadowNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  hash = gsk_hash_value (hash, self->outline);
+  hash = gsk_hash_value (hash, self->color);
+  hash = gsk_hash_value (hash, self->dx);
+  hash = gsk_hash_value (hash, self->dy);
+  hash = gsk_hash_value (hash, self->spread);
+  hash = gsk_hash_value (hash, self->blur_radius);
+
+  return hash;
+}
+
 static void
 gsk_outset_shadow_node_class_init (gpointer g_class,
                                    gpointer class_data)
@@ -2708,6 +2882,7 @@ gsk_outset_shadow_node_class_init (gpointer g_class,
 
   node_class->draw = gsk_outset_shadow_node_draw;
   node_class->diff = gsk_outset_shadow_node_diff;
+  node_class->hash = gsk_outset_shadow_node_hash;
 }
 
 /**
@@ -3022,6 +3197,7 @@ struct _GskContainerNode
   GskRenderNode render_node;
 
   gboolean disjoint;
+  graphene_rect_t opaque;
   guint n_children;
   GskRenderNode **children;
 };
@@ -3149,6 +3325,38 @@ gsk_container_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static gboolean
+gsk_container_node_get_opaque_rect (GskRenderNode   *node,
+                                    graphene_rect_t *out_opaque)
+{
+  GskContainerNode *self = (GskContainerNode *) node;
+
+  if (self->opaque.size.width <= 0 || self->opaque.size.height <= 0)
+    return FALSE;
+
+  *out_opaque = self->opaque;
+  return TRUE;
+}
+
+static guint64
+gsk_container_node_hash (GskRenderNode *node)
+{
+  GskContainerNode *self = (GskContainerNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  for (guint i = 0; i < self->n_children; i++)
+    {
+      guint64 child_hash = gsk_render_node_get_hash (self->children[i]);
+
+      if (child_hash == 0)
+        return 0;
+
+      hash = gsk_hash_value (hash, child_hash);
+    }
+
+  return hash;
+}
+
 static void
 gsk_container_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -3160,6 +3368,8 @@ gsk_container_node_class_init (gpointer g_class,
   node_class->finalize = gsk_container_node_finalize;
   node_class->draw = gsk_container_node_draw;
   node_class->diff = gsk_container_node_diff;
+  node_class->hash = gsk_container_node_hash;
+  node_class->get_opaque_rect = gsk_container_node_get_opaque_rect;
 }
 
 /**
@@ -3198,13 +3408,19 @@ gsk_container_node_new (GskRenderNode **children,
 
       self->children[0] = gsk_render_node_ref (children[0]);
       graphene_rect_init_from_rect (&bounds, &(children[0]->bounds));
+      if (!gsk_render_node_get_opaque_rect (children[0], &self->opaque))
+        self->opaque = GRAPHENE_RECT_INIT (0, 0, 0, 0);
       node->preferred_depth = gdk_memory_depth_merge (node->preferred_depth,
                                                       gsk_render_node_get_preferred_depth (children[0]));
 
       for (guint i = 1; i < n_children; i++)
         {
+          graphene_rect_t child_opaque;
+
           self->children[i] = gsk_render_node_ref (children[i]);
           self->disjoint = self->disjoint && !graphene_rect_intersection (&bounds, &(children[i]->bounds), NULL);
+          if (gsk_render_node_get_opaque_rect (children[i], &child_opaque))
+            gsk_rect_coverage (&self->opaque, &child_opaque, &self->opaque);
           graphene_rect_union (&bounds, &(children[i]->bounds), &bounds);
           node->preferred_depth = gdk_memory_depth_merge (node->preferred_depth,
                                                           gsk_render_node_get_preferred_depth (children[i]));
@@ -3435,6 +3651,43 @@ gsk_transform_node_diff (GskRenderNode  *node1,
     }
 }
 
+static gboolean
+gsk_transform_node_get_opaque_rect (GskRenderNode   *node,
+                                    graphene_rect_t *out_opaque)
+{
+  GskTransformNode *self = (GskTransformNode *) node;
+  graphene_rect_t child_opaque;
+
+  /* Only transforms keeping rectangles axis-aligned give exact results */
+  if (gsk_transform_get_category (self->transform) < GSK_TRANSFORM_CATEGORY_2D_AFFINE)
+    return FALSE;
+
+  if (!gsk_render_node_get_opaque_rect (self->child, &child_opaque))
+    return FALSE;
+
+  gsk_transform_transform_bounds (self->transform, &child_opaque, out_opaque);
+  return TRUE;
+}
+
+static guint64
+gsk_transform_node_hash (GskRenderNode *node)
+{
+  GskTransformNode *self = (GskTransformNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+  graphene_matrix_t matrix;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+
+  gsk_transform_to_matrix (self->transform, &matrix);
+  hash = gsk_hash_value (hash, matrix);
+
+  return hash;
+}
+
 static void
 gsk_transform_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -3447,6 +3700,8 @@ gsk_transform_node_class_init (gpointer g_class,
   node_class->draw = gsk_transform_node_draw;
   node_class->can_diff = gsk_transform_node_can_diff;
   node_class->diff = gsk_transform_node_diff;
+  node_class->hash = gsk_transform_node_hash;
+  node_class->get_opaque_rect = gsk_transform_node_get_opaque_rect;
 }
 
 /**
@@ -3596,6 +3851,34 @@ gsk_opacity_node_diff (GskRenderNode  *node1,
     gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static gboolean
+gsk_opacity_node_get_opaque_rect (GskRenderNode   *node,
+                                  graphene_rect_t *out_opaque)
+{
+  GskOpacityNode *self = (GskOpacityNode *) node;
+
+  if (self->opacity < 1.0)
+    return FALSE;
+
+  return gsk_render_node_get_opaque_rect (self->child, out_opaque);
+}
+
+static guint64
+gsk_opacity_node_hash (GskRenderNode *node)
+{
+  GskOpacityNode *self = (GskOpacityNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->opacity);
+
+  return hash;
+}
+
 static void
 gsk_opacity_node_class_init (gpointer g_class,
                              gpointer class_data)
@@ -3607,6 +3890,8 @@ gsk_opacity_node_class_init (gpointer g_class,
   node_class->finalize = gsk_opacity_node_finalize;
   node_class->draw = gsk_opacity_node_draw;
   node_class->diff = gsk_opacity_node_diff;
+  node_class->hash = gsk_opacity_node_hash;
+  node_class->get_opaque_rect = gsk_opacity_node_get_opaque_rect;
 }
 
 /**
@@ -3819,6 +4104,23 @@ nope:
   return;
 }
 
+static guint64
+gsk_color_matrix_node_hash (GskRenderNode *node)
+{
+  GskColorMatrixNode *self = (GskColorMatrixNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->color_matrix);
+  hash = gsk_hash_value (hash, self->color_offset);
+
+  return hash;
+}
+
 static void
 gsk_color_matrix_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -3830,6 +4132,7 @@ gsk_color_matrix_node_class_init (gpointer g_class,
   node_class->finalize = gsk_color_matrix_node_finalize;
   node_class->draw = gsk_color_matrix_node_draw;
   node_class->diff = gsk_color_matrix_node_diff;
+  node_class->hash = gsk_color_matrix_node_hash;
 }
 
 /**
@@ -4143,6 +4446,35 @@ gsk_clip_node_diff (GskRenderNode  *node1,
     }
 }
 
+static gboolean
+gsk_clip_node_get_opaque_rect (GskRenderNode   *node,
+                               graphene_rect_t *out_opaque)
+{
+  GskClipNode *self = (GskClipNode *) node;
+  graphene_rect_t child_opaque;
+
+  if (!gsk_render_node_get_opaque_rect (self->child, &child_opaque))
+    return FALSE;
+
+  return graphene_rect_intersection (&self->clip, &child_opaque, out_opaque);
+}
+
+static guint64
+gsk_clip_node_hash (GskRenderNode *node)
+{
+  GskClipNode *self = (GskClipNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->clip);
+
+  return hash;
+}
+
 static void
 gsk_clip_node_class_init (gpointer g_class,
                                gpointer class_data)
@@ -4154,6 +4486,8 @@ gsk_clip_node_class_init (gpointer g_class,
   node_class->finalize = gsk_clip_node_finalize;
   node_class->draw = gsk_clip_node_draw;
   node_class->diff = gsk_clip_node_diff;
+  node_class->hash = gsk_clip_node_hash;
+  node_class->get_opaque_rect = gsk_clip_node_get_opaque_rect;
 }
 
 /**
@@ -4291,6 +4625,37 @@ gsk_rounded_clip_node_diff (GskRenderNode  *node1,
     }
 }
 
+static gboolean
+gsk_rounded_clip_node_get_opaque_rect (GskRenderNode   *node,
+                                       graphene_rect_t *out_opaque)
+{
+  GskRoundedClipNode *self = (GskRoundedClipNode *) node;
+  graphene_rect_t child_opaque;
+
+  if (!gsk_render_node_get_opaque_rect (self->child, &child_opaque))
+    return FALSE;
+
+  gsk_rounded_rect_get_largest_cover (&self->clip, &child_opaque, out_opaque);
+
+  return out_opaque->size.width > 0 && out_opaque->size.height > 0;
+}
+
+static guint64
+gsk_rounded_clip_node_hash (GskRenderNode *node)
+{
+  GskRoundedClipNode *self = (GskRoundedClipNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->clip);
+
+  return hash;
+}
+
 static void
 gsk_rounded_clip_node_class_init (gpointer g_class,
                                   gpointer class_data)
@@ -4302,6 +4667,8 @@ gsk_rounded_clip_node_class_init (gpointer g_class,
   node_class->finalize = gsk_rounded_clip_node_finalize;
   node_class->draw = gsk_rounded_clip_node_draw;
   node_class->diff = gsk_rounded_clip_node_diff;
+  node_class->hash = gsk_rounded_clip_node_hash;
+  node_class->get_opaque_rect = gsk_rounded_clip_node_get_opaque_rect;
 }
 
 /**
@@ -4465,6 +4832,84 @@ gsk_fill_node_diff (GskRenderNode  *node1,
     }
 }
 
+typedef struct
+{
+  guint64 hash;
+  graphene_point_t origin;
+} PathHash;
+
+static gboolean
+hash_path_op (GskPathOperation        op,
+              const graphene_point_t *pts,
+              gsize                   n_pts,
+              gpointer                user_data)
+{
+  PathHash *data = user_data;
+
+  data->hash = gsk_hash_value (data->hash, op);
+  for (gsize i = 0; i < n_pts; i++)
+    {
+      graphene_point_t p = GRAPHENE_POINT_INIT (pts[i].x - data->origin.x,
+                                                pts[i].y - data->origin.y);
+
+      data->hash = gsk_hash_value (data->hash, p);
+    }
+
+  return TRUE;
+}
+
+/* Paths are hashed by their operations, so that recreating the same
+ * path gives the same hash. Points are taken relative to @origin, so
+ * translated copies of a path can be found, too.
+ */
+static guint64
+gsk_hash_path (guint64                 hash,
+               GskPath                *path,
+               const graphene_point_t *origin)
+{
+  PathHash data = { hash, *origin };
+
+  gsk_path_foreach (path,
+                    GSK_PATH_FOREACH_ALLOW_QUAD |
+                    GSK_PATH_FOREACH_ALLOW_CUBIC |
+                    GSK_PATH_FOREACH_ALLOW_ARC,
+                    hash_path_op,
+                    &data);
+
+  return data.hash;
+}
+
+static guint64
+gsk_hash_stroke (guint64          hash,
+                 const GskStroke *stroke)
+{
+  hash = gsk_hash_value (hash, stroke->line_width);
+  hash = gsk_hash_value (hash, stroke->line_cap);
+  hash = gsk_hash_value (hash, stroke->line_join);
+  hash = gsk_hash_value (hash, stroke->miter_limit);
+  hash = gsk_hash_bytes (hash, stroke->dash, stroke->n_dash * sizeof (float));
+  hash = gsk_hash_value (hash, stroke->dash_offset);
+
+  return hash;
+}
+
+static guint64
+gsk_fill_node_hash (GskRenderNode *node)
+{
+  GskFillNode *self = (GskFillNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_path (hash, self->path, graphene_point_zero ());
+  hash = gsk_hash_value (hash, self->fill_rule);
+
+  return hash;
+}
+
 static void
 gsk_fill_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -4476,6 +4921,7 @@ gsk_fill_node_class_init (gpointer g_class,
   node_class->finalize = gsk_fill_node_finalize;
   node_class->draw = gsk_fill_node_draw;
   node_class->diff = gsk_fill_node_diff;
+  node_class->hash = gsk_fill_node_hash;
 }
 
 /**
@@ -4670,6 +5116,23 @@ gsk_stroke_node_diff (GskRenderNode  *node1,
     }
 }
 
+static guint64
+gsk_stroke_node_hash (GskRenderNode *node)
+{
+  GskStrokeNode *self = (GskStrokeNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_path (hash, self->path, graphene_point_zero ());
+  hash = gsk_hash_stroke (hash, &self->stroke);
+
+  return hash;
+}
+
 static void
 gsk_stroke_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -4681,6 +5144,7 @@ gsk_stroke_node_class_init (gpointer g_class,
   node_class->finalize = gsk_stroke_node_finalize;
   node_class->draw = gsk_stroke_node_draw;
   node_class->diff = gsk_stroke_node_diff;
+  node_class->hash = gsk_stroke_node_hash;
 }
 
 /**
@@ -4787,6 +5251,102 @@ gsk_stroke_node_get_stroke (const GskRenderNode *node)
   return &self->stroke;
 }
 
+/*< private >
+ * gsk_render_node_create_path_mask:
+ * @node: a fill or stroke node
+ *
+ * Creates a node that covers the same area as @node, but
+ * draws opaque white instead of the child.
+ *
+ * Renderers can rasterize this once as a coverage mask and
+ * apply it to the child, and cache it by its content hash.
+ *
+ * Returns: (transfer full): a new fill or stroke node
+ */
+GskRenderNode *
+gsk_render_node_create_path_mask (const GskRenderNode *node)
+{
+  GskRenderNode *color, *mask;
+
+  color = gsk_color_node_new (&(GdkRGBA) { 1, 1, 1, 1 }, &node->bounds);
+
+  switch (gsk_render_node_get_node_type (node))
+    {
+    case GSK_FILL_NODE:
+      mask = gsk_fill_node_new (color,
+                                gsk_fill_node_get_path (node),
+                                gsk_fill_node_get_fill_rule (node));
+      break;
+
+    case GSK_STROKE_NODE:
+      mask = gsk_stroke_node_new (color,
+                                  gsk_stroke_node_get_path (node),
+                                  gsk_stroke_node_get_stroke (node));
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  gsk_render_node_unref (color);
+
+  return mask;
+}
+
+/*< private >
+ * gsk_render_node_get_path_mask_hash:
+ * @node: a fill or stroke node
+ * @origin: the origin of the mask
+ *
+ * Computes a hash of the mask created by gsk_render_node_create_path_mask()
+ * relative to @origin.
+ *
+ * Translated copies of a node have the same hash when @origin is
+ * translated with them, so a mask rasterized for one of them can be
+ * reused for the others. Scale and size of the rasterized mask are
+ * not included.
+ *
+ * Returns: the hash
+ */
+guint64
+gsk_render_node_get_path_mask_hash (const GskRenderNode    *node,
+                                    const graphene_point_t *origin)
+{
+  GskRenderNodeType type = gsk_render_node_get_node_type (node);
+  guint64 hash = GSK_HASH_INIT;
+  graphene_rect_t bounds;
+
+  hash = gsk_hash_value (hash, type);
+  graphene_rect_offset_r (&node->bounds, - origin->x, - origin->y, &bounds);
+  hash = gsk_hash_value (hash, bounds);
+
+  switch (type)
+    {
+    case GSK_FILL_NODE:
+      {
+        const GskFillNode *self = (const GskFillNode *) node;
+
+        hash = gsk_hash_path (hash, self->path, origin);
+        hash = gsk_hash_value (hash, self->fill_rule);
+      }
+      break;
+
+    case GSK_STROKE_NODE:
+      {
+        const GskStrokeNode *self = (const GskStrokeNode *) node;
+
+        hash = gsk_hash_path (hash, self->path, origin);
+        hash = gsk_hash_stroke (hash, &self->stroke);
+      }
+      break;
+
+    default:
+      g_assert_not_reached ();
+    }
+
+  return hash;
+}
+
 /* }}} */
 /* {{{ GSK_SHADOW_NODE */
 
@@ -4945,6 +5505,22 @@ gsk_shadow_node_get_bounds (GskShadowNode *self,
   bounds->size.height += top + bottom;
 }
 
+static guint64
+gsk_shadow_node_hash (GskRenderNode *node)
+{
+  GskShadowNode *self = (GskShadowNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_bytes (hash, self->shadows, self->n_shadows * sizeof (GskShadow));
+
+  return hash;
+}
+
 static void
 gsk_shadow_node_class_init (gpointer g_class,
                             gpointer class_data)
@@ -4956,6 +5532,7 @@ gsk_shadow_node_class_init (gpointer g_class,
   node_class->finalize = gsk_shadow_node_finalize;
   node_class->draw = gsk_shadow_node_draw;
   node_class->diff = gsk_shadow_node_diff;
+  node_class->hash = gsk_shadow_node_hash;
 }
 
 /**
@@ -5157,6 +5734,26 @@ gsk_blend_node_diff (GskRenderNode  *node1,
     }
 }
 
+static guint64
+gsk_blend_node_hash (GskRenderNode *node)
+{
+  GskBlendNode *self = (GskBlendNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->bottom);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  child_hash = gsk_render_node_get_hash (self->top);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->blend_mode);
+
+  return hash;
+}
+
 static void
 gsk_blend_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -5168,6 +5765,7 @@ gsk_blend_node_class_init (gpointer g_class,
   node_class->finalize = gsk_blend_node_finalize;
   node_class->draw = gsk_blend_node_draw;
   node_class->diff = gsk_blend_node_diff;
+  node_class->hash = gsk_blend_node_hash;
 }
 
 /**
@@ -5323,6 +5921,26 @@ gsk_cross_fade_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_cross_fade_node_hash (GskRenderNode *node)
+{
+  GskCrossFadeNode *self = (GskCrossFadeNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->start);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  child_hash = gsk_render_node_get_hash (self->end);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->progress);
+
+  return hash;
+}
+
 static void
 gsk_cross_fade_node_class_init (gpointer g_class,
                                 gpointer class_data)
@@ -5334,6 +5952,7 @@ gsk_cross_fade_node_class_init (gpointer g_class,
   node_class->finalize = gsk_cross_fade_node_finalize;
   node_class->draw = gsk_cross_fade_node_draw;
   node_class->diff = gsk_cross_fade_node_diff;
+  node_class->hash = gsk_cross_fade_node_hash;
 }
 
 /**
@@ -5514,6 +6133,21 @@ gsk_text_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff_impossible (node1, node2, region);
 }
 
+static guint64
+gsk_text_node_hash (GskRenderNode *node)
+{
+  GskTextNode *self = (GskTextNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+
+  /* Fonts are shared by the fontmap, and both nodes hold a reference */
+  hash = gsk_hash_value (hash, self->font);
+  hash = gsk_hash_value (hash, self->color);
+  hash = gsk_hash_value (hash, self->offset);
+  hash = gsk_hash_bytes (hash, self->glyphs, self->num_glyphs * sizeof (PangoGlyphInfo));
+
+  return hash;
+}
+
 static void
 gsk_text_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -5525,6 +6159,7 @@ gsk_text_node_class_init (gpointer g_class,
   node_class->finalize = gsk_text_node_finalize;
   node_class->draw = gsk_text_node_draw;
   node_class->diff = gsk_text_node_diff;
+  node_class->hash = gsk_text_node_hash;
 }
 
 /**
@@ -5950,6 +6585,22 @@ gsk_blur_node_diff (GskRenderNode  *node1,
     }
 }
 
+static guint64
+gsk_blur_node_hash (GskRenderNode *node)
+{
+  GskBlurNode *self = (GskBlurNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->child);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->radius);
+
+  return hash;
+}
+
 static void
 gsk_blur_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -5961,6 +6612,7 @@ gsk_blur_node_class_init (gpointer g_class,
   node_class->finalize = gsk_blur_node_finalize;
   node_class->draw = gsk_blur_node_draw;
   node_class->diff = gsk_blur_node_diff;
+  node_class->hash = gsk_blur_node_hash;
 }
 
 /**
@@ -6176,6 +6828,26 @@ gsk_mask_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff (self1->mask, self2->mask, region);
 }
 
+static guint64
+gsk_mask_node_hash (GskRenderNode *node)
+{
+  GskMaskNode *self = (GskMaskNode *) node;
+  guint64 hash = GSK_HASH_INIT;
+  guint64 child_hash;
+
+  child_hash = gsk_render_node_get_hash (self->source);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  child_hash = gsk_render_node_get_hash (self->mask);
+  if (child_hash == 0)
+    return 0;
+  hash = gsk_hash_value (hash, child_hash);
+  hash = gsk_hash_value (hash, self->mask_mode);
+
+  return hash;
+}
+
 static void
 gsk_mask_node_class_init (gpointer g_class,
                           gpointer class_data)
@@ -6187,6 +6859,7 @@ gsk_mask_node_class_init (gpointer g_class,
   node_class->finalize = gsk_mask_node_finalize;
   node_class->draw = gsk_mask_node_draw;
   node_class->diff = gsk_mask_node_diff;
+  node_class->hash = gsk_mask_node_hash;
 }
 
 /**
@@ -6344,6 +7017,24 @@ gsk_debug_node_diff (GskRenderNode  *node1,
   gsk_render_node_diff (self1->child, self2->child, region);
 }
 
+static gboolean
+gsk_debug_node_get_opaque_rect (GskRenderNode   *node,
+                                graphene_rect_t *out_opaque)
+{
+  GskDebugNode *self = (GskDebugNode *) node;
+
+  return gsk_render_node_get_opaque_rect (self->child, out_opaque);
+}
+
+static guint64
+gsk_debug_node_hash (GskRenderNode *node)
+{
+  GskDebugNode *self = (GskDebugNode *) node;
+
+  /* The message does not influence rendering */
+  return gsk_render_node_get_hash (self->child);
+}
+
 static void
 gsk_debug_node_class_init (gpointer g_class,
                            gpointer class_data)
@@ -6356,6 +7047,8 @@ gsk_debug_node_class_init (gpointer g_class,
   node_class->draw = gsk_debug_node_draw;
   node_class->can_diff = gsk_debug_node_can_diff;
   node_class->diff = gsk_debug_node_diff;
+  node_class->hash = gsk_debug_node_hash;
+  node_class->get_opaque_rect = gsk_debug_node_get_opaque_rect;
 }
 
 /**
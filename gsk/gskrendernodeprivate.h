@@ -29,8 +29,13 @@ struct _GskRenderNode
 
   graphene_rect_t bounds;
 
+  /* Content hash, computed lazily by gsk_render_node_get_hash() */
+  guint64 hash;
+
   guint preferred_depth : 2;
   guint offscreen_for_opacity : 1;
+  guint hash_valid : 1;
+  guint arena_allocated : 1;
 };
 
 struct _GskRenderNodeClass
@@ -47,8 +52,32 @@ struct _GskRenderNodeClass
   void            (* diff)        (GskRenderNode  *node1,
                                    GskRenderNode  *node2,
                                    cairo_region_t *region);
+  gboolean        (* get_opaque_rect) (GskRenderNode   *node,
+                                       graphene_rect_t *out_opaque);
+  guint64         (* hash)        (GskRenderNode  *node);
 };
 
+#define GSK_HASH_INIT 0xcbf29ce484222325ull
+
+/* FNV-1a, used to accumulate render node content hashes */
+static inline guint64
+gsk_hash_bytes (guint64       hash,
+                gconstpointer data,
+                gsize         size)
+{
+  const guchar *bytes = data;
+
+  for (gsize i = 0; i < size; i++)
+    {
+      hash ^= bytes[i];
+      hash *= 0x100000001b3ull;
+    }
+
+  return hash;
+}
+
+#define gsk_hash_value(hash, value) gsk_hash_bytes ((hash), &(value), sizeof (value))
+
 void            gsk_render_node_init_types              (void);
 
 GType           gsk_render_node_type_register_static    (const char                  *node_name,
@@ -62,6 +91,7 @@ gboolean        gsk_render_node_can_diff                (const GskRenderNode
 void            gsk_render_node_diff                    (GskRenderNode               *node1,
                                                          GskRenderNode               *node2,
                                                          cairo_region_t              *region);
+guint64         gsk_render_node_get_hash                (GskRenderNode               *node);
 void            gsk_render_node_diff_impossible         (GskRenderNode               *node1,
                                                          GskRenderNode               *node2,
                                                          cairo_region_t              *region);
@@ -87,6 +117,13 @@ gboolean        gsk_container_node_is_disjoint          (const GskRenderNode
 
 gboolean        gsk_render_node_use_offscreen_for_opacity (const GskRenderNode       *node);
 
+gboolean        gsk_render_node_get_opaque_rect         (GskRenderNode               *node,
+                                                         graphene_rect_t             *out_opaque);
+
+GskRenderNode * gsk_render_node_create_path_mask        (const GskRenderNode         *node);
+guint64         gsk_render_node_get_path_mask_hash      (const GskRenderNode         *node,
+                                                         const graphene_point_t      *origin);
+
 
 G_END_DECLS
 
@@ -0,0 +1,386 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gskshadowcacheprivate.h"
+
+#include "gskcairoblurprivate.h"
+#include "gskrendernodeprivate.h"
+#include "gskroundedrectprivate.h"
+
+#include <string.h>
+
+/* The shadow cache keeps blurred outset shadows as alpha-only
+ * textures, so renderers that have no blur of their own can draw
+ * them with a texture lookup.
+ *
+ * Shadows are rendered for the smallest outline with the same corners,
+ * offset, spread and blur. Everything between the corners is the same
+ * along the edges, so the texture can be stretched to any outline
+ * that is at least as big by drawing it in 9 slices. Like this, all
+ * buttons with the same style share a single texture.
+ *
+ * The textures are not tied to a renderer, and the cache is evicted
+ * in least-recently-used order when it grows beyond its budget.
+ */
+
+#define MAX_CACHE_SIZE (4 * 1024 * 1024)
+
+typedef struct
+{
+  graphene_size_t size;
+  graphene_size_t corner[4];
+  float dx;
+  float dy;
+  float spread;
+  float blur_radius;
+  float scale_x;
+  float scale_y;
+} ShadowKey;
+
+typedef struct
+{
+  ShadowKey key;
+  GdkTexture *texture;
+  gsize size;
+  GList link;
+} ShadowEntry;
+
+typedef struct
+{
+  float start, end;
+  float tex_start, tex_end;
+} Segment;
+
+G_LOCK_DEFINE_STATIC (shadow_cache);
+static GHashTable *shadows;
+static GQueue lru = G_QUEUE_INIT;
+static gsize cache_size;
+
+static guint
+shadow_key_hash (gconstpointer data)
+{
+  return gsk_hash_bytes (GSK_HASH_INIT, data, sizeof (ShadowKey));
+}
+
+static gboolean
+shadow_key_equal (gconstpointer a,
+                  gconstpointer b)
+{
+  return memcmp (a, b, sizeof (ShadowKey)) == 0;
+}
+
+static void
+shadow_entry_free (gpointer data)
+{
+  ShadowEntry *entry = data;
+
+  g_object_unref (entry->texture);
+  g_free (entry);
+}
+
+void
+gsk_shadow_cache_add_counters (GskProfiler *profiler)
+{
+  gsk_profiler_add_counter (profiler, "shadow-cache-hits", "Shadow cache hits", TRUE);
+  gsk_profiler_add_counter (profiler, "shadow-cache-misses", "Shadow cache misses", TRUE);
+  gsk_profiler_add_counter (profiler, "shadow-cache-size", "Shadow cache size", FALSE);
+}
+
+/* Splits one axis of the shadow into the part before the middle, a
+ * single row of the texture that gets stretched and the part after it.
+ * If the outline is too small for that, the shadow is used as is.
+ */
+static guint
+compute_segments (float    start,
+                  float    size,
+                  float    extent_before,
+                  float    extent_after,
+                  float    margin_before,
+                  float    margin_after,
+                  float   *canonical_size,
+                  Segment  segments[3])
+{
+  float min_size, middle;
+
+  /* Leave a bit of room around the middle, so that filtering
+   * only ever sees identical rows.
+   */
+  min_size = margin_before + margin_after + 3;
+
+  if (size <= min_size)
+    {
+      *canonical_size = size;
+      segments[0] = (Segment) { start - extent_before, start + size + extent_after,
+                                0, extent_before + size + extent_after };
+      return 1;
+    }
+
+  *canonical_size = min_size;
+  middle = extent_before + margin_before + 1;
+  segments[0] = (Segment) { start - extent_before, start + margin_before + 1,
+                            0, middle };
+  segments[1] = (Segment) { start + margin_before + 1, start + size - margin_after - 1,
+                            middle, middle + 1 };
+  segments[2] = (Segment) { start + size - margin_after - 1, start + size + extent_after,
+                            middle + 1, extent_before + min_size + extent_after };
+
+  return 3;
+}
+
+static GdkTexture *
+render_shadow (const ShadowKey       *key,
+               const graphene_rect_t *outline_bounds,
+               const GdkRGBA         *color,
+               int                    width,
+               int                    height,
+               gsize                 *out_size)
+{
+  GskRoundedRect outline;
+  GskRenderNode *shadow;
+  cairo_surface_t *surface;
+  GdkTexture *texture;
+  GBytes *bytes;
+  cairo_t *cr;
+
+  outline.bounds = *outline_bounds;
+  memcpy (outline.corner, key->corner, sizeof (outline.corner));
+
+  shadow = gsk_outset_shadow_node_new (&outline,
+                                       color,
+                                       key->dx, key->dy,
+                                       key->spread,
+                                       key->blur_radius);
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_A8, width, height);
+  cairo_surface_set_device_scale (surface, key->scale_x, key->scale_y);
+  cr = cairo_create (surface);
+  gsk_render_node_draw (shadow, cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  gsk_render_node_unref (shadow);
+
+  *out_size = cairo_image_surface_get_stride (surface) * height;
+  bytes = g_bytes_new_with_free_func (cairo_image_surface_get_data (surface),
+                                      *out_size,
+                                      (GDestroyNotify) cairo_surface_destroy,
+                                      surface);
+  texture = gdk_memory_texture_new (width, height,
+                                    GDK_MEMORY_A8,
+                                    bytes,
+                                    cairo_image_surface_get_stride (surface));
+  g_bytes_unref (bytes);
+
+  return texture;
+}
+
+static void
+evict_shadows (gsize max_size)
+{
+  while (cache_size > max_size && lru.tail != NULL)
+    {
+      ShadowEntry *entry = lru.tail->data;
+
+      g_queue_unlink (&lru, &entry->link);
+      cache_size -= entry->size;
+      g_hash_table_remove (shadows, &entry->key);
+    }
+}
+
+/*< private >
+ * gsk_shadow_cache_lookup:
+ * @node: an outset shadow node
+ * @scale_x: the horizontal scale the shadow is drawn at
+ * @scale_y: the vertical scale the shadow is drawn at
+ * @profiler: (nullable): a profiler to record hits and misses in.
+ *   It must have had gsk_shadow_cache_add_counters() called on it
+ * @slices: (out caller-allocates): return location for the slices
+ *   to draw
+ * @n_slices: (out): return location for the number of slices
+ *
+ * Looks up the blurred shadow for @node and renders it if it is not
+ * in the cache yet.
+ *
+ * The texture contains the shadow in its alpha channel; it needs to
+ * be drawn in @node's color. It must be drawn once for every slice,
+ * and the slices together cover the bounds of @node.
+ *
+ * Returns: (transfer full): the texture with the shadow
+ */
+GdkTexture *
+gsk_shadow_cache_lookup (const GskRenderNode *node,
+                         float                scale_x,
+                         float                scale_y,
+                         GskProfiler         *profiler,
+                         GskShadowSlice       slices[GSK_SHADOW_CACHE_MAX_SLICES],
+                         guint               *n_slices)
+{
+  const GskRoundedRect *outline = gsk_outset_shadow_node_get_outline (node);
+  float spread = gsk_outset_shadow_node_get_spread (node);
+  float dx = gsk_outset_shadow_node_get_dx (node);
+  float dy = gsk_outset_shadow_node_get_dy (node);
+  float blur_radius = gsk_outset_shadow_node_get_blur_radius (node);
+  float extent_left, extent_top, extent_right, extent_bottom;
+  float margin_left, margin_top, margin_right, margin_bottom;
+  float clip_radius, tex_width, tex_height;
+  Segment x_segments[3], y_segments[3];
+  guint n_x, n_y, x, y;
+  GskRoundedRect box;
+  ShadowKey key;
+  ShadowEntry *entry;
+  GdkTexture *texture;
+  gboolean cached;
+  int width, height;
+
+  g_return_val_if_fail (gsk_render_node_get_node_type (node) == GSK_OUTSET_SHADOW_NODE, NULL);
+
+  extent_left = outline->bounds.origin.x - node->bounds.origin.x;
+  extent_top = outline->bounds.origin.y - node->bounds.origin.y;
+  extent_right = node->bounds.origin.x + node->bounds.size.width - outline->bounds.origin.x - outline->bounds.size.width;
+  extent_bottom = node->bounds.origin.y + node->bounds.size.height - outline->bounds.origin.y - outline->bounds.size.height;
+
+  /* The middle of the shadow must be far enough from the corners
+   * of both the outline and the blurred box.
+   */
+  clip_radius = gsk_cairo_blur_compute_pixels (ceil (blur_radius / 2.0));
+  gsk_rounded_rect_init_copy (&box, outline);
+  gsk_rounded_rect_shrink (&box, -spread, -spread, -spread, -spread);
+
+  margin_left = MAX (MAX (outline->corner[GSK_CORNER_TOP_LEFT].width,
+                          outline->corner[GSK_CORNER_BOTTOM_LEFT].width),
+                     dx - spread + clip_radius + MAX (box.corner[GSK_CORNER_TOP_LEFT].width,
+                                                      box.corner[GSK_CORNER_BOTTOM_LEFT].width));
+  margin_right = MAX (MAX (outline->corner[GSK_CORNER_TOP_RIGHT].width,
+                           outline->corner[GSK_CORNER_BOTTOM_RIGHT].width),
+                      - dx - spread + clip_radius + MAX (box.corner[GSK_CORNER_TOP_RIGHT].width,
+                                                         box.corner[GSK_CORNER_BOTTOM_RIGHT].width));
+  margin_top = MAX (MAX (outline->corner[GSK_CORNER_TOP_LEFT].height,
+                         outline->corner[GSK_CORNER_TOP_RIGHT].height),
+                    dy - spread + clip_radius + MAX (box.corner[GSK_CORNER_TOP_LEFT].height,
+                                                     box.corner[GSK_CORNER_TOP_RIGHT].height));
+  margin_bottom = MAX (MAX (outline->corner[GSK_CORNER_BOTTOM_LEFT].height,
+                            outline->corner[GSK_CORNER_BOTTOM_RIGHT].height),
+                       - dy - spread + clip_radius + MAX (box.corner[GSK_CORNER_BOTTOM_LEFT].height,
+                                                          box.corner[GSK_CORNER_BOTTOM_RIGHT].height));
+
+  memset (&key, 0, sizeof key);
+  n_x = compute_segments (outline->bounds.origin.x, outline->bounds.size.width,
+                          extent_left, extent_right,
+                          ceilf (MAX (margin_left, 0)), ceilf (MAX (margin_right, 0)),
+                          &key.size.width, x_segments);
+  n_y = compute_segments (outline->bounds.origin.y, outline->bounds.size.height,
+                          extent_top, extent_bottom,
+                          ceilf (MAX (margin_top, 0)), ceilf (MAX (margin_bottom, 0)),
+                          &key.size.height, y_segments);
+  memcpy (key.corner, outline->corner, sizeof (key.corner));
+  key.dx = dx;
+  key.dy = dy;
+  key.spread = spread;
+  key.blur_radius = blur_radius;
+  key.scale_x = scale_x;
+  key.scale_y = scale_y;
+
+  width = ceilf ((extent_left + key.size.width + extent_right) * scale_x);
+  height = ceilf ((extent_top + key.size.height + extent_bottom) * scale_y);
+
+  G_LOCK (shadow_cache);
+
+  if (shadows == NULL)
+    shadows = g_hash_table_new_full (shadow_key_hash, shadow_key_equal, NULL, shadow_entry_free);
+
+  entry = g_hash_table_lookup (shadows, &key);
+  cached = entry != NULL;
+  if (cached)
+    {
+      g_queue_unlink (&lru, &entry->link);
+    }
+  else
+    {
+      entry = g_new0 (ShadowEntry, 1);
+      entry->key = key;
+      entry->link.data = entry;
+      entry->texture = render_shadow (&key,
+                                      &GRAPHENE_RECT_INIT (extent_left, extent_top,
+                                                           key.size.width, key.size.height),
+                                      &(GdkRGBA) { 1, 1, 1, 1 },
+                                      width, height,
+                                      &entry->size);
+      g_hash_table_insert (shadows, &entry->key, entry);
+      cache_size += entry->size;
+    }
+
+  g_queue_push_head_link (&lru, &entry->link);
+  texture = g_object_ref (entry->texture);
+
+  evict_shadows (MAX_CACHE_SIZE);
+
+#ifdef G_ENABLE_DEBUG
+  if (profiler)
+    {
+      gsk_profiler_counter_inc (profiler, g_quark_from_static_string (cached ? "shadow-cache-hits"
+                                                                             : "shadow-cache-misses"));
+      gsk_profiler_counter_set (profiler, g_quark_from_static_string ("shadow-cache-size"), cache_size);
+    }
+#endif
+
+  G_UNLOCK (shadow_cache);
+
+  tex_width = width / scale_x;
+  tex_height = height / scale_y;
+
+  *n_slices = 0;
+  for (y = 0; y < n_y; y++)
+    {
+      float ky = (y_segments[y].end - y_segments[y].start) / (y_segments[y].tex_end - y_segments[y].tex_start);
+
+      for (x = 0; x < n_x; x++)
+        {
+          float kx = (x_segments[x].end - x_segments[x].start) / (x_segments[x].tex_end - x_segments[x].tex_start);
+          GskShadowSlice *slice = &slices[(*n_slices)++];
+
+          graphene_rect_init (&slice->rect,
+                              x_segments[x].start,
+                              y_segments[y].start,
+                              x_segments[x].end - x_segments[x].start,
+                              y_segments[y].end - y_segments[y].start);
+          graphene_rect_init (&slice->tex_rect,
+                              x_segments[x].start - x_segments[x].tex_start * kx,
+                              y_segments[y].start - y_segments[y].tex_start * ky,
+                              tex_width * kx,
+                              tex_height * ky);
+        }
+    }
+
+  return texture;
+}
+
+/*< private >
+ * gsk_shadow_cache_trim:
+ *
+ * Drops all cached shadows.
+ */
+void
+gsk_shadow_cache_trim (void)
+{
+  G_LOCK (shadow_cache);
+
+  evict_shadows (0);
+
+  G_UNLOCK (shadow_cache);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "gskprofilerprivate.h"
+#include "gskrendernode.h"
+
+G_BEGIN_DECLS
+
+/* A part of a cached shadow: @rect is the area to draw and @tex_rect
+ * the area that the whole texture is stretched to, so that the right
+ * part of it ends up in @rect.
+ */
+typedef struct _GskShadowSlice GskShadowSlice;
+
+struct _GskShadowSlice
+{
+  graphene_rect_t rect;
+  graphene_rect_t tex_rect;
+};
+
+#define GSK_SHADOW_CACHE_MAX_SLICES 9
+
+void            gsk_shadow_cache_add_counters           (GskProfiler            *profiler);
+
+GdkTexture *    gsk_shadow_cache_lookup                 (const GskRenderNode    *node,
+                                                         float                   scale_x,
+                                                         float                   scale_y,
+                                                         GskProfiler            *profiler,
+                                                         GskShadowSlice          slices[GSK_SHADOW_CACHE_MAX_SLICES],
+                                                         guint                  *n_slices);
+
+void            gsk_shadow_cache_trim                   (void);
+
+G_END_DECLS
+
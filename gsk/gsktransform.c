@@ -2082,6 +2082,102 @@ gsk_transform_transform_bounds (GskTransform          *self,
     }
 }
 
+/*< private >
+ * gsk_transform_untransform_bounds:
+ * @self: a `GskTransform`
+ * @rect: a rectangle in the transformed coordinate space
+ * @out_rect: (out caller-allocates): return location for the bounds
+ *   of the untransformed area that is mapped into @rect
+ *
+ * Computes the area of the untransformed plane that ends up inside
+ * @rect after applying @self. Renderers use this to cull the children
+ * of transform nodes against the clip.
+ *
+ * Returns: %TRUE if the bounds could be computed, %FALSE if @self
+ *   is not invertible or uses perspective
+ */
+gboolean
+gsk_transform_untransform_bounds (GskTransform          *self,
+                                  const graphene_rect_t *rect,
+                                  graphene_rect_t       *out_rect)
+{
+  switch (gsk_transform_get_category (self))
+    {
+    case GSK_TRANSFORM_CATEGORY_IDENTITY:
+      graphene_rect_init_from_rect (out_rect, rect);
+      return TRUE;
+
+    case GSK_TRANSFORM_CATEGORY_2D_TRANSLATE:
+      {
+        float dx, dy;
+
+        gsk_transform_to_translate (self, &dx, &dy);
+        graphene_rect_offset_r (rect, - dx, - dy, out_rect);
+      }
+      return TRUE;
+
+    case GSK_TRANSFORM_CATEGORY_2D_AFFINE:
+      {
+        float dx, dy, scale_x, scale_y;
+
+        gsk_transform_to_affine (self, &scale_x, &scale_y, &dx, &dy);
+        if (scale_x == 0 || scale_y == 0)
+          return FALSE;
+
+        graphene_rect_init (out_rect,
+                            (rect->origin.x - dx) / scale_x,
+                            (rect->origin.y - dy) / scale_y,
+                            rect->size.width / scale_x,
+                            rect->size.height / scale_y);
+        graphene_rect_normalize (out_rect);
+      }
+      return TRUE;
+
+    case GSK_TRANSFORM_CATEGORY_UNKNOWN:
+    case GSK_TRANSFORM_CATEGORY_ANY:
+    case GSK_TRANSFORM_CATEGORY_3D:
+    case GSK_TRANSFORM_CATEGORY_2D:
+    default:
+      {
+        graphene_matrix_t mat, plane, inverse;
+        float w, xx, yx, xy, yy;
+
+        gsk_transform_to_matrix (self, &mat);
+
+        /* With perspective, points behind the viewer make the bounds
+         * meaningless. Without it, the z=0 plane of the child is mapped
+         * by a 2D affine transform that we can invert.
+         */
+        if (graphene_matrix_get_value (&mat, 0, 3) != 0 ||
+            graphene_matrix_get_value (&mat, 1, 3) != 0)
+          return FALSE;
+
+        w = graphene_matrix_get_value (&mat, 3, 3);
+        if (w == 0)
+          return FALSE;
+
+        xx = graphene_matrix_get_value (&mat, 0, 0) / w;
+        yx = graphene_matrix_get_value (&mat, 0, 1) / w;
+        xy = graphene_matrix_get_value (&mat, 1, 0) / w;
+        yy = graphene_matrix_get_value (&mat, 1, 1) / w;
+
+        /* The plane is seen edge-on */
+        if (fabsf (xx * yy - yx * xy) < FLT_EPSILON)
+          return FALSE;
+
+        graphene_matrix_init_from_2d (&plane,
+                                      xx, yx, xy, yy,
+                                      graphene_matrix_get_value (&mat, 3, 0) / w,
+                                      graphene_matrix_get_value (&mat, 3, 1) / w);
+        if (!graphene_matrix_inverse (&plane, &inverse))
+          return FALSE;
+
+        gsk_matrix_transform_bounds (&inverse, rect, out_rect);
+      }
+      return TRUE;
+    }
+}
+
 /**
  * gsk_transform_transform_point:
  * @self: a `GskTransform`
@@ -40,6 +40,10 @@ struct _GskTransform
 gboolean                gsk_transform_parser_parse              (GtkCssParser           *parser,
                                                                  GskTransform          **out_transform);
 
+gboolean                gsk_transform_untransform_bounds        (GskTransform           *self,
+                                                                 const graphene_rect_t  *rect,
+                                                                 graphene_rect_t        *out_rect);
+
 void gsk_matrix_transform_point   (const graphene_matrix_t  *m,
                                    const graphene_point_t   *p,
                                    graphene_point_t         *res);
@@ -47,12 +47,13 @@ gsk_vulkan_buffer_new_internal (GdkVulkanContext  *context,
   self->memory = gsk_vulkan_memory_new (context,
                                         requirements.memoryTypeBits,
                                         VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
-                                        requirements.size);
+                                        requirements.size,
+                                        requirements.alignment);
 
   GSK_VK_CHECK (vkBindBufferMemory, gdk_vulkan_context_get_device (context),
                                     self->vk_buffer,
                                     gsk_vulkan_memory_get_device_memory (self->memory),
-                                    0);
+                                    gsk_vulkan_memory_get_offset (self->memory));
   return self;
 }
 
@@ -72,6 +73,15 @@ gsk_vulkan_buffer_new_storage (GdkVulkanContext  *context,
   return gsk_vulkan_buffer_new_internal (context, size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
 }
 
+GskVulkanBuffer *
+gsk_vulkan_buffer_new_ring (GdkVulkanContext  *context,
+                            gsize              size)
+{
+  return gsk_vulkan_buffer_new_internal (context, size,
+                                         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT
+                                         | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+}
+
 GskVulkanBuffer *
 gsk_vulkan_buffer_new_map (GdkVulkanContext  *context,
                            gsize              size,
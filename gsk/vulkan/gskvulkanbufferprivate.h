@@ -17,6 +17,8 @@ GskVulkanBuffer *       gsk_vulkan_buffer_new                           (GdkVulk
                                                                          gsize                   size);
 GskVulkanBuffer *       gsk_vulkan_buffer_new_storage                   (GdkVulkanContext       *context,
                                                                          gsize                   size);
+GskVulkanBuffer *       gsk_vulkan_buffer_new_ring                      (GdkVulkanContext       *context,
+                                                                         gsize                   size);
 GskVulkanBuffer *       gsk_vulkan_buffer_new_map                       (GdkVulkanContext       *context,
                                                                          gsize                   size,
                                                                          GskVulkanMapMode        mode);
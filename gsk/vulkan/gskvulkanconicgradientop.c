@@ -0,0 +1,109 @@
+#include "config.h"
+
+#include "gskvulkanconicgradientopprivate.h"
+
+#include "gskvulkanprivate.h"
+#include "gskvulkanshaderopprivate.h"
+
+#include "vulkan/resources/conic.vert.h"
+
+typedef struct _GskVulkanConicGradientOp GskVulkanConicGradientOp;
+
+struct _GskVulkanConicGradientOp
+{
+  GskVulkanShaderOp op;
+
+  graphene_rect_t rect;
+  graphene_point_t center;
+  float angle;
+  GskColorStop *stops;
+  gsize n_stops;
+
+  gsize buffer_offset;
+};
+
+static void
+gsk_vulkan_conic_gradient_op_finish (GskVulkanOp *op)
+{
+  GskVulkanConicGradientOp *self = (GskVulkanConicGradientOp *) op;
+
+  g_free (self->stops);
+}
+
+static void
+gsk_vulkan_conic_gradient_op_print (GskVulkanOp *op,
+                                    GString     *string,
+                                    guint        indent)
+{
+  GskVulkanConicGradientOp *self = (GskVulkanConicGradientOp *) op;
+
+  print_indent (string, indent);
+  print_rect (string, &self->rect);
+  g_string_append_printf (string, "conic-gradient (%zu stops)", self->n_stops);
+  print_newline (string);
+}
+
+static void
+gsk_vulkan_conic_gradient_op_collect_vertex_data (GskVulkanOp *op,
+                                                  guchar      *data)
+{
+  GskVulkanConicGradientOp *self = (GskVulkanConicGradientOp *) op;
+  GskVulkanConicInstance *instance = (GskVulkanConicInstance *) (data + ((GskVulkanShaderOp *) op)->vertex_offset);
+
+  gsk_rect_to_float (&self->rect, instance->rect);
+  gsk_vulkan_point_to_float (&self->center, instance->center);
+  instance->angle = self->angle;
+  instance->stop_offset = self->buffer_offset;
+  instance->stop_count = self->n_stops;
+}
+
+static void
+gsk_vulkan_conic_gradient_op_reserve_descriptor_sets (GskVulkanOp     *op,
+                                                      GskVulkanRender *render)
+{
+  GskVulkanConicGradientOp *self = (GskVulkanConicGradientOp *) op;
+  guchar *mem;
+
+  mem = gsk_vulkan_render_get_buffer_memory (render,
+                                             self->n_stops * sizeof (GskColorStop),
+                                             G_ALIGNOF (GskColorStop),
+                                             &self->buffer_offset);
+  memcpy (mem, self->stops, self->n_stops * sizeof (GskColorStop));
+}
+
+static const GskVulkanShaderOpClass GSK_VULKAN_CONIC_GRADIENT_OP_CLASS = {
+  {
+    GSK_VULKAN_OP_SIZE (GskVulkanConicGradientOp),
+    GSK_VULKAN_STAGE_SHADER,
+    gsk_vulkan_conic_gradient_op_finish,
+    gsk_vulkan_conic_gradient_op_print,
+    gsk_vulkan_shader_op_count_vertex_data,
+    gsk_vulkan_conic_gradient_op_collect_vertex_data,
+    gsk_vulkan_conic_gradient_op_reserve_descriptor_sets,
+    gsk_vulkan_shader_op_command
+  },
+  "conic",
+  0,
+  &gsk_vulkan_conic_info,
+};
+
+void
+gsk_vulkan_conic_gradient_op (GskVulkanRender        *render,
+                              GskVulkanShaderClip     clip,
+                              const graphene_rect_t  *rect,
+                              const graphene_point_t *offset,
+                              const graphene_point_t *center,
+                              float                   angle,
+                              const GskColorStop     *stops,
+                              gsize                   n_stops)
+{
+  GskVulkanConicGradientOp *self;
+
+  self = (GskVulkanConicGradientOp *) gsk_vulkan_shader_op_alloc (render, &GSK_VULKAN_CONIC_GRADIENT_OP_CLASS, clip, NULL);
+
+  graphene_rect_offset_r (rect, offset->x, offset->y, &self->rect);
+  self->center = GRAPHENE_POINT_INIT (center->x + offset->x, center->y + offset->y);
+  self->angle = angle;
+  self->stops = g_memdup (stops, sizeof (GskColorStop) * n_stops);
+  self->n_stops = n_stops;
+}
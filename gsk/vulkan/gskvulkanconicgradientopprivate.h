@@ -0,0 +1,18 @@
+#pragma once
+
+#include "gskvulkanopprivate.h"
+
+G_BEGIN_DECLS
+
+void                    gsk_vulkan_conic_gradient_op                    (GskVulkanRender                *render,
+                                                                         GskVulkanShaderClip             clip,
+                                                                         const graphene_rect_t          *rect,
+                                                                         const graphene_point_t         *offset,
+                                                                         const graphene_point_t         *center,
+                                                                         float                           angle,
+                                                                         const GskColorStop             *stops,
+                                                                         gsize                           n_stops);
+
+
+G_END_DECLS
+
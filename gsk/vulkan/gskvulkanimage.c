@@ -7,6 +7,7 @@
 #include "gskvulkanprivate.h"
 
 #include "gdk/gdkmemoryformatprivate.h"
+#include "gsk/gskgpumemoryprivate.h"
 
 #include <string.h>
 
@@ -20,6 +21,7 @@ struct _GskVulkanImage
   VkFormat vk_format;
   gsize width;
   gsize height;
+  guint n_levels;
   VkImageTiling vk_tiling;
   VkImageUsageFlags vk_usage;
   VkImage vk_image;
@@ -32,6 +34,8 @@ struct _GskVulkanImage
   VkAccessFlags vk_access;
 
   GskVulkanMemory *memory;
+  GskGpuMemoryCategory memory_category;
+  gsize memory_size;
 };
 
 G_DEFINE_TYPE (GskVulkanImage, gsk_vulkan_image, G_TYPE_OBJECT)
@@ -390,7 +394,8 @@ gsk_vulkan_context_supports_format (GdkVulkanContext  *context,
                                     VkImageTiling      tiling,
                                     VkImageUsageFlags  usage,
                                     gsize              width,
-                                    gsize              height)
+                                    gsize              height,
+                                    guint              n_levels)
 {
   VkFormatProperties properties;
   VkImageFormatProperties image_properties;
@@ -417,6 +422,11 @@ gsk_vulkan_context_supports_format (GdkVulkanContext  *context,
     required |= VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT;
   if (usage & VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT)
     required |= VK_FORMAT_FEATURE_COLOR_ATTACHMENT_BLEND_BIT;
+  /* mipmaps are generated by blitting */
+  if (n_levels > 1)
+    required |= VK_FORMAT_FEATURE_BLIT_SRC_BIT |
+                VK_FORMAT_FEATURE_BLIT_DST_BIT |
+                VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT;
 
   if ((features & required) != required)
     return FALSE;
@@ -432,7 +442,8 @@ gsk_vulkan_context_supports_format (GdkVulkanContext  *context,
     return FALSE;
 
   if (image_properties.maxExtent.width < width ||
-      image_properties.maxExtent.height < height)
+      image_properties.maxExtent.height < height ||
+      image_properties.maxMipLevels < n_levels)
     return FALSE;
 
   return TRUE;
@@ -452,7 +463,7 @@ gsk_vulkan_image_create_view (GskVulkanImage            *self,
                                      .subresourceRange = {
                                          .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                                          .baseMipLevel = 0,
-                                         .levelCount = 1,
+                                         .levelCount = self->n_levels,
                                          .baseArrayLayer = 0,
                                          .layerCount = 1,
                                      },
@@ -463,9 +474,11 @@ gsk_vulkan_image_create_view (GskVulkanImage            *self,
 
 static GskVulkanImage *
 gsk_vulkan_image_new (GdkVulkanContext          *context,
+                      GskGpuMemoryCategory       category,
                       GdkMemoryFormat            format,
                       gsize                      width,
                       gsize                      height,
+                      guint                      n_levels,
                       GskVulkanImagePostprocess  allowed_postprocess,
                       VkImageTiling              tiling,
                       VkImageUsageFlags          usage,
@@ -492,14 +505,16 @@ gsk_vulkan_image_new (GdkVulkanContext          *context,
           if (gsk_vulkan_context_supports_format (context,
                                                   vk_format->format,
                                                   tiling, usage,
-                                                  width, height))
+                                                  width, height,
+                                                  n_levels))
             break;
 
           if (tiling != VK_IMAGE_TILING_OPTIMAL &&
               gsk_vulkan_context_supports_format (context,
                                                   vk_format->format,
                                                   VK_IMAGE_TILING_OPTIMAL, usage,
-                                                  width, height))
+                                                  width, height,
+                                                  n_levels))
             {
               tiling = VK_IMAGE_TILING_OPTIMAL;
               break;
@@ -519,6 +534,7 @@ gsk_vulkan_image_new (GdkVulkanContext          *context,
   self->postprocess = vk_format->postprocess;
   self->width = width;
   self->height = height;
+  self->n_levels = n_levels;
   self->vk_tiling = tiling;
   self->vk_usage = usage;
   self->vk_pipeline_stage = stage;
@@ -532,7 +548,7 @@ gsk_vulkan_image_new (GdkVulkanContext          *context,
                                     .imageType = VK_IMAGE_TYPE_2D,
                                     .format = vk_format->format,
                                     .extent = { width, height, 1 },
-                                    .mipLevels = 1,
+                                    .mipLevels = n_levels,
                                     .arrayLayers = 1,
                                     .samples = VK_SAMPLE_COUNT_1_BIT,
                                     .tiling = tiling,
@@ -550,12 +566,16 @@ gsk_vulkan_image_new (GdkVulkanContext          *context,
   self->memory = gsk_vulkan_memory_new (context,
                                         requirements.memoryTypeBits,
                                         memory,
-                                        requirements.size);
+                                        requirements.size,
+                                        requirements.alignment);
+  self->memory_category = category;
+  self->memory_size = requirements.size;
+  gsk_gpu_memory_add (category, requirements.size);
 
   GSK_VK_CHECK (vkBindImageMemory, gdk_vulkan_context_get_device (context),
                                    self->vk_image,
                                    gsk_vulkan_memory_get_device_memory (self->memory),
-                                   0);
+                                   gsk_vulkan_memory_get_offset (self->memory));
 
   gsk_vulkan_image_create_view (self, vk_format);
 
@@ -571,9 +591,11 @@ gsk_vulkan_image_new_for_upload (GdkVulkanContext  *context,
   GskVulkanImage *self;
 
   self = gsk_vulkan_image_new (context,
+                               GSK_GPU_MEMORY_TEXTURES,
                                format,
                                width,
                                height,
+                               1,
                                -1,
                                VK_IMAGE_TILING_LINEAR,
                                VK_IMAGE_USAGE_TRANSFER_DST_BIT |
@@ -586,6 +608,43 @@ gsk_vulkan_image_new_for_upload (GdkVulkanContext  *context,
   return self;
 }
 
+/*
+ * gsk_vulkan_image_new_for_upload_mipmap:
+ *
+ * Creates an image with a full mipmap chain. Level 0 is uploaded
+ * like gsk_vulkan_image_new_for_upload() does, the other levels are
+ * filled with gsk_vulkan_image_generate_mipmaps().
+ *
+ * No postprocessing is allowed, as that would require rendering
+ * into every level.
+ */
+GskVulkanImage *
+gsk_vulkan_image_new_for_upload_mipmap (GdkVulkanContext  *context,
+                                        GdkMemoryFormat    format,
+                                        gsize              width,
+                                        gsize              height)
+{
+  GskVulkanImage *self;
+
+  self = gsk_vulkan_image_new (context,
+                               GSK_GPU_MEMORY_TEXTURES,
+                               format,
+                               width,
+                               height,
+                               g_bit_storage (MAX (width, height)),
+                               0,
+                               VK_IMAGE_TILING_OPTIMAL,
+                               VK_IMAGE_USAGE_TRANSFER_SRC_BIT |
+                               VK_IMAGE_USAGE_TRANSFER_DST_BIT |
+                               VK_IMAGE_USAGE_SAMPLED_BIT,
+                               VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                               VK_IMAGE_LAYOUT_UNDEFINED,
+                               0,
+                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+  return self;
+}
+
 static gboolean
 gsk_vulkan_image_can_map (GskVulkanImage *self)
 {
@@ -649,6 +708,7 @@ gsk_vulkan_image_new_for_swapchain (GdkVulkanContext *context,
   self->vulkan = g_object_ref (context);
   self->width = width;
   self->height = height;
+  self->n_levels = 1;
   self->vk_tiling = VK_IMAGE_TILING_OPTIMAL;
   self->vk_image = image;
   self->vk_format = format;
@@ -677,9 +737,11 @@ gsk_vulkan_image_new_for_atlas (GdkVulkanContext *context,
   GskVulkanImage *self;
 
   self = gsk_vulkan_image_new (context,
+                               GSK_GPU_MEMORY_ATLASES,
                                GDK_MEMORY_DEFAULT,
                                width,
                                height,
+                               1,
                                0,
                                VK_IMAGE_TILING_OPTIMAL,
                                VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
@@ -700,9 +762,11 @@ gsk_vulkan_image_new_for_offscreen (GdkVulkanContext *context,
   GskVulkanImage *self;
 
   self = gsk_vulkan_image_new (context,
+                               GSK_GPU_MEMORY_OFFSCREENS,
                                preferred_format,
                                width,
                                height,
+                               1,
                                0,
                                VK_IMAGE_TILING_LINEAR,
                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
@@ -736,6 +800,7 @@ gsk_vulkan_image_finalize (GObject *object)
     vkDestroyImage (device, self->vk_image, NULL);
 
   g_clear_pointer (&self->memory, gsk_vulkan_memory_free);
+  gsk_gpu_memory_add (self->memory_category, - (gssize) self->memory_size);
 
   g_object_unref (self->vulkan);
 
@@ -790,6 +855,12 @@ gsk_vulkan_image_get_height (GskVulkanImage *self)
   return self->height;
 }
 
+guint
+gsk_vulkan_image_get_n_levels (GskVulkanImage *self)
+{
+  return self->n_levels;
+}
+
 GskVulkanImagePostprocess
 gsk_vulkan_image_get_postprocess (GskVulkanImage *self)
 {
@@ -867,7 +938,7 @@ gsk_vulkan_image_transition (GskVulkanImage       *self,
                             .subresourceRange = {
                               .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
                               .baseMipLevel = 0,
-                              .levelCount = 1,
+                              .levelCount = self->n_levels,
                               .baseArrayLayer = 0,
                               .layerCount = 1
                             },
@@ -876,6 +947,107 @@ gsk_vulkan_image_transition (GskVulkanImage       *self,
   gsk_vulkan_image_set_vk_image_layout (self, stage, image_layout, access);
 }
 
+static void
+gsk_vulkan_image_transition_level (GskVulkanImage  *self,
+                                   VkCommandBuffer  command_buffer,
+                                   guint            level)
+{
+  vkCmdPipelineBarrier (command_buffer,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                        0,
+                        0, NULL,
+                        0, NULL,
+                        1, &(VkImageMemoryBarrier) {
+                            .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER,
+                            .srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
+                            .oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                            .newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+                            .image = self->vk_image,
+                            .subresourceRange = {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .baseMipLevel = level,
+                              .levelCount = 1,
+                              .baseArrayLayer = 0,
+                              .layerCount = 1
+                            },
+                        });
+}
+
+/*
+ * gsk_vulkan_image_generate_mipmaps:
+ *
+ * Fills all mipmap levels from level 0 by successively blitting
+ * every level into the next smaller one.
+ *
+ * Level 0 must have been written to already, and all levels are
+ * in TRANSFER_SRC_OPTIMAL layout when this function returns.
+ */
+void
+gsk_vulkan_image_generate_mipmaps (GskVulkanImage  *self,
+                                   VkCommandBuffer  command_buffer)
+{
+  int width, height;
+  guint i;
+
+  gsk_vulkan_image_transition (self,
+                               command_buffer,
+                               VK_PIPELINE_STAGE_TRANSFER_BIT,
+                               VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                               VK_ACCESS_TRANSFER_WRITE_BIT);
+
+  width = self->width;
+  height = self->height;
+
+  for (i = 1; i < self->n_levels; i++)
+    {
+      gsk_vulkan_image_transition_level (self, command_buffer, i - 1);
+
+      vkCmdBlitImage (command_buffer,
+                      self->vk_image,
+                      VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      self->vk_image,
+                      VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                      1,
+                      &(VkImageBlit) {
+                          .srcSubresource = {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .mipLevel = i - 1,
+                              .baseArrayLayer = 0,
+                              .layerCount = 1
+                          },
+                          .srcOffsets = {
+                              { 0, 0, 0 },
+                              { width, height, 1 }
+                          },
+                          .dstSubresource = {
+                              .aspectMask = VK_IMAGE_ASPECT_COLOR_BIT,
+                              .mipLevel = i,
+                              .baseArrayLayer = 0,
+                              .layerCount = 1
+                          },
+                          .dstOffsets = {
+                              { 0, 0, 0 },
+                              { MAX (width / 2, 1), MAX (height / 2, 1), 1 }
+                          },
+                      },
+                      VK_FILTER_LINEAR);
+
+      width = MAX (width / 2, 1);
+      height = MAX (height / 2, 1);
+    }
+
+  gsk_vulkan_image_transition_level (self, command_buffer, self->n_levels - 1);
+
+  gsk_vulkan_image_set_vk_image_layout (self,
+                                        VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                        VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                                        VK_ACCESS_TRANSFER_READ_BIT);
+}
+
 VkFormat
 gsk_vulkan_image_get_vk_format (GskVulkanImage *self)
 {
@@ -36,12 +36,17 @@ GskVulkanImage *        gsk_vulkan_image_new_for_upload                 (GdkVulk
                                                                          GdkMemoryFormat         format,
                                                                          gsize                   width,
                                                                          gsize                   height);
+GskVulkanImage *        gsk_vulkan_image_new_for_upload_mipmap          (GdkVulkanContext       *context,
+                                                                         GdkMemoryFormat         format,
+                                                                         gsize                   width,
+                                                                         gsize                   height);
 guchar *                gsk_vulkan_image_try_map                        (GskVulkanImage         *self,
                                                                          gsize                  *out_stride);
 void                    gsk_vulkan_image_unmap                          (GskVulkanImage         *self);
 
 gsize                   gsk_vulkan_image_get_width                      (GskVulkanImage         *self);
 gsize                   gsk_vulkan_image_get_height                     (GskVulkanImage         *self);
+guint                   gsk_vulkan_image_get_n_levels                   (GskVulkanImage         *self);
 GskVulkanImagePostprocess
                         gsk_vulkan_image_get_postprocess                (GskVulkanImage         *self);
 VkPipelineStageFlags    gsk_vulkan_image_get_vk_pipeline_stage          (GskVulkanImage         *self);
@@ -56,6 +61,8 @@ void                    gsk_vulkan_image_transition                     (GskVulk
                                                                          VkPipelineStageFlags    stage,
                                                                          VkImageLayout           image_layout,
                                                                          VkAccessFlags           access);
+void                    gsk_vulkan_image_generate_mipmaps               (GskVulkanImage         *self,
+                                                                         VkCommandBuffer         command_buffer);
 #define gdk_vulkan_image_transition_shader(image) \
   gsk_vulkan_image_transition ((image), VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, \
                                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT)
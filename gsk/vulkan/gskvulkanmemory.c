@@ -4,54 +4,322 @@
 
 #include "gskvulkanprivate.h"
 
+/* Drivers limit the number of allocations, often to 4096, and each
+ * allocation is slow. So memory is allocated in big blocks per memory
+ * type, and images and buffers get a range of such a block. Blocks
+ * are freed when their last range is freed.
+ *
+ * Only allocations that would take up a big part of a block get
+ * their own device memory.
+ */
+#define BLOCK_SIZE (64 * 1024 * 1024)
+
+typedef struct _GskVulkanAllocator GskVulkanAllocator;
+typedef struct _GskVulkanMemoryBlock GskVulkanMemoryBlock;
+typedef struct _GskVulkanRange GskVulkanRange;
+
+struct _GskVulkanRange
+{
+  gsize offset;
+  gsize size;
+};
+
+struct _GskVulkanMemoryBlock
+{
+  GskVulkanAllocator *allocator;
+  uint32_t memory_type;
+
+  VkDeviceMemory vk_memory;
+  gsize size;
+
+  /* sorted by offset, adjacent ranges are merged */
+  GArray *free_ranges;
+  guint n_allocations;
+
+  guchar *map;
+  guint n_maps;
+};
+
+struct _GskVulkanAllocator
+{
+  GdkVulkanContext *vulkan;
+
+  VkPhysicalDeviceMemoryProperties properties;
+  VkDeviceSize granularity;
+
+  GSList *blocks[VK_MAX_MEMORY_TYPES];
+};
+
 struct _GskVulkanMemory
 {
   GdkVulkanContext *vulkan;
 
   gsize size;
+  gsize offset;
 
   VkMemoryType vk_memory_type;
   VkDeviceMemory vk_memory;
+
+  GskVulkanMemoryBlock *block;
 };
 
+static void
+gsk_vulkan_allocator_free (gpointer data)
+{
+  GskVulkanAllocator *self = data;
+  uint32_t i;
+
+  /* Every memory keeps the context alive, so all blocks are gone */
+  for (i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+    g_assert (self->blocks[i] == NULL);
+
+  g_free (self);
+}
+
+static GskVulkanAllocator *
+gsk_vulkan_allocator_get (GdkVulkanContext *context)
+{
+  GskVulkanAllocator *self;
+  VkPhysicalDeviceProperties device_properties;
+
+  self = g_object_get_data (G_OBJECT (context), "-gsk-vulkan-allocator");
+  if (self)
+    return self;
+
+  self = g_new0 (GskVulkanAllocator, 1);
+  self->vulkan = context;
+
+  vkGetPhysicalDeviceMemoryProperties (gdk_vulkan_context_get_physical_device (context),
+                                       &self->properties);
+  vkGetPhysicalDeviceProperties (gdk_vulkan_context_get_physical_device (context),
+                                 &device_properties);
+  /* Linear and optimal resources share blocks, so keep them apart */
+  self->granularity = device_properties.limits.bufferImageGranularity;
+
+  g_object_set_data_full (G_OBJECT (context), "-gsk-vulkan-allocator", self, gsk_vulkan_allocator_free);
+
+  return self;
+}
+
+static gsize
+gsk_vulkan_allocator_get_block_size (GskVulkanAllocator *self,
+                                     uint32_t            memory_type)
+{
+  VkDeviceSize heap_size;
+
+  heap_size = self->properties.memoryHeaps[self->properties.memoryTypes[memory_type].heapIndex].size;
+
+  /* Some heaps, like host-visible VRAM, are tiny */
+  return MIN (BLOCK_SIZE, heap_size / 8);
+}
+
+static GskVulkanMemoryBlock *
+gsk_vulkan_memory_block_new (GskVulkanAllocator *allocator,
+                             uint32_t            memory_type,
+                             gsize               size)
+{
+  GskVulkanMemoryBlock *self;
+  GskVulkanRange range = { 0, size };
+
+  self = g_new0 (GskVulkanMemoryBlock, 1);
+  self->allocator = allocator;
+  self->memory_type = memory_type;
+  self->size = size;
+  self->free_ranges = g_array_new (FALSE, FALSE, sizeof (GskVulkanRange));
+  g_array_append_val (self->free_ranges, range);
+
+  GSK_VK_CHECK (vkAllocateMemory, gdk_vulkan_context_get_device (allocator->vulkan),
+                                  &(VkMemoryAllocateInfo) {
+                                      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                                      .allocationSize = size,
+                                      .memoryTypeIndex = memory_type
+                                  },
+                                  NULL,
+                                  &self->vk_memory);
+
+  allocator->blocks[memory_type] = g_slist_prepend (allocator->blocks[memory_type], self);
+
+  return self;
+}
+
+static void
+gsk_vulkan_memory_block_free (GskVulkanMemoryBlock *self)
+{
+  GskVulkanAllocator *allocator = self->allocator;
+
+  g_assert (self->n_allocations == 0);
+  g_assert (self->n_maps == 0);
+
+  allocator->blocks[self->memory_type] = g_slist_remove (allocator->blocks[self->memory_type], self);
+
+  vkFreeMemory (gdk_vulkan_context_get_device (allocator->vulkan),
+                self->vk_memory,
+                NULL);
+
+  g_array_unref (self->free_ranges);
+  g_free (self);
+}
+
+/* First fit, the offset is returned in @offset */
+static gboolean
+gsk_vulkan_memory_block_alloc (GskVulkanMemoryBlock *self,
+                               gsize                 size,
+                               gsize                 alignment,
+                               gsize                *offset)
+{
+  guint i;
+
+  for (i = 0; i < self->free_ranges->len; i++)
+    {
+      GskVulkanRange *range = &g_array_index (self->free_ranges, GskVulkanRange, i);
+      gsize start, end;
+
+      start = (range->offset + alignment - 1) / alignment * alignment;
+      end = start + size;
+      if (end > range->offset + range->size)
+        continue;
+
+      if (end < range->offset + range->size)
+        {
+          GskVulkanRange after = { end, range->offset + range->size - end };
+
+          if (start > range->offset)
+            {
+              range->size = start - range->offset;
+              g_array_insert_val (self->free_ranges, i + 1, after);
+            }
+          else
+            {
+              *range = after;
+            }
+        }
+      else
+        {
+          if (start > range->offset)
+            range->size = start - range->offset;
+          else
+            g_array_remove_index (self->free_ranges, i);
+        }
+
+      self->n_allocations++;
+      *offset = start;
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+gsk_vulkan_memory_block_release (GskVulkanMemoryBlock *self,
+                                 gsize                 offset,
+                                 gsize                 size)
+{
+  GskVulkanRange *prev, *next;
+  guint i;
+
+  for (i = 0; i < self->free_ranges->len; i++)
+    {
+      if (g_array_index (self->free_ranges, GskVulkanRange, i).offset > offset)
+        break;
+    }
+
+  prev = i > 0 ? &g_array_index (self->free_ranges, GskVulkanRange, i - 1) : NULL;
+  next = i < self->free_ranges->len ? &g_array_index (self->free_ranges, GskVulkanRange, i) : NULL;
+
+  if (prev && prev->offset + prev->size == offset)
+    {
+      prev->size += size;
+      if (next && offset + size == next->offset)
+        {
+          prev->size += next->size;
+          g_array_remove_index (self->free_ranges, i);
+        }
+    }
+  else if (next && offset + size == next->offset)
+    {
+      next->offset = offset;
+      next->size += size;
+    }
+  else
+    {
+      GskVulkanRange range = { offset, size };
+
+      g_array_insert_val (self->free_ranges, i, range);
+    }
+
+  self->n_allocations--;
+  if (self->n_allocations == 0)
+    gsk_vulkan_memory_block_free (self);
+}
+
 GskVulkanMemory *
 gsk_vulkan_memory_new (GdkVulkanContext      *context,
                        uint32_t               allowed_types,
                        VkMemoryPropertyFlags  flags,
-                       gsize                  size)
+                       gsize                  size,
+                       gsize                  alignment)
 {
-  VkPhysicalDeviceMemoryProperties properties;
+  GskVulkanAllocator *allocator;
   GskVulkanMemory *self;
+  gsize block_size;
+  GSList *l;
   uint32_t i;
 
+  allocator = gsk_vulkan_allocator_get (context);
+
   self = g_new0 (GskVulkanMemory, 1);
 
   self->vulkan = g_object_ref (context);
-  self->size = size;
-
-  vkGetPhysicalDeviceMemoryProperties (gdk_vulkan_context_get_physical_device (context),
-                                       &properties);
 
-  for (i = 0; i < properties.memoryTypeCount; i++)
+  for (i = 0; i < allocator->properties.memoryTypeCount; i++)
     {
       if (!(allowed_types & (1 << i)))
         continue;
 
-      if ((properties.memoryTypes[i].propertyFlags & flags) == flags)
+      if ((allocator->properties.memoryTypes[i].propertyFlags & flags) == flags)
         break;
   }
 
-  g_assert (i < properties.memoryTypeCount);
+  g_assert (i < allocator->properties.memoryTypeCount);
 
-  self->vk_memory_type = properties.memoryTypes[i];
-  GSK_VK_CHECK (vkAllocateMemory, gdk_vulkan_context_get_device (context),
-                                  &(VkMemoryAllocateInfo) {
-                                      .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
-                                      .allocationSize = size,
-                                      .memoryTypeIndex = i
-                                  },
-                                  NULL,
-                                  &self->vk_memory);
+  self->vk_memory_type = allocator->properties.memoryTypes[i];
+
+  alignment = MAX (MAX (alignment, 1), allocator->granularity);
+  size = (size + alignment - 1) / alignment * alignment;
+  self->size = size;
+
+  block_size = gsk_vulkan_allocator_get_block_size (allocator, i);
+  if (size > block_size / 2)
+    {
+      GSK_VK_CHECK (vkAllocateMemory, gdk_vulkan_context_get_device (context),
+                                      &(VkMemoryAllocateInfo) {
+                                          .sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO,
+                                          .allocationSize = size,
+                                          .memoryTypeIndex = i
+                                      },
+                                      NULL,
+                                      &self->vk_memory);
+      return self;
+    }
+
+  for (l = allocator->blocks[i]; l; l = l->next)
+    {
+      if (gsk_vulkan_memory_block_alloc (l->data, size, alignment, &self->offset))
+        {
+          self->block = l->data;
+          break;
+        }
+    }
+
+  if (self->block == NULL)
+    {
+      self->block = gsk_vulkan_memory_block_new (allocator, i, block_size);
+      if (!gsk_vulkan_memory_block_alloc (self->block, size, alignment, &self->offset))
+        g_assert_not_reached ();
+    }
+
+  self->vk_memory = self->block->vk_memory;
 
   return self;
 }
@@ -59,9 +327,12 @@ gsk_vulkan_memory_new (GdkVulkanContext      *context,
 void
 gsk_vulkan_memory_free (GskVulkanMemory *self)
 {
-  vkFreeMemory (gdk_vulkan_context_get_device (self->vulkan),
-                self->vk_memory,
-                NULL);
+  if (self->block)
+    gsk_vulkan_memory_block_release (self->block, self->offset, self->size);
+  else
+    vkFreeMemory (gdk_vulkan_context_get_device (self->vulkan),
+                  self->vk_memory,
+                  NULL);
 
   g_object_unref (self->vulkan);
 
@@ -74,6 +345,12 @@ gsk_vulkan_memory_get_device_memory (GskVulkanMemory *self)
   return self->vk_memory;
 }
 
+gsize
+gsk_vulkan_memory_get_offset (GskVulkanMemory *self)
+{
+  return self->offset;
+}
+
 gboolean
 gsk_vulkan_memory_can_map (GskVulkanMemory *self,
                            gboolean         fast)
@@ -101,6 +378,27 @@ gsk_vulkan_memory_map (GskVulkanMemory *self)
 
   g_assert (gsk_vulkan_memory_can_map (self, FALSE));
 
+  if (self->block)
+    {
+      /* Memory can only be mapped once, so the whole block is mapped
+       * for as long as any of its ranges is
+       */
+      if (self->block->n_maps == 0)
+        {
+          GSK_VK_CHECK (vkMapMemory, gdk_vulkan_context_get_device (self->vulkan),
+                                     self->block->vk_memory,
+                                     0,
+                                     VK_WHOLE_SIZE,
+                                     0,
+                                     &data);
+          self->block->map = data;
+        }
+
+      self->block->n_maps++;
+
+      return self->block->map + self->offset;
+    }
+
   GSK_VK_CHECK (vkMapMemory, gdk_vulkan_context_get_device (self->vulkan),
                              self->vk_memory,
                              0,
@@ -114,7 +412,17 @@ gsk_vulkan_memory_map (GskVulkanMemory *self)
 void
 gsk_vulkan_memory_unmap (GskVulkanMemory *self)
 {
+  if (self->block)
+    {
+      g_assert (self->block->n_maps > 0);
+
+      self->block->n_maps--;
+      if (self->block->n_maps > 0)
+        return;
+
+      self->block->map = NULL;
+    }
+
   vkUnmapMemory (gdk_vulkan_context_get_device (self->vulkan),
                  self->vk_memory);
 }
-
@@ -9,10 +9,12 @@ typedef struct _GskVulkanMemory GskVulkanMemory;
 GskVulkanMemory *       gsk_vulkan_memory_new                           (GdkVulkanContext       *context,
                                                                          uint32_t                allowed_types,
                                                                          VkMemoryPropertyFlags   properties,
-                                                                         gsize                   size);
+                                                                         gsize                   size,
+                                                                         gsize                   alignment);
 void                    gsk_vulkan_memory_free                          (GskVulkanMemory        *memory);
 
 VkDeviceMemory          gsk_vulkan_memory_get_device_memory             (GskVulkanMemory        *self);
+gsize                   gsk_vulkan_memory_get_offset                    (GskVulkanMemory        *self);
 
 gboolean                gsk_vulkan_memory_can_map                       (GskVulkanMemory        *self,
                                                                          gboolean                fast);
@@ -0,0 +1,123 @@
+#include "config.h"
+
+#include "gskvulkanradialgradientopprivate.h"
+
+#include "gskvulkanprivate.h"
+#include "gskvulkanshaderopprivate.h"
+
+#include "vulkan/resources/radial.vert.h"
+
+typedef struct _GskVulkanRadialGradientOp GskVulkanRadialGradientOp;
+
+struct _GskVulkanRadialGradientOp
+{
+  GskVulkanShaderOp op;
+
+  graphene_rect_t rect;
+  graphene_point_t center;
+  graphene_point_t radius;
+  float start;
+  float end;
+  gboolean repeating;
+  GskColorStop *stops;
+  gsize n_stops;
+
+  gsize buffer_offset;
+};
+
+static void
+gsk_vulkan_radial_gradient_op_finish (GskVulkanOp *op)
+{
+  GskVulkanRadialGradientOp *self = (GskVulkanRadialGradientOp *) op;
+
+  g_free (self->stops);
+}
+
+static void
+gsk_vulkan_radial_gradient_op_print (GskVulkanOp *op,
+                                     GString     *string,
+                                     guint        indent)
+{
+  GskVulkanRadialGradientOp *self = (GskVulkanRadialGradientOp *) op;
+
+  print_indent (string, indent);
+  print_rect (string, &self->rect);
+  g_string_append_printf (string, "radial-gradient (%zu stops)", self->n_stops);
+  print_newline (string);
+}
+
+static void
+gsk_vulkan_radial_gradient_op_collect_vertex_data (GskVulkanOp *op,
+                                                   guchar      *data)
+{
+  GskVulkanRadialGradientOp *self = (GskVulkanRadialGradientOp *) op;
+  GskVulkanRadialInstance *instance = (GskVulkanRadialInstance *) (data + ((GskVulkanShaderOp *) op)->vertex_offset);
+
+  gsk_rect_to_float (&self->rect, instance->rect);
+  gsk_vulkan_point_to_float (&self->center, instance->center);
+  gsk_vulkan_point_to_float (&self->radius, instance->radius);
+  /* maps the distance in radii to the position in the stops */
+  instance->range[0] = 1.0f / (self->end - self->start);
+  instance->range[1] = - self->start / (self->end - self->start);
+  instance->repeating = self->repeating;
+  instance->stop_offset = self->buffer_offset;
+  instance->stop_count = self->n_stops;
+}
+
+static void
+gsk_vulkan_radial_gradient_op_reserve_descriptor_sets (GskVulkanOp     *op,
+                                                       GskVulkanRender *render)
+{
+  GskVulkanRadialGradientOp *self = (GskVulkanRadialGradientOp *) op;
+  guchar *mem;
+
+  mem = gsk_vulkan_render_get_buffer_memory (render,
+                                             self->n_stops * sizeof (GskColorStop),
+                                             G_ALIGNOF (GskColorStop),
+                                             &self->buffer_offset);
+  memcpy (mem, self->stops, self->n_stops * sizeof (GskColorStop));
+}
+
+static const GskVulkanShaderOpClass GSK_VULKAN_RADIAL_GRADIENT_OP_CLASS = {
+  {
+    GSK_VULKAN_OP_SIZE (GskVulkanRadialGradientOp),
+    GSK_VULKAN_STAGE_SHADER,
+    gsk_vulkan_radial_gradient_op_finish,
+    gsk_vulkan_radial_gradient_op_print,
+    gsk_vulkan_shader_op_count_vertex_data,
+    gsk_vulkan_radial_gradient_op_collect_vertex_data,
+    gsk_vulkan_radial_gradient_op_reserve_descriptor_sets,
+    gsk_vulkan_shader_op_command
+  },
+  "radial",
+  0,
+  &gsk_vulkan_radial_info,
+};
+
+void
+gsk_vulkan_radial_gradient_op (GskVulkanRender        *render,
+                               GskVulkanShaderClip     clip,
+                               const graphene_rect_t  *rect,
+                               const graphene_point_t *offset,
+                               const graphene_point_t *center,
+                               float                   hradius,
+                               float                   vradius,
+                               float                   start,
+                               float                   end,
+                               gboolean                repeating,
+                               const GskColorStop     *stops,
+                               gsize                   n_stops)
+{
+  GskVulkanRadialGradientOp *self;
+
+  self = (GskVulkanRadialGradientOp *) gsk_vulkan_shader_op_alloc (render, &GSK_VULKAN_RADIAL_GRADIENT_OP_CLASS, clip, NULL);
+
+  graphene_rect_offset_r (rect, offset->x, offset->y, &self->rect);
+  self->center = GRAPHENE_POINT_INIT (center->x + offset->x, center->y + offset->y);
+  self->radius = GRAPHENE_POINT_INIT (hradius, vradius);
+  self->start = start;
+  self->end = end;
+  self->repeating = repeating;
+  self->stops = g_memdup (stops, sizeof (GskColorStop) * n_stops);
+  self->n_stops = n_stops;
+}
@@ -14,10 +14,13 @@
 #include "gskvulkanrendererprivate.h"
 #include "gskvulkanrenderpassprivate.h"
 #include "gskvulkanrenderpassopprivate.h"
+#include "gskvulkanringbufferprivate.h"
 #include "gskvulkanshaderopprivate.h"
 
 #include "gdk/gdkvulkancontextprivate.h"
 
+#include <string.h>
+
 #define GDK_ARRAY_NAME gsk_vulkan_render_ops
 #define GDK_ARRAY_TYPE_NAME GskVulkanRenderOps
 #define GDK_ARRAY_ELEMENT_TYPE guchar
@@ -26,6 +29,7 @@
 
 #define DESCRIPTOR_POOL_MAXITEMS 50000
 #define VERTEX_BUFFER_SIZE_STEP 128 * 1024 /* 128kB */
+#define VERTEX_BUFFER_ALIGNMENT 16
 
 #define GDK_ARRAY_NAME gsk_descriptor_image_infos
 #define GDK_ARRAY_TYPE_NAME GskDescriptorImageInfos
@@ -45,6 +49,12 @@
 
 #define N_DESCRIPTOR_SETS 2
 
+/* Damage is snapped to tiles of this size before deciding whether it
+ * is sparse enough to be rendered in separate passes.
+ */
+#define TILE_SIZE 128
+#define MAX_TILED_PASSES 8
+
 struct _GskVulkanRender
 {
   GskRenderer *renderer;
@@ -62,6 +72,8 @@ struct _GskVulkanRender
   GskVulkanOp *first_op;
 
   GskDescriptorImageInfos descriptor_images;
+  /* image => index + 1 in descriptor_images, per sampler */
+  GHashTable *image_descriptor_indices[4];
   GskDescriptorBufferInfos descriptor_buffers;
   VkDescriptorPool descriptor_pool;
   VkDescriptorSet descriptor_sets[N_DESCRIPTOR_SETS];
@@ -70,14 +82,27 @@ struct _GskVulkanRender
 
   GskVulkanImage *target;
 
+  /* owned by the renderer */
+  GskVulkanRingBuffer *ring_buffer;
+  guint64 ring_frame;
+
+  /* only used when the ring buffer is full */
   GskVulkanBuffer *vertex_buffer;
-  VkSampler samplers[3];
   GskVulkanBuffer *storage_buffer;
-  guchar *storage_buffer_memory;
-  gsize storage_buffer_used;
+
+  VkBuffer vertex_vk_buffer;
+  VkDeviceSize vertex_offset;
+  VkPipeline bound_pipeline;
+  VkSampler samplers[4];
+  GByteArray *storage_data;
 
   GQuark render_pass_counter;
   GQuark gpu_time_timer;
+
+  /* timestamps written at the start and end of the command buffer */
+  VkQueryPool timestamp_pool;
+  float timestamp_period;
+  gboolean timestamps_pending;
 };
 
 typedef struct _PipelineCacheKey PipelineCacheKey;
@@ -191,18 +216,90 @@ gsk_vulkan_render_setup (GskVulkanRender       *self,
     }
 }
 
+#ifdef G_ENABLE_DEBUG
+static void
+gsk_vulkan_render_init_timestamps (GskVulkanRender *self)
+{
+  VkPhysicalDevice physical_device;
+  VkPhysicalDeviceProperties properties;
+  VkQueueFamilyProperties *queue_properties;
+  uint32_t n_queue_properties, queue_family;
+  gboolean supported;
+
+  physical_device = gdk_vulkan_context_get_physical_device (self->vulkan);
+  vkGetPhysicalDeviceProperties (physical_device, &properties);
+
+  queue_family = gdk_vulkan_context_get_queue_family_index (self->vulkan);
+  vkGetPhysicalDeviceQueueFamilyProperties (physical_device, &n_queue_properties, NULL);
+  queue_properties = g_newa (VkQueueFamilyProperties, n_queue_properties);
+  vkGetPhysicalDeviceQueueFamilyProperties (physical_device, &n_queue_properties, queue_properties);
+
+  supported = queue_family < n_queue_properties &&
+              queue_properties[queue_family].timestampValidBits > 0 &&
+              properties.limits.timestampPeriod > 0;
+  if (!supported)
+    return;
+
+  self->timestamp_period = properties.limits.timestampPeriod;
+  GSK_VK_CHECK (vkCreateQueryPool, gdk_vulkan_context_get_device (self->vulkan),
+                                   &(VkQueryPoolCreateInfo) {
+                                       .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+                                       .queryType = VK_QUERY_TYPE_TIMESTAMP,
+                                       .queryCount = 2,
+                                   },
+                                   NULL,
+                                   &self->timestamp_pool);
+}
+
+/* Reads back the timestamps of the last submitted command buffer.
+ * The fence must have been signaled.
+ */
+static void
+gsk_vulkan_render_collect_timestamps (GskVulkanRender *self)
+{
+  uint64_t timestamps[2];
+  VkResult res;
+
+  if (!self->timestamps_pending)
+    return;
+
+  self->timestamps_pending = FALSE;
+
+  res = vkGetQueryPoolResults (gdk_vulkan_context_get_device (self->vulkan),
+                               self->timestamp_pool,
+                               0, 2,
+                               sizeof (timestamps),
+                               timestamps,
+                               sizeof (uint64_t),
+                               VK_QUERY_RESULT_64_BIT);
+  if (res != VK_SUCCESS || timestamps[1] < timestamps[0])
+    return;
+
+  /* timestamps are in ticks of timestamp_period nanoseconds,
+   * profiler timers in microseconds */
+  gsk_profiler_timer_set (gsk_renderer_get_profiler (self->renderer),
+                          self->gpu_time_timer,
+                          (timestamps[1] - timestamps[0]) * self->timestamp_period / 1000);
+}
+#endif
+
 GskVulkanRender *
 gsk_vulkan_render_new (GskRenderer      *renderer,
                        GdkVulkanContext *context)
 {
   GskVulkanRender *self;
   VkDevice device;
+  gsize i;
 
   self = g_new0 (GskVulkanRender, 1);
 
   self->vulkan = context;
   self->renderer = renderer;
+  self->ring_buffer = gsk_vulkan_renderer_get_ring_buffer (GSK_VULKAN_RENDERER (renderer));
+  self->storage_data = g_byte_array_new ();
   gsk_descriptor_image_infos_init (&self->descriptor_images);
+  for (i = 0; i < G_N_ELEMENTS (self->image_descriptor_indices); i++)
+    self->image_descriptor_indices[i] = g_hash_table_new (NULL, NULL);
   gsk_descriptor_buffer_infos_init (&self->descriptor_buffers);
 
   device = gdk_vulkan_context_get_device (self->vulkan);
@@ -343,6 +440,24 @@ gsk_vulkan_render_new (GskRenderer      *renderer,
                                  },
                                  NULL,
                                  &self->samplers[GSK_VULKAN_SAMPLER_NEAREST]);
+
+  GSK_VK_CHECK (vkCreateSampler, device,
+                                 &(VkSamplerCreateInfo) {
+                                     .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
+                                     .magFilter = VK_FILTER_LINEAR,
+                                     .minFilter = VK_FILTER_LINEAR,
+                                     .mipmapMode = VK_SAMPLER_MIPMAP_MODE_LINEAR,
+                                     .addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                     .addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE,
+                                     .addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT,
+                                     .borderColor = VK_BORDER_COLOR_FLOAT_TRANSPARENT_BLACK,
+                                     .unnormalizedCoordinates = VK_FALSE,
+                                     .maxAnisotropy = 1.0,
+                                     .minLod = 0.0,
+                                     .maxLod = VK_LOD_CLAMP_NONE,
+                                 },
+                                 NULL,
+                                 &self->samplers[GSK_VULKAN_SAMPLER_MIPMAP]);
   
 
   gsk_vulkan_render_ops_init (&self->render_ops);
@@ -352,6 +467,7 @@ gsk_vulkan_render_new (GskRenderer      *renderer,
 #ifdef G_ENABLE_DEBUG
   self->render_pass_counter = g_quark_from_static_string ("render-passes");
   self->gpu_time_timer = g_quark_from_static_string ("gpu-time");
+  gsk_vulkan_render_init_timestamps (self);
 #endif
 
   return self;
@@ -471,21 +587,78 @@ gsk_vulkan_render_sort_ops (GskVulkanRender *self)
     sort_data.command.last->next = NULL;
 }
 
+/*<private>
+ * gsk_vulkan_render_get_tiles:
+ * @self: a `GskVulkanRender`
+ *
+ * Snaps the damage to a grid of TILE_SIZE tiles. This merges the many
+ * small rectangles a damage region tends to have into few areas, while
+ * keeping damage at distant places of the surface apart.
+ *
+ * Returns: (transfer full): the damaged tiles
+ */
+static cairo_region_t *
+gsk_vulkan_render_get_tiles (GskVulkanRender *self)
+{
+  cairo_region_t *tiles;
+  int width, height;
+  int i, n;
+
+  width = gsk_vulkan_image_get_width (self->target);
+  height = gsk_vulkan_image_get_height (self->target);
+  tiles = cairo_region_create ();
+
+  n = cairo_region_num_rectangles (self->clip);
+  for (i = 0; i < n; i++)
+    {
+      cairo_rectangle_int_t rect;
+      int x0, y0, x1, y1;
+
+      cairo_region_get_rectangle (self->clip, i, &rect);
+      if (rect.width <= 0 || rect.height <= 0)
+        continue;
+
+      x0 = MAX (rect.x, 0) / TILE_SIZE * TILE_SIZE;
+      y0 = MAX (rect.y, 0) / TILE_SIZE * TILE_SIZE;
+      x1 = MIN ((rect.x + rect.width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE, width);
+      y1 = MIN ((rect.y + rect.height + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE, height);
+      if (x1 <= x0 || y1 <= y0)
+        continue;
+
+      cairo_region_union_rectangle (tiles, &(cairo_rectangle_int_t) { x0, y0, x1 - x0, y1 - y0 });
+    }
+
+  return tiles;
+}
+
+static gsize
+region_get_area (const cairo_region_t *region)
+{
+  cairo_rectangle_int_t rect;
+  gsize area = 0;
+  int i;
+
+  for (i = 0; i < cairo_region_num_rectangles (region); i++)
+    {
+      cairo_region_get_rectangle (region, i, &rect);
+      area += (gsize) rect.width * rect.height;
+    }
+
+  return area;
+}
+
 static void
-gsk_vulkan_render_add_node (GskVulkanRender       *self,
-                            GskRenderNode         *node,
-                            GskVulkanDownloadFunc  download_func,
-                            gpointer               download_data)
+gsk_vulkan_render_add_pass (GskVulkanRender             *self,
+                            GskRenderNode               *node,
+                            const cairo_rectangle_int_t *area,
+                            VkImageLayout                initial_layout)
 {
   GskVulkanRenderPass *render_pass;
-  cairo_rectangle_int_t extents;
-
-  cairo_region_get_extents (self->clip, &extents);
 
   gsk_vulkan_render_pass_begin_op (self,
                                    self->target,
-                                   &extents,
-                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                   area,
+                                   initial_layout,
                                    VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
 
   render_pass = gsk_vulkan_render_pass_new ();
@@ -493,7 +666,7 @@ gsk_vulkan_render_add_node (GskVulkanRender       *self,
                               self,
                               gsk_vulkan_image_get_width (self->target),
                               gsk_vulkan_image_get_height (self->target),
-                              &extents,
+                              (cairo_rectangle_int_t *) area,
                               node,
                               &self->viewport);
   gsk_vulkan_render_pass_free (render_pass);
@@ -501,10 +674,60 @@ gsk_vulkan_render_add_node (GskVulkanRender       *self,
   gsk_vulkan_render_pass_end_op (self,
                                  self->target,
                                  VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+}
+
+static void
+gsk_vulkan_render_add_node (GskVulkanRender       *self,
+                            GskRenderNode         *node,
+                            GskVulkanDownloadFunc  download_func,
+                            gpointer               download_data)
+{
+  cairo_rectangle_int_t extents;
+  cairo_region_t *tiles;
+  int n_tiles;
+
+  cairo_region_get_extents (self->clip, &extents);
+  tiles = gsk_vulkan_render_get_tiles (self);
+  n_tiles = cairo_region_num_rectangles (tiles);
+
+  /* Render sparse damage as one pass per damaged area, instead of
+   * redrawing everything in between. Each pass only records the nodes
+   * intersecting its area.
+   */
+  if (n_tiles > 1 && n_tiles <= MAX_TILED_PASSES &&
+      region_get_area (tiles) * 2 < (gsize) extents.width * extents.height)
+    {
+      cairo_rectangle_int_t area;
+      int i;
+
+      /* Sorting the ops moves later top-level passes in front of earlier
+       * ones, so we go backwards and the area recorded last is the first
+       * to be rendered. That one gets the undefined layout.
+       */
+      for (i = n_tiles - 1; i >= 0; i--)
+        {
+          cairo_region_get_rectangle (tiles, i, &area);
+          gsk_vulkan_render_add_pass (self,
+                                      node,
+                                      &area,
+                                      i == 0 ? VK_IMAGE_LAYOUT_UNDEFINED
+                                             : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+        }
+    }
+  else
+    {
+      gsk_vulkan_render_add_pass (self, node, &extents, VK_IMAGE_LAYOUT_UNDEFINED);
+    }
+
+  cairo_region_destroy (tiles);
 
   if (download_func)
     gsk_vulkan_download_op (self, self->target, download_func, download_data);
+}
 
+static void
+gsk_vulkan_render_prepare_ops (GskVulkanRender *self)
+{
   gsk_vulkan_render_seal_ops (self);
   gsk_vulkan_render_verbose_print (self, "start of frame");
   gsk_vulkan_render_sort_ops (self);
@@ -636,6 +859,24 @@ gsk_vulkan_render_get_pipeline (GskVulkanRender        *self,
   return pipeline;
 }
 
+/* Consecutive ops often use the same pipeline even when they can't
+ * be merged into one draw, for example when their vertices are not
+ * adjacent
+ */
+void
+gsk_vulkan_render_bind_pipeline (GskVulkanRender *self,
+                                 VkCommandBuffer  command_buffer,
+                                 VkPipeline       pipeline)
+{
+  if (self->bound_pipeline == pipeline)
+    return;
+
+  vkCmdBindPipeline (command_buffer,
+                     VK_PIPELINE_BIND_POINT_GRAPHICS,
+                     pipeline);
+  self->bound_pipeline = pipeline;
+}
+
 VkRenderPass
 gsk_vulkan_render_get_render_pass (GskVulkanRender *self,
                                    VkFormat         format,
@@ -706,7 +947,15 @@ gsk_vulkan_render_get_image_descriptor (GskVulkanRender        *self,
 {
   gsize result;
 
+  /* Atlases and cached textures are used by many ops per frame,
+   * give them all the same descriptor
+   */
+  result = GPOINTER_TO_SIZE (g_hash_table_lookup (self->image_descriptor_indices[render_sampler], image));
+  if (result > 0)
+    return result - 1;
+
   result = gsk_descriptor_image_infos_get_size (&self->descriptor_images);
+  g_hash_table_insert (self->image_descriptor_indices[render_sampler], image, GSIZE_TO_POINTER (result + 1));
   gsk_descriptor_image_infos_append (&self->descriptor_images,
                                      &(VkDescriptorImageInfo) {
                                        .sampler = self->samplers[render_sampler],
@@ -722,22 +971,19 @@ gsk_vulkan_render_get_image_descriptor (GskVulkanRender        *self,
 static void
 gsk_vulkan_render_ensure_storage_buffer (GskVulkanRender *self)
 {
-  if (self->storage_buffer_memory != NULL)
+  if (gsk_descriptor_buffer_infos_get_size (&self->descriptor_buffers) > 0)
     return;
 
-  if (self->storage_buffer == NULL)
-    {
-      self->storage_buffer = gsk_vulkan_buffer_new_storage (self->vulkan,
-                                                            /* random */
-                                                            sizeof (float) * 1024 * 1024);
-    }
-
-  self->storage_buffer_memory = gsk_vulkan_buffer_map (self->storage_buffer);
-
-  if (gsk_vulkan_render_get_buffer_descriptor (self, self->storage_buffer) != 0)
-    {
-      g_assert_not_reached ();
-    }
+  /* The storage buffer is always descriptor 0. We only know where it
+   * goes once all data has been collected, so the buffer gets filled in
+   * by gsk_vulkan_render_upload_storage_buffer().
+   */
+  gsk_descriptor_buffer_infos_append (&self->descriptor_buffers,
+                                      &(VkDescriptorBufferInfo) {
+                                        .buffer = VK_NULL_HANDLE,
+                                        .offset = 0,
+                                        .range = VK_WHOLE_SIZE
+                                      });
 }
 
 gsize
@@ -773,19 +1019,62 @@ gsk_vulkan_render_get_buffer_memory (GskVulkanRender *self,
                                      gsize            alignment,
                                      gsize           *out_offset)
 {
-  guchar *result;
+  gsize offset;
 
   g_assert (alignment >= sizeof (float));
+  g_assert (alignment <= VERTEX_BUFFER_ALIGNMENT);
 
   gsk_vulkan_render_ensure_storage_buffer (self);
 
-  self->storage_buffer_used = round_up (self->storage_buffer_used, alignment);
-  result = self->storage_buffer_memory + self->storage_buffer_used;
-  *out_offset = self->storage_buffer_used / sizeof (float);
+  offset = round_up (self->storage_data->len, alignment);
+  g_byte_array_set_size (self->storage_data, offset + size);
+  *out_offset = offset / sizeof (float);
 
-  self->storage_buffer_used += size;
+  return self->storage_data->data + offset;
+}
 
-  return result;
+static void
+gsk_vulkan_render_upload_storage_buffer (GskVulkanRender *self)
+{
+  VkDescriptorBufferInfo *info;
+  gsize size, offset;
+  guchar *data;
+
+  /* Don't bind an empty range */
+  size = MAX (self->storage_data->len, sizeof (float));
+  info = gsk_descriptor_buffer_infos_index (&self->descriptor_buffers, 0);
+
+  data = gsk_vulkan_ring_buffer_alloc (self->ring_buffer,
+                                       size,
+                                       MAX (gsk_vulkan_ring_buffer_get_storage_alignment (self->ring_buffer),
+                                            VERTEX_BUFFER_ALIGNMENT),
+                                       &offset);
+  if (data)
+    {
+      memcpy (data, self->storage_data->data, self->storage_data->len);
+
+      info->buffer = gsk_vulkan_ring_buffer_get_buffer (self->ring_buffer);
+      info->offset = offset;
+      info->range = size;
+    }
+  else
+    {
+      if (self->storage_buffer && gsk_vulkan_buffer_get_size (self->storage_buffer) < size)
+        g_clear_pointer (&self->storage_buffer, gsk_vulkan_buffer_free);
+
+      if (self->storage_buffer == NULL)
+        self->storage_buffer = gsk_vulkan_buffer_new_storage (self->vulkan, round_up (size, VERTEX_BUFFER_SIZE_STEP));
+
+      data = gsk_vulkan_buffer_map (self->storage_buffer);
+      memcpy (data, self->storage_data->data, self->storage_data->len);
+      gsk_vulkan_buffer_unmap (self->storage_buffer);
+
+      info->buffer = gsk_vulkan_buffer_get_buffer (self->storage_buffer);
+      info->offset = 0;
+      info->range = VK_WHOLE_SIZE;
+    }
+
+  g_byte_array_set_size (self->storage_data, 0);
 }
 
 static void
@@ -803,12 +1092,8 @@ gsk_vulkan_render_prepare_descriptor_sets (GskVulkanRender *self)
       gsk_vulkan_op_reserve_descriptor_sets (op, self);
     }
   
-  if (self->storage_buffer_memory)
-    {
-      gsk_vulkan_buffer_unmap (self->storage_buffer);
-      self->storage_buffer_memory = NULL;
-      self->storage_buffer_used = 0;
-    }
+  if (gsk_descriptor_buffer_infos_get_size (&self->descriptor_buffers) > 0)
+    gsk_vulkan_render_upload_storage_buffer (self);
 
   GSK_VK_CHECK (vkAllocateDescriptorSets, device,
                                           &(VkDescriptorSetAllocateInfo) {
@@ -863,7 +1148,8 @@ static void
 gsk_vulkan_render_collect_vertex_buffer (GskVulkanRender *self)
 {
   GskVulkanOp *op;
-  gsize n_bytes;
+  gsize n_bytes, offset;
+  gboolean from_ring;
   guchar *data;
 
   n_bytes = 0;
@@ -874,18 +1160,33 @@ gsk_vulkan_render_collect_vertex_buffer (GskVulkanRender *self)
   if (n_bytes == 0)
     return;
 
-  if (self->vertex_buffer && gsk_vulkan_buffer_get_size (self->vertex_buffer) < n_bytes)
-    g_clear_pointer (&self->vertex_buffer, gsk_vulkan_buffer_free);
+  data = gsk_vulkan_ring_buffer_alloc (self->ring_buffer, n_bytes, VERTEX_BUFFER_ALIGNMENT, &offset);
+  from_ring = data != NULL;
+  if (from_ring)
+    {
+      self->vertex_vk_buffer = gsk_vulkan_ring_buffer_get_buffer (self->ring_buffer);
+      self->vertex_offset = offset;
+    }
+  else
+    {
+      if (self->vertex_buffer && gsk_vulkan_buffer_get_size (self->vertex_buffer) < n_bytes)
+        g_clear_pointer (&self->vertex_buffer, gsk_vulkan_buffer_free);
 
-  if (self->vertex_buffer == NULL)
-    self->vertex_buffer = gsk_vulkan_buffer_new (self->vulkan, round_up (n_bytes, VERTEX_BUFFER_SIZE_STEP));
+      if (self->vertex_buffer == NULL)
+        self->vertex_buffer = gsk_vulkan_buffer_new (self->vulkan, round_up (n_bytes, VERTEX_BUFFER_SIZE_STEP));
+
+      data = gsk_vulkan_buffer_map (self->vertex_buffer);
+      self->vertex_vk_buffer = gsk_vulkan_buffer_get_buffer (self->vertex_buffer);
+      self->vertex_offset = 0;
+    }
 
-  data = gsk_vulkan_buffer_map (self->vertex_buffer);
   for (op = self->first_op; op; op = op->next)
     {
       gsk_vulkan_op_collect_vertex_data (op, data);
     }
-  gsk_vulkan_buffer_unmap (self->vertex_buffer);
+
+  if (!from_ring)
+    gsk_vulkan_buffer_unmap (self->vertex_buffer);
 }
 
 static void
@@ -895,7 +1196,7 @@ gsk_vulkan_render_submit (GskVulkanRender *self)
   GskVulkanOp *op;
 
 #ifdef G_ENABLE_DEBUG
-  if (GSK_RENDERER_DEBUG_CHECK (self->renderer, SYNC))
+  if (GSK_RENDERER_DEBUG_CHECK (self->renderer, SYNC) && self->timestamp_pool == VK_NULL_HANDLE)
     gsk_profiler_timer_begin (gsk_renderer_get_profiler (self->renderer), self->gpu_time_timer);
 #endif
 
@@ -903,16 +1204,26 @@ gsk_vulkan_render_submit (GskVulkanRender *self)
 
   gsk_vulkan_render_collect_vertex_buffer (self);
 
+  self->ring_frame = gsk_vulkan_ring_buffer_end_frame (self->ring_buffer);
+
   command_buffer = gsk_vulkan_command_pool_get_buffer (self->command_pool);
 
-  if (self->vertex_buffer)
+#ifdef G_ENABLE_DEBUG
+  if (self->timestamp_pool)
+    {
+      vkCmdResetQueryPool (command_buffer, self->timestamp_pool, 0, 2);
+      vkCmdWriteTimestamp (command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, self->timestamp_pool, 0);
+    }
+#endif
+
+  if (self->vertex_vk_buffer)
     vkCmdBindVertexBuffers (command_buffer,
                             0,
                             1,
                             (VkBuffer[1]) {
-                                gsk_vulkan_buffer_get_buffer (self->vertex_buffer)
+                                self->vertex_vk_buffer
                             },
-                            (VkDeviceSize[1]) { 0 });
+                            (VkDeviceSize[1]) { self->vertex_offset });
 
   vkCmdBindDescriptorSets (command_buffer,
                            VK_PIPELINE_BIND_POINT_GRAPHICS,
@@ -923,12 +1234,22 @@ gsk_vulkan_render_submit (GskVulkanRender *self)
                            0,
                            NULL);
 
+  self->bound_pipeline = VK_NULL_HANDLE;
+
   op = self->first_op;
   while (op)
     {
       op = gsk_vulkan_op_command (op, self, VK_NULL_HANDLE, command_buffer);
     }
 
+#ifdef G_ENABLE_DEBUG
+  if (self->timestamp_pool)
+    {
+      vkCmdWriteTimestamp (command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, self->timestamp_pool, 1);
+      self->timestamps_pending = TRUE;
+    }
+#endif
+
   gsk_vulkan_command_pool_submit_buffer (self->command_pool,
                                          command_buffer,
                                          0,
@@ -940,18 +1261,25 @@ gsk_vulkan_render_submit (GskVulkanRender *self)
 #ifdef G_ENABLE_DEBUG
   if (GSK_RENDERER_DEBUG_CHECK (self->renderer, SYNC))
     {
-      GskProfiler *profiler;
-      gint64 gpu_time;
-
       GSK_VK_CHECK (vkWaitForFences, gdk_vulkan_context_get_device (self->vulkan),
                                      1,
                                      &self->fence,
                                      VK_TRUE,
                                      INT64_MAX);
 
-      profiler = gsk_renderer_get_profiler (self->renderer);
-      gpu_time = gsk_profiler_timer_end (profiler, self->gpu_time_timer);
-      gsk_profiler_timer_set (profiler, self->gpu_time_timer, gpu_time);
+      if (self->timestamp_pool)
+        {
+          gsk_vulkan_render_collect_timestamps (self);
+        }
+      else
+        {
+          GskProfiler *profiler;
+          gint64 gpu_time;
+
+          profiler = gsk_renderer_get_profiler (self->renderer);
+          gpu_time = gsk_profiler_timer_end (profiler, self->gpu_time_timer);
+          gsk_profiler_timer_set (profiler, self->gpu_time_timer, gpu_time);
+        }
     }
 #endif
 }
@@ -970,10 +1298,22 @@ gsk_vulkan_render_cleanup (GskVulkanRender *self)
                                  VK_TRUE,
                                  INT64_MAX);
 
+#ifdef G_ENABLE_DEBUG
+  /* Without GSK_DEBUG=sync, the GPU time of a frame is only known
+   * once its fence has been waited on, so it gets reported with a
+   * later frame.
+   */
+  gsk_vulkan_render_collect_timestamps (self);
+#endif
+
   GSK_VK_CHECK (vkResetFences, device,
                                1,
                                &self->fence);
 
+  gsk_vulkan_ring_buffer_release_frame (self->ring_buffer, self->ring_frame);
+  self->ring_frame = 0;
+  self->vertex_vk_buffer = VK_NULL_HANDLE;
+
   for (i = 0; i < gsk_vulkan_render_ops_get_size (&self->render_ops); i += op->op_class->size)
     {
       op = (GskVulkanOp *) gsk_vulkan_render_ops_index (&self->render_ops, i);
@@ -988,6 +1328,8 @@ gsk_vulkan_render_cleanup (GskVulkanRender *self)
                                        self->descriptor_pool,
                                        0);
   gsk_descriptor_image_infos_set_size (&self->descriptor_images, 0);
+  for (i = 0; i < G_N_ELEMENTS (self->image_descriptor_indices); i++)
+    g_hash_table_remove_all (self->image_descriptor_indices[i]);
   gsk_descriptor_buffer_infos_set_size (&self->descriptor_buffers, 0);
 
   g_clear_pointer (&self->clip, cairo_region_destroy);
@@ -1006,6 +1348,7 @@ gsk_vulkan_render_free (GskVulkanRender *self)
 
   g_clear_pointer (&self->storage_buffer, gsk_vulkan_buffer_free);
   g_clear_pointer (&self->vertex_buffer, gsk_vulkan_buffer_free);
+  g_byte_array_unref (self->storage_data);
 
   device = gdk_vulkan_context_get_device (self->vulkan);
 
@@ -1036,6 +1379,8 @@ gsk_vulkan_render_free (GskVulkanRender *self)
                            self->descriptor_pool,
                            NULL);
   gsk_descriptor_image_infos_clear (&self->descriptor_images);
+  for (i = 0; i < G_N_ELEMENTS (self->image_descriptor_indices); i++)
+    g_hash_table_unref (self->image_descriptor_indices[i]);
   gsk_descriptor_buffer_infos_clear (&self->descriptor_buffers);
 
   for (i = 0; i < N_DESCRIPTOR_SETS; i++)
@@ -1047,6 +1392,11 @@ gsk_vulkan_render_free (GskVulkanRender *self)
                   self->fence,
                   NULL);
 
+  if (self->timestamp_pool)
+    vkDestroyQueryPool (device,
+                        self->timestamp_pool,
+                        NULL);
+
   for (i = 0; i < G_N_ELEMENTS (self->samplers); i++)
     {
       vkDestroySampler (device,
@@ -1080,6 +1430,56 @@ gsk_vulkan_render_render (GskVulkanRender       *self,
 
   gsk_vulkan_render_add_node (self, node, download_func, download_data);
 
+  gsk_vulkan_render_prepare_ops (self);
+
+  gsk_vulkan_render_submit (self);
+}
+
+/*<private>
+ * gsk_vulkan_render_render_batch:
+ * @self: a `GskVulkanRender`
+ * @targets: (array length=n_nodes): the images to render to, they must
+ *   all have the same format
+ * @rects: (array length=n_nodes): the viewports for each node
+ * @nodes: (array length=n_nodes): the nodes to render
+ * @n_nodes: the number of nodes
+ * @download_func: function to call with the contents of each target
+ * @download_data: (array length=n_nodes): data to pass to @download_func
+ *   for each target
+ *
+ * Renders multiple nodes to their own targets with a single command
+ * buffer. Sorting the ops puts all render passes before the downloads,
+ * so that each download happens after its node was drawn.
+ */
+void
+gsk_vulkan_render_render_batch (GskVulkanRender        *self,
+                                GskVulkanImage        **targets,
+                                const graphene_rect_t  *rects,
+                                GskRenderNode         **nodes,
+                                gsize                   n_nodes,
+                                GskVulkanDownloadFunc   download_func,
+                                gpointer               *download_data)
+{
+  gsize i;
+
+  g_return_if_fail (n_nodes > 0);
+
+  gsk_vulkan_render_cleanup (self);
+
+  for (i = 0; i < n_nodes; i++)
+    {
+      g_assert (gsk_vulkan_image_get_vk_format (targets[i]) == gsk_vulkan_image_get_vk_format (targets[0]));
+
+      /* The pipelines are looked up with the format of the last target */
+      g_clear_pointer (&self->clip, cairo_region_destroy);
+      g_clear_object (&self->target);
+      gsk_vulkan_render_setup (self, targets[i], &rects[i], NULL);
+
+      gsk_vulkan_render_add_node (self, nodes[i], download_func, download_data[i]);
+    }
+
+  gsk_vulkan_render_prepare_ops (self);
+
   gsk_vulkan_render_submit (self);
 }
 
@@ -6,6 +6,7 @@
 #include "gskprivate.h"
 #include "gskrendererprivate.h"
 #include "gskrendernodeprivate.h"
+#include "gskshadowcacheprivate.h"
 #include "gskvulkanbufferprivate.h"
 #include "gskvulkanimageprivate.h"
 #include "gskvulkanprivate.h"
@@ -21,6 +22,8 @@
 #include <graphene.h>
 
 #define GSK_VULKAN_MAX_RENDERS 4
+#define GSK_VULKAN_RING_BUFFER_SIZE (4 * 1024 * 1024)
+#define GSK_VULKAN_WARM_UP_SIZE 16
 
 typedef struct _GskVulkanTextureData GskVulkanTextureData;
 
@@ -61,6 +64,7 @@ struct _GskVulkanRenderer
   GSList *textures;
 
   GskVulkanGlyphCache *glyph_cache;
+  GskVulkanRingBuffer *ring_buffer;
 
 #ifdef G_ENABLE_DEBUG
   ProfileCounters profile_counters;
@@ -201,6 +205,122 @@ gsk_vulkan_renderer_get_render (GskVulkanRenderer *self)
     }
 }
 
+static GskRenderNode *
+gsk_vulkan_renderer_create_warm_up_node (void)
+{
+  const graphene_rect_t bounds = GRAPHENE_RECT_INIT (0, 0, GSK_VULKAN_WARM_UP_SIZE, GSK_VULKAN_WARM_UP_SIZE);
+  const graphene_rect_t clip = GRAPHENE_RECT_INIT (1, 1, GSK_VULKAN_WARM_UP_SIZE - 2, GSK_VULKAN_WARM_UP_SIZE - 2);
+  const GdkRGBA color = { 0.5, 0.5, 0.5, 0.5 };
+  const GskColorStop stops[2] = { { 0, { 0, 0, 0, 1 } }, { 1, { 1, 1, 1, 1 } } };
+  static const guchar pixel[4] = { 0xff, 0xff, 0xff, 0xff };
+  GskRoundedRect outline, rounded_clip;
+  GskRenderNode *nodes[8], *variants[3], *node;
+  GdkTexture *texture;
+  GBytes *bytes;
+  guint i;
+
+  gsk_rounded_rect_init_from_rect (&outline, &bounds, 4);
+  gsk_rounded_rect_init_from_rect (&rounded_clip, &clip, 4);
+
+  bytes = g_bytes_new_static (pixel, sizeof (pixel));
+  texture = gdk_memory_texture_new (1, 1, GDK_MEMORY_DEFAULT, bytes, 4);
+  g_bytes_unref (bytes);
+
+  nodes[0] = gsk_color_node_new (&color, &bounds);
+  nodes[1] = gsk_texture_node_new (texture, &bounds);
+  nodes[2] = gsk_border_node_new (&outline,
+                                  (float[4]) { 1, 1, 1, 1 },
+                                  (GdkRGBA[4]) { color, color, color, color });
+  nodes[3] = gsk_linear_gradient_node_new (&bounds,
+                                           &GRAPHENE_POINT_INIT (0, 0),
+                                           &GRAPHENE_POINT_INIT (GSK_VULKAN_WARM_UP_SIZE, 0),
+                                           stops, G_N_ELEMENTS (stops));
+  nodes[4] = gsk_inset_shadow_node_new (&outline, &color, 1, 1, 1, 0);
+  nodes[5] = gsk_outset_shadow_node_new (&outline, &color, 1, 1, 1, 0);
+  nodes[6] = gsk_radial_gradient_node_new (&bounds,
+                                           &GRAPHENE_POINT_INIT (GSK_VULKAN_WARM_UP_SIZE / 2, GSK_VULKAN_WARM_UP_SIZE / 2),
+                                           GSK_VULKAN_WARM_UP_SIZE / 2, GSK_VULKAN_WARM_UP_SIZE / 2,
+                                           0, 1,
+                                           stops, G_N_ELEMENTS (stops));
+  nodes[7] = gsk_conic_gradient_node_new (&bounds,
+                                          &GRAPHENE_POINT_INIT (GSK_VULKAN_WARM_UP_SIZE / 2, GSK_VULKAN_WARM_UP_SIZE / 2),
+                                          0,
+                                          stops, G_N_ELEMENTS (stops));
+  g_object_unref (texture);
+
+  node = gsk_container_node_new (nodes, G_N_ELEMENTS (nodes));
+  for (i = 0; i < G_N_ELEMENTS (nodes); i++)
+    gsk_render_node_unref (nodes[i]);
+
+  /* one copy each for the unclipped, clipped and rounded-clipped pipelines */
+  variants[0] = gsk_render_node_ref (node);
+  variants[1] = gsk_clip_node_new (node, &clip);
+  variants[2] = gsk_rounded_clip_node_new (node, &rounded_clip);
+  gsk_render_node_unref (node);
+
+  node = gsk_container_node_new (variants, G_N_ELEMENTS (variants));
+  for (i = 0; i < G_N_ELEMENTS (variants); i++)
+    gsk_render_node_unref (variants[i]);
+
+  return node;
+}
+
+static void
+gsk_vulkan_renderer_warm_up_format (GskVulkanRenderer *self,
+                                    GskRenderNode     *node,
+                                    GdkMemoryFormat    format,
+                                    VkFormat           vk_format)
+{
+  GskVulkanImage *image;
+
+  image = gsk_vulkan_image_new_for_offscreen (self->vulkan,
+                                              format,
+                                              GSK_VULKAN_WARM_UP_SIZE,
+                                              GSK_VULKAN_WARM_UP_SIZE);
+
+  if (vk_format == VK_FORMAT_UNDEFINED ||
+      gsk_vulkan_image_get_vk_format (image) == vk_format)
+    {
+      /* Not waited for, the render keeps the image alive until it is reused */
+      gsk_vulkan_render_render (gsk_vulkan_renderer_get_render (self),
+                                image,
+                                &GRAPHENE_RECT_INIT (0, 0, GSK_VULKAN_WARM_UP_SIZE, GSK_VULKAN_WARM_UP_SIZE),
+                                NULL,
+                                node,
+                                NULL, NULL);
+    }
+
+  g_object_unref (image);
+}
+
+/* Renders a tiny scene containing the commonly used ops, so that their
+ * pipelines get created at realize time and end up in the display's
+ * pipeline cache, which is saved to disk, instead of being compiled
+ * while the first frame is drawn.
+ */
+static void
+gsk_vulkan_renderer_warm_up (GskVulkanRenderer *self)
+{
+  GskRenderNode *node;
+  GdkMemoryFormat offscreen_format;
+  VkFormat swapchain_format;
+
+  node = gsk_vulkan_renderer_create_warm_up_node ();
+
+  offscreen_format = gdk_vulkan_context_get_offscreen_format (self->vulkan, GDK_MEMORY_U8);
+  gsk_vulkan_renderer_warm_up_format (self, node, offscreen_format, VK_FORMAT_UNDEFINED);
+
+  /* The swapchain images can't be drawn to outside of a frame, so use
+   * an offscreen with the same format instead, if there is one. */
+  swapchain_format = gdk_vulkan_context_get_image_format (self->vulkan);
+  if (swapchain_format == VK_FORMAT_B8G8R8A8_UNORM)
+    gsk_vulkan_renderer_warm_up_format (self, node, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED, swapchain_format);
+  else if (swapchain_format == VK_FORMAT_R8G8B8A8_UNORM)
+    gsk_vulkan_renderer_warm_up_format (self, node, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, swapchain_format);
+
+  gsk_render_node_unref (node);
+}
+
 static gboolean
 gsk_vulkan_renderer_realize (GskRenderer  *renderer,
                              GdkSurface   *surface,
@@ -223,18 +343,18 @@ gsk_vulkan_renderer_realize (GskRenderer  *renderer,
   gsk_vulkan_renderer_update_images_cb (self->vulkan, self);
 
   self->glyph_cache = gsk_vulkan_glyph_cache_new (self->vulkan);
+  self->ring_buffer = gsk_vulkan_ring_buffer_new (self->vulkan, GSK_VULKAN_RING_BUFFER_SIZE);
+
+  if (surface != NULL)
+    gsk_vulkan_renderer_warm_up (self);
 
   return TRUE;
 }
 
 static void
-gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
+gsk_vulkan_renderer_clear_textures (GskVulkanRenderer *self)
 {
-  GskVulkanRenderer *self = GSK_VULKAN_RENDERER (renderer);
   GSList *l;
-  guint i;
-
-  g_clear_object (&self->glyph_cache);
 
   for (l = self->textures; l; l = l->next)
     {
@@ -244,10 +364,24 @@ gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
       gdk_texture_clear_render_data (data->texture);
     }
   g_clear_pointer (&self->textures, g_slist_free);
+}
+
+static void
+gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
+{
+  GskVulkanRenderer *self = GSK_VULKAN_RENDERER (renderer);
+  guint i;
+
+  g_clear_object (&self->glyph_cache);
+
+  gsk_vulkan_renderer_clear_textures (self);
 
   for (i = 0; i < G_N_ELEMENTS (self->renders); i++)
     g_clear_pointer (&self->renders[i], gsk_vulkan_render_free);
 
+  /* after the renders, which release their frames when freed */
+  g_clear_pointer (&self->ring_buffer, gsk_vulkan_ring_buffer_free);
+
   gsk_vulkan_renderer_free_targets (self);
   g_signal_handlers_disconnect_by_func(self->vulkan,
                                        gsk_vulkan_renderer_update_images_cb,
@@ -256,6 +390,15 @@ gsk_vulkan_renderer_unrealize (GskRenderer *renderer)
   g_clear_object (&self->vulkan);
 }
 
+/* Uploaded textures are kept around as long as their GdkTexture lives,
+ * drop them so they are uploaded again when they are needed.
+ */
+static void
+gsk_vulkan_renderer_trim (GskRenderer *renderer)
+{
+  gsk_vulkan_renderer_clear_textures (GSK_VULKAN_RENDERER (renderer));
+}
+
 static void
 gsk_vulkan_renderer_download_texture_cb (gpointer         user_data,
                                          GdkMemoryFormat  format,
@@ -346,6 +489,103 @@ gsk_vulkan_renderer_render_texture (GskRenderer           *renderer,
   return texture;
 }
 
+/* Limits how much memory the images of a single batch in
+ * gsk_vulkan_renderer_render_textures() may use, in pixels.
+ */
+#define MAX_BATCH_PIXELS (4096 * 4096)
+
+static void
+gsk_vulkan_renderer_render_textures (GskRenderer            *renderer,
+                                     GskRenderNode         **roots,
+                                     const graphene_rect_t  *viewports,
+                                     gsize                   n_roots,
+                                     GdkTexture            **textures)
+{
+  GskVulkanRenderer *self = GSK_VULKAN_RENDERER (renderer);
+  GskVulkanRender *render;
+  GskVulkanImage **images;
+  graphene_rect_t *rounded_viewports;
+  gpointer *download_data;
+  gsize i, j;
+#ifdef G_ENABLE_DEBUG
+  GskProfiler *profiler;
+  gint64 cpu_time;
+#endif
+
+#ifdef G_ENABLE_DEBUG
+  profiler = gsk_renderer_get_profiler (renderer);
+  gsk_profiler_counter_set (profiler, self->profile_counters.fallback_pixels, 0);
+  gsk_profiler_counter_set (profiler, self->profile_counters.texture_pixels, 0);
+  gsk_profiler_counter_set (profiler, self->profile_counters.render_passes, 0);
+  gsk_profiler_timer_begin (profiler, self->profile_timers.cpu_time);
+#endif
+
+  render = gsk_vulkan_render_new (renderer, self->vulkan);
+  images = g_new (GskVulkanImage *, n_roots);
+  rounded_viewports = g_new (graphene_rect_t, n_roots);
+  download_data = g_new (gpointer, n_roots);
+
+  /* Submit runs of nodes with the same format together */
+  i = 0;
+  while (i < n_roots)
+    {
+      GdkMemoryFormat format;
+      gsize n_pixels = 0;
+
+      format = gdk_vulkan_context_get_offscreen_format (self->vulkan,
+                                                        gsk_render_node_get_preferred_depth (roots[i]));
+
+      for (j = i; j < n_roots && n_pixels < MAX_BATCH_PIXELS; j++)
+        {
+          if (gdk_vulkan_context_get_offscreen_format (self->vulkan,
+                                                       gsk_render_node_get_preferred_depth (roots[j])) != format)
+            break;
+
+          rounded_viewports[j] = GRAPHENE_RECT_INIT (viewports[j].origin.x,
+                                                     viewports[j].origin.y,
+                                                     ceil (viewports[j].size.width),
+                                                     ceil (viewports[j].size.height));
+          images[j] = gsk_vulkan_image_new_for_offscreen (self->vulkan,
+                                                          format,
+                                                          rounded_viewports[j].size.width,
+                                                          rounded_viewports[j].size.height);
+          textures[j] = NULL;
+          download_data[j] = &textures[j];
+
+          n_pixels += rounded_viewports[j].size.width * rounded_viewports[j].size.height;
+        }
+
+      gsk_vulkan_render_render_batch (render,
+                                      &images[i],
+                                      &rounded_viewports[i],
+                                      &roots[i],
+                                      j - i,
+                                      gsk_vulkan_renderer_download_texture_cb,
+                                      &download_data[i]);
+
+      /* The render keeps the images alive until the batch is done */
+      for (; i < j; i++)
+        g_object_unref (images[i]);
+    }
+
+  /* This waits for the last batch and downloads its textures */
+  gsk_vulkan_render_free (render);
+
+  for (i = 0; i < n_roots; i++)
+    g_assert (textures[i]);
+
+  g_free (download_data);
+  g_free (rounded_viewports);
+  g_free (images);
+
+#ifdef G_ENABLE_DEBUG
+  cpu_time = gsk_profiler_timer_end (profiler, self->profile_timers.cpu_time);
+  gsk_profiler_timer_set (profiler, self->profile_timers.cpu_time, cpu_time);
+
+  gsk_profiler_push_samples (profiler);
+#endif
+}
+
 static void
 gsk_vulkan_renderer_render (GskRenderer          *renderer,
                             GskRenderNode        *root,
@@ -412,6 +652,8 @@ gsk_vulkan_renderer_class_init (GskVulkanRendererClass *klass)
   renderer_class->unrealize = gsk_vulkan_renderer_unrealize;
   renderer_class->render = gsk_vulkan_renderer_render;
   renderer_class->render_texture = gsk_vulkan_renderer_render_texture;
+  renderer_class->render_textures = gsk_vulkan_renderer_render_textures;
+  renderer_class->trim = gsk_vulkan_renderer_trim;
 }
 
 static void
@@ -428,10 +670,10 @@ gsk_vulkan_renderer_init (GskVulkanRenderer *self)
   self->profile_counters.render_passes = gsk_profiler_add_counter (profiler, "render-passes", "Render passes", FALSE);
   self->profile_counters.fallback_pixels = gsk_profiler_add_counter (profiler, "fallback-pixels", "Fallback pixels", TRUE);
   self->profile_counters.texture_pixels = gsk_profiler_add_counter (profiler, "texture-pixels", "Texture pixels", TRUE);
+  gsk_shadow_cache_add_counters (profiler);
 
   self->profile_timers.cpu_time = gsk_profiler_add_timer (profiler, "cpu-time", "CPU time", FALSE, TRUE);
-  if (GSK_RENDERER_DEBUG_CHECK (GSK_RENDERER (self), SYNC))
-    self->profile_timers.gpu_time = gsk_profiler_add_timer (profiler, "gpu-time", "GPU time", FALSE, TRUE);
+  self->profile_timers.gpu_time = gsk_profiler_add_timer (profiler, "gpu-time", "GPU time", FALSE, TRUE);
 
   if (texture_pixels_counter == 0)
     {
@@ -497,6 +739,12 @@ gsk_vulkan_renderer_get_glyph_cache (GskVulkanRenderer  *self)
   return self->glyph_cache;
 }
 
+GskVulkanRingBuffer *
+gsk_vulkan_renderer_get_ring_buffer (GskVulkanRenderer *self)
+{
+  return self->ring_buffer;
+}
+
 /**
  * gsk_vulkan_renderer_new:
  *
@@ -3,6 +3,7 @@
 #include "gskvulkanrenderer.h"
 #include "gskvulkanglyphcacheprivate.h"
 #include "gskvulkanimageprivate.h"
+#include "gskvulkanringbufferprivate.h"
 
 G_BEGIN_DECLS
 
@@ -13,6 +14,7 @@ void                    gsk_vulkan_renderer_add_texture_image           (GskVulk
                                                                          GskVulkanImage         *image);
 
 GskVulkanGlyphCache *   gsk_vulkan_renderer_get_glyph_cache             (GskVulkanRenderer      *self);
+GskVulkanRingBuffer *   gsk_vulkan_renderer_get_ring_buffer             (GskVulkanRenderer      *self);
 
 
 G_END_DECLS
@@ -4,11 +4,13 @@
 
 #include "gskdebugprivate.h"
 #include "gskprofilerprivate.h"
+#include "gskrectprivate.h"
 #include "gskrendernodeprivate.h"
 #include "gskrenderer.h"
 #include "gskrendererprivate.h"
 #include "gskroundedrectprivate.h"
-#include "gsktransform.h"
+#include "gskshadowcacheprivate.h"
+#include "gsktransformprivate.h"
 #include "gskvulkanblendmodeopprivate.h"
 #include "gskvulkanbluropprivate.h"
 #include "gskvulkanborderopprivate.h"
@@ -16,6 +18,7 @@
 #include "gskvulkanclipprivate.h"
 #include "gskvulkancolormatrixopprivate.h"
 #include "gskvulkancoloropprivate.h"
+#include "gskvulkanconicgradientopprivate.h"
 #include "gskvulkanconvertopprivate.h"
 #include "gskvulkancrossfadeopprivate.h"
 #include "gskvulkanglyphopprivate.h"
@@ -29,11 +32,13 @@
 #include "gskvulkanrenderpassopprivate.h"
 #include "gskvulkanoutsetshadowopprivate.h"
 #include "gskvulkanpushconstantsopprivate.h"
+#include "gskvulkanradialgradientopprivate.h"
 #include "gskvulkanscissoropprivate.h"
 #include "gskvulkantextureopprivate.h"
 #include "gskvulkanuploadopprivate.h"
 #include "gskprivate.h"
 
+#include "gdk/gdktextureprivate.h"
 #include "gdk/gdkvulkancontextprivate.h"
 
 #define ORTHO_NEAR_PLANE        -10000
@@ -143,7 +148,8 @@ gsk_vulkan_parse_rect_is_integer (const GskVulkanParseState *state,
 
 static GskVulkanImage *
 gsk_vulkan_render_pass_upload_texture (GskVulkanRender *render,
-                                       GdkTexture      *texture)
+                                       GdkTexture      *texture,
+                                       gboolean         mipmap)
 {
   GskVulkanImage *image, *better_image;
   int width, height;
@@ -151,7 +157,7 @@ gsk_vulkan_render_pass_upload_texture (GskVulkanRender *render,
   graphene_matrix_t projection;
   graphene_vec2_t scale;
 
-  image = gsk_vulkan_upload_texture_op (render, texture);
+  image = gsk_vulkan_upload_texture_op (render, texture, mipmap);
   postproc = gsk_vulkan_image_get_postprocess (image);
   if (postproc == 0)
     return image;
@@ -206,7 +212,7 @@ gsk_vulkan_render_pass_get_node_as_image (GskVulkanRenderPass       *self,
         result = gsk_vulkan_renderer_get_texture_image (renderer, texture);
         if (result == NULL)
           {
-            result = gsk_vulkan_render_pass_upload_texture (render, texture);
+            result = gsk_vulkan_render_pass_upload_texture (render, texture, FALSE);
             gsk_vulkan_renderer_add_texture_image (renderer, texture, result);
           }
 
@@ -311,8 +317,35 @@ gsk_vulkan_render_pass_add_container_node (GskVulkanRenderPass       *self,
                                            const GskVulkanParseState *state,
                                            GskRenderNode             *node)
 {
-  for (guint i = 0; i < gsk_container_node_get_n_children (node); i++)
-    gsk_vulkan_render_pass_add_node (self, render, state, gsk_container_node_get_child (node, i));
+  GskRenderNode **children;
+  graphene_rect_t visible;
+  guint i, n_children, first;
+
+  children = gsk_container_node_get_children (node, &n_children);
+  first = 0;
+
+  /* Skip all children painted over by a later opaque child that
+   * covers everything visible of this node.
+   */
+  graphene_rect_offset_r (&state->clip.rect.bounds, - state->offset.x, - state->offset.y, &visible);
+  if (n_children > 1 &&
+      graphene_rect_intersection (&visible, &node->bounds, &visible))
+    {
+      for (i = n_children - 1; i > 0; i--)
+        {
+          graphene_rect_t opaque;
+
+          if (gsk_render_node_get_opaque_rect (children[i], &opaque) &&
+              gsk_rect_contains_rect (&opaque, &visible))
+            {
+              first = i;
+              break;
+            }
+        }
+    }
+
+  for (i = first; i < n_children; i++)
+    gsk_vulkan_render_pass_add_node (self, render, state, children[i]);
 
   return TRUE;
 }
@@ -451,6 +484,44 @@ gsk_vulkan_render_pass_add_linear_gradient_node (GskVulkanRenderPass       *self
   return TRUE;
 }
 
+static inline gboolean
+gsk_vulkan_render_pass_add_radial_gradient_node (GskVulkanRenderPass       *self,
+                                                 GskVulkanRender           *render,
+                                                 const GskVulkanParseState *state,
+                                                 GskRenderNode             *node)
+{
+  gsk_vulkan_radial_gradient_op (render,
+                                 gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &node->bounds),
+                                 &node->bounds,
+                                 &state->offset,
+                                 gsk_radial_gradient_node_get_center (node),
+                                 gsk_radial_gradient_node_get_hradius (node),
+                                 gsk_radial_gradient_node_get_vradius (node),
+                                 gsk_radial_gradient_node_get_start (node),
+                                 gsk_radial_gradient_node_get_end (node),
+                                 gsk_render_node_get_node_type (node) == GSK_REPEATING_RADIAL_GRADIENT_NODE,
+                                 gsk_radial_gradient_node_get_color_stops (node, NULL),
+                                 gsk_radial_gradient_node_get_n_color_stops (node));
+  return TRUE;
+}
+
+static inline gboolean
+gsk_vulkan_render_pass_add_conic_gradient_node (GskVulkanRenderPass       *self,
+                                                GskVulkanRender           *render,
+                                                const GskVulkanParseState *state,
+                                                GskRenderNode             *node)
+{
+  gsk_vulkan_conic_gradient_op (render,
+                                gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &node->bounds),
+                                &node->bounds,
+                                &state->offset,
+                                gsk_conic_gradient_node_get_center (node),
+                                gsk_conic_gradient_node_get_angle (node),
+                                gsk_conic_gradient_node_get_color_stops (node, NULL),
+                                gsk_conic_gradient_node_get_n_color_stops (node));
+  return TRUE;
+}
+
 static inline gboolean
 gsk_vulkan_render_pass_add_border_node (GskVulkanRenderPass       *self,
                                         GskVulkanRender           *render,
@@ -481,7 +552,7 @@ gsk_vulkan_render_pass_add_texture_node (GskVulkanRenderPass       *self,
   image = gsk_vulkan_renderer_get_texture_image (renderer, texture);
   if (image == NULL)
     {
-      image = gsk_vulkan_render_pass_upload_texture (render, texture);
+      image = gsk_vulkan_render_pass_upload_texture (render, texture, FALSE);
       gsk_vulkan_renderer_add_texture_image (renderer, texture, image);
     }
 
@@ -506,6 +577,7 @@ gsk_vulkan_render_pass_add_texture_scale_node (GskVulkanRenderPass       *self,
   GskVulkanRenderer *renderer;
   GskVulkanRenderSampler sampler;
   GdkTexture *texture;
+  gboolean mipmap;
 
   renderer = GSK_VULKAN_RENDERER (gsk_vulkan_render_get_renderer (render));
   texture = gsk_texture_scale_node_get_texture (node);
@@ -514,17 +586,28 @@ gsk_vulkan_render_pass_add_texture_scale_node (GskVulkanRenderPass       *self,
     default:
       g_assert_not_reached ();
     case GSK_SCALING_FILTER_LINEAR:
-    case GSK_SCALING_FILTER_TRILINEAR:
       sampler = GSK_VULKAN_SAMPLER_DEFAULT;
+      mipmap = FALSE;
+      break;
+    case GSK_SCALING_FILTER_TRILINEAR:
+      sampler = GSK_VULKAN_SAMPLER_MIPMAP;
+      mipmap = TRUE;
       break;
     case GSK_SCALING_FILTER_NEAREST:
       sampler = GSK_VULKAN_SAMPLER_NEAREST;
+      mipmap = FALSE;
       break;
     }
   image = gsk_vulkan_renderer_get_texture_image (renderer, texture);
-  if (image == NULL)
+  if (image == NULL ||
+      (mipmap && gsk_vulkan_image_get_n_levels (image) == 1))
     {
-      image = gsk_vulkan_render_pass_upload_texture (render, texture);
+      /* The mipmapped image replaces the cached one, so the
+       * mip levels are only generated once per texture.
+       */
+      if (image)
+        gdk_texture_clear_render_data (texture);
+      image = gsk_vulkan_render_pass_upload_texture (render, texture, mipmap);
       gsk_vulkan_renderer_add_texture_image (renderer, texture, image);
     }
 
@@ -568,7 +651,50 @@ gsk_vulkan_render_pass_add_outset_shadow_node (GskVulkanRenderPass       *self,
                                                GskRenderNode             *node)
 {
   if (gsk_outset_shadow_node_get_blur_radius (node) > 0)
-    FALLBACK ("Blur support not implemented for outset shadows");
+    {
+      GskShadowSlice slices[GSK_SHADOW_CACHE_MAX_SLICES];
+      GskVulkanRenderer *renderer;
+      GskProfiler *profiler;
+      GskVulkanImage *image;
+      GdkTexture *texture;
+      guint i, n_slices;
+
+      /* We have no blur that is fast enough for large radii, so we
+       * draw the shadow from a cached mask.
+       */
+      renderer = GSK_VULKAN_RENDERER (gsk_vulkan_render_get_renderer (render));
+#ifdef G_ENABLE_DEBUG
+      profiler = gsk_renderer_get_profiler (GSK_RENDERER (renderer));
+#else
+      profiler = NULL;
+#endif
+      texture = gsk_shadow_cache_lookup (node,
+                                         graphene_vec2_get_x (&state->scale),
+                                         graphene_vec2_get_y (&state->scale),
+                                         profiler,
+                                         slices, &n_slices);
+      image = gsk_vulkan_renderer_get_texture_image (renderer, texture);
+      if (image == NULL)
+        {
+          image = gsk_vulkan_render_pass_upload_texture (render, texture, FALSE);
+          gsk_vulkan_renderer_add_texture_image (renderer, texture, image);
+        }
+
+      for (i = 0; i < n_slices; i++)
+        {
+          gsk_vulkan_glyph_op (render,
+                               gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &slices[i].rect),
+                               image,
+                               &slices[i].rect,
+                               &state->offset,
+                               &slices[i].tex_rect,
+                               gsk_outset_shadow_node_get_color (node));
+        }
+
+      g_object_unref (texture);
+
+      return TRUE;
+    }
 
   gsk_vulkan_outset_shadow_op (render,
                                gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &node->bounds),
@@ -583,6 +709,27 @@ gsk_vulkan_render_pass_add_outset_shadow_node (GskVulkanRenderPass       *self,
   return TRUE;
 }
 
+/* The clip rect of an unclipped state is still the visible area, so
+ * use it to cull the children of transform nodes. Otherwise zoomed
+ * in canvases would draw everything outside the viewport, too.
+ */
+static gboolean
+gsk_vulkan_parse_state_get_visible_child_bounds (const GskVulkanParseState *state,
+                                                 GskTransform              *transform,
+                                                 const graphene_rect_t     *child_bounds,
+                                                 graphene_rect_t           *out_visible)
+{
+  graphene_rect_t clip;
+
+  if (!gsk_transform_untransform_bounds (transform, &state->clip.rect.bounds, &clip))
+    {
+      *out_visible = *child_bounds;
+      return TRUE;
+    }
+
+  return graphene_rect_intersection (child_bounds, &clip, out_visible);
+}
+
 static inline gboolean
 gsk_vulkan_render_pass_add_transform_node (GskVulkanRenderPass       *self,
                                            GskVulkanRender           *render,
@@ -634,7 +781,14 @@ gsk_vulkan_render_pass_add_transform_node (GskVulkanRenderPass       *self,
 
         if (gsk_vulkan_clip_contains_rect (&state->clip, &state->offset, &node->bounds))
           {
-            gsk_vulkan_clip_init_empty (&new_state.clip, &child->bounds);
+            graphene_rect_t visible;
+
+            if (!gsk_vulkan_parse_state_get_visible_child_bounds (state, clip_transform, &child->bounds, &visible))
+              {
+                gsk_transform_unref (clip_transform);
+                return TRUE;
+              }
+            gsk_vulkan_clip_init_empty (&new_state.clip, &visible);
           }
         else if (!gsk_vulkan_clip_transform (&new_state.clip, &state->clip, clip_transform, &child->bounds))
           {
@@ -679,7 +833,14 @@ gsk_vulkan_render_pass_add_transform_node (GskVulkanRenderPass       *self,
 
         if (gsk_vulkan_clip_contains_rect (&state->clip, &state->offset, &node->bounds))
           {
-            gsk_vulkan_clip_init_empty (&new_state.clip, &child->bounds);
+            graphene_rect_t visible;
+
+            if (!gsk_vulkan_parse_state_get_visible_child_bounds (state, clip_transform, &child->bounds, &visible))
+              {
+                gsk_transform_unref (clip_transform);
+                return TRUE;
+              }
+            gsk_vulkan_clip_init_empty (&new_state.clip, &visible);
           }
         else if (!gsk_vulkan_clip_transform (&new_state.clip, &state->clip, clip_transform, &child->bounds))
           {
@@ -869,14 +1030,33 @@ gsk_vulkan_render_pass_add_rounded_clip_node (GskVulkanRenderPass       *self,
                                               const GskVulkanParseState *state,
                                               GskRenderNode             *node)
 {
+  GskRenderNode *child = gsk_rounded_clip_node_get_child (node);
   GskVulkanParseState new_state;
   GskRoundedRect clip;
+  graphene_rect_t child_bounds;
 
   clip = *gsk_rounded_clip_node_get_clip (node);
   gsk_rounded_rect_offset (&clip, state->offset.x, state->offset.y);
+  graphene_rect_offset_r (&child->bounds, state->offset.x, state->offset.y, &child_bounds);
+
+  /* The child does not reach the rounded corners */
+  if (gsk_rounded_rect_contains_rect (&clip, &child_bounds))
+    {
+      gsk_vulkan_render_pass_add_node (self, render, state, child);
+      return TRUE;
+    }
 
   if (!gsk_vulkan_clip_intersect_rounded_rect (&new_state.clip, &state->clip, &clip))
-    FALLBACK ("Failed to find intersection between clip of type %u and rounded rectangle", state->clip.type);
+    {
+      /* The shaders can only evaluate one rounded rect, but if the
+       * old clip does not affect the child, the new one can replace it.
+       */
+      if (!gsk_vulkan_clip_contains_rect (&state->clip, graphene_point_zero (), &child_bounds))
+        FALLBACK ("Failed to find intersection between clip of type %u and rounded rectangle", state->clip.type);
+
+      new_state.clip.type = GSK_VULKAN_CLIP_ROUNDED;
+      new_state.clip.rect = clip;
+    }
 
   if (new_state.clip.type == GSK_VULKAN_CLIP_ALL_CLIPPED)
     return TRUE;
@@ -889,7 +1069,7 @@ gsk_vulkan_render_pass_add_rounded_clip_node (GskVulkanRenderPass       *self,
 
   gsk_vulkan_render_pass_append_push_constants (render, node, &new_state);
 
-  gsk_vulkan_render_pass_add_node (self, render, &new_state, gsk_rounded_clip_node_get_child (node));
+  gsk_vulkan_render_pass_add_node (self, render, &new_state, child);
 
   gsk_vulkan_render_pass_append_push_constants (render, node, state);
 
@@ -1053,6 +1233,8 @@ gsk_vulkan_render_pass_add_text_node (GskVulkanRenderPass       *self,
   GskVulkanGlyphCache *cache;
   const graphene_point_t *node_offset;
   const PangoFont *font;
+  GskVulkanShaderClip clip;
+  gboolean has_color_glyphs;
   guint num_glyphs;
   int x_position;
   int i;
@@ -1065,6 +1247,13 @@ gsk_vulkan_render_pass_add_text_node (GskVulkanRenderPass       *self,
 
   scale = MAX (graphene_vec2_get_x (&state->scale), graphene_vec2_get_y (&state->scale));
   node_offset = gsk_text_node_get_offset (node);
+  has_color_glyphs = gsk_text_node_has_color_glyphs (node);
+
+  /* Use the same clip for all glyphs, so they end up in the same
+   * pipeline and can be drawn together with the glyphs of the
+   * neighbouring text nodes.
+   */
+  clip = gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &node->bounds);
 
   x_position = 0;
   for (i = 0; i < num_glyphs; i++)
@@ -1090,9 +1279,9 @@ gsk_vulkan_render_pass_add_text_node (GskVulkanRenderPass       *self,
                           glyph_bounds.origin.y - glyph->draw_height * glyph->ty / glyph->th,
                           glyph->draw_width / glyph->tw,
                           glyph->draw_height / glyph->th);
-      if (gsk_text_node_has_color_glyphs (node))
+      if (has_color_glyphs)
         gsk_vulkan_texture_op (render,
-                               gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &glyph_bounds),
+                               clip,
                                glyph->atlas_image,
                                GSK_VULKAN_SAMPLER_DEFAULT,
                                &glyph_bounds,
@@ -1100,7 +1289,7 @@ gsk_vulkan_render_pass_add_text_node (GskVulkanRenderPass       *self,
                                &glyph_tex_rect);
       else
         gsk_vulkan_glyph_op (render,
-                             gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &glyph_bounds),
+                             clip,
                              glyph->atlas_image,
                              &glyph_bounds,
                              &state->offset,
@@ -1213,6 +1402,86 @@ gsk_vulkan_render_pass_add_mask_node (GskVulkanRenderPass       *self,
   return TRUE;
 }
 
+/* Fills and strokes only rasterize the coverage of the path with cairo
+ * and apply it to the child, which is drawn like any other node.
+ */
+static inline gboolean
+gsk_vulkan_render_pass_add_path_node (GskVulkanRenderPass       *self,
+                                      GskVulkanRender           *render,
+                                      const GskVulkanParseState *state,
+                                      GskRenderNode             *node,
+                                      GskRenderNode             *child)
+{
+  GskVulkanImage *source_image, *mask_image;
+  graphene_rect_t source_tex_rect, clipped;
+  GskRenderNode *mask;
+
+  graphene_rect_offset_r (&state->clip.rect.bounds, - state->offset.x, - state->offset.y, &clipped);
+  graphene_rect_intersection (&clipped, &node->bounds, &clipped);
+
+  if (clipped.size.width == 0 || clipped.size.height == 0)
+    return TRUE;
+
+  mask = gsk_render_node_create_path_mask (node);
+  mask_image = gsk_vulkan_upload_cairo_op (render,
+                                           mask,
+                                           &state->scale,
+                                           &clipped);
+  gsk_render_node_unref (mask);
+
+  /* Use the glyph shader as an optimization */
+  if (gsk_render_node_get_node_type (child) == GSK_COLOR_NODE &&
+      gsk_rect_contains_rect (&child->bounds, &node->bounds))
+    {
+      gsk_vulkan_glyph_op (render,
+                           gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &clipped),
+                           mask_image,
+                           &clipped,
+                           &state->offset,
+                           &clipped,
+                           gsk_color_node_get_color (child));
+      return TRUE;
+    }
+
+  source_image = gsk_vulkan_render_pass_get_node_as_image (self,
+                                                           render,
+                                                           state,
+                                                           child,
+                                                           &source_tex_rect);
+  if (source_image == NULL)
+    return TRUE;
+
+  gsk_vulkan_mask_op (render,
+                      gsk_vulkan_clip_get_shader_clip (&state->clip, &state->offset, &clipped),
+                      &state->offset,
+                      source_image,
+                      &child->bounds,
+                      &source_tex_rect,
+                      mask_image,
+                      &clipped,
+                      &clipped,
+                      GSK_MASK_MODE_ALPHA);
+  return TRUE;
+}
+
+static inline gboolean
+gsk_vulkan_render_pass_add_fill_node (GskVulkanRenderPass       *self,
+                                      GskVulkanRender           *render,
+                                      const GskVulkanParseState *state,
+                                      GskRenderNode             *node)
+{
+  return gsk_vulkan_render_pass_add_path_node (self, render, state, node, gsk_fill_node_get_child (node));
+}
+
+static inline gboolean
+gsk_vulkan_render_pass_add_stroke_node (GskVulkanRenderPass       *self,
+                                        GskVulkanRender           *render,
+                                        const GskVulkanParseState *state,
+                                        GskRenderNode             *node)
+{
+  return gsk_vulkan_render_pass_add_path_node (self, render, state, node, gsk_stroke_node_get_child (node));
+}
+
 static inline gboolean
 gsk_vulkan_render_pass_add_debug_node (GskVulkanRenderPass       *self,
                                        GskVulkanRender           *render,
@@ -1238,9 +1507,9 @@ static const GskVulkanRenderPassNodeFunc nodes_vtable[] = {
   [GSK_COLOR_NODE] = gsk_vulkan_render_pass_add_color_node,
   [GSK_LINEAR_GRADIENT_NODE] = gsk_vulkan_render_pass_add_linear_gradient_node,
   [GSK_REPEATING_LINEAR_GRADIENT_NODE] = gsk_vulkan_render_pass_add_linear_gradient_node,
-  [GSK_RADIAL_GRADIENT_NODE] = NULL,
-  [GSK_REPEATING_RADIAL_GRADIENT_NODE] = NULL,
-  [GSK_CONIC_GRADIENT_NODE] = NULL,
+  [GSK_RADIAL_GRADIENT_NODE] = gsk_vulkan_render_pass_add_radial_gradient_node,
+  [GSK_REPEATING_RADIAL_GRADIENT_NODE] = gsk_vulkan_render_pass_add_radial_gradient_node,
+  [GSK_CONIC_GRADIENT_NODE] = gsk_vulkan_render_pass_add_conic_gradient_node,
   [GSK_BORDER_NODE] = gsk_vulkan_render_pass_add_border_node,
   [GSK_TEXTURE_NODE] = gsk_vulkan_render_pass_add_texture_node,
   [GSK_INSET_SHADOW_NODE] = gsk_vulkan_render_pass_add_inset_shadow_node,
@@ -1260,8 +1529,8 @@ static const GskVulkanRenderPassNodeFunc nodes_vtable[] = {
   [GSK_GL_SHADER_NODE] = NULL,
   [GSK_TEXTURE_SCALE_NODE] = gsk_vulkan_render_pass_add_texture_scale_node,
   [GSK_MASK_NODE] = gsk_vulkan_render_pass_add_mask_node,
-  [GSK_FILL_NODE] = NULL,
-  [GSK_STROKE_NODE] = NULL,
+  [GSK_FILL_NODE] = gsk_vulkan_render_pass_add_fill_node,
+  [GSK_STROKE_NODE] = gsk_vulkan_render_pass_add_stroke_node,
 };
 
 static void
@@ -1314,7 +1583,6 @@ gsk_vulkan_render_pass_add (GskVulkanRenderPass   *self,
   GskVulkanParseState state;
 
   state.scissor = *clip;
-  gsk_vulkan_clip_init_empty (&state.clip, &GRAPHENE_RECT_INIT (0, 0, viewport->size.width, viewport->size.height));
 
   state.modelview = NULL;
   graphene_matrix_init_ortho (&state.projection,
@@ -1324,6 +1592,12 @@ gsk_vulkan_render_pass_add (GskVulkanRenderPass   *self,
                               ORTHO_FAR_PLANE);
   graphene_vec2_init (&state.scale, width / viewport->size.width,
                                     height / viewport->size.height);
+  /* Limit the clip to the scissor, so nodes outside of it get culled */
+  gsk_vulkan_clip_init_empty (&state.clip,
+                              &GRAPHENE_RECT_INIT (clip->x / graphene_vec2_get_x (&state.scale),
+                                                   clip->y / graphene_vec2_get_y (&state.scale),
+                                                   clip->width / graphene_vec2_get_x (&state.scale),
+                                                   clip->height / graphene_vec2_get_y (&state.scale)));
   state.offset = GRAPHENE_POINT_INIT (-viewport->origin.x,
                                       -viewport->origin.y);
 
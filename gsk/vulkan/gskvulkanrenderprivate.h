@@ -13,7 +13,8 @@ G_BEGIN_DECLS
 typedef enum {
   GSK_VULKAN_SAMPLER_DEFAULT,
   GSK_VULKAN_SAMPLER_REPEAT,
-  GSK_VULKAN_SAMPLER_NEAREST
+  GSK_VULKAN_SAMPLER_NEAREST,
+  GSK_VULKAN_SAMPLER_MIPMAP
 } GskVulkanRenderSampler;
 
 typedef void            (* GskVulkanDownloadFunc)                       (gpointer                user_data,
@@ -35,6 +36,13 @@ void                    gsk_vulkan_render_render                        (GskVulk
                                                                          GskRenderNode          *node,
                                                                          GskVulkanDownloadFunc   download_func,
                                                                          gpointer                download_data);
+void                    gsk_vulkan_render_render_batch                  (GskVulkanRender        *self,
+                                                                         GskVulkanImage        **targets,
+                                                                         const graphene_rect_t  *rects,
+                                                                         GskRenderNode         **nodes,
+                                                                         gsize                   n_nodes,
+                                                                         GskVulkanDownloadFunc   download_func,
+                                                                         gpointer               *download_data);
 
 GskRenderer *           gsk_vulkan_render_get_renderer                  (GskVulkanRender        *self);
 GdkVulkanContext *      gsk_vulkan_render_get_context                   (GskVulkanRender        *self);
@@ -47,6 +55,9 @@ VkPipeline              gsk_vulkan_render_get_pipeline                  (GskVulk
                                                                          const GskVulkanOpClass *op_class,
                                                                          GskVulkanShaderClip     clip,
                                                                          VkRenderPass            render_pass);
+void                    gsk_vulkan_render_bind_pipeline                 (GskVulkanRender        *self,
+                                                                         VkCommandBuffer         command_buffer,
+                                                                         VkPipeline              pipeline);
 VkRenderPass            gsk_vulkan_render_get_render_pass               (GskVulkanRender        *self,
                                                                          VkFormat                format,
                                                                          VkImageLayout           from_layout,
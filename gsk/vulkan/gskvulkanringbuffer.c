@@ -0,0 +1,217 @@
+#include "config.h"
+
+#include "gskvulkanringbufferprivate.h"
+
+#include "gskvulkanprivate.h"
+
+/* A persistently mapped buffer that vertex and storage data for
+ * renders gets sub-allocated from, so we don't need to allocate and
+ * map buffers for every frame.
+ *
+ * Allocations are grouped into frames. Once the GPU is done with a
+ * frame - ie its render's fence is signaled - the render releases it.
+ * Frames are reused in the order they were allocated, so releasing a
+ * frame while an older one is still in flight only marks it.
+ */
+
+typedef struct _GskVulkanRingFrame GskVulkanRingFrame;
+
+struct _GskVulkanRingFrame
+{
+  guint64 serial;
+  gsize end;
+  gboolean released;
+};
+
+struct _GskVulkanRingBuffer
+{
+  GskVulkanBuffer *buffer;
+  guchar *data;
+  gsize size;
+  gsize storage_alignment;
+
+  /* where the next allocation goes */
+  gsize head;
+  /* where the oldest frame still in use starts */
+  gsize tail;
+
+  /* GskVulkanRingFrame, oldest first */
+  GQueue frames;
+  guint64 last_serial;
+  gboolean frame_started;
+};
+
+GskVulkanRingBuffer *
+gsk_vulkan_ring_buffer_new (GdkVulkanContext *context,
+                            gsize             size)
+{
+  GskVulkanRingBuffer *self;
+  VkPhysicalDeviceProperties properties;
+
+  self = g_new0 (GskVulkanRingBuffer, 1);
+
+  self->size = size;
+  self->buffer = gsk_vulkan_buffer_new_ring (context, size);
+  self->data = gsk_vulkan_buffer_map (self->buffer);
+
+  vkGetPhysicalDeviceProperties (gdk_vulkan_context_get_physical_device (context),
+                                 &properties);
+  self->storage_alignment = MAX (properties.limits.minStorageBufferOffsetAlignment, sizeof (float));
+
+  g_queue_init (&self->frames);
+
+  return self;
+}
+
+void
+gsk_vulkan_ring_buffer_free (GskVulkanRingBuffer *self)
+{
+  g_warn_if_fail (g_queue_is_empty (&self->frames));
+
+  g_queue_clear_full (&self->frames, g_free);
+
+  gsk_vulkan_buffer_unmap (self->buffer);
+  gsk_vulkan_buffer_free (self->buffer);
+
+  g_free (self);
+}
+
+VkBuffer
+gsk_vulkan_ring_buffer_get_buffer (GskVulkanRingBuffer *self)
+{
+  return gsk_vulkan_buffer_get_buffer (self->buffer);
+}
+
+gsize
+gsk_vulkan_ring_buffer_get_storage_alignment (GskVulkanRingBuffer *self)
+{
+  return self->storage_alignment;
+}
+
+static inline gsize
+round_up (gsize number, gsize divisor)
+{
+  return (number + divisor - 1) / divisor * divisor;
+}
+
+/*<private>
+ * gsk_vulkan_ring_buffer_alloc:
+ * @self: a ring buffer
+ * @size: the number of bytes to allocate
+ * @alignment: the alignment of the allocation
+ * @out_offset: (out): the offset of the allocation in the buffer
+ *
+ * Allocates memory for the current frame.
+ *
+ * Returns: (nullable): a pointer to the allocated memory, or %NULL
+ *   if the buffer does not have room for it
+ */
+guchar *
+gsk_vulkan_ring_buffer_alloc (GskVulkanRingBuffer *self,
+                              gsize                size,
+                              gsize                alignment,
+                              gsize               *out_offset)
+{
+  gsize offset;
+
+  if (g_queue_is_empty (&self->frames) && !self->frame_started)
+    {
+      self->head = 0;
+      self->tail = 0;
+    }
+  else if (self->head == self->tail)
+    {
+      /* full */
+      return NULL;
+    }
+
+  offset = round_up (self->head, alignment);
+
+  if (self->head >= self->tail)
+    {
+      /* free space is from head to the end and from the start to tail */
+      if (offset + size > self->size)
+        {
+          if (self->tail == 0 || size > self->tail)
+            return NULL;
+
+          offset = 0;
+        }
+    }
+  else
+    {
+      /* free space is from head to tail */
+      if (offset + size > self->tail)
+        return NULL;
+    }
+
+  self->head = offset + size;
+  self->frame_started = TRUE;
+
+  *out_offset = offset;
+
+  return self->data + offset;
+}
+
+/*<private>
+ * gsk_vulkan_ring_buffer_end_frame:
+ * @self: a ring buffer
+ *
+ * Ends the current frame. All allocations since the last call
+ * stay valid until the returned frame is released.
+ *
+ * Returns: the frame to pass to gsk_vulkan_ring_buffer_release_frame(),
+ *   or 0 if nothing was allocated
+ */
+guint64
+gsk_vulkan_ring_buffer_end_frame (GskVulkanRingBuffer *self)
+{
+  GskVulkanRingFrame *frame;
+
+  if (!self->frame_started)
+    return 0;
+
+  frame = g_new (GskVulkanRingFrame, 1);
+  frame->serial = ++self->last_serial;
+  frame->end = self->head;
+  frame->released = FALSE;
+  g_queue_push_tail (&self->frames, frame);
+
+  self->frame_started = FALSE;
+
+  return frame->serial;
+}
+
+/*<private>
+ * gsk_vulkan_ring_buffer_release_frame:
+ * @self: a ring buffer
+ * @frame: a frame returned by gsk_vulkan_ring_buffer_end_frame()
+ *
+ * Marks the memory of @frame as no longer used by the GPU.
+ */
+void
+gsk_vulkan_ring_buffer_release_frame (GskVulkanRingBuffer *self,
+                                      guint64              frame)
+{
+  GskVulkanRingFrame *f;
+  GList *l;
+
+  if (frame == 0)
+    return;
+
+  for (l = self->frames.head; l; l = l->next)
+    {
+      f = l->data;
+      if (f->serial == frame)
+        {
+          f->released = TRUE;
+          break;
+        }
+    }
+
+  while ((f = g_queue_peek_head (&self->frames)) && f->released)
+    {
+      self->tail = f->end;
+      g_free (g_queue_pop_head (&self->frames));
+    }
+}
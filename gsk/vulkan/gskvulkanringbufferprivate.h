@@ -0,0 +1,25 @@
+#pragma once
+
+#include "gskvulkanbufferprivate.h"
+
+G_BEGIN_DECLS
+
+typedef struct _GskVulkanRingBuffer GskVulkanRingBuffer;
+
+GskVulkanRingBuffer *   gsk_vulkan_ring_buffer_new                      (GdkVulkanContext       *context,
+                                                                         gsize                   size);
+void                    gsk_vulkan_ring_buffer_free                     (GskVulkanRingBuffer    *self);
+
+VkBuffer                gsk_vulkan_ring_buffer_get_buffer               (GskVulkanRingBuffer    *self);
+gsize                   gsk_vulkan_ring_buffer_get_storage_alignment    (GskVulkanRingBuffer    *self);
+
+guchar *                gsk_vulkan_ring_buffer_alloc                    (GskVulkanRingBuffer    *self,
+                                                                         gsize                   size,
+                                                                         gsize                   alignment,
+                                                                         gsize                  *out_offset);
+guint64                 gsk_vulkan_ring_buffer_end_frame                (GskVulkanRingBuffer    *self);
+void                    gsk_vulkan_ring_buffer_release_frame            (GskVulkanRingBuffer    *self,
+                                                                         guint64                 frame);
+
+G_END_DECLS
+
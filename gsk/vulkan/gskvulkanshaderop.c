@@ -52,19 +52,21 @@ gsk_vulkan_shader_op_command_n (GskVulkanOp      *op,
     {
       GskVulkanShaderOp *next_shader = (GskVulkanShaderOp *) next;
   
+      /* The clip selects the pipeline, so it must match, too */
       if (next->op_class != op->op_class ||
+          next_shader->clip != self->clip ||
           next_shader->vertex_offset != self->vertex_offset + i * stride)
         break;
 
       i++;
     }
 
-  vkCmdBindPipeline (command_buffer,
-                     VK_PIPELINE_BIND_POINT_GRAPHICS,
-                     gsk_vulkan_render_get_pipeline (render,
-                                                     op->op_class,
-                                                     self->clip,
-                                                     render_pass));
+  gsk_vulkan_render_bind_pipeline (render,
+                                   command_buffer,
+                                   gsk_vulkan_render_get_pipeline (render,
+                                                                   op->op_class,
+                                                                   self->clip,
+                                                                   render_pass));
 
   vkCmdDraw (command_buffer,
              6 * instance_scale, i,
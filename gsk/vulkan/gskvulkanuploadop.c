@@ -3,9 +3,12 @@
 #include "gskvulkanuploadopprivate.h"
 
 #include "gskvulkanprivate.h"
+#include "gskglyphtileprivate.h"
 
 #include "gdk/gdkmemoryformatprivate.h"
 
+#include <string.h>
+
 static gsize
 gsk_vulkan_upload_op_count_vertex_data (GskVulkanOp *op,
                                         gsize        n_bytes)
@@ -47,22 +50,10 @@ gsk_vulkan_upload_op_command_with_area (GskVulkanOp                 *op,
 
   gsk_vulkan_buffer_unmap (*buffer);
 
-  vkCmdPipelineBarrier (command_buffer,
-                        VK_PIPELINE_STAGE_HOST_BIT,
-                        VK_PIPELINE_STAGE_TRANSFER_BIT,
-                        0,
-                        0, NULL,
-                        1, &(VkBufferMemoryBarrier) {
-                            .sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER,
-                            .srcAccessMask = VK_ACCESS_HOST_WRITE_BIT,
-                            .dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT,
-                            .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                            .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
-                            .buffer = gsk_vulkan_buffer_get_buffer (*buffer),
-                            .offset = 0,
-                            .size = VK_WHOLE_SIZE,
-                        },
-                        0, NULL);
+  /* No barrier is needed for the host writes. Submitting the command
+   * buffer makes them available to the device, and the staging buffer
+   * is host coherent.
+   */
   gsk_vulkan_image_transition (image, 
                                command_buffer,
                                VK_PIPELINE_STAGE_TRANSFER_BIT,
@@ -192,13 +183,19 @@ gsk_vulkan_upload_texture_op_command (GskVulkanOp      *op,
                                       VkCommandBuffer   command_buffer)
 {
   GskVulkanUploadTextureOp *self = (GskVulkanUploadTextureOp *) op;
+  GskVulkanOp *next;
 
-  return gsk_vulkan_upload_op_command (op,
+  next = gsk_vulkan_upload_op_command (op,
                                        render,
                                        command_buffer,
                                        self->image,
                                        gsk_vulkan_upload_texture_op_draw,
                                        &self->buffer);
+
+  if (gsk_vulkan_image_get_n_levels (self->image) > 1)
+    gsk_vulkan_image_generate_mipmaps (self->image, command_buffer);
+
+  return next;
 }
 
 static const GskVulkanOpClass GSK_VULKAN_UPLOAD_TEXTURE_OP_CLASS = {
@@ -214,17 +211,24 @@ static const GskVulkanOpClass GSK_VULKAN_UPLOAD_TEXTURE_OP_CLASS = {
 
 GskVulkanImage *
 gsk_vulkan_upload_texture_op (GskVulkanRender  *render,
-                              GdkTexture       *texture)
+                              GdkTexture       *texture,
+                              gboolean          mipmap)
 {
   GskVulkanUploadTextureOp *self;
 
   self = (GskVulkanUploadTextureOp *) gsk_vulkan_op_alloc (render, &GSK_VULKAN_UPLOAD_TEXTURE_OP_CLASS);
 
   self->texture = g_object_ref (texture);
-  self->image = gsk_vulkan_image_new_for_upload (gsk_vulkan_render_get_context (render),
-                                                 gdk_texture_get_format (texture),
-                                                 gdk_texture_get_width (texture),
-                                                 gdk_texture_get_height (texture));
+  if (mipmap)
+    self->image = gsk_vulkan_image_new_for_upload_mipmap (gsk_vulkan_render_get_context (render),
+                                                          gdk_texture_get_format (texture),
+                                                          gdk_texture_get_width (texture),
+                                                          gdk_texture_get_height (texture));
+  else
+    self->image = gsk_vulkan_image_new_for_upload (gsk_vulkan_render_get_context (render),
+                                                   gdk_texture_get_format (texture),
+                                                   gdk_texture_get_width (texture),
+                                                   gdk_texture_get_height (texture));
 
   return self->image;
 }
@@ -394,40 +398,22 @@ gsk_vulkan_upload_glyph_op_draw (GskVulkanOp *op,
                                  gsize        stride)
 {
   GskVulkanUploadGlyphOp *self = (GskVulkanUploadGlyphOp *) op;
-  cairo_surface_t *surface;
-  cairo_t *cr;
-
-  surface = cairo_image_surface_create_for_data (data,
-                                                 CAIRO_FORMAT_ARGB32,
-                                                 self->area.width,
-                                                 self->area.height,
-                                                 stride);
-  cairo_surface_set_device_scale (surface, self->scale, self->scale);
-
-  cr = cairo_create (surface);
-  cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
-  cairo_paint (cr);
-  cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
-
-  /* Make sure the entire surface is initialized to black */
-  cairo_set_source_rgba (cr, 0, 0, 0, 0);
-  cairo_rectangle (cr, 0.0, 0.0, self->area.width, self->area.height);
-  cairo_fill (cr);
-
-  /* Draw glyph */
-  cairo_set_source_rgba (cr, 1, 1, 1, 1);
-
-  pango_cairo_show_glyph_string (cr,
-                                 self->font,
-                                 &(PangoGlyphString) {
-                                   .num_glyphs = 1,
-                                   .glyphs = &self->glyph_info
-                                 });
-
-  cairo_destroy (cr);
-
-  cairo_surface_finish (surface);
-  cairo_surface_destroy (surface);
+  GskGlyphTile *tile;
+  gsize row_size;
+  int y;
+
+  tile = gsk_glyph_tile_lookup (self->font,
+                                &self->glyph_info,
+                                self->area.width,
+                                self->area.height,
+                                self->scale,
+                                self->scale);
+
+  row_size = self->area.width * 4;
+  for (y = 0; y < self->area.height; y++)
+    memcpy (data + y * stride, tile->data + y * tile->stride, row_size);
+
+  gsk_glyph_tile_unref (tile);
 }
 
 static GskVulkanOp *
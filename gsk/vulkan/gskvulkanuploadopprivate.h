@@ -5,7 +5,8 @@
 G_BEGIN_DECLS
 
 GskVulkanImage *        gsk_vulkan_upload_texture_op                    (GskVulkanRender                *render,
-                                                                         GdkTexture                     *texture);
+                                                                         GdkTexture                     *texture,
+                                                                         gboolean                        mipmap);
 
 GskVulkanImage *        gsk_vulkan_upload_cairo_op                      (GskVulkanRender                *render,
                                                                          GskRenderNode                  *node,
@@ -0,0 +1,31 @@
+#version 450
+
+#include "common.frag.glsl"
+#include "clip.frag.glsl"
+#include "gradient.frag.glsl"
+#include "rect.frag.glsl"
+
+#define PI 3.1415926535897932384626433832795
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in flat Rect inRect;
+layout(location = 2) in vec2 inGradientCoord;
+layout(location = 3) in flat float inAngle;
+layout(location = 4) in flat int inStopOffset;
+layout(location = 5) in flat int inStopCount;
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+  /* atan() is in [-PI, PI], fract() makes the progress start at inAngle */
+  float pos = fract ((atan (inGradientCoord.y, inGradientCoord.x) + inAngle) / (2 * PI) + 2);
+  /* fwidth (pos) jumps where pos wraps around, so use the distance
+   * to the center: a pixel covers 1 / radius of the circle there.
+   */
+  float dPos = 0.5 * length (fwidth (inGradientCoord)) / (2 * PI * max (length (inGradientCoord), 0.5));
+  vec4 c = gradient_get_color_for_pos (inStopOffset, inStopCount, pos, dPos, true);
+
+  float alpha = c.a * rect_coverage (inRect, inPos);
+  color = clip_scaled (inPos, vec4(c.rgb, 1) * alpha);
+}
@@ -0,0 +1,28 @@
+#version 450
+
+#include "common.vert.glsl"
+#include "rect.vert.glsl"
+
+layout(location = 0) in vec4 inRect;
+layout(location = 1) in vec2 inCenter;
+layout(location = 2) in float inAngle;
+layout(location = 3) in int inStopOffset;
+layout(location = 4) in int inStopCount;
+
+layout(location = 0) out vec2 outPos;
+layout(location = 1) out flat Rect outRect;
+layout(location = 2) out vec2 outGradientCoord;
+layout(location = 3) out flat float outAngle;
+layout(location = 4) out flat int outStopOffset;
+layout(location = 5) out flat int outStopCount;
+
+void main() {
+  Rect r = rect_from_gsk (inRect);
+  vec2 pos = set_position_from_rect (r);
+  outPos = pos;
+  outRect = r;
+  outGradientCoord = pos - inCenter * push.scale;
+  outAngle = inAngle;
+  outStopOffset = inStopOffset;
+  outStopCount = inStopCount;
+}
@@ -0,0 +1,135 @@
+#ifndef _GRADIENT_FRAG_
+#define _GRADIENT_FRAG_
+
+/* Color stops are stored as 5 floats in the storage buffer:
+ * offset, red, green, blue, alpha.
+ */
+
+float
+gradient_get_offset (int stops,
+                     int i)
+{
+  return get_float (stops + i * 5);
+}
+
+vec4
+gradient_get_color (int stops,
+                    int n_stops,
+                    int i)
+{
+  i = clamp (i, 0, n_stops - 1);
+  return vec4 (get_float (stops + i * 5 + 1),
+               get_float (stops + i * 5 + 2),
+               get_float (stops + i * 5 + 3),
+               get_float (stops + i * 5 + 4));
+}
+
+vec4
+gradient_get_color_for_range_unscaled (int   stops,
+                                       int   n_stops,
+                                       float start,
+                                       float end)
+{
+  vec4 result = vec4 (0);
+  float offset;
+  int i;
+
+  for (i = 0; i < n_stops; i++)
+    {
+      offset = gradient_get_offset (stops, i);
+      if (offset >= start)
+        break;
+    }
+  if (i == n_stops)
+    offset = 1;
+
+  float last_offset = i > 0 ? gradient_get_offset (stops, i - 1) : 0;
+  vec4 last_color = gradient_get_color (stops, n_stops, i - 1);
+  vec4 color = gradient_get_color (stops, n_stops, i);
+  if (last_offset < start)
+    {
+      last_color = mix (last_color, color, (start - last_offset) / (offset - last_offset));
+      last_offset = start;
+    }
+  if (end <= start)
+    return last_color;
+
+  for (; i < n_stops; i++)
+    {
+      offset = gradient_get_offset (stops, i);
+      color = gradient_get_color (stops, n_stops, i);
+      if (offset >= end)
+        break;
+      result += 0.5 * (color + last_color) * (offset - last_offset);
+      last_offset = offset;
+      last_color = color;
+    }
+  if (i == n_stops)
+    {
+      offset = 1;
+      color = gradient_get_color (stops, n_stops, i);
+    }
+  if (offset > end)
+    {
+      color = mix (last_color, color, (end - last_offset) / (offset - last_offset));
+      offset = end;
+    }
+  result += 0.5 * (color + last_color) * (offset - last_offset);
+
+  return result;
+}
+
+vec4
+gradient_get_color_for_range (int   stops,
+                              int   n_stops,
+                              float start,
+                              float end)
+{
+  return gradient_get_color_for_range_unscaled (stops, n_stops, start, end) / (end - start);
+}
+
+/* Averages the gradient over [pos - dpos, pos + dpos], which is
+ * the part of it that the current pixel covers.
+ */
+vec4
+gradient_get_color_for_pos (int   stops,
+                            int   n_stops,
+                            float pos,
+                            float dpos,
+                            bool  repeating)
+{
+  vec4 c;
+  float pos_start, pos_end;
+
+  if (repeating)
+    {
+      pos_start = pos - dpos;
+      pos_end = pos + dpos;
+      if (floor (pos_end) > floor (pos_start))
+        {
+          float fract_end = fract(pos_end);
+          float fract_start = fract(pos_start);
+          float n = floor (pos_end) - floor (pos_start);
+          if (fract_end > fract_start + 0.01)
+            c = gradient_get_color_for_range_unscaled (stops, n_stops, fract_start, fract_end);
+          else if (fract_start > fract_end + 0.01)
+            c = -gradient_get_color_for_range_unscaled (stops, n_stops, fract_end, fract_start);
+          c += gradient_get_color_for_range_unscaled (stops, n_stops, 0.0, 1.0) * n;
+          c /= pos_end - pos_start;
+        }
+      else
+        {
+          c = gradient_get_color_for_range (stops, n_stops, fract (pos_start), fract (pos_end));
+        }
+    }
+  else
+    {
+      pos_start = clamp (pos - dpos, 0, 1);
+      pos_end = clamp (pos + dpos, 0, 1);
+      c = gradient_get_color_for_range (stops, n_stops, pos_start, pos_end);
+    }
+
+  return c;
+}
+
+#endif
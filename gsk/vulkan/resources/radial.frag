@@ -0,0 +1,26 @@
+#version 450
+
+#include "common.frag.glsl"
+#include "clip.frag.glsl"
+#include "gradient.frag.glsl"
+#include "rect.frag.glsl"
+
+layout(location = 0) in vec2 inPos;
+layout(location = 1) in flat Rect inRect;
+layout(location = 2) in vec2 inGradientCoord;
+layout(location = 3) in flat vec2 inRange;
+layout(location = 4) in flat int inRepeating;
+layout(location = 5) in flat int inStopOffset;
+layout(location = 6) in flat int inStopCount;
+
+layout(location = 0) out vec4 color;
+
+void main()
+{
+  float pos = length (inGradientCoord) * inRange.x + inRange.y;
+  float dPos = 0.5 * abs (fwidth (pos));
+  vec4 c = gradient_get_color_for_pos (inStopOffset, inStopCount, pos, dPos, inRepeating != 0);
+
+  float alpha = c.a * rect_coverage (inRect, inPos);
+  color = clip_scaled (inPos, vec4(c.rgb, 1) * alpha);
+}
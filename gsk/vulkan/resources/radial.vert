@@ -0,0 +1,33 @@
+#version 450
+
+#include "common.vert.glsl"
+#include "rect.vert.glsl"
+
+layout(location = 0) in vec4 inRect;
+layout(location = 1) in vec2 inCenter;
+layout(location = 2) in vec2 inRadius;
+layout(location = 3) in vec2 inRange;
+layout(location = 4) in int inRepeating;
+layout(location = 5) in int inStopOffset;
+layout(location = 6) in int inStopCount;
+
+layout(location = 0) out vec2 outPos;
+layout(location = 1) out flat Rect outRect;
+layout(location = 2) out vec2 outGradientCoord;
+layout(location = 3) out flat vec2 outRange;
+layout(location = 4) out flat int outRepeating;
+layout(location = 5) out flat int outStopOffset;
+layout(location = 6) out flat int outStopCount;
+
+void main() {
+  Rect r = rect_from_gsk (inRect);
+  vec2 pos = set_position_from_rect (r);
+  outPos = pos;
+  outRect = r;
+  /* This is linear in pos, so it can be interpolated */
+  outGradientCoord = (pos - inCenter * push.scale) / (inRadius * push.scale);
+  outRange = inRange;
+  outRepeating = inRepeating;
+  outStopOffset = inStopOffset;
+  outStopCount = inStopCount;
+}
@@ -62,6 +62,12 @@ struct _GtkAtSpiCache
   /* HashTable<GtkAtSpiContext, str> */
   GHashTable *contexts_to_path;
 
+  /* HashSet<GtkAtSpiContext>, contexts that were added since
+   * the last AddAccessible emission
+   */
+  GHashTable *pending_additions;
+  guint pending_additions_id;
+
   /* Re-entrancy guard */
   gboolean in_get_items;
 
@@ -85,6 +91,8 @@ gtk_at_spi_cache_finalize (GObject *gobject)
 {
   GtkAtSpiCache *self = GTK_AT_SPI_CACHE (gobject);
 
+  g_clear_handle_id (&self->pending_additions_id, g_source_remove);
+  g_clear_pointer (&self->pending_additions, g_hash_table_unref);
   g_clear_pointer (&self->contexts_to_path, g_hash_table_unref);
   g_clear_pointer (&self->contexts_by_path, g_hash_table_unref);
   g_clear_object (&self->connection);
@@ -271,6 +279,31 @@ emit_remove_accessible (GtkAtSpiCache   *self,
                                  NULL);
 }
 
+static gboolean
+emit_pending_additions (gpointer data)
+{
+  GtkAtSpiCache *self = data;
+  GHashTable *additions;
+  GHashTableIter iter;
+  gpointer key_p;
+
+  self->pending_additions_id = 0;
+
+  /* Serializing the contexts might add new ones, which will
+   * be emitted on the next run
+   */
+  additions = g_steal_pointer (&self->pending_additions);
+  self->pending_additions = g_hash_table_new (NULL, NULL);
+
+  g_hash_table_iter_init (&iter, additions);
+  while (g_hash_table_iter_next (&iter, &key_p, NULL))
+    emit_add_accessible (self, key_p);
+
+  g_hash_table_unref (additions);
+
+  return G_SOURCE_REMOVE;
+}
+
 static void
 handle_cache_method (GDBusConnection       *connection,
                      const gchar           *sender,
@@ -304,6 +337,10 @@ handle_cache_method (GDBusConnection       *connection,
 
       self->in_get_items = FALSE;
 
+      /* The reply contains everything that was waiting to be added */
+      g_hash_table_remove_all (self->pending_additions);
+      g_clear_handle_id (&self->pending_additions_id, g_source_remove);
+
       GTK_DEBUG (A11Y, "Returning %lu items", g_variant_n_children (items));
 
       g_dbus_method_invocation_return_value (invocation, items);
@@ -388,6 +425,7 @@ gtk_at_spi_cache_init (GtkAtSpiCache *self)
                                                   g_free,
                                                   NULL);
   self->contexts_to_path = g_hash_table_new (NULL, NULL);
+  self->pending_additions = g_hash_table_new (NULL, NULL);
 }
 
 GtkAtSpiCache *
@@ -432,8 +470,23 @@ gtk_at_spi_cache_add_context (GtkAtSpiCache   *self,
   /* GetItems is safe from re-entrancy, but we still don't want to
    * emit an unnecessary signal while we're collecting ATContexts
    */
-  if (!self->in_get_items)
-    emit_add_accessible (self, context);
+  if (self->in_get_items)
+    return;
+
+  /* Realizing a subtree adds many contexts at once, and they often
+   * go away again right after, e.g. for recycled list rows. So we
+   * wait until the frame is done, and skip the ones that are gone
+   */
+  g_hash_table_add (self->pending_additions, context);
+
+  if (self->pending_additions_id == 0)
+    {
+      self->pending_additions_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10,
+                                                    emit_pending_additions,
+                                                    self,
+                                                    NULL);
+      gdk_source_set_static_name_by_id (self->pending_additions_id, "[gtk] emit_pending_additions");
+    }
 }
 
 void
@@ -450,7 +503,9 @@ gtk_at_spi_cache_remove_context (GtkAtSpiCache   *self,
   if (!g_hash_table_contains (self->contexts_by_path, path))
     return;
 
-  emit_remove_accessible (self, context);
+  /* If the AT never heard of the context, there's nothing to remove */
+  if (!g_hash_table_remove (self->pending_additions, context))
+    emit_remove_accessible (self, context);
 
   /* The order is important: the value in contexts_by_path is the
    * key in contexts_to_path
@@ -111,8 +111,21 @@ struct _GtkAtSpiContext
 
   guint registration_ids[20];
   guint n_registered_objects;
+
+  /* StateChanged and PropertyChange events are coalesced, and
+   * emitted once per frame; see queue_object_event()
+   */
+  GArray *pending_events;
+  guint pending_events_id;
 };
 
+typedef struct {
+  const char *member;
+  const char *name;
+  int detail;
+  GVariant *value;
+} PendingEvent;
+
 G_DEFINE_TYPE (GtkAtSpiContext, gtk_at_spi_context, GTK_TYPE_AT_CONTEXT)
 
 /* {{{ State handling */
@@ -538,6 +551,31 @@ handle_accessible_method (GDBusConnection       *connection,
                                  "placeholder-text", gtk_string_accessible_value_get (value));
         }
 
+      /* Lists only have widgets for the visible items, so ATs can't
+       * count the children to find out where an item is
+       */
+      if (gtk_at_context_has_accessible_relation (GTK_AT_CONTEXT (self), GTK_ACCESSIBLE_RELATION_POS_IN_SET))
+        {
+          GtkAccessibleValue *value;
+          char *str;
+
+          value = gtk_at_context_get_accessible_relation (GTK_AT_CONTEXT (self), GTK_ACCESSIBLE_RELATION_POS_IN_SET);
+          str = g_strdup_printf ("%d", gtk_int_accessible_value_get (value));
+          g_variant_builder_add (&builder, "{ss}", "posinset", str);
+          g_free (str);
+        }
+
+      if (gtk_at_context_has_accessible_relation (GTK_AT_CONTEXT (self), GTK_ACCESSIBLE_RELATION_SET_SIZE))
+        {
+          GtkAccessibleValue *value;
+          char *str;
+
+          value = gtk_at_context_get_accessible_relation (GTK_AT_CONTEXT (self), GTK_ACCESSIBLE_RELATION_SET_SIZE);
+          str = g_strdup_printf ("%d", gtk_int_accessible_value_get (value));
+          g_variant_builder_add (&builder, "{ss}", "setsize", str);
+          g_free (str);
+        }
+
       g_variant_builder_close (&builder);
 
       g_dbus_method_invocation_return_value (invocation, g_variant_builder_end (&builder));
@@ -698,6 +736,122 @@ static const GDBusInterfaceVTable accessible_vtable = {
 };
 /* }}} */
 /* {{{ Change notification */
+static void
+clear_pending_event (gpointer data)
+{
+  PendingEvent *event = data;
+
+  g_variant_unref (event->value);
+}
+
+static void
+discard_pending_events (GtkAtSpiContext *self)
+{
+  g_clear_handle_id (&self->pending_events_id, g_source_remove);
+
+  if (self->pending_events != NULL)
+    g_array_set_size (self->pending_events, 0);
+}
+
+/* Emits all the queued events, in the order they were first queued.
+ * This must be called before emitting any other event on the context,
+ * so that ATs see changes in the order they happened
+ */
+static void
+flush_pending_events (GtkAtSpiContext *self)
+{
+  g_clear_handle_id (&self->pending_events_id, g_source_remove);
+
+  if (self->pending_events == NULL || self->pending_events->len == 0)
+    return;
+
+  if (self->connection != NULL && self->context_path != NULL)
+    {
+      for (guint i = 0; i < self->pending_events->len; i++)
+        {
+          PendingEvent *event = &g_array_index (self->pending_events, PendingEvent, i);
+
+          g_dbus_connection_emit_signal (self->connection,
+                                         NULL,
+                                         self->context_path,
+                                         "org.a11y.atspi.Event.Object",
+                                         event->member,
+                                         g_variant_new ("(siiva{sv})",
+                                                        event->name, event->detail, 0,
+                                                        event->value, NULL),
+                                         NULL);
+        }
+    }
+
+  g_array_set_size (self->pending_events, 0);
+}
+
+static gboolean
+flush_pending_events_cb (gpointer data)
+{
+  GtkAtSpiContext *self = data;
+
+  self->pending_events_id = 0;
+  flush_pending_events (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Widgets often change the same state several times while handling
+ * a single event, e.g. when a list model is updated. Instead of a
+ * D-Bus message for each change, only the last value of each state
+ * and property is sent, after the frame has been drawn.
+ *
+ * @member and @name must be static strings.
+ */
+static void
+queue_object_event (GtkAtSpiContext *self,
+                    const char      *member,
+                    const char      *name,
+                    int              detail,
+                    GVariant        *value)
+{
+  PendingEvent *event = NULL;
+
+  if (self->pending_events == NULL)
+    {
+      self->pending_events = g_array_new (FALSE, FALSE, sizeof (PendingEvent));
+      g_array_set_clear_func (self->pending_events, clear_pending_event);
+    }
+
+  for (guint i = 0; i < self->pending_events->len; i++)
+    {
+      PendingEvent *e = &g_array_index (self->pending_events, PendingEvent, i);
+
+      if (e->member == member && strcmp (e->name, name) == 0)
+        {
+          event = e;
+          g_variant_unref (event->value);
+          break;
+        }
+    }
+
+  if (event == NULL)
+    {
+      g_array_set_size (self->pending_events, self->pending_events->len + 1);
+      event = &g_array_index (self->pending_events, PendingEvent, self->pending_events->len - 1);
+      event->member = member;
+      event->name = name;
+    }
+
+  event->detail = detail;
+  event->value = g_variant_ref_sink (value);
+
+  if (self->pending_events_id == 0)
+    {
+      self->pending_events_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10,
+                                                 flush_pending_events_cb,
+                                                 self,
+                                                 NULL);
+      gdk_source_set_static_name_by_id (self->pending_events_id, "[gtk] flush_pending_events_cb");
+    }
+}
+
 static void
 emit_text_changed (GtkAtSpiContext *self,
                    const char      *kind,
@@ -708,6 +862,8 @@ emit_text_changed (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   g_dbus_connection_emit_signal (self->connection,
                                  NULL,
                                  self->context_path,
@@ -726,6 +882,8 @@ emit_text_selection_changed (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   if (strcmp (kind, "text-caret-moved") == 0)
     g_dbus_connection_emit_signal (self->connection,
                                    NULL,
@@ -753,6 +911,8 @@ emit_selection_changed (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   g_dbus_connection_emit_signal (self->connection,
                                  NULL,
                                  self->context_path,
@@ -771,14 +931,7 @@ emit_state_changed (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
-  g_dbus_connection_emit_signal (self->connection,
-                                 NULL,
-                                 self->context_path,
-                                 "org.a11y.atspi.Event.Object",
-                                 "StateChanged",
-                                 g_variant_new ("(siiva{sv})",
-                                                name, enabled, 0, g_variant_new_string ("0"), NULL),
-                                 NULL);
+  queue_object_event (self, "StateChanged", name, enabled, g_variant_new_string ("0"));
 }
 
 static void
@@ -787,6 +940,9 @@ emit_defunct (GtkAtSpiContext *self)
   if (self->connection == NULL)
     return;
 
+  /* Nobody cares about the state of an object that is going away */
+  discard_pending_events (self);
+
   g_dbus_connection_emit_signal (self->connection,
                                  NULL,
                                  self->context_path,
@@ -801,23 +957,13 @@ emit_property_changed (GtkAtSpiContext *self,
                        const char      *name,
                        GVariant        *value)
 {
-  GVariant *value_owned = g_variant_ref_sink (value);
-
   if (self->connection == NULL)
     {
-      g_variant_unref (value_owned);
+      g_variant_unref (g_variant_ref_sink (value));
       return;
     }
 
-  g_dbus_connection_emit_signal (self->connection,
-                                 NULL,
-                                 self->context_path,
-                                 "org.a11y.atspi.Event.Object",
-                                 "PropertyChange",
-                                 g_variant_new ("(siiva{sv})",
-                                                name, 0, 0, value_owned, NULL),
-                                 NULL);
-  g_variant_unref (value_owned);
+  queue_object_event (self, "PropertyChange", name, 0, value);
 }
 
 static void
@@ -830,6 +976,8 @@ emit_bounds_changed (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   g_dbus_connection_emit_signal (self->connection,
                                  NULL,
                                  self->context_path,
@@ -850,6 +998,8 @@ emit_children_changed (GtkAtSpiContext         *self,
   if (self->connection == NULL || child_context->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   GVariant *context_ref = gtk_at_spi_context_to_ref (self);
   GVariant *child_ref = gtk_at_spi_context_to_ref (child_context);
 
@@ -868,6 +1018,8 @@ emit_focus (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   if (focus_in)
     g_dbus_connection_emit_signal (self->connection,
                                    NULL,
@@ -886,6 +1038,8 @@ emit_window_event (GtkAtSpiContext *self,
   if (self->connection == NULL)
     return;
 
+  flush_pending_events (self);
+
   g_dbus_connection_emit_signal (self->connection,
                                  NULL,
                                  self->context_path,
@@ -1372,6 +1526,9 @@ gtk_at_spi_context_finalize (GObject *gobject)
 {
   GtkAtSpiContext *self = GTK_AT_SPI_CONTEXT (gobject);
 
+  discard_pending_events (self);
+  g_clear_pointer (&self->pending_events, g_array_unref);
+
   gtk_at_spi_context_unregister_object (self);
 
   g_clear_object (&self->root);
@@ -1482,6 +1639,7 @@ gtk_at_spi_context_unrealize (GtkATContext *context)
 
   /* Notify ATs that the accessible object is going away */
   emit_defunct (self);
+  discard_pending_events (self);
   gtk_at_spi_root_unregister (self->root, self);
 
   gtk_atspi_disconnect_text_signals (accessible);
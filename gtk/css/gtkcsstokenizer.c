@@ -833,7 +833,18 @@ gtk_css_tokenizer_read_whitespace (GtkCssTokenizer *tokenizer,
                                    GtkCssToken     *token)
 {
   do {
-    gtk_css_tokenizer_consume_whitespace (tokenizer);
+    const char *data;
+
+    /* Indentation is runs of spaces and tabs, so consume those at once */
+    for (data = tokenizer->data;
+         data < tokenizer->end && (*data == ' ' || *data == '\t');
+         data++)
+      ;
+
+    if (data > tokenizer->data)
+      gtk_css_tokenizer_consume (tokenizer, data - tokenizer->data, data - tokenizer->data);
+    else
+      gtk_css_tokenizer_consume_newline (tokenizer);
   } while (tokenizer->data != tokenizer->end &&
            is_whitespace (*tokenizer->data));
 
@@ -884,6 +895,24 @@ gtk_css_tokenizer_read_name (GtkCssTokenizer *tokenizer)
   g_string_set_size (tokenizer->name_buffer, 0);
 
   do {
+      const char *data;
+
+      /* Fast path: most names are plain ASCII, copy those in one go */
+      for (data = tokenizer->data;
+           data < tokenizer->end && is_name (*data) && !is_multibyte (*data);
+           data++)
+        ;
+
+      if (data > tokenizer->data)
+        {
+          gsize len = data - tokenizer->data;
+
+          g_string_append_len (tokenizer->name_buffer, tokenizer->data, len);
+          gtk_css_tokenizer_consume (tokenizer, len, len);
+          if (tokenizer->data == tokenizer->end)
+            break;
+        }
+
       if (*tokenizer->data == '\\')
         {
           if (gtk_css_tokenizer_has_valid_escape (tokenizer))
@@ -1252,6 +1281,27 @@ gtk_css_tokenizer_read_comment (GtkCssTokenizer  *tokenizer,
 
   while (tokenizer->data < tokenizer->end)
     {
+      const char *data;
+      gsize n_chars = 0;
+
+      /* Skip everything that can't end the comment or start a new line,
+       * counting only the bytes that start a character.
+       */
+      for (data = tokenizer->data;
+           data < tokenizer->end && *data != '*' && !is_newline (*data);
+           data++)
+        {
+          if ((*data & 0xC0) != 0x80)
+            n_chars++;
+        }
+
+      if (data > tokenizer->data)
+        {
+          gtk_css_tokenizer_consume (tokenizer, data - tokenizer->data, n_chars);
+          if (tokenizer->data == tokenizer->end)
+            break;
+        }
+
       if (gtk_css_tokenizer_remaining (tokenizer) > 1 &&
           tokenizer->data[0] == '*' && tokenizer->data[1] == '/')
         {
@@ -46,6 +46,7 @@
 #include <gtk/gtkapplicationwindow.h>
 #include <gtk/gtkaspectframe.h>
 #include <gtk/deprecated/gtkassistant.h>
+#include <gtk/gtkasyncliststore.h>
 #include <gtk/gtkatcontext.h>
 #include <gtk/gtkbinlayout.h>
 #include <gtk/gtkbitset.h>
@@ -294,6 +295,7 @@
 #include <gtk/gtkversion.h>
 #include <gtk/gtkvideo.h>
 #include <gtk/gtkviewport.h>
+#include <gtk/gtkvirtualstringlist.h>
 #include <gtk/deprecated/gtkvolumebutton.h>
 #include <gtk/gtkwidget.h>
 #include <gtk/gtkwidgetpaintable.h>
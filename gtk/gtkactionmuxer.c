@@ -160,6 +160,7 @@ struct _GtkActionMuxer
 
   GHashTable *observed_actions;
   GHashTable *groups;
+  GHashTable *resolved;
   GtkAccels primary_accels;
 
   GtkBitmask *widget_actions_disabled;
@@ -194,6 +195,18 @@ typedef struct
   gulong        handler_ids[4];
 } Group;
 
+/* What an action name refers to in a muxer itself, without looking
+ * at the parents. This only depends on the class of the widget and
+ * the inserted groups, so it is cached until a group is inserted or
+ * removed. Whether the group has the action is checked on every
+ * lookup, since groups gain and lose actions on their own.
+ */
+typedef struct
+{
+  GtkWidgetAction *action;
+  Group           *group;
+} Resolved;
+
 static inline guint
 get_action_position (GtkWidgetAction *action)
 {
@@ -271,13 +284,77 @@ gtk_action_muxer_list_actions (GtkActionMuxer *muxer,
   return (char **)keys;
 }
 
+static Resolved *
+gtk_action_muxer_resolve (GtkActionMuxer *muxer,
+                          const char     *full_name)
+{
+  Resolved *resolved;
+
+  if (muxer->resolved == NULL)
+    muxer->resolved = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, g_free);
+
+  resolved = g_hash_table_lookup (muxer->resolved, full_name);
+  if (resolved)
+    return resolved;
+
+  resolved = g_new0 (Resolved, 1);
+
+  if (muxer->widget)
+    {
+      GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (muxer->widget);
+      GtkWidgetClassPrivate *priv = klass->priv;
+      GtkWidgetAction *action;
+
+      for (action = priv->actions; action; action = action->next)
+        {
+          if (strcmp (action->name, full_name) == 0)
+            {
+              resolved->action = action;
+              break;
+            }
+        }
+    }
+
+  if (resolved->action == NULL && muxer->groups)
+    {
+      const char *dot = strchr (full_name, '.');
+
+      if (dot)
+        {
+          char *prefix = g_strndup (full_name, dot - full_name);
+          resolved->group = g_hash_table_lookup (muxer->groups, prefix);
+          g_free (prefix);
+        }
+    }
+
+  g_hash_table_insert (muxer->resolved, g_strdup (full_name), resolved);
+
+  return resolved;
+}
+
+static void
+gtk_action_muxer_clear_resolved (GtkActionMuxer *muxer)
+{
+  if (muxer->resolved)
+    g_hash_table_remove_all (muxer->resolved);
+}
+
+static GtkWidgetAction *
+gtk_action_muxer_find_widget_action (GtkActionMuxer *muxer,
+                                     const char     *full_name)
+{
+  if (!muxer->widget)
+    return NULL;
+
+  return gtk_action_muxer_resolve (muxer, full_name)->action;
+}
+
 static Group *
 gtk_action_muxer_find_group (GtkActionMuxer  *muxer,
                              const char      *full_name,
                              const char     **action_name)
 {
   const char *dot;
-  char *prefix;
   const char *name;
   Group *group;
 
@@ -291,9 +368,7 @@ gtk_action_muxer_find_group (GtkActionMuxer  *muxer,
 
   name = dot + 1;
 
-  prefix = g_strndup (full_name, dot - full_name);
-  group = g_hash_table_lookup (muxer->groups, prefix);
-  g_free (prefix);
+  group = gtk_action_muxer_resolve (muxer, full_name)->group;
 
   if (action_name)
     *action_name = name;
@@ -354,21 +429,12 @@ gtk_action_muxer_action_enabled_changed (GtkActionMuxer *muxer,
   Action *action;
   GSList *node;
 
-  if (muxer->widget)
+  iter = gtk_action_muxer_find_widget_action (muxer, action_name);
+  if (iter)
     {
-      GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (muxer->widget);
-      GtkWidgetClassPrivate *priv = klass->priv;
-
-      for (iter = priv->actions; iter; iter = iter->next)
-        {
-          if (strcmp (action_name, iter->name) == 0)
-            {
-              guint position = get_action_position (iter);
-              muxer->widget_actions_disabled =
-                _gtk_bitmask_set (muxer->widget_actions_disabled, position, !enabled);
-              break;
-            }
-        }
+      guint position = get_action_position (iter);
+      muxer->widget_actions_disabled =
+        _gtk_bitmask_set (muxer->widget_actions_disabled, position, !enabled);
     }
 
   action = find_observers (muxer, action_name);
@@ -754,42 +820,32 @@ action_muxer_query_action (GtkActionMuxer      *muxer,
   Group *group;
   const char *unprefixed_name;
 
-  if (muxer->widget)
+  action = gtk_action_muxer_find_widget_action (muxer, action_name);
+  if (action)
     {
-      GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (muxer->widget);
-      GtkWidgetClassPrivate *priv = klass->priv;
+      guint position = get_action_position (action);
 
-      for (action = priv->actions; action; action = action->next)
-        {
-          guint position;
-
-          if (strcmp (action->name, action_name) != 0)
-            continue;
+      if (enabled)
+        *enabled = !_gtk_bitmask_get (muxer->widget_actions_disabled, position);
+      if (parameter_type)
+        *parameter_type = action->parameter_type;
+      if (state_type)
+        *state_type = action->state_type;
 
-          position = get_action_position (action);
-
-          if (enabled)
-            *enabled = !_gtk_bitmask_get (muxer->widget_actions_disabled, position);
-          if (parameter_type)
-            *parameter_type = action->parameter_type;
-          if (state_type)
-            *state_type = action->state_type;
+      if (state_hint)
+        *state_hint = NULL;
+      if (state)
+        *state = NULL;
 
-          if (state_hint)
-            *state_hint = NULL;
+      if (action->pspec)
+        {
           if (state)
-            *state = NULL;
-
-          if (action->pspec)
-            {
-              if (state)
-                *state = prop_action_get_state (muxer->widget, action);
-              if (state_hint)
-                *state_hint = prop_action_get_state_hint (muxer->widget, action);
-            }
-
-          return TRUE;
+            *state = prop_action_get_state (muxer->widget, action);
+          if (state_hint)
+            *state_hint = prop_action_get_state_hint (muxer->widget, action);
         }
+
+      return TRUE;
     }
 
   group = gtk_action_muxer_find_group (muxer, action_name, &unprefixed_name);
@@ -835,38 +891,30 @@ gtk_action_muxer_activate_action (GtkActionMuxer *muxer,
                                   const char     *action_name,
                                   GVariant       *parameter)
 {
+  GtkWidgetAction *action;
   const char *unprefixed_name;
   Group *group;
 
-  if (muxer->widget)
+  action = gtk_action_muxer_find_widget_action (muxer, action_name);
+  if (action)
     {
-      GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (muxer->widget);
-      GtkWidgetClassPrivate *priv = klass->priv;
-      GtkWidgetAction *action;
+      guint position = get_action_position (action);
 
-      for (action = priv->actions; action; action = action->next)
+      if (!_gtk_bitmask_get (muxer->widget_actions_disabled, position))
         {
-          if (strcmp (action->name, action_name) == 0)
+          if (action->activate)
+            {
+              GTK_DEBUG (ACTIONS, "%s: activate action", action->name);
+              action->activate (muxer->widget, action->name, parameter);
+            }
+          else if (action->pspec)
             {
-              guint position = get_action_position (action);
-
-              if (!_gtk_bitmask_get (muxer->widget_actions_disabled, position))
-                {
-                  if (action->activate)
-                    {
-                      GTK_DEBUG (ACTIONS, "%s: activate action", action->name);
-                      action->activate (muxer->widget, action->name, parameter);
-                    }
-                  else if (action->pspec)
-                    {
-                      GTK_DEBUG (ACTIONS, "%s: activate prop action", action->pspec->name);
-                      prop_action_activate (muxer->widget, action, parameter);
-                    }
-                }
-
-              return;
+              GTK_DEBUG (ACTIONS, "%s: activate prop action", action->pspec->name);
+              prop_action_activate (muxer->widget, action, parameter);
             }
         }
+
+      return;
     }
 
   group = gtk_action_muxer_find_group (muxer, action_name, &unprefixed_name);
@@ -886,21 +934,13 @@ gtk_action_muxer_change_action_state (GtkActionMuxer *muxer,
   const char *unprefixed_name;
   Group *group;
 
-  if (muxer->widget)
+  action = gtk_action_muxer_find_widget_action (muxer, action_name);
+  if (action)
     {
-      GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (muxer->widget);
-      GtkWidgetClassPrivate *priv = klass->priv;
+      if (action->pspec)
+        prop_action_set_state (muxer->widget, action, state);
 
-      for (action = priv->actions; action; action = action->next)
-        {
-          if (strcmp (action->name, action_name) == 0)
-            {
-              if (action->pspec)
-                prop_action_set_state (muxer->widget, action, state);
-
-              return;
-            }
-        }
+      return;
     }
 
   group = gtk_action_muxer_find_group (muxer, action_name, &unprefixed_name);
@@ -1058,6 +1098,8 @@ gtk_action_muxer_finalize (GObject *object)
     }
   if (muxer->groups)
     g_hash_table_unref (muxer->groups);
+  if (muxer->resolved)
+    g_hash_table_unref (muxer->resolved);
 
   gtk_accels_clear (&muxer->primary_accels);
 
@@ -1076,6 +1118,7 @@ gtk_action_muxer_dispose (GObject *object)
     g_hash_table_remove_all (muxer->observed_actions);
 
   muxer->widget = NULL;
+  gtk_action_muxer_clear_resolved (muxer);
 
   G_OBJECT_CLASS (gtk_action_muxer_parent_class)->dispose (object);
 }
@@ -1125,6 +1168,7 @@ gtk_action_muxer_set_property (GObject      *object,
 
     case PROP_WIDGET:
       muxer->widget = g_value_get_object (value);
+      gtk_action_muxer_clear_resolved (muxer);
       break;
 
     default:
@@ -1287,6 +1331,7 @@ gtk_action_muxer_insert (GtkActionMuxer *muxer,
   group->prefix = g_strdup (prefix);
 
   g_hash_table_insert (muxer->groups, group->prefix, group);
+  gtk_action_muxer_clear_resolved (muxer);
 
   actions = g_action_group_list_actions (group->group);
   for (i = 0; actions[i]; i++)
@@ -1330,6 +1375,7 @@ gtk_action_muxer_remove (GtkActionMuxer *muxer,
       int i;
 
       g_hash_table_steal (muxer->groups, prefix);
+      gtk_action_muxer_clear_resolved (muxer);
 
       actions = g_action_group_list_actions (group->group);
       for (i = 0; actions[i]; i++)
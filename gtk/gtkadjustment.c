@@ -62,6 +62,10 @@ struct _GtkAdjustmentPrivate {
   gint64 start_time;
   gint64 end_time;
   GdkFrameClock *clock;
+
+  GdkFrameClock *coalesce_clock;
+  gulong coalesce_id;
+  guint value_changed_pending : 1;
 };
 typedef struct _GtkAdjustmentPrivate GtkAdjustmentPrivate;
 
@@ -113,6 +117,9 @@ gtk_adjustment_finalize (GObject *object)
     g_signal_handler_disconnect (priv->clock, priv->tick_id);
   if (priv->clock)
     g_object_unref (priv->clock);
+  if (priv->coalesce_id)
+    g_signal_handler_disconnect (priv->coalesce_clock, priv->coalesce_id);
+  g_clear_object (&priv->coalesce_clock);
 
   G_OBJECT_CLASS (gtk_adjustment_parent_class)->finalize (object);
 }
@@ -315,13 +322,32 @@ gtk_adjustment_set_property (GObject      *object,
     }
 }
 
-static inline void
-emit_value_changed (GtkAdjustment *adjustment)
+static void
+flush_value_changed (GtkAdjustment *adjustment)
 {
+  GtkAdjustmentPrivate *priv = gtk_adjustment_get_instance_private (adjustment);
+
+  if (!priv->value_changed_pending)
+    return;
+
+  priv->value_changed_pending = FALSE;
   g_signal_emit (adjustment, adjustment_signals[VALUE_CHANGED], 0);
   g_object_notify_by_pspec (G_OBJECT (adjustment), adjustment_props[PROP_VALUE]);
 }
 
+static inline void
+emit_value_changed (GtkAdjustment *adjustment)
+{
+  GtkAdjustmentPrivate *priv = gtk_adjustment_get_instance_private (adjustment);
+
+  priv->value_changed_pending = TRUE;
+
+  if (priv->coalesce_clock)
+    gdk_frame_clock_request_phase (priv->coalesce_clock, GDK_FRAME_CLOCK_PHASE_UPDATE);
+  else
+    flush_value_changed (adjustment);
+}
+
 static void
 gtk_adjustment_dispatch_properties_changed (GObject     *object,
                                             guint        n_pspecs,
@@ -505,6 +531,10 @@ gtk_adjustment_on_frame_clock_update (GdkFrameClock *clock,
       adjustment_set_value (adjustment, priv->target);
       gtk_adjustment_end_updating (adjustment);
     }
+
+  /* We are in the update phase already, don't wait for the next one */
+  if (clock == priv->coalesce_clock)
+    flush_value_changed (adjustment);
 }
 
 static void
@@ -941,6 +971,95 @@ gtk_adjustment_get_minimum_increment (GtkAdjustment *adjustment)
   return minimum_increment;
 }
 
+static void
+gtk_adjustment_on_coalesce_update (GdkFrameClock *clock,
+                                   GtkAdjustment *adjustment)
+{
+  flush_value_changed (adjustment);
+}
+
+/**
+ * gtk_adjustment_set_coalesce_clock:
+ * @adjustment: a `GtkAdjustment`
+ * @clock: (nullable): the frame clock to coalesce on
+ *
+ * Makes @adjustment coalesce value changes per frame of @clock.
+ *
+ * When a frame clock is set, [signal@Gtk.Adjustment::value-changed]
+ * and the notification for [property@Gtk.Adjustment:value] are not
+ * emitted for every change of the value. Instead, they are emitted
+ * once during the update phase of the next frame of @clock, no matter
+ * how often the value changed in between. This avoids redoing work
+ * for every motion event when scrolling quickly, for example in views
+ * that share an adjustment.
+ *
+ * [method@Gtk.Adjustment.get_value] always returns the latest value.
+ * The [signal@Gtk.Adjustment::changed] signal is not affected.
+ *
+ * Usually, @clock is the frame clock of a widget that uses @adjustment,
+ * see [method@Gtk.Widget.get_frame_clock]. Pass %NULL to emit the
+ * signal for every change again; a pending emission happens right away
+ * in that case.
+ *
+ * Since: 4.14
+ */
+void
+gtk_adjustment_set_coalesce_clock (GtkAdjustment *adjustment,
+                                   GdkFrameClock *clock)
+{
+  GtkAdjustmentPrivate *priv = gtk_adjustment_get_instance_private (adjustment);
+
+  g_return_if_fail (GTK_IS_ADJUSTMENT (adjustment));
+  g_return_if_fail (clock == NULL || GDK_IS_FRAME_CLOCK (clock));
+
+  if (priv->coalesce_clock == clock)
+    return;
+
+  if (priv->coalesce_clock)
+    {
+      g_signal_handler_disconnect (priv->coalesce_clock, priv->coalesce_id);
+      priv->coalesce_id = 0;
+      g_object_unref (priv->coalesce_clock);
+    }
+
+  priv->coalesce_clock = clock;
+
+  if (priv->coalesce_clock)
+    {
+      g_object_ref (priv->coalesce_clock);
+      priv->coalesce_id = g_signal_connect (priv->coalesce_clock, "update",
+                                            G_CALLBACK (gtk_adjustment_on_coalesce_update), adjustment);
+      if (priv->value_changed_pending)
+        gdk_frame_clock_request_phase (priv->coalesce_clock, GDK_FRAME_CLOCK_PHASE_UPDATE);
+    }
+  else
+    {
+      flush_value_changed (adjustment);
+    }
+}
+
+/**
+ * gtk_adjustment_get_coalesce_clock:
+ * @adjustment: a `GtkAdjustment`
+ *
+ * Gets the frame clock that value changes are coalesced on.
+ *
+ * See [method@Gtk.Adjustment.set_coalesce_clock].
+ *
+ * Returns: (nullable) (transfer none): the frame clock
+ *
+ * Since: 4.14
+ */
+GdkFrameClock *
+gtk_adjustment_get_coalesce_clock (GtkAdjustment *adjustment)
+{
+  GtkAdjustmentPrivate *priv = gtk_adjustment_get_instance_private (adjustment);
+
+  g_return_val_if_fail (GTK_IS_ADJUSTMENT (adjustment), NULL);
+
+  return priv->coalesce_clock;
+}
+
 void
 gtk_adjustment_enable_animation (GtkAdjustment *adjustment,
                                  GdkFrameClock *clock,
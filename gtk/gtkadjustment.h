@@ -120,6 +120,13 @@ void       gtk_adjustment_configure             (GtkAdjustment   *adjustment,
 GDK_AVAILABLE_IN_ALL
 double     gtk_adjustment_get_minimum_increment (GtkAdjustment   *adjustment);
 
+GDK_AVAILABLE_IN_4_14
+void       gtk_adjustment_set_coalesce_clock    (GtkAdjustment   *adjustment,
+                                                 GdkFrameClock   *clock);
+GDK_AVAILABLE_IN_4_14
+GdkFrameClock *
+           gtk_adjustment_get_coalesce_clock    (GtkAdjustment   *adjustment);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtkAdjustment, g_object_unref)
 
 G_END_DECLS
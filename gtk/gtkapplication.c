@@ -21,7 +21,6 @@
 #include "config.h"
 
 #include "gtkapplication.h"
-#include "gdkprofilerprivate.h"
 
 #include <stdlib.h>
 
@@ -35,6 +34,7 @@
 #include "gtkicontheme.h"
 #include "gtkbuilder.h"
 #include "gtkprivate.h"
+#include "gtkstartupprivate.h"
 
 /* NB: please do not add backend-specific GDK headers here.  This should
  * be abstracted via GtkApplicationImpl.
@@ -246,25 +246,21 @@ gtk_application_startup (GApplication *g_application)
 {
   GtkApplication *application = GTK_APPLICATION (g_application);
   GtkApplicationPrivate *priv = gtk_application_get_instance_private (application);
-  gint64 before G_GNUC_UNUSED;
-  gint64 before2 G_GNUC_UNUSED;
 
-  before = GDK_PROFILER_CURRENT_TIME;
+  gtk_startup_phase_begin ("gtk application startup");
 
   G_APPLICATION_CLASS (gtk_application_parent_class)->startup (g_application);
 
   gtk_action_muxer_insert (priv->muxer, "app", G_ACTION_GROUP (application));
 
-  before2 = GDK_PROFILER_CURRENT_TIME;
   gtk_init ();
-  gdk_profiler_end_mark (before2, "gtk init", NULL);
 
   priv->impl = gtk_application_impl_new (application, gdk_display_get_default ());
   gtk_application_impl_startup (priv->impl, priv->register_session);
 
   gtk_application_load_resources (application);
 
-  gdk_profiler_end_mark (before, "gtk application startup", NULL);
+  gtk_startup_phase_end (NULL);
 }
 
 static void
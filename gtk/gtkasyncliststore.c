@@ -0,0 +1,373 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkasyncliststore.h"
+
+#include "gtkprivate.h"
+
+/**
+ * GtkAsyncListStore:
+ *
+ * `GtkAsyncListStore` is a list model that other threads can append
+ * items to.
+ *
+ * Items are added with [method@Gtk.AsyncListStore.push], which can be
+ * called from any thread and never blocks. The pushed items are added
+ * to the model in the thread that created it, once per main loop
+ * iteration just before the next frame is drawn, so pushing many items
+ * quickly results in a single [signal@Gio.ListModel::items-changed]
+ * emission for all of them.
+ *
+ * All other functions, including the `GListModel` api, must only be
+ * called from the thread that created the model.
+ *
+ * Since: 4.14
+ */
+
+enum {
+  PROP_0,
+  PROP_ITEM_TYPE,
+  PROP_N_ITEMS,
+  NUM_PROPERTIES
+};
+
+typedef struct _PendingItem PendingItem;
+
+struct _PendingItem
+{
+  PendingItem *next;
+  GObject *item;
+};
+
+#define GDK_ARRAY_ELEMENT_TYPE GObject *
+#define GDK_ARRAY_NAME objects
+#define GDK_ARRAY_TYPE_NAME Objects
+#define GDK_ARRAY_FREE_FUNC g_object_unref
+#include "gdk/gdkarrayimpl.c"
+
+struct _GtkAsyncListStore
+{
+  GObject parent_instance;
+
+  GType item_type;
+  Objects items;
+
+  GMainContext *context;
+  /* atomic, pushed items in reverse order */
+  PendingItem *pending;
+  /* atomic, TRUE while a flush is queued */
+  int flush_queued;
+};
+
+struct _GtkAsyncListStoreClass
+{
+  GObjectClass parent_class;
+};
+
+static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
+
+static GType
+gtk_async_list_store_get_item_type (GListModel *list)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (list);
+
+  return self->item_type;
+}
+
+static guint
+gtk_async_list_store_get_n_items (GListModel *list)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (list);
+
+  return objects_get_size (&self->items);
+}
+
+static gpointer
+gtk_async_list_store_get_item (GListModel *list,
+                               guint       position)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (list);
+
+  if (position >= objects_get_size (&self->items))
+    return NULL;
+
+  return g_object_ref (objects_get (&self->items, position));
+}
+
+static void
+gtk_async_list_store_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = gtk_async_list_store_get_item_type;
+  iface->get_n_items = gtk_async_list_store_get_n_items;
+  iface->get_item = gtk_async_list_store_get_item;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GtkAsyncListStore, gtk_async_list_store, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_async_list_store_model_init))
+
+static void
+gtk_async_list_store_set_property (GObject      *object,
+                                   guint         prop_id,
+                                   const GValue *value,
+                                   GParamSpec   *pspec)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (object);
+
+  switch (prop_id)
+    {
+    case PROP_ITEM_TYPE:
+      self->item_type = g_value_get_gtype (value);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_async_list_store_get_property (GObject    *object,
+                                   guint       prop_id,
+                                   GValue     *value,
+                                   GParamSpec *pspec)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (object);
+
+  switch (prop_id)
+    {
+    case PROP_ITEM_TYPE:
+      g_value_set_gtype (value, self->item_type);
+      break;
+
+    case PROP_N_ITEMS:
+      g_value_set_uint (value, objects_get_size (&self->items));
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_async_list_store_finalize (GObject *object)
+{
+  GtkAsyncListStore *self = GTK_ASYNC_LIST_STORE (object);
+  PendingItem *pending, *next;
+
+  for (pending = self->pending; pending; pending = next)
+    {
+      next = pending->next;
+      g_object_unref (pending->item);
+      g_free (pending);
+    }
+
+  objects_clear (&self->items);
+  g_main_context_unref (self->context);
+
+  G_OBJECT_CLASS (gtk_async_list_store_parent_class)->finalize (object);
+}
+
+static void
+gtk_async_list_store_class_init (GtkAsyncListStoreClass *class)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (class);
+
+  gobject_class->set_property = gtk_async_list_store_set_property;
+  gobject_class->get_property = gtk_async_list_store_get_property;
+  gobject_class->finalize = gtk_async_list_store_finalize;
+
+  /**
+   * GtkAsyncListStore:item-type:
+   *
+   * The type of items. See [method@Gio.ListModel.get_item_type].
+   *
+   * Since: 4.14
+   **/
+  properties[PROP_ITEM_TYPE] =
+    g_param_spec_gtype ("item-type", NULL, NULL,
+                        G_TYPE_OBJECT,
+                        G_PARAM_READWRITE | G_PARAM_CONSTRUCT_ONLY | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GtkAsyncListStore:n-items:
+   *
+   * The number of items. See [method@Gio.ListModel.get_n_items].
+   *
+   * Since: 4.14
+   **/
+  properties[PROP_N_ITEMS] =
+    g_param_spec_uint ("n-items", NULL, NULL,
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
+}
+
+static void
+gtk_async_list_store_init (GtkAsyncListStore *self)
+{
+  self->item_type = G_TYPE_OBJECT;
+  objects_init (&self->items);
+  self->context = g_main_context_ref_thread_default ();
+}
+
+/**
+ * gtk_async_list_store_new:
+ * @item_type: the `GType` of items in the list
+ *
+ * Creates a new `GtkAsyncListStore` with items of type @item_type.
+ *
+ * Pushed items are added to the model in the thread-default main
+ * context of the calling thread.
+ *
+ * Returns: a new `GtkAsyncListStore`
+ *
+ * Since: 4.14
+ */
+GtkAsyncListStore *
+gtk_async_list_store_new (GType item_type)
+{
+  g_return_val_if_fail (g_type_is_a (item_type, G_TYPE_OBJECT), NULL);
+
+  return g_object_new (GTK_TYPE_ASYNC_LIST_STORE,
+                       "item-type", item_type,
+                       NULL);
+}
+
+static gboolean
+gtk_async_list_store_flush_cb (gpointer data)
+{
+  GtkAsyncListStore *self = data;
+
+  gtk_async_list_store_flush (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_async_list_store_queue_flush (GtkAsyncListStore *self)
+{
+  GSource *source;
+
+  /* Only the first push after a flush queues a new one */
+  if (!g_atomic_int_compare_and_exchange (&self->flush_queued, FALSE, TRUE))
+    return;
+
+  source = g_idle_source_new ();
+  g_source_set_priority (source, GDK_PRIORITY_REDRAW - 1);
+  g_source_set_callback (source,
+                         gtk_async_list_store_flush_cb,
+                         g_object_ref (self),
+                         g_object_unref);
+  g_source_set_static_name (source, "[gtk] gtk_async_list_store_flush_cb");
+  g_source_attach (source, self->context);
+  g_source_unref (source);
+}
+
+/**
+ * gtk_async_list_store_push:
+ * @self: a `GtkAsyncListStore`
+ * @item: (type GObject): the new item
+ *
+ * Appends @item to @self.
+ *
+ * This function can be called from any thread. It does not take
+ * any locks and returns immediately. The item is added to the model
+ * later in the thread that created @self, see
+ * [method@Gtk.AsyncListStore.flush].
+ *
+ * Items pushed by the same thread are added in the order they
+ * were pushed.
+ *
+ * @item must be of type [property@Gtk.AsyncListStore:item-type].
+ *
+ * Since: 4.14
+ */
+void
+gtk_async_list_store_push (GtkAsyncListStore *self,
+                           gpointer           item)
+{
+  PendingItem *pending;
+
+  g_return_if_fail (GTK_IS_ASYNC_LIST_STORE (self));
+  g_return_if_fail (g_type_is_a (G_OBJECT_TYPE (item), self->item_type));
+
+  pending = g_new (PendingItem, 1);
+  pending->item = g_object_ref (item);
+
+  do
+    {
+      pending->next = g_atomic_pointer_get (&self->pending);
+    }
+  while (!g_atomic_pointer_compare_and_exchange (&self->pending, pending->next, pending));
+
+  gtk_async_list_store_queue_flush (self);
+}
+
+/**
+ * gtk_async_list_store_flush:
+ * @self: a `GtkAsyncListStore`
+ *
+ * Adds all items that have been pushed so far to the model.
+ *
+ * This happens automatically once per main loop iteration, but
+ * can be called to make pushed items available right away.
+ *
+ * Since: 4.14
+ */
+void
+gtk_async_list_store_flush (GtkAsyncListStore *self)
+{
+  PendingItem *pending, *next, *reversed;
+  guint position, n_items;
+
+  g_return_if_fail (GTK_IS_ASYNC_LIST_STORE (self));
+
+  /* Clear the flag first, so that a push after we took the
+   * pending items is guaranteed to queue another flush.
+   */
+  g_atomic_int_set (&self->flush_queued, FALSE);
+  pending = g_atomic_pointer_exchange (&self->pending, NULL);
+  if (pending == NULL)
+    return;
+
+  n_items = 0;
+  reversed = NULL;
+  for (; pending; pending = next)
+    {
+      next = pending->next;
+      pending->next = reversed;
+      reversed = pending;
+      n_items++;
+    }
+
+  position = objects_get_size (&self->items);
+  objects_reserve (&self->items, position + n_items);
+
+  for (pending = reversed; pending; pending = next)
+    {
+      next = pending->next;
+      objects_append (&self->items, pending->item);
+      g_free (pending);
+    }
+
+  g_list_model_items_changed (G_LIST_MODEL (self), position, 0, n_items);
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+}
@@ -0,0 +1,47 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gio/gio.h>
+/* for GDK_AVAILABLE_IN_ALL */
+#include <gdk/gdk.h>
+
+
+G_BEGIN_DECLS
+
+#define GTK_TYPE_ASYNC_LIST_STORE (gtk_async_list_store_get_type ())
+
+GDK_AVAILABLE_IN_4_14
+G_DECLARE_FINAL_TYPE (GtkAsyncListStore, gtk_async_list_store, GTK, ASYNC_LIST_STORE, GObject)
+
+GDK_AVAILABLE_IN_4_14
+GtkAsyncListStore *     gtk_async_list_store_new                        (GType                           item_type);
+
+GDK_AVAILABLE_IN_4_14
+void                    gtk_async_list_store_push                       (GtkAsyncListStore              *self,
+                                                                         gpointer                        item);
+GDK_AVAILABLE_IN_4_14
+void                    gtk_async_list_store_flush                      (GtkAsyncListStore              *self);
+
+G_END_DECLS
+
@@ -47,8 +47,41 @@ struct _GtkBitset
 {
   int ref_count;
   roaring_bitmap_t roaring;
+
+  /* Number of values before each container and the total size at the
+   * end, so that get_nth() can binary search for the container.
+   * NULL if it needs to be computed again.
+   */
+  guint64 *ranks;
 };
 
+static inline void
+gtk_bitset_changed (GtkBitset *self)
+{
+  g_clear_pointer (&self->ranks, g_free);
+}
+
+static const guint64 *
+gtk_bitset_ensure_ranks (const GtkBitset *self)
+{
+  const roaring_array_t *ra = &self->roaring.high_low_container;
+  guint64 *ranks;
+  int i;
+
+  if (self->ranks)
+    return self->ranks;
+
+  ranks = g_new (guint64, ra->size + 1);
+  ranks[0] = 0;
+  for (i = 0; i < ra->size; i++)
+    ranks[i + 1] = ranks[i] + container_get_cardinality (ra->containers[i], ra->typecodes[i]);
+
+  /* this is only a cache, it doesn't change the value of the set */
+  ((GtkBitset *) self)->ranks = ranks;
+
+  return ranks;
+}
+
 
 G_DEFINE_BOXED_TYPE (GtkBitset, gtk_bitset,
                      gtk_bitset_ref,
@@ -92,6 +125,7 @@ gtk_bitset_unref (GtkBitset *self)
     return;
 
   ra_clear (&self->roaring.high_low_container);
+  g_free (self->ranks);
   g_free (self);
 }
 
@@ -207,7 +241,7 @@ gtk_bitset_get_size (const GtkBitset *self)
 {
   g_return_val_if_fail (self != NULL, 0);
 
-  return roaring_bitmap_get_cardinality (&self->roaring);
+  return gtk_bitset_ensure_ranks (self)[self->roaring.high_low_container.size];
 }
 
 /**
@@ -251,12 +285,32 @@ guint
 gtk_bitset_get_nth (const GtkBitset *self,
                     guint            nth)
 {
-  uint32_t result;
+  const roaring_array_t *ra = &self->roaring.high_low_container;
+  const guint64 *ranks;
+  uint32_t start_rank, result;
+  int low, high, mid;
 
-  if (!roaring_bitmap_select (&self->roaring, nth, &result))
+  ranks = gtk_bitset_ensure_ranks (self);
+  if (nth >= ranks[ra->size])
     return 0;
 
-  return result;
+  /* find the last container starting at or before nth */
+  low = 0;
+  high = ra->size - 1;
+  while (low < high)
+    {
+      mid = (low + high + 1) / 2;
+      if (ranks[mid] <= nth)
+        low = mid;
+      else
+        high = mid - 1;
+    }
+
+  start_rank = ranks[low];
+  if (!container_select (ra->containers[low], ra->typecodes[low], &start_rank, nth, &result))
+    g_return_val_if_reached (0);
+
+  return ((guint) ra->keys[low] << 16) | result;
 }
 
 /**
@@ -320,6 +374,8 @@ gtk_bitset_copy (const GtkBitset *self)
 
   copy = gtk_bitset_new_empty ();
   roaring_bitmap_overwrite (&copy->roaring, &self->roaring);
+  if (self->ranks)
+    copy->ranks = g_memdup2 (self->ranks, sizeof (guint64) * (self->roaring.high_low_container.size + 1));
 
   return copy;
 }
@@ -336,6 +392,7 @@ gtk_bitset_remove_all (GtkBitset *self)
   g_return_if_fail (self != NULL);
 
   roaring_bitmap_clear (&self->roaring);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -354,7 +411,11 @@ gtk_bitset_add (GtkBitset *self,
 {
   g_return_val_if_fail (self != NULL, FALSE);
 
-  return roaring_bitmap_add_checked (&self->roaring, value);
+  if (!roaring_bitmap_add_checked (&self->roaring, value))
+    return FALSE;
+
+  gtk_bitset_changed (self);
+  return TRUE;
 }
 
 /**
@@ -373,7 +434,11 @@ gtk_bitset_remove (GtkBitset *self,
 {
   g_return_val_if_fail (self != NULL, FALSE);
 
-  return roaring_bitmap_remove_checked (&self->roaring, value);
+  if (!roaring_bitmap_remove_checked (&self->roaring, value))
+    return FALSE;
+
+  gtk_bitset_changed (self);
+  return TRUE;
 }
 
 /**
@@ -399,6 +464,7 @@ gtk_bitset_add_range (GtkBitset *self,
   g_return_if_fail (start + n_items == 0 || start + n_items > start);
 
   roaring_bitmap_add_range_closed (&self->roaring, start, start + n_items - 1);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -424,6 +490,7 @@ gtk_bitset_remove_range (GtkBitset *self,
   g_return_if_fail (start + n_items == 0 || start + n_items > start);
 
   roaring_bitmap_remove_range_closed (&self->roaring, start, start + n_items - 1);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -444,6 +511,7 @@ gtk_bitset_add_range_closed (GtkBitset *self,
   g_return_if_fail (first <= last);
 
   roaring_bitmap_add_range_closed (&self->roaring, first, last);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -464,6 +532,7 @@ gtk_bitset_remove_range_closed (GtkBitset *self,
   g_return_if_fail (first <= last);
 
   roaring_bitmap_remove_range_closed (&self->roaring, first, last);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -551,6 +620,7 @@ gtk_bitset_union (GtkBitset       *self,
     return;
 
   roaring_bitmap_or_inplace (&self->roaring, &other->roaring);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -576,6 +646,7 @@ gtk_bitset_intersect (GtkBitset       *self,
     return;
 
   roaring_bitmap_and_inplace (&self->roaring, &other->roaring);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -599,11 +670,12 @@ gtk_bitset_subtract (GtkBitset       *self,
 
   if (self == other)
     {
-      roaring_bitmap_clear (&self->roaring);
+      gtk_bitset_remove_all (self);
       return;
     }
 
   roaring_bitmap_andnot_inplace (&self->roaring, &other->roaring);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -629,11 +701,12 @@ gtk_bitset_difference (GtkBitset       *self,
 
   if (self == other)
     {
-      roaring_bitmap_clear (&self->roaring);
+      gtk_bitset_remove_all (self);
       return;
     }
 
   roaring_bitmap_xor_inplace (&self->roaring, &other->roaring);
+  gtk_bitset_changed (self);
 }
 
 /**
@@ -23,6 +23,7 @@
 
 #include "gtkbuilder.h"
 #include "gtkbuilderprivate.h"
+#include "gtkbuilderscope.h"
 #include "gtklistitemfactoryprivate.h"
 #include "gtklistitemprivate.h"
 
@@ -59,6 +60,9 @@ struct _GtkBuilderListItemFactory
   GtkListItemFactory parent_instance;
 
   GtkBuilderScope *scope;
+  /* used when no scope is set, shared by all items so that
+   * the module and its symbols are only looked up once */
+  GtkBuilderScope *default_scope;
   GBytes *bytes;
   GBytes *data;
   char *resource;
@@ -95,11 +99,13 @@ gtk_builder_list_item_factory_setup (GtkListItemFactory *factory,
 
   GTK_LIST_ITEM_FACTORY_CLASS (gtk_builder_list_item_factory_parent_class)->setup (factory, item, bind, func, data);
 
-  builder = gtk_builder_new ();
+  if (self->scope == NULL && self->default_scope == NULL)
+    self->default_scope = gtk_builder_cscope_new ();
 
-  gtk_builder_set_current_object (builder, item);
-  if (self->scope)
-    gtk_builder_set_scope (builder, self->scope);
+  builder = g_object_new (GTK_TYPE_BUILDER,
+                          "scope", self->scope ? self->scope : self->default_scope,
+                          "current-object", item,
+                          NULL);
 
   gtk_builder_set_allow_template_parents (builder, TRUE);
   if (!gtk_builder_extend_with_template (builder, G_OBJECT (item), G_OBJECT_TYPE (item),
@@ -163,7 +169,11 @@ gtk_builder_list_item_factory_set_bytes (GtkBuilderListItemFactory *self,
 
   self->bytes = g_bytes_ref (bytes);
 
-  if (!_gtk_buildable_parser_is_precompiled (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes)))
+  if (_gtk_buildable_parser_is_precompiled (g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes)))
+    {
+      self->data = g_bytes_ref (bytes);
+    }
+  else
     {
       GError *error = NULL;
       GBytes *data;
@@ -241,6 +251,7 @@ gtk_builder_list_item_factory_finalize (GObject *object)
   GtkBuilderListItemFactory *self = GTK_BUILDER_LIST_ITEM_FACTORY (object);
 
   g_clear_object (&self->scope);
+  g_clear_object (&self->default_scope);
   g_bytes_unref (self->bytes);
   g_bytes_unref (self->data);
   g_free (self->resource);
@@ -167,6 +167,7 @@ struct _GtkBuilderCScopePrivate
 {
   GModule *module;
   GHashTable *callbacks;
+  GHashTable *module_callbacks;  /* symbols found in the module, looking them up is slow */
 };
 
 static void gtk_builder_cscope_scope_init (GtkBuilderScopeInterface *iface);
@@ -285,6 +286,7 @@ gtk_builder_cscope_get_callback (GtkBuilderCScope  *self,
                                  const char        *function_name,
                                  GError           **error)
 {
+  GtkBuilderCScopePrivate *priv = gtk_builder_cscope_get_instance_private (self);
   GModule *module;
   GCallback func;
 
@@ -292,6 +294,13 @@ gtk_builder_cscope_get_callback (GtkBuilderCScope  *self,
   if (func)
     return func;
 
+  if (priv->module_callbacks)
+    {
+      func = g_hash_table_lookup (priv->module_callbacks, function_name);
+      if (func)
+        return func;
+    }
+
   module = gtk_builder_cscope_get_module (self);
   if (module == NULL)
     {
@@ -313,6 +322,13 @@ gtk_builder_cscope_get_callback (GtkBuilderCScope  *self,
       return NULL;
     }
 
+  /* Templates are instantiated many times, so remember the symbol. Failed
+   * lookups aren't cached, a library loaded later might provide it.
+   */
+  if (!priv->module_callbacks)
+    priv->module_callbacks = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+  g_hash_table_insert (priv->module_callbacks, g_strdup (function_name), func);
+
   return func;
 }
 
@@ -397,6 +413,7 @@ gtk_builder_cscope_finalize (GObject *object)
   GtkBuilderCScopePrivate *priv = gtk_builder_cscope_get_instance_private (self);
 
   g_clear_pointer (&priv->callbacks, g_hash_table_destroy);
+  g_clear_pointer (&priv->module_callbacks, g_hash_table_destroy);
   g_clear_pointer (&priv->module, g_module_close);
 
   G_OBJECT_CLASS (gtk_builder_cscope_parent_class)->finalize (object);
@@ -24,6 +24,7 @@
 #include "gtkadjustment.h"
 #include "gtkboxlayout.h"
 #include "gtkbuildable.h"
+#include "gtkcolumnviewcellwidgetprivate.h"
 #include "gtkcolumnviewcolumnprivate.h"
 #include "gtkcolumnviewsorterprivate.h"
 #include "gtkcssnodeprivate.h"
@@ -107,7 +108,9 @@
  * `GtkColumnView` uses the %GTK_ACCESSIBLE_ROLE_TREE_GRID role, header title
  * widgets are using the %GTK_ACCESSIBLE_ROLE_COLUMN_HEADER role. The row widgets
  * are using the %GTK_ACCESSIBLE_ROLE_ROW role, and individual cells are using
- * the %GTK_ACCESSIBLE_ROLE_GRID_CELL role
+ * the %GTK_ACCESSIBLE_ROLE_GRID_CELL role. Rows have their position and
+ * the number of rows set with the %GTK_ACCESSIBLE_RELATION_POS_IN_SET and
+ * %GTK_ACCESSIBLE_RELATION_SET_SIZE relations.
  */
 
 /* We create a subclass of GtkListView for the sole purpose of overriding
@@ -145,6 +148,8 @@ struct _GtkColumnView
   double autoscroll_delta;
 
   GtkGesture *drag_gesture;
+
+  GHashTable *cell_pool; /* GtkListItemFactory => GPtrArray of unused cells */
 };
 
 struct _GtkColumnViewClass
@@ -189,12 +194,7 @@ gtk_column_list_view_create_list_widget (GtkListBase *base)
       GtkColumnViewColumn *column = g_list_model_get_item (G_LIST_MODEL (self->columns), i);
 
       if (gtk_column_view_column_get_visible (column))
-        {
-          GtkWidget *cell;
-
-          cell = gtk_column_view_cell_widget_new (column, gtk_column_view_is_inert (self));
-          gtk_column_view_row_widget_add_child (GTK_COLUMN_VIEW_ROW_WIDGET (result), cell);
-        }
+        gtk_column_view_add_cell (self, GTK_COLUMN_VIEW_ROW_WIDGET (result), column);
 
       g_object_unref (column);
     }
@@ -309,12 +309,104 @@ gtk_column_view_is_inert (GtkColumnView *self)
          gtk_widget_get_root (widget) == NULL;
 }
 
+/* Maximum number of unused cells kept per factory */
+#define GTK_COLUMN_VIEW_MAX_POOLED_CELLS 256
+
+/*
+ * gtk_column_view_add_cell:
+ * @self: a `GtkColumnView`
+ * @row: the row to add the cell to
+ * @column: the column of the cell
+ *
+ * Adds a cell for @column to @row.
+ *
+ * If a cell that uses the same factory as @column was removed previously,
+ * that cell is reused, so the factory does not need to set it up again.
+ *
+ * Returns: (transfer none): the new cell
+ */
+GtkWidget *
+gtk_column_view_add_cell (GtkColumnView          *self,
+                          GtkColumnViewRowWidget *row,
+                          GtkColumnViewColumn    *column)
+{
+  GtkListItemFactory *factory;
+  GPtrArray *cells;
+  GtkWidget *cell;
+
+  factory = gtk_column_view_column_get_factory (column);
+  if (factory == NULL || gtk_column_view_is_inert (self))
+    cells = NULL;
+  else
+    cells = g_hash_table_lookup (self->cell_pool, factory);
+
+  if (cells == NULL)
+    {
+      cell = gtk_column_view_cell_widget_new (column, gtk_column_view_is_inert (self));
+      gtk_column_view_row_widget_add_child (row, cell);
+      return cell;
+    }
+
+  cell = g_ptr_array_steal_index_fast (cells, cells->len - 1);
+  if (cells->len == 0)
+    g_hash_table_remove (self->cell_pool, factory);
+
+  gtk_column_view_cell_widget_set_column (GTK_COLUMN_VIEW_CELL_WIDGET (cell), column);
+  gtk_column_view_row_widget_add_child (row, cell);
+  g_object_unref (cell);
+
+  return cell;
+}
+
+/*
+ * gtk_column_view_remove_cell:
+ * @self: a `GtkColumnView`
+ * @cell: the cell to remove
+ *
+ * Removes @cell from its row. The cell is unbound and kept
+ * for reuse by gtk_column_view_add_cell().
+ */
+void
+gtk_column_view_remove_cell (GtkColumnView           *self,
+                             GtkColumnViewCellWidget *cell)
+{
+  GtkListItemFactory *factory;
+  GPtrArray *cells;
+
+  factory = gtk_list_factory_widget_get_factory (GTK_LIST_FACTORY_WIDGET (cell));
+  if (factory == NULL)
+    {
+      gtk_column_view_cell_widget_remove (cell);
+      return;
+    }
+
+  cells = g_hash_table_lookup (self->cell_pool, factory);
+  if (cells == NULL)
+    {
+      cells = g_ptr_array_new_with_free_func (g_object_unref);
+      g_hash_table_insert (self->cell_pool, factory, cells);
+    }
+  else if (cells->len >= GTK_COLUMN_VIEW_MAX_POOLED_CELLS)
+    {
+      gtk_column_view_cell_widget_remove (cell);
+      return;
+    }
+
+  g_ptr_array_add (cells, g_object_ref (cell));
+  gtk_column_view_cell_widget_remove (cell);
+  gtk_list_item_base_update (GTK_LIST_ITEM_BASE (cell), GTK_INVALID_LIST_POSITION, NULL, FALSE);
+  gtk_column_view_cell_widget_set_column (cell, NULL);
+}
+
 static void
 gtk_column_view_update_cell_factories (GtkColumnView *self,
                                        gboolean       inert)
 {
   guint i, n;
 
+  if (inert)
+    g_hash_table_remove_all (self->cell_pool);
+
   n = g_list_model_get_n_items (G_LIST_MODEL (self->columns));
 
   for (i = 0; i < n; i++)
@@ -589,6 +681,8 @@ gtk_column_view_dispose (GObject *object)
 
   g_assert (self->focus_column == NULL);
 
+  g_hash_table_remove_all (self->cell_pool);
+
   g_clear_pointer (&self->header, gtk_widget_unparent);
 
   g_clear_pointer ((GtkWidget **) &self->listview, gtk_widget_unparent);
@@ -605,6 +699,7 @@ gtk_column_view_finalize (GObject *object)
   GtkColumnView *self = GTK_COLUMN_VIEW (object);
 
   g_object_unref (self->columns);
+  g_hash_table_unref (self->cell_pool);
 
   G_OBJECT_CLASS (gtk_column_view_parent_class)->finalize (object);
 }
@@ -1445,6 +1540,7 @@ gtk_column_view_init (GtkColumnView *self)
   GtkEventController *controller;
 
   self->columns = g_list_store_new (GTK_TYPE_COLUMN_VIEW_COLUMN);
+  self->cell_pool = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_ptr_array_unref);
 
   self->header = gtk_column_view_row_widget_new (NULL, TRUE);
   gtk_widget_set_can_focus (self->header, FALSE);
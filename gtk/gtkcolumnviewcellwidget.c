@@ -270,24 +270,43 @@ gtk_column_view_cell_widget_size_allocate (GtkWidget *widget,
 }
 
 static void
-gtk_column_view_cell_widget_dispose (GObject *object)
+gtk_column_view_cell_widget_unlink (GtkColumnViewCellWidget *self)
 {
-  GtkColumnViewCellWidget *self = GTK_COLUMN_VIEW_CELL_WIDGET (object);
+  if (self->column == NULL)
+    return;
 
-  if (self->column)
-    {
-      gtk_column_view_column_remove_cell (self->column, self);
+  gtk_column_view_column_remove_cell (self->column, self);
 
-      if (self->prev_cell)
-        self->prev_cell->next_cell = self->next_cell;
-      if (self->next_cell)
-        self->next_cell->prev_cell = self->prev_cell;
+  if (self->prev_cell)
+    self->prev_cell->next_cell = self->next_cell;
+  if (self->next_cell)
+    self->next_cell->prev_cell = self->prev_cell;
 
-      self->prev_cell = NULL;
-      self->next_cell = NULL;
+  self->prev_cell = NULL;
+  self->next_cell = NULL;
 
-      g_clear_object (&self->column);
-    }
+  g_clear_object (&self->column);
+}
+
+static void
+gtk_column_view_cell_widget_link (GtkColumnViewCellWidget *self,
+                                  GtkColumnViewColumn     *column)
+{
+  self->column = g_object_ref (column);
+
+  self->next_cell = gtk_column_view_column_get_first_cell (self->column);
+  if (self->next_cell)
+    self->next_cell->prev_cell = self;
+
+  gtk_column_view_column_add_cell (self->column, self);
+}
+
+static void
+gtk_column_view_cell_widget_dispose (GObject *object)
+{
+  GtkColumnViewCellWidget *self = GTK_COLUMN_VIEW_CELL_WIDGET (object);
+
+  gtk_column_view_cell_widget_unlink (self);
 
   G_OBJECT_CLASS (gtk_column_view_cell_widget_parent_class)->dispose (object);
 }
@@ -358,15 +377,33 @@ gtk_column_view_cell_widget_new (GtkColumnViewColumn *column,
                        "factory", inert ? NULL : gtk_column_view_column_get_factory (column),
                        NULL);
 
-  self->column = g_object_ref (column);
+  gtk_column_view_cell_widget_link (self, column);
 
-  self->next_cell = gtk_column_view_column_get_first_cell (self->column);
-  if (self->next_cell)
-    self->next_cell->prev_cell = self;
+  return GTK_WIDGET (self);
+}
 
-  gtk_column_view_column_add_cell (self->column, self);
+/*
+ * gtk_column_view_cell_widget_set_column:
+ * @self: a `GtkColumnViewCellWidget`
+ * @column: (nullable): the new column
+ *
+ * Moves an unparented cell to a different column, so that it
+ * can be reused. The cell keeps its factory, so @column must use
+ * the same factory as the cell's previous column.
+ */
+void
+gtk_column_view_cell_widget_set_column (GtkColumnViewCellWidget *self,
+                                        GtkColumnViewColumn     *column)
+{
+  g_assert (gtk_widget_get_parent (GTK_WIDGET (self)) == NULL);
 
-  return GTK_WIDGET (self);
+  if (self->column == column)
+    return;
+
+  gtk_column_view_cell_widget_unlink (self);
+
+  if (column)
+    gtk_column_view_cell_widget_link (self, column);
 }
 
 void
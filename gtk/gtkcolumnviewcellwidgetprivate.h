@@ -46,5 +46,7 @@ void                            gtk_column_view_cell_widget_remove             (
 GtkColumnViewCellWidget *       gtk_column_view_cell_widget_get_next           (GtkColumnViewCellWidget         *self);
 GtkColumnViewCellWidget *       gtk_column_view_cell_widget_get_prev           (GtkColumnViewCellWidget         *self);
 GtkColumnViewColumn *           gtk_column_view_cell_widget_get_column         (GtkColumnViewCellWidget         *self);
+void                            gtk_column_view_cell_widget_set_column         (GtkColumnViewCellWidget         *self,
+                                                                                GtkColumnViewColumn             *column);
 
 G_END_DECLS
@@ -535,8 +535,7 @@ gtk_column_view_column_create_cells (GtkColumnViewColumn *self)
 
       list_item = GTK_COLUMN_VIEW_ROW_WIDGET (row);
       base = GTK_LIST_ITEM_BASE (row);
-      cell = gtk_column_view_cell_widget_new (self, gtk_column_view_is_inert (self->view));
-      gtk_column_view_row_widget_add_child (list_item, cell);
+      cell = gtk_column_view_add_cell (self->view, list_item, self);
       gtk_list_item_base_update (GTK_LIST_ITEM_BASE (cell),
                                  gtk_list_item_base_get_position (base),
                                  gtk_list_item_base_get_item (base),
@@ -548,7 +547,12 @@ static void
 gtk_column_view_column_remove_cells (GtkColumnViewColumn *self)
 {
   while (self->first_cell)
-    gtk_column_view_cell_widget_remove (self->first_cell);
+    {
+      if (self->view)
+        gtk_column_view_remove_cell (self->view, self->first_cell);
+      else
+        gtk_column_view_cell_widget_remove (self->first_cell);
+    }
 }
 
 static void
@@ -23,6 +23,7 @@
 #include "gtk/gtklistview.h"
 #include "gtk/gtksizerequest.h"
 
+#include "gtk/gtkcolumnviewcellwidgetprivate.h"
 #include "gtk/gtkcolumnviewsorterprivate.h"
 #include "gtk/gtkcolumnviewrowwidgetprivate.h"
 
@@ -31,6 +32,12 @@ gboolean                gtk_column_view_is_inert                (GtkColumnView
 GtkColumnViewRowWidget *gtk_column_view_get_header_widget       (GtkColumnView          *self);
 GtkListView *           gtk_column_view_get_list_view           (GtkColumnView          *self);
 
+GtkWidget *             gtk_column_view_add_cell                (GtkColumnView          *self,
+                                                                 GtkColumnViewRowWidget *row,
+                                                                 GtkColumnViewColumn    *column);
+void                    gtk_column_view_remove_cell             (GtkColumnView          *self,
+                                                                 GtkColumnViewCellWidget *cell);
+
 void                    gtk_column_view_measure_across          (GtkColumnView          *self,
                                                                  int                    *minimum,
                                                                  int                    *natural);
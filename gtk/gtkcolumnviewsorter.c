@@ -32,6 +32,7 @@ typedef struct
   GtkSorter *sorter;
   gboolean   inverted;
   gulong     changed_id;
+  gulong     item_changed_id;
 } Sorter;
 
 static void
@@ -40,6 +41,7 @@ free_sorter (gpointer data)
   Sorter *s = data;
 
   g_signal_handler_disconnect (s->sorter, s->changed_id);
+  g_signal_handler_disconnect (s->sorter, s->item_changed_id);
   g_object_unref (s->sorter);
   g_object_unref (s->column);
   g_free (s);
@@ -269,6 +271,12 @@ gtk_column_view_sorter_changed_cb (GtkSorter *sorter, int change, gpointer data)
   gtk_sorter_changed (GTK_SORTER (data), GTK_SORTER_CHANGE_DIFFERENT);
 }
 
+static void
+gtk_column_view_sorter_item_changed_cb (GtkSorter *sorter, gpointer item, gpointer data)
+{
+  gtk_sorter_item_changed (GTK_SORTER (data), item);
+}
+
 static gboolean
 remove_column (GtkColumnViewSorter *self,
                GtkColumnViewColumn *column)
@@ -325,6 +333,7 @@ gtk_column_view_sorter_add_column (GtkColumnViewSorter *self,
   s->column = g_object_ref (column);
   s->sorter = g_object_ref (sorter);
   s->changed_id = g_signal_connect (sorter, "changed", G_CALLBACK (gtk_column_view_sorter_changed_cb), self);
+  s->item_changed_id = g_signal_connect (sorter, "item-changed", G_CALLBACK (gtk_column_view_sorter_item_changed_cb), self);
   s->inverted = FALSE;
 
   g_sequence_insert_before (iter, s);
@@ -388,6 +397,7 @@ gtk_column_view_sorter_set_column (GtkColumnViewSorter *self,
   s->column = g_object_ref (column);
   s->sorter = g_object_ref (sorter);
   s->changed_id = g_signal_connect (sorter, "changed", G_CALLBACK (gtk_column_view_sorter_changed_cb), self);
+  s->item_changed_id = g_signal_connect (sorter, "item-changed", G_CALLBACK (gtk_column_view_sorter_item_changed_cb), self);
   s->inverted = inverted;
 
   g_sequence_prepend (self->sorters, s);
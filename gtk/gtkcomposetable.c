@@ -748,8 +748,9 @@ gtk_compose_table_load_cache (const char *compose_file,
 {
   guint32 hash;
   char *path = NULL;
-  char *contents = NULL;
-  char *p;
+  GMappedFile *map = NULL;
+  const char *contents;
+  const char *p;
   GStatBuf original_buf;
   GStatBuf cache_buf;
   gsize total_length;
@@ -780,13 +781,24 @@ gtk_compose_table_load_cache (const char *compose_file,
   g_stat (compose_file, &original_buf);
   if (original_buf.st_mtime > cache_buf.st_mtime)
     goto out_load_cache;
-  if (!g_file_get_contents (path, &contents, &total_length, &error))
+  map = g_mapped_file_new (path, FALSE, &error);
+  if (map == NULL)
     {
       g_warning ("Failed to get cache content %s: %s", path, error->message);
       g_error_free (error);
       goto out_load_cache;
     }
 
+  contents = g_mapped_file_get_contents (map);
+  total_length = g_mapped_file_get_length (map);
+
+  /* magic, followed by 5 guint16 header fields */
+  if (total_length < strlen (GTK_COMPOSE_TABLE_MAGIC) + 5 * sizeof (guint16))
+    {
+      g_warning ("Broken cache content %s at head", path);
+      goto out_load_cache;
+    }
+
 #define GET_GUINT16(elt) \
   memcpy (&bytes, p, sizeof (guint16)); \
   elt = GUINT16_FROM_BE (bytes); \
@@ -801,11 +813,6 @@ gtk_compose_table_load_cache (const char *compose_file,
     }
 
   p += strlen (GTK_COMPOSE_TABLE_MAGIC);
-  if (p - contents > total_length)
-    {
-      g_warning ("Broken cache content %s at head", path);
-      goto out_load_cache;
-    }
 
   GET_GUINT16 (version);
   if (version != GTK_COMPOSE_TABLE_VERSION)
@@ -826,6 +833,12 @@ gtk_compose_table_load_cache (const char *compose_file,
       goto out_load_cache;
     }
 
+  if (total_length - (p - contents) < data_size * sizeof (guint16) + n_chars)
+    {
+      g_warning ("Broken cache content %s", path);
+      goto out_load_cache;
+    }
+
   data = g_new0 (guint16, data_size);
 
   for (i = 0; i < data_size; i++)
@@ -849,7 +862,7 @@ gtk_compose_table_load_cache (const char *compose_file,
   retval->n_chars = n_chars;
   retval->id = hash;
 
-  g_free (contents);
+  g_mapped_file_unref (map);
   g_free (path);
 
   return retval;
@@ -859,7 +872,7 @@ gtk_compose_table_load_cache (const char *compose_file,
 out_load_cache:
   g_free (data);
   g_free (char_data);
-  g_free (contents);
+  g_clear_pointer (&map, g_mapped_file_unref);
   g_free (path);
   return NULL;
 }
@@ -1036,6 +1036,10 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
   layout_width = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_WIDTH);
   layout_height = get_layout_attribute (self, widget, GTK_CONSTRAINT_ATTRIBUTE_HEIGHT);
 
+  /* Adding and removing each constraint runs the simplex again, so
+   * we batch them, and only optimize once for all of them
+   */
+  gtk_constraint_solver_freeze (solver);
   gtk_constraint_variable_set_value (layout_top, 0.0);
   stay_t = gtk_constraint_solver_add_stay_variable (solver,
                                                     layout_top,
@@ -1052,6 +1056,8 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
   stay_h = gtk_constraint_solver_add_stay_variable (solver,
                                                     layout_height,
                                                     GTK_CONSTRAINT_STRENGTH_REQUIRED);
+  gtk_constraint_solver_thaw (solver);
+
   GTK_DEBUG (LAYOUT, "Layout [%p]: { .x: %g, .y: %g, .w: %g, .h: %g }",
                      self,
                      gtk_constraint_variable_get_value (layout_left),
@@ -1124,10 +1130,12 @@ gtk_constraint_layout_allocate (GtkLayoutManager *manager,
 #endif
 
   /* The allocation stay constraints are not needed any more */
+  gtk_constraint_solver_freeze (solver);
   gtk_constraint_solver_remove_constraint (solver, stay_w);
   gtk_constraint_solver_remove_constraint (solver, stay_h);
   gtk_constraint_solver_remove_constraint (solver, stay_t);
   gtk_constraint_solver_remove_constraint (solver, stay_l);
+  gtk_constraint_solver_thaw (solver);
 }
 
 static void
@@ -1399,6 +1399,9 @@ gtk_constraint_solver_freeze (GtkConstraintSolver *solver)
  * @solver: a `GtkConstraintSolver`
  *
  * Thaws a frozen `GtkConstraintSolver`.
+ *
+ * All the constraints added or removed while the solver was frozen
+ * are optimized in a single pass.
  */
 void
 gtk_constraint_solver_thaw (GtkConstraintSolver *solver)
@@ -1411,6 +1414,12 @@ gtk_constraint_solver_thaw (GtkConstraintSolver *solver)
   if (solver->freeze_count == 0)
     {
       solver->auto_solve = TRUE;
+
+      /* Adding and removing constraints keeps the tableau feasible,
+       * but only the primal simplex makes it optimal again */
+      if (solver->needs_solving)
+        gtk_constraint_solver_optimize (solver, solver->objective);
+
       gtk_constraint_solver_resolve (solver);
     }
 }
@@ -740,7 +740,7 @@ gtk_css_filter_value_new_none (void)
   return _gtk_css_value_ref (&filter_none_singleton);
 }
 
-static gboolean
+gboolean
 gtk_css_filter_value_is_none (const GtkCssValue *value)
 {
   return value->n_filters == 0;
@@ -28,6 +28,7 @@ G_BEGIN_DECLS
 
 GtkCssValue *   gtk_css_filter_value_new_none           (void);
 GtkCssValue *   gtk_css_filter_value_parse              (GtkCssParser           *parser);
+gboolean        gtk_css_filter_value_is_none            (const GtkCssValue      *value);
 
 void            gtk_css_filter_value_push_snapshot      (const GtkCssValue      *filter,
                                                          GtkSnapshot            *snapshot);
@@ -26,7 +26,9 @@
 #include "gtksettingsprivate.h"
 #include "gtktypebuiltins.h"
 #include "gtkprivate.h"
+#include "gtkcsslookupprivate.h"
 #include "gdkprofilerprivate.h"
+#include "gdk/gdkparalleltaskprivate.h"
 
 /*
  * CSS nodes are the backbone of the GtkStyleContext implementation and
@@ -95,6 +97,25 @@
  */
 #define GTK_CSS_CHANGE_NEEDS_RECOMPUTE (GTK_CSS_RADICAL_CHANGE & ~GTK_CSS_CHANGE_PARENT_STYLE)
 
+/* Below this many siblings that need a new style, matching their
+ * selectors in parallel isn't worth the overhead.
+ */
+#define PREFETCH_MIN_NODES 16
+
+/* The selector matching part of computing a style, done for all
+ * children of a node at once when restyling lots of them.
+ * Matching only reads the node tree and the style providers, so
+ * it can run in threads, unlike computing the values.
+ * Any invalidation of the node throws the result away.
+ */
+struct _GtkCssNodePrefetch
+{
+  GtkStyleProvider *provider;
+  GtkCssChange      pending_changes;
+  GtkCssChange      change;
+  GtkCssLookup      lookup;
+};
+
 G_DEFINE_TYPE (GtkCssNode, gtk_css_node, G_TYPE_OBJECT)
 
 enum {
@@ -123,8 +144,13 @@ gtk_css_node_get_style_provider_or_null (GtkCssNode *cssnode)
 
 static int invalidated_nodes;
 static int created_styles;
+static int style_cache_hits;
+static int style_cache_misses;
 static guint invalidated_nodes_counter;
 static guint created_styles_counter;
+static guint style_cache_hits_counter;
+static guint style_cache_misses_counter;
+static gboolean stats_enabled;
 
 static void
 gtk_css_node_set_invalid (GtkCssNode *node,
@@ -225,6 +251,13 @@ gtk_css_node_set_property (GObject      *object,
     }
 }
 
+static void
+gtk_css_node_prefetch_free (GtkCssNodePrefetch *prefetch)
+{
+  _gtk_css_lookup_destroy (&prefetch->lookup);
+  g_free (prefetch);
+}
+
 static void
 gtk_css_node_dispose (GObject *object)
 {
@@ -238,6 +271,7 @@ gtk_css_node_dispose (GObject *object)
   gtk_css_node_set_invalid (cssnode, FALSE);
 
   g_clear_pointer (&cssnode->cache, gtk_css_node_style_cache_unref);
+  g_clear_pointer (&cssnode->prefetch, gtk_css_node_prefetch_free);
 
  if (cssnode->children_observer)
    gtk_list_list_model_clear (cssnode->children_observer);
@@ -253,6 +287,7 @@ gtk_css_node_finalize (GObject *object)
   if (cssnode->style)
     g_object_unref (cssnode->style);
   gtk_css_node_declaration_unref (cssnode->decl);
+  g_free (cssnode->stats);
 
   G_OBJECT_CLASS (gtk_css_node_parent_class)->finalize (object);
 }
@@ -317,7 +352,14 @@ lookup_in_global_parent_cache (GtkCssNode                  *node,
     return NULL;
 
   if (parent->cache == NULL)
-    return NULL;
+    parent->cache = gtk_css_node_style_cache_lookup_shared (parent->style,
+                                                            gtk_css_node_get_style_provider (parent));
+
+  if (parent->cache == NULL)
+    {
+      style_cache_misses++;
+      return NULL;
+    }
 
   g_assert (node->cache == NULL);
   node->cache = gtk_css_node_style_cache_lookup (parent->cache,
@@ -325,7 +367,12 @@ lookup_in_global_parent_cache (GtkCssNode                  *node,
                                                  gtk_css_node_is_first_child (node),
                                                  gtk_css_node_is_last_child (node));
   if (node->cache == NULL)
-    return NULL;
+    {
+      style_cache_misses++;
+      return NULL;
+    }
+
+  style_cache_hits++;
 
   return gtk_css_node_style_cache_get_style (node->cache);
 }
@@ -346,7 +393,8 @@ store_in_global_parent_cache (GtkCssNode                  *node,
     return;
 
   if (parent->cache == NULL)
-    parent->cache = gtk_css_node_style_cache_new (parent->style);
+    parent->cache = gtk_css_node_style_cache_get_shared (parent->style,
+                                                         gtk_css_node_get_style_provider (parent));
 
   node->cache = gtk_css_node_style_cache_insert (parent->cache,
                                                  (GtkCssNodeDeclaration *) decl,
@@ -363,29 +411,51 @@ gtk_css_node_create_style (GtkCssNode                   *cssnode,
   const GtkCssNodeDeclaration *decl;
   GtkCssStyle *style;
   GtkCssChange style_change;
+  GtkCssNodePrefetch *prefetch;
+  GtkStyleProvider *provider;
 
   decl = gtk_css_node_get_declaration (cssnode);
+  prefetch = g_steal_pointer (&cssnode->prefetch);
 
   style = lookup_in_global_parent_cache (cssnode, decl);
   if (style)
-    return g_object_ref (style);
+    {
+      g_clear_pointer (&prefetch, gtk_css_node_prefetch_free);
+      return g_object_ref (style);
+    }
 
   created_styles++;
 
-  if (change & GTK_CSS_CHANGE_NEEDS_RECOMPUTE)
+  provider = gtk_css_node_get_style_provider (cssnode);
+
+  if (prefetch &&
+      prefetch->provider == provider &&
+      prefetch->pending_changes == change)
     {
-      /* Need to recompute the change flags */
-      style_change = 0;
+      style = gtk_css_static_style_new_for_lookup (provider,
+                                                   cssnode,
+                                                   &prefetch->lookup,
+                                                   prefetch->change);
     }
   else
     {
-      style_change = gtk_css_static_style_get_change (gtk_css_style_get_static_style (cssnode->style));
+      if (change & GTK_CSS_CHANGE_NEEDS_RECOMPUTE)
+        {
+          /* Need to recompute the change flags */
+          style_change = 0;
+        }
+      else
+        {
+          style_change = gtk_css_static_style_get_change (gtk_css_style_get_static_style (cssnode->style));
+        }
+
+      style = gtk_css_static_style_new_compute (provider,
+                                                filter,
+                                                cssnode,
+                                                style_change);
     }
 
-  style = gtk_css_static_style_new_compute (gtk_css_node_get_style_provider (cssnode),
-                                            filter,
-                                            cssnode,
-                                            style_change);
+  g_clear_pointer (&prefetch, gtk_css_node_prefetch_free);
 
   store_in_global_parent_cache (cssnode, decl, style);
 
@@ -605,6 +675,8 @@ gtk_css_node_class_init (GtkCssNodeClass *klass)
     {
       invalidated_nodes_counter = gdk_profiler_define_int_counter ("invalidated-nodes", "CSS Node Invalidations");
       created_styles_counter = gdk_profiler_define_int_counter ("created-styles", "CSS Style Creations");
+      style_cache_hits_counter = gdk_profiler_define_int_counter ("style-cache-hits", "CSS Style Cache Hits");
+      style_cache_misses_counter = gdk_profiler_define_int_counter ("style-cache-misses", "CSS Style Cache Misses");
     }
 }
 
@@ -929,6 +1001,37 @@ gtk_css_node_propagate_pending_changes (GtkCssNode *cssnode,
   cssnode->needs_propagation = FALSE;
 }
 
+static void
+gtk_css_node_record_restyle (GtkCssNode   *cssnode,
+                             GtkCssChange  change,
+                             gboolean      style_changed,
+                             gint64        before)
+{
+  gint64 duration = g_get_monotonic_time () - before;
+
+  if (stats_enabled)
+    {
+      if (cssnode->stats == NULL)
+        cssnode->stats = g_new0 (GtkCssNodeStats, 1);
+
+      cssnode->stats->n_restyles++;
+      if (style_changed)
+        cssnode->stats->n_changes++;
+      cssnode->stats->time += duration;
+      cssnode->stats->causes |= change;
+    }
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      const char *name = g_quark_to_string (gtk_css_node_get_name (cssnode));
+      char *causes = gtk_css_change_to_string (change);
+
+      gdk_profiler_add_markf (before * 1000, duration * 1000, "css restyle",
+                              "%s: %s", name ? name : "*", causes);
+      g_free (causes);
+    }
+}
+
 static gboolean
 gtk_css_node_needs_new_style (GtkCssNode *cssnode)
 {
@@ -945,17 +1048,25 @@ gtk_css_node_do_ensure_style (GtkCssNode                   *cssnode,
   if (cssnode->style_is_invalid)
     {
       GtkCssStyle *new_style;
+      GtkCssChange change = cssnode->pending_changes;
+      gint64 before = 0;
+
+      if (G_UNLIKELY (stats_enabled || GDK_PROFILER_IS_RUNNING))
+        before = g_get_monotonic_time ();
 
       g_clear_pointer (&cssnode->cache, gtk_css_node_style_cache_unref);
 
       new_style = GTK_CSS_NODE_GET_CLASS (cssnode)->update_style (cssnode,
                                                                   filter,
-                                                                  cssnode->pending_changes,
+                                                                  change,
                                                                   current_time,
                                                                   cssnode->style);
 
       style_changed = gtk_css_node_set_style (cssnode, new_style);
       g_object_unref (new_style);
+
+      if (G_UNLIKELY (before != 0))
+        gtk_css_node_record_restyle (cssnode, change, style_changed, before);
     }
   else
     {
@@ -1003,9 +1114,21 @@ gtk_css_node_get_style (GtkCssNode *cssnode)
 {
   if (gtk_css_node_needs_new_style (cssnode))
     {
+      GtkCountingBloomFilter filter = GTK_COUNTING_BLOOM_FILTER_INIT;
       gint64 timestamp = gtk_css_node_get_timestamp (cssnode);
-
-      gtk_css_node_ensure_style (cssnode, NULL, timestamp);
+      GtkCssNode *ancestor;
+
+      /* We are not called from validation, so nobody tracked the
+       * ancestors for us. Collecting them once is cheap compared to
+       * walking them for every descendant selector in the theme.
+       * The filter may contain more than the ancestors of any node
+       * we end up computing a style for, which only costs matching
+       * them the slow way.
+       */
+      for (ancestor = cssnode->parent; ancestor; ancestor = ancestor->parent)
+        gtk_css_node_declaration_add_bloom_hashes (ancestor->decl, &filter);
+
+      gtk_css_node_ensure_style (cssnode, &filter, timestamp);
     }
 
   return cssnode->style;
@@ -1300,18 +1423,141 @@ gtk_css_node_invalidate (GtkCssNode   *cssnode,
     return;
 
   cssnode->pending_changes |= change;
+  g_clear_pointer (&cssnode->prefetch, gtk_css_node_prefetch_free);
 
   if (cssnode->parent)
     cssnode->parent->needs_propagation = TRUE;
   gtk_css_node_invalidate_style (cssnode);
 }
 
+typedef struct _PrefetchLookups PrefetchLookups;
+
+struct _PrefetchLookups
+{
+  const GtkCountingBloomFilter *filter;
+  GPtrArray                    *nodes;
+
+  /* atomic */ int              next_node;
+};
+
+static void
+gtk_css_node_prefetch_task (gpointer data)
+{
+  PrefetchLookups *pl = data;
+  guint i;
+
+  for (i = g_atomic_int_add (&pl->next_node, 1);
+       i < pl->nodes->len;
+       i = g_atomic_int_add (&pl->next_node, 1))
+    {
+      GtkCssNode *node = g_ptr_array_index (pl->nodes, i);
+      GtkCssNodePrefetch *prefetch = node->prefetch;
+
+      gtk_style_provider_lookup (prefetch->provider,
+                                 pl->filter,
+                                 node,
+                                 &prefetch->lookup,
+                                 prefetch->change == 0 ? &prefetch->change : NULL);
+    }
+}
+
+static gboolean
+gtk_css_node_needs_prefetch (GtkCssNode *node)
+{
+  return node->visible &&
+         node->style_is_invalid &&
+         node->prefetch == NULL &&
+         gtk_css_style_needs_recreation (GTK_CSS_STYLE (gtk_css_style_get_static_style (node->style)),
+                                         node->pending_changes);
+}
+
+/* Does the selector matching for the children of @cssnode that are
+ * going to need a new style in parallel, so that validating them
+ * only needs to compute the values.
+ * Expects @filter to contain the hashes of @cssnode and its ancestors,
+ * like when validating the children.
+ */
+static GPtrArray *
+gtk_css_node_prefetch_children (GtkCssNode                   *cssnode,
+                                const GtkCountingBloomFilter *filter)
+{
+  PrefetchLookups pl;
+  GHashTable *decls;
+  GtkCssNode *child;
+  guint n_nodes;
+
+  n_nodes = 0;
+  for (child = cssnode->first_child; child; child = child->next_sibling)
+    {
+      if (gtk_css_node_needs_prefetch (child))
+        n_nodes++;
+    }
+
+  if (n_nodes < PREFETCH_MIN_NODES)
+    return NULL;
+
+  pl.filter = filter;
+  pl.nodes = g_ptr_array_new_full (n_nodes, g_object_unref);
+  pl.next_node = 0;
+
+  /* Siblings with the same declaration are going to find the
+   * first one's style in the parent cache, don't match them again.
+   */
+  decls = g_hash_table_new (gtk_css_node_declaration_hash, gtk_css_node_declaration_equal);
+
+  for (child = cssnode->first_child; child; child = child->next_sibling)
+    {
+      GtkCssNodePrefetch *prefetch;
+
+      if (!gtk_css_node_needs_prefetch (child))
+        continue;
+
+      if (may_use_global_parent_cache (child) &&
+          !gtk_css_node_is_first_child (child) &&
+          !gtk_css_node_is_last_child (child) &&
+          !g_hash_table_add (decls, child->decl))
+        continue;
+
+      prefetch = g_new (GtkCssNodePrefetch, 1);
+      prefetch->provider = gtk_css_node_get_style_provider (child);
+      prefetch->pending_changes = child->pending_changes;
+      if (child->pending_changes & GTK_CSS_CHANGE_NEEDS_RECOMPUTE)
+        prefetch->change = 0;
+      else
+        prefetch->change = gtk_css_static_style_get_change (gtk_css_style_get_static_style (child->style));
+      _gtk_css_lookup_init (&prefetch->lookup);
+
+      child->prefetch = prefetch;
+      g_ptr_array_add (pl.nodes, g_object_ref (child));
+    }
+
+  g_hash_table_unref (decls);
+
+  if (pl.nodes->len < PREFETCH_MIN_NODES)
+    {
+      guint i;
+
+      for (i = 0; i < pl.nodes->len; i++)
+        {
+          child = g_ptr_array_index (pl.nodes, i);
+          g_clear_pointer (&child->prefetch, gtk_css_node_prefetch_free);
+        }
+      g_ptr_array_unref (pl.nodes);
+      return NULL;
+    }
+
+  gdk_parallel_task_run (gtk_css_node_prefetch_task, &pl, pl.nodes->len);
+
+  return pl.nodes;
+}
+
 static void
 gtk_css_node_validate_internal (GtkCssNode             *cssnode,
                                 GtkCountingBloomFilter *filter,
                                 gint64                  timestamp)
 {
   GtkCssNode *child;
+  GPtrArray *prefetched = NULL;
   gboolean bloomed = FALSE;
 
   if (!cssnode->invalid)
@@ -1337,11 +1583,25 @@ gtk_css_node_validate_internal (GtkCssNode             *cssnode,
         {
           gtk_css_node_declaration_add_bloom_hashes (cssnode->decl, filter);
           bloomed = TRUE;
+          prefetched = gtk_css_node_prefetch_children (cssnode, filter);
         }
 
       gtk_css_node_validate_internal (child, filter, timestamp);
     }
 
+  if (prefetched)
+    {
+      guint i;
+
+      /* Drop what wasn't used, the lookups point into the providers */
+      for (i = 0; i < prefetched->len; i++)
+        {
+          child = g_ptr_array_index (prefetched, i);
+          g_clear_pointer (&child->prefetch, gtk_css_node_prefetch_free);
+        }
+      g_ptr_array_unref (prefetched);
+    }
+
   if (bloomed)
     gtk_css_node_declaration_remove_bloom_hashes (cssnode->decl, filter);
 }
@@ -1366,8 +1626,12 @@ gtk_css_node_validate (GtkCssNode *cssnode)
       gdk_profiler_end_mark (before,  "css validation", "");
       gdk_profiler_set_int_counter (invalidated_nodes_counter, invalidated_nodes);
       gdk_profiler_set_int_counter (created_styles_counter, created_styles);
+      gdk_profiler_set_int_counter (style_cache_hits_counter, style_cache_hits);
+      gdk_profiler_set_int_counter (style_cache_misses_counter, style_cache_misses);
       invalidated_nodes = 0;
       created_styles = 0;
+      style_cache_hits = 0;
+      style_cache_misses = 0;
     }
 }
 
@@ -1454,3 +1718,30 @@ gtk_css_node_observe_children (GtkCssNode *cssnode)
   return G_LIST_MODEL (cssnode->children_observer);
 }
 
+/* Turns recording of restyle statistics on or off for all nodes.
+ * Statistics that were already recorded are kept.
+ */
+void
+gtk_css_node_set_stats_enabled (gboolean enabled)
+{
+  stats_enabled = enabled;
+}
+
+gboolean
+gtk_css_node_get_stats_enabled (void)
+{
+  return stats_enabled;
+}
+
+/* Returns NULL if the node was not restyled while recording */
+const GtkCssNodeStats *
+gtk_css_node_get_stats (GtkCssNode *cssnode)
+{
+  return cssnode->stats;
+}
+
+void
+gtk_css_node_reset_stats (GtkCssNode *cssnode)
+{
+  g_clear_pointer (&cssnode->stats, g_free);
+}
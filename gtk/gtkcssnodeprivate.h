@@ -35,6 +35,17 @@ G_BEGIN_DECLS
 #define GTK_CSS_NODE_GET_CLASS(obj) (G_TYPE_INSTANCE_GET_CLASS ((obj), GTK_TYPE_CSS_NODE, GtkCssNodeClass))
 
 typedef struct _GtkCssNodeClass         GtkCssNodeClass;
+typedef struct _GtkCssNodePrefetch      GtkCssNodePrefetch;
+typedef struct _GtkCssNodeStats         GtkCssNodeStats;
+
+/* Collected while gtk_css_node_set_stats_enabled() is on, for the inspector */
+struct _GtkCssNodeStats
+{
+  guint                  n_restyles;            /* number of times the style was recomputed */
+  guint                  n_changes;             /* number of recomputations that changed the style */
+  gint64                 time;                  /* total time spent recomputing, in µs */
+  GtkCssChange           causes;                /* all changes that caused a recomputation */
+};
 
 struct _GtkCssNode
 {
@@ -51,6 +62,8 @@ struct _GtkCssNode
   GtkCssNodeDeclaration *decl;
   GtkCssStyle           *style;
   GtkCssNodeStyleCache  *cache;                 /* cache for children to look up styles */
+  GtkCssNodePrefetch    *prefetch;              /* selector matches done ahead of computing the style */
+  GtkCssNodeStats       *stats;                 /* restyle statistics or NULL if none were recorded */
 
   GtkCssChange           pending_changes;       /* changes that accumulated since the style was last computed */
 
@@ -167,5 +180,10 @@ void                    gtk_css_node_print              (GtkCssNode           *c
 
 GListModel *            gtk_css_node_observe_children   (GtkCssNode                *cssnode);
 
+void                    gtk_css_node_set_stats_enabled  (gboolean               enabled);
+gboolean                gtk_css_node_get_stats_enabled  (void);
+const GtkCssNodeStats * gtk_css_node_get_stats          (GtkCssNode            *cssnode);
+void                    gtk_css_node_reset_stats        (GtkCssNode            *cssnode);
+
 G_END_DECLS
 
@@ -23,11 +23,29 @@
 #include "gtkcssstaticstyleprivate.h"
 
 struct _GtkCssNodeStyleCache {
-  guint        ref_count;
-  GtkCssStyle *style;
-  GHashTable  *children;
+  guint             ref_count;
+  GtkCssStyle      *style;
+  GtkStyleProvider *provider; /* only a key for shared caches, not a ref */
+  GHashTable       *children;
 };
 
+typedef struct _SharedKey SharedKey;
+
+struct _SharedKey {
+  GtkCssStyle      *style;
+  GtkStyleProvider *provider;
+};
+
+/* Caches of all nodes that have the same parent style and provider
+ * are shared, no matter if the nodes got their style from the same
+ * cache. This keeps siblings sharing their children's styles after one
+ * of them had its cache dropped while keeping its style.
+ *
+ * Only live caches are in here, so this doesn't grow beyond the number
+ * of nodes.
+ */
+static GHashTable *shared_caches;
+
 #define UNPACK_DECLARATION(packed) ((GtkCssNodeDeclaration *) (GPOINTER_TO_SIZE (packed) & ~0x3))
 #define UNPACK_FLAGS(packed) (GPOINTER_TO_SIZE (packed) & 0x3)
 #define PACK(decl, first_child, last_child) GSIZE_TO_POINTER (GPOINTER_TO_SIZE (decl) | ((first_child) ? 0x2 : 0) | ((last_child) ? 0x1 : 0))
@@ -53,6 +71,24 @@ gtk_css_node_style_cache_ref (GtkCssNodeStyleCache *cache)
   return cache;
 }
 
+static guint
+shared_key_hash (gconstpointer data)
+{
+  const SharedKey *key = data;
+
+  return g_direct_hash (key->style) ^ g_direct_hash (key->provider);
+}
+
+static gboolean
+shared_key_equal (gconstpointer a,
+                  gconstpointer b)
+{
+  const SharedKey *ka = a;
+  const SharedKey *kb = b;
+
+  return ka->style == kb->style && ka->provider == kb->provider;
+}
+
 void
 gtk_css_node_style_cache_unref (GtkCssNodeStyleCache *cache)
 {
@@ -61,6 +97,14 @@ gtk_css_node_style_cache_unref (GtkCssNodeStyleCache *cache)
   if (cache->ref_count > 0)
     return;
 
+  if (cache->provider)
+    {
+      SharedKey key = { cache->style, cache->provider };
+
+      if (g_hash_table_lookup (shared_caches, &key) == cache)
+        g_hash_table_remove (shared_caches, &key);
+    }
+
   g_object_unref (cache->style);
   if (cache->children)
     g_hash_table_unref (cache->children);
@@ -68,6 +112,82 @@ gtk_css_node_style_cache_unref (GtkCssNodeStyleCache *cache)
   g_free (cache);
 }
 
+static void
+gtk_css_node_style_cache_share (GtkCssNodeStyleCache *cache,
+                                GtkStyleProvider     *provider)
+{
+  SharedKey *key;
+
+  if (shared_caches == NULL)
+    shared_caches = g_hash_table_new_full (shared_key_hash, shared_key_equal, g_free, NULL);
+
+  key = g_new (SharedKey, 1);
+  key->style = cache->style;
+  key->provider = provider;
+
+  if (g_hash_table_contains (shared_caches, key))
+    {
+      g_free (key);
+      return;
+    }
+
+  cache->provider = provider;
+  g_hash_table_insert (shared_caches, key, cache);
+}
+
+/**
+ * gtk_css_node_style_cache_lookup_shared:
+ * @style: the style of the parent node
+ * @provider: the style provider of the parent node
+ *
+ * Looks up the cache used by other nodes with the same @style and
+ * @provider.
+ *
+ * Returns: (nullable) (transfer full): the cache
+ */
+GtkCssNodeStyleCache *
+gtk_css_node_style_cache_lookup_shared (GtkCssStyle      *style,
+                                        GtkStyleProvider *provider)
+{
+  SharedKey key = { style, provider };
+  GtkCssNodeStyleCache *result;
+
+  if (shared_caches == NULL)
+    return NULL;
+
+  result = g_hash_table_lookup (shared_caches, &key);
+  if (result == NULL)
+    return NULL;
+
+  return gtk_css_node_style_cache_ref (result);
+}
+
+/**
+ * gtk_css_node_style_cache_get_shared:
+ * @style: the style of the parent node
+ * @provider: the style provider of the parent node
+ *
+ * Like gtk_css_node_style_cache_lookup_shared(), but creates
+ * a new cache if none exists yet.
+ *
+ * Returns: (transfer full): the cache
+ */
+GtkCssNodeStyleCache *
+gtk_css_node_style_cache_get_shared (GtkCssStyle      *style,
+                                     GtkStyleProvider *provider)
+{
+  GtkCssNodeStyleCache *result;
+
+  result = gtk_css_node_style_cache_lookup_shared (style, provider);
+  if (result)
+    return result;
+
+  result = gtk_css_node_style_cache_new (style);
+  gtk_css_node_style_cache_share (result, provider);
+
+  return result;
+}
+
 GtkCssStyle *
 gtk_css_node_style_cache_get_style (GtkCssNodeStyleCache *cache)
 {
@@ -154,6 +274,9 @@ gtk_css_node_style_cache_insert (GtkCssNodeStyleCache   *parent,
                                               (GDestroyNotify) gtk_css_node_style_cache_unref);
 
   result = gtk_css_node_style_cache_new (style);
+  /* Children use the provider of their parent, or they don't get here */
+  if (parent->provider)
+    gtk_css_node_style_cache_share (result, parent->provider);
 
   g_hash_table_insert (parent->children,
                        PACK (gtk_css_node_declaration_ref (decl), is_first, is_last),
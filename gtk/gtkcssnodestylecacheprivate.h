@@ -19,6 +19,7 @@
 
 #include "gtkcssnodedeclarationprivate.h"
 #include "gtkcssstyleprivate.h"
+#include "gtkstyleprovider.h"
 
 G_BEGIN_DECLS
 
@@ -28,6 +29,11 @@ GtkCssNodeStyleCache *  gtk_css_node_style_cache_new            (GtkCssStyle
 GtkCssNodeStyleCache *  gtk_css_node_style_cache_ref            (GtkCssNodeStyleCache   *cache);
 void                    gtk_css_node_style_cache_unref          (GtkCssNodeStyleCache   *cache);
 
+GtkCssNodeStyleCache *  gtk_css_node_style_cache_lookup_shared  (GtkCssStyle            *style,
+                                                                 GtkStyleProvider       *provider);
+GtkCssNodeStyleCache *  gtk_css_node_style_cache_get_shared     (GtkCssStyle            *style,
+                                                                 GtkStyleProvider       *provider);
+
 GtkCssStyle *           gtk_css_node_style_cache_get_style      (GtkCssNodeStyleCache   *cache);
 
 GtkCssNodeStyleCache *  gtk_css_node_style_cache_insert         (GtkCssNodeStyleCache   *parent,
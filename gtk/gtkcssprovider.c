@@ -38,6 +38,7 @@
 
 #include <string.h>
 #include <stdlib.h>
+#include <glib/gstdio.h>
 
 #include <gdk-pixbuf/gdk-pixbuf.h>
 #include "gdk/gdkprofilerprivate.h"
@@ -133,6 +134,9 @@ struct _GtkCssProviderPrivate
   GtkCssSelectorTree *tree;
   GResource *resource;
   char *path;
+
+  /* A provider from the theme cache whose parsed contents we use */
+  GtkCssProvider *shared;
 };
 
 enum {
@@ -142,6 +146,23 @@ enum {
 
 static gboolean gtk_keep_css_sections = FALSE;
 
+/* Named themes are kept parsed for a while, so loading one again, for
+ * another display or when switching back from a variant, doesn't need
+ * to parse it again. The most recently used entry comes first.
+ */
+#define THEME_CACHE_SIZE 4
+
+typedef struct _ThemeCacheEntry ThemeCacheEntry;
+
+struct _ThemeCacheEntry
+{
+  char *key;
+  guint64 mtime;
+  GtkCssProvider *provider;
+};
+
+static GQueue theme_cache = G_QUEUE_INIT;
+
 static guint css_provider_signals[LAST_SIGNAL] = { 0 };
 
 static void gtk_css_provider_finalize (GObject *object);
@@ -405,13 +426,25 @@ gtk_css_provider_init (GtkCssProvider *css_provider)
                                            (GDestroyNotify) _gtk_css_keyframes_unref);
 }
 
+/* Returns the private data that holds the parsed contents of @self */
+static GtkCssProviderPrivate *
+gtk_css_provider_get_data (GtkCssProvider *self)
+{
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (self);
+
+  if (priv->shared)
+    return gtk_css_provider_get_instance_private (priv->shared);
+
+  return priv;
+}
+
 static void
 verify_tree_match_results (GtkCssProvider        *provider,
                            GtkCssNode            *node,
                            GtkCssSelectorMatches *tree_rules)
 {
 #ifdef VERIFY_TREE
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_data (provider);
   GtkCssRuleset *ruleset;
   gboolean should_match;
   int i, j;
@@ -447,9 +480,16 @@ gtk_css_style_provider_get_color (GtkStyleProvider *provider,
                                   const char       *name)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *own = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_data (css_provider);
+  GtkCssValue *color;
+
+  /* Colors from gtk_css_provider_set_color() override shared ones */
+  color = g_hash_table_lookup (own->symbolic_colors, name);
+  if (color == NULL && priv != own)
+    color = g_hash_table_lookup (priv->symbolic_colors, name);
 
-  return g_hash_table_lookup (priv->symbolic_colors, name);
+  return color;
 }
 
 static GtkCssKeyframes *
@@ -457,7 +497,7 @@ gtk_css_style_provider_get_keyframes (GtkStyleProvider *provider,
                                       const char       *name)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_data (css_provider);
 
   return g_hash_table_lookup (priv->keyframes, name);
 }
@@ -470,7 +510,7 @@ gtk_css_style_provider_lookup (GtkStyleProvider             *provider,
                                GtkCssChange                 *change)
 {
   GtkCssProvider *css_provider = GTK_CSS_PROVIDER (provider);
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (css_provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_data (css_provider);
   GtkCssRuleset *ruleset;
   guint j;
   int i;
@@ -547,6 +587,7 @@ gtk_css_provider_finalize (GObject *object)
     }
 
   g_free (priv->path);
+  g_clear_object (&priv->shared);
 
   G_OBJECT_CLASS (gtk_css_provider_parent_class)->finalize (object);
 }
@@ -609,6 +650,8 @@ gtk_css_provider_reset (GtkCssProvider *css_provider)
       priv->path = NULL;
     }
 
+  g_clear_object (&priv->shared);
+
   g_hash_table_remove_all (priv->symbolic_colors);
   g_hash_table_remove_all (priv->keyframes);
 
@@ -1019,6 +1062,43 @@ gtk_css_provider_postprocess (GtkCssProvider *css_provider)
   gdk_profiler_end_mark (before, "create selector tree", NULL);
 }
 
+/* Map local files instead of reading them, so their contents
+ * are not copied into the heap. Resources are not copied by
+ * g_file_load_bytes() either, their bytes point into the mapped
+ * resource data.
+ *
+ * The bytes are only kept while parsing, sections just refer
+ * to the file and a location in it.
+ */
+static GBytes *
+gtk_css_provider_load_file_bytes (GFile   *file,
+                                  GError **error)
+{
+  char *path;
+
+  path = g_file_get_path (file);
+  if (path != NULL)
+    {
+      GMappedFile *map;
+
+      map = g_mapped_file_new (path, FALSE, NULL);
+      g_free (path);
+
+      if (map != NULL)
+        {
+          GBytes *bytes;
+
+          bytes = g_mapped_file_get_bytes (map);
+          g_mapped_file_unref (map);
+
+          return bytes;
+        }
+    }
+
+  /* Fall back to GIO, also for a proper error */
+  return g_file_load_bytes (file, NULL, NULL, error);
+}
+
 static void
 gtk_css_provider_load_internal (GtkCssProvider *self,
                                 GtkCssScanner  *parent,
@@ -1033,7 +1113,7 @@ gtk_css_provider_load_internal (GtkCssProvider *self,
     {
       GError *load_error = NULL;
 
-      bytes = g_file_load_bytes (file, NULL, NULL, &load_error);
+      bytes = gtk_css_provider_load_file_bytes (file, &load_error);
 
       if (bytes == NULL)
         {
@@ -1269,7 +1349,7 @@ _gtk_get_theme_dir (void)
 const char *
 _gtk_css_provider_get_theme_dir (GtkCssProvider *provider)
 {
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_data (provider);
 
   return priv->path;
 }
@@ -1367,6 +1447,158 @@ _gtk_css_find_theme (const char *name,
   return path;
 }
 
+static void
+theme_cache_entry_free (ThemeCacheEntry *entry)
+{
+  g_free (entry->key);
+  g_object_unref (entry->provider);
+  g_free (entry);
+}
+
+static guint64
+theme_cache_get_mtime (const char *path)
+{
+  GStatBuf buf;
+
+  if (path == NULL || g_stat (path, &buf) != 0)
+    return 0;
+
+  return buf.st_mtime;
+}
+
+static GtkCssProvider *
+theme_cache_lookup (const char *key,
+                    guint64     mtime)
+{
+  GList *l;
+
+  for (l = theme_cache.head; l; l = l->next)
+    {
+      ThemeCacheEntry *entry = l->data;
+
+      if (strcmp (entry->key, key) != 0)
+        continue;
+
+      if (entry->mtime != mtime)
+        {
+          g_queue_delete_link (&theme_cache, l);
+          theme_cache_entry_free (entry);
+          return NULL;
+        }
+
+      g_queue_unlink (&theme_cache, l);
+      g_queue_push_head_link (&theme_cache, l);
+
+      return entry->provider;
+    }
+
+  return NULL;
+}
+
+static void
+theme_cache_insert (const char     *key,
+                    guint64         mtime,
+                    GtkCssProvider *provider)
+{
+  ThemeCacheEntry *entry;
+
+  entry = g_new (ThemeCacheEntry, 1);
+  entry->key = g_strdup (key);
+  entry->mtime = mtime;
+  entry->provider = g_object_ref (provider);
+
+  g_queue_push_head (&theme_cache, entry);
+
+  while (theme_cache.length > THEME_CACHE_SIZE)
+    theme_cache_entry_free (g_queue_pop_tail (&theme_cache));
+}
+
+/*< private >
+ * gtk_css_provider_trim_theme_cache:
+ *
+ * Drops the parsed themes that are kept around for reuse. Themes
+ * that are in use stay alive, they are only not shared anymore.
+ */
+void
+gtk_css_provider_trim_theme_cache (void)
+{
+  g_queue_clear_full (&theme_cache, (GDestroyNotify) theme_cache_entry_free);
+}
+
+static void
+forward_parsing_error (GtkCssProvider *cached,
+                       GtkCssSection  *section,
+                       const GError   *error,
+                       GtkCssProvider *provider)
+{
+  g_signal_emit (provider, css_provider_signals[PARSING_ERROR], 0, section, error);
+}
+
+static void
+gtk_css_provider_load_named_for_real (GtkCssProvider *provider,
+                                      const char     *key,
+                                      const char     *resource_path,
+                                      const char     *path)
+{
+  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProvider *cached;
+  guint64 mtime = 0;
+  gulong handler;
+
+  /* Sections refer to the provider that parsed them, so only share
+   * when nobody asked for them.
+   */
+  if (gtk_keep_css_sections)
+    cached = NULL;
+  else
+    {
+      mtime = theme_cache_get_mtime (path);
+      cached = theme_cache_lookup (key, mtime);
+    }
+
+  if (cached == NULL)
+    {
+      cached = gtk_css_provider_new ();
+      handler = g_signal_connect (cached, "parsing-error", G_CALLBACK (forward_parsing_error), provider);
+
+      if (resource_path)
+        gtk_css_provider_load_from_resource (cached, resource_path);
+      else
+        {
+          GtkCssProviderPrivate *cached_priv = gtk_css_provider_get_instance_private (cached);
+          char *dir, *resource_file;
+          GResource *resource;
+
+          dir = g_path_get_dirname (path);
+          resource_file = g_build_filename (dir, "gtk.gresource", NULL);
+          resource = g_resource_load (resource_file, NULL);
+          g_free (resource_file);
+
+          if (resource != NULL)
+            g_resources_register (resource);
+
+          gtk_css_provider_load_from_path (cached, path);
+
+          /* Only set this after load, as load_from_path will clear it */
+          cached_priv->resource = resource;
+          cached_priv->path = dir;
+        }
+
+      g_signal_handler_disconnect (cached, handler);
+
+      if (!gtk_keep_css_sections)
+        theme_cache_insert (key, mtime, cached);
+
+      priv->shared = cached;
+    }
+  else
+    {
+      priv->shared = g_object_ref (cached);
+    }
+
+  gtk_style_provider_changed (GTK_STYLE_PROVIDER (provider));
+}
+
 /**
  * gtk_css_provider_load_named:
  * @provider: a `GtkCssProvider`
@@ -1403,7 +1635,7 @@ gtk_css_provider_load_named (GtkCssProvider *provider,
 
   if (g_resources_get_info (resource_path, 0, NULL, NULL, NULL))
     {
-      gtk_css_provider_load_from_resource (provider, resource_path);
+      gtk_css_provider_load_named_for_real (provider, resource_path, resource_path, NULL);
       g_free (resource_path);
       return;
     }
@@ -1413,24 +1645,7 @@ gtk_css_provider_load_named (GtkCssProvider *provider,
   path = _gtk_css_find_theme (name, variant);
   if (path)
     {
-      GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
-      char *dir, *resource_file;
-      GResource *resource;
-
-      dir = g_path_get_dirname (path);
-      resource_file = g_build_filename (dir, "gtk.gresource", NULL);
-      resource = g_resource_load (resource_file, NULL);
-      g_free (resource_file);
-
-      if (resource != NULL)
-        g_resources_register (resource);
-
-      gtk_css_provider_load_from_path (provider, path);
-
-      /* Only set this after load, as load_from_path will clear it */
-      priv->resource = resource;
-      priv->path = dir;
-
+      gtk_css_provider_load_named_for_real (provider, path, NULL, path);
       g_free (path);
     }
   else
@@ -1462,6 +1677,55 @@ gtk_css_provider_load_named (GtkCssProvider *provider,
     }
 }
 
+/**
+ * gtk_css_provider_set_color:
+ * @css_provider: a `GtkCssProvider`
+ * @name: the name of the color
+ * @color: the new value for the color
+ *
+ * Sets the named color @name, as if it had been defined with
+ * `@define-color` in the loaded CSS.
+ *
+ * This is meant for colors that change at runtime, like accent colors.
+ * Unlike loading changed CSS, it does not need to parse the CSS again
+ * or rebuild the selectors, while styles referring to @name as
+ * `@name` pick up the new value.
+ *
+ * The color stays set until @css_provider gets loaded again.
+ *
+ * Since: 4.14
+ */
+void
+gtk_css_provider_set_color (GtkCssProvider *css_provider,
+                            const char     *name,
+                            const GdkRGBA  *color)
+{
+  GtkCssProviderPrivate *priv;
+  GtkCssValue *value, *old;
+
+  g_return_if_fail (GTK_IS_CSS_PROVIDER (css_provider));
+  g_return_if_fail (name != NULL);
+  g_return_if_fail (color != NULL);
+
+  /* Set it on ourselves even when sharing parsed data with other
+   * providers, our own colors take precedence when looking them up.
+   */
+  priv = gtk_css_provider_get_instance_private (css_provider);
+
+  value = _gtk_css_color_value_new_literal (color);
+
+  old = gtk_css_style_provider_get_color (GTK_STYLE_PROVIDER (css_provider), name);
+  if (old && _gtk_css_value_equal (old, value))
+    {
+      _gtk_css_value_unref (value);
+      return;
+    }
+
+  g_hash_table_insert (priv->symbolic_colors, g_strdup (name), value);
+
+  gtk_style_provider_changed (GTK_STYLE_PROVIDER (css_provider));
+}
+
 static int
 compare_properties (gconstpointer a, gconstpointer b, gpointer style)
 {
@@ -1578,15 +1842,36 @@ gtk_css_provider_print_keyframes (GHashTable *keyframes,
 char *
 gtk_css_provider_to_string (GtkCssProvider *provider)
 {
-  GtkCssProviderPrivate *priv = gtk_css_provider_get_instance_private (provider);
+  GtkCssProviderPrivate *priv, *own;
   GString *str;
   guint i;
 
   g_return_val_if_fail (GTK_IS_CSS_PROVIDER (provider), NULL);
 
+  priv = gtk_css_provider_get_data (provider);
+
   str = g_string_new ("");
 
-  gtk_css_provider_print_colors (priv->symbolic_colors, str);
+  own = gtk_css_provider_get_instance_private (provider);
+  if (own != priv && g_hash_table_size (own->symbolic_colors) > 0)
+    {
+      GHashTable *colors;
+      GHashTableIter iter;
+      gpointer name, color;
+
+      colors = g_hash_table_new (g_str_hash, g_str_equal);
+      g_hash_table_iter_init (&iter, priv->symbolic_colors);
+      while (g_hash_table_iter_next (&iter, &name, &color))
+        g_hash_table_insert (colors, name, color);
+      g_hash_table_iter_init (&iter, own->symbolic_colors);
+      while (g_hash_table_iter_next (&iter, &name, &color))
+        g_hash_table_insert (colors, name, color);
+
+      gtk_css_provider_print_colors (colors, str);
+      g_hash_table_unref (colors);
+    }
+  else
+    gtk_css_provider_print_colors (priv->symbolic_colors, str);
   gtk_css_provider_print_keyframes (priv->keyframes, str);
 
   for (i = 0; i < priv->rulesets->len; i++)
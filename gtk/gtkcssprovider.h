@@ -18,6 +18,7 @@
 #pragma once
 
 #include <gio/gio.h>
+#include <gdk/gdk.h>
 #include <gtk/css/gtkcss.h>
 
 G_BEGIN_DECLS
@@ -73,6 +74,11 @@ void             gtk_css_provider_load_named     (GtkCssProvider  *provider,
                                                   const char      *name,
                                                   const char      *variant);
 
+GDK_AVAILABLE_IN_4_14
+void             gtk_css_provider_set_color      (GtkCssProvider  *css_provider,
+                                                  const char      *name,
+                                                  const GdkRGBA   *color);
+
 G_DEFINE_AUTOPTR_CLEANUP_FUNC(GtkCssProvider, g_object_unref)
 
 G_END_DECLS
@@ -26,6 +26,7 @@ char *_gtk_get_theme_dir (void);
 const char *_gtk_css_provider_get_theme_dir (GtkCssProvider *provider);
 
 void   gtk_css_provider_set_keep_css_sections (void);
+void   gtk_css_provider_trim_theme_cache      (void);
 
 G_END_DECLS
 
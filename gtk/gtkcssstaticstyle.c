@@ -171,6 +171,30 @@ static const int other_props[] = {
 
 #define GET_VALUES(v) (GtkCssValue **)((guint8*)(v) + sizeof (GtkCssValues))
 
+/* Properties that were not set and are not inherited get their
+ * initial value. Computing that gives the same value as in the
+ * group's initial values for everything but border widths, which
+ * depend on the border style, so take it from there instead of
+ * computing it again for every style that sets some other property
+ * of the group.
+ */
+static inline gboolean
+gtk_css_static_style_can_share_initial (guint id)
+{
+  switch (id)
+    {
+    case GTK_CSS_PROPERTY_BORDER_TOP_WIDTH:
+    case GTK_CSS_PROPERTY_BORDER_RIGHT_WIDTH:
+    case GTK_CSS_PROPERTY_BORDER_BOTTOM_WIDTH:
+    case GTK_CSS_PROPERTY_BORDER_LEFT_WIDTH:
+    case GTK_CSS_PROPERTY_OUTLINE_WIDTH:
+      return FALSE;
+
+    default:
+      return !_gtk_css_style_property_is_inherit (_gtk_css_style_property_lookup_by_id (id));
+    }
+}
+
 #define DEFINE_VALUES(ENUM, TYPE, NAME) \
 void \
 gtk_css_## NAME ## _values_compute_changes_and_affects (GtkCssStyle *style1, \
@@ -194,6 +218,8 @@ gtk_css_## NAME ## _values_compute_changes_and_affects (GtkCssStyle *style1, \
     } \
 } \
 \
+static GtkCssValues * gtk_css_ ## NAME ## _initial_values; \
+\
 static inline void \
 gtk_css_ ## NAME ## _values_new_compute (GtkCssStaticStyle *sstyle, \
                                          GtkStyleProvider *provider, \
@@ -201,13 +227,26 @@ gtk_css_ ## NAME ## _values_new_compute (GtkCssStaticStyle *sstyle, \
                                          GtkCssLookup *lookup) \
 { \
   GtkCssStyle *style = (GtkCssStyle *)sstyle; \
+  GtkCssValue **initial, **values; \
   int i; \
 \
   style->NAME = (GtkCss ## TYPE ## Values *)gtk_css_values_new (GTK_CSS_ ## ENUM ## _VALUES); \
+  values = GET_VALUES (style->NAME); \
+  if (gtk_css_ ## NAME ## _initial_values) \
+    initial = GET_VALUES (gtk_css_ ## NAME ## _initial_values); \
+  else \
+    initial = NULL; \
 \
   for (i = 0; i < G_N_ELEMENTS (NAME ## _props); i++) \
     { \
       guint id = NAME ## _props[i]; \
+      if (initial && initial[i] && \
+          lookup->values[id].value == NULL && \
+          gtk_css_static_style_can_share_initial (id)) \
+        { \
+          values[i] = gtk_css_value_ref (initial[i]); \
+          continue; \
+        } \
       gtk_css_static_style_compute_value (sstyle, \
                                           provider, \
                                           parent_style, \
@@ -215,9 +254,10 @@ gtk_css_ ## NAME ## _values_new_compute (GtkCssStaticStyle *sstyle, \
                                           lookup->values[id].value, \
                                           lookup->values[id].section); \
     } \
+\
+  style->NAME = (GtkCss ## TYPE ## Values *)gtk_css_values_intern ((GtkCssValues *)style->NAME); \
 } \
 static GtkBitmask * gtk_css_ ## NAME ## _values_mask; \
-static GtkCssValues * gtk_css_ ## NAME ## _initial_values; \
 \
 static GtkCssValues * gtk_css_ ## NAME ## _create_initial_values (void); \
 \
@@ -1001,9 +1041,8 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
                                   GtkCssNode                   *node,
                                   GtkCssChange                  change)
 {
-  GtkCssStaticStyle *result;
+  GtkCssStyle *result;
   GtkCssLookup lookup;
-  GtkCssNode *parent;
 
   _gtk_css_lookup_init (&lookup);
 
@@ -1014,6 +1053,36 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
                                &lookup,
                                change == 0 ? &change : NULL);
 
+  result = gtk_css_static_style_new_for_lookup (provider, node, &lookup, change);
+
+  _gtk_css_lookup_destroy (&lookup);
+
+  return result;
+}
+
+/*
+ * gtk_css_static_style_new_for_lookup:
+ * @provider: the style provider the lookup was done with
+ * @node: (nullable): the node the lookup was done for
+ * @lookup: the result of gtk_style_provider_lookup()
+ * @change: the change flags for the new style
+ *
+ * Computes a style from the winning declarations in @lookup.
+ *
+ * This is the second half of gtk_css_static_style_new_compute(),
+ * for callers that did the selector matching themselves.
+ *
+ * Returns: (transfer full): the new style
+ */
+GtkCssStyle *
+gtk_css_static_style_new_for_lookup (GtkStyleProvider *provider,
+                                     GtkCssNode       *node,
+                                     GtkCssLookup     *lookup,
+                                     GtkCssChange      change)
+{
+  GtkCssStaticStyle *result;
+  GtkCssNode *parent;
+
   result = g_object_new (GTK_TYPE_CSS_STATIC_STYLE, NULL);
 
   result->change = change;
@@ -1023,13 +1092,11 @@ gtk_css_static_style_new_compute (GtkStyleProvider             *provider,
   else
     parent = NULL;
 
-  gtk_css_lookup_resolve (&lookup,
+  gtk_css_lookup_resolve (lookup,
                           provider,
                           result,
                           parent ? gtk_css_node_get_style (parent) : NULL);
 
-  _gtk_css_lookup_destroy (&lookup);
-
   return GTK_CSS_STYLE (result);
 }
 
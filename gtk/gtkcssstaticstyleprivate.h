@@ -56,6 +56,10 @@ GtkCssStyle *           gtk_css_static_style_new_compute        (GtkStyleProvide
                                                                  const GtkCountingBloomFilter   *filter,
                                                                  GtkCssNode                     *node,
                                                                  GtkCssChange                    change);
+GtkCssStyle *           gtk_css_static_style_new_for_lookup     (GtkStyleProvider               *provider,
+                                                                 GtkCssNode                     *node,
+                                                                 struct _GtkCssLookup           *lookup,
+                                                                 GtkCssChange                    change);
 GtkCssChange            gtk_css_static_style_get_change         (GtkCssStaticStyle              *style);
 
 G_END_DECLS
@@ -40,6 +40,8 @@
 #include "gtkstylepropertyprivate.h"
 #include "gtkstyleproviderprivate.h"
 
+#include <string.h>
+
 G_DEFINE_ABSTRACT_TYPE (GtkCssStyle, gtk_css_style, G_TYPE_OBJECT)
 
 static GtkCssSection *
@@ -73,6 +75,9 @@ gtk_css_style_finalize (GObject *object)
   gtk_css_values_unref ((GtkCssValues *)style->size);
   gtk_css_values_unref ((GtkCssValues *)style->other);
 
+  g_clear_pointer (&style->background_node, gsk_render_node_unref);
+  g_clear_pointer (&style->border_node, gsk_render_node_unref);
+
   G_OBJECT_CLASS (gtk_css_style_parent_class)->finalize (object);
 }
 
@@ -772,6 +777,41 @@ static const int values_size[] = {
 
 #define GET_VALUES(v) (GtkCssValue **)((guint8 *)(v) + sizeof (GtkCssValues))
 
+/* Value structs that styles computed and that may be shared by others
+ * with the same values, see gtk_css_values_intern()
+ */
+static GHashTable *interned_values;
+
+static guint
+gtk_css_values_hash (gconstpointer data)
+{
+  const GtkCssValues *values = data;
+  GtkCssValue **v = GET_VALUES (values);
+  guint hash;
+  int i;
+
+  hash = values->type;
+  for (i = 0; i < N_VALUES (values->type); i++)
+    hash = (hash << 5) - hash + GPOINTER_TO_UINT (v[i]);
+
+  return hash;
+}
+
+static gboolean
+gtk_css_values_equal (gconstpointer data1,
+                      gconstpointer data2)
+{
+  const GtkCssValues *values1 = data1;
+  const GtkCssValues *values2 = data2;
+
+  if (values1->type != values2->type)
+    return FALSE;
+
+  return memcmp (GET_VALUES (values1),
+                 GET_VALUES (values2),
+                 N_VALUES (values1->type) * sizeof (GtkCssValue *)) == 0;
+}
+
 GtkCssValues *gtk_css_values_ref (GtkCssValues *values)
 {
   values->ref_count++;
@@ -785,6 +825,10 @@ gtk_css_values_free (GtkCssValues *values)
   int i;
   GtkCssValue **v = GET_VALUES (values);
 
+  if (interned_values &&
+      g_hash_table_lookup (interned_values, values) == values)
+    g_hash_table_remove (interned_values, values);
+
   for (i = 0; i < N_VALUES (values->type); i++)
     {
       if (v[i])
@@ -826,6 +870,40 @@ gtk_css_values_copy (GtkCssValues *values)
   return copy;
 }
 
+/*< private >
+ * gtk_css_values_intern:
+ * @values: (transfer full): values that are not going to be changed anymore
+ *
+ * Looks for a struct holding the same values as @values and returns
+ * it instead if one exists, so styles that compute the same values
+ * for a group of properties share the memory for them.
+ *
+ * Values are compared by identity. That catches what matters, since
+ * values taken from the same declaration, inherited or initial values
+ * are usually the same objects.
+ *
+ * Returns: (transfer full): @values or an equal struct
+ */
+GtkCssValues *
+gtk_css_values_intern (GtkCssValues *values)
+{
+  GtkCssValues *interned;
+
+  if (interned_values == NULL)
+    interned_values = g_hash_table_new (gtk_css_values_hash, gtk_css_values_equal);
+
+  interned = g_hash_table_lookup (interned_values, values);
+  if (interned)
+    {
+      gtk_css_values_unref (values);
+      return gtk_css_values_ref (interned);
+    }
+
+  g_hash_table_add (interned_values, values);
+
+  return values;
+}
+
 GtkCssValues *
 gtk_css_values_new (GtkCssValuesType type)
 {
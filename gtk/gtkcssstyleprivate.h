@@ -20,6 +20,7 @@
 #pragma once
 
 #include <glib-object.h>
+#include <gsk/gsk.h>
 #include <gtk/css/gtkcss.h>
 
 #include "gtk/gtkbitmaskprivate.h"
@@ -232,6 +233,15 @@ struct _GtkCssStyle
   GtkCssTransitionValues  *transition;
   GtkCssSizeValues        *size;
   GtkCssOtherValues       *other;
+
+  /* The nodes of the last background and border snapshot and the
+   * border box they were created for, see gtkrenderbackground.c
+   * and gtkrenderborder.c
+   */
+  GskRenderNode           *background_node;
+  graphene_rect_t          background_rect;
+  GskRenderNode           *border_node;
+  graphene_rect_t          border_rect;
 };
 
 struct _GtkCssStyleClass
@@ -268,10 +278,11 @@ char *                  gtk_css_style_compute_font_features     (GtkCssStyle
 PangoAttrList *         gtk_css_style_get_pango_attributes      (GtkCssStyle            *style);
 PangoFontDescription *  gtk_css_style_get_pango_font            (GtkCssStyle            *style);
 
-GtkCssValues *gtk_css_values_new   (GtkCssValuesType  type);
-GtkCssValues *gtk_css_values_ref   (GtkCssValues     *values);
-void          gtk_css_values_unref (GtkCssValues     *values);
-GtkCssValues *gtk_css_values_copy  (GtkCssValues     *values);
+GtkCssValues *gtk_css_values_new    (GtkCssValuesType  type);
+GtkCssValues *gtk_css_values_ref    (GtkCssValues     *values);
+void          gtk_css_values_unref  (GtkCssValues     *values);
+GtkCssValues *gtk_css_values_copy   (GtkCssValues     *values);
+GtkCssValues *gtk_css_values_intern (GtkCssValues     *values);
 
 void gtk_css_core_values_compute_changes_and_affects (GtkCssStyle *style1,
                                                       GtkCssStyle *style2,
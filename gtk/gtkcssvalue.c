@@ -23,6 +23,8 @@
 #include "gtkcssstyleprivate.h"
 #include "gtkstyleproviderprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 struct _GtkCssValue {
   GTK_CSS_VALUE_BASE
 };
@@ -147,6 +149,16 @@ _gtk_css_value_alloc (const GtkCssValueClass *klass,
   value->class = klass;
   value->ref_count = 1;
 
+#ifdef G_ENABLE_DEBUG
+  {
+    static guint allocation_counter;
+
+    if (G_UNLIKELY (allocation_counter == 0))
+      allocation_counter = gdk_profiler_define_allocation_counter ("css value allocations", "CSS values created per frame");
+    gdk_profiler_count_allocation (allocation_counter);
+  }
+#endif
+
 #ifdef CSS_VALUE_ACCOUNTING
   {
     ValueAccounting *c;
@@ -53,6 +53,7 @@ G_BEGIN_DECLS
  * @GTK_DEBUG_BUILDER_OBJECTS: Log unused GtkBuilder objects
  * @GTK_DEBUG_A11Y: Information about accessibility state changes
  * @GTK_DEBUG_ICONFALLBACK: Information about icon fallback. Since: 4.2
+ * @GTK_DEBUG_STARTUP: Print a summary of the startup phases. Since: 4.14
  *
  * Flags to use with gtk_set_debug_flags().
  *
@@ -80,6 +81,7 @@ typedef enum {
   GTK_DEBUG_A11Y            = 1 << 17,
   GTK_DEBUG_ICONFALLBACK    = 1 << 18,
   GTK_DEBUG_INVERT_TEXT_DIR = 1 << 19,
+  GTK_DEBUG_STARTUP         = 1 << 20,
 } GtkDebugFlags;
 
 #ifdef G_ENABLE_DEBUG
@@ -48,18 +48,34 @@
  * This means you do not need access to the `GtkDirectoryList`, but can access
  * the `GFile` directly from the `GFileInfo` when operating with a `GtkListView`
  * or similar.
+ *
+ * Files are queried in batches, see [property@Gtk.DirectoryList:batch-size],
+ * and the files found are added to the list at most once per main loop
+ * iteration, so that a directory with many files does not flood the
+ * views with ::items-changed signals.
+ *
+ * Attributes that are expensive to query, like thumbnails or the content
+ * type, can be set as [property@Gtk.DirectoryList:lazy-attributes]. They
+ * are then only queried for the items that are actually requested from the
+ * list, and the item is replaced with one containing the additional
+ * attributes once they have been loaded.
  */
 
 /* random number that everyone else seems to use, too */
 #define FILES_PER_QUERY 100
 
+/* maximum time we hold back new files before adding them */
+#define MAX_FLUSH_DELAY (16 * G_TIME_SPAN_MILLISECOND)
+
 enum {
   PROP_0,
   PROP_ATTRIBUTES,
+  PROP_BATCH_SIZE,
   PROP_ERROR,
   PROP_FILE,
   PROP_IO_PRIORITY,
   PROP_ITEM_TYPE,
+  PROP_LAZY_ATTRIBUTES,
   PROP_LOADING,
   PROP_MONITORED,
   PROP_N_ITEMS,
@@ -86,20 +102,36 @@ free_queued_event (gpointer data)
   g_free (event);
 }
 
+typedef struct _LazyQuery LazyQuery;
+struct _LazyQuery
+{
+  GtkDirectoryList *list;
+  GSequenceIter *iter; /* NULL if the item is gone */
+};
+
 struct _GtkDirectoryList
 {
   GObject parent_instance;
 
   char *attributes;
+  char *lazy_attributes;
   GFile *file;
   GFileMonitor *monitor;
   gboolean monitored;
   int io_priority;
+  guint batch_size;
 
   GCancellable *cancellable;
   GError *error; /* Error while loading */
   GSequence *items; /* Use GPtrArray or GListStore here? */
   GQueue events;
+
+  GPtrArray *pending; /* loaded files not yet added to items */
+  gint64 pending_since;
+  guint flush_cb; /* idle callback handle */
+
+  GCancellable *lazy_cancellable;
+  GHashTable *lazy_queries; /* GSequenceIter => LazyQuery */
 };
 
 struct _GtkDirectoryListClass
@@ -108,6 +140,10 @@ struct _GtkDirectoryListClass
 };
 
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
+static GQuark lazy_quark;
+
+static void gtk_directory_list_query_lazy (GtkDirectoryList *self,
+                                           GSequenceIter    *iter);
 
 static GType
 gtk_directory_list_get_item_type (GListModel *list)
@@ -130,12 +166,18 @@ gtk_directory_list_get_item (GListModel *list,
   GtkDirectoryList *self = GTK_DIRECTORY_LIST (list);
   GSequenceIter *iter;
 
+  GFileInfo *info;
+
   iter = g_sequence_get_iter_at_pos (self->items, position);
 
   if (g_sequence_iter_is_end (iter))
     return NULL;
-  else
-    return g_object_ref (g_sequence_get (iter));
+
+  info = g_sequence_get (iter);
+  if (self->lazy_attributes && !g_object_get_qdata (G_OBJECT (info), lazy_quark))
+    gtk_directory_list_query_lazy (self, iter);
+
+  return g_object_ref (info);
 }
 
 static void
@@ -162,6 +204,11 @@ gtk_directory_list_set_property (GObject      *object,
     case PROP_ATTRIBUTES:
       gtk_directory_list_set_attributes (self, g_value_get_string (value));
       break;
+
+    case PROP_BATCH_SIZE:
+      gtk_directory_list_set_batch_size (self, g_value_get_uint (value));
+      break;
+
     case PROP_FILE:
       gtk_directory_list_set_file (self, g_value_get_object (value));
       break;
@@ -170,6 +217,10 @@ gtk_directory_list_set_property (GObject      *object,
       gtk_directory_list_set_io_priority (self, g_value_get_int (value));
       break;
 
+    case PROP_LAZY_ATTRIBUTES:
+      gtk_directory_list_set_lazy_attributes (self, g_value_get_string (value));
+      break;
+
     case PROP_MONITORED:
       gtk_directory_list_set_monitored (self, g_value_get_boolean (value));
       break;
@@ -194,6 +245,10 @@ gtk_directory_list_get_property (GObject     *object,
       g_value_set_string (value, self->attributes);
       break;
 
+    case PROP_BATCH_SIZE:
+      g_value_set_uint (value, self->batch_size);
+      break;
+
     case PROP_ERROR:
       g_value_set_boxed (value, self->error);
       break;
@@ -210,6 +265,10 @@ gtk_directory_list_get_property (GObject     *object,
       g_value_set_gtype (value, G_TYPE_FILE_INFO);
       break;
 
+    case PROP_LAZY_ATTRIBUTES:
+      g_value_set_string (value, self->lazy_attributes);
+      break;
+
     case PROP_LOADING:
       g_value_set_boolean (value, gtk_directory_list_is_loading (self));
       break;
@@ -239,6 +298,38 @@ gtk_directory_list_stop_loading (GtkDirectoryList *self)
   return TRUE;
 }
 
+static void
+gtk_directory_list_forget_iter (GtkDirectoryList *self,
+                                GSequenceIter    *iter)
+{
+  LazyQuery *query;
+
+  query = g_hash_table_lookup (self->lazy_queries, iter);
+  if (query == NULL)
+    return;
+
+  query->iter = NULL;
+  g_hash_table_remove (self->lazy_queries, iter);
+}
+
+static void
+gtk_directory_list_stop_lazy_queries (GtkDirectoryList *self)
+{
+  GHashTableIter iter;
+  gpointer query;
+
+  if (self->lazy_cancellable == NULL)
+    return;
+
+  g_hash_table_iter_init (&iter, self->lazy_queries);
+  while (g_hash_table_iter_next (&iter, NULL, &query))
+    ((LazyQuery *) query)->iter = NULL;
+  g_hash_table_remove_all (self->lazy_queries);
+
+  g_cancellable_cancel (self->lazy_cancellable);
+  g_clear_object (&self->lazy_cancellable);
+}
+
 static void directory_changed (GFileMonitor       *monitor,
                                GFile              *file,
                                GFile              *other_file,
@@ -260,12 +351,17 @@ gtk_directory_list_dispose (GObject *object)
 
   gtk_directory_list_stop_loading (self);
   gtk_directory_list_stop_monitoring (self);
+  gtk_directory_list_stop_lazy_queries (self);
+  g_clear_handle_id (&self->flush_cb, g_source_remove);
 
   g_clear_object (&self->file);
   g_clear_pointer (&self->attributes, g_free);
+  g_clear_pointer (&self->lazy_attributes, g_free);
 
   g_clear_error (&self->error);
   g_clear_pointer (&self->items, g_sequence_free);
+  g_clear_pointer (&self->pending, g_ptr_array_unref);
+  g_clear_pointer (&self->lazy_queries, g_hash_table_unref);
 
   g_queue_foreach (&self->events, (GFunc) free_queued_event, NULL);
   g_queue_clear (&self->events);
@@ -292,6 +388,19 @@ gtk_directory_list_class_init (GtkDirectoryListClass *class)
                            NULL,
                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkDirectoryList:batch-size: (attributes org.gtk.Property.get=gtk_directory_list_get_batch_size org.gtk.Property.set=gtk_directory_list_set_batch_size)
+   *
+   * The number of files to query at once, or 0 to pick a suitable
+   * number automatically.
+   *
+   * Since: 4.14
+   */
+  properties[PROP_BATCH_SIZE] =
+      g_param_spec_uint ("batch-size", NULL, NULL,
+                         0, G_MAXINT, 0,
+                         GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkDirectoryList:error: (attributes org.gtk.Property.get=gtk_directory_list_get_error)
    *
@@ -334,6 +443,18 @@ gtk_directory_list_class_init (GtkDirectoryListClass *class)
                         G_TYPE_FILE_INFO,
                         G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GtkDirectoryList:lazy-attributes: (attributes org.gtk.Property.get=gtk_directory_list_get_lazy_attributes org.gtk.Property.set=gtk_directory_list_set_lazy_attributes)
+   *
+   * Additional attributes to query only for items that are requested.
+   *
+   * Since: 4.14
+   */
+  properties[PROP_LAZY_ATTRIBUTES] =
+      g_param_spec_string ("lazy-attributes", NULL, NULL,
+                           NULL,
+                           GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkDirectoryList:loading: (attributes org.gtk.Property.get=gtk_directory_list_is_loading)
    *
@@ -367,12 +488,16 @@ gtk_directory_list_class_init (GtkDirectoryListClass *class)
                        G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
+
+  lazy_quark = g_quark_from_static_string ("gtk-directory-list-lazy");
 }
 
 static void
 gtk_directory_list_init (GtkDirectoryList *self)
 {
   self->items = g_sequence_new (g_object_unref);
+  self->pending = g_ptr_array_new_with_free_func (g_object_unref);
+  self->lazy_queries = g_hash_table_new (NULL, NULL);
   self->io_priority = G_PRIORITY_DEFAULT;
   self->monitored = TRUE;
   g_queue_init (&self->events);
@@ -407,6 +532,10 @@ gtk_directory_list_clear_items (GtkDirectoryList *self)
 {
   guint n_items;
 
+  g_clear_handle_id (&self->flush_cb, g_source_remove);
+  g_ptr_array_set_size (self->pending, 0);
+  gtk_directory_list_stop_lazy_queries (self);
+
   n_items = g_sequence_get_length (self->items);
   if (n_items > 0)
     {
@@ -424,6 +553,65 @@ gtk_directory_list_clear_items (GtkDirectoryList *self)
     }
 }
 
+static void
+gtk_directory_list_flush_pending (GtkDirectoryList *self)
+{
+  guint i, n;
+
+  g_clear_handle_id (&self->flush_cb, g_source_remove);
+
+  n = self->pending->len;
+  if (n == 0)
+    return;
+
+  for (i = 0; i < n; i++)
+    g_sequence_append (self->items, g_object_ref (g_ptr_array_index (self->pending, i)));
+  g_ptr_array_set_size (self->pending, 0);
+
+  g_list_model_items_changed (G_LIST_MODEL (self), g_sequence_get_length (self->items) - n, 0, n);
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+}
+
+static gboolean
+gtk_directory_list_flush_cb (gpointer data)
+{
+  GtkDirectoryList *self = data;
+
+  self->flush_cb = 0;
+  gtk_directory_list_flush_pending (self);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_directory_list_queue_flush (GtkDirectoryList *self)
+{
+  /* Flush either right before the next frame is drawn or, if loading
+   * keeps the main loop busy, when files have been held back for
+   * longer than a frame.
+   */
+  if (g_get_monotonic_time () - self->pending_since >= MAX_FLUSH_DELAY)
+    {
+      gtk_directory_list_flush_pending (self);
+      return;
+    }
+
+  if (self->flush_cb)
+    return;
+
+  self->flush_cb = g_idle_add_full (GDK_PRIORITY_REDRAW - 1, gtk_directory_list_flush_cb, self, NULL);
+  gdk_source_set_static_name_by_id (self->flush_cb, "[gtk] gtk_directory_list_flush_cb");
+}
+
+static guint
+gtk_directory_list_get_files_per_query (GtkDirectoryList *self)
+{
+  if (self->batch_size > 0)
+    return self->batch_size;
+
+  return g_file_is_native (self->file) ? 50 * FILES_PER_QUERY : FILES_PER_QUERY;
+}
+
 static void
 gtk_directory_list_enumerator_closed_cb (GObject      *source,
                                          GAsyncResult *res,
@@ -441,7 +629,6 @@ gtk_directory_list_got_files_cb (GObject      *source,
   GFileEnumerator *enumerator = G_FILE_ENUMERATOR (source);
   GError *error = NULL;
   GList *l, *files;
-  guint n;
 
   files = g_file_enumerator_next_files_finish (enumerator, res, &error);
 
@@ -461,6 +648,8 @@ gtk_directory_list_got_files_cb (GObject      *source,
 
       g_object_freeze_notify (G_OBJECT (self));
 
+      gtk_directory_list_flush_pending (self);
+
       g_clear_object (&self->cancellable);
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LOADING]);
 
@@ -474,7 +663,9 @@ gtk_directory_list_got_files_cb (GObject      *source,
       return;
     }
 
-  n = 0;
+  if (self->pending->len == 0)
+    self->pending_since = g_get_monotonic_time ();
+
   for (l = files; l; l = l->next)
     {
       GFileInfo *info;
@@ -484,23 +675,19 @@ gtk_directory_list_got_files_cb (GObject      *source,
       file = g_file_enumerator_get_child (enumerator, info);
       g_file_info_set_attribute_object (info, "standard::file", G_OBJECT (file));
       g_object_unref (file);
-      g_sequence_append (self->items, info);
-      n++;
+      g_ptr_array_add (self->pending, info);
     }
   g_list_free (files);
 
   g_file_enumerator_next_files_async (enumerator,
-                                      g_file_is_native (self->file) ? 50 * FILES_PER_QUERY : FILES_PER_QUERY,
+                                      gtk_directory_list_get_files_per_query (self),
                                       self->io_priority,
                                       self->cancellable,
                                       gtk_directory_list_got_files_cb,
                                       self);
 
-  if (n > 0)
-    {
-      g_list_model_items_changed (G_LIST_MODEL (self), g_sequence_get_length (self->items) - n, 0, n);
-      g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
-    }
+  if (self->pending->len > 0)
+    gtk_directory_list_queue_flush (self);
 }
 
 static void
@@ -532,7 +719,7 @@ gtk_directory_list_got_enumerator_cb (GObject      *source,
     }
 
   g_file_enumerator_next_files_async (enumerator,
-                                      g_file_is_native (file) ? 50 * FILES_PER_QUERY : FILES_PER_QUERY,
+                                      gtk_directory_list_get_files_per_query (self),
                                       self->io_priority,
                                       self->cancellable,
                                       gtk_directory_list_got_files_cb,
@@ -591,6 +778,96 @@ find_file (GSequence *sequence,
   return NULL;
 }
 
+static void
+copy_attributes (GFileInfo *dest,
+                 GFileInfo *src)
+{
+  char **attributes;
+  guint i;
+
+  attributes = g_file_info_list_attributes (src, NULL);
+  for (i = 0; attributes[i]; i++)
+    {
+      GFileAttributeType type;
+      gpointer value;
+
+      if (g_file_info_get_attribute_data (src, attributes[i], &type, &value, NULL))
+        g_file_info_set_attribute (dest, attributes[i], type, value);
+    }
+  g_strfreev (attributes);
+}
+
+static void
+gtk_directory_list_got_lazy_info_cb (GObject      *source,
+                                     GAsyncResult *res,
+                                     gpointer      data)
+{
+  LazyQuery *query = data;
+  GtkDirectoryList *self = query->list; /* invalid if cancelled */
+  GFileInfo *lazy_info, *info;
+  GError *error = NULL;
+  guint position;
+
+  lazy_info = g_file_query_info_finish (G_FILE (source), res, &error);
+  if (g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+    {
+      g_clear_error (&error);
+      g_free (query);
+      return;
+    }
+  g_clear_error (&error);
+
+  if (query->iter && lazy_info)
+    {
+      g_hash_table_remove (self->lazy_queries, query->iter);
+
+      /* Replace the item, so that views notice the new attributes */
+      info = g_file_info_dup (g_sequence_get (query->iter));
+      copy_attributes (info, lazy_info);
+      g_object_set_qdata (G_OBJECT (info), lazy_quark, GINT_TO_POINTER (TRUE));
+
+      position = g_sequence_iter_get_position (query->iter);
+      g_sequence_set (query->iter, info);
+      g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 1);
+    }
+  else if (query->iter)
+    {
+      g_hash_table_remove (self->lazy_queries, query->iter);
+    }
+
+  g_clear_object (&lazy_info);
+  g_free (query);
+}
+
+static void
+gtk_directory_list_query_lazy (GtkDirectoryList *self,
+                               GSequenceIter    *iter)
+{
+  GFileInfo *info = g_sequence_get (iter);
+  LazyQuery *query;
+  GFile *file;
+
+  /* Mark the item, so we only query it once */
+  g_object_set_qdata (G_OBJECT (info), lazy_quark, GINT_TO_POINTER (TRUE));
+
+  if (self->lazy_cancellable == NULL)
+    self->lazy_cancellable = g_cancellable_new ();
+
+  query = g_new (LazyQuery, 1);
+  query->list = self;
+  query->iter = iter;
+  g_hash_table_insert (self->lazy_queries, iter, query);
+
+  file = G_FILE (g_file_info_get_attribute_object (info, "standard::file"));
+  g_file_query_info_async (file,
+                           self->lazy_attributes,
+                           G_FILE_QUERY_INFO_NONE,
+                           self->io_priority,
+                           self->lazy_cancellable,
+                           gtk_directory_list_got_lazy_info_cb,
+                           query);
+}
+
 static gboolean
 handle_event (QueuedEvent *event)
 {
@@ -600,6 +877,9 @@ handle_event (QueuedEvent *event)
   GSequenceIter *iter;
   unsigned int position;
 
+  /* Make sure we find files that are still pending */
+  gtk_directory_list_flush_pending (self);
+
   switch ((int)event->event)
     {
     case G_FILE_MONITOR_EVENT_MOVED_IN:
@@ -613,6 +893,7 @@ handle_event (QueuedEvent *event)
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
+          gtk_directory_list_forget_iter (self, iter);
           g_sequence_set (iter, g_object_ref (info));
           g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 1);
         }
@@ -631,6 +912,7 @@ handle_event (QueuedEvent *event)
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
+          gtk_directory_list_forget_iter (self, iter);
           g_sequence_remove (iter);
           g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 0);
           g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
@@ -647,6 +929,7 @@ handle_event (QueuedEvent *event)
       if (iter)
         {
           position = g_sequence_iter_get_position (iter);
+          gtk_directory_list_forget_iter (self, iter);
           g_sequence_set (iter, g_object_ref (info));
           g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 1);
         }
@@ -949,6 +1232,112 @@ gtk_directory_list_get_io_priority (GtkDirectoryList *self)
   return self->io_priority;
 }
 
+/**
+ * gtk_directory_list_set_batch_size: (attributes org.gtk.Method.set_property=batch-size)
+ * @self: a `GtkDirectoryList`
+ * @batch_size: the number of files to query at once, or 0
+ *
+ * Sets the number of files to query at once while loading directories.
+ *
+ * If @batch_size is 0, a suitable number is chosen depending on
+ * the type of file system. This is the default.
+ *
+ * Files found are still only added to the list once per main
+ * loop iteration, so a small batch size does not cause more
+ * ::items-changed emissions. Setting the batch size while @self
+ * is loading will take effect with the next batch.
+ *
+ * Since: 4.14
+ */
+void
+gtk_directory_list_set_batch_size (GtkDirectoryList *self,
+                                   guint             batch_size)
+{
+  g_return_if_fail (GTK_IS_DIRECTORY_LIST (self));
+  g_return_if_fail (batch_size <= G_MAXINT);
+
+  if (self->batch_size == batch_size)
+    return;
+
+  self->batch_size = batch_size;
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_BATCH_SIZE]);
+}
+
+/**
+ * gtk_directory_list_get_batch_size: (attributes org.gtk.Method.get_property=batch-size)
+ * @self: a `GtkDirectoryList`
+ *
+ * Gets the batch size set via gtk_directory_list_set_batch_size().
+ *
+ * Returns: The batch size, or 0 if it is chosen automatically
+ *
+ * Since: 4.14
+ */
+guint
+gtk_directory_list_get_batch_size (GtkDirectoryList *self)
+{
+  g_return_val_if_fail (GTK_IS_DIRECTORY_LIST (self), 0);
+
+  return self->batch_size;
+}
+
+/**
+ * gtk_directory_list_set_lazy_attributes: (attributes org.gtk.Method.set_property=lazy-attributes)
+ * @self: a `GtkDirectoryList`
+ * @attributes: (nullable): the attributes to query lazily
+ *
+ * Sets additional attributes to query only for items that are
+ * requested from @self, and restarts the enumeration.
+ *
+ * This is meant for attributes that are expensive to query, like
+ * thumbnails or the content type. When an item is requested for the
+ * first time, these attributes are queried in the background, and
+ * once they are available, the item is replaced with a `GFileInfo`
+ * that contains them in addition to the
+ * [property@Gtk.DirectoryList:attributes].
+ *
+ * Since: 4.14
+ */
+void
+gtk_directory_list_set_lazy_attributes (GtkDirectoryList *self,
+                                        const char       *attributes)
+{
+  g_return_if_fail (GTK_IS_DIRECTORY_LIST (self));
+
+  if (g_strcmp0 (self->lazy_attributes, attributes) == 0)
+    return;
+
+  g_object_freeze_notify (G_OBJECT (self));
+
+  g_free (self->lazy_attributes);
+  self->lazy_attributes = g_strdup (attributes);
+
+  gtk_directory_list_start_loading (self);
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_LAZY_ATTRIBUTES]);
+
+  g_object_thaw_notify (G_OBJECT (self));
+}
+
+/**
+ * gtk_directory_list_get_lazy_attributes: (attributes org.gtk.Method.get_property=lazy-attributes)
+ * @self: a `GtkDirectoryList`
+ *
+ * Gets the attributes that are queried lazily.
+ *
+ * Returns: (nullable) (transfer none): The lazily queried attributes
+ *
+ * Since: 4.14
+ */
+const char *
+gtk_directory_list_get_lazy_attributes (GtkDirectoryList *self)
+{
+  g_return_val_if_fail (GTK_IS_DIRECTORY_LIST (self), NULL);
+
+  return self->lazy_attributes;
+}
+
 /**
  * gtk_directory_list_is_loading: (attributes org.gtk.Method.get_property=loading)
  * @self: a `GtkDirectoryList`
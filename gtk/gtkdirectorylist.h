@@ -55,6 +55,16 @@ void                    gtk_directory_list_set_io_priority      (GtkDirectoryLis
                                                                  int                     io_priority);
 GDK_AVAILABLE_IN_ALL
 int                     gtk_directory_list_get_io_priority      (GtkDirectoryList       *self);
+GDK_AVAILABLE_IN_4_14
+void                    gtk_directory_list_set_batch_size       (GtkDirectoryList       *self,
+                                                                 guint                   batch_size);
+GDK_AVAILABLE_IN_4_14
+guint                   gtk_directory_list_get_batch_size       (GtkDirectoryList       *self);
+GDK_AVAILABLE_IN_4_14
+void                    gtk_directory_list_set_lazy_attributes  (GtkDirectoryList       *self,
+                                                                 const char             *attributes);
+GDK_AVAILABLE_IN_4_14
+const char *            gtk_directory_list_get_lazy_attributes  (GtkDirectoryList       *self);
 
 GDK_AVAILABLE_IN_ALL
 gboolean                gtk_directory_list_is_loading           (GtkDirectoryList       *self);
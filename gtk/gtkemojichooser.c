@@ -200,6 +200,7 @@ struct _GtkEmojiChooser
   GtkWidget *scrolled_window;
 
   int emoji_max_width;
+  GHashTable *renders;
 
   EmojiSection recent;
   EmojiSection people;
@@ -242,6 +243,7 @@ gtk_emoji_chooser_finalize (GObject *object)
     g_source_remove (chooser->populate_idle);
 
   g_clear_pointer (&chooser->data, g_variant_unref);
+  g_clear_pointer (&chooser->renders, g_hash_table_unref);
   g_clear_object (&chooser->settings);
 
   G_OBJECT_CLASS (gtk_emoji_chooser_parent_class)->finalize (object);
@@ -547,6 +549,46 @@ pressed_cb (GtkGesture *gesture,
   show_variations (chooser, child);
 }
 
+enum {
+  EMOJI_RENDERS_UNKNOWN,
+  EMOJI_RENDERS_YES,
+  EMOJI_RENDERS_NO
+};
+
+/* Whether emoji render well only depends on the font, so the
+ * results are shared by all choosers that use the same font.
+ * This maps font descriptions to tables that map the text of
+ * emoji to EMOJI_RENDERS_YES or EMOJI_RENDERS_NO.
+ */
+static GHashTable *renders_caches;
+
+static GHashTable *
+get_renders_cache (GtkEmojiChooser *chooser)
+{
+  PangoContext *context;
+  GHashTable *cache;
+  char *font, *key;
+
+  context = gtk_widget_get_pango_context (GTK_WIDGET (chooser));
+  font = pango_font_description_to_string (pango_context_get_font_description (context));
+  key = g_strdup_printf ("%s %d", font, chooser->emoji_max_width);
+  g_free (font);
+
+  if (renders_caches == NULL)
+    renders_caches = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, (GDestroyNotify) g_hash_table_unref);
+
+  cache = g_hash_table_lookup (renders_caches, key);
+  if (cache == NULL)
+    {
+      cache = g_hash_table_new_full (g_str_hash, g_str_equal, g_free, NULL);
+      g_hash_table_insert (renders_caches, key, cache);
+    }
+  else
+    g_free (key);
+
+  return g_hash_table_ref (cache);
+}
+
 static void
 add_emoji (GtkWidget    *box,
            gboolean      prepend,
@@ -564,6 +606,7 @@ add_emoji (GtkWidget    *box,
   PangoLayout *layout;
   PangoRectangle rect;
   gunichar code = 0;
+  int renders;
 
   codes = g_variant_get_child_value (item, 0);
   for (i = 0; i < g_variant_n_children (codes); i++)
@@ -581,22 +624,34 @@ add_emoji (GtkWidget    *box,
 
   p[0] = 0;
 
+  /* Check for fallback rendering that generates too wide items */
+  renders = GPOINTER_TO_INT (g_hash_table_lookup (chooser->renders, text));
+  if (renders == EMOJI_RENDERS_NO)
+    return;
+
   label = gtk_label_new (text);
   attrs = pango_attr_list_new ();
   pango_attr_list_insert (attrs, pango_attr_scale_new (PANGO_SCALE_X_LARGE));
   gtk_label_set_attributes (GTK_LABEL (label), attrs);
   pango_attr_list_unref (attrs);
 
-  layout = gtk_label_get_layout (GTK_LABEL (label));
-  pango_layout_get_extents (layout, &rect, NULL);
-
-  /* Check for fallback rendering that generates too wide items */
-  if (pango_layout_get_unknown_glyphs_count (layout) > 0 ||
-      rect.width >= 1.5 * chooser->emoji_max_width)
+  if (renders == EMOJI_RENDERS_UNKNOWN)
     {
-      g_object_ref_sink (label);
-      g_object_unref (label);
-      return;
+      layout = gtk_label_get_layout (GTK_LABEL (label));
+      pango_layout_get_extents (layout, &rect, NULL);
+
+      renders = pango_layout_get_unknown_glyphs_count (layout) == 0 &&
+                rect.width < 1.5 * chooser->emoji_max_width
+                ? EMOJI_RENDERS_YES
+                : EMOJI_RENDERS_NO;
+      g_hash_table_insert (chooser->renders, g_strdup (text), GINT_TO_POINTER (renders));
+
+      if (renders == EMOJI_RENDERS_NO)
+        {
+          g_object_ref_sink (label);
+          g_object_unref (label);
+          return;
+        }
     }
 
   child = g_object_new (GTK_TYPE_EMOJI_CHOOSER_CHILD, NULL);
@@ -705,6 +760,32 @@ get_emoji_data (void)
   return bytes;
 }
 
+/*< private >
+ * get_shared_emoji_data:
+ *
+ * Gets the emoji data for the default language as a variant
+ * of type a(ausasu). It is loaded once and shared between all
+ * emoji choosers and completions.
+ *
+ * Returns: (transfer none): the emoji data
+ */
+GVariant *
+get_shared_emoji_data (void)
+{
+  static GVariant *emoji_data;
+
+  if (emoji_data == NULL)
+    {
+      GBytes *bytes;
+
+      bytes = get_emoji_data ();
+      emoji_data = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("a(ausasu)"), bytes, TRUE));
+      g_bytes_unref (bytes);
+    }
+
+  return emoji_data;
+}
+
 static gboolean
 populate_emoji_chooser (gpointer data)
 {
@@ -715,14 +796,7 @@ populate_emoji_chooser (gpointer data)
   start = g_get_monotonic_time ();
 
   if (!chooser->data)
-    {
-      GBytes *bytes;
-
-      bytes = get_emoji_data ();
-
-      chooser->data = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("a(ausasu)"), bytes, TRUE));
-      g_bytes_unref (bytes);
-    }
+    chooser->data = g_variant_ref (get_shared_emoji_data ());
 
   if (!chooser->iter)
     {
@@ -1018,6 +1092,8 @@ gtk_emoji_chooser_init (GtkEmojiChooser *chooser)
     g_object_unref (layout);
   }
 
+  chooser->renders = get_renders_cache (chooser);
+
   adj = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (chooser->scrolled_window));
   g_signal_connect (adj, "value-changed", G_CALLBACK (adj_value_changed), chooser);
 
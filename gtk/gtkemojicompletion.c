@@ -617,15 +617,11 @@ long_pressed_cb (GtkGesture *gesture,
 static void
 gtk_emoji_completion_init (GtkEmojiCompletion *completion)
 {
-  GBytes *bytes = NULL;
   GtkGesture *long_press;
 
   gtk_widget_init_template (GTK_WIDGET (completion));
 
-  bytes = get_emoji_data ();
-  completion->data = g_variant_ref_sink (g_variant_new_from_bytes (G_VARIANT_TYPE ("a(ausasu)"), bytes, TRUE));
-
-  g_bytes_unref (bytes);
+  completion->data = g_variant_ref (get_shared_emoji_data ());
 
   long_press = gtk_gesture_long_press_new ();
   g_signal_connect (long_press, "pressed", G_CALLBACK (long_pressed_cb), completion);
@@ -1178,16 +1178,23 @@ gtk_property_expression_watch_notify_cb (GObject                    *object,
 static void
 gtk_property_expression_watch_create_closure (GtkPropertyExpressionWatch *pwatch)
 {
+  /* List item bindings reconnect every time a row is recycled,
+   * so avoid looking up the signal and the detail by name
+   */
+  static guint notify_signal_id;
   GObject *object;
 
   object = gtk_property_expression_get_object (pwatch->expr, pwatch->this);
   if (object == NULL)
     return;
 
+  if (G_UNLIKELY (notify_signal_id == 0))
+    notify_signal_id = g_signal_lookup ("notify", G_TYPE_OBJECT);
+
   pwatch->closure = g_cclosure_new (G_CALLBACK (gtk_property_expression_watch_notify_cb), pwatch, NULL);
   if (!g_signal_connect_closure_by_id (object,
-                                       g_signal_lookup ("notify", G_OBJECT_TYPE (object)),
-                                       g_quark_from_string (pwatch->expr->pspec->name),
+                                       notify_signal_id,
+                                       g_param_spec_get_name_quark (pwatch->expr->pspec),
                                        g_closure_ref (pwatch->closure),
                                        FALSE))
     {
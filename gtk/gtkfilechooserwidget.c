@@ -364,11 +364,19 @@ enum {
 
 static guint signals[LAST_SIGNAL] = { 0 };
 
-#define MODEL_ATTRIBUTES "standard::name,standard::type,standard::display-name," \
-                         "standard::is-hidden,standard::is-backup,standard::size," \
-                         "standard::content-type,standard::fast-content-type,time::modified,time::access," \
-                         "access::can-rename,access::can-delete,access::can-trash," \
-                         "standard::target-uri"
+#define MODEL_FAST_ATTRIBUTES "standard::name,standard::type,standard::display-name," \
+                              "standard::is-hidden,standard::is-backup,standard::size," \
+                              "standard::fast-content-type,time::modified,time::access," \
+                              "access::can-rename,access::can-delete,access::can-trash," \
+                              "standard::target-uri"
+
+/* Guessing the content type may need to read the file, so when browsing
+ * a folder it is only queried for the files that are shown. Until then,
+ * the fast content type is used.
+ */
+#define MODEL_DEFERRED_ATTRIBUTES "standard::content-type"
+
+#define MODEL_ATTRIBUTES MODEL_FAST_ATTRIBUTES "," MODEL_DEFERRED_ATTRIBUTES
 
 #define DEFAULT_RECENT_FILES_LIMIT 50
 
@@ -3970,7 +3978,8 @@ set_list_model (GtkFileChooserWidget  *impl,
 
   g_clear_object (&impl->browse_files_model);
   impl->browse_files_model =
-    _gtk_file_system_model_new_for_directory (impl->current_folder, MODEL_ATTRIBUTES);
+    _gtk_file_system_model_new_for_directory (impl->current_folder, MODEL_FAST_ATTRIBUTES);
+  _gtk_file_system_model_set_deferred_attributes (impl->browse_files_model, MODEL_DEFERRED_ATTRIBUTES);
 
   _gtk_file_system_model_set_show_hidden (impl->browse_files_model, impl->show_hidden);
   _gtk_file_system_model_set_can_select_files (impl->browse_files_model, impl->action != GTK_FILE_CHOOSER_ACTION_SELECT_FOLDER);
@@ -7297,6 +7306,10 @@ bind_name_cell (GtkFileChooserWidget *impl,
   GtkWidget *inscription;
   GFileInfo *info = gtk_column_view_cell_get_item (column_cell);
 
+  if (impl->browse_files_model)
+    _gtk_file_system_model_query_deferred_attributes (impl->browse_files_model,
+                                                      _gtk_file_info_get_file (info));
+
   box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
   thumbnail = g_object_new (GTK_TYPE_FILE_THUMBNAIL, NULL);
   gtk_widget_set_margin_start (GTK_WIDGET (thumbnail), 6);
@@ -51,6 +51,7 @@ struct _FileModelNode
   guint                 visible :1;     /* if the file is currently visible */
   guint                 filtered_out :1;/* if the file is currently filtered out (i.e. it didn't pass the filters) */
   guint                 frozen_add :1;  /* true if the model was frozen and the entry has not been added yet */
+  guint                 deferred_queried :1; /* true if the deferred attributes have been queried */
 };
 
 struct _GtkFileSystemModel
@@ -60,6 +61,7 @@ struct _GtkFileSystemModel
   GFile *               dir;            /* directory that's displayed */
   guint                 dir_thaw_source;/* GSource id for unfreezing the model */
   char *                attributes;     /* attributes the file info must contain, or NULL for all attributes */
+  char *                deferred_attributes; /* attributes that are only queried for files that are shown, or NULL */
   GFileMonitor *        dir_monitor;    /* directory that is monitored, or NULL if monitoring was not supported */
 
   GCancellable *        cancellable;    /* cancellable in use for all operations - cancelled on dispose */
@@ -74,6 +76,7 @@ struct _GtkFileSystemModel
   GtkFileFilter *       filter;         /* filter to use for deciding which nodes are visible */
 
   guint                 frozen;         /* number of times we're frozen */
+  guint                 first_frozen_add; /* index of the first node with frozen_add set, or G_MAXUINT */
 
   unsigned int          filter_on_thaw   : 1; /* set when filtering needs to happen upon thawing */
   unsigned int          show_hidden      : 1; /* whether to show hidden files */
@@ -81,6 +84,7 @@ struct _GtkFileSystemModel
   unsigned int          show_files       : 1; /* whether to show files */
   unsigned int          filter_folders   : 1; /* whether filter applies to folders */
   unsigned int          can_select_files : 1;
+  unsigned int          query_all_deferred : 1; /* the filter needs the deferred attributes */
 };
 
 static void freeze_updates (GtkFileSystemModel *model);
@@ -400,8 +404,7 @@ thaw_updates (GtkFileSystemModel *model)
   if (model->frozen > 0)
     return;
 
-  stuff_added = model->files->len > 0 &&
-                get_node (model, model->files->len - 1)->frozen_add;
+  stuff_added = model->first_frozen_add < model->files->len;
 
   if (model->filter_on_thaw)
     gtk_file_system_model_refilter_all (model);
@@ -410,7 +413,10 @@ thaw_updates (GtkFileSystemModel *model)
       guint i;
       guint changed_idx = G_MAXUINT;
 
-      for (i = 0; i < model->files->len; i++)
+      /* Only look at the nodes that were added while frozen, not at all
+       * of them, or loading a big directory gets quadratic
+       */
+      for (i = model->first_frozen_add; i < model->files->len; i++)
         {
           FileModelNode *node = get_node (model, i);
 
@@ -428,8 +434,13 @@ thaw_updates (GtkFileSystemModel *model)
                                     model->files->len - changed_idx,
                                     model->files->len - changed_idx);
     }
+
+  model->first_frozen_add = G_MAXUINT;
 }
 
+static void node_query_deferred_attributes (GtkFileSystemModel *model,
+                                            guint               id);
+
 static void
 add_file (GtkFileSystemModel *model,
           GFile              *file,
@@ -456,6 +467,12 @@ add_file (GtkFileSystemModel *model,
 
   position = model->files->len - 1;
 
+  if (model->frozen)
+    model->first_frozen_add = MIN (model->first_frozen_add, position);
+
+  if (model->query_all_deferred)
+    node_query_deferred_attributes (model, position);
+
   if (!model->frozen)
     {
       node_compute_visibility_and_filters (model, position);
@@ -510,6 +527,9 @@ remove_file (GtkFileSystemModel *model,
 
   g_array_remove_index (model->files, id);
 
+  if (model->first_frozen_add != G_MAXUINT && id < model->first_frozen_add)
+    model->first_frozen_add--;
+
   g_list_model_items_changed (G_LIST_MODEL (model), id, 1, 0);
 }
 
@@ -544,6 +564,7 @@ gtk_file_system_model_finalize (GObject *object)
 
   g_clear_object (&model->cancellable);
   g_clear_pointer (&model->attributes, g_free);
+  g_clear_pointer (&model->deferred_attributes, g_free);
   g_clear_object (&model->dir);
   g_clear_object (&model->dir_monitor);
   g_clear_pointer (&model->file_lookup, g_hash_table_destroy);
@@ -577,6 +598,7 @@ gtk_file_system_model_init (GtkFileSystemModel *model)
   model->show_hidden = FALSE;
   model->filter_folders = FALSE;
   model->can_select_files = TRUE;
+  model->first_frozen_add = G_MAXUINT;
 
   model->file_lookup = g_hash_table_new (g_file_hash, (GEqualFunc) g_file_equal);
   model->cancellable = g_cancellable_new ();
@@ -735,6 +757,103 @@ gtk_file_system_model_query_done (GObject *     object,
   query_done_helper (object, res, data, FALSE);
 }
 
+static void
+deferred_query_done (GObject      *object,
+                     GAsyncResult *res,
+                     gpointer      data)
+{
+  GtkFileSystemModel *model = GTK_FILE_SYSTEM_MODEL (data);
+  GFile *file = G_FILE (object);
+  FileModelNode *node;
+  GFileInfo *queried, *info;
+  char **attributes;
+  guint id, i;
+
+  queried = g_file_query_info_finish (file, res, NULL);
+  if (queried == NULL)
+    goto out;
+
+  id = node_get_for_file (model, file);
+  if (id == GTK_INVALID_LIST_POSITION)
+    goto out;
+
+  node = get_node (model, id);
+
+  /* Replace the info instead of changing it, so that the list
+   * items notice the change and show the new values
+   */
+  info = g_file_info_dup (node->info);
+  attributes = g_file_info_list_attributes (queried, NULL);
+  for (i = 0; attributes[i]; i++)
+    {
+      GFileAttributeType type;
+      gpointer value;
+
+      if (g_file_info_get_attribute_data (queried, attributes[i], &type, &value, NULL))
+        g_file_info_set_attribute (info, attributes[i], type, value);
+    }
+  g_strfreev (attributes);
+
+  g_set_object (&node->info, info);
+  g_object_unref (info);
+
+  if (!node->frozen_add)
+    {
+      node_compute_visibility_and_filters (model, id);
+      g_list_model_items_changed (G_LIST_MODEL (model), id, 1, 1);
+    }
+
+out:
+  g_clear_object (&queried);
+  g_object_unref (model);
+}
+
+static void
+node_query_deferred_attributes (GtkFileSystemModel *model,
+                                guint               id)
+{
+  FileModelNode *node = get_node (model, id);
+
+  if (model->deferred_attributes == NULL || node->deferred_queried)
+    return;
+
+  node->deferred_queried = TRUE;
+
+  g_file_query_info_async (node->file,
+                           model->deferred_attributes,
+                           G_FILE_QUERY_INFO_NONE,
+                           IO_PRIORITY,
+                           model->cancellable,
+                           deferred_query_done,
+                           g_object_ref (model));
+}
+
+static gboolean
+filter_needs_deferred_attributes (GtkFileSystemModel *model)
+{
+  GFileAttributeMatcher *matcher;
+  const char **attributes;
+  gboolean result = FALSE;
+  guint i;
+
+  if (model->deferred_attributes == NULL || model->filter == NULL)
+    return FALSE;
+
+  matcher = g_file_attribute_matcher_new (model->deferred_attributes);
+  attributes = gtk_file_filter_get_attributes (model->filter);
+  for (i = 0; attributes && attributes[i]; i++)
+    {
+      if (g_file_attribute_matcher_matches (matcher, attributes[i]))
+        {
+          result = TRUE;
+          break;
+        }
+    }
+  g_file_attribute_matcher_unref (matcher);
+
+  return result;
+}
+
 static void
 gtk_file_system_model_monitor_change (GFileMonitor *      monitor,
                                       GFile *             file,
@@ -1058,9 +1177,74 @@ _gtk_file_system_model_set_filter (GtkFileSystemModel      *model,
 
   g_set_object (&model->filter, filter);
 
+  /* The filter can't work without the deferred attributes, so query
+   * them for all files now, instead of waiting for them to be shown
+   */
+  if (!model->query_all_deferred && filter_needs_deferred_attributes (model))
+    {
+      guint i;
+
+      model->query_all_deferred = TRUE;
+      for (i = 0; i < model->files->len; i++)
+        node_query_deferred_attributes (model, i);
+    }
+
   gtk_file_system_model_refilter_all (model);
 }
 
+/**
+ * _gtk_file_system_model_set_deferred_attributes:
+ * @model: a `GtkFileSystemModel`
+ * @attributes: (nullable): attributes to load later
+ *
+ * Sets attributes that are expensive to query, like the content
+ * type for which the file has to be read. They are not queried when
+ * files are added, but only when
+ * _gtk_file_system_model_query_deferred_attributes() is called for
+ * a file, usually because it is shown, or when the filter needs them.
+ *
+ * The attributes that are passed when creating the model
+ * should not include @attributes.
+ **/
+void
+_gtk_file_system_model_set_deferred_attributes (GtkFileSystemModel *model,
+                                                const char         *attributes)
+{
+  g_return_if_fail (GTK_IS_FILE_SYSTEM_MODEL (model));
+
+  g_free (model->deferred_attributes);
+  model->deferred_attributes = g_strdup (attributes);
+}
+
+/**
+ * _gtk_file_system_model_query_deferred_attributes:
+ * @model: a `GtkFileSystemModel`
+ * @file: the file to query the attributes for
+ *
+ * Starts querying the attributes set with
+ * _gtk_file_system_model_set_deferred_attributes() for @file,
+ * unless that has happened already. When they are loaded, the
+ * file info of @file is replaced with one that has them.
+ **/
+void
+_gtk_file_system_model_query_deferred_attributes (GtkFileSystemModel *model,
+                                                  GFile              *file)
+{
+  guint id;
+
+  g_return_if_fail (GTK_IS_FILE_SYSTEM_MODEL (model));
+  g_return_if_fail (G_IS_FILE (file));
+
+  if (model->deferred_attributes == NULL)
+    return;
+
+  id = node_get_for_file (model, file);
+  if (id == GTK_INVALID_LIST_POSITION)
+    return;
+
+  node_query_deferred_attributes (model, id);
+}
+
 /**
  * _gtk_file_system_model_add_and_query_file:
  * @model: a `GtkFileSystemModel`
@@ -57,6 +57,11 @@ void                _gtk_file_system_model_set_filter_folders (GtkFileSystemMode
 void                _gtk_file_system_model_set_filter       (GtkFileSystemModel *model,
                                                              GtkFileFilter      *filter);
 
+void                _gtk_file_system_model_set_deferred_attributes   (GtkFileSystemModel *model,
+                                                                      const char         *attributes);
+void                _gtk_file_system_model_query_deferred_attributes (GtkFileSystemModel *model,
+                                                                      GFile              *file);
+
 void                _gtk_file_system_model_set_can_select_files (GtkFileSystemModel   *model,
                                                                  gboolean              can_select);
 
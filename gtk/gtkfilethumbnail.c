@@ -26,10 +26,20 @@
 #include "gtkfilechooserutils.h"
 #include "gtkimage.h"
 #include "gtkprivate.h"
+#include "gtkscrollable.h"
 #include "gtkwidget.h"
 
+#include "gdk/gdkprivate.h"
+
 #define ICON_SIZE 16
 
+/* How many thumbnails are queried and decoded at the same time.
+ * Scrolling through a folder of photos binds hundreds of cells,
+ * so requests are queued and the ones closest to the visible
+ * area are started first.
+ */
+#define MAX_RUNNING_LOADS 4
+
 struct _GtkFileThumbnail
 {
   GtkWidget parent;
@@ -39,6 +49,9 @@ struct _GtkFileThumbnail
 
   GCancellable *cancellable;
   GFileInfo *info;
+  GIcon *thumbnail;
+
+  guint queued : 1;
 };
 
 typedef struct
@@ -57,6 +70,12 @@ enum {
 
 static GParamSpec *properties [N_PROPS];
 
+static GQueue pending_loads = G_QUEUE_INIT;
+static guint n_running_loads;
+static guint dispatch_loads_id;
+
+static void start_load (GtkFileThumbnail *self);
+
 static void
 copy_attribute (GFileInfo  *to,
                 GFileInfo  *from,
@@ -74,8 +93,12 @@ update_image (GtkFileThumbnail *self)
 {
   GtkIconTheme *icon_theme;
   GIcon *icon;
-  int icon_size;
-  int scale;
+
+  if (self->thumbnail)
+    {
+      gtk_image_set_from_gicon (GTK_IMAGE (self->image), self->thumbnail);
+      return TRUE;
+    }
 
   if (!g_file_info_has_attribute (self->info, G_FILE_ATTRIBUTE_STANDARD_ICON))
     {
@@ -83,11 +106,14 @@ update_image (GtkFileThumbnail *self)
       return FALSE;
     }
 
-  scale = gtk_widget_get_scale_factor (GTK_WIDGET (self));
+  /* The thumbnail itself is decoded in a thread, see load_thumbnail() */
   icon_theme = gtk_icon_theme_get_for_display (gtk_widget_get_display (GTK_WIDGET (self)));
 
-  icon_size = self->icon_size != -1 ? self->icon_size : ICON_SIZE;
-  icon = _gtk_file_info_get_icon (self->info, icon_size, scale, icon_theme);
+  icon = g_file_info_get_icon (self->info);
+  if (icon && gtk_icon_theme_has_gicon (icon_theme, icon))
+    g_object_ref (icon);
+  else
+    icon = g_themed_icon_new ("text-x-generic");
 
   gtk_image_set_from_gicon (GTK_IMAGE (self->image), icon);
 
@@ -96,6 +122,180 @@ update_image (GtkFileThumbnail *self)
   return TRUE;
 }
 
+static float
+get_viewport_distance (GtkFileThumbnail *self)
+{
+  GtkWidget *widget = GTK_WIDGET (self);
+  GtkWidget *viewport;
+  graphene_rect_t bounds;
+  float distance = 0;
+
+  if (!gtk_widget_get_mapped (widget))
+    return G_MAXFLOAT;
+
+  /* List and grid views allocate the cells outside of the
+   * visible area at coordinates outside of their own size
+   */
+  viewport = gtk_widget_get_ancestor (widget, GTK_TYPE_SCROLLABLE);
+  if (viewport == NULL ||
+      !gtk_widget_compute_bounds (widget, viewport, &bounds))
+    return 0;
+
+  if (bounds.origin.y + bounds.size.height < 0)
+    distance += - (bounds.origin.y + bounds.size.height);
+  else if (bounds.origin.y > gtk_widget_get_height (viewport))
+    distance += bounds.origin.y - gtk_widget_get_height (viewport);
+
+  if (bounds.origin.x + bounds.size.width < 0)
+    distance += - (bounds.origin.x + bounds.size.width);
+  else if (bounds.origin.x > gtk_widget_get_width (viewport))
+    distance += bounds.origin.x - gtk_widget_get_width (viewport);
+
+  return distance;
+}
+
+static gboolean
+dispatch_loads (gpointer data)
+{
+  dispatch_loads_id = 0;
+
+  while (n_running_loads < MAX_RUNNING_LOADS &&
+         !g_queue_is_empty (&pending_loads))
+    {
+      GList *l, *nearest = NULL;
+      float nearest_distance = G_MAXFLOAT;
+      GtkFileThumbnail *self;
+
+      for (l = pending_loads.head; l; l = l->next)
+        {
+          float distance = get_viewport_distance (l->data);
+
+          if (nearest == NULL || distance < nearest_distance)
+            {
+              nearest = l;
+              nearest_distance = distance;
+            }
+        }
+
+      self = nearest->data;
+      g_queue_delete_link (&pending_loads, nearest);
+      self->queued = FALSE;
+
+      start_load (self);
+    }
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+queue_dispatch_loads (void)
+{
+  if (dispatch_loads_id != 0 || g_queue_is_empty (&pending_loads))
+    return;
+
+  /* Run after layout, so the cells have their final position */
+  dispatch_loads_id = g_idle_add_full (GDK_PRIORITY_REDRAW + 10, dispatch_loads, NULL, NULL);
+  gdk_source_set_static_name_by_id (dispatch_loads_id, "[gtk] dispatch_loads");
+}
+
+static void
+load_finished (void)
+{
+  g_assert (n_running_loads > 0);
+
+  n_running_loads--;
+  queue_dispatch_loads ();
+}
+
+typedef struct
+{
+  char *path;
+  int size;
+} LoadData;
+
+static void
+load_data_free (gpointer data)
+{
+  LoadData *load = data;
+
+  g_free (load->path);
+  g_free (load);
+}
+
+static void
+load_thumbnail_thread (GTask        *task,
+                       gpointer      source_object,
+                       gpointer      task_data,
+                       GCancellable *cancellable)
+{
+  LoadData *load = task_data;
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+
+  if (g_task_return_error_if_cancelled (task))
+    return;
+
+  pixbuf = gdk_pixbuf_new_from_file_at_size (load->path, load->size, load->size, &error);
+  if (pixbuf)
+    g_task_return_pointer (task, pixbuf, g_object_unref);
+  else
+    g_task_return_error (task, error);
+}
+
+static void
+thumbnail_loaded_cb (GObject      *object,
+                     GAsyncResult *result,
+                     gpointer      user_data)
+{
+  GtkFileThumbnail *self = user_data; /* might be unreffed if operation was cancelled */
+  GdkPixbuf *pixbuf;
+  GError *error = NULL;
+
+  pixbuf = g_task_propagate_pointer (G_TASK (result), &error);
+
+  load_finished ();
+
+  if (error)
+    {
+      if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
+        {
+          /* Keep showing the icon, and don't try again */
+          g_file_info_remove_attribute (self->info, G_FILE_ATTRIBUTE_THUMBNAIL_PATH);
+          g_clear_object (&self->cancellable);
+        }
+      g_clear_error (&error);
+      return;
+    }
+
+  self->thumbnail = G_ICON (pixbuf);
+  g_clear_object (&self->cancellable);
+
+  update_image (self);
+}
+
+/* Decodes the thumbnail at the size it is shown at, so that big
+ * thumbnails don't need to be kept around in full size
+ */
+static void
+load_thumbnail (GtkFileThumbnail *self)
+{
+  LoadData *load;
+  GTask *task;
+  int icon_size;
+
+  icon_size = self->icon_size != -1 ? self->icon_size : ICON_SIZE;
+
+  load = g_new (LoadData, 1);
+  load->path = g_strdup (g_file_info_get_attribute_byte_string (self->info, G_FILE_ATTRIBUTE_THUMBNAIL_PATH));
+  load->size = icon_size * gtk_widget_get_scale_factor (GTK_WIDGET (self));
+
+  task = g_task_new (NULL, self->cancellable, thumbnail_loaded_cb, self);
+  g_task_set_source_tag (task, load_thumbnail);
+  g_task_set_task_data (task, load, load_data_free);
+  g_task_run_in_thread (task, load_thumbnail_thread);
+  g_object_unref (task);
+}
+
 static void
 thumbnail_queried_cb (GObject      *object,
                       GAsyncResult *result,
@@ -111,8 +311,12 @@ thumbnail_queried_cb (GObject      *object,
   if (error)
     {
       if (!g_error_matches (error, G_IO_ERROR, G_IO_ERROR_CANCELLED))
-        g_file_info_set_attribute_boolean (self->info, "filechooser::queried", TRUE);
+        {
+          g_file_info_set_attribute_boolean (self->info, "filechooser::queried", TRUE);
+          g_clear_object (&self->cancellable);
+        }
       g_clear_error (&error);
+      load_finished ();
       return;
     }
 
@@ -126,46 +330,86 @@ thumbnail_queried_cb (GObject      *object,
 
   g_clear_object (&queried);
 
+  /* Keep the slot for decoding the thumbnail */
+  if (g_file_info_has_attribute (self->info, G_FILE_ATTRIBUTE_THUMBNAIL_PATH))
+    {
+      load_thumbnail (self);
+      return;
+    }
+
   g_clear_object (&self->cancellable);
+  load_finished ();
+}
+
+static void
+start_load (GtkFileThumbnail *self)
+{
+  g_assert (self->cancellable == NULL);
+
+  n_running_loads++;
+  self->cancellable = g_cancellable_new ();
+
+  if (!g_file_info_has_attribute (self->info, G_FILE_ATTRIBUTE_STANDARD_ICON))
+    {
+      GFile *file;
+
+      file = _gtk_file_info_get_file (self->info);
+      g_file_query_info_async (file,
+                               G_FILE_ATTRIBUTE_THUMBNAIL_PATH ","
+                               G_FILE_ATTRIBUTE_THUMBNAILING_FAILED ","
+                               G_FILE_ATTRIBUTE_STANDARD_ICON,
+                               G_FILE_QUERY_INFO_NONE,
+                               G_PRIORITY_DEFAULT,
+                               self->cancellable,
+                               thumbnail_queried_cb,
+                               self);
+    }
+  else
+    {
+      load_thumbnail (self);
+    }
 }
 
 static void
 cancel_thumbnail (GtkFileThumbnail *self)
 {
+  if (self->queued)
+    {
+      g_queue_remove (&pending_loads, self);
+      self->queued = FALSE;
+    }
+
+  /* The slot is given back when the callback runs */
   g_cancellable_cancel (self->cancellable);
   g_clear_object (&self->cancellable);
+
+  g_clear_object (&self->thumbnail);
 }
 
 static void
 get_thumbnail (GtkFileThumbnail *self)
 {
+  gboolean needs_load;
+
   if (!self->info)
     {
       gtk_image_clear (GTK_IMAGE (self->image));
       return;
     }
 
-  if (!update_image (self))
-    {
-      GFile *file;
+  if (update_image (self))
+    needs_load = g_file_info_has_attribute (self->info, G_FILE_ATTRIBUTE_THUMBNAIL_PATH);
+  else
+    needs_load = !g_file_info_has_attribute (self->info, "filechooser::queried");
 
-      if (g_file_info_has_attribute (self->info, "filechooser::queried"))
-        return;
+  if (!needs_load)
+    return;
 
-      g_assert (self->cancellable == NULL);
-      self->cancellable = g_cancellable_new ();
+  g_assert (self->cancellable == NULL);
 
-      file = _gtk_file_info_get_file (self->info);
-      g_file_query_info_async (file,
-                               G_FILE_ATTRIBUTE_THUMBNAIL_PATH ","
-                               G_FILE_ATTRIBUTE_THUMBNAILING_FAILED ","
-                               G_FILE_ATTRIBUTE_STANDARD_ICON,
-                               G_FILE_QUERY_INFO_NONE,
-                               G_PRIORITY_DEFAULT,
-                               self->cancellable,
-                               thumbnail_queried_cb,
-                               self);
-    }
+  self->queued = TRUE;
+  g_queue_push_tail (&pending_loads, self);
+  queue_dispatch_loads ();
 }
 
 static void
@@ -19,8 +19,11 @@
 
 #include "config.h"
 
-#include "gtkfilter.h"
+#include "gtkfilterprivate.h"
 
+#include "gtkboolfilter.h"
+#include "gtkmultifilter.h"
+#include "gtkstringfilter.h"
 #include "gtktypebuiltins.h"
 #include "gtkprivate.h"
 
@@ -185,3 +188,166 @@ gtk_filter_changed (GtkFilter       *self,
   g_signal_emit (self, signals[CHANGED], 0, change);
 }
 
+
+/* Only constants and chains of property lookups are evaluated without
+ * running user code other than property getters.
+ */
+static gboolean
+gtk_filter_expression_is_threadsafe (GtkExpression *expression)
+{
+  while (expression)
+    {
+      if (G_TYPE_CHECK_INSTANCE_TYPE (expression, GTK_TYPE_CONSTANT_EXPRESSION))
+        return TRUE;
+
+      if (!G_TYPE_CHECK_INSTANCE_TYPE (expression, GTK_TYPE_PROPERTY_EXPRESSION))
+        return FALSE;
+
+      expression = gtk_property_expression_get_expression (expression);
+    }
+
+  return TRUE;
+}
+
+/*<private>
+ * gtk_filter_is_threadsafe:
+ * @self: a `GtkFilter`
+ *
+ * Checks if [method@Gtk.Filter.match] may be called for different
+ * items from multiple threads at the same time, while the main thread
+ * waits for the results.
+ *
+ * This is only known for the filters provided by GTK, and only when
+ * their expressions do not call out to code other than the property
+ * getters of the items.
+ *
+ * Returns: %TRUE if @self can match items in parallel
+ */
+gboolean
+gtk_filter_is_threadsafe (GtkFilter *self)
+{
+  g_return_val_if_fail (GTK_IS_FILTER (self), FALSE);
+
+  if (GTK_IS_STRING_FILTER (self))
+    {
+      return gtk_filter_expression_is_threadsafe (gtk_string_filter_get_expression (GTK_STRING_FILTER (self)));
+    }
+  else if (GTK_IS_BOOL_FILTER (self))
+    {
+      return gtk_filter_expression_is_threadsafe (gtk_bool_filter_get_expression (GTK_BOOL_FILTER (self)));
+    }
+  else if (GTK_IS_MULTI_FILTER (self))
+    {
+      GListModel *filters = G_LIST_MODEL (self);
+      guint i, n;
+
+      n = g_list_model_get_n_items (filters);
+      for (i = 0; i < n; i++)
+        {
+          GtkFilter *child = g_list_model_get_item (filters, i);
+          gboolean result = gtk_filter_is_threadsafe (child);
+
+          g_object_unref (child);
+          if (!result)
+            return FALSE;
+        }
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static gboolean
+gtk_filter_append_state (GtkFilter *self,
+                         GString   *string)
+{
+  if (GTK_IS_STRING_FILTER (self))
+    {
+      GtkStringFilter *filter = GTK_STRING_FILTER (self);
+      const char *search = gtk_string_filter_get_search (filter);
+
+      g_string_append_printf (string, "string %p %u %u %s",
+                              gtk_string_filter_get_expression (filter),
+                              gtk_string_filter_get_match_mode (filter),
+                              gtk_string_filter_get_ignore_case (filter),
+                              search ? search : "");
+      return TRUE;
+    }
+  else if (GTK_IS_BOOL_FILTER (self))
+    {
+      GtkBoolFilter *filter = GTK_BOOL_FILTER (self);
+
+      g_string_append_printf (string, "bool %p %u",
+                              gtk_bool_filter_get_expression (filter),
+                              gtk_bool_filter_get_invert (filter));
+      return TRUE;
+    }
+  else if (GTK_IS_MULTI_FILTER (self))
+    {
+      GListModel *filters = G_LIST_MODEL (self);
+      GString *child_string;
+      guint i, n;
+
+      g_string_append (string, GTK_IS_ANY_FILTER (self) ? "any" : "every");
+
+      child_string = g_string_new (NULL);
+      n = g_list_model_get_n_items (filters);
+      for (i = 0; i < n; i++)
+        {
+          GtkFilter *child = g_list_model_get_item (filters, i);
+          gboolean result = gtk_filter_append_state (child, child_string);
+
+          g_object_unref (child);
+          if (!result)
+            {
+              g_string_free (child_string, TRUE);
+              return FALSE;
+            }
+
+          /* prefix the length so nested states can't be confused */
+          g_string_append_printf (string, " %zu:%s", child_string->len, child_string->str);
+          g_string_truncate (child_string, 0);
+        }
+      g_string_free (child_string, TRUE);
+
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+/*<private>
+ * gtk_filter_get_state:
+ * @self: a `GtkFilter`
+ *
+ * Describes the current settings of @self as a string, so that users
+ * of the filter can remember results and reuse them when the filter
+ * returns to a previous state.
+ *
+ * Two filters with the same state match the same items as long as the
+ * items do not change.
+ *
+ * This is only known for the filters provided by GTK. The state
+ * refers to expressions by address, so it is only valid until the
+ * filter emits a [enum@Gtk.FilterChange.DIFFERENT] change.
+ *
+ * Returns: (transfer full) (nullable): the state of @self or %NULL
+ *   if it is unknown
+ */
+char *
+gtk_filter_get_state (GtkFilter *self)
+{
+  GString *string;
+
+  g_return_val_if_fail (GTK_IS_FILTER (self), NULL);
+
+  string = g_string_new (NULL);
+  if (!gtk_filter_append_state (self, string))
+    {
+      g_string_free (string, TRUE);
+      return NULL;
+    }
+
+  return g_string_free (string, FALSE);
+}
@@ -22,9 +22,14 @@
 #include "gtkfilterlistmodel.h"
 
 #include "gtkbitset.h"
+#include "gtkfilterprivate.h"
 #include "gtkprivate.h"
 #include "gtksectionmodelprivate.h"
 
+#include "gdk/gdkparalleltaskprivate.h"
+
+#include <string.h>
+
 /**
  * GtkFilterListModel:
  *
@@ -38,6 +43,9 @@
  * filtering long lists doesn't block the UI. See
  * [method@Gtk.FilterListModel.set_incremental] for details.
  *
+ * Large models can also be filtered using multiple threads, see
+ * [method@Gtk.FilterListModel.set_parallel].
+ *
  * `GtkFilterListModel` passes through sections from the underlying model.
  */
 
@@ -48,10 +56,23 @@ enum {
   PROP_ITEM_TYPE,
   PROP_MODEL,
   PROP_N_ITEMS,
+  PROP_PARALLEL,
   PROP_PENDING,
   NUM_PROPERTIES
 };
 
+/* Number of previous results that are remembered, so that undoing
+ * a change to the filter - like pressing backspace in a search entry -
+ * doesn't need to filter again.
+ */
+#define GTK_FILTER_HISTORY_SIZE 8
+
+typedef struct
+{
+  char *filter_state;
+  GtkBitset *matches;
+} FilterHistory;
+
 struct _GtkFilterListModel
 {
   GObject parent_instance;
@@ -60,10 +81,15 @@ struct _GtkFilterListModel
   GtkFilter *filter;
   GtkFilterMatch strictness;
   gboolean incremental;
+  gboolean parallel;
 
   GtkBitset *matches; /* NULL if strictness != GTK_FILTER_MATCH_SOME */
   GtkBitset *pending; /* not yet filtered items or NULL if all filtered */
   guint pending_cb; /* idle callback handle */
+
+  char *filter_state; /* gtk_filter_get_state() of the filter that computed matches */
+  FilterHistory history[GTK_FILTER_HISTORY_SIZE]; /* oldest first */
+  guint n_history;
 };
 
 struct _GtkFilterListModelClass
@@ -71,6 +97,17 @@ struct _GtkFilterListModelClass
   GObjectClass parent_class;
 };
 
+/* Minimum number of items to filter before using threads */
+#define GTK_FILTER_PARALLEL_MIN_ITEMS (4096)
+
+/* Number of items fetched from the model at once when filtering in
+ * parallel, this limits the memory needed to hold the items
+ */
+#define GTK_FILTER_PARALLEL_BATCH (65536)
+
+/* Number of items matched by a thread at once when filtering in parallel */
+#define GTK_FILTER_PARALLEL_CHUNK (512)
+
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
 
 static GType
@@ -250,6 +287,93 @@ gtk_filter_list_model_run_filter_on_item (GtkFilterListModel *self,
   return visible;
 }
 
+typedef struct
+{
+  GtkFilter *filter;
+  gpointer *items;
+  guint8 *results;
+  guint n_items;
+  guint n_chunks;
+  /* atomic */ int next_chunk;
+} MatchItems;
+
+static void
+gtk_filter_list_model_match_items_task (gpointer data)
+{
+  MatchItems *mi = data;
+  guint i, pos, end;
+
+  for (i = g_atomic_int_add (&mi->next_chunk, 1);
+       i < mi->n_chunks;
+       i = g_atomic_int_add (&mi->next_chunk, 1))
+    {
+      end = MIN ((i + 1) * GTK_FILTER_PARALLEL_CHUNK, mi->n_items);
+
+      for (pos = i * GTK_FILTER_PARALLEL_CHUNK; pos < end; pos++)
+        mi->results[pos] = gtk_filter_match (mi->filter, mi->items[pos]);
+    }
+}
+
+/* Filters all pending items by fetching them in batches on the main
+ * thread and matching them in parallel.
+ * Returns FALSE if the items need to be filtered the normal way.
+ */
+static gboolean
+gtk_filter_list_model_run_filter_parallel (GtkFilterListModel *self)
+{
+  MatchItems mi;
+  GtkBitsetIter iter;
+  guint *positions;
+  guint64 n_pending;
+  guint i, pos, batch_size;
+  gboolean more;
+
+  g_assert (self->strictness == GTK_FILTER_MATCH_SOME);
+
+  n_pending = gtk_bitset_get_size (self->pending);
+  if (!self->parallel ||
+      n_pending < GTK_FILTER_PARALLEL_MIN_ITEMS ||
+      !gtk_filter_is_threadsafe (self->filter))
+    return FALSE;
+
+  batch_size = MIN (n_pending, GTK_FILTER_PARALLEL_BATCH);
+  mi.filter = self->filter;
+  mi.items = g_new (gpointer, batch_size);
+  mi.results = g_new (guint8, batch_size);
+  positions = g_new (guint, batch_size);
+
+  more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
+  while (more)
+    {
+      for (mi.n_items = 0;
+           mi.n_items < batch_size && more;
+           mi.n_items++, more = gtk_bitset_iter_next (&iter, &pos))
+        {
+          positions[mi.n_items] = pos;
+          mi.items[mi.n_items] = g_list_model_get_item (self->model, pos);
+        }
+
+      mi.n_chunks = (mi.n_items + GTK_FILTER_PARALLEL_CHUNK - 1) / GTK_FILTER_PARALLEL_CHUNK;
+      mi.next_chunk = 0;
+      gdk_parallel_task_run (gtk_filter_list_model_match_items_task, &mi, mi.n_chunks);
+
+      for (i = 0; i < mi.n_items; i++)
+        {
+          if (mi.results[i])
+            gtk_bitset_add (self->matches, positions[i]);
+          g_object_unref (mi.items[i]);
+        }
+    }
+
+  g_free (positions);
+  g_free (mi.results);
+  g_free (mi.items);
+
+  g_clear_pointer (&self->pending, gtk_bitset_unref);
+
+  return TRUE;
+}
+
 static void
 gtk_filter_list_model_run_filter (GtkFilterListModel *self,
                                   guint               n_steps)
@@ -263,6 +387,10 @@ gtk_filter_list_model_run_filter (GtkFilterListModel *self,
   if (self->pending == NULL)
     return;
 
+  if (n_steps >= gtk_bitset_get_size (self->pending) &&
+      gtk_filter_list_model_run_filter_parallel (self))
+    return;
+
   for (i = 0, more = gtk_bitset_iter_init_first (&iter, self->pending, &pos);
        i < n_steps && more;
        i++, more = gtk_bitset_iter_next (&iter, &pos))
@@ -368,6 +496,62 @@ gtk_filter_list_model_start_filtering (GtkFilterListModel *self,
   gdk_source_set_static_name_by_id (self->pending_cb, "[gtk] gtk_filter_list_model_run_filter_cb");
 }
 
+static void
+gtk_filter_list_model_clear_history (GtkFilterListModel *self)
+{
+  guint i;
+
+  for (i = 0; i < self->n_history; i++)
+    {
+      g_free (self->history[i].filter_state);
+      gtk_bitset_unref (self->history[i].matches);
+    }
+  self->n_history = 0;
+}
+
+/* NB: filter_state is (transfer full) */
+static void
+gtk_filter_list_model_push_history (GtkFilterListModel *self,
+                                    char               *filter_state,
+                                    GtkBitset          *matches)
+{
+  if (self->n_history == GTK_FILTER_HISTORY_SIZE)
+    {
+      g_free (self->history[0].filter_state);
+      gtk_bitset_unref (self->history[0].matches);
+      memmove (&self->history[0], &self->history[1], sizeof (FilterHistory) * (GTK_FILTER_HISTORY_SIZE - 1));
+      self->n_history--;
+    }
+
+  self->history[self->n_history].filter_state = filter_state;
+  self->history[self->n_history].matches = gtk_bitset_copy (matches);
+  self->n_history++;
+}
+
+/* Returns (transfer full) the matches remembered for filter_state or NULL */
+static GtkBitset *
+gtk_filter_list_model_pop_history (GtkFilterListModel *self,
+                                   const char         *filter_state)
+{
+  GtkBitset *matches;
+  guint i;
+
+  for (i = self->n_history; i-- > 0; )
+    {
+      if (!g_str_equal (self->history[i].filter_state, filter_state))
+        continue;
+
+      matches = self->history[i].matches;
+      g_free (self->history[i].filter_state);
+      memmove (&self->history[i], &self->history[i + 1], sizeof (FilterHistory) * (self->n_history - i - 1));
+      self->n_history--;
+
+      return matches;
+    }
+
+  return NULL;
+}
+
 static void
 gtk_filter_list_model_items_changed_cb (GListModel         *model,
                                         guint               position,
@@ -377,6 +561,10 @@ gtk_filter_list_model_items_changed_cb (GListModel         *model,
 {
   guint filter_removed, filter_added;
 
+  /* positions changed, and new items haven't been filtered for
+   * the previous filters */
+  gtk_filter_list_model_clear_history (self);
+
   switch (self->strictness)
     {
     case GTK_FILTER_MATCH_NONE:
@@ -442,6 +630,10 @@ gtk_filter_list_model_set_property (GObject      *object,
       gtk_filter_list_model_set_model (self, g_value_get_object (value));
       break;
 
+    case PROP_PARALLEL:
+      gtk_filter_list_model_set_parallel (self, g_value_get_boolean (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -478,6 +670,10 @@ gtk_filter_list_model_get_property (GObject     *object,
       g_value_set_uint (value, gtk_filter_list_model_get_n_items (G_LIST_MODEL (self)));
       break;
 
+    case PROP_PARALLEL:
+      g_value_set_boolean (value, self->parallel);
+      break;
+
     case PROP_PENDING:
       g_value_set_uint (value, gtk_filter_list_model_get_pending (self));
       break;
@@ -495,6 +691,8 @@ gtk_filter_list_model_clear_model (GtkFilterListModel *self)
     return;
 
   gtk_filter_list_model_stop_filtering (self);
+  gtk_filter_list_model_clear_history (self);
+  g_clear_pointer (&self->filter_state, g_free);
   g_signal_handlers_disconnect_by_func (self->model, gtk_filter_list_model_items_changed_cb, self);
   g_signal_handlers_disconnect_by_func (self->model, gtk_filter_list_model_sections_changed_cb, self);
   g_clear_object (&self->model);
@@ -636,12 +834,72 @@ gtk_filter_list_model_refilter (GtkFilterListModel *self,
     }
 }
 
+/* NB: matches is (transfer full) */
+static void
+gtk_filter_list_model_restore_matches (GtkFilterListModel *self,
+                                       GtkBitset          *matches)
+{
+  GtkBitset *old;
+
+  if (self->matches)
+    old = self->matches;
+  else if (self->strictness == GTK_FILTER_MATCH_ALL)
+    old = gtk_bitset_new_range (0, g_list_model_get_n_items (self->model));
+  else
+    old = gtk_bitset_new_empty ();
+
+  gtk_filter_list_model_stop_filtering (self);
+  self->strictness = GTK_FILTER_MATCH_SOME;
+  self->matches = matches;
+
+  gtk_filter_list_model_emit_items_changed_for_changes (self, old);
+}
+
 static void
 gtk_filter_list_model_filter_changed_cb (GtkFilter          *filter,
                                          GtkFilterChange     change,
                                          GtkFilterListModel *self)
 {
-  gtk_filter_list_model_refilter (self, change);
+  GtkBitset *matches;
+  char *filter_state;
+
+  if (change == GTK_FILTER_CHANGE_DIFFERENT || self->model == NULL)
+    {
+      gtk_filter_list_model_clear_history (self);
+      g_clear_pointer (&self->filter_state, g_free);
+      gtk_filter_list_model_refilter (self, change);
+      if (self->model)
+        self->filter_state = gtk_filter_get_state (filter);
+      return;
+    }
+
+  filter_state = gtk_filter_get_state (filter);
+  if (filter_state == NULL)
+    {
+      gtk_filter_list_model_clear_history (self);
+      g_clear_pointer (&self->filter_state, g_free);
+      gtk_filter_list_model_refilter (self, change);
+      return;
+    }
+
+  /* Only complete results can be reused */
+  if (self->filter_state && self->strictness == GTK_FILTER_MATCH_SOME && self->pending == NULL)
+    gtk_filter_list_model_push_history (self, g_steal_pointer (&self->filter_state), self->matches);
+  else
+    g_clear_pointer (&self->filter_state, g_free);
+
+  matches = gtk_filter_list_model_pop_history (self, filter_state);
+  if (matches && gtk_filter_get_strictness (filter) == GTK_FILTER_MATCH_SOME)
+    {
+      gtk_filter_list_model_restore_matches (self, matches);
+    }
+  else
+    {
+      g_clear_pointer (&matches, gtk_bitset_unref);
+      gtk_filter_list_model_refilter (self, change);
+    }
+
+  self->filter_state = filter_state;
 }
 
 static void
@@ -652,6 +910,8 @@ gtk_filter_list_model_clear_filter (GtkFilterListModel *self)
 
   g_signal_handlers_disconnect_by_func (self->filter, gtk_filter_list_model_filter_changed_cb, self);
   g_clear_object (&self->filter);
+  gtk_filter_list_model_clear_history (self);
+  g_clear_pointer (&self->filter_state, g_free);
 }
 
 static void
@@ -729,6 +989,18 @@ gtk_filter_list_model_class_init (GtkFilterListModelClass *class)
                        0, G_MAXUINT, 0,
                        G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
 
+  /**
+   * GtkFilterListModel:parallel: (attributes org.gtk.Property.get=gtk_filter_list_model_get_parallel org.gtk.Property.set=gtk_filter_list_model_set_parallel)
+   *
+   * If the model may match items from multiple threads.
+   *
+   * Since: 4.14
+   */
+  properties[PROP_PARALLEL] =
+      g_param_spec_boolean ("parallel", NULL, NULL,
+                            FALSE,
+                            GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   /**
    * GtkFilterListModel:pending: (attributes org.gtk.Property.get=gtk_filter_list_model_get_pending)
    *
@@ -878,6 +1150,9 @@ gtk_filter_list_model_set_model (GtkFilterListModel *self,
         {
           added = g_list_model_get_n_items (model);
         }
+
+      if (self->filter)
+        self->filter_state = gtk_filter_get_state (self->filter);
     }
   else
     {
@@ -977,6 +1252,64 @@ gtk_filter_list_model_get_incremental (GtkFilterListModel *self)
   return self->incremental;
 }
 
+/**
+ * gtk_filter_list_model_set_parallel: (attributes org.gtk.Method.set_property=parallel)
+ * @self: a `GtkFilterListModel`
+ * @parallel: %TRUE to allow filtering in multiple threads
+ *
+ * Sets whether the filter model may match items from multiple threads.
+ *
+ * When this is enabled and a large number of items needs to be
+ * filtered at once, the items are taken from the model on the main
+ * thread and then matched by multiple threads at the same time.
+ *
+ * This is only done for filters provided by GTK whose expressions
+ * only look up properties, like a `GtkStringFilter` or a `GtkBoolFilter`
+ * using `GtkPropertyExpression`s. It requires that the getters of those
+ * properties can be called from any thread. Other filters are always run
+ * on the main thread.
+ *
+ * Parallel filtering is used when filtering is not incremental, so that
+ * filtering large models finishes without blocking the UI for long.
+ *
+ * By default, parallel filtering is disabled.
+ *
+ * Since: 4.14
+ */
+void
+gtk_filter_list_model_set_parallel (GtkFilterListModel *self,
+                                    gboolean            parallel)
+{
+  g_return_if_fail (GTK_IS_FILTER_LIST_MODEL (self));
+
+  if (self->parallel == parallel)
+    return;
+
+  self->parallel = parallel;
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PARALLEL]);
+}
+
+/**
+ * gtk_filter_list_model_get_parallel: (attributes org.gtk.Method.get_property=parallel)
+ * @self: a `GtkFilterListModel`
+ *
+ * Returns whether the filter model may match items from multiple threads.
+ *
+ * See [method@Gtk.FilterListModel.set_parallel].
+ *
+ * Returns: %TRUE if parallel filtering is enabled
+ *
+ * Since: 4.14
+ */
+gboolean
+gtk_filter_list_model_get_parallel (GtkFilterListModel *self)
+{
+  g_return_val_if_fail (GTK_IS_FILTER_LIST_MODEL (self), FALSE);
+
+  return self->parallel;
+}
+
 /**
  * gtk_filter_list_model_get_pending: (attributes org.gtk.Method.get_property=pending)
  * @self: a `GtkFilterListModel`
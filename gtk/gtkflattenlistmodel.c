@@ -48,6 +48,8 @@ typedef struct _FlattenAugment FlattenAugment;
 struct _FlattenNode
 {
   GListModel *model;
+  /* cached, so lookups don't need to call into the model */
+  guint n_items;
   GtkFlattenListModel *list;
 };
 
@@ -96,7 +98,7 @@ gtk_flatten_list_model_get_nth (GtkRbTree *tree,
           position -= aug->n_items;
         }
 
-      model_n_items = g_list_model_get_n_items (node->model);
+      model_n_items = node->n_items;
       if (position < model_n_items)
         break;
       position -= model_n_items;
@@ -139,7 +141,7 @@ gtk_flatten_list_model_get_nth_model (GtkRbTree *tree,
       if (position == 0)
         break;
       position--;
-      before += g_list_model_get_n_items (node->model);
+      before += node->n_items;
 
       node = gtk_rb_tree_node_get_right (node);
     }
@@ -219,7 +221,7 @@ gtk_flatten_list_model_get_section (GtkSectionModel *model,
     }
 
   *out_start = position - model_pos;
-  *out_end = position - model_pos + g_list_model_get_n_items (node->model);
+  *out_end = position - model_pos + node->n_items;
 }
 
 static void
@@ -245,6 +247,7 @@ gtk_flatten_list_model_items_changed_cb (GListModel *model,
   GtkFlattenListModel *self = node->list;
   guint real_position;
 
+  node->n_items = node->n_items - removed + added;
   gtk_rb_tree_node_mark_dirty (node);
   real_position = position;
 
@@ -267,7 +270,7 @@ gtk_flatten_list_model_items_changed_cb (GListModel *model,
               FlattenAugment *aug = gtk_rb_tree_get_augment (self->items, left);
               real_position += aug->n_items;
             }
-          real_position += g_list_model_get_n_items (parent->model);
+          real_position += parent->n_items;
         }
     }
 
@@ -295,7 +298,7 @@ gtk_flatten_list_model_augment (GtkRbTree *flatten,
   FlattenNode *node = _node;
   FlattenAugment *aug = _aug;
 
-  aug->n_items = g_list_model_get_n_items (node->model);
+  aug->n_items = node->n_items;
   aug->n_models = 1;
 
   if (left)
@@ -331,7 +334,8 @@ gtk_flatten_list_model_add_items (GtkFlattenListModel *self,
                         G_CALLBACK (gtk_flatten_list_model_items_changed_cb),
                         node);
       node->list = self;
-      added += g_list_model_get_n_items (node->model);
+      node->n_items = g_list_model_get_n_items (node->model);
+      added += node->n_items;
     }
 
   return added;
@@ -393,20 +397,45 @@ gtk_flatten_list_model_model_items_changed_cb (GListModel          *model,
                                                GtkFlattenListModel *self)
 {
   FlattenNode *node;
-  guint i, real_position, real_removed, real_added;
+  guint i, n_replaced, real_position, real_removed, real_added;
 
   node = gtk_flatten_list_model_get_nth_model (self->items, position, &real_position);
 
   real_removed = 0;
-  for (i = 0; i < removed; i++)
+  real_added = 0;
+
+  /* Reuse the existing nodes for replaced models instead of removing
+   * and inserting tree nodes, that saves a lot of rebalancing when
+   * many small models are replaced at once.
+   */
+  n_replaced = MIN (removed, added);
+  for (i = 0; i < n_replaced; i++)
+    {
+      real_removed += node->n_items;
+      g_signal_handlers_disconnect_by_func (node->model, gtk_flatten_list_model_items_changed_cb, node);
+      g_object_unref (node->model);
+
+      node->model = g_list_model_get_item (model, position + i);
+      g_signal_connect (node->model,
+                        "items-changed",
+                        G_CALLBACK (gtk_flatten_list_model_items_changed_cb),
+                        node);
+      node->n_items = g_list_model_get_n_items (node->model);
+      real_added += node->n_items;
+      gtk_rb_tree_node_mark_dirty (node);
+
+      node = gtk_rb_tree_node_get_next (node);
+    }
+
+  for (i = n_replaced; i < removed; i++)
     {
       FlattenNode *next = gtk_rb_tree_node_get_next (node);
-      real_removed += g_list_model_get_n_items (node->model);
+      real_removed += node->n_items;
       gtk_rb_tree_remove (self->items, node);
       node = next;
     }
 
-  real_added = gtk_flatten_list_model_add_items (self, node, position, added);
+  real_added += gtk_flatten_list_model_add_items (self, node, position + n_replaced, added - n_replaced);
 
   if (real_removed > 0 || real_added > 0)
     g_list_model_items_changed (G_LIST_MODEL (self), real_position, real_removed, real_added);
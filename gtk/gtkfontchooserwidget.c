@@ -348,6 +348,49 @@ output_cb (GtkSpinButton *spin,
   return TRUE;
 }
 
+/* Finding the languages of a face means loading a font, and this is
+ * needed for every face when populating the list and when filtering
+ * by language. So we do it only once, and cache the result on the
+ * PangoFontFace.
+ */
+static PangoLanguage **
+get_face_languages (GtkFontChooserWidget *self,
+                    PangoFontFace        *face)
+{
+  PangoLanguage **langs;
+  PangoLanguage **font_langs;
+  PangoFontDescription *desc;
+  PangoContext *context;
+  PangoFont *font;
+  gsize n;
+
+  langs = g_object_get_data (G_OBJECT (face), "gtk-languages");
+  if (langs)
+    return langs;
+
+  desc = pango_font_face_describe (face);
+  pango_font_description_set_size (desc, 20);
+
+  context = gtk_widget_get_pango_context (GTK_WIDGET (self));
+  font = pango_context_load_font (context, desc);
+
+  font_langs = font ? pango_font_get_languages (font) : NULL;
+  for (n = 0; font_langs && font_langs[n]; n++)
+    ;
+
+  langs = g_new (PangoLanguage *, n + 1);
+  if (n > 0)
+    memcpy (langs, font_langs, n * sizeof (PangoLanguage *));
+  langs[n] = NULL;
+
+  g_object_set_data_full (G_OBJECT (face), "gtk-languages", langs, g_free);
+
+  g_clear_object (&font);
+  pango_font_description_free (desc);
+
+  return langs;
+}
+
 static gboolean
 user_filter_cb (gpointer item,
                 gpointer data)
@@ -374,37 +417,16 @@ user_filter_cb (gpointer item,
   if (self->filter_by_language &&
       self->filter_language)
     {
-      PangoFontDescription *desc;
-      PangoContext *context;
-      PangoFont *font;
-      gboolean ret;
       PangoLanguage **langs;
 
-      desc = pango_font_face_describe (face);
-      pango_font_description_set_size (desc, 20);
-
-      context = gtk_widget_get_pango_context (GTK_WIDGET (self));
-      font = pango_context_load_font (context, desc);
-
-      ret = FALSE;
-
-      langs = pango_font_get_languages (font);
-      if (langs)
+      langs = get_face_languages (self, face);
+      for (int i = 0; langs[i]; i++)
         {
-          for (int i = 0; langs[i]; i++)
-            {
-              if (langs[i] == self->filter_language)
-                {
-                  ret = TRUE;
-                  break;
-                }
-            }
+          if (langs[i] == self->filter_language)
+            return TRUE;
         }
 
-      g_object_unref (font);
-      pango_font_description_free (desc);
-
-      return ret;
+      return FALSE;
     }
 
   return TRUE;
@@ -727,28 +749,36 @@ get_font_attributes (GObject  *ignore,
 {
   PangoAttribute *attribute;
   PangoAttrList *attrs;
+  PangoFontFace *face;
+  PangoFontDescription *font_desc;
 
-  attrs = pango_attr_list_new ();
+  if (item == NULL)
+    return pango_attr_list_new ();
 
-  if (item)
+  if (PANGO_IS_FONT_FAMILY (item))
+    face = pango_font_family_get_face (item, NULL);
+  else
+    face = item;
+  if (face == NULL)
+    return pango_attr_list_new ();
+
+  /* Rows are rebound all the time while scrolling, so we
+   * create the attributes only once per PangoFontFace
+   */
+  attrs = g_object_get_data (G_OBJECT (face), "gtk-font-attributes");
+  if (attrs == NULL)
     {
-      PangoFontFace *face;
-      PangoFontDescription *font_desc;
+      attrs = pango_attr_list_new ();
+      font_desc = pango_font_face_describe (face);
+      attribute = pango_attr_font_desc_new (font_desc);
+      pango_attr_list_insert (attrs, attribute);
+      pango_font_description_free (font_desc);
 
-      if (PANGO_IS_FONT_FAMILY (item))
-        face = pango_font_family_get_face (item, NULL);
-      else
-        face = item;
-      if (face)
-        {
-          font_desc = pango_font_face_describe (face);
-          attribute = pango_attr_font_desc_new (font_desc);
-          pango_attr_list_insert (attrs, attribute);
-          pango_font_description_free (font_desc);
-        }
+      g_object_set_data_full (G_OBJECT (face), "gtk-font-attributes",
+                              attrs, (GDestroyNotify) pango_attr_list_unref);
     }
 
-  return attrs;
+  return pango_attr_list_ref (attrs);
 }
 
 static void
@@ -1042,9 +1072,6 @@ add_languages_from_font (GtkFontChooserWidget *self,
                          gpointer              item)
 {
   PangoFontFace *face;
-  PangoFontDescription *desc;
-  PangoFont *font;
-  PangoContext *context;
   GtkSelectionModel *model = gtk_list_view_get_model (GTK_LIST_VIEW (self->language_list));
   PangoLanguage *default_lang = pango_language_get_default ();
   PangoLanguage **langs;
@@ -1058,40 +1085,28 @@ add_languages_from_font (GtkFontChooserWidget *self,
   if (!face)
     return;
 
-  desc = pango_font_face_describe (face);
-  pango_font_description_set_size (desc, 20);
-
-  context = gtk_widget_get_pango_context (GTK_WIDGET (self));
-  font = pango_context_load_font (context, desc);
-
-  langs = pango_font_get_languages (font);
-  if (langs)
+  langs = get_face_languages (self, face);
+  for (i = 0; langs[i]; i++)
     {
-      for (i = 0; langs[i]; i++)
+      if (!g_hash_table_contains (self->language_table, langs[i]))
         {
-          if (!g_hash_table_contains (self->language_table, langs[i]))
+          g_hash_table_add (self->language_table, langs[i]);
+          if (get_language_name (langs[i]))
             {
-              g_hash_table_add (self->language_table, langs[i]);
-              if (get_language_name (langs[i]))
-                {
-                  const char *l = pango_language_to_string (langs[i]);
-                  gulong id = 0;
+              const char *l = pango_language_to_string (langs[i]);
+              gulong id = 0;
 
-                  /* Pre-select the default language */
-                  if (pango_language_matches (default_lang, l))
-                    id = g_signal_connect (model, "items-changed", G_CALLBACK (select_added), NULL);
+              /* Pre-select the default language */
+              if (pango_language_matches (default_lang, l))
+                id = g_signal_connect (model, "items-changed", G_CALLBACK (select_added), NULL);
 
-                  gtk_string_list_append (self->languages, l);
+              gtk_string_list_append (self->languages, l);
 
-                  if (id)
-                    g_signal_handler_disconnect (model, id);
-                }
+              if (id)
+                g_signal_handler_disconnect (model, id);
             }
         }
     }
-
-  g_object_unref (font);
-  pango_font_description_free (desc);
 }
 
 static gboolean
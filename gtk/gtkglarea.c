@@ -149,6 +149,13 @@ typedef struct {
   GdkTexture *holder;
 } Texture;
 
+/* The texture the application renders into, and up to two that
+ * were rendered before and may still be in use by the renderer or
+ * the compositor. Released textures are kept around up to this
+ * number, so rendering does not wait for or reallocate a buffer.
+ */
+#define MAX_TEXTURES 3
+
 typedef struct {
   GdkGLContext *context;
   GError *error;
@@ -431,6 +438,7 @@ gtk_gl_area_ensure_texture (GtkGLArea *area)
   if (priv->texture == NULL)
     {
       GList *l, *link;
+      guint n_kept = 1;
 
       l = priv->textures;
       while (l)
@@ -440,14 +448,25 @@ gtk_gl_area_ensure_texture (GtkGLArea *area)
           l = l->next;
 
           if (texture->holder)
-            continue;
-
-          priv->textures = g_list_delete_link (priv->textures, link);
+            {
+              n_kept++;
+              continue;
+            }
 
           if (priv->texture == NULL)
-            priv->texture = texture;
+            {
+              priv->textures = g_list_delete_link (priv->textures, link);
+              priv->texture = texture;
+            }
+          else if (n_kept < MAX_TEXTURES)
+            {
+              n_kept++;
+            }
           else
-            delete_one_texture (texture);
+            {
+              priv->textures = g_list_delete_link (priv->textures, link);
+              delete_one_texture (texture);
+            }
         }
     }
 
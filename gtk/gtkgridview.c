@@ -93,6 +93,8 @@ struct _GtkGridView
   /* set in size_allocate */
   guint n_columns;
   double column_width;
+  /* set in size_allocate if all rows have the same height, 0 otherwise */
+  int row_height;
 };
 
 struct _GtkGridViewClass
@@ -326,12 +328,29 @@ gtk_grid_view_get_allocation (GtkListBase  *base,
   guint offset;
   int xspacing, yspacing;
 
+  gtk_list_base_get_border_spacing (base, &xspacing, &yspacing);
+
+  if (self->row_height > 0)
+    {
+      /* all rows are the same size, so we can compute the area directly */
+      guint col;
+
+      if (pos >= gtk_list_base_get_n_items (base))
+        return FALSE;
+
+      col = pos % self->n_columns;
+      area->x = column_start (self, xspacing, col);
+      area->width = column_end (self, xspacing, col) - area->x;
+      area->y = (pos / self->n_columns) * (self->row_height + yspacing);
+      area->height = self->row_height;
+
+      return TRUE;
+    }
+
   tile = gtk_list_item_manager_get_nth (self->item_manager, pos, &offset);
   if (tile == NULL)
     return FALSE;
 
-  gtk_list_base_get_border_spacing (base, &xspacing, &yspacing);
-
   if (tile->area.width <= 0 || tile->area.height <= 0)
     {
       /* item is not allocated yet */
@@ -395,6 +414,36 @@ gtk_grid_view_get_position_from_allocation (GtkListBase           *base,
   GtkListTile *tile;
   guint pos;
 
+  if (self->row_height > 0)
+    {
+      /* all rows are the same size, so skip the tile lookup */
+      guint n_items, row, col;
+      int xspacing, yspacing;
+
+      n_items = gtk_list_base_get_n_items (base);
+      if (n_items == 0)
+        return FALSE;
+
+      gtk_list_base_get_border_spacing (base, &xspacing, &yspacing);
+
+      row = MAX (y, 0) / (self->row_height + yspacing);
+      col = MIN (column_index (self, xspacing, MAX (x, 0)), self->n_columns - 1);
+      pos = MIN ((guint64) row * self->n_columns + col, n_items - 1);
+
+      if (area)
+        {
+          col = pos % self->n_columns;
+          area->x = column_start (self, xspacing, col);
+          area->width = column_end (self, xspacing, col) - area->x;
+          area->y = (pos / self->n_columns) * (self->row_height + yspacing);
+          area->height = self->row_height;
+        }
+
+      *position = pos;
+
+      return TRUE;
+    }
+
   tile = gtk_list_item_manager_get_nearest_tile (self->item_manager, x, y);
   if (tile == NULL)
     return FALSE;
@@ -745,7 +794,7 @@ gtk_grid_view_size_allocate (GtkWidget *widget,
   GtkGridView *self = GTK_GRID_VIEW (widget);
   GtkListTile *tile, *start;
   GArray *heights;
-  int min_row_height, unknown_row_height, row_height, col_min, col_nat;
+  int min_row_height, unknown_row_height, uniform_row_height, row_height, col_min, col_nat;
   GtkOrientation orientation;
   GtkScrollablePolicy scroll_policy;
   int y, xspacing, yspacing;
@@ -757,6 +806,7 @@ gtk_grid_view_size_allocate (GtkWidget *widget,
   gtk_list_base_get_border_spacing (GTK_LIST_BASE (self), &xspacing, &yspacing);
 
   gtk_list_item_manager_gc_tiles (self->item_manager);
+  self->row_height = 0;
 
   /* step 0: exit early if list is empty */
   tile = gtk_list_item_manager_get_first (self->item_manager);
@@ -835,6 +885,13 @@ gtk_grid_view_size_allocate (GtkWidget *widget,
 
   /* step 3: determine height of rows with only unknown items */
   unknown_row_height = gtk_grid_view_get_unknown_row_size (self, heights);
+  /* heights are sorted now, so if the extremes match, every cell has
+   * the same size and so does every row */
+  if (heights->len > 0 &&
+      g_array_index (heights, int, 0) == g_array_index (heights, int, heights->len - 1))
+    uniform_row_height = unknown_row_height;
+  else
+    uniform_row_height = 0;
   g_array_free (heights, TRUE);
 
   /* step 4: determine height for remaining rows and set each row's position */
@@ -861,10 +918,13 @@ gtk_grid_view_size_allocate (GtkWidget *widget,
         }
       else
         {
-          if (tile->area.height == 0)
+          if (tile->area.height == 0 ||
+              (uniform_row_height > 0 && tile->area.height != uniform_row_height))
             {
               /* this case is for the last row - it may not be a full row so it won't
-               * be a multirow tile but it may have no widgets either */
+               * be a multirow tile but it may have no widgets either.
+               * With uniform rows, it also catches leftover sizes from earlier
+               * allocations of rows without widgets. */
               gtk_list_tile_set_area_size (self->item_manager,
                                            tile,
                                            column_end (self, xspacing, i + tile->n_items - 1) - tile->area.x,
@@ -896,6 +956,10 @@ gtk_grid_view_size_allocate (GtkWidget *widget,
                                    tile->area.height);
     }
 
+  /* With uniform rows, position lookups and allocations can be computed
+   * directly instead of walking the tiles. */
+  self->row_height = uniform_row_height;
+
   /* step 4: allocate the rest */
   gtk_list_base_allocate (GTK_LIST_BASE (self));
 }
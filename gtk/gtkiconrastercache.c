@@ -0,0 +1,215 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkiconrastercacheprivate.h"
+
+#include "gtkversion.h"
+#include "gdk/gdkmemoryformatprivate.h"
+
+#include <glib/gstdio.h>
+#include <string.h>
+
+/* The raster cache keeps rasterized SVG icons on disk, so that
+ * other processes (and later runs of this one) can map them
+ * instead of parsing and rendering the SVG again.
+ *
+ * Every rendering lives in its own file, named by a hash of the
+ * source file, its modification time and size, and the parameters
+ * it was rendered with. Files are only ever replaced atomically, so
+ * concurrent writers and readers can't see partial data, and a
+ * changed icon simply ends up under a different name.
+ *
+ * The file contents are a CacheHeader followed by the pixel data
+ * in the texture's native memory format, which is used as-is for
+ * a memory texture.
+ */
+
+#define CACHE_MAGIC   0x43524947 /* "GIRC" */
+#define CACHE_VERSION 1
+
+typedef struct
+{
+  guint32 magic;
+  guint32 version;
+  guint32 format;
+  guint32 width;
+  guint32 height;
+  guint32 stride;
+  guint32 padding[2];
+} CacheHeader;
+
+static char *
+get_cache_dir (void)
+{
+  return g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "icons", NULL);
+}
+
+static char *
+get_cache_path (const char *filename,
+                int         size,
+                int         scale,
+                gboolean    symbolic)
+{
+  GStatBuf st;
+  char *key, *hash, *dir, *path;
+
+  if (g_stat (filename, &st) != 0)
+    return NULL;
+
+  key = g_strdup_printf ("%s\n%" G_GINT64_FORMAT "\n%" G_GINT64_FORMAT "\n%d\n%d\n%d\n%d.%d.%d",
+                         filename,
+                         (gint64) st.st_mtime,
+                         (gint64) st.st_size,
+                         size, scale, symbolic ? 1 : 0,
+                         GTK_MAJOR_VERSION, GTK_MINOR_VERSION, GTK_MICRO_VERSION);
+  hash = g_compute_checksum_for_string (G_CHECKSUM_SHA1, key, -1);
+
+  dir = get_cache_dir ();
+  path = g_build_filename (dir, hash, NULL);
+
+  g_free (dir);
+  g_free (hash);
+  g_free (key);
+
+  return path;
+}
+
+/*< private >
+ * gtk_icon_raster_cache_lookup:
+ * @filename: the icon file
+ * @size: the size the icon was rendered at, in pixels
+ * @scale: the scale the icon was rendered for
+ * @symbolic: whether the icon was rendered as a symbolic icon
+ *
+ * Looks up a previous rendering of @filename in the cache.
+ *
+ * The returned texture maps the cache file, so this is cheap.
+ *
+ * Returns: (nullable) (transfer full): the texture
+ */
+GdkTexture *
+gtk_icon_raster_cache_lookup (const char *filename,
+                              int         size,
+                              int         scale,
+                              gboolean    symbolic)
+{
+  GMappedFile *map;
+  CacheHeader header;
+  GBytes *bytes, *pixels;
+  GdkTexture *texture;
+  char *path;
+  gsize len;
+
+  path = get_cache_path (filename, size, scale, symbolic);
+  if (path == NULL)
+    return NULL;
+
+  map = g_mapped_file_new (path, FALSE, NULL);
+  g_free (path);
+  if (map == NULL)
+    return NULL;
+
+  len = g_mapped_file_get_length (map);
+  if (len < sizeof (CacheHeader))
+    goto invalid;
+
+  memcpy (&header, g_mapped_file_get_contents (map), sizeof (CacheHeader));
+  if (header.magic != CACHE_MAGIC ||
+      header.version != CACHE_VERSION ||
+      header.format >= GDK_MEMORY_N_FORMATS ||
+      header.width == 0 || header.height == 0 ||
+      header.stride < header.width * gdk_memory_format_bytes_per_pixel (header.format) ||
+      len - sizeof (CacheHeader) < (gsize) header.stride * (header.height - 1) +
+                                   header.width * gdk_memory_format_bytes_per_pixel (header.format))
+    goto invalid;
+
+  bytes = g_mapped_file_get_bytes (map);
+  pixels = g_bytes_new_from_bytes (bytes, sizeof (CacheHeader), len - sizeof (CacheHeader));
+  texture = gdk_memory_texture_new (header.width, header.height,
+                                    header.format,
+                                    pixels,
+                                    header.stride);
+  g_bytes_unref (pixels);
+  g_bytes_unref (bytes);
+  g_mapped_file_unref (map);
+
+  return texture;
+
+invalid:
+  g_mapped_file_unref (map);
+  return NULL;
+}
+
+/*< private >
+ * gtk_icon_raster_cache_store:
+ * @filename: the icon file
+ * @size: the size the icon was rendered at, in pixels
+ * @scale: the scale the icon was rendered for
+ * @symbolic: whether the icon was rendered as a symbolic icon
+ * @texture: the rendering
+ *
+ * Stores a rendering of @filename in the cache. Errors are ignored,
+ * the cache is only an optimization.
+ */
+void
+gtk_icon_raster_cache_store (const char *filename,
+                             int         size,
+                             int         scale,
+                             gboolean    symbolic,
+                             GdkTexture *texture)
+{
+  GdkTextureDownloader *downloader;
+  GdkMemoryFormat format;
+  CacheHeader header;
+  GBytes *bytes;
+  gsize stride, len;
+  char *path, *dir, *data;
+
+  path = get_cache_path (filename, size, scale, symbolic);
+  if (path == NULL)
+    return;
+
+  format = gdk_texture_get_format (texture);
+  downloader = gdk_texture_downloader_new (texture);
+  gdk_texture_downloader_set_format (downloader, format);
+  bytes = gdk_texture_downloader_download_bytes (downloader, &stride);
+  gdk_texture_downloader_free (downloader);
+
+  memset (&header, 0, sizeof (CacheHeader));
+  header.magic = CACHE_MAGIC;
+  header.version = CACHE_VERSION;
+  header.format = format;
+  header.width = gdk_texture_get_width (texture);
+  header.height = gdk_texture_get_height (texture);
+  header.stride = stride;
+
+  len = sizeof (CacheHeader) + g_bytes_get_size (bytes);
+  data = g_malloc (len);
+  memcpy (data, &header, sizeof (CacheHeader));
+  memcpy (data + sizeof (CacheHeader), g_bytes_get_data (bytes, NULL), g_bytes_get_size (bytes));
+
+  dir = get_cache_dir ();
+  if (g_mkdir_with_parents (dir, 0700) == 0)
+    g_file_set_contents_full (path, data, len, G_FILE_SET_CONTENTS_CONSISTENT, 0600, NULL);
+
+  g_free (dir);
+  g_free (data);
+  g_bytes_unref (bytes);
+  g_free (path);
+}
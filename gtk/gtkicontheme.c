@@ -44,10 +44,12 @@
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkdebug.h"
 #include "gtkiconcacheprivate.h"
+#include "gtkiconrastercacheprivate.h"
 #include "gtkmain.h"
 #include "gtkprivate.h"
 #include "gtksettingsprivate.h"
 #include "gtksnapshot.h"
+#include "gtkstartupprivate.h"
 #include "gtkstyleproviderprivate.h"
 #include "gtksymbolicpaintable.h"
 #include "gtkwidgetprivate.h"
@@ -304,8 +306,26 @@ typedef enum
 #define DEBUG_CACHE(args)
 #endif
 
-#define LRU_CACHE_SIZE 100
-#define MAX_LRU_TEXTURE_SIZE 128
+/* The default for GtkSettings:gtk-icon-cache-size, in bytes */
+#define DEFAULT_LRU_CACHE_BUDGET (8 * 1024 * 1024)
+
+/* Recently used icons are kept alive in a separate lru list for
+ * each size class, so that a few large icons can't push out all
+ * the small ones. Each list gets an equal share of the budget.
+ */
+typedef enum
+{
+  LRU_CACHE_SMALL,      /* up to 32 pixels */
+  LRU_CACHE_MEDIUM,     /* up to 128 pixels */
+  LRU_CACHE_LARGE,
+  N_LRU_CACHES
+} LruCacheClass;
+
+typedef struct
+{
+  GQueue icons;         /* most recently used first */
+  gsize size;           /* estimated memory use of the icons, in bytes */
+} LruCache;
 
 typedef struct _GtkIconPaintableClass GtkIconPaintableClass;
 typedef struct _GtkIconThemeClass     GtkIconThemeClass;
@@ -328,8 +348,11 @@ struct _GtkIconTheme
 
   GHashTable *icon_cache;                       /* Protected by icon_cache lock */
 
-  GtkIconPaintable *lru_cache[LRU_CACHE_SIZE];  /* Protected by icon_cache lock */
-  int lru_cache_current;                        /* Protected by icon_cache lock */
+  LruCache lru_cache[N_LRU_CACHES];             /* Protected by icon_cache lock */
+  gsize lru_cache_budget;                       /* Protected by icon_cache lock */
+  guint cache_hits;                             /* Protected by icon_cache lock */
+  guint cache_misses;                           /* Protected by icon_cache lock */
+  guint cache_evictions;                        /* Protected by icon_cache lock */
 
   GtkStringSet icons;
 
@@ -399,6 +422,7 @@ struct _GtkIconPaintable
    */
   IconKey key;
   GtkIconTheme *in_cache; /* Protected by icon_cache lock */
+  GList lru_link;         /* Protected by icon_cache lock, data is set while in the lru cache */
 
   char *icon_name;
   char *filename;
@@ -494,7 +518,8 @@ static GtkIconPaintable *theme_lookup_icon                (IconTheme        *the
 static void              theme_subdir_load                (GtkIconTheme     *self,
                                                            IconTheme        *theme,
                                                            GKeyFile         *theme_file,
-                                                           char             *subdir);
+                                                           char             *subdir,
+                                                           GHashTable       *listings);
 static void              do_theme_change                  (GtkIconTheme     *self);
 static void              blow_themes                      (GtkIconTheme     *self);
 static gboolean          rescan_themes                    (GtkIconTheme     *self);
@@ -662,36 +687,85 @@ icon_key_equal (gconstpointer _a,
  */
 
 /* This is called with icon_cache lock held so must not take any locks */
-static gboolean
-_icon_cache_should_lru_cache (GtkIconPaintable *icon)
+static LruCache *
+_icon_cache_get_lru_cache (GtkIconTheme     *theme,
+                           GtkIconPaintable *icon)
 {
-  return icon->desired_size <= MAX_LRU_TEXTURE_SIZE;
+  int size = icon->desired_size * icon->desired_scale;
+
+  if (size <= 32)
+    return &theme->lru_cache[LRU_CACHE_SMALL];
+  else if (size <= 128)
+    return &theme->lru_cache[LRU_CACHE_MEDIUM];
+  else
+    return &theme->lru_cache[LRU_CACHE_LARGE];
 }
 
-/* This returns the old lru element because we can't unref it with
- * the lock held */
-static GtkIconPaintable *
+/* The texture may not be loaded yet, and we can't take the
+ * texture lock here, so this estimates the memory use from
+ * the requested size.
+ */
+static gsize
+_icon_cache_get_icon_size (GtkIconPaintable *icon)
+{
+  gsize size = icon->desired_size * icon->desired_scale;
+
+  return size * size * 4;
+}
+
+/* Drops the least recently used icons until the lru cache fits
+ * in @budget. This returns the dropped icons because
+ * we can't unref them with the lock held.
+ */
+static GSList *
+_icon_cache_evict (GtkIconTheme *theme,
+                   LruCache     *cache,
+                   gsize         budget,
+                   GSList       *old_icons)
+{
+  while (cache->size > budget)
+    {
+      GList *link = g_queue_pop_tail_link (&cache->icons);
+      GtkIconPaintable *icon = link->data;
+
+      link->data = NULL;
+      cache->size -= _icon_cache_get_icon_size (icon);
+      theme->cache_evictions++;
+
+      old_icons = g_slist_prepend (old_icons, icon);
+    }
+
+  return old_icons;
+}
+
+/* This returns the evicted lru elements because we can't unref
+ * them with the lock held */
+static GSList *
 _icon_cache_add_to_lru_cache (GtkIconTheme     *theme,
                               GtkIconPaintable *icon)
 {
-  GtkIconPaintable *old_icon = NULL;
+  LruCache *cache = _icon_cache_get_lru_cache (theme, icon);
 
-  /* Avoid storing the same info multiple times in a row */
-  if (theme->lru_cache[theme->lru_cache_current] != icon)
+  if (icon->lru_link.data != NULL)
     {
-      theme->lru_cache_current = (theme->lru_cache_current + 1) % LRU_CACHE_SIZE;
-      old_icon = theme->lru_cache[theme->lru_cache_current];
-      theme->lru_cache[theme->lru_cache_current] = g_object_ref (icon);
+      /* Move item to front */
+      g_queue_unlink (&cache->icons, &icon->lru_link);
+      g_queue_push_head_link (&cache->icons, &icon->lru_link);
+      return NULL;
     }
 
-  return old_icon;
+  icon->lru_link.data = g_object_ref (icon);
+  g_queue_push_head_link (&cache->icons, &icon->lru_link);
+  cache->size += _icon_cache_get_icon_size (icon);
+
+  return _icon_cache_evict (theme, cache, theme->lru_cache_budget / N_LRU_CACHES, NULL);
 }
 
 static GtkIconPaintable *
 icon_cache_lookup (GtkIconTheme *theme,
                    IconKey      *key)
 {
-  GtkIconPaintable *old_icon = NULL;
+  GSList *old_icons = NULL;
   GtkIconPaintable *icon;
 
   G_LOCK (icon_cache);
@@ -706,17 +780,18 @@ icon_cache_lookup (GtkIconTheme *theme,
                     g_hash_table_size (theme->icon_cache)));
 
       icon = g_object_ref (icon);
+      theme->cache_hits++;
 
       /* Move item to front in LRU cache */
-      if (_icon_cache_should_lru_cache (icon))
-        old_icon = _icon_cache_add_to_lru_cache (theme, icon);
+      old_icons = _icon_cache_add_to_lru_cache (theme, icon);
     }
+  else
+    theme->cache_misses++;
 
   G_UNLOCK (icon_cache);
 
-  /* Call potential finalizer outside the lock */
-  if (old_icon)
-    g_object_unref (old_icon);
+  /* Call potential finalizers outside the lock */
+  g_slist_free_full (old_icons, g_object_unref);
 
   return icon;
 }
@@ -740,33 +815,28 @@ icon_uncached_cb (GtkIconPaintable *icon)
 static void
 icon_cache_mark_used_if_cached (GtkIconPaintable *icon)
 {
-  GtkIconPaintable *old_icon = NULL;
-
-  if (!_icon_cache_should_lru_cache (icon))
-    return;
+  GSList *old_icons = NULL;
 
   G_LOCK (icon_cache);
   if (icon->in_cache)
-    old_icon = _icon_cache_add_to_lru_cache (icon->in_cache, icon);
+    old_icons = _icon_cache_add_to_lru_cache (icon->in_cache, icon);
   G_UNLOCK (icon_cache);
 
   /* Call potential finalizers outside the lock */
-  if (old_icon)
-    g_object_unref (old_icon);
+  g_slist_free_full (old_icons, g_object_unref);
 }
 
 static void
 icon_cache_add (GtkIconTheme     *theme,
                 GtkIconPaintable *icon)
 {
-  GtkIconPaintable *old_icon = NULL;
+  GSList *old_icons = NULL;
 
   G_LOCK (icon_cache);
   icon->in_cache = theme;
   g_hash_table_insert (theme->icon_cache, &icon->key, icon);
 
-  if (_icon_cache_should_lru_cache (icon))
-    old_icon = _icon_cache_add_to_lru_cache (theme, icon);
+  old_icons = _icon_cache_add_to_lru_cache (theme, icon);
   DEBUG_CACHE (("adding %p (%s %d 0x%x) to cache (cache size %d)\n",
                 icon,
                 g_strjoinv (",", icon->key.icon_names),
@@ -774,9 +844,8 @@ icon_cache_add (GtkIconTheme     *theme,
                 g_hash_table_size (theme->icon_cache)));
   G_UNLOCK (icon_cache);
 
-  /* Call potential finalizer outside the lock */
-  if (old_icon)
-    g_object_unref (old_icon);
+  /* Call potential finalizers outside the lock */
+  g_slist_free_full (old_icons, g_object_unref);
 }
 
 static void
@@ -788,27 +857,104 @@ icon_cache_remove (GtkIconPaintable *icon)
   G_UNLOCK (icon_cache);
 }
 
+static void
+icon_cache_set_budget (GtkIconTheme *theme,
+                       gsize         budget)
+{
+  GSList *old_icons = NULL;
+  int i;
+
+  G_LOCK (icon_cache);
+  theme->lru_cache_budget = budget;
+  for (i = 0; i < N_LRU_CACHES; i++)
+    old_icons = _icon_cache_evict (theme, &theme->lru_cache[i], budget / N_LRU_CACHES, old_icons);
+  G_UNLOCK (icon_cache);
+
+  /* Call potential finalizers outside the lock */
+  g_slist_free_full (old_icons, g_object_unref);
+}
+
 static void
 icon_cache_clear (GtkIconTheme *theme)
 {
+  GSList *old_icons = NULL;
   int i;
-  GtkIconPaintable *old_icons[LRU_CACHE_SIZE];
 
   G_LOCK (icon_cache);
   g_hash_table_remove_all (theme->icon_cache);
-  for (i = 0; i < LRU_CACHE_SIZE; i ++)
+  for (i = 0; i < N_LRU_CACHES; i++)
     {
-      old_icons[i] = theme->lru_cache[i];
-      theme->lru_cache[i] = NULL;
+      LruCache *cache = &theme->lru_cache[i];
+      GList *link;
+
+      while ((link = g_queue_pop_head_link (&cache->icons)) != NULL)
+        {
+          old_icons = g_slist_prepend (old_icons, link->data);
+          link->data = NULL;
+        }
+      cache->size = 0;
     }
   G_UNLOCK (icon_cache);
 
   /* Call potential finalizers outside the lock */
-  for (i = 0; i < LRU_CACHE_SIZE; i ++)
-    {
-      if (old_icons[i] != NULL)
-        g_object_unref (old_icons[i]);
-    }
+  g_slist_free_full (old_icons, g_object_unref);
+}
+
+/*< private >
+ * gtk_icon_theme_get_cache_stats:
+ * @self: a `GtkIconTheme`
+ * @stats: (out caller-allocates): return location for the statistics
+ *
+ * Gets the counters of the icon cache of @self, for the inspector.
+ */
+void
+gtk_icon_theme_get_cache_stats (GtkIconTheme      *self,
+                                GtkIconCacheStats *stats)
+{
+  int i;
+
+  G_LOCK (icon_cache);
+  stats->n_hits = self->cache_hits;
+  stats->n_misses = self->cache_misses;
+  stats->n_evictions = self->cache_evictions;
+  stats->size = 0;
+  for (i = 0; i < N_LRU_CACHES; i++)
+    stats->size += self->lru_cache[i].size;
+  stats->budget = self->lru_cache_budget;
+  G_UNLOCK (icon_cache);
+}
+
+/*< private >
+ * gtk_icon_theme_trim:
+ * @self: a `GtkIconTheme`
+ * @level: how urgently memory should be freed
+ *
+ * Drops recently used icons that are only kept alive by the
+ * cache of @self. The higher @level is, the more of them are
+ * dropped. The budget for the cache is not changed, so it fills
+ * up again as icons are used.
+ */
+void
+gtk_icon_theme_trim (GtkIconTheme               *self,
+                     GMemoryMonitorWarningLevel  level)
+{
+  GSList *old_icons = NULL;
+  gsize budget;
+  int i;
+
+  G_LOCK (icon_cache);
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL)
+    budget = 0;
+  else if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM)
+    budget = self->lru_cache_budget / 4;
+  else
+    budget = self->lru_cache_budget / 2;
+  for (i = 0; i < N_LRU_CACHES; i++)
+    old_icons = _icon_cache_evict (self, &self->lru_cache[i], budget / N_LRU_CACHES, old_icons);
+  G_UNLOCK (icon_cache);
+
+  /* Call potential finalizers outside the lock */
+  g_slist_free_full (old_icons, g_object_unref);
 }
 
 /****************** End of icon cache ***********************/
@@ -885,6 +1031,8 @@ gtk_icon_theme_get_for_display (GdkDisplay *display)
   self = g_object_get_data (G_OBJECT (display), "gtk-icon-theme");
   if (!self)
     {
+      gtk_startup_phase_begin ("icon theme");
+
       self = gtk_icon_theme_new ();
       self->is_display_singleton = TRUE;
       g_object_set_data (G_OBJECT (display), I_("gtk-icon-theme"), self);
@@ -894,6 +1042,8 @@ gtk_icon_theme_get_for_display (GdkDisplay *display)
 
       /* Queue early read of the default themes, we read the icon theme name in set_display(). */
       gtk_icon_theme_load_in_thread (self);
+
+      gtk_startup_phase_end (self->current_theme);
     }
 
   return self;
@@ -1162,6 +1312,37 @@ theme_changed__mainthread_unlocked (GtkSettings     *settings,
   gtk_icon_theme_ref_release (ref);
 }
 
+static void
+update_cache_budget (GtkIconTheme *self)
+{
+  gsize budget = DEFAULT_LRU_CACHE_BUDGET;
+
+  if (self->display_settings)
+    {
+      int size;
+
+      g_object_get (self->display_settings, "gtk-icon-cache-size", &size, NULL);
+      budget = MIN ((gsize) size, G_MAXSIZE / 1024) * 1024;
+    }
+
+  icon_cache_set_budget (self, budget);
+}
+
+/* Callback when the icon cache size GtkSetting changes
+ */
+static void
+cache_size_changed__mainthread_unlocked (GtkSettings     *settings,
+                                         GParamSpec      *pspec,
+                                         GtkIconThemeRef *ref)
+{
+  GtkIconTheme *self = gtk_icon_theme_ref_aquire (ref);
+
+  if (self)
+    update_cache_budget (self);
+
+  gtk_icon_theme_ref_release (ref);
+}
+
 static void
 gtk_icon_theme_unset_display (GtkIconTheme *self)
 {
@@ -1173,10 +1354,15 @@ gtk_icon_theme_unset_display (GtkIconTheme *self)
       g_signal_handlers_disconnect_by_func (self->display_settings,
                                             (gpointer) theme_changed__mainthread_unlocked,
                                             self->ref);
+      g_signal_handlers_disconnect_by_func (self->display_settings,
+                                            (gpointer) cache_size_changed__mainthread_unlocked,
+                                            self->ref);
 
       self->display = NULL;
       self->display_settings = NULL;
 
+      update_cache_budget (self);
+
       g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DISPLAY]);
     }
 }
@@ -1209,6 +1395,13 @@ gtk_icon_theme_set_display (GtkIconTheme *self,
                              gtk_icon_theme_ref_ref (self->ref),
                              (GClosureNotify)gtk_icon_theme_ref_unref,
                              0);
+      g_signal_connect_data (self->display_settings, "notify::gtk-icon-cache-size",
+                             G_CALLBACK (cache_size_changed__mainthread_unlocked),
+                             gtk_icon_theme_ref_ref (self->ref),
+                             (GClosureNotify)gtk_icon_theme_ref_unref,
+                             0);
+
+      update_cache_budget (self);
 
       g_object_notify_by_pspec (G_OBJECT (self), props[PROP_DISPLAY]);
     }
@@ -1275,6 +1468,9 @@ gtk_icon_theme_init (GtkIconTheme *self)
 
   self->icon_cache = g_hash_table_new_full (icon_key_hash, icon_key_equal, NULL,
                                             (GDestroyNotify)icon_uncached_cb);
+  for (i = 0; i < N_LRU_CACHES; i++)
+    g_queue_init (&self->lru_cache[i].icons);
+  self->lru_cache_budget = DEFAULT_LRU_CACHE_BUDGET;
 
   self->custom_theme = FALSE;
   self->dir_mtimes = g_array_new (FALSE, TRUE, sizeof (IconThemeDirMtime));
@@ -1729,6 +1925,119 @@ gtk_icon_theme_get_theme_name (GtkIconTheme *self)
   return theme_name;
 }
 
+typedef struct
+{
+  char *path;
+  GPtrArray *names;     /* NULL if the directory can't be read */
+} DirListing;
+
+static void
+read_dir_thread (gpointer data,
+                 gpointer user_data)
+{
+  DirListing *listing = data;
+  const char *name;
+  GDir *gdir;
+
+  gdir = g_dir_open (listing->path, 0, NULL);
+  if (gdir == NULL)
+    return;
+
+  listing->names = g_ptr_array_new_with_free_func (g_free);
+  while ((name = g_dir_read_name (gdir)))
+    g_ptr_array_add (listing->names, g_strdup (name));
+
+  g_dir_close (gdir);
+}
+
+static void
+free_dir_names (GPtrArray *names)
+{
+  if (names)
+    g_ptr_array_unref (names);
+}
+
+/* Without an icon cache, loading a theme means listing every
+ * subdirectory in every theme directory, and that time is mostly
+ * spent waiting for the file system. So read all of them in
+ * parallel up front, and let theme_subdir_load() use the results.
+ *
+ * Returns a hash table mapping the subdirectory paths to a
+ * GPtrArray of file names, or to NULL if they couldn't be read.
+ */
+static GHashTable *
+read_theme_dirs (GtkIconTheme  *self,
+                 char         **dirs,
+                 char         **scaled_dirs)
+{
+  GHashTable *listings;
+  GThreadPool *pool;
+  GArray *todo;
+  guint i, j;
+
+  todo = g_array_new (FALSE, FALSE, sizeof (DirListing));
+
+  for (i = 0; i < self->dir_mtimes->len; i++)
+    {
+      IconThemeDirMtime *dir_mtime = &g_array_index (self->dir_mtimes, IconThemeDirMtime, i);
+      const char *sep;
+
+      if (!dir_mtime->exists)
+        continue;
+
+      /* This will return NULL if the cache doesn't exist or is outdated */
+      if (dir_mtime->cache == NULL)
+        dir_mtime->cache = gtk_icon_cache_new_for_path (dir_mtime->dir);
+      if (dir_mtime->cache != NULL)
+        continue;
+
+      /* Build the paths the same way as theme_subdir_load() */
+      sep = g_str_has_suffix (dir_mtime->dir, "/") ? "" : "/";
+
+      for (j = 0; dirs[j]; j++)
+        {
+          DirListing listing = { g_strconcat (dir_mtime->dir, sep, dirs[j], NULL), NULL };
+          g_array_append_val (todo, listing);
+        }
+
+      for (j = 0; scaled_dirs && scaled_dirs[j]; j++)
+        {
+          DirListing listing = { g_strconcat (dir_mtime->dir, sep, scaled_dirs[j], NULL), NULL };
+          g_array_append_val (todo, listing);
+        }
+    }
+
+  if (todo->len < 2)
+    {
+      for (i = 0; i < todo->len; i++)
+        g_free (g_array_index (todo, DirListing, i).path);
+      g_array_unref (todo);
+      return NULL;
+    }
+
+  GTK_DISPLAY_DEBUG (self->display, ICONTHEME, "reading %u directories", todo->len);
+
+  pool = g_thread_pool_new (read_dir_thread, NULL,
+                            MIN (g_get_num_processors (), 8),
+                            FALSE, NULL);
+  for (i = 0; i < todo->len; i++)
+    g_thread_pool_push (pool, &g_array_index (todo, DirListing, i), NULL);
+  /* Waits for all the directories to be read */
+  g_thread_pool_free (pool, FALSE, TRUE);
+
+  listings = g_hash_table_new_full (g_str_hash, g_str_equal,
+                                    g_free, (GDestroyNotify) free_dir_names);
+  for (i = 0; i < todo->len; i++)
+    {
+      DirListing *listing = &g_array_index (todo, DirListing, i);
+      g_hash_table_replace (listings, listing->path, listing->names);
+    }
+
+  g_array_unref (todo);
+
+  return listings;
+}
+
 static void
 insert_theme (GtkIconTheme *self,
               const char   *theme_name)
@@ -1742,6 +2051,7 @@ insert_theme (GtkIconTheme *self,
   char *path;
   GKeyFile *theme_file;
   GStatBuf stat_buf;
+  GHashTable *listings;
 
   for (l = self->themes; l != NULL; l = l->next)
     {
@@ -1824,15 +2134,18 @@ insert_theme (GtkIconTheme *self,
   theme = theme_new (theme_name, theme_file);
   self->themes = g_list_prepend (self->themes, theme);
 
+  listings = read_theme_dirs (self, dirs, scaled_dirs);
+
   for (i = 0; dirs[i] != NULL; i++)
-    theme_subdir_load (self, theme, theme_file, dirs[i]);
+    theme_subdir_load (self, theme, theme_file, dirs[i], listings);
 
   if (scaled_dirs)
     {
       for (i = 0; scaled_dirs[i] != NULL; i++)
-        theme_subdir_load (self, theme, theme_file, scaled_dirs[i]);
+        theme_subdir_load (self, theme, theme_file, scaled_dirs[i], listings);
     }
 
+  g_clear_pointer (&listings, g_hash_table_unref);
   g_strfreev (dirs);
   g_strfreev (scaled_dirs);
 
@@ -3111,6 +3424,31 @@ theme_lookup_icon (IconTheme   *theme,
   return NULL;
 }
 
+/* Strips the suffix from name in place */
+static GHashTable *
+add_icon_file_name (GHashTable   *icons,
+                    char         *name,
+                    GtkStringSet *set)
+{
+  const char *interned;
+  IconCacheFlag suffix, hash_suffix;
+
+  suffix = suffix_from_name (name);
+  if (suffix == ICON_CACHE_FLAG_NONE)
+    return icons;
+
+  strip_suffix_inline (name, suffix);
+  interned = gtk_string_set_add (set, name);
+
+  if (!icons)
+    icons = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, NULL);
+
+  hash_suffix = GPOINTER_TO_INT (g_hash_table_lookup (icons, interned));
+  g_hash_table_replace (icons, (char *)interned, GUINT_TO_POINTER (hash_suffix|suffix));
+
+  return icons;
+}
+
 static GHashTable *
 scan_directory (GtkIconTheme  *self,
                 char          *full_dir,
@@ -3128,25 +3466,22 @@ scan_directory (GtkIconTheme  *self,
     return NULL;
 
   while ((name = g_dir_read_name (gdir)))
-    {
-      const char *interned;
-      IconCacheFlag suffix, hash_suffix;
+    icons = add_icon_file_name (icons, (char *)name, set);
 
-      suffix = suffix_from_name (name);
-      if (suffix == ICON_CACHE_FLAG_NONE)
-        continue;
-
-      strip_suffix_inline ((char *)name, suffix);
-      interned = gtk_string_set_add (set, name);
+  g_dir_close (gdir);
 
-      if (!icons)
-        icons = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, NULL);
+  return icons;
+}
 
-      hash_suffix = GPOINTER_TO_INT (g_hash_table_lookup (icons, interned));
-      g_hash_table_replace (icons, (char *)interned, GUINT_TO_POINTER (hash_suffix|suffix));
-    }
+static GHashTable *
+scan_directory_listing (GPtrArray     *names,
+                        GtkStringSet  *set)
+{
+  GHashTable *icons = NULL;
+  guint i;
 
-  g_dir_close (gdir);
+  for (i = 0; i < names->len; i++)
+    icons = add_icon_file_name (icons, g_ptr_array_index (names, i), set);
 
   return icons;
 }
@@ -3309,7 +3644,8 @@ static void
 theme_subdir_load (GtkIconTheme *self,
                    IconTheme    *theme,
                    GKeyFile     *theme_file,
-                   char         *subdir)
+                   char         *subdir,
+                   GHashTable   *listings)
 {
   char *type_string;
   IconThemeDirType type;
@@ -3323,6 +3659,8 @@ theme_subdir_load (GtkIconTheme *self,
   int scale;
   guint i;
   GString *str;
+  GPtrArray *names;
+  char *path;
 
   size = g_key_file_get_integer (theme_file, subdir, "Size", &error);
   if (error)
@@ -3384,8 +3722,32 @@ theme_subdir_load (GtkIconTheme *self,
         g_string_append_c (str, '/');
       g_string_append (str, subdir);
 
+      if (listings != NULL &&
+          g_hash_table_steal_extended (listings, str->str, (gpointer *) &path, (gpointer *) &names))
+        {
+          /* The directory has been read already, see read_theme_dirs() */
+          if (names)
+            {
+              GHashTable *icons = scan_directory_listing (names, &self->icons);
+
+              if (icons)
+                {
+                  theme_add_dir_with_icons (theme,
+                                            dir_size,
+                                            FALSE,
+                                            path,
+                                            icons);
+                  g_hash_table_destroy (icons);
+                  path = NULL;
+                }
+
+              g_ptr_array_unref (names);
+            }
+
+          g_free (path);
+        }
       /* First, see if we have a cache for the directory */
-      if (dir_mtime->cache != NULL || g_file_test (str->str, G_FILE_TEST_IS_DIR))
+      else if (dir_mtime->cache != NULL || g_file_test (str->str, G_FILE_TEST_IS_DIR))
         {
           GHashTable *icons = NULL;
 
@@ -3764,31 +4126,48 @@ icon_ensure_texture__locked (GtkIconPaintable *icon,
     {
       if (icon->is_svg)
         {
-          if (gtk_icon_paintable_is_symbolic (icon))
-            icon->texture = gdk_texture_new_from_path_symbolic (icon->filename,
-                                                                pixel_size, pixel_size,
-                                                                icon->desired_scale,
-                                                                &load_error);
-          else
-            {
-              GFile *file = g_file_new_for_path (icon->filename);
-              GInputStream *stream = G_INPUT_STREAM (g_file_read (file, NULL, &load_error));
+          gboolean symbolic = gtk_icon_paintable_is_symbolic (icon);
 
-              if (stream)
+          /* Rendering svgs is slow, so keep them around on disk */
+          icon->texture = gtk_icon_raster_cache_lookup (icon->filename,
+                                                        pixel_size, icon->desired_scale,
+                                                        symbolic);
+          if (icon->texture == NULL)
+            {
+              if (symbolic)
+                icon->texture = gdk_texture_new_from_path_symbolic (icon->filename,
+                                                                    pixel_size, pixel_size,
+                                                                    icon->desired_scale,
+                                                                    &load_error);
+              else
                 {
-                  icon->texture = gdk_texture_new_from_stream_at_scale (stream,
-                                                                        pixel_size, pixel_size,
-                                                                        TRUE, NULL,
-                                                                        &load_error);
-                  g_object_unref (stream);
+                  GFile *file = g_file_new_for_path (icon->filename);
+                  GInputStream *stream = G_INPUT_STREAM (g_file_read (file, NULL, &load_error));
+
+                  if (stream)
+                    {
+                      icon->texture = gdk_texture_new_from_stream_at_scale (stream,
+                                                                            pixel_size, pixel_size,
+                                                                            TRUE, NULL,
+                                                                            &load_error);
+                      g_object_unref (stream);
+                    }
+
+                  g_object_unref (file);
                 }
 
-              g_object_unref (file);
+              if (icon->texture)
+                gtk_icon_raster_cache_store (icon->filename,
+                                             pixel_size, icon->desired_scale,
+                                             symbolic,
+                                             icon->texture);
             }
         }
       else
         {
-          icon->texture = gdk_texture_new_from_filename (icon->filename, &load_error);
+          icon->texture = gdk_texture_new_from_filename_at_size (icon->filename,
+                                                                 pixel_size, pixel_size,
+                                                                 &load_error);
         }
     }
   else
@@ -3909,6 +4288,11 @@ gtk_icon_paintable_snapshot_symbolic (GtkSymbolicPaintable *paintable,
   texture = gtk_icon_paintable_ensure_texture (icon);
   symbolic = gtk_icon_paintable_is_symbolic (icon);
 
+  /* Symbolic icons are loaded once as a mask with the foreground,
+   * success, warning and error parts in separate channels, and are
+   * recolored by the renderer with a color matrix. That way the same
+   * texture (and atlas entry) is shared between all colors.
+   */
   if (symbolic)
     {
       graphene_matrix_t matrix;
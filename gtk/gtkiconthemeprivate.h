@@ -31,3 +31,17 @@ void gtk_icon_theme_lookup_symbolic_colors   (GtkCssStyle      *style,
 
 int gtk_icon_theme_get_serial (GtkIconTheme *self);
 
+typedef struct
+{
+  guint n_hits;
+  guint n_misses;
+  guint n_evictions;
+  gsize size;           /* estimated memory use of the cached icons, in bytes */
+  gsize budget;         /* in bytes */
+} GtkIconCacheStats;
+
+void gtk_icon_theme_get_cache_stats (GtkIconTheme      *self,
+                                     GtkIconCacheStats *stats);
+void gtk_icon_theme_trim            (GtkIconTheme               *self,
+                                     GMemoryMonitorWarningLevel  level);
+
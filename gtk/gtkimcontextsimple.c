@@ -24,7 +24,7 @@
 
 #include "gtkprivate.h"
 #include "gtkaccelgroup.h"
-#include "gtkimcontextsimple.h"
+#include "gtkimcontextsimpleprivate.h"
 #include "gtksettings.h"
 #include "gtkwidget.h"
 #include "gtkdebug.h"
@@ -177,8 +177,7 @@ gtk_im_context_simple_class_init (GtkIMContextSimpleClass *class)
   im_context_class->get_preedit_string = gtk_im_context_simple_get_preedit_string;
   gobject_class->finalize = gtk_im_context_simple_finalize;
 
-  init_builtin_table ();
-  init_compose_table_async (NULL, NULL, NULL);
+  gtk_im_context_simple_preload_compose_tables ();
 }
 
 static int
@@ -193,28 +192,39 @@ gtk_compose_table_find (gconstpointer data1,
 static gboolean
 add_compose_table_from_file (const char *compose_file)
 {
+  GtkComposeTable *table;
   guint hash;
-  gboolean ret = FALSE;
-
-  G_LOCK (global_tables);
+  gboolean found;
 
   hash = g_str_hash (compose_file);
-  if (!g_slist_find_custom (global_tables, GINT_TO_POINTER (hash), gtk_compose_table_find))
-    {
-      GtkComposeTable *table;
 
-      table = gtk_compose_table_new_with_file (compose_file);
+  G_LOCK (global_tables);
+  found = g_slist_find_custom (global_tables, GINT_TO_POINTER (hash), gtk_compose_table_find) != NULL;
+  G_UNLOCK (global_tables);
+
+  if (found)
+    return FALSE;
 
-      if (table)
-        {
-          ret = TRUE;
-          global_tables = g_slist_prepend (global_tables, table);
-        }
-    }
+  /* Don't hold the lock while loading, key presses need it */
+  table = gtk_compose_table_new_with_file (compose_file);
+  if (table == NULL)
+    return FALSE;
 
+  G_LOCK (global_tables);
+  found = g_slist_find_custom (global_tables, GINT_TO_POINTER (hash), gtk_compose_table_find) != NULL;
+  if (!found)
+    global_tables = g_slist_prepend (global_tables, table);
   G_UNLOCK (global_tables);
 
-  return ret;
+  if (found)
+    {
+      g_free (table->data);
+      g_free (table->char_data);
+      g_free (table);
+      return FALSE;
+    }
+
+  return TRUE;
 }
 
 static void
@@ -367,6 +377,28 @@ init_compose_table_async (GCancellable         *cancellable,
   g_object_unref (task);
 }
 
+/*< private >
+ * gtk_im_context_simple_preload_compose_tables:
+ *
+ * Starts loading the compose tables in a thread, so that they
+ * are ready by the time the first key is pressed.
+ *
+ * This is called during gtk_init(). Loading only happens once,
+ * the tables are shared by all `GtkIMContextSimple` instances.
+ */
+void
+gtk_im_context_simple_preload_compose_tables (void)
+{
+  static gsize loading = 0;
+
+  if (g_once_init_enter (&loading))
+    {
+      init_builtin_table ();
+      init_compose_table_async (NULL, NULL, NULL);
+      g_once_init_leave (&loading, 1);
+    }
+}
+
 static void
 gtk_im_context_simple_init (GtkIMContextSimple *context_simple)
 {
@@ -33,10 +33,11 @@
 #include <gmodule.h>
 #include "gtkimmodule.h"
 #include "gtkimmoduleprivate.h"
-#include "gtkimcontextsimple.h"
+#include "gtkimcontextsimpleprivate.h"
 #include "gtkmodulesprivate.h"
 #include "gtksettings.h"
 #include "gtkprivate.h"
+#include "gtkstartupprivate.h"
 
 #ifdef GDK_WINDOWING_X11
 #include "x11/gdkx.h"
@@ -92,6 +93,8 @@ _gtk_im_module_create (const char *context_id)
   if (strcmp (context_id, NONE_ID) == 0)
     return NULL;
 
+  gtk_startup_phase_begin ("create im context");
+
   ep = g_io_extension_point_lookup (GTK_IM_MODULE_EXTENSION_POINT_NAME);
   ext = g_io_extension_point_get_extension_by_name (ep, context_id);
   if (ext)
@@ -100,6 +103,8 @@ _gtk_im_module_create (const char *context_id)
       context = g_object_new (type, NULL);
     }
 
+  gtk_startup_phase_end (context_id);
+
   return context;
 }
 
@@ -270,6 +275,8 @@ gtk_im_modules_init (void)
   char **paths;
   int i;
 
+  gtk_startup_phase_begin ("im modules");
+
   gtk_im_module_ensure_extension_point ();
 
   g_type_ensure (gtk_im_context_simple_get_type ());
@@ -292,7 +299,9 @@ gtk_im_modules_init (void)
   for (i = 0; paths[i]; i++)
     {
       GTK_DEBUG (MODULES, "Scanning io modules in %s", paths[i]);
+      gtk_startup_phase_begin ("scan im modules");
       g_io_modules_scan_all_in_directory_with_scope (paths[i], scope);
+      gtk_startup_phase_end (paths[i]);
     }
   g_strfreev (paths);
 
@@ -313,4 +322,9 @@ gtk_im_modules_init (void)
                    g_type_name (g_io_extension_get_type (ext)));
         }
     }
+
+  /* Start loading compose tables now, not on the first key press */
+  gtk_im_context_simple_preload_compose_tables ();
+
+  gtk_startup_phase_end (NULL);
 }
@@ -76,6 +76,7 @@ struct _GtkInscription
   GtkInscriptionOverflow overflow;
 
   PangoLayout *layout;
+  GtkLayoutNodeCache layout_cache;
 };
 
 enum
@@ -116,6 +117,7 @@ gtk_inscription_finalize (GObject *object)
   GtkInscription *self = GTK_INSCRIPTION (object);
 
   g_clear_object (&self->layout);
+  gtk_layout_node_cache_clear (&self->layout_cache);
 
   G_OBJECT_CLASS (gtk_inscription_parent_class)->finalize (object);
 }
@@ -521,7 +523,7 @@ gtk_inscription_snapshot (GtkWidget   *widget,
   gtk_inscription_get_layout_location (self, &lx, &ly);
 
   gtk_css_boxes_init (&boxes, widget);
-  gtk_css_style_snapshot_layout (&boxes, snapshot, lx, ly, self->layout);
+  gtk_css_style_snapshot_layout_cached (&boxes, snapshot, lx, ly, self->layout, &self->layout_cache);
 
   gtk_snapshot_pop (snapshot);
 }
@@ -55,6 +55,7 @@
 #include "gtkdragicon.h"
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkjoinedmenuprivate.h"
+#include "gdkprofilerprivate.h"
 
 #include <math.h>
 #include <stdlib.h>
@@ -261,6 +262,8 @@ struct _GtkLabel
   PangoLayout   *layout;
   PangoTabArray *tabs;
 
+  GtkLayoutNodeCache layout_cache;
+
   GtkWidget *popup_menu;
   GMenuModel *extra_menu;
 
@@ -1091,6 +1094,160 @@ get_default_widths (GtkLabel    *self,
     }
 }
 
+/* The size of a label that neither wraps nor ellipsizes only depends
+ * on its text, attributes and Pango context, so it is shared between
+ * all labels. Lists often show the same few strings many times.
+ */
+#define MAX_MEASURE_CACHE_SIZE 1024
+
+typedef struct
+{
+  char *text;
+  char *attrs;
+  PangoFontDescription *font;
+  PangoFontMap *font_map;
+  guint font_map_serial;
+  guint font_options_hash;
+  double resolution;
+  PangoLanguage *language;
+  guint single_line_mode : 1;
+  guint round_glyph_positions : 1;
+
+  int width;
+  int height;
+  int baseline;
+} MeasureCacheEntry;
+
+static GHashTable *measure_cache;
+static int measure_cache_hits;
+static int measure_cache_misses;
+static guint measure_cache_hits_counter;
+static guint measure_cache_misses_counter;
+
+static guint
+measure_cache_entry_hash (gconstpointer data)
+{
+  const MeasureCacheEntry *entry = data;
+
+  return g_str_hash (entry->text) ^
+         g_str_hash (entry->attrs) ^
+         pango_font_description_hash (entry->font) ^
+         entry->font_options_hash;
+}
+
+static gboolean
+measure_cache_entry_equal (gconstpointer a,
+                           gconstpointer b)
+{
+  const MeasureCacheEntry *entry_a = a;
+  const MeasureCacheEntry *entry_b = b;
+
+  return entry_a->font_map == entry_b->font_map &&
+         entry_a->font_map_serial == entry_b->font_map_serial &&
+         entry_a->font_options_hash == entry_b->font_options_hash &&
+         entry_a->resolution == entry_b->resolution &&
+         entry_a->language == entry_b->language &&
+         entry_a->single_line_mode == entry_b->single_line_mode &&
+         entry_a->round_glyph_positions == entry_b->round_glyph_positions &&
+         g_str_equal (entry_a->text, entry_b->text) &&
+         g_str_equal (entry_a->attrs, entry_b->attrs) &&
+         pango_font_description_equal (entry_a->font, entry_b->font);
+}
+
+static void
+measure_cache_entry_free (gpointer data)
+{
+  MeasureCacheEntry *entry = data;
+
+  g_free (entry->text);
+  g_free (entry->attrs);
+  pango_font_description_free (entry->font);
+  g_free (entry);
+}
+
+static void
+get_unwrapped_size (GtkLabel *self,
+                    int      *width,
+                    int      *height,
+                    int      *baseline)
+{
+  MeasureCacheEntry lookup, *entry;
+  PangoContext *context;
+  PangoAttrList *attrs;
+  PangoLayout *layout;
+  const cairo_font_options_t *options;
+
+  gtk_label_ensure_layout (self);
+
+  context = pango_layout_get_context (self->layout);
+
+  /* Tabs and transformed contexts are rare, don't bother */
+  if (self->tabs != NULL || pango_context_get_matrix (context) != NULL)
+    {
+      layout = gtk_label_get_measuring_layout (self, NULL, -1);
+      pango_layout_get_size (layout, width, height);
+      *baseline = pango_layout_get_baseline (layout);
+      g_object_unref (layout);
+      return;
+    }
+
+  attrs = pango_layout_get_attributes (self->layout);
+  options = pango_cairo_context_get_font_options (context);
+
+  lookup.text = (char *) pango_layout_get_text (self->layout);
+  lookup.attrs = attrs ? pango_attr_list_to_string (attrs) : g_strdup ("");
+  lookup.font = (PangoFontDescription *) pango_context_get_font_description (context);
+  lookup.font_map = pango_context_get_font_map (context);
+  lookup.font_map_serial = pango_font_map_get_serial (lookup.font_map);
+  lookup.font_options_hash = options ? cairo_font_options_hash (options) : 0;
+  lookup.resolution = pango_cairo_context_get_resolution (context);
+  lookup.language = pango_context_get_language (context);
+  lookup.single_line_mode = self->single_line_mode;
+  lookup.round_glyph_positions = pango_context_get_round_glyph_positions (context);
+
+  if (measure_cache == NULL)
+    measure_cache = g_hash_table_new_full (measure_cache_entry_hash,
+                                           measure_cache_entry_equal,
+                                           measure_cache_entry_free,
+                                           NULL);
+
+  entry = g_hash_table_lookup (measure_cache, &lookup);
+  if (entry != NULL)
+    {
+      measure_cache_hits++;
+      g_free (lookup.attrs);
+    }
+  else
+    {
+      measure_cache_misses++;
+
+      layout = gtk_label_get_measuring_layout (self, NULL, -1);
+
+      entry = g_memdup2 (&lookup, sizeof (MeasureCacheEntry));
+      entry->text = g_strdup (lookup.text);
+      entry->font = pango_font_description_copy (lookup.font);
+      pango_layout_get_size (layout, &entry->width, &entry->height);
+      entry->baseline = pango_layout_get_baseline (layout);
+
+      g_object_unref (layout);
+
+      if (g_hash_table_size (measure_cache) >= MAX_MEASURE_CACHE_SIZE)
+        g_hash_table_remove_all (measure_cache);
+
+      g_hash_table_add (measure_cache, entry);
+    }
+
+  *width = entry->width;
+  *height = entry->height;
+  *baseline = entry->baseline;
+
+  if (GDK_PROFILER_IS_RUNNING)
+    {
+      gdk_profiler_set_int_counter (measure_cache_hits_counter, measure_cache_hits);
+      gdk_profiler_set_int_counter (measure_cache_misses_counter, measure_cache_misses);
+    }
+}
+
 static void
 get_static_size (GtkLabel       *self,
                  GtkOrientation  orientation,
@@ -1104,7 +1261,27 @@ get_static_size (GtkLabel       *self,
 
   get_default_widths (self, &minimum_default, &natural_default);
 
-  layout = gtk_label_get_measuring_layout (self, NULL, self->ellipsize ? natural_default : -1);
+  if (!self->ellipsize)
+    {
+      int width, height, baseline;
+
+      get_unwrapped_size (self, &width, &height, &baseline);
+
+      if (orientation == GTK_ORIENTATION_HORIZONTAL)
+        {
+          *minimum = MAX (width, minimum_default);
+          *natural = *minimum;
+        }
+      else
+        {
+          *minimum = *natural = height;
+          *minimum_baseline = *natural_baseline = baseline;
+        }
+
+      return;
+    }
+
+  layout = gtk_label_get_measuring_layout (self, NULL, natural_default);
 
   if (orientation == GTK_ORIENTATION_HORIZONTAL)
     {
@@ -1367,6 +1544,9 @@ gtk_label_size_allocate (GtkWidget *widget,
         pango_layout_set_width (self->layout, width * PANGO_SCALE);
       else
         pango_layout_set_width (self->layout, -1);
+
+      gtk_pango_layout_prefetch_glyphs (self->layout,
+                                        gtk_pango_get_glyph_prefetch_scale (widget));
     }
 
   if (self->popup_menu)
@@ -1396,7 +1576,7 @@ gtk_label_snapshot (GtkWidget   *widget,
   get_layout_location (self, &lx, &ly);
 
   gtk_css_boxes_init (&boxes, widget);
-  gtk_css_style_snapshot_layout (&boxes, snapshot, lx, ly, self->layout);
+  gtk_css_style_snapshot_layout_cached (&boxes, snapshot, lx, ly, self->layout, &self->layout_cache);
 
   info = self->select_info;
   if (!info)
@@ -1551,6 +1731,7 @@ gtk_label_finalize (GObject *object)
   g_free (self->text);
 
   g_clear_object (&self->layout);
+  gtk_layout_node_cache_clear (&self->layout_cache);
   g_clear_pointer (&self->attrs, pango_attr_list_unref);
   g_clear_pointer (&self->markup_attrs, pango_attr_list_unref);
 
@@ -2202,6 +2383,9 @@ gtk_label_class_init (GtkLabelClass *class)
   gobject_class->set_property = gtk_label_set_property;
   gobject_class->get_property = gtk_label_get_property;
   gobject_class->finalize = gtk_label_finalize;
+
+  measure_cache_hits_counter = gdk_profiler_define_int_counter ("label-measure-cache-hits", "Label Measure Cache Hits");
+  measure_cache_misses_counter = gdk_profiler_define_int_counter ("label-measure-cache-misses", "Label Measure Cache Misses");
   gobject_class->dispose = gtk_label_dispose;
 
   widget_class->size_allocate = gtk_label_size_allocate;
@@ -4169,6 +4353,7 @@ static void
 gtk_label_clear_layout (GtkLabel *self)
 {
   g_clear_object (&self->layout);
+  gtk_layout_node_cache_clear (&self->layout_cache);
 }
 
 static void
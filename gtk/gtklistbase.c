@@ -47,6 +47,13 @@
  */
 #define GTK_LIST_BASE_CHILD_MAX_OVERDRAW 10
 
+/* How far ahead, in seconds of scrolling, rows are prepared */
+#define GTK_LIST_BASE_PREFETCH_TIME 0.5
+/* Maximum number of rows prepared ahead of scrolling */
+#define GTK_LIST_BASE_MAX_PREFETCH 100
+/* Number of rows prepared per idle iteration */
+#define GTK_LIST_BASE_PREFETCH_STEP 4
+
 typedef struct _RubberbandData RubberbandData;
 
 struct _RubberbandData
@@ -78,6 +85,18 @@ struct _GtkListBasePrivate
   GtkPackType anchor_side_across;
   guint center_widgets;
   guint above_below_widgets;
+  /* time allowed for creating widgets while scrolling */
+  gint64 frame_budget;
+
+  /* rows prepared in idle time ahead of the scroll direction */
+  GtkListItemTracker *prefetch;
+  guint prefetch_id; /* idle callback handle */
+  guint prefetch_n_items;
+  guint prefetch_target;
+  gboolean prefetch_forward;
+  double scroll_velocity; /* in pixels per second */
+  int last_scroll_value;
+  gint64 last_scroll_time;
   /* the last item that was selected - basically the location to extend selections from */
   GtkListItemTracker *selected;
   /* the item that has input focus */
@@ -179,6 +198,128 @@ gtk_list_base_get_adjustment_values (GtkListBase    *self,
     *page_size = ps;
 }
 
+static void
+gtk_list_base_clear_prefetch (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  g_clear_handle_id (&priv->prefetch_id, g_source_remove);
+  priv->prefetch_n_items = 0;
+  priv->prefetch_target = 0;
+
+  if (priv->prefetch)
+    {
+      gtk_list_item_tracker_free (priv->item_manager, priv->prefetch);
+      priv->prefetch = NULL;
+    }
+}
+
+static gboolean
+gtk_list_base_prefetch_cb (gpointer data)
+{
+  GtkListBase *self = data;
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  guint anchor, n_before, n_after, n_items, start, end;
+
+  n_items = gtk_list_base_get_n_items (self);
+  anchor = gtk_list_item_tracker_get_position (priv->item_manager, priv->anchor);
+  if (n_items == 0 || anchor == GTK_INVALID_LIST_POSITION)
+    {
+      priv->prefetch_id = 0;
+      return G_SOURCE_REMOVE;
+    }
+
+  priv->prefetch_n_items = MIN (priv->prefetch_n_items + GTK_LIST_BASE_PREFETCH_STEP, priv->prefetch_target);
+
+  /* Place the rows right behind the ones kept by the anchor */
+  n_before = round (priv->center_widgets * CLAMP (priv->anchor_align_along, 0, 1));
+  n_after = priv->center_widgets - n_before + priv->above_below_widgets;
+  n_before += priv->above_below_widgets;
+
+  if (priv->prefetch_forward)
+    {
+      start = MIN (anchor + MIN (n_after, n_items) + 1, n_items);
+      end = MIN (start + priv->prefetch_n_items, n_items);
+    }
+  else
+    {
+      end = anchor - MIN (n_before, anchor);
+      start = end - MIN (priv->prefetch_n_items, end);
+    }
+
+  if (start < end)
+    {
+      if (priv->prefetch == NULL)
+        priv->prefetch = gtk_list_item_tracker_new (priv->item_manager);
+
+      gtk_list_item_tracker_set_position (priv->item_manager,
+                                          priv->prefetch,
+                                          start,
+                                          0,
+                                          end - start - 1);
+    }
+
+  if (start < end && priv->prefetch_n_items < priv->prefetch_target)
+    return G_SOURCE_CONTINUE;
+
+  priv->prefetch_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+/* Track how fast we scroll and prepare rows for the places we are
+ * going to scroll to during idle time, so that their bind handlers
+ * don't run in the frame that makes them visible.
+ */
+static void
+gtk_list_base_update_prefetch (GtkListBase *self)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+  int value, size, page_size;
+  double velocity;
+  gboolean forward;
+  guint n_items, target;
+  gint64 now;
+
+  gtk_list_base_get_adjustment_values (self, priv->orientation, &value, &size, &page_size);
+  now = g_get_monotonic_time ();
+
+  if (priv->last_scroll_time == 0 || now - priv->last_scroll_time > G_USEC_PER_SEC / 4)
+    velocity = 0;
+  else if (now > priv->last_scroll_time)
+    velocity = (priv->scroll_velocity + (double) (value - priv->last_scroll_value) * G_USEC_PER_SEC / (now - priv->last_scroll_time)) / 2;
+  else
+    velocity = priv->scroll_velocity;
+
+  priv->last_scroll_value = value;
+  priv->last_scroll_time = now;
+  priv->scroll_velocity = velocity;
+
+  if (velocity == 0)
+    return;
+
+  forward = velocity > 0;
+  if (forward != priv->prefetch_forward)
+    {
+      /* release the rows we prepared for the other direction */
+      gtk_list_base_clear_prefetch (self);
+      priv->prefetch_forward = forward;
+    }
+
+  n_items = gtk_list_base_get_n_items (self);
+  if (n_items == 0 || size <= page_size)
+    return;
+
+  target = ceil (fabs (velocity) * GTK_LIST_BASE_PREFETCH_TIME * n_items / size);
+  target = MIN (target, GTK_LIST_BASE_MAX_PREFETCH);
+  priv->prefetch_target = MAX (priv->prefetch_target, target);
+
+  if (priv->prefetch_target > 0 && priv->prefetch_id == 0)
+    {
+      priv->prefetch_id = g_idle_add_full (G_PRIORITY_DEFAULT_IDLE, gtk_list_base_prefetch_cb, self, NULL);
+      gdk_source_set_static_name_by_id (priv->prefetch_id, "[gtk] gtk_list_base_prefetch_cb");
+    }
+}
+
 static void
 gtk_list_base_adjustment_value_changed_cb (GtkAdjustment *adjustment,
                                            GtkListBase   *self)
@@ -253,10 +394,15 @@ gtk_list_base_adjustment_value_changed_cb (GtkAdjustment *adjustment,
   else
     align_along = (double) (cell_area.y + cell_area.height - area.y) / area.height;
 
+  gtk_list_item_manager_set_frame_budget (priv->item_manager, priv->frame_budget);
   gtk_list_base_set_anchor (self,
                             pos,
                             align_across, side_across,
                             align_along, side_along);
+  gtk_list_item_manager_set_frame_budget (priv->item_manager, 0);
+
+  if (adjustment == priv->adjustment[priv->orientation])
+    gtk_list_base_update_prefetch (self);
 
   gtk_widget_queue_allocate (GTK_WIDGET (self));
 }
@@ -681,6 +827,7 @@ gtk_list_base_dispose (GObject *object)
       gtk_list_item_tracker_free (priv->item_manager, priv->focus);
       priv->focus = NULL;
     }
+  gtk_list_base_clear_prefetch (self);
   g_clear_object (&priv->item_manager);
 
   g_clear_object (&priv->model);
@@ -960,6 +1107,38 @@ gtk_list_base_set_focus_child (GtkWidget *widget,
     }
 }
 
+static void
+gtk_list_base_snapshot (GtkWidget   *widget,
+                        GtkSnapshot *snapshot)
+{
+  graphene_rect_t view, bounds;
+  GtkWidget *child;
+
+  graphene_rect_init (&view,
+                      0, 0,
+                      gtk_widget_get_width (widget),
+                      gtk_widget_get_height (widget));
+
+  for (child = _gtk_widget_get_first_child (widget);
+       child != NULL;
+       child = _gtk_widget_get_next_sibling (child))
+    {
+      /* Rows that only moved keep their render node and get reused by
+       * gtk_widget_snapshot_child() with the new offset. Rows that need
+       * to be redrawn but are outside the view (like the focus row or
+       * rows prepared ahead of scrolling) are skipped, they will be
+       * snapshot once they scroll into view.
+       */
+      if (GTK_IS_LIST_ITEM_BASE (child) &&
+          _gtk_widget_get_draw_needed (child) &&
+          gtk_widget_compute_bounds (child, widget, &bounds) &&
+          !graphene_rect_intersection (&view, &bounds, NULL))
+        continue;
+
+      gtk_widget_snapshot_child (widget, child, snapshot);
+    }
+}
+
 static void
 gtk_list_base_select_item_action (GtkWidget  *widget,
                                   const char *action_name,
@@ -1218,6 +1397,7 @@ gtk_list_base_class_init (GtkListBaseClass *klass)
   widget_class->focus = gtk_list_base_focus;
   widget_class->grab_focus = gtk_list_base_grab_focus;
   widget_class->set_focus_child = gtk_list_base_set_focus_child;
+  widget_class->snapshot = gtk_list_base_snapshot;
 
   gobject_class->dispose = gtk_list_base_dispose;
   gobject_class->get_property = gtk_list_base_get_property;
@@ -2281,6 +2461,26 @@ gtk_list_base_set_anchor_max_widgets (GtkListBase *self,
                             priv->anchor_side_along);
 }
 
+/*
+ * gtk_list_base_set_frame_budget:
+ * @self: a `GtkListBase`
+ * @budget: time in microseconds, or 0
+ *
+ * Sets how long creating widgets for newly visible items may take
+ * when scrolling. Items that don't get a widget within that time
+ * are created in the following frames.
+ *
+ * See gtk_list_item_manager_set_frame_budget().
+ **/
+void
+gtk_list_base_set_frame_budget (GtkListBase *self,
+                                gint64       budget)
+{
+  GtkListBasePrivate *priv = gtk_list_base_get_instance_private (self);
+
+  priv->frame_budget = budget;
+}
+
 GtkSelectionModel *
 gtk_list_base_get_model (GtkListBase *self)
 {
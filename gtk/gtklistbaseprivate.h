@@ -83,6 +83,8 @@ void                   gtk_list_base_set_anchor                 (GtkListBase
 void                   gtk_list_base_set_anchor_max_widgets     (GtkListBase            *self,
                                                                  guint                   n_center,
                                                                  guint                   n_above_below);
+void                   gtk_list_base_set_frame_budget           (GtkListBase            *self,
+                                                                 gint64                  budget);
 
 void                   gtk_list_base_set_enable_rubberband      (GtkListBase            *self,
                                                                  gboolean                enable);
@@ -29,6 +29,10 @@ struct _GtkListItemBasePrivate
   GObject *item;
   guint position;
   gboolean selected;
+
+  /* The position and set size last told to ATs */
+  guint accessible_position;
+  guint accessible_n_items;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkListItemBase, gtk_list_item_base, GTK_TYPE_WIDGET)
@@ -70,6 +74,10 @@ gtk_list_item_base_class_init (GtkListItemBaseClass *klass)
 static void
 gtk_list_item_base_init (GtkListItemBase *self)
 {
+  GtkListItemBasePrivate *priv = gtk_list_item_base_get_instance_private (self);
+
+  priv->accessible_position = GTK_INVALID_LIST_POSITION;
+  priv->accessible_n_items = GTK_INVALID_LIST_POSITION;
 }
 
 void
@@ -128,3 +136,41 @@ gtk_list_item_base_get_selected (GtkListItemBase *self)
   return priv->selected;
 }
 
+/*< private >
+ * gtk_list_item_base_update_accessible_position:
+ * @self: a `GtkListItemBase`
+ * @n_items: the number of items in the model
+ *
+ * Tells ATs which position in the list the item is at, so
+ * they can announce "item 3 of 500" even though only the
+ * visible items exist as widgets.
+ *
+ * This only updates the accessible if something changed,
+ * so it is cheap to call for every item that is updated.
+ */
+void
+gtk_list_item_base_update_accessible_position (GtkListItemBase *self,
+                                               guint            n_items)
+{
+  GtkListItemBasePrivate *priv = gtk_list_item_base_get_instance_private (self);
+
+  if (priv->accessible_position == priv->position &&
+      priv->accessible_n_items == n_items)
+    return;
+
+  priv->accessible_position = priv->position;
+  priv->accessible_n_items = n_items;
+
+  if (priv->position == GTK_INVALID_LIST_POSITION)
+    {
+      gtk_accessible_reset_relation (GTK_ACCESSIBLE (self), GTK_ACCESSIBLE_RELATION_POS_IN_SET);
+      gtk_accessible_reset_relation (GTK_ACCESSIBLE (self), GTK_ACCESSIBLE_RELATION_SET_SIZE);
+    }
+  else
+    {
+      gtk_accessible_update_relation (GTK_ACCESSIBLE (self),
+                                      GTK_ACCESSIBLE_RELATION_POS_IN_SET, priv->position + 1,
+                                      GTK_ACCESSIBLE_RELATION_SET_SIZE, n_items,
+                                      -1);
+    }
+}
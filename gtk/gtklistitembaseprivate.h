@@ -59,5 +59,9 @@ guint                   gtk_list_item_base_get_position         (GtkListItemBase
 gpointer                gtk_list_item_base_get_item             (GtkListItemBase        *self);
 gboolean                gtk_list_item_base_get_selected         (GtkListItemBase        *self);
 
+void                    gtk_list_item_base_update_accessible_position
+                                                                (GtkListItemBase        *self,
+                                                                 guint                   n_items);
+
 G_END_DECLS
 
@@ -23,6 +23,8 @@
 
 #include "gtklistitemprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
+
 /**
  * GtkListItemFactory:
  *
@@ -78,6 +80,42 @@
 
 G_DEFINE_TYPE (GtkListItemFactory, gtk_list_item_factory, G_TYPE_OBJECT)
 
+static guint creations_counter;
+static guint binds_counter;
+static guint unbinds_counter;
+
+static guint n_creations;
+static guint n_binds;
+static guint n_unbinds;
+static gint64 last_report;
+
+static void
+gtk_list_item_factory_count (guint created,
+                             guint bound,
+                             guint unbound)
+{
+  gint64 now;
+
+  if (!GDK_PROFILER_IS_RUNNING)
+    return;
+
+  n_creations += created;
+  n_binds += bound;
+  n_unbinds += unbound;
+
+  now = g_get_monotonic_time ();
+  if (now - last_report < G_USEC_PER_SEC)
+    return;
+
+  gdk_profiler_set_int_counter (creations_counter, n_creations);
+  gdk_profiler_set_int_counter (binds_counter, n_binds);
+  gdk_profiler_set_int_counter (unbinds_counter, n_unbinds);
+  n_creations = 0;
+  n_binds = 0;
+  n_unbinds = 0;
+  last_report = now;
+}
+
 static void
 gtk_list_item_factory_default_setup (GtkListItemFactory *self,
                                      GObject            *item,
@@ -118,6 +156,13 @@ gtk_list_item_factory_class_init (GtkListItemFactoryClass *klass)
   klass->setup = gtk_list_item_factory_default_setup;
   klass->teardown = gtk_list_item_factory_default_teardown;
   klass->update = gtk_list_item_factory_default_update;
+
+  if (creations_counter == 0)
+    {
+      creations_counter = gdk_profiler_define_int_counter ("list-item-creations", "List item setups per second");
+      binds_counter = gdk_profiler_define_int_counter ("list-item-binds", "List item binds per second");
+      unbinds_counter = gdk_profiler_define_int_counter ("list-item-unbinds", "List item unbinds per second");
+    }
 }
 
 static void
@@ -134,6 +179,8 @@ gtk_list_item_factory_setup (GtkListItemFactory *self,
 {
   g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
 
+  gtk_list_item_factory_count (1, bind ? 1 : 0, 0);
+
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->setup (self, item, bind, func, data);
 }
 
@@ -146,6 +193,8 @@ gtk_list_item_factory_teardown (GtkListItemFactory *self,
 {
   g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
 
+  gtk_list_item_factory_count (0, 0, unbind ? 1 : 0);
+
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->teardown (self, item, unbind, func, data);
 }
 
@@ -160,5 +209,7 @@ gtk_list_item_factory_update (GtkListItemFactory *self,
   g_return_if_fail (GTK_IS_LIST_ITEM_FACTORY (self));
   g_return_if_fail (G_IS_OBJECT (item));
 
+  gtk_list_item_factory_count (0, bind ? 1 : 0, unbind ? 1 : 0);
+
   GTK_LIST_ITEM_FACTORY_GET_CLASS (self)->update (self, item, unbind, bind, func, data);
 }
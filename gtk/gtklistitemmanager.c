@@ -39,6 +39,10 @@ struct _GtkListItemManager
   GtkRbTree *items;
   GSList *trackers;
 
+  gint64 frame_budget;
+  gint64 materialize_budget;
+  guint materialize_id; /* tick callback handle */
+
   GtkListTile * (* split_func) (GtkWidget *, GtkListTile *, guint);
   GtkListItemBase * (* create_widget) (GtkWidget *);
   void (* prepare_section) (GtkWidget *, GtkListTile *, guint);
@@ -1264,6 +1268,160 @@ gtk_list_tile_find_widget_before (GtkListTile *tile)
   return NULL;
 }
 
+static gboolean
+gtk_list_item_manager_is_tracker_position (GtkListItemManager *self,
+                                           guint               position)
+{
+  GSList *l;
+
+  for (l = self->trackers; l; l = l->next)
+    {
+      GtkListItemTracker *tracker = l->data;
+
+      if (tracker->position == position)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+gtk_list_item_manager_update_accessible_positions (GtkListItemManager *self)
+{
+  GtkListTile *tile;
+  guint n_items;
+
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (self->model));
+
+  for (tile = gtk_list_item_manager_get_first (self);
+       tile != NULL;
+       tile = gtk_rb_tree_node_get_next (tile))
+    {
+      if (tile->widget && tile->type == GTK_LIST_TILE_ITEM)
+        gtk_list_item_base_update_accessible_position (GTK_LIST_ITEM_BASE (tile->widget), n_items);
+    }
+}
+
+static gboolean
+gtk_list_item_manager_materialize_item (GtkListItemManager *self,
+                                        GtkListItemChange  *change,
+                                        guint               position,
+                                        gint64              deadline)
+{
+  GtkListTile *tile;
+  guint offset;
+  gpointer item;
+
+  tile = gtk_list_item_manager_get_nth (self, position, &offset);
+  if (tile->widget)
+    return TRUE;
+
+  if (g_get_monotonic_time () >= deadline)
+    return FALSE;
+
+  if (offset > 0)
+    tile = gtk_list_item_manager_ensure_split (self, tile, offset);
+  if (tile->n_items > 1)
+    gtk_list_item_manager_ensure_split (self, tile, 1);
+
+  item = g_list_model_get_item (G_LIST_MODEL (self->model), position);
+  tile->widget = GTK_WIDGET (gtk_list_item_change_get (change, item));
+  if (tile->widget == NULL)
+    tile->widget = GTK_WIDGET (self->create_widget (self->widget));
+  gtk_list_item_base_update (GTK_LIST_ITEM_BASE (tile->widget),
+                             position,
+                             item,
+                             gtk_selection_model_is_selected (self->model, position));
+  gtk_list_item_base_update_accessible_position (GTK_LIST_ITEM_BASE (tile->widget),
+                                                 g_list_model_get_n_items (G_LIST_MODEL (self->model)));
+  g_object_unref (item);
+  gtk_widget_insert_after (tile->widget, self->widget, gtk_list_tile_find_widget_before (tile));
+
+  return TRUE;
+}
+
+/*
+ * gtk_list_item_manager_materialize:
+ * @self: a `GtkListItemManager`
+ * @change: the change to take widgets from
+ * @deadline: monotonic time when to stop creating widgets
+ *
+ * Creates the widgets for tracked items that ensure_items() left
+ * as placeholders. The items closest to the center of each tracked
+ * range are created first.
+ *
+ * Returns: %TRUE if all tracked items have widgets
+ */
+static gboolean
+gtk_list_item_manager_materialize (GtkListItemManager *self,
+                                   GtkListItemChange  *change,
+                                   gint64              deadline)
+{
+  guint n_items, start, n, center, d, max_d;
+  GSList *l;
+
+  if (self->model == NULL)
+    return TRUE;
+
+  n_items = g_list_model_get_n_items (G_LIST_MODEL (self->model));
+
+  for (l = self->trackers; l; l = l->next)
+    {
+      if (!gtk_list_item_tracker_query_range (self, l->data, n_items, &start, &n))
+        continue;
+
+      center = start + n / 2;
+      max_d = MAX (center - start, start + n - 1 - center);
+
+      for (d = 0; d <= max_d; d++)
+        {
+          if (center + d < start + n &&
+              !gtk_list_item_manager_materialize_item (self, change, center + d, deadline))
+            return FALSE;
+          if (d > 0 && d <= center - start &&
+              !gtk_list_item_manager_materialize_item (self, change, center - d, deadline))
+            return FALSE;
+        }
+    }
+
+  return TRUE;
+}
+
+static gboolean
+gtk_list_item_manager_materialize_cb (GtkWidget     *widget,
+                                      GdkFrameClock *frame_clock,
+                                      gpointer       data)
+{
+  GtkListItemManager *self = data;
+  GtkListItemChange change;
+  gboolean done;
+
+  gtk_list_item_change_init (&change);
+  done = gtk_list_item_manager_materialize (self, &change, g_get_monotonic_time () + self->materialize_budget);
+  gtk_list_item_change_finish (&change);
+
+  gtk_widget_queue_resize (self->widget);
+
+  if (!done)
+    return G_SOURCE_CONTINUE;
+
+  self->materialize_id = 0;
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_list_item_manager_queue_materialize (GtkListItemManager *self)
+{
+  if (self->materialize_id)
+    return;
+
+  self->materialize_budget = self->frame_budget;
+  self->materialize_id = gtk_widget_add_tick_callback (self->widget,
+                                                       gtk_list_item_manager_materialize_cb,
+                                                       self,
+                                                       NULL);
+}
+
 static void
 gtk_list_item_manager_ensure_items (GtkListItemManager *self,
                                     GtkListItemChange  *change,
@@ -1273,11 +1431,15 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
   GtkListTile *tile, *header;
   GtkWidget *insert_after;
   guint position, i, n_items, query_n_items, offset;
-  gboolean tracked, has_sections;
+  gboolean tracked, has_sections, deferred;
+  gint64 deadline;
 
   if (self->model == NULL)
     return;
 
+  deadline = self->frame_budget > 0 ? g_get_monotonic_time () + self->frame_budget : 0;
+  deferred = FALSE;
+
   n_items = g_list_model_get_n_items (G_LIST_MODEL (self->model));
   position = 0;
   has_sections = gtk_list_item_manager_has_sections (self);
@@ -1354,15 +1516,31 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
               if (tile->widget == NULL)
                 {
                   gpointer item = g_list_model_get_item (G_LIST_MODEL (self->model), position + i);
-                  tile->widget = GTK_WIDGET (gtk_list_item_change_get (change, item));
-                  if (tile->widget == NULL)
-                    tile->widget = GTK_WIDGET (self->create_widget (self->widget));
-                  gtk_list_item_base_update (GTK_LIST_ITEM_BASE (tile->widget),
-                                             position + i,
-                                             item,
-                                             gtk_selection_model_is_selected (self->model, position + i));
+                  /* With a frame budget, only reuse the widget of an item that
+                   * moved, and leave the rest to materialize() */
+                  if (deadline != 0 && !gtk_list_item_manager_is_tracker_position (self, position + i))
+                    {
+                      tile->widget = GTK_WIDGET (gtk_list_item_change_find (change, item));
+                    }
+                  else
+                    {
+                      tile->widget = GTK_WIDGET (gtk_list_item_change_get (change, item));
+                      if (tile->widget == NULL)
+                        tile->widget = GTK_WIDGET (self->create_widget (self->widget));
+                    }
+                  if (tile->widget)
+                    {
+                      gtk_list_item_base_update (GTK_LIST_ITEM_BASE (tile->widget),
+                                                 position + i,
+                                                 item,
+                                                 gtk_selection_model_is_selected (self->model, position + i));
+                      gtk_widget_insert_after (tile->widget, self->widget, insert_after);
+                    }
+                  else
+                    {
+                      deferred = TRUE;
+                    }
                   g_object_unref (item);
-                  gtk_widget_insert_after (tile->widget, self->widget, insert_after);
                 }
               else
                 {
@@ -1374,7 +1552,8 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
                                                  gtk_selection_model_is_selected (self->model, position + i));
                     }
                 }
-              insert_after = tile->widget;
+              if (tile->widget)
+                insert_after = tile->widget;
               i++;
               break;
 
@@ -1421,6 +1600,11 @@ gtk_list_item_manager_ensure_items (GtkListItemManager *self,
 
       position += query_n_items;
     }
+
+  gtk_list_item_manager_update_accessible_positions (self);
+
+  if (deferred && !gtk_list_item_manager_materialize (self, change, deadline))
+    gtk_list_item_manager_queue_materialize (self);
 }
 
 static void
@@ -1727,6 +1911,12 @@ gtk_list_item_manager_dispose (GObject *object)
 
   gtk_list_item_manager_clear_model (self);
 
+  if (self->materialize_id)
+    {
+      gtk_widget_remove_tick_callback (self->widget, self->materialize_id);
+      self->materialize_id = 0;
+    }
+
   g_clear_pointer (&self->items, gtk_rb_tree_unref);
 
   G_OBJECT_CLASS (gtk_list_item_manager_parent_class)->dispose (object);
@@ -1860,6 +2050,30 @@ gtk_list_item_manager_get_has_sections (GtkListItemManager *self)
   return self->has_sections;
 }
 
+/*
+ * gtk_list_item_manager_set_frame_budget:
+ * @self: a `GtkListItemManager`
+ * @budget: time in microseconds, or 0
+ *
+ * Sets the time that creating and binding widgets for tracked items may
+ * take before the remaining items are left as placeholders without a
+ * widget. Those are then created over the following frames, starting
+ * with the ones closest to the center of the tracked range.
+ *
+ * Items that are the position of a tracker always get a widget.
+ *
+ * A budget of 0, the default, creates all widgets immediately.
+ */
+void
+gtk_list_item_manager_set_frame_budget (GtkListItemManager *self,
+                                        gint64              budget)
+{
+  g_return_if_fail (GTK_IS_LIST_ITEM_MANAGER (self));
+  g_return_if_fail (budget >= 0);
+
+  self->frame_budget = budget;
+}
+
 GtkListItemTracker *
 gtk_list_item_tracker_new (GtkListItemManager *self)
 {
@@ -134,6 +134,8 @@ GtkSelectionModel *     gtk_list_item_manager_get_model         (GtkListItemMana
 void                    gtk_list_item_manager_set_has_sections  (GtkListItemManager     *self,
                                                                  gboolean                has_sections);
 gboolean                gtk_list_item_manager_get_has_sections  (GtkListItemManager     *self);
+void                    gtk_list_item_manager_set_frame_budget  (GtkListItemManager     *self,
+                                                                 gint64                  budget);
 
 GtkListItemTracker *    gtk_list_item_tracker_new               (GtkListItemManager     *self);
 void                    gtk_list_item_tracker_free              (GtkListItemManager     *self,
@@ -39,6 +39,11 @@
 /* Extra items to keep above + below every tracker */
 #define GTK_LIST_VIEW_EXTRA_ITEMS 2
 
+/* Time we spend creating rows while scrolling before we leave
+ * the rest for the next frames. About half a frame at 60Hz.
+ */
+#define GTK_LIST_VIEW_FRAME_BUDGET (8 * G_TIME_SPAN_MILLISECOND)
+
 /**
  * GtkListView:
  *
@@ -139,6 +144,10 @@
  *
  * `GtkListView` uses the %GTK_ACCESSIBLE_ROLE_LIST role, and the list
  * items use the %GTK_ACCESSIBLE_ROLE_LIST_ITEM role.
+ *
+ * Only the visible items have widgets, so the position of an item and
+ * the number of items are provided with the %GTK_ACCESSIBLE_RELATION_POS_IN_SET
+ * and %GTK_ACCESSIBLE_RELATION_SET_SIZE relations.
  */
 
 enum
@@ -477,6 +486,18 @@ gtk_list_view_get_unknown_row_height (GtkListView *self,
   return g_array_index (heights, int, heights->len / 2);
 }
 
+static int
+gtk_list_view_estimate_rows (GtkListView *self,
+                             guint        position,
+                             guint        n_items,
+                             int          row_height)
+{
+  if (self->estimate_func)
+    return self->estimate_func (self, position, n_items, self->estimate_data);
+
+  return row_height * n_items;
+}
+
 static void
 gtk_list_view_measure_across (GtkWidget      *widget,
                               GtkOrientation  orientation,
@@ -524,7 +545,7 @@ gtk_list_view_measure_list (GtkWidget      *widget,
   GtkListTile *tile;
   int min, nat, child_min, child_nat, spacing;
   GArray *min_heights, *nat_heights;
-  guint n_unknown, n_items;
+  guint n_unknown, n_items, position;
 
   n_items = gtk_list_base_get_n_items (GTK_LIST_BASE (self));
   if (n_items == 0)
@@ -536,10 +557,11 @@ gtk_list_view_measure_list (GtkWidget      *widget,
   n_unknown = 0;
   min = 0;
   nat = 0;
+  position = 0;
 
   for (tile = gtk_list_item_manager_get_first (self->item_manager);
        tile != NULL;
-       tile = gtk_rb_tree_node_get_next (tile))
+       position += tile->n_items, tile = gtk_rb_tree_node_get_next (tile))
     {
       if (tile->widget)
         {
@@ -554,6 +576,13 @@ gtk_list_view_measure_list (GtkWidget      *widget,
           min += child_min;
           nat += child_nat;
         }
+      else if (self->estimate_func && tile->n_items > 0)
+        {
+          int estimate = gtk_list_view_estimate_rows (self, position, tile->n_items, 0);
+
+          min += estimate;
+          nat += estimate;
+        }
       else
         {
           n_unknown += tile->n_items;
@@ -599,6 +628,7 @@ gtk_list_view_size_allocate (GtkWidget *widget,
   GtkListTile *tile;
   GArray *heights;
   int min, nat, row_height, y, list_width, spacing;
+  guint position;
   GtkOrientation orientation, opposite_orientation;
   GtkScrollablePolicy scroll_policy, opposite_scroll_policy;
 
@@ -655,9 +685,10 @@ gtk_list_view_size_allocate (GtkWidget *widget,
   g_array_free (heights, TRUE);
 
   y = 0;
+  position = 0;
   for (tile = gtk_list_item_manager_get_first (self->item_manager);
        tile != NULL;
-       tile = gtk_rb_tree_node_get_next (tile))
+       position += tile->n_items, tile = gtk_rb_tree_node_get_next (tile))
     {
       gtk_list_tile_set_area_position (self->item_manager, tile, 0, y);
       if (tile->widget == NULL)
@@ -665,7 +696,7 @@ gtk_list_view_size_allocate (GtkWidget *widget,
           gtk_list_tile_set_area_size (self->item_manager,
                                        tile,
                                        list_width,
-                                       row_height * tile->n_items
+                                       (tile->n_items > 0 ? gtk_list_view_estimate_rows (self, position, tile->n_items, row_height) : 0)
                                        + spacing * (tile->n_items - 1));
         }
 
@@ -727,6 +758,12 @@ gtk_list_view_dispose (GObject *object)
 
   self->item_manager = NULL;
 
+  if (self->estimate_destroy)
+    self->estimate_destroy (self->estimate_data);
+  self->estimate_func = NULL;
+  self->estimate_data = NULL;
+  self->estimate_destroy = NULL;
+
   g_clear_object (&self->factory);
   g_clear_object (&self->header_factory);
 
@@ -993,6 +1030,7 @@ gtk_list_view_init (GtkListView *self)
   gtk_list_base_set_anchor_max_widgets (GTK_LIST_BASE (self),
                                         GTK_LIST_VIEW_MAX_LIST_ITEMS,
                                         GTK_LIST_VIEW_EXTRA_ITEMS);
+  gtk_list_base_set_frame_budget (GTK_LIST_BASE (self), GTK_LIST_VIEW_FRAME_BUDGET);
 
   gtk_widget_add_css_class (GTK_WIDGET (self), "view");
 }
@@ -1376,3 +1414,47 @@ gtk_list_view_scroll_to (GtkListView        *self,
   gtk_list_base_scroll_to (GTK_LIST_BASE (self), pos, flags, scroll);
 }
 
+
+/**
+ * gtk_list_view_set_estimate_func:
+ * @self: a `GtkListView`
+ * @func: (nullable) (scope notified) (closure user_data) (destroy user_destroy): function
+ *   to estimate the size of rows
+ * @user_data: data to pass to @func
+ * @user_destroy: destroy notifier for @user_data
+ *
+ * Sets a function to estimate the size of rows that have no widget.
+ *
+ * By default, rows that have not been created are assumed to be as
+ * large as a typical row that is currently shown. If rows vary a lot
+ * in size, this guess changes while scrolling, and so do the position
+ * and size of the scrollbar. Scrolling to a faraway position can then
+ * land somewhere unexpected.
+ *
+ * If the size of rows can be estimated without creating them, for
+ * example from the contents of the model, an estimate function keeps
+ * the scrollbar stable.
+ *
+ * The function will be called with ranges of rows. To keep scrolling
+ * fast with large models, it should not need to look at every row in
+ * the range.
+ *
+ * Since: 4.14
+ */
+void
+gtk_list_view_set_estimate_func (GtkListView             *self,
+                                 GtkListViewEstimateFunc  func,
+                                 gpointer                 user_data,
+                                 GDestroyNotify           user_destroy)
+{
+  g_return_if_fail (GTK_IS_LIST_VIEW (self));
+
+  if (self->estimate_destroy)
+    self->estimate_destroy (self->estimate_data);
+
+  self->estimate_func = func;
+  self->estimate_data = user_data;
+  self->estimate_destroy = user_destroy;
+
+  gtk_widget_queue_resize (GTK_WIDGET (self));
+}
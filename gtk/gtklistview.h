@@ -37,6 +37,25 @@ G_BEGIN_DECLS
 typedef struct _GtkListView GtkListView;
 typedef struct _GtkListViewClass GtkListViewClass;
 
+/**
+ * GtkListViewEstimateFunc:
+ * @self: the list view
+ * @position: the first row to estimate
+ * @n_items: the number of rows to estimate
+ * @user_data: user data
+ *
+ * Estimates the combined size of @n_items rows starting at @position,
+ * not including the spacing between them.
+ *
+ * Returns: the estimated size in pixels
+ *
+ * Since: 4.14
+ */
+typedef int (* GtkListViewEstimateFunc) (GtkListView *self,
+                                         guint        position,
+                                         guint        n_items,
+                                         gpointer     user_data);
+
 GDK_AVAILABLE_IN_ALL
 GType           gtk_list_view_get_type                          (void) G_GNUC_CONST;
 
@@ -89,6 +108,12 @@ GDK_AVAILABLE_IN_4_12
 GtkListTabBehavior
                 gtk_list_view_get_tab_behavior                  (GtkListView            *self);
 
+GDK_AVAILABLE_IN_4_14
+void            gtk_list_view_set_estimate_func                 (GtkListView            *self,
+                                                                 GtkListViewEstimateFunc func,
+                                                                 gpointer                user_data,
+                                                                 GDestroyNotify          user_destroy);
+
 GDK_AVAILABLE_IN_4_12
 void            gtk_list_view_scroll_to                         (GtkListView            *self,
                                                                  guint                   pos,
@@ -33,6 +33,10 @@ struct _GtkListView
   GtkListItemFactory *header_factory;
   gboolean show_separators;
   gboolean single_click_activate;
+
+  GtkListViewEstimateFunc estimate_func;
+  gpointer estimate_data;
+  GDestroyNotify estimate_destroy;
 };
 
 struct _GtkListViewClass
@@ -59,7 +59,9 @@
 #include "gtkmodulesprivate.h"
 #include "gtkprivate.h"
 #include "gtkrecentmanager.h"
+#include "gtkstartupprivate.h"
 #include "gtktooltipprivate.h"
+#include "gtktrimprivate.h"
 #include "gtkwidgetprivate.h"
 #include "gtkwindowprivate.h"
 #include "gtkwindowgroup.h"
@@ -199,6 +201,7 @@ static const GdkDebugKey gtk_debug_keys[] = {
   { "snapshot", GTK_DEBUG_SNAPSHOT, "Generate debug render nodes" },
   { "accessibility", GTK_DEBUG_A11Y, "Information about accessibility state changes" },
   { "iconfallback", GTK_DEBUG_ICONFALLBACK, "Information about icon fallback" },
+  { "startup", GTK_DEBUG_STARTUP, "Summarize startup phases at the first frame" },
   { "invert-text-dir", GTK_DEBUG_INVERT_TEXT_DIR, "Invert the default text direction", TRUE },
 };
 
@@ -476,6 +479,8 @@ do_pre_parse_initialization (void)
 
   pre_initialized = TRUE;
 
+  gtk_startup_phase_begin ("pre-parse initialization");
+
   if (_gtk_module_has_mixed_deps (NULL))
     g_error ("GTK 2/3 symbols detected. Using GTK 2/3 and GTK 4 in the same process is not supported");
 
@@ -494,7 +499,11 @@ do_pre_parse_initialization (void)
     }
 
   /* Trigger fontconfig initialization early */
+  gtk_startup_phase_begin ("font map");
   pango_cairo_font_map_get_default ();
+  gtk_startup_phase_end (NULL);
+
+  gtk_startup_phase_end (NULL);
 }
 
 static void
@@ -519,12 +528,11 @@ do_post_parse_initialization (void)
 {
   GdkDisplayManager *display_manager;
   GtkTextDirection text_dir;
-  gint64 before G_GNUC_UNUSED;
 
   if (gtk_initialized)
     return;
 
-  before = GDK_PROFILER_CURRENT_TIME;
+  gtk_startup_phase_begin ("basic initialization");
 
   gettext_initialization ();
 
@@ -549,29 +557,31 @@ do_post_parse_initialization (void)
   gsk_render_node_init_types ();
   _gtk_ensure_resources ();
 
-  gdk_profiler_end_mark (before, "basic initialization", NULL);
+  gtk_startup_phase_end (NULL);
 
   gtk_initialized = TRUE;
 
-  before = GDK_PROFILER_CURRENT_TIME;
+  gtk_startup_phase_begin ("init modules");
 #ifdef G_OS_UNIX
   gtk_print_backends_init ();
 #endif
   gtk_im_modules_init ();
   gtk_media_file_extension_init ();
-  gdk_profiler_end_mark (before, "init modules", NULL);
+  gtk_startup_phase_end (NULL);
 
-  before = GDK_PROFILER_CURRENT_TIME;
+  gtk_startup_phase_begin ("create display");
   display_manager = gdk_display_manager_get ();
   if (gdk_display_manager_get_default_display (display_manager) != NULL)
     default_display_notify_cb (display_manager);
-  gdk_profiler_end_mark (before, "create display", NULL);
+  gtk_startup_phase_end (NULL);
 
   g_signal_connect (display_manager, "notify::default-display",
                     G_CALLBACK (default_display_notify_cb),
                     NULL);
 
   gtk_inspector_register_extension ();
+
+  gtk_trim_init ();
 }
 
 #ifdef G_PLATFORM_WIN32
@@ -608,10 +618,16 @@ gtk_init_check (void)
   if (!check_setugid ())
     return FALSE;
 
+  gtk_startup_phase_begin ("gtk init");
+
   do_pre_parse_initialization ();
   do_post_parse_initialization ();
 
+  gtk_startup_phase_begin ("open default display");
   ret = gdk_display_open_default () != NULL;
+  gtk_startup_phase_end (NULL);
+
+  gtk_startup_phase_end (NULL);
 
   if (ret && (gtk_get_debug_flags () & GTK_DEBUG_INTERACTIVE))
     gtk_window_set_interactive_debugging (TRUE);
@@ -180,6 +180,8 @@ gtk_media_file_init (GtkMediaFile *self)
 {
 }
 
+static void gtk_media_file_ensure_modules (void);
+
 GIOExtension *
 gtk_media_file_get_extension (void)
 {
@@ -189,6 +191,7 @@ gtk_media_file_get_extension (void)
 
   GTK_DEBUG (MODULES, "Looking up MediaFile extension");
 
+  gtk_media_file_ensure_modules ();
   ep = g_io_extension_point_lookup (GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
   e = NULL;
 
@@ -603,20 +606,22 @@ gtk_media_file_get_input_stream (GtkMediaFile *self)
   return priv->input_stream;
 }
 
-void
-gtk_media_file_extension_init (void)
+/* Scanning the module directories is deferred until a media
+ * file is created, most processes never play media.
+ */
+static void
+gtk_media_file_ensure_modules (void)
 {
+  static gsize scanned = 0;
   GIOExtensionPoint *ep;
   GIOModuleScope *scope;
   char **paths;
   int i;
 
-  GTK_DEBUG (MODULES, "Registering extension point %s", GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
-
-  ep = g_io_extension_point_register (GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
-  g_io_extension_point_set_required_type (ep, GTK_TYPE_MEDIA_FILE);
+  if (!g_once_init_enter (&scanned))
+    return;
 
-  g_type_ensure (GTK_TYPE_NO_MEDIA_FILE);
+  ep = g_io_extension_point_lookup (GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
 
   scope = g_io_module_scope_new (G_IO_MODULE_SCOPE_BLOCK_DUPLICATES);
 
@@ -644,6 +649,24 @@ gtk_media_file_extension_init (void)
         }
     }
 
+  g_once_init_leave (&scanned, 1);
+}
+
+void
+gtk_media_file_extension_init (void)
+{
+  GIOExtensionPoint *ep;
+
+  GTK_DEBUG (MODULES, "Registering extension point %s", GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
+
+  ep = g_io_extension_point_register (GTK_MEDIA_FILE_EXTENSION_POINT_NAME);
+  g_io_extension_point_set_required_type (ep, GTK_TYPE_MEDIA_FILE);
+
+  g_type_ensure (GTK_TYPE_NO_MEDIA_FILE);
+
+  if (GTK_DEBUG_CHECK (MODULES))
+    gtk_media_file_ensure_modules ();
+
   /* If the env var is given, check at startup that things actually work */
   if (g_getenv ("GTK_MEDIA"))
     gtk_media_file_get_extension ();
@@ -54,6 +54,9 @@ struct _GtkMenuSectionBox
   GtkPopoverMenuFlags  flags;
   GtkSizeGroup        *indicators;
   GHashTable          *custom_slots;
+
+  /* For submenus whose items are only created when they are shown */
+  GtkMenuTrackerItem  *pending_item;
 };
 
 typedef struct
@@ -500,6 +503,32 @@ gtk_menu_section_box_init (GtkMenuSectionBox *box)
   gtk_widget_set_halign (GTK_WIDGET (box), GTK_ALIGN_FILL);
 }
 
+static void
+gtk_menu_section_box_ensure_items (GtkMenuSectionBox *box)
+{
+  GtkMenuTrackerItem *item;
+
+  if (box->pending_item == NULL)
+    return;
+
+  item = g_steal_pointer (&box->pending_item);
+
+  box->tracker = gtk_menu_tracker_new_for_item_link (item, G_MENU_LINK_SUBMENU, FALSE, FALSE,
+                                                     gtk_menu_section_box_insert_func,
+                                                     gtk_menu_section_box_remove_func,
+                                                     box);
+
+  g_object_unref (item);
+}
+
+static void
+gtk_menu_section_box_map (GtkWidget *widget)
+{
+  gtk_menu_section_box_ensure_items (GTK_MENU_SECTION_BOX (widget));
+
+  GTK_WIDGET_CLASS (gtk_menu_section_box_parent_class)->map (widget);
+}
+
 static void
 gtk_menu_section_box_dispose (GObject *object)
 {
@@ -519,6 +548,7 @@ gtk_menu_section_box_dispose (GObject *object)
       box->tracker = NULL;
     }
 
+  g_clear_object (&box->pending_item);
   g_clear_object (&box->indicators);
   g_clear_pointer (&box->custom_slots, g_hash_table_unref);
 
@@ -529,6 +559,7 @@ static void
 gtk_menu_section_box_class_init (GtkMenuSectionBoxClass *class)
 {
   G_OBJECT_CLASS (class)->dispose = gtk_menu_section_box_dispose;
+  GTK_WIDGET_CLASS (class)->map = gtk_menu_section_box_map;
 }
 
 static void
@@ -610,10 +641,8 @@ gtk_menu_section_box_new_submenu (GtkMenuTrackerItem *item,
   gtk_stack_add_named (GTK_STACK (gtk_widget_get_ancestor (GTK_WIDGET (toplevel), GTK_TYPE_STACK)),
                        GTK_WIDGET (box), gtk_menu_tracker_item_get_label (item));
 
-  box->tracker = gtk_menu_tracker_new_for_item_link (item, G_MENU_LINK_SUBMENU, FALSE, FALSE,
-                                                     gtk_menu_section_box_insert_func,
-                                                     gtk_menu_section_box_remove_func,
-                                                     box);
+  /* The items are created when the submenu is first shown */
+  box->pending_item = g_object_ref (item);
 }
 
 static GtkWidget *
@@ -744,6 +773,25 @@ gtk_menu_section_box_add_custom (GtkPopoverMenu *popover,
 
   slot = (GtkWidget *)g_hash_table_lookup (box->custom_slots, id);
 
+  if (slot == NULL)
+    {
+      GtkWidget *page;
+
+      /* The slot may be in a submenu that has not been shown yet.
+       * Submenus of submenus are added to the end of the stack,
+       * so they are reached by the same loop.
+       */
+      for (page = gtk_widget_get_first_child (stack);
+           page != NULL;
+           page = gtk_widget_get_next_sibling (page))
+        {
+          if (GTK_IS_MENU_SECTION_BOX (page))
+            gtk_menu_section_box_ensure_items (GTK_MENU_SECTION_BOX (page));
+        }
+
+      slot = (GtkWidget *)g_hash_table_lookup (box->custom_slots, id);
+    }
+
   if (slot == NULL)
     return FALSE;
 
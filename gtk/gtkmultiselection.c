@@ -32,6 +32,13 @@
  * elements.
  */
 
+/* Selected items are remembered, so that they stay selected when the
+ * model removes and adds them again, like a sort model does. Looking up
+ * all items is too slow for huge selections, so this is only done while
+ * the selection is at most this big.
+ */
+#define MAX_TRACKED_ITEMS 100000
+
 struct _GtkMultiSelection
 {
   GObject parent_instance;
@@ -40,6 +47,7 @@ struct _GtkMultiSelection
 
   GtkBitset *selected;
   GHashTable *items; /* item => position */
+  guint track_items : 1; /* FALSE if the selection got too big for items */
 };
 
 struct _GtkMultiSelectionClass
@@ -136,41 +144,75 @@ gtk_multi_selection_toggle_selection (GtkMultiSelection *self,
                                       GtkBitset         *changes)
 {
   GListModel *model = G_LIST_MODEL (self);
-  GtkBitsetIter change_iter, selected_iter;
-  GtkBitset *selected;
-  guint change_pos, selected_pos;
+  GtkBitsetIter iter;
+  GtkBitset *selected, *unselected;
+  guint pos;
   gboolean more;
 
   gtk_bitset_difference (self->selected, changes);
 
+  if (!self->track_items)
+    {
+      /* start over once the big selection is gone */
+      if (!gtk_bitset_is_empty (self->selected))
+        return;
+      self->track_items = TRUE;
+    }
+
+  if (gtk_bitset_get_size (self->selected) > MAX_TRACKED_ITEMS)
+    {
+      g_hash_table_remove_all (self->items);
+      self->track_items = FALSE;
+      return;
+    }
+
   selected = gtk_bitset_copy (changes);
   gtk_bitset_intersect (selected, self->selected);
+  unselected = gtk_bitset_copy (changes);
+  gtk_bitset_subtract (unselected, selected);
 
-  if (!gtk_bitset_iter_init_first (&selected_iter, selected, &selected_pos))
-    selected_pos = G_MAXUINT;
-
-  for (more = gtk_bitset_iter_init_first (&change_iter, changes, &change_pos);
-       more;
-       more = gtk_bitset_iter_next (&change_iter, &change_pos))
+  if (gtk_bitset_is_empty (self->selected))
     {
-      gpointer item = g_list_model_get_item (model, change_pos);
+      /* unselect all */
+      g_hash_table_remove_all (self->items);
+    }
+  else if (gtk_bitset_get_size (unselected) > g_hash_table_size (self->items) / 16)
+    {
+      /* Looking up lots of items in the model is slower than
+       * going through the items we know */
+      GHashTableIter hash_iter;
+      gpointer pos_pointer;
 
-      if (change_pos < selected_pos)
+      g_hash_table_iter_init (&hash_iter, self->items);
+      while (g_hash_table_iter_next (&hash_iter, NULL, &pos_pointer))
         {
+          if (gtk_bitset_contains (unselected, GPOINTER_TO_UINT (pos_pointer)))
+            g_hash_table_iter_remove (&hash_iter);
+        }
+    }
+  else
+    {
+      for (more = gtk_bitset_iter_init_first (&iter, unselected, &pos);
+           more;
+           more = gtk_bitset_iter_next (&iter, &pos))
+        {
+          gpointer item = g_list_model_get_item (model, pos);
+
           g_hash_table_remove (self->items, item);
           g_object_unref (item);
         }
-      else
-        {
-          g_assert (change_pos == selected_pos);
+    }
 
-          g_hash_table_insert (self->items, item, GUINT_TO_POINTER (change_pos));
+  for (more = gtk_bitset_iter_init_first (&iter, selected, &pos);
+       more;
+       more = gtk_bitset_iter_next (&iter, &pos))
+    {
+      gpointer item = g_list_model_get_item (model, pos);
 
-          if (!gtk_bitset_iter_next (&selected_iter, &selected_pos))
-            selected_pos = G_MAXUINT;
-        }
+      g_hash_table_insert (self->items, item, GUINT_TO_POINTER (pos));
     }
 
+  gtk_bitset_unref (unselected);
   gtk_bitset_unref (selected);
 }
 
@@ -241,6 +283,8 @@ gtk_multi_selection_items_changed_cb (GListModel        *model,
   guint i;
 
   gtk_bitset_splice (self->selected, position, removed, added);
+  if (!self->track_items && gtk_bitset_is_empty (self->selected))
+    self->track_items = TRUE;
 
   g_hash_table_iter_init (&iter, self->items);
   while (g_hash_table_iter_next (&iter, &item, &pos_pointer))
@@ -430,6 +474,7 @@ gtk_multi_selection_init (GtkMultiSelection *self)
 {
   self->selected = gtk_bitset_new_empty ();
   self->items = g_hash_table_new_full (NULL, NULL, g_object_unref, NULL);
+  self->track_items = TRUE;
 }
 
 /**
@@ -155,6 +155,54 @@ gtk_multi_sort_keys_clear_key (GtkSortKeys *keys,
     gtk_sort_keys_clear_key (self->keys[i].keys, key + self->keys[i].offset);
 }
 
+static gboolean
+gtk_multi_sort_keys_is_threadsafe (GtkSortKeys *keys)
+{
+  GtkMultiSortKeys *self = (GtkMultiSortKeys *) keys;
+  gsize i;
+
+  for (i = 0; i < self->n_keys; i++)
+    {
+      if (!gtk_sort_keys_is_threadsafe (self->keys[i].keys))
+        return FALSE;
+    }
+
+  return TRUE;
+}
+
+static void
+gtk_multi_sort_keys_prepare_key (GtkSortKeys *keys,
+                                 gpointer     item,
+                                 gpointer     key_memory)
+{
+  GtkMultiSortKeys *self = (GtkMultiSortKeys *) keys;
+  char *key = (char *) key_memory;
+  gsize i;
+
+  for (i = 0; i < self->n_keys; i++)
+    {
+      if (gtk_sort_keys_can_prepare_key (self->keys[i].keys))
+        gtk_sort_keys_prepare_key (self->keys[i].keys, item, key + self->keys[i].offset);
+      else
+        gtk_sort_keys_init_key (self->keys[i].keys, item, key + self->keys[i].offset);
+    }
+}
+
+static void
+gtk_multi_sort_keys_finish_key (GtkSortKeys *keys,
+                                gpointer     key_memory)
+{
+  GtkMultiSortKeys *self = (GtkMultiSortKeys *) keys;
+  char *key = (char *) key_memory;
+  gsize i;
+
+  for (i = 0; i < self->n_keys; i++)
+    {
+      if (gtk_sort_keys_can_prepare_key (self->keys[i].keys))
+        gtk_sort_keys_finish_key (self->keys[i].keys, key + self->keys[i].offset);
+    }
+}
+
 static const GtkSortKeysClass GTK_MULTI_SORT_KEYS_CLASS =
 {
   gtk_multi_sort_keys_free,
@@ -162,6 +210,9 @@ static const GtkSortKeysClass GTK_MULTI_SORT_KEYS_CLASS =
   gtk_multi_sort_keys_is_compatible,
   gtk_multi_sort_keys_init_key,
   gtk_multi_sort_keys_clear_key,
+  gtk_multi_sort_keys_is_threadsafe,
+  gtk_multi_sort_keys_prepare_key,
+  gtk_multi_sort_keys_finish_key,
 };
 
 static GtkSortKeys *
@@ -361,6 +412,14 @@ gtk_multi_sorter_get_property (GObject    *object,
     }
 }
 
+static void
+gtk_multi_sorter_item_changed_cb (GtkSorter      *sorter,
+                                  gpointer        item,
+                                  GtkMultiSorter *self)
+{
+  gtk_sorter_item_changed (GTK_SORTER (self), item);
+}
+
 static void
 gtk_multi_sorter_dispose (GObject *object)
 {
@@ -371,6 +430,7 @@ gtk_multi_sorter_dispose (GObject *object)
     {
       GtkSorter *sorter = gtk_sorters_get (&self->sorters, i);
       g_signal_handlers_disconnect_by_func (sorter, gtk_multi_sorter_changed_cb, self);
+      g_signal_handlers_disconnect_by_func (sorter, gtk_multi_sorter_item_changed_cb, self);
     }
   gtk_sorters_clear (&self->sorters);
 
@@ -462,6 +522,7 @@ gtk_multi_sorter_append (GtkMultiSorter *self,
   g_return_if_fail (GTK_IS_SORTER (sorter));
 
   g_signal_connect (sorter, "changed", G_CALLBACK (gtk_multi_sorter_changed_cb), self);
+  g_signal_connect (sorter, "item-changed", G_CALLBACK (gtk_multi_sorter_item_changed_cb), self);
   gtk_sorters_append (&self->sorters, sorter);
   g_list_model_items_changed (G_LIST_MODEL (self), gtk_sorters_get_size (&self->sorters) - 1, 0, 1);
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
@@ -496,6 +557,7 @@ gtk_multi_sorter_remove (GtkMultiSorter *self,
 
   sorter = gtk_sorters_get (&self->sorters, position);
   g_signal_handlers_disconnect_by_func (sorter, gtk_multi_sorter_changed_cb, self);
+  g_signal_handlers_disconnect_by_func (sorter, gtk_multi_sorter_item_changed_cb, self);
   gtk_sorters_splice (&self->sorters, position, 1, FALSE, NULL, 0);
   g_list_model_items_changed (G_LIST_MODEL (self), position, 1, 0);
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
@@ -26,6 +26,10 @@
 #include "gtkpangoprivate.h"
 #include <pango/pangocairo.h>
 #include "gtkbuilderprivate.h"
+#include "gtknative.h"
+#include "gtkwidget.h"
+#include "gsk/gskglyphtileprivate.h"
+#include <gsk/gl/gskglrenderer.h>
 
 static gboolean
 attr_list_merge_filter (PangoAttribute *attribute,
@@ -504,3 +508,75 @@ pango_align_to_string (PangoAlignment align)
       g_assert_not_reached ();
     }
 }
+
+/*
+ * gtk_pango_get_glyph_prefetch_scale:
+ * @widget: a `GtkWidget`
+ *
+ * Gets the scale to prefetch glyphs for @widget at, for use with
+ * gtk_pango_layout_prefetch_glyphs().
+ *
+ * Only the GL renderer lays out glyphs the way the prefetched
+ * tiles are rendered, so this returns 0 for all other renderers.
+ *
+ * Returns: the scale, or 0 if prefetching is not useful
+ */
+float
+gtk_pango_get_glyph_prefetch_scale (GtkWidget *widget)
+{
+  GtkNative *native;
+  GskRenderer *renderer;
+
+  native = gtk_widget_get_native (widget);
+  if (native == NULL)
+    return 0;
+
+  renderer = gtk_native_get_renderer (native);
+  if (renderer == NULL || !GSK_IS_GL_RENDERER (renderer))
+    return 0;
+
+  return gdk_surface_get_scale (gtk_native_get_surface (native));
+}
+
+/*
+ * gtk_pango_layout_prefetch_glyphs:
+ * @layout: a `PangoLayout`
+ * @scale: the scale the layout will be rendered at
+ *
+ * Starts rendering the glyphs of @layout in the background,
+ * so they are ready by the time the layout gets rendered.
+ *
+ * The layout is assumed to be placed at a pixel-aligned position.
+ */
+void
+gtk_pango_layout_prefetch_glyphs (PangoLayout *layout,
+                                  float        scale)
+{
+  PangoLayoutIter *iter;
+
+  if (scale <= 0)
+    return;
+
+  iter = pango_layout_get_iter (layout);
+
+  do
+    {
+      PangoLayoutRun *run;
+      PangoRectangle logical;
+
+      run = pango_layout_iter_get_run_readonly (iter);
+      if (run == NULL)
+        continue;
+
+      pango_layout_iter_get_run_extents (iter, NULL, &logical);
+
+      gsk_glyph_tile_prefetch (run->item->analysis.font,
+                               run->glyphs,
+                               (float) logical.x / PANGO_SCALE,
+                               (float) pango_layout_iter_get_baseline (iter) / PANGO_SCALE,
+                               scale);
+    }
+  while (pango_layout_iter_next_run (iter));
+
+  pango_layout_iter_free (iter);
+}
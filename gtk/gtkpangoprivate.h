@@ -60,5 +60,9 @@ const char *pango_style_to_string (PangoStyle style);
 const char *pango_variant_to_string (PangoVariant variant);
 const char *pango_align_to_string (PangoAlignment align);
 
+float gtk_pango_get_glyph_prefetch_scale (GtkWidget   *widget);
+void  gtk_pango_layout_prefetch_glyphs   (PangoLayout *layout,
+                                          float        scale);
+
 G_END_DECLS
 
@@ -131,6 +131,7 @@ GtkDebugFlags   gtk_get_display_debug_flags        (GdkDisplay    *display);
 gboolean        gtk_get_any_display_debug_flag_set (void);
 
 GBytes *get_emoji_data (void);
+GVariant *get_shared_emoji_data (void);
 
 #ifdef G_ENABLE_DEBUG
 
@@ -36,6 +36,7 @@
 #include "gtkcsscolorvalueprivate.h"
 #include "gtkcssstyleprivate.h"
 #include "gtkcsstypesprivate.h"
+#include "gtksnapshotprivate.h"
 
 #include <math.h>
 
@@ -241,35 +242,20 @@ gtk_theming_background_snapshot_layer (GtkCssBoxes *bg,
   gtk_snapshot_pop (snapshot);
 }
 
-void
-gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
-                                   GtkSnapshot *snapshot)
+static void
+gtk_css_style_snapshot_background_layers (GtkCssBoxes   *boxes,
+                                          GtkSnapshot   *snapshot,
+                                          const GdkRGBA *bg_color,
+                                          gboolean       has_bg_color,
+                                          gboolean       has_bg_image,
+                                          gboolean       has_shadow)
 {
   const GtkCssBackgroundValues *background = boxes->style->background;
-  GtkCssValue *background_image;
-  const GdkRGBA *bg_color;
-  const GtkCssValue *box_shadow;
-  gboolean has_bg_color;
-  gboolean has_bg_image;
-  gboolean has_shadow;
+  GtkCssValue *background_image = background->background_image;
+  const GtkCssValue *box_shadow = background->box_shadow;
   int idx;
   guint number_of_layers;
 
-  if (background->base.type == GTK_CSS_BACKGROUND_INITIAL_VALUES)
-    return;
-
-  background_image = background->background_image;
-  bg_color = gtk_css_color_value_get_rgba (background->background_color);
-  box_shadow = background->box_shadow;
-
-  has_bg_color = !gdk_rgba_is_clear (bg_color);
-  has_bg_image = _gtk_css_image_value_get_image (_gtk_css_array_value_get_nth (background_image, 0)) != NULL;
-  has_shadow = !gtk_css_shadow_value_is_none (box_shadow);
-
-  /* This is the common default case of no background */
-  if (!has_bg_color && !has_bg_image && !has_shadow)
-    return;
-
   gtk_snapshot_push_debug (snapshot, "CSS background");
 
   if (has_shadow)
@@ -322,3 +308,76 @@ gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
   gtk_snapshot_pop (snapshot);
 }
 
+static gboolean
+gtk_css_background_is_dynamic (GtkCssValue *background_image)
+{
+  guint i;
+
+  for (i = 0; i < _gtk_css_array_value_get_n_values (background_image); i++)
+    {
+      GtkCssImage *image = _gtk_css_image_value_get_image (_gtk_css_array_value_get_nth (background_image, i));
+
+      if (image && gtk_css_image_is_dynamic (image))
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
+void
+gtk_css_style_snapshot_background (GtkCssBoxes *boxes,
+                                   GtkSnapshot *snapshot)
+{
+  GtkCssStyle *style = boxes->style;
+  const GtkCssBackgroundValues *background = style->background;
+  GtkCssValue *background_image;
+  const GdkRGBA *bg_color;
+  const graphene_rect_t *rect;
+  gboolean has_bg_color;
+  gboolean has_bg_image;
+  gboolean has_shadow;
+
+  if (background->base.type == GTK_CSS_BACKGROUND_INITIAL_VALUES)
+    return;
+
+  background_image = background->background_image;
+  bg_color = gtk_css_color_value_get_rgba (background->background_color);
+
+  has_bg_color = !gdk_rgba_is_clear (bg_color);
+  has_bg_image = _gtk_css_image_value_get_image (_gtk_css_array_value_get_nth (background_image, 0)) != NULL;
+  has_shadow = !gtk_css_shadow_value_is_none (background->box_shadow);
+
+  /* This is the common default case of no background */
+  if (!has_bg_color && !has_bg_image && !has_shadow)
+    return;
+
+  /* Widgets with the same style often have the same size, too, like
+   * the buttons of a toolbar, so they can share the nodes. Animated
+   * styles and images change all the time, caching them is pointless.
+   */
+  if (!gtk_css_style_is_static (style) ||
+      (has_bg_image && gtk_css_background_is_dynamic (background_image)))
+    {
+      gtk_css_style_snapshot_background_layers (boxes, snapshot,
+                                                bg_color, has_bg_color, has_bg_image, has_shadow);
+      return;
+    }
+
+  rect = gtk_css_boxes_get_border_rect (boxes);
+
+  if (style->background_node == NULL ||
+      !graphene_rect_equal (&style->background_rect, rect))
+    {
+      g_clear_pointer (&style->background_node, gsk_render_node_unref);
+
+      gtk_snapshot_push_collect (snapshot);
+      gtk_css_style_snapshot_background_layers (boxes, snapshot,
+                                                bg_color, has_bg_color, has_bg_image, has_shadow);
+      style->background_node = gtk_snapshot_pop_collect (snapshot);
+      style->background_rect = *rect;
+    }
+
+  if (style->background_node)
+    gtk_snapshot_append_node (snapshot, style->background_node);
+}
+
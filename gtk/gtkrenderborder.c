@@ -642,17 +642,14 @@ snapshot_border (GtkSnapshot          *snapshot,
   snapshot_frame_fill (snapshot, border_box, border_width, colors, hidden_side);
 }
 
-void
-gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
-                               GtkSnapshot *snapshot)
+static void
+gtk_css_style_snapshot_border_uncached (GtkCssBoxes *boxes,
+                                        GtkSnapshot *snapshot)
 {
   const GtkCssBorderValues *border = boxes->style->border;
   GtkBorderImage border_image;
   float border_width[4];
 
-  if (border->base.type == GTK_CSS_BORDER_INITIAL_VALUES)
-    return;
-
   if (gtk_border_image_init (&border_image, boxes->style))
     {
       cairo_t *cr;
@@ -677,11 +674,6 @@ gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
       GdkRGBA colors[4];
       graphene_simd4f_t alpha_test_vector;
 
-      /* Optimize the most common case of "This widget has no border" */
-      if (graphene_rect_equal (gtk_css_boxes_get_border_rect (boxes),
-                               gtk_css_boxes_get_padding_rect (boxes)))
-        return;
-
       colors[0] = *gtk_css_color_value_get_rgba (border->border_top_color ? border->border_top_color : boxes->style->core->color);
       colors[1] = *gtk_css_color_value_get_rgba (border->border_right_color ? border->border_right_color : boxes->style->core->color);
       colors[2] = *gtk_css_color_value_get_rgba (border->border_bottom_color ? border->border_bottom_color : boxes->style->core->color);
@@ -725,6 +717,49 @@ gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
     }
 }
 
+void
+gtk_css_style_snapshot_border (GtkCssBoxes *boxes,
+                               GtkSnapshot *snapshot)
+{
+  GtkCssStyle *style = boxes->style;
+  const graphene_rect_t *rect;
+  GtkCssImage *image;
+
+  if (style->border->base.type == GTK_CSS_BORDER_INITIAL_VALUES)
+    return;
+
+  image = _gtk_css_image_value_get_image (style->border->border_image_source);
+
+  rect = gtk_css_boxes_get_border_rect (boxes);
+
+  /* Optimize the most common case of "This widget has no border" */
+  if (image == NULL &&
+      graphene_rect_equal (rect, gtk_css_boxes_get_padding_rect (boxes)))
+    return;
+
+  /* Share the nodes like gtk_css_style_snapshot_background() does */
+  if (!gtk_css_style_is_static (style) ||
+      (image != NULL && gtk_css_image_is_dynamic (image)))
+    {
+      gtk_css_style_snapshot_border_uncached (boxes, snapshot);
+      return;
+    }
+
+  if (style->border_node == NULL ||
+      !graphene_rect_equal (&style->border_rect, rect))
+    {
+      g_clear_pointer (&style->border_node, gsk_render_node_unref);
+
+      gtk_snapshot_push_collect (snapshot);
+      gtk_css_style_snapshot_border_uncached (boxes, snapshot);
+      style->border_node = gtk_snapshot_pop_collect (snapshot);
+      style->border_rect = *rect;
+    }
+
+  if (style->border_node)
+    gtk_snapshot_append_node (snapshot, style->border_node);
+}
+
 void
 gtk_css_style_snapshot_outline (GtkCssBoxes *boxes,
                                 GtkSnapshot *snapshot)
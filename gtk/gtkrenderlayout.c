@@ -61,6 +61,60 @@ gtk_css_style_snapshot_layout (GtkCssBoxes *boxes,
   gtk_snapshot_pop (snapshot);
 }
 
+void
+gtk_layout_node_cache_clear (GtkLayoutNodeCache *cache)
+{
+  g_clear_pointer (&cache->node, gsk_render_node_unref);
+  g_clear_object (&cache->layout);
+  g_clear_object (&cache->style);
+}
+
+/* Like gtk_css_style_snapshot_layout(), but reuses the nodes from the
+ * last call if neither the layout nor the style changed since then.
+ * The layout's serial covers text, attributes, size and changes to
+ * its context, such as the font options for the scale.
+ */
+void
+gtk_css_style_snapshot_layout_cached (GtkCssBoxes        *boxes,
+                                      GtkSnapshot        *snapshot,
+                                      int                 x,
+                                      int                 y,
+                                      PangoLayout        *layout,
+                                      GtkLayoutNodeCache *cache)
+{
+  guint serial = pango_layout_get_serial (layout);
+
+  if (cache->layout != layout ||
+      cache->style != boxes->style ||
+      cache->serial != serial)
+    {
+      GtkSnapshot *layout_snapshot;
+
+      gtk_layout_node_cache_clear (cache);
+
+      layout_snapshot = gtk_snapshot_new ();
+      gtk_css_style_snapshot_layout (boxes, layout_snapshot, 0, 0, layout);
+      cache->node = gtk_snapshot_free_to_node (layout_snapshot);
+      cache->layout = g_object_ref (layout);
+      cache->style = g_object_ref (boxes->style);
+      cache->serial = serial;
+    }
+
+  if (cache->node == NULL)
+    return;
+
+  if (x != 0 || y != 0)
+    {
+      gtk_snapshot_save (snapshot);
+      gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
+    }
+
+  gtk_snapshot_append_node (snapshot, cache->node);
+
+  if (x != 0 || y != 0)
+    gtk_snapshot_restore (snapshot);
+}
+
 static void
 draw_insertion_cursor (cairo_t         *cr,
                        double           x,
@@ -26,12 +26,33 @@
 
 G_BEGIN_DECLS
 
+/* The nodes for a layout, kept until the layout or the style change */
+typedef struct _GtkLayoutNodeCache GtkLayoutNodeCache;
+
+struct _GtkLayoutNodeCache
+{
+  GskRenderNode *node;
+  PangoLayout   *layout;
+  GtkCssStyle   *style;
+  guint          serial;
+};
+
 void            gtk_css_style_snapshot_layout (GtkCssBoxes    *boxes,
                                                GtkSnapshot    *snapshot,
                                                int             x,
                                                int             y,
                                                PangoLayout    *layout);
 
+void            gtk_css_style_snapshot_layout_cached
+                                              (GtkCssBoxes        *boxes,
+                                               GtkSnapshot        *snapshot,
+                                               int                 x,
+                                               int                 y,
+                                               PangoLayout        *layout,
+                                               GtkLayoutNodeCache *cache);
+
+void            gtk_layout_node_cache_clear   (GtkLayoutNodeCache *cache);
+
 void            gtk_css_style_snapshot_caret  (GtkCssBoxes    *boxes,
                                                GdkDisplay     *display,
                                                GtkSnapshot    *snapshot,
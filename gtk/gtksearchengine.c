@@ -32,6 +32,13 @@
 #include "gtksearchenginetracker3private.h"
 #endif
 
+/* Broad searches can return many thousands of hits, and every batch
+ * that is emitted turns into a splice of the search model. So hits
+ * are collected and emitted at most once per frame, in chunks.
+ */
+#define FLUSH_HITS_INTERVAL_MS 16
+#define MAX_HITS_PER_FLUSH 1000
+
 struct _GtkSearchEnginePrivate {
   GtkSearchEngine *native;
   gboolean native_running;
@@ -46,6 +53,9 @@ struct _GtkSearchEnginePrivate {
   gboolean recursive;
   GHashTable *hits;
 
+  GQueue pending_hits;
+  guint flush_hits_id;
+
   GtkQuery *query;
 };
 
@@ -61,6 +71,14 @@ static guint signals[LAST_SIGNAL];
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkSearchEngine, _gtk_search_engine, G_TYPE_OBJECT);
 
+static void
+clear_pending_hits (GtkSearchEngine *engine)
+{
+  /* The hits are owned by the hits table */
+  g_queue_clear (&engine->priv->pending_hits);
+  g_clear_handle_id (&engine->priv->flush_hits_id, g_source_remove);
+}
+
 static void
 set_query (GtkSearchEngine *engine,
            GtkQuery        *query)
@@ -77,6 +95,7 @@ set_query (GtkSearchEngine *engine,
 static void
 start (GtkSearchEngine *engine)
 {
+  clear_pending_hits (engine);
   g_hash_table_remove_all (engine->priv->hits);
 
   if (engine->priv->native)
@@ -113,6 +132,7 @@ stop (GtkSearchEngine *engine)
 
   engine->priv->running = FALSE;
 
+  clear_pending_hits (engine);
   g_hash_table_remove_all (engine->priv->hits);
 }
 
@@ -127,6 +147,7 @@ finalize (GObject *object)
   g_clear_object (&engine->priv->model);
   g_free (engine->priv->model_error);
 
+  clear_pending_hits (engine);
   g_clear_pointer (&engine->priv->hits, g_hash_table_unref);
 
   g_clear_object (&engine->priv->query);
@@ -179,6 +200,43 @@ static void
 _gtk_search_engine_init (GtkSearchEngine *engine)
 {
   engine->priv = _gtk_search_engine_get_instance_private (engine);
+  g_queue_init (&engine->priv->pending_hits);
+}
+
+static void update_status (GtkSearchEngine *engine);
+
+static gboolean
+flush_hits (gpointer data)
+{
+  GtkSearchEngine *engine = data;
+  GList *hits = NULL;
+  gboolean more;
+  guint i;
+
+  for (i = 0; i < MAX_HITS_PER_FLUSH && !g_queue_is_empty (&engine->priv->pending_hits); i++)
+    hits = g_list_prepend (hits, g_queue_pop_head (&engine->priv->pending_hits));
+
+  hits = g_list_reverse (hits);
+
+  more = !g_queue_is_empty (&engine->priv->pending_hits);
+  if (!more)
+    engine->priv->flush_hits_id = 0;
+
+  g_object_ref (engine);
+
+  _gtk_search_engine_hits_added (engine, hits);
+  g_list_free (hits);
+
+  /* The engines may have finished while hits were pending */
+  if (!more)
+    update_status (engine);
+
+  /* Stopping the search from a handler removes this source */
+  more = more && engine->priv->flush_hits_id != 0;
+
+  g_object_unref (engine);
+
+  return more ? G_SOURCE_CONTINUE : G_SOURCE_REMOVE;
 }
 
 static void
@@ -187,11 +245,10 @@ hits_added (GtkSearchEngine *engine,
             gpointer         data)
 {
   GtkSearchEngine *composite = GTK_SEARCH_ENGINE (data);
-  GList *added, *l;
+  GList *l;
   GtkSearchHit *hit;
 
-  added = NULL;
-
+  /* The same file is often found by several engines */
   for (l = hits; l; l = l->next)
     {
       hit = l->data;
@@ -200,14 +257,15 @@ hits_added (GtkSearchEngine *engine,
         {
           hit = _gtk_search_hit_dup (hit);
           g_hash_table_add (composite->priv->hits, hit);
-          added = g_list_prepend (added, hit);
+          g_queue_push_tail (&composite->priv->pending_hits, hit);
         }
     }
 
-  if (added)
+  if (composite->priv->flush_hits_id == 0 &&
+      !g_queue_is_empty (&composite->priv->pending_hits))
     {
-      _gtk_search_engine_hits_added (composite, added);
-      g_list_free (added);
+      composite->priv->flush_hits_id = g_timeout_add (FLUSH_HITS_INTERVAL_MS, flush_hits, composite);
+      gdk_source_set_static_name_by_id (composite->priv->flush_hits_id, "[gtk] flush_hits");
     }
 }
 
@@ -220,6 +278,10 @@ update_status (GtkSearchEngine *engine)
 
   if (running != engine->priv->running)
     {
+      /* Report the end of the search after the last hits */
+      if (!running && !g_queue_is_empty (&engine->priv->pending_hits))
+        return;
+
       engine->priv->running = running;
 
       if (!running)
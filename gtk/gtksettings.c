@@ -23,6 +23,7 @@
 #include "gtkcssproviderprivate.h"
 #include "gtkprivate.h"
 #include "gtkscrolledwindow.h"
+#include "gtkstartupprivate.h"
 #include "deprecated/gtkstylecontextprivate.h"
 #include "gtkstyleproviderprivate.h"
 #include "gtktypebuiltins.h"
@@ -199,6 +200,7 @@ enum {
   PROP_LONG_PRESS_TIME,
   PROP_KEYNAV_USE_CARET,
   PROP_OVERLAY_SCROLLING,
+  PROP_ICON_CACHE_SIZE,
 
   NUM_PROPERTIES
 };
@@ -938,6 +940,21 @@ gtk_settings_class_init (GtkSettingsClass *class)
                                                          TRUE,
                                                          GTK_PARAM_READWRITE);
 
+  /**
+   * GtkSettings:gtk-icon-cache-size:
+   *
+   * The amount of memory that icon themes may use to keep
+   * recently used icons loaded, in kilobytes.
+   *
+   * Setting this to zero disables the cache, so icons are
+   * only kept while they are in use.
+   *
+   * Since: 4.14
+   */
+  pspecs[PROP_ICON_CACHE_SIZE] = g_param_spec_int ("gtk-icon-cache-size", NULL, NULL,
+                                                   0, G_MAXINT, 8192,
+                                                   GTK_PARAM_READWRITE);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, pspecs);
 }
 
@@ -1069,6 +1086,8 @@ gtk_settings_create_for_display (GdkDisplay *display)
 {
   GtkSettings *settings;
 
+  gtk_startup_phase_begin ("settings");
+
 #ifdef GDK_WINDOWING_MACOS
   if (GDK_IS_MACOS_DISPLAY (display))
     settings = g_object_new (GTK_TYPE_SETTINGS,
@@ -1092,6 +1111,8 @@ gtk_settings_create_for_display (GdkDisplay *display)
   settings_update_font_options (settings);
   settings_update_font_values (settings);
 
+  gtk_startup_phase_end (NULL);
+
   return settings;
 }
 
@@ -1605,9 +1626,11 @@ settings_update_theme (GtkSettings *settings)
 
   get_theme_name (settings, &theme_name, &theme_variant);
 
+  gtk_startup_phase_begin ("css theme");
   gtk_css_provider_load_named (settings->theme_provider,
                                theme_name,
                                theme_variant);
+  gtk_startup_phase_end (theme_name);
 
   /* reload per-theme settings */
   theme_dir = _gtk_css_provider_get_theme_dir (settings->theme_provider);
@@ -19,7 +19,7 @@
 
 #include "config.h"
 
-#include "gtkshortcut.h"
+#include "gtkshortcutprivate.h"
 
 #include "gtkshortcutaction.h"
 #include "gtkshortcuttrigger.h"
@@ -68,6 +68,11 @@ G_DEFINE_TYPE (GtkShortcut, gtk_shortcut, G_TYPE_OBJECT)
 
 static GParamSpec *properties[N_PROPS] = { NULL, };
 
+/* Bumped whenever the trigger of any shortcut changes, so
+ * shortcut controllers know when their index is out of date
+ */
+static guint trigger_serial;
+
 static void
 gtk_shortcut_dispose (GObject *object)
 {
@@ -344,6 +349,7 @@ gtk_shortcut_set_trigger (GtkShortcut *self,
 
   if (g_set_object (&self->trigger, trigger))
     {
+      trigger_serial++;
       g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_TRIGGER]);
       g_object_unref (trigger);
     }
@@ -387,3 +393,17 @@ gtk_shortcut_set_arguments (GtkShortcut *self,
 
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_ARGUMENTS]);
 }
+
+/*< private >
+ * gtk_shortcut_get_trigger_serial:
+ *
+ * Gets a number that changes whenever the trigger of
+ * any shortcut is changed.
+ *
+ * Returns: the current trigger serial
+ */
+guint
+gtk_shortcut_get_trigger_serial (void)
+{
+  return trigger_serial;
+}
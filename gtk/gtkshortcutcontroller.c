@@ -70,7 +70,7 @@
 #include "gtkflattenlistmodel.h"
 #include "gtkbuildable.h"
 #include "gtkeventcontrollerprivate.h"
-#include "gtkshortcut.h"
+#include "gtkshortcutprivate.h"
 #include "gtkshortcutmanager.h"
 #include "gtkshortcuttrigger.h"
 #include "gtktypebuiltins.h"
@@ -93,6 +93,14 @@ struct _GtkShortcutController
   guint custom_shortcuts : 1;
 
   guint last_activated;
+
+  /* Maps keyvals to the positions of the shortcuts whose trigger
+   * might match them, built on demand. Shortcuts with triggers that
+   * are not about a keyval are in index_fallback.
+   */
+  GHashTable *index;
+  GArray *index_fallback;
+  guint index_serial;
 };
 
 struct _GtkShortcutControllerClass
@@ -176,6 +184,175 @@ G_DEFINE_TYPE_WITH_CODE (GtkShortcutController, gtk_shortcut_controller,
                          G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_shortcut_controller_list_model_init)
                          G_IMPLEMENT_INTERFACE (GTK_TYPE_BUILDABLE, gtk_shortcut_controller_buildable_init))
 
+/* Building the index is not worth it for a handful of shortcuts */
+#define INDEX_MIN_SHORTCUTS 16
+
+static void
+gtk_shortcut_controller_clear_index (GtkShortcutController *self)
+{
+  g_clear_pointer (&self->index, g_hash_table_unref);
+  g_clear_pointer (&self->index_fallback, g_array_unref);
+}
+
+static guint
+index_keyval (guint keyval)
+{
+  /* Keyval triggers apply Shift to their keyval and mnemonics
+   * match the lowercase keyval, so index the lowercase one
+   */
+  if (keyval == GDK_KEY_ISO_Left_Tab)
+    return GDK_KEY_Tab;
+
+  return gdk_keyval_to_lower (keyval);
+}
+
+static void
+index_add (GHashTable *index,
+           guint       keyval,
+           guint       position)
+{
+  GArray *positions;
+
+  positions = g_hash_table_lookup (index, GUINT_TO_POINTER (keyval));
+  if (positions == NULL)
+    {
+      positions = g_array_new (FALSE, FALSE, sizeof (guint));
+      g_hash_table_insert (index, GUINT_TO_POINTER (keyval), positions);
+    }
+  else if (g_array_index (positions, guint, positions->len - 1) == position)
+    {
+      /* both alternatives have the same keyval */
+      return;
+    }
+
+  g_array_append_val (positions, position);
+}
+
+/* Returns FALSE if the trigger can't be indexed by keyval */
+static gboolean
+index_add_trigger (GHashTable         *index,
+                   GtkShortcutTrigger *trigger,
+                   guint               position)
+{
+  if (GTK_IS_KEYVAL_TRIGGER (trigger))
+    {
+      index_add (index, index_keyval (gtk_keyval_trigger_get_keyval (GTK_KEYVAL_TRIGGER (trigger))), position);
+      return TRUE;
+    }
+  else if (GTK_IS_MNEMONIC_TRIGGER (trigger))
+    {
+      index_add (index, index_keyval (gtk_mnemonic_trigger_get_keyval (GTK_MNEMONIC_TRIGGER (trigger))), position);
+      return TRUE;
+    }
+  else if (GTK_IS_ALTERNATIVE_TRIGGER (trigger))
+    {
+      GtkAlternativeTrigger *alternative = GTK_ALTERNATIVE_TRIGGER (trigger);
+
+      return index_add_trigger (index, gtk_alternative_trigger_get_first (alternative), position) &&
+             index_add_trigger (index, gtk_alternative_trigger_get_second (alternative), position);
+    }
+  else if (GTK_IS_NEVER_TRIGGER (trigger))
+    {
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
+static void
+gtk_shortcut_controller_build_index (GtkShortcutController *self)
+{
+  guint i, n;
+
+  self->index = g_hash_table_new_full (NULL, NULL, NULL, (GDestroyNotify) g_array_unref);
+  self->index_fallback = g_array_new (FALSE, FALSE, sizeof (guint));
+  self->index_serial = gtk_shortcut_get_trigger_serial ();
+
+  for (i = 0, n = g_list_model_get_n_items (self->shortcuts); i < n; i++)
+    {
+      GtkShortcut *shortcut = g_list_model_get_item (self->shortcuts, i);
+
+      if (GTK_IS_SHORTCUT (shortcut) &&
+          !index_add_trigger (self->index, gtk_shortcut_get_trigger (shortcut), i))
+        g_array_append_val (self->index_fallback, i);
+
+      g_object_unref (shortcut);
+    }
+}
+
+static void
+index_lookup (GHashTable *index,
+              guint       keyval,
+              GArray     *result)
+{
+  GArray *positions;
+
+  positions = g_hash_table_lookup (index, GUINT_TO_POINTER (index_keyval (keyval)));
+  if (positions)
+    g_array_append_vals (result, positions->data, positions->len);
+}
+
+static int
+compare_positions (gconstpointer a,
+                   gconstpointer b)
+{
+  guint pa = *(const guint *) a;
+  guint pb = *(const guint *) b;
+
+  return pa < pb ? -1 : (pa > pb ? 1 : 0);
+}
+
+/* Returns the sorted positions of the shortcuts that might be
+ * triggered by @event, or %NULL if all of them need to be checked
+ */
+static GArray *
+gtk_shortcut_controller_get_candidates (GtkShortcutController *self,
+                                        GdkEvent              *event)
+{
+  GArray *result;
+  guint *keyvals;
+  int n_keyvals;
+  guint i, j;
+
+  if (g_list_model_get_n_items (self->shortcuts) < INDEX_MIN_SHORTCUTS)
+    return NULL;
+
+  if (self->index && self->index_serial != gtk_shortcut_get_trigger_serial ())
+    gtk_shortcut_controller_clear_index (self);
+
+  if (self->index == NULL)
+    gtk_shortcut_controller_build_index (self);
+
+  result = g_array_new (FALSE, FALSE, sizeof (guint));
+  g_array_append_vals (result, self->index_fallback->data, self->index_fallback->len);
+
+  index_lookup (self->index, gdk_key_event_get_keyval (event), result);
+
+  /* Partial matches are for keyvals in other groups of the same key */
+  if (gdk_display_map_keycode (gdk_event_get_display (event),
+                               gdk_key_event_get_keycode (event),
+                               NULL, &keyvals, &n_keyvals))
+    {
+      for (i = 0; i < (guint) n_keyvals; i++)
+        index_lookup (self->index, keyvals[i], result);
+
+      g_free (keyvals);
+    }
+
+  g_array_sort (result, compare_positions);
+
+  for (i = 0, j = 0; i < result->len; i++)
+    {
+      if (j > 0 && g_array_index (result, guint, j - 1) == g_array_index (result, guint, i))
+        continue;
+
+      g_array_index (result, guint, j++) = g_array_index (result, guint, i);
+    }
+  g_array_set_size (result, j);
+
+  return result;
+}
+
 static gboolean
 gtk_shortcut_controller_is_rooted (GtkShortcutController *self)
 {
@@ -194,6 +371,8 @@ gtk_shortcut_controller_items_changed_cb (GListModel            *model,
                                           guint                  added,
                                           GtkShortcutController *self)
 {
+  gtk_shortcut_controller_clear_index (self);
+
   g_list_model_items_changed (G_LIST_MODEL (self), position, removed, added);
   if (removed != added)
     g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
@@ -292,6 +471,7 @@ gtk_shortcut_controller_finalize (GObject *object)
 
   g_clear_signal_handler (&self->shortcuts_changed_id, self->shortcuts);
   g_clear_object (&self->shortcuts);
+  gtk_shortcut_controller_clear_index (self);
 
   G_OBJECT_CLASS (gtk_shortcut_controller_parent_class)->finalize (object);
 }
@@ -318,12 +498,29 @@ gtk_shortcut_controller_run_controllers (GtkEventController *controller,
                                          gboolean            enable_mnemonics)
 {
   GtkShortcutController *self = GTK_SHORTCUT_CONTROLLER (controller);
-  int i, p;
+  int i, p, start;
+  GArray *candidates;
   GArray *shortcuts = NULL;
   gboolean has_exact = FALSE;
   gboolean retval = FALSE;
 
-  for (i = 0, p = g_list_model_get_n_items (self->shortcuts); i < p; i++)
+  candidates = gtk_shortcut_controller_get_candidates (self, event);
+  if (candidates)
+    {
+      p = candidates->len;
+      for (start = 0; start < p; start++)
+        {
+          if (g_array_index (candidates, guint, start) > self->last_activated)
+            break;
+        }
+    }
+  else
+    {
+      p = g_list_model_get_n_items (self->shortcuts);
+      start = self->last_activated + 1;
+    }
+
+  for (i = 0; i < p; i++)
     {
       GtkShortcut *shortcut;
       ShortcutData *data;
@@ -335,10 +532,13 @@ gtk_shortcut_controller_run_controllers (GtkEventController *controller,
        * for mnemonics.
        */
       if (enable_mnemonics)
-        index = (self->last_activated + 1 + i) % g_list_model_get_n_items (self->shortcuts);
+        index = (start + i) % p;
       else
         index = i;
 
+      if (candidates)
+        index = g_array_index (candidates, guint, index);
+
       shortcut = g_list_model_get_item (self->shortcuts, index);
       if (!GTK_IS_SHORTCUT (shortcut))
         {
@@ -419,6 +619,8 @@ gtk_shortcut_controller_run_controllers (GtkEventController *controller,
     }
 #endif
 
+  g_clear_pointer (&candidates, g_array_unref);
+
   if (!shortcuts)
     return retval;
 
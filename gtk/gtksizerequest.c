@@ -31,6 +31,7 @@
 #include "gtkcssnodeprivate.h"
 #include "gtkcssnumbervalueprivate.h"
 #include "gtklayoutmanagerprivate.h"
+#include "gdk/gdkprofilerprivate.h"
 
 
 #ifdef G_ENABLE_CONSISTENCY_CHECKS
@@ -144,6 +145,7 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
   int min_baseline = -1;
   int nat_baseline = -1;
   gboolean found_in_cache;
+  gint64 before G_GNUC_UNUSED;
 
   gtk_widget_ensure_resize (widget);
 
@@ -182,6 +184,8 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
       int css_extra_size;
       int widget_margins_for_size;
 
+      before = GDK_PROFILER_CURRENT_TIME;
+
       style = gtk_css_node_get_style (gtk_widget_get_css_node (widget));
       get_box_margin (style, &margin);
       get_box_border (style, &border);
@@ -294,6 +298,18 @@ gtk_widget_query_size_for_orientation (GtkWidget        *widget,
             }
         }
 
+      if (GDK_PROFILER_IS_RUNNING)
+        {
+          gint64 duration = GDK_PROFILER_CURRENT_TIME - before;
+
+          if (duration > GTK_WIDGET_MIN_PROFILED_DURATION)
+            gdk_profiler_add_markf (before, duration, "measure",
+                                    "%s %s for_size=%d",
+                                    G_OBJECT_TYPE_NAME (widget),
+                                    orientation == GTK_ORIENTATION_HORIZONTAL ? "width" : "height",
+                                    for_size);
+        }
+
       min_size = MAX (0, MAX (reported_min_size, css_min_size)) + css_extra_size;
       nat_size = MAX (0, MAX (reported_nat_size, css_min_size)) + css_extra_size;
 
@@ -31,35 +31,20 @@ _gtk_size_request_cache_init (SizeRequestCache *cache)
   memset (cache, 0, sizeof (SizeRequestCache));
 }
 
-static void
-free_sizes_x (SizeRequestX **sizes)
-{
-  int i;
-
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
-    g_free (sizes[i]);
-
-  g_free (sizes);
-}
-
-static void
-free_sizes_y (SizeRequestY **sizes)
+/* Entries are only added one at a time, so the arrays need to
+ * grow whenever the number of entries reaches a power of two.
+ */
+static inline gboolean
+needs_grow (guint n_sizes)
 {
-  int i;
-
-  for (i = 0; i < GTK_SIZE_REQUEST_CACHED_SIZES && sizes[i] != NULL; i++)
-    g_free (sizes[i]);
-
-  g_free (sizes);
+  return (n_sizes & (n_sizes - 1)) == 0;
 }
 
 void
 _gtk_size_request_cache_free (SizeRequestCache *cache)
 {
-  if (cache->requests_x)
-    free_sizes_x (cache->requests_x);
-  if (cache->requests_y)
-    free_sizes_y (cache->requests_y);
+  g_free (cache->requests_x);
+  g_free (cache->requests_y);
 }
 
 void
@@ -115,16 +100,16 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 
   if (orientation == GTK_ORIENTATION_HORIZONTAL)
     {
-      SizeRequestX **cached_sizes = cache->requests_x;
-      SizeRequestX  *cached_size;
+      SizeRequestX *cached_sizes = cache->requests_x;
+      SizeRequestX *cached_size;
 
       for (i = 0; i < n_sizes; i++)
 	{
-	  if (cached_sizes[i]->cached_size.minimum_size == minimum_size &&
-	      cached_sizes[i]->cached_size.natural_size == natural_size)
+	  if (cached_sizes[i].cached_size.minimum_size == minimum_size &&
+	      cached_sizes[i].cached_size.natural_size == natural_size)
 	    {
-	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, for_size);
-	      cached_sizes[i]->upper_for_size = MAX (cached_sizes[i]->upper_for_size, for_size);
+	      cached_sizes[i].lower_for_size = MIN (cached_sizes[i].lower_for_size, for_size);
+	      cached_sizes[i].upper_for_size = MAX (cached_sizes[i].upper_for_size, for_size);
 	      return;
 	    }
 	}
@@ -143,13 +128,10 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	    cache->flags[orientation].last_cached_request = 0;
 	}
 
-      if (cache->requests_x == NULL)
-	cache->requests_x = g_new0 (SizeRequestX *, GTK_SIZE_REQUEST_CACHED_SIZES);
+      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES && needs_grow (n_sizes))
+        cache->requests_x = g_renew (SizeRequestX, cache->requests_x, MAX (1, 2 * n_sizes));
 
-      if (cache->requests_x[cache->flags[orientation].last_cached_request] == NULL)
-	cache->requests_x[cache->flags[orientation].last_cached_request] = g_new (SizeRequestX, 1);
-
-      cached_size = cache->requests_x[cache->flags[orientation].last_cached_request];
+      cached_size = &cache->requests_x[cache->flags[orientation].last_cached_request];
       cached_size->lower_for_size = for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
@@ -157,18 +139,18 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
     }
   else
     {
-      SizeRequestY **cached_sizes = cache->requests_y;
-      SizeRequestY  *cached_size;
+      SizeRequestY *cached_sizes = cache->requests_y;
+      SizeRequestY *cached_size;
 
       for (i = 0; i < n_sizes; i++)
 	{
-	  if (cached_sizes[i]->cached_size.minimum_size == minimum_size &&
-	      cached_sizes[i]->cached_size.natural_size == natural_size &&
-	      cached_sizes[i]->cached_size.minimum_baseline == minimum_baseline &&
-	      cached_sizes[i]->cached_size.natural_baseline == natural_baseline)
+	  if (cached_sizes[i].cached_size.minimum_size == minimum_size &&
+	      cached_sizes[i].cached_size.natural_size == natural_size &&
+	      cached_sizes[i].cached_size.minimum_baseline == minimum_baseline &&
+	      cached_sizes[i].cached_size.natural_baseline == natural_baseline)
 	    {
-	      cached_sizes[i]->lower_for_size = MIN (cached_sizes[i]->lower_for_size, for_size);
-	      cached_sizes[i]->upper_for_size = MAX (cached_sizes[i]->upper_for_size, for_size);
+	      cached_sizes[i].lower_for_size = MIN (cached_sizes[i].lower_for_size, for_size);
+	      cached_sizes[i].upper_for_size = MAX (cached_sizes[i].upper_for_size, for_size);
 	      return;
 	    }
 	}
@@ -187,13 +169,10 @@ _gtk_size_request_cache_commit (SizeRequestCache *cache,
 	    cache->flags[orientation].last_cached_request = 0;
 	}
 
-      if (cache->requests_y == NULL)
-	cache->requests_y = g_new0 (SizeRequestY *, GTK_SIZE_REQUEST_CACHED_SIZES);
-
-      if (cache->requests_y[cache->flags[orientation].last_cached_request] == NULL)
-	cache->requests_y[cache->flags[orientation].last_cached_request] = g_new (SizeRequestY, 1);
+      if (n_sizes < GTK_SIZE_REQUEST_CACHED_SIZES && needs_grow (n_sizes))
+        cache->requests_y = g_renew (SizeRequestY, cache->requests_y, MAX (1, 2 * n_sizes));
 
-      cached_size = cache->requests_y[cache->flags[orientation].last_cached_request];
+      cached_size = &cache->requests_y[cache->flags[orientation].last_cached_request];
       cached_size->lower_for_size = for_size;
       cached_size->upper_for_size = for_size;
       cached_size->cached_size.minimum_size = minimum_size;
@@ -236,10 +215,13 @@ _gtk_size_request_cache_lookup (const SizeRequestCache *cache,
         }
       else
 	{
-	  /* Search for an already cached size */
+	  /* Search for an already cached size, starting with the newest
+           * entry, as that is the one repeated queries are most likely
+           * to hit */
           for (i = 0, p = cache->flags[GTK_ORIENTATION_HORIZONTAL].n_cached_requests; i < p; i++)
             {
-              const SizeRequestX *cur = cache->requests_x[i];
+              guint j = (cache->flags[GTK_ORIENTATION_HORIZONTAL].last_cached_request + p - i) % p;
+              const SizeRequestX *cur = &cache->requests_x[j];
 
 	      if (cur->lower_for_size <= for_size &&
 		  cur->upper_for_size >= for_size)
@@ -275,10 +257,13 @@ _gtk_size_request_cache_lookup (const SizeRequestCache *cache,
         }
       else
 	{
-	  /* Search for an already cached size */
+	  /* Search for an already cached size, starting with the newest
+           * entry, as that is the one repeated queries are most likely
+           * to hit */
           for (i = 0, p = cache->flags[GTK_ORIENTATION_VERTICAL].n_cached_requests; i < p; i++)
             {
-              const SizeRequestY *cur = cache->requests_y[i];
+              guint j = (cache->flags[GTK_ORIENTATION_VERTICAL].last_cached_request + p - i) % p;
+              const SizeRequestY *cur = &cache->requests_y[j];
 
 	      if (cur->lower_for_size <= for_size &&
 		  cur->upper_for_size >= for_size)
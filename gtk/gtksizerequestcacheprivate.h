@@ -64,8 +64,9 @@ typedef struct
 } SizeRequestY;
 
 typedef struct {
-  SizeRequestX **requests_x;
-  SizeRequestY **requests_y;
+  /* Arrays of n_cached_requests entries, grown in powers of two */
+  SizeRequestX *requests_x;
+  SizeRequestY *requests_y;
 
   CachedSizeX  cached_size_x;
   CachedSizeY  cached_size_y;
@@ -26,6 +26,7 @@
 #include "gtkrendernodepaintableprivate.h"
 #include "gsktransformprivate.h"
 
+#include "gdk/gdkprofilerprivate.h"
 #include "gdk/gdkrgbaprivate.h"
 
 #include "gsk/gskrendernodeprivate.h"
@@ -166,6 +167,13 @@ struct _GtkSnapshotClass {
 
 G_DEFINE_TYPE (GtkSnapshot, gtk_snapshot, GDK_TYPE_SNAPSHOT)
 
+/* Nodes that were not created because they would not have
+ * changed the rendering, like opacity 1.0 or containers with
+ * a single child
+ */
+static int skipped_nodes;
+static guint skipped_nodes_counter;
+
 static void
 gtk_snapshot_dispose (GObject *object)
 {
@@ -189,6 +197,8 @@ gtk_snapshot_class_init (GtkSnapshotClass *klass)
   GObjectClass *gobject_class = G_OBJECT_CLASS (klass);
 
   gobject_class->dispose = gtk_snapshot_dispose;
+
+  skipped_nodes_counter = gdk_profiler_define_int_counter ("snapshot-skipped-nodes", "Snapshot Skipped Nodes");
 }
 
 static GskRenderNode *
@@ -206,6 +216,7 @@ gtk_snapshot_collect_default (GtkSnapshot       *snapshot,
   else if (n_nodes == 1)
     {
       node = gsk_render_node_ref (nodes[0]);
+      skipped_nodes++;
     }
   else
     {
@@ -362,7 +373,32 @@ gtk_snapshot_collect_autopush_transform (GtkSnapshot      *snapshot,
   if (node == NULL)
     return NULL;
 
-  transform_node = gsk_transform_node_new (node, previous_state->transform);
+  /* Merge with the transform of an appended node, this is common
+   * for the cached nodes of child widgets. Only 2D transforms are
+   * merged, so that the result is always exactly the same.
+   */
+  if (gsk_render_node_get_node_type (node) == GSK_TRANSFORM_NODE &&
+      gsk_transform_get_category (previous_state->transform) >= GSK_TRANSFORM_CATEGORY_2D &&
+      gsk_transform_get_category (gsk_transform_node_get_transform (node)) >= GSK_TRANSFORM_CATEGORY_2D)
+    {
+      GskRenderNode *child = gsk_transform_node_get_child (node);
+      GskTransform *transform;
+
+      transform = gsk_transform_transform (gsk_transform_ref (previous_state->transform),
+                                           gsk_transform_node_get_transform (node));
+
+      if (gsk_transform_get_category (transform) == GSK_TRANSFORM_CATEGORY_IDENTITY)
+        transform_node = gsk_render_node_ref (child);
+      else
+        transform_node = gsk_transform_node_new (child, transform);
+
+      gsk_transform_unref (transform);
+      skipped_nodes++;
+    }
+  else
+    {
+      transform_node = gsk_transform_node_new (node, previous_state->transform);
+    }
 
   gsk_render_node_unref (node);
 
@@ -469,6 +505,7 @@ gtk_snapshot_collect_opacity (GtkSnapshot      *snapshot,
   if (state->data.opacity.opacity == 1.0)
     {
       opacity_node = node;
+      skipped_nodes++;
     }
   else if (state->data.opacity.opacity == 0.0)
     {
@@ -838,7 +875,10 @@ gtk_snapshot_collect_clip (GtkSnapshot      *snapshot,
 
   /* Check if the child node will even be clipped */
   if (graphene_rect_contains_rect (&state->data.clip.bounds, &node->bounds))
-    return node;
+    {
+      skipped_nodes++;
+      return node;
+    }
 
   if (state->data.clip.bounds.size.width == 0 ||
       state->data.clip.bounds.size.height == 0)
@@ -1061,14 +1101,20 @@ gtk_snapshot_collect_rounded_clip (GtkSnapshot      *snapshot,
     {
       /* ... and do the same optimization */
       if (graphene_rect_contains_rect (&state->data.rounded_clip.bounds.bounds, &node->bounds))
-        return node;
+        {
+          skipped_nodes++;
+          return node;
+        }
 
       clip_node = gsk_clip_node_new (node, &state->data.rounded_clip.bounds.bounds);
     }
   else
     {
       if (gsk_rounded_rect_contains_rect (&state->data.rounded_clip.bounds, &node->bounds))
-        return node;
+        {
+          skipped_nodes++;
+          return node;
+        }
 
       clip_node = gsk_rounded_clip_node_new (node, &state->data.rounded_clip.bounds);
     }
@@ -1764,12 +1810,24 @@ gtk_snapshot_pop_internal (GtkSnapshot *snapshot,
  * Pushes state so a later pop_collect call can collect all nodes
  * appended until that point.
  */
+/* Same as the default, but marks where gtk_snapshot_get_clip_bounds()
+ * has to stop looking
+ */
+static GskRenderNode *
+gtk_snapshot_collect_subtree (GtkSnapshot      *snapshot,
+                              GtkSnapshotState *state,
+                              GskRenderNode   **nodes,
+                              guint             n_nodes)
+{
+  return gtk_snapshot_collect_default (snapshot, state, nodes, n_nodes);
+}
+
 void
 gtk_snapshot_push_collect (GtkSnapshot *snapshot)
 {
   gtk_snapshot_push_state (snapshot,
                            NULL,
-                           gtk_snapshot_collect_default,
+                           gtk_snapshot_collect_subtree,
                            NULL);
 }
 
@@ -1781,6 +1839,102 @@ gtk_snapshot_pop_collect (GtkSnapshot *snapshot)
   return result;
 }
 
+static gboolean
+gtk_snapshot_state_is_pixelwise (const GtkSnapshotState *state)
+{
+  return state->collect_func == NULL ||
+         state->collect_func == gtk_snapshot_collect_default ||
+         state->collect_func == gtk_snapshot_collect_debug ||
+         state->collect_func == gtk_snapshot_collect_opacity ||
+         state->collect_func == gtk_snapshot_collect_color_matrix ||
+         state->collect_func == gtk_snapshot_collect_fill ||
+         state->collect_func == gtk_snapshot_collect_stroke ||
+         state->collect_func == gtk_snapshot_collect_blend_top ||
+         state->collect_func == gtk_snapshot_collect_blend_bottom ||
+         state->collect_func == gtk_snapshot_collect_mask_source ||
+         state->collect_func == gtk_snapshot_collect_mask_mask ||
+         state->collect_func == gtk_snapshot_collect_cross_fade_start ||
+         state->collect_func == gtk_snapshot_collect_cross_fade_end;
+}
+
+/*< private >
+ * gtk_snapshot_get_clip_bounds:
+ * @snapshot: a `GtkSnapshot`
+ * @out_bounds: (out): return location for the clip
+ *
+ * Gets the bounds of the innermost clip in the current coordinate
+ * system. Only clips pushed since the last gtk_snapshot_push_collect()
+ * are considered, because the collected node may be reused in other
+ * places. Clips below nodes that draw outside of their child, like
+ * blurs and shadows, are ignored.
+ *
+ * Returns: %TRUE if there is a clip
+ */
+gboolean
+gtk_snapshot_get_clip_bounds (GtkSnapshot     *snapshot,
+                              graphene_rect_t *out_bounds)
+{
+  GskTransform *transform;
+  gboolean result = FALSE;
+  gsize i;
+
+  transform = gsk_transform_ref (gtk_snapshot_get_current_state (snapshot)->transform);
+
+  for (i = gtk_snapshot_states_get_size (&snapshot->state_stack); i > 0; i--)
+    {
+      const GtkSnapshotState *state = gtk_snapshot_states_get (&snapshot->state_stack, i - 1);
+      const graphene_rect_t *clip;
+      float scale_x, scale_y, dx, dy;
+
+      if (state->collect_func == gtk_snapshot_collect_clip)
+        {
+          clip = &state->data.clip.bounds;
+        }
+      else if (state->collect_func == gtk_snapshot_collect_rounded_clip)
+        {
+          clip = &state->data.rounded_clip.bounds.bounds;
+        }
+      else if (state->collect_func == gtk_snapshot_collect_autopush_transform && i > 1)
+        {
+          const GtkSnapshotState *previous = gtk_snapshot_states_get (&snapshot->state_stack, i - 2);
+          GskTransform *outer;
+
+          outer = gsk_transform_transform (gsk_transform_ref (previous->transform), transform);
+          gsk_transform_unref (transform);
+          transform = outer;
+          continue;
+        }
+      else if (gtk_snapshot_state_is_pixelwise (state))
+        {
+          continue;
+        }
+      else
+        {
+          break;
+        }
+
+      if (gsk_transform_get_category (transform) >= GSK_TRANSFORM_CATEGORY_2D_AFFINE)
+        {
+          gsk_transform_to_affine (transform, &scale_x, &scale_y, &dx, &dy);
+          if (scale_x > 0 && scale_y > 0)
+            {
+              graphene_rect_init (out_bounds,
+                                  (clip->origin.x - dx) / scale_x,
+                                  (clip->origin.y - dy) / scale_y,
+                                  clip->size.width / scale_x,
+                                  clip->size.height / scale_y);
+              result = TRUE;
+            }
+        }
+
+      break;
+    }
+
+  gsk_transform_unref (transform);
+
+  return result;
+}
+
 /**
  * gtk_snapshot_to_node:
  * @snapshot: a `GtkSnapshot`
@@ -1816,6 +1970,9 @@ gtk_snapshot_to_node (GtkSnapshot *snapshot)
   gtk_snapshot_states_clear (&snapshot->state_stack);
   gtk_snapshot_nodes_clear (&snapshot->nodes);
 
+  if (GDK_PROFILER_IS_RUNNING)
+    gdk_profiler_set_int_counter (skipped_nodes_counter, skipped_nodes);
+
   return result;
 }
 
@@ -32,6 +32,8 @@ void                    gtk_snapshot_append_text                (GtkSnapshot
 
 void                    gtk_snapshot_push_collect               (GtkSnapshot            *snapshot);
 GskRenderNode *         gtk_snapshot_pop_collect                (GtkSnapshot            *snapshot);
+gboolean                gtk_snapshot_get_clip_bounds            (GtkSnapshot            *snapshot,
+                                                                 graphene_rect_t        *out_bounds);
 
 G_END_DECLS
 
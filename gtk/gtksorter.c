@@ -66,6 +66,7 @@ struct _GtkDefaultSortKeys
 
 enum {
   CHANGED,
+  ITEM_CHANGED,
   LAST_SIGNAL
 };
 
@@ -138,6 +139,32 @@ gtk_sorter_class_init (GtkSorterClass *class)
   g_signal_set_va_marshaller (signals[CHANGED],
                               G_TYPE_FROM_CLASS (class),
                               g_cclosure_marshal_VOID__ENUMv);
+
+  /**
+   * GtkSorter::item-changed:
+   * @self: The `GtkSorter`
+   * @item: (type GObject): the item that needs to be sorted again
+   *
+   * Emitted when the sort order of a single item changed, while
+   * the sorter still sorts all other items the same way.
+   *
+   * Users of the sorter should then only move @item into its new
+   * place, [class@Gtk.SortListModel] handles this signal automatically.
+   *
+   * Since: 4.14
+   */
+  signals[ITEM_CHANGED] =
+    g_signal_new (I_("item-changed"),
+                  G_TYPE_FROM_CLASS (class),
+                  G_SIGNAL_RUN_LAST,
+                  0,
+                  NULL, NULL,
+                  g_cclosure_marshal_VOID__OBJECT,
+                  G_TYPE_NONE, 1,
+                  G_TYPE_OBJECT);
+  g_signal_set_va_marshaller (signals[ITEM_CHANGED],
+                              G_TYPE_FROM_CLASS (class),
+                              g_cclosure_marshal_VOID__OBJECTv);
 }
 
 static void
@@ -337,6 +364,33 @@ gtk_sorter_changed (GtkSorter       *self,
   g_signal_emit (self, signals[CHANGED], 0, change);
 }
 
+/**
+ * gtk_sorter_item_changed:
+ * @self: a `GtkSorter`
+ * @item: (type GObject): the item whose sort order changed
+ *
+ * Notifies all users of the sorter that @item needs to be sorted
+ * again, for example because the value it is sorted by changed.
+ *
+ * This emits the [signal@Gtk.Sorter::item-changed] signal. Unlike
+ * [method@Gtk.Sorter.changed], this allows users to keep the sort
+ * order of all other items and only move @item into its new place.
+ *
+ * This function is intended for implementors of `GtkSorter`
+ * subclasses and should not be called from other functions.
+ *
+ * Since: 4.14
+ */
+void
+gtk_sorter_item_changed (GtkSorter *self,
+                         gpointer   item)
+{
+  g_return_if_fail (GTK_IS_SORTER (self));
+  g_return_if_fail (G_IS_OBJECT (item));
+
+  g_signal_emit (self, signals[ITEM_CHANGED], 0, item);
+}
+
 /*<private>
  * gtk_sorter_changed_with_keys:
  * @self: a `GtkSorter`
@@ -113,6 +113,9 @@ GtkSorterOrder          gtk_sorter_get_order                    (GtkSorter
 GDK_AVAILABLE_IN_ALL
 void                    gtk_sorter_changed                      (GtkSorter              *self,
                                                                  GtkSorterChange         change);
+GDK_AVAILABLE_IN_4_14
+void                    gtk_sorter_item_changed                 (GtkSorter              *self,
+                                                                 gpointer                item);
 
 
 G_END_DECLS
@@ -95,6 +95,46 @@ gtk_sort_keys_needs_clear_key (GtkSortKeys *self)
   return self->klass->clear_key != NULL;
 }
 
+/*<private>
+ * gtk_sort_keys_is_threadsafe:
+ * @self: a GtkSortKeys
+ *
+ * Checks if keys created by @self can be compared from multiple
+ * threads at the same time. This is the case when comparing only
+ * looks at the key memory and does not call back into objects.
+ *
+ * Returns: %TRUE if comparing keys is threadsafe
+ **/
+gboolean
+gtk_sort_keys_is_threadsafe (GtkSortKeys *self)
+{
+  return self->klass->is_threadsafe != NULL &&
+         self->klass->is_threadsafe (self);
+}
+
+gboolean
+gtk_sort_keys_threadsafe (GtkSortKeys *self)
+{
+  return TRUE;
+}
+
+/*<private>
+ * gtk_sort_keys_can_prepare_key:
+ * @self: a GtkSortKeys
+ *
+ * Checks if keys can be initialized in two steps with
+ * gtk_sort_keys_prepare_key() and gtk_sort_keys_finish_key().
+ * The first step must happen on the main thread, the second one
+ * may happen in any thread.
+ *
+ * Returns: %TRUE if keys can be initialized in two steps
+ **/
+gboolean
+gtk_sort_keys_can_prepare_key (GtkSortKeys *self)
+{
+  return self->klass->finish_key != NULL;
+}
+
 static void
 gtk_equal_sort_keys_free (GtkSortKeys *keys)
 {
@@ -129,7 +169,8 @@ static const GtkSortKeysClass GTK_EQUAL_SORT_KEYS_CLASS =
   gtk_equal_sort_keys_compare,
   gtk_equal_sort_keys_is_compatible,
   gtk_equal_sort_keys_init_key,
-  NULL
+  NULL,
+  gtk_sort_keys_threadsafe,
 };
 
 /*<private>
@@ -47,6 +47,16 @@ struct _GtkSortKeysClass
                                                                  gpointer                key_memory);
   void                  (* clear_key)                           (GtkSortKeys            *self,
                                                                  gpointer                key_memory);
+  /* NULL if key_compare must only be called from one thread */
+  gboolean              (* is_threadsafe)                       (GtkSortKeys            *self);
+  /* Optional split of init_key(): prepare_key() runs on the main thread and
+   * looks at the item, finish_key() may run in any thread and only uses the
+   * key memory. Either both or none must be set. */
+  void                  (* prepare_key)                         (GtkSortKeys            *self,
+                                                                 gpointer                item,
+                                                                 gpointer                key_memory);
+  void                  (* finish_key)                          (GtkSortKeys            *self,
+                                                                 gpointer                key_memory);
 };
 
 GtkSortKeys *           gtk_sort_keys_alloc                     (const GtkSortKeysClass *klass,
@@ -66,6 +76,10 @@ GCompareDataFunc        gtk_sort_keys_get_key_compare_func      (GtkSortKeys
 gboolean                gtk_sort_keys_is_compatible             (GtkSortKeys            *self,
                                                                  GtkSortKeys            *other);
 gboolean                gtk_sort_keys_needs_clear_key           (GtkSortKeys            *self);
+gboolean                gtk_sort_keys_is_threadsafe             (GtkSortKeys            *self);
+/* for use as is_threadsafe vfunc */
+gboolean                gtk_sort_keys_threadsafe                (GtkSortKeys            *self);
+gboolean                gtk_sort_keys_can_prepare_key           (GtkSortKeys            *self);
 
 #define GTK_SORT_KEYS_ALIGN(_size,_align) (((_size) + (_align) - 1) & ~((_align) - 1))
 static inline int
@@ -84,6 +98,21 @@ gtk_sort_keys_init_key (GtkSortKeys *self,
   self->klass->init_key (self, item, key_memory);
 }
 
+static inline void
+gtk_sort_keys_prepare_key (GtkSortKeys *self,
+                           gpointer     item,
+                           gpointer     key_memory)
+{
+  self->klass->prepare_key (self, item, key_memory);
+}
+
+static inline void
+gtk_sort_keys_finish_key (GtkSortKeys *self,
+                          gpointer     key_memory)
+{
+  self->klass->finish_key (self, key_memory);
+}
+
 static inline void
 gtk_sort_keys_clear_key (GtkSortKeys *self,
                          gpointer       key_memory)
@@ -28,6 +28,8 @@
 #include "gtksorterprivate.h"
 #include "timsort/gtktimsortprivate.h"
 
+#include "gdk/gdkparalleltaskprivate.h"
+
 /* The maximum amount of items to merge for a single merge step
  *
  * Making this smaller will result in more steps, which has more overhead and slows
@@ -53,6 +55,21 @@
  */
 #define GTK_SORT_STEP_TIME_US (1000) /* 1 millisecond */
 
+/* Minimum number of items per run when sorting runs in parallel
+ *
+ * Below this the overhead of waking up threads and merging the runs
+ * afterwards is larger than the time saved.
+ */
+#define GTK_SORT_PARALLEL_MIN_RUN (16384)
+
+/* Maximum number of runs sorted in parallel, this must be well below
+ * GTK_TIM_SORT_MAX_PENDING as runs are pushed on the timsort stack.
+ */
+#define GTK_SORT_PARALLEL_MAX_RUNS (64)
+
+/* Number of keys finished by a thread at once when creating keys in parallel */
+#define GTK_SORT_PARALLEL_KEYS_CHUNK (1024)
+
 /**
  * GtkSortListModel:
  *
@@ -369,6 +386,134 @@ gtk_sort_list_model_stop_sorting (GtkSortListModel *self,
   g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_PENDING]);
 }
 
+static int
+sort_func (gconstpointer a,
+           gconstpointer b,
+           gpointer      data);
+
+typedef struct
+{
+  GtkSortListModel *self;
+  gsize runs[GTK_SORT_PARALLEL_MAX_RUNS + 1];
+  guint n_runs;
+  /* atomic */ int next_run;
+} SortRuns;
+
+static void
+gtk_sort_list_model_sort_runs_task (gpointer data)
+{
+  SortRuns *sr = data;
+  GtkSortListModel *self = sr->self;
+  guint i, j;
+
+  for (i = g_atomic_int_add (&sr->next_run, 1);
+       i < sr->n_runs;
+       i = g_atomic_int_add (&sr->next_run, 1))
+    {
+      gsize start = 0;
+
+      for (j = 0; j < i; j++)
+        start += sr->runs[j];
+
+      gtk_tim_sort (self->positions + start,
+                    sr->runs[i],
+                    sizeof (gpointer),
+                    sort_func,
+                    self->sort_keys);
+    }
+}
+
+typedef struct
+{
+  GtkSortListModel *self;
+  guint n_chunks;
+  /* atomic */ int next_chunk;
+} FinishKeys;
+
+static void
+gtk_sort_list_model_finish_keys_task (gpointer data)
+{
+  FinishKeys *fk = data;
+  GtkSortListModel *self = fk->self;
+  guint i, pos, end;
+
+  for (i = g_atomic_int_add (&fk->next_chunk, 1);
+       i < fk->n_chunks;
+       i = g_atomic_int_add (&fk->next_chunk, 1))
+    {
+      end = MIN ((i + 1) * GTK_SORT_PARALLEL_KEYS_CHUNK, self->n_items);
+
+      for (pos = i * GTK_SORT_PARALLEL_KEYS_CHUNK; pos < end; pos++)
+        gtk_sort_keys_finish_key (self->sort_keys, key_from_pos (self, pos));
+    }
+}
+
+/* Creates all keys by looking at the items on the main thread and
+ * doing the expensive part of the key creation in parallel.
+ * Returns FALSE if the keys need to be created the normal way.
+ */
+static gboolean
+gtk_sort_list_model_init_keys_parallel (GtkSortListModel *self)
+{
+  FinishKeys fk;
+  guint pos;
+
+  if (!gtk_sort_keys_can_prepare_key (self->sort_keys) ||
+      self->n_items < GTK_SORT_PARALLEL_MIN_RUN ||
+      gtk_bitset_get_size (self->missing_keys) != self->n_items)
+    return FALSE;
+
+  for (pos = 0; pos < self->n_items; pos++)
+    {
+      gpointer item = g_list_model_get_item (self->model, pos);
+      gtk_sort_keys_prepare_key (self->sort_keys, item, key_from_pos (self, pos));
+      g_object_unref (item);
+    }
+
+  fk.self = self;
+  fk.n_chunks = (self->n_items + GTK_SORT_PARALLEL_KEYS_CHUNK - 1) / GTK_SORT_PARALLEL_KEYS_CHUNK;
+  fk.next_chunk = 0;
+
+  gdk_parallel_task_run (gtk_sort_list_model_finish_keys_task, &fk, fk.n_chunks);
+
+  return TRUE;
+}
+
+/* Sorts equally sized runs of the positions in parallel and hands them
+ * to the ongoing sort, which then only has to merge them.
+ * Returns FALSE if the sort was left to do all the work itself.
+ */
+static gboolean
+gtk_sort_list_model_sort_runs_parallel (GtkSortListModel *self)
+{
+  SortRuns sr;
+  guint i;
+
+  /* Runs from a previous sort are cheaper to merge than to sort again */
+  if (self->sort.pending_runs > 0 || self->sort.size != self->n_items)
+    return FALSE;
+
+  if (!gtk_sort_keys_is_threadsafe (self->sort_keys))
+    return FALSE;
+
+  sr.n_runs = MIN (MIN (g_get_num_processors (), GTK_SORT_PARALLEL_MAX_RUNS),
+                   self->n_items / GTK_SORT_PARALLEL_MIN_RUN);
+  if (sr.n_runs < 2)
+    return FALSE;
+
+  sr.self = self;
+  sr.next_run = 0;
+  for (i = 0; i < sr.n_runs; i++)
+    sr.runs[i] = (gsize) self->n_items * (i + 1) / sr.n_runs - (gsize) self->n_items * i / sr.n_runs;
+  sr.runs[sr.n_runs] = 0;
+
+  gdk_parallel_task_run (gtk_sort_list_model_sort_runs_task, &sr, sr.n_runs);
+
+  gtk_tim_sort_set_runs (&self->sort, sr.runs);
+
+  return TRUE;
+}
+
 static gboolean
 gtk_sort_list_model_sort_step (GtkSortListModel *self,
                                gboolean          finish,
@@ -387,28 +532,40 @@ gtk_sort_list_model_sort_step (GtkSortListModel *self,
       GtkBitsetIter iter;
       guint pos;
 
-      for (gtk_bitset_iter_init_first (&iter, self->missing_keys, &pos);
-           gtk_bitset_iter_is_valid (&iter);
-           gtk_bitset_iter_next (&iter, &pos))
+      if (!finish || !gtk_sort_list_model_init_keys_parallel (self))
         {
-          gpointer item = g_list_model_get_item (self->model, pos);
-          gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, pos));
-          g_object_unref (item);
-
-          if (g_get_monotonic_time () >= end_time && !finish)
+          for (gtk_bitset_iter_init_first (&iter, self->missing_keys, &pos);
+               gtk_bitset_iter_is_valid (&iter);
+               gtk_bitset_iter_next (&iter, &pos))
             {
-              gtk_bitset_remove_range_closed (self->missing_keys, 0, pos);
-              *out_position = 0;
-              *out_n_items = 0;
-              return TRUE;
+              gpointer item = g_list_model_get_item (self->model, pos);
+              gtk_sort_keys_init_key (self->sort_keys, item, key_from_pos (self, pos));
+              g_object_unref (item);
+
+              if (g_get_monotonic_time () >= end_time && !finish)
+                {
+                  gtk_bitset_remove_range_closed (self->missing_keys, 0, pos);
+                  *out_position = 0;
+                  *out_n_items = 0;
+                  return TRUE;
+                }
             }
         }
       result = TRUE;
       gtk_bitset_remove_all (self->missing_keys);
     }
 
-  end_change = self->positions;
-  start_change = self->positions + self->n_items;
+  if (finish && gtk_sort_list_model_sort_runs_parallel (self))
+    {
+      result = TRUE;
+      start_change = self->positions;
+      end_change = self->positions + self->n_items;
+    }
+  else
+    {
+      end_change = self->positions;
+      start_change = self->positions + self->n_items;
+    }
 
   while (gtk_tim_sort_step (&self->sort, &change))
     {
@@ -951,6 +1108,32 @@ gtk_sort_list_model_sorter_changed_cb (GtkSorter        *sorter,
   gtk_sort_list_model_sorter_changed (sorter, change, self, FALSE);
 }
 
+static void
+gtk_sort_list_model_sorter_item_changed_cb (GtkSorter        *sorter,
+                                            gpointer          item,
+                                            GtkSortListModel *self)
+{
+  guint i;
+
+  if (self->sort_keys == NULL)
+    return;
+
+  for (i = 0; i < self->n_items; i++)
+    {
+      gpointer other = g_list_model_get_item (self->model, i);
+
+      g_object_unref (other);
+      if (other != item)
+        continue;
+
+      /* Pretend the item was replaced by itself. This recreates its
+       * key and merges it back into the otherwise sorted items,
+       * which is a lot cheaper than sorting everything again.
+       */
+      gtk_sort_list_model_items_changed_cb (self->model, i, 1, 1, self);
+    }
+}
+
 static void
 gtk_sort_list_model_clear_model (GtkSortListModel *self)
 {
@@ -970,6 +1153,7 @@ gtk_sort_list_model_clear_real_sorter (GtkSortListModel *self)
     return;
 
   g_signal_handlers_disconnect_by_func (self->real_sorter, gtk_sort_list_model_sorter_changed_cb, self);
+  g_signal_handlers_disconnect_by_func (self->real_sorter, gtk_sort_list_model_sorter_item_changed_cb, self);
   g_clear_object (&self->real_sorter);
 }
 
@@ -998,7 +1182,10 @@ gtk_sort_list_model_ensure_real_sorter (GtkSortListModel *self,
     }
 
   if (self->real_sorter)
-    g_signal_connect (self->real_sorter, "changed", G_CALLBACK (gtk_sort_list_model_sorter_changed_cb), self);
+    {
+      g_signal_connect (self->real_sorter, "changed", G_CALLBACK (gtk_sort_list_model_sorter_changed_cb), self);
+      g_signal_connect (self->real_sorter, "item-changed", G_CALLBACK (gtk_sort_list_model_sorter_item_changed_cb), self);
+    }
 
   gtk_sort_list_model_sorter_changed (self->real_sorter, GTK_SORTER_CHANGE_DIFFERENT, self, sections_changed);
 }
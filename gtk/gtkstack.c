@@ -26,6 +26,8 @@
 #include "gtkenums.h"
 #include "gtkaccessibleprivate.h"
 #include "gtkatcontextprivate.h"
+#include "gtkbinlayout.h"
+#include "gtkgizmoprivate.h"
 #include "gtkprivate.h"
 #include "gtkprogresstrackerprivate.h"
 #include "gtksettingsprivate.h"
@@ -149,6 +151,9 @@ typedef struct {
   guint transition_duration;
 
   GtkStackPage *last_visible_child;
+  GskRenderNode *last_visible_node;
+  int last_visible_node_width;
+  int last_visible_node_height;
   guint tick_id;
   GtkProgressTracker tracker;
   gboolean first_frame_skipped;
@@ -162,6 +167,8 @@ typedef struct {
 
   GtkSelectionModel *pages;
 
+  guint prewarm_id;
+
 } GtkStackPrivate;
 
 static void gtk_stack_buildable_interface_init (GtkBuildableIface *iface);
@@ -216,6 +223,11 @@ struct _GtkStackPage
 
   GtkATContext *at_context;
 
+  /* for pages added with gtk_stack_add_lazy(), until the child is created */
+  GtkStackCreateChildFunc create_func;
+  gpointer create_data;
+  GDestroyNotify create_destroy;
+
   guint needs_attention : 1;
   guint visible         : 1;
   guint use_underline   : 1;
@@ -350,6 +362,9 @@ gtk_stack_page_finalize (GObject *object)
   g_free (page->title);
   g_free (page->icon_name);
 
+  if (page->create_destroy)
+    page->create_destroy (page->create_data);
+
   if (page->last_focus)
     g_object_remove_weak_pointer (G_OBJECT (page->last_focus),
                                   (gpointer *)&page->last_focus);
@@ -837,6 +852,8 @@ gtk_stack_dispose (GObject *obj)
   GtkWidget *child;
   guint n_pages = priv->children->len;
 
+  g_clear_handle_id (&priv->prewarm_id, g_source_remove);
+
   while ((child = gtk_widget_get_first_child (GTK_WIDGET (stack))))
     stack_remove (stack, child, TRUE);
 
@@ -860,6 +877,7 @@ gtk_stack_finalize (GObject *obj)
 
   gtk_stack_unschedule_ticks (stack);
 
+  g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
   g_ptr_array_free (priv->children, TRUE);
 
   G_OBJECT_CLASS (gtk_stack_parent_class)->finalize (obj);
@@ -1246,6 +1264,7 @@ gtk_stack_progress_updated (GtkStack *stack)
     {
       gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
       priv->last_visible_child = NULL;
+      g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
     }
 }
 
@@ -1387,6 +1406,87 @@ gtk_stack_start_transition (GtkStack               *stack,
   gtk_stack_progress_updated (GTK_STACK (widget));
 }
 
+static void
+gtk_stack_page_ensure_child (GtkStack     *stack,
+                             GtkStackPage *page)
+{
+  GtkStackCreateChildFunc create_func = page->create_func;
+  GtkWidget *child;
+
+  if (create_func == NULL)
+    return;
+
+  /* Clear the function first, in case creating the child
+   * ends up showing the page again
+   */
+  page->create_func = NULL;
+  child = create_func (stack, page->name, page->create_data);
+
+  if (page->create_destroy)
+    page->create_destroy (page->create_data);
+  page->create_data = NULL;
+  page->create_destroy = NULL;
+
+  if (child == NULL)
+    {
+      g_warning ("GtkStackCreateChildFunc did not return a child for page “%s”",
+                 page->name ? page->name : "(unnamed)");
+      return;
+    }
+
+  gtk_widget_set_parent (child, page->widget);
+}
+
+static gboolean
+gtk_stack_prewarm_cb (gpointer data)
+{
+  GtkStack *stack = data;
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+  guint idx;
+
+  priv->prewarm_id = 0;
+
+  if (priv->visible_child == NULL)
+    return G_SOURCE_REMOVE;
+
+  for (idx = 0; idx < priv->children->len; idx++)
+    {
+      if (g_ptr_array_index (priv->children, idx) == priv->visible_child)
+        break;
+    }
+
+  if (idx > 0)
+    gtk_stack_page_ensure_child (stack, g_ptr_array_index (priv->children, idx - 1));
+  if (idx + 1 < priv->children->len)
+    gtk_stack_page_ensure_child (stack, g_ptr_array_index (priv->children, idx + 1));
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+gtk_stack_queue_prewarm (GtkStack *stack)
+{
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+  guint idx;
+
+  if (priv->prewarm_id != 0)
+    return;
+
+  for (idx = 0; idx < priv->children->len; idx++)
+    {
+      GtkStackPage *page = g_ptr_array_index (priv->children, idx);
+
+      if (page->create_func)
+        break;
+    }
+
+  if (idx == priv->children->len)
+    return;
+
+  priv->prewarm_id = g_idle_add_full (G_PRIORITY_LOW, gtk_stack_prewarm_cb, stack, NULL);
+  gdk_source_set_static_name_by_id (priv->prewarm_id, "[gtk] gtk_stack_prewarm_cb");
+}
+
 static void
 set_visible_child (GtkStack               *stack,
                    GtkStackPage      *child_info,
@@ -1460,6 +1560,7 @@ set_visible_child (GtkStack               *stack,
   if (priv->last_visible_child)
     gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
   priv->last_visible_child = NULL;
+  g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
 
   if (priv->visible_child && priv->visible_child->widget)
     {
@@ -1479,6 +1580,7 @@ set_visible_child (GtkStack               *stack,
 
   if (child_info)
     {
+      gtk_stack_page_ensure_child (stack, child_info);
       gtk_widget_set_child_visible (child_info->widget, TRUE);
 
       if (contains_focus)
@@ -1535,6 +1637,9 @@ set_visible_child (GtkStack               *stack,
                                                MAX (old_pos, new_pos) - MIN (old_pos, new_pos) + 1);
     }
 
+  if (child_info)
+    gtk_stack_queue_prewarm (stack);
+
   gtk_stack_start_transition (stack, transition_type, transition_duration);
 }
 
@@ -1556,6 +1661,7 @@ update_child_visible (GtkStack     *stack,
     {
       gtk_widget_set_child_visible (priv->last_visible_child->widget, FALSE);
       priv->last_visible_child = NULL;
+      g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
     }
 
   gtk_accessible_update_state (GTK_ACCESSIBLE (child_info),
@@ -1646,6 +1752,85 @@ gtk_stack_add_named (GtkStack   *stack,
   return gtk_stack_add_internal (stack, child, name, NULL);
 }
 
+/**
+ * GtkStackCreateChildFunc:
+ * @stack: the `GtkStack`
+ * @name: (nullable): the name of the page
+ * @user_data: (closure): user data
+ *
+ * Called by a `GtkStack` to create the child of a page that was
+ * added with [method@Gtk.Stack.add_lazy].
+ *
+ * Returns: (transfer floating): the child for the page
+ *
+ * Since: 4.14
+ */
+
+/**
+ * gtk_stack_add_lazy:
+ * @stack: a `GtkStack`
+ * @name: (nullable): the name for the page
+ * @title: (nullable): a human-readable title for the page
+ * @create_func: (scope notified) (closure user_data) (destroy user_destroy):
+ *   function to create the child of the page
+ * @user_data: user data for @create_func
+ * @user_destroy: destroy notifier for @user_data
+ *
+ * Adds a page to @stack whose child is only created when needed.
+ *
+ * @create_func is called the first time the page becomes the visible
+ * child. After a page has been shown, the pages next to it are created
+ * in an idle handler with low priority, so that switching to them
+ * doesn't have to wait for their construction.
+ *
+ * The child returned by @create_func is placed inside a container
+ * widget, which is the [property@Gtk.StackPage:child] of the returned
+ * page. Until the child has been created, the page does not contribute
+ * to the size of a homogeneous @stack.
+ *
+ * This is useful for stacks with many pages that are expensive to
+ * build, such as preference dialogs. @create_func may use a
+ * `GtkBuilder` to build the child from a template or resource.
+ *
+ * Returns: (transfer none): the `GtkStackPage` for the new page
+ *
+ * Since: 4.14
+ */
+GtkStackPage *
+gtk_stack_add_lazy (GtkStack                *stack,
+                    const char              *name,
+                    const char              *title,
+                    GtkStackCreateChildFunc  create_func,
+                    gpointer                 user_data,
+                    GDestroyNotify           user_destroy)
+{
+  GtkStackPage *child_info;
+  GtkWidget *placeholder;
+
+  g_return_val_if_fail (GTK_IS_STACK (stack), NULL);
+  g_return_val_if_fail (create_func != NULL, NULL);
+
+  placeholder = gtk_gizmo_new ("widget", NULL, NULL, NULL, NULL,
+                               (GtkGizmoFocusFunc)gtk_widget_focus_child,
+                               (GtkGizmoGrabFocusFunc)gtk_widget_grab_focus_child);
+  gtk_widget_set_layout_manager (placeholder, gtk_bin_layout_new ());
+
+  child_info = g_object_new (GTK_TYPE_STACK_PAGE,
+                             "child", placeholder,
+                             "name", name,
+                             "title", title,
+                             NULL);
+  child_info->create_func = create_func;
+  child_info->create_data = user_data;
+  child_info->create_destroy = user_destroy;
+
+  gtk_stack_add_page (stack, child_info);
+
+  g_object_unref (child_info);
+
+  return child_info;
+}
+
 static GtkStackPage *
 gtk_stack_add_internal (GtkStack   *stack,
                         GtkWidget  *child,
@@ -1749,7 +1934,10 @@ stack_remove (GtkStack  *stack,
     priv->visible_child = NULL;
 
   if (priv->last_visible_child == child_info)
-    priv->last_visible_child = NULL;
+    {
+      priv->last_visible_child = NULL;
+      g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
+    }
 
   gtk_widget_unparent (child);
 
@@ -2359,6 +2547,37 @@ gtk_stack_get_request_mode (GtkWidget *widget)
         GTK_SIZE_REQUEST_HEIGHT_FOR_WIDTH;
 }
 
+/* The page that is going away does not change during the transition,
+ * so it is only snapshotted once. It is snapshotted again if its size
+ * changes, which happens when interpolating the size of the stack.
+ */
+static void
+gtk_stack_snapshot_last_visible_child (GtkWidget   *widget,
+                                       GtkSnapshot *snapshot)
+{
+  GtkStack *stack = GTK_STACK (widget);
+  GtkStackPrivate *priv = gtk_stack_get_instance_private (stack);
+  GtkWidget *child = priv->last_visible_child->widget;
+
+  if (priv->last_visible_node == NULL ||
+      priv->last_visible_node_width != gtk_widget_get_width (child) ||
+      priv->last_visible_node_height != gtk_widget_get_height (child))
+    {
+      GtkSnapshot *child_snapshot;
+
+      g_clear_pointer (&priv->last_visible_node, gsk_render_node_unref);
+
+      child_snapshot = gtk_snapshot_new ();
+      gtk_widget_snapshot_child (widget, child, child_snapshot);
+      priv->last_visible_node = gtk_snapshot_free_to_node (child_snapshot);
+      priv->last_visible_node_width = gtk_widget_get_width (child);
+      priv->last_visible_node_height = gtk_widget_get_height (child);
+    }
+
+  if (priv->last_visible_node)
+    gtk_snapshot_append_node (snapshot, priv->last_visible_node);
+}
+
 static void
 gtk_stack_snapshot_crossfade (GtkWidget   *widget,
                               GtkSnapshot *snapshot)
@@ -2370,11 +2589,7 @@ gtk_stack_snapshot_crossfade (GtkWidget   *widget,
   gtk_snapshot_push_cross_fade (snapshot, progress);
 
   if (priv->last_visible_child)
-    {
-      gtk_widget_snapshot_child (widget,
-                                 priv->last_visible_child->widget,
-                                 snapshot);
-    }
+    gtk_stack_snapshot_last_visible_child (widget, snapshot);
   gtk_snapshot_pop (snapshot);
 
   gtk_widget_snapshot_child (widget,
@@ -2437,7 +2652,7 @@ gtk_stack_snapshot_under (GtkWidget   *widget,
     {
       gtk_snapshot_save (snapshot);
       gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (pos_x, pos_y));
-      gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+      gtk_stack_snapshot_last_visible_child (widget, snapshot);
       gtk_snapshot_restore (snapshot);
     }
 }
@@ -2473,7 +2688,7 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
                                  - gtk_widget_get_height (widget) / 2.f,
                                  gtk_widget_get_width (widget) / 2.f));
       if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
-        gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+        gtk_stack_snapshot_last_visible_child (widget, snapshot);
       else
         gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
@@ -2497,7 +2712,7 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
   if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
     gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
   else if (priv->last_visible_child)
-    gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+    gtk_stack_snapshot_last_visible_child (widget, snapshot);
   gtk_snapshot_restore (snapshot);
 
   if (priv->last_visible_child && progress <= 0.5)
@@ -2517,7 +2732,7 @@ gtk_stack_snapshot_cube (GtkWidget   *widget,
                                  - gtk_widget_get_height (widget) / 2.f,
                                  gtk_widget_get_width (widget) / 2.f));
       if (priv->active_transition_type == GTK_STACK_TRANSITION_TYPE_ROTATE_LEFT)
-        gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+        gtk_stack_snapshot_last_visible_child (widget, snapshot);
       else
         gtk_widget_snapshot_child (widget, priv->visible_child->widget, snapshot);
       gtk_snapshot_restore (snapshot);
@@ -2580,7 +2795,7 @@ gtk_stack_snapshot_slide (GtkWidget   *widget,
 
       gtk_snapshot_save (snapshot);
       gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
-      gtk_widget_snapshot_child (widget, priv->last_visible_child->widget, snapshot);
+      gtk_stack_snapshot_last_visible_child (widget, snapshot);
       gtk_snapshot_restore (snapshot);
      }
 
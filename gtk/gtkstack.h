@@ -123,6 +123,18 @@ GtkStackPage *         gtk_stack_add_titled              (GtkStack
                                                           GtkWidget              *child,
                                                           const char             *name,
                                                           const char             *title);
+
+typedef GtkWidget *  (* GtkStackCreateChildFunc)         (GtkStack               *stack,
+                                                          const char             *name,
+                                                          gpointer                user_data);
+
+GDK_AVAILABLE_IN_4_14
+GtkStackPage *         gtk_stack_add_lazy                (GtkStack               *stack,
+                                                          const char             *name,
+                                                          const char             *title,
+                                                          GtkStackCreateChildFunc create_func,
+                                                          gpointer                user_data,
+                                                          GDestroyNotify          user_destroy);
 GDK_AVAILABLE_IN_ALL
 void                   gtk_stack_remove                  (GtkStack               *stack,
                                                           GtkWidget              *child);
@@ -0,0 +1,202 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkstartupprivate.h"
+
+#include "gtkdebug.h"
+#include "gtkprivate.h"
+
+#include "gdk/gdkdebugprivate.h"
+#include "gdk/gdkprofilerprivate.h"
+
+/* Startup phases are the expensive steps between gtk_init() and the
+ * first frame: opening the display, loading settings, themes and
+ * modules. They nest, and each of them produces a profiler mark.
+ *
+ * The phases are also recorded, so that GTK_DEBUG=startup can print
+ * a summary when the first frame has been rendered. After that,
+ * tracking stops and all of this is a no-op.
+ *
+ * Phases are only tracked on the thread that started the first one,
+ * work that other threads do during startup is not included.
+ */
+
+typedef struct
+{
+  const char *name;
+  char *message;
+  guint depth;
+  gint64 start;
+  gint64 end;
+  gint64 profiler_start;
+} StartupPhase;
+
+static GArray *phases;
+static GArray *open_phases;
+static GThread *startup_thread;
+static gboolean startup_finished;
+
+static void
+startup_phase_clear (gpointer data)
+{
+  StartupPhase *phase = data;
+
+  g_free (phase->message);
+}
+
+static gboolean
+should_track (void)
+{
+  if (startup_finished)
+    return FALSE;
+
+  if (startup_thread == NULL)
+    {
+      startup_thread = g_thread_self ();
+      phases = g_array_new (FALSE, FALSE, sizeof (StartupPhase));
+      g_array_set_clear_func (phases, startup_phase_clear);
+      open_phases = g_array_new (FALSE, FALSE, sizeof (guint));
+    }
+
+  return startup_thread == g_thread_self ();
+}
+
+/*< private >
+ * gtk_startup_phase_begin:
+ * @name: (not nullable): a static string naming the phase
+ *
+ * Starts a startup phase. It is nested inside any phase that has
+ * been started, but not ended yet.
+ *
+ * Every call must be paired with a call to gtk_startup_phase_end().
+ */
+void
+gtk_startup_phase_begin (const char *name)
+{
+  StartupPhase phase;
+  guint index;
+
+  if (!should_track ())
+    return;
+
+  phase.name = name;
+  phase.message = NULL;
+  phase.depth = open_phases->len;
+  phase.start = g_get_monotonic_time ();
+  phase.end = 0;
+  phase.profiler_start = GDK_PROFILER_CURRENT_TIME;
+
+  index = phases->len;
+  g_array_append_val (phases, phase);
+  g_array_append_val (open_phases, index);
+}
+
+/*< private >
+ * gtk_startup_phase_end:
+ * @message: (nullable): details to add to the phase
+ *
+ * Ends the innermost open startup phase.
+ */
+void
+gtk_startup_phase_end (const char *message)
+{
+  StartupPhase *phase;
+  guint index;
+
+  if (!should_track ())
+    return;
+
+  g_return_if_fail (open_phases->len > 0);
+
+  index = g_array_index (open_phases, guint, open_phases->len - 1);
+  g_array_set_size (open_phases, open_phases->len - 1);
+
+  phase = &g_array_index (phases, StartupPhase, index);
+  phase->message = g_strdup (message);
+  phase->end = g_get_monotonic_time ();
+
+  gdk_profiler_end_mark (phase->profiler_start, phase->name, message);
+}
+
+/*< private >
+ * gtk_startup_is_finished:
+ *
+ * Returns whether startup has finished, ie the first frame has
+ * been rendered.
+ *
+ * Returns: %TRUE if startup has finished
+ */
+gboolean
+gtk_startup_is_finished (void)
+{
+  return startup_finished;
+}
+
+static void
+print_summary (void)
+{
+  gint64 origin;
+  guint i;
+
+  if (phases->len == 0)
+    return;
+
+  origin = g_array_index (phases, StartupPhase, 0).start;
+
+  gdk_debug_message ("Startup phases (start, duration in ms):");
+  for (i = 0; i < phases->len; i++)
+    {
+      StartupPhase *phase = &g_array_index (phases, StartupPhase, i);
+
+      gdk_debug_message ("%8.2f %8.2f  %*s%s%s%s",
+                         (phase->start - origin) / 1000.,
+                         (phase->end - phase->start) / 1000.,
+                         (int) (2 * phase->depth), "",
+                         phase->name,
+                         phase->message ? ": " : "",
+                         phase->message ? phase->message : "");
+    }
+}
+
+/*< private >
+ * gtk_startup_finish:
+ *
+ * Marks the end of startup. This is called when the first
+ * frame has been rendered.
+ *
+ * Phases that are still open are ended, and the summary is
+ * printed if GTK_DEBUG=startup is set.
+ */
+void
+gtk_startup_finish (void)
+{
+  if (!should_track ())
+    return;
+
+  while (open_phases->len > 0)
+    gtk_startup_phase_end (NULL);
+
+  startup_finished = TRUE;
+
+  if (GTK_DEBUG_CHECK (STARTUP))
+    print_summary ();
+
+  g_clear_pointer (&phases, g_array_unref);
+  g_clear_pointer (&open_phases, g_array_unref);
+}
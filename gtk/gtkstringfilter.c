@@ -52,8 +52,22 @@ struct _GtkStringFilter
   GtkStringFilterMatchMode match_mode;
 
   GtkExpression *expression;
+
+  GMutex cache_lock; /* matching may happen in parallel, see gtk_filter_is_threadsafe() */
+  GHashTable *cache; /* item => CacheEntry */
 };
 
+/* Normalizing and casefolding is a lot more expensive than evaluating
+ * the expression, and it has to be done for every item on every change
+ * of the search term. So we remember the result per item, and redo it
+ * only when the item's string changed.
+ */
+typedef struct
+{
+  char *string;
+  char *prepared;
+} CacheEntry;
+
 enum {
   PROP_0,
   PROP_EXPRESSION,
@@ -88,6 +102,96 @@ gtk_string_filter_prepare (GtkStringFilter *self,
   return result;
 }
 
+static void
+cache_entry_free (gpointer data)
+{
+  CacheEntry *entry = data;
+
+  g_free (entry->string);
+  g_free (entry->prepared);
+  g_free (entry);
+}
+
+static void
+gtk_string_filter_item_finalized (gpointer  data,
+                                  GObject  *where_the_object_was)
+{
+  GtkStringFilter *self = data;
+
+  g_mutex_lock (&self->cache_lock);
+  g_hash_table_remove (self->cache, where_the_object_was);
+  g_mutex_unlock (&self->cache_lock);
+}
+
+static void
+gtk_string_filter_clear_cache (GtkStringFilter *self)
+{
+  GHashTableIter iter;
+  gpointer item;
+
+  g_mutex_lock (&self->cache_lock);
+
+  g_hash_table_iter_init (&iter, self->cache);
+  while (g_hash_table_iter_next (&iter, &item, NULL))
+    g_object_weak_unref (item, gtk_string_filter_item_finalized, self);
+
+  g_hash_table_remove_all (self->cache);
+
+  g_mutex_unlock (&self->cache_lock);
+}
+
+/* When matching in parallel, the item is kept alive and its string
+ * does not change while matching, so the entry stays valid after
+ * the lock is released.
+ * The expensive preparation of new strings happens without holding
+ * the lock.
+ */
+static const char *
+gtk_string_filter_get_prepared (GtkStringFilter *self,
+                                gpointer         item,
+                                const char      *s)
+{
+  CacheEntry *entry;
+  char *prepared;
+
+  g_mutex_lock (&self->cache_lock);
+  entry = g_hash_table_lookup (self->cache, item);
+  if (entry != NULL && g_strcmp0 (entry->string, s) == 0)
+    {
+      g_mutex_unlock (&self->cache_lock);
+      return entry->prepared;
+    }
+  g_mutex_unlock (&self->cache_lock);
+
+  prepared = gtk_string_filter_prepare (self, s);
+
+  g_mutex_lock (&self->cache_lock);
+  entry = g_hash_table_lookup (self->cache, item);
+  if (entry == NULL)
+    {
+      entry = g_new (CacheEntry, 1);
+      entry->string = g_strdup (s);
+      entry->prepared = prepared;
+      g_object_weak_ref (item, gtk_string_filter_item_finalized, self);
+      g_hash_table_insert (self->cache, item, entry);
+    }
+  else if (g_strcmp0 (entry->string, s) != 0)
+    {
+      g_free (entry->string);
+      g_free (entry->prepared);
+      entry->string = g_strdup (s);
+      entry->prepared = prepared;
+    }
+  else
+    {
+      /* the same item appears multiple times and another thread was faster */
+      g_free (prepared);
+    }
+  g_mutex_unlock (&self->cache_lock);
+
+  return entry->prepared;
+}
+
 /* This is necessary because code just looks at self->search otherwise
  * and that can be the empty string...
  */
@@ -103,7 +207,7 @@ gtk_string_filter_match (GtkFilter *filter,
 {
   GtkStringFilter *self = GTK_STRING_FILTER (filter);
   GValue value = G_VALUE_INIT;
-  char *prepared;
+  const char *prepared;
   const char *s;
   gboolean result;
 
@@ -114,9 +218,12 @@ gtk_string_filter_match (GtkFilter *filter,
       !gtk_expression_evaluate (self->expression, item, &value))
     return FALSE;
   s = g_value_get_string (&value);
-  prepared = gtk_string_filter_prepare (self, s);
+  prepared = gtk_string_filter_get_prepared (self, item, s);
   if (prepared == NULL)
-    return FALSE;
+    {
+      g_value_unset (&value);
+      return FALSE;
+    }
 
   switch (self->match_mode)
     {
@@ -137,7 +244,6 @@ gtk_string_filter_match (GtkFilter *filter,
   g_print ("%s (%s) %s %s (%s)\n", s, prepared, result ? "==" : "!=", self->search, self->search_prepared);
 #endif
 
-  g_free (prepared);
   g_value_unset (&value);
 
   return result;
@@ -229,10 +335,22 @@ gtk_string_filter_dispose (GObject *object)
   g_clear_pointer (&self->search, g_free);
   g_clear_pointer (&self->search_prepared, g_free);
   g_clear_pointer (&self->expression, gtk_expression_unref);
+  gtk_string_filter_clear_cache (self);
 
   G_OBJECT_CLASS (gtk_string_filter_parent_class)->dispose (object);
 }
 
+static void
+gtk_string_filter_finalize (GObject *object)
+{
+  GtkStringFilter *self = GTK_STRING_FILTER (object);
+
+  g_hash_table_unref (self->cache);
+  g_mutex_clear (&self->cache_lock);
+
+  G_OBJECT_CLASS (gtk_string_filter_parent_class)->finalize (object);
+}
+
 static void
 gtk_string_filter_class_init (GtkStringFilterClass *class)
 {
@@ -245,6 +363,7 @@ gtk_string_filter_class_init (GtkStringFilterClass *class)
   object_class->get_property = gtk_string_filter_get_property;
   object_class->set_property = gtk_string_filter_set_property;
   object_class->dispose = gtk_string_filter_dispose;
+  object_class->finalize = gtk_string_filter_finalize;
 
   /**
    * GtkStringFilter:expression: (type GtkExpression) (attributes org.gtk.Property.get=gtk_string_filter_get_expression org.gtk.Property.set=gtk_string_filter_set_expression)
@@ -295,6 +414,8 @@ gtk_string_filter_init (GtkStringFilter *self)
 {
   self->ignore_case = TRUE;
   self->match_mode = GTK_STRING_FILTER_MATCH_MODE_SUBSTRING;
+  g_mutex_init (&self->cache_lock);
+  self->cache = g_hash_table_new_full (NULL, NULL, NULL, cache_entry_free);
 }
 
 /**
@@ -418,6 +539,7 @@ gtk_string_filter_set_expression (GtkStringFilter *self,
 
   g_clear_pointer (&self->expression, gtk_expression_unref);
   self->expression = gtk_expression_ref (expression);
+  gtk_string_filter_clear_cache (self);
 
   if (gtk_string_filter_has_search (self))
     gtk_filter_changed (GTK_FILTER (self), GTK_FILTER_CHANGE_DIFFERENT);
@@ -458,6 +580,7 @@ gtk_string_filter_set_ignore_case (GtkStringFilter *self,
     return;
 
   self->ignore_case = ignore_case;
+  gtk_string_filter_clear_cache (self);
 
   if (self->search)
     {
@@ -35,6 +35,9 @@
  * `GtkStringList` is well-suited for any place where you would
  * typically use a `char*[]`, but need a list model.
  *
+ * The strings are stored in a compact way, and the objects are only
+ * created when they are first requested with g_list_model_get_item().
+ *
  * # GtkStringList as GtkBuildable
  *
  * The `GtkStringList` implementation of the `GtkBuildable` interface
@@ -67,12 +70,6 @@
  * a [property@Gtk.StringObject:string] property.
  */
 
-#define GDK_ARRAY_ELEMENT_TYPE GtkStringObject *
-#define GDK_ARRAY_NAME objects
-#define GDK_ARRAY_TYPE_NAME Objects
-#define GDK_ARRAY_FREE_FUNC g_object_unref
-#include "gdk/gdkarrayimpl.c"
-
 struct _GtkStringObject
 {
   GObject parent_instance;
@@ -185,6 +182,78 @@ gtk_string_object_get_string (GtkStringObject *self)
   return self->string;
 }
 
+/* }}} */
+/* {{{ String storage */
+
+/* Strings are stored back to back in chunks, so that adding many
+ * strings only needs a few allocations. Chunks either belong to the
+ * list or are provided via gtk_string_list_splice_bytes(). A chunk is
+ * freed when all its strings have been removed.
+ */
+#define CHUNK_SIZE 4096
+
+typedef struct
+{
+  GBytes *bytes; /* set if data belongs to these bytes */
+  char *data;
+  gsize size;
+  gsize used;
+  guint n_strings;
+} Chunk;
+
+typedef struct
+{
+  const char *string;
+  Chunk *chunk;
+  GtkStringObject *object; /* created on demand */
+} Item;
+
+#define GDK_ARRAY_ELEMENT_TYPE Item
+#define GDK_ARRAY_NAME items
+#define GDK_ARRAY_TYPE_NAME Items
+#define GDK_ARRAY_BY_VALUE 1
+#define GDK_ARRAY_NO_MEMSET 1
+#include "gdk/gdkarrayimpl.c"
+
+static Chunk *
+chunk_new (gsize size)
+{
+  Chunk *chunk;
+
+  chunk = g_new (Chunk, 1);
+  chunk->bytes = NULL;
+  chunk->data = g_malloc (size);
+  chunk->size = size;
+  chunk->used = 0;
+  chunk->n_strings = 0;
+
+  return chunk;
+}
+
+static Chunk *
+chunk_new_for_bytes (GBytes *bytes)
+{
+  Chunk *chunk;
+
+  chunk = g_new (Chunk, 1);
+  chunk->bytes = g_bytes_ref (bytes);
+  chunk->data = (char *) g_bytes_get_data (bytes, &chunk->size);
+  chunk->used = chunk->size;
+  chunk->n_strings = 0;
+
+  return chunk;
+}
+
+static void
+chunk_free (Chunk *chunk)
+{
+  if (chunk->bytes)
+    g_bytes_unref (chunk->bytes);
+  else
+    g_free (chunk->data);
+  g_free (chunk);
+}
+
 /* }}} */
 /* {{{ List model implementation */
 
@@ -192,7 +261,8 @@ struct _GtkStringList
 {
   GObject parent_instance;
 
-  Objects items;
+  Items items;
+  Chunk *current; /* chunk that new strings are appended to */
 };
 
 struct _GtkStringListClass
@@ -200,6 +270,61 @@ struct _GtkStringListClass
   GObjectClass parent_class;
 };
 
+static void
+gtk_string_list_release_items (GtkStringList *self,
+                               guint          position,
+                               guint          n_items)
+{
+  guint i;
+
+  for (i = position; i < position + n_items; i++)
+    {
+      Item *item = items_index (&self->items, i);
+
+      g_clear_object (&item->object);
+
+      item->chunk->n_strings--;
+      if (item->chunk->n_strings == 0 && item->chunk != self->current)
+        chunk_free (item->chunk);
+    }
+}
+
+/* Makes sure that strings of the given size can be stored and
+ * returns the chunk to store them in.
+ * Large amounts of strings get their own chunk.
+ */
+static Chunk *
+gtk_string_list_reserve (GtkStringList *self,
+                         gsize          size)
+{
+  if (size > CHUNK_SIZE / 4)
+    return chunk_new (size);
+
+  if (self->current == NULL ||
+      self->current->size - self->current->used < size)
+    {
+      if (self->current && self->current->n_strings == 0)
+        chunk_free (self->current);
+      self->current = chunk_new (CHUNK_SIZE);
+    }
+
+  return self->current;
+}
+
+static void
+gtk_string_list_store (Chunk      *chunk,
+                       Item       *item,
+                       const char *string,
+                       gsize       size)
+{
+  memcpy (chunk->data + chunk->used, string, size);
+  item->string = chunk->data + chunk->used;
+  item->chunk = chunk;
+  item->object = NULL;
+  chunk->used += size;
+  chunk->n_strings++;
+}
+
 static GType
 gtk_string_list_get_item_type (GListModel *list)
 {
@@ -211,7 +336,7 @@ gtk_string_list_get_n_items (GListModel *list)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
 
-  return objects_get_size (&self->items);
+  return items_get_size (&self->items);
 }
 
 static gpointer
@@ -219,11 +344,16 @@ gtk_string_list_get_item (GListModel *list,
                           guint       position)
 {
   GtkStringList *self = GTK_STRING_LIST (list);
+  Item *item;
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return g_object_ref (objects_get (&self->items, position));
+  item = items_index (&self->items, position);
+  if (item->object == NULL)
+    item->object = gtk_string_object_new (item->string);
+
+  return g_object_ref (item->object);
 }
 
 static void
@@ -420,7 +550,13 @@ gtk_string_list_dispose (GObject *object)
 {
   GtkStringList *self = GTK_STRING_LIST (object);
 
-  objects_clear (&self->items);
+  gtk_string_list_release_items (self, 0, items_get_size (&self->items));
+  items_clear (&self->items);
+  if (self->current)
+    {
+      g_assert (self->current->n_strings == 0);
+      g_clear_pointer (&self->current, chunk_free);
+    }
 
   G_OBJECT_CLASS (gtk_string_list_parent_class)->dispose (object);
 }
@@ -468,7 +604,7 @@ gtk_string_list_class_init (GtkStringListClass *class)
 static void
 gtk_string_list_init (GtkStringList *self)
 {
-  objects_init (&self->items);
+  items_init (&self->items);
 }
 
 /* }}} */
@@ -517,21 +653,103 @@ gtk_string_list_splice (GtkStringList      *self,
                         const char * const *additions)
 {
   guint i, n_additions;
+  gsize *sizes, total;
+  Chunk *chunk;
 
   g_return_if_fail (GTK_IS_STRING_LIST (self));
   g_return_if_fail (position + n_removals >= position); /* overflow */
-  g_return_if_fail (position + n_removals <= objects_get_size (&self->items));
+  g_return_if_fail (position + n_removals <= items_get_size (&self->items));
 
   if (additions)
     n_additions = g_strv_length ((char **) additions);
   else
     n_additions = 0;
 
-  objects_splice (&self->items, position, n_removals, FALSE, NULL, n_additions);
+  gtk_string_list_release_items (self, position, n_removals);
+  items_splice (&self->items, position, n_removals, TRUE, NULL, n_additions);
+
+  if (n_additions > 0)
+    {
+      sizes = g_new (gsize, n_additions);
+      total = 0;
+      for (i = 0; i < n_additions; i++)
+        {
+          sizes[i] = strlen (additions[i]) + 1;
+          total += sizes[i];
+        }
+
+      /* all strings go into one chunk */
+      chunk = gtk_string_list_reserve (self, total);
+      for (i = 0; i < n_additions; i++)
+        gtk_string_list_store (chunk, items_index (&self->items, position + i), additions[i], sizes[i]);
+
+      g_free (sizes);
+    }
+
+  if (n_removals || n_additions)
+    g_list_model_items_changed (G_LIST_MODEL (self), position, n_removals, n_additions);
+}
+
+/**
+ * gtk_string_list_splice_bytes:
+ * @self: a `GtkStringList`
+ * @position: the position at which to make the change
+ * @n_removals: the number of strings to remove
+ * @strings: the strings to add, each followed by a nul byte
+ *
+ * Changes @self by removing @n_removals strings and adding the
+ * strings contained in @strings to it.
+ *
+ * @strings contains the strings back to back, each terminated by
+ * a nul byte, so "a\0b\0c\0" adds three strings. In particular,
+ * the last byte must be a nul byte.
+ *
+ * This is a variant of [method@Gtk.StringList.splice] for adding
+ * large numbers of strings. Instead of copying the strings, @self
+ * keeps a reference to @strings and uses its data directly.
+ *
+ * Since: 4.14
+ */
+void
+gtk_string_list_splice_bytes (GtkStringList *self,
+                              guint          position,
+                              guint          n_removals,
+                              GBytes        *strings)
+{
+  const char *data, *end, *s;
+  guint i, n_additions;
+  Chunk *chunk;
+  gsize size;
+
+  g_return_if_fail (GTK_IS_STRING_LIST (self));
+  g_return_if_fail (position + n_removals >= position); /* overflow */
+  g_return_if_fail (position + n_removals <= items_get_size (&self->items));
+  g_return_if_fail (strings != NULL);
+
+  data = g_bytes_get_data (strings, &size);
+  g_return_if_fail (size == 0 || data[size - 1] == '\0');
 
-  for (i = 0; i < n_additions; i++)
+  end = data + size;
+  n_additions = 0;
+  for (s = data; s < end; s = (const char *) memchr (s, '\0', end - s) + 1)
+    n_additions++;
+
+  gtk_string_list_release_items (self, position, n_removals);
+  items_splice (&self->items, position, n_removals, TRUE, NULL, n_additions);
+
+  if (n_additions > 0)
     {
-      *objects_index (&self->items, position + i) = gtk_string_object_new (additions[i]);
+      chunk = chunk_new_for_bytes (strings);
+      chunk->n_strings = n_additions;
+
+      for (i = 0, s = data; i < n_additions; i++, s = (const char *) memchr (s, '\0', end - s) + 1)
+        {
+          Item *item = items_index (&self->items, position + i);
+
+          item->string = s;
+          item->chunk = chunk;
+          item->object = NULL;
+        }
     }
 
   if (n_removals || n_additions)
@@ -546,7 +764,7 @@ gtk_string_list_splice (GtkStringList      *self,
  * Appends @string to @self.
  *
  * The @string will be copied. See
- * [method@Gtk.StringList.take] for a way to avoid that.
+ * [method@Gtk.StringList.splice_bytes] for a way to avoid that.
  */
 void
 gtk_string_list_append (GtkStringList *self,
@@ -554,9 +772,7 @@ gtk_string_list_append (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new (string));
-
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  gtk_string_list_splice (self, items_get_size (&self->items), 0, (const char * const[]) { string, NULL });
 }
 
 /**
@@ -580,9 +796,8 @@ gtk_string_list_take (GtkStringList *self,
 {
   g_return_if_fail (GTK_IS_STRING_LIST (self));
 
-  objects_append (&self->items, gtk_string_object_new_take (string));
-
-  g_list_model_items_changed (G_LIST_MODEL (self), objects_get_size (&self->items) - 1, 0, 1);
+  gtk_string_list_append (self, string);
+  g_free (string);
 }
 
 /**
@@ -624,10 +839,10 @@ gtk_string_list_get_string (GtkStringList *self,
 {
   g_return_val_if_fail (GTK_IS_STRING_LIST (self), NULL);
 
-  if (position >= objects_get_size (&self->items))
+  if (position >= items_get_size (&self->items))
     return NULL;
 
-  return objects_get (&self->items, position)->string;
+  return items_get (&self->items, position)->string;
 }
 
 /* }}} */
@@ -66,6 +66,12 @@ void            gtk_string_list_splice          (GtkStringList         *self,
                                                  guint                  n_removals,
                                                  const char * const    *additions);
 
+GDK_AVAILABLE_IN_4_14
+void            gtk_string_list_splice_bytes    (GtkStringList         *self,
+                                                 guint                  position,
+                                                 guint                  n_removals,
+                                                 GBytes                *strings);
+
 GDK_AVAILABLE_IN_ALL
 const char *    gtk_string_list_get_string      (GtkStringList         *self,
                                                  guint                  position);
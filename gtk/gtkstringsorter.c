@@ -60,29 +60,13 @@ G_DEFINE_TYPE (GtkStringSorter, gtk_string_sorter, GTK_TYPE_SORTER)
 static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
 
 static char *
-gtk_string_sorter_get_key (GtkExpression *expression,
-                           gboolean       ignore_case,
-                           GtkCollation   collation,
-                           gpointer       item1)
+gtk_string_sorter_make_key (const char   *string,
+                            gboolean      ignore_case,
+                            GtkCollation  collation)
 {
-  GValue value = G_VALUE_INIT;
-  const char *string;
   char *s;
   char *key;
 
-  if (expression == NULL)
-    return NULL;
-
-  if (!gtk_expression_evaluate (expression, item1, &value))
-    return NULL;
-
-  string = g_value_get_string (&value);
-  if (string == NULL)
-    {
-      g_value_unset (&value);
-      return NULL;
-    }
-
   if (ignore_case)
     s = g_utf8_casefold (string, -1);
   else
@@ -113,6 +97,34 @@ gtk_string_sorter_get_key (GtkExpression *expression,
   if (s != string)
     g_free (s);
 
+  return key;
+}
+
+static char *
+gtk_string_sorter_get_key (GtkExpression *expression,
+                           gboolean       ignore_case,
+                           GtkCollation   collation,
+                           gpointer       item1)
+{
+  GValue value = G_VALUE_INIT;
+  const char *string;
+  char *key;
+
+  if (expression == NULL)
+    return NULL;
+
+  if (!gtk_expression_evaluate (expression, item1, &value))
+    return NULL;
+
+  string = g_value_get_string (&value);
+  if (string == NULL)
+    {
+      g_value_unset (&value);
+      return NULL;
+    }
+
+  key = gtk_string_sorter_make_key (string, ignore_case, collation);
+
   g_value_unset (&value);
 
   return key;
@@ -214,6 +226,43 @@ gtk_string_sort_keys_clear_key (GtkSortKeys *keys,
   g_free (*key);
 }
 
+/* Only the expression needs the main thread, collation keys are the
+ * expensive part and can be created anywhere.
+ */
+static void
+gtk_string_sort_keys_prepare_key (GtkSortKeys *keys,
+                                  gpointer     item,
+                                  gpointer     key_memory)
+{
+  GtkStringSortKeys *self = (GtkStringSortKeys *) keys;
+  char **key = (char **) key_memory;
+  GValue value = G_VALUE_INIT;
+
+  if (gtk_expression_evaluate (self->expression, item, &value))
+    {
+      *key = g_value_dup_string (&value);
+      g_value_unset (&value);
+    }
+  else
+    *key = NULL;
+}
+
+static void
+gtk_string_sort_keys_finish_key (GtkSortKeys *keys,
+                                 gpointer     key_memory)
+{
+  GtkStringSortKeys *self = (GtkStringSortKeys *) keys;
+  char **key = (char **) key_memory;
+  char *string;
+
+  if (*key == NULL)
+    return;
+
+  string = *key;
+  *key = gtk_string_sorter_make_key (string, self->ignore_case, self->collation);
+  g_free (string);
+}
+
 static const GtkSortKeysClass GTK_STRING_SORT_KEYS_CLASS =
 {
   gtk_string_sort_keys_free,
@@ -221,6 +270,9 @@ static const GtkSortKeysClass GTK_STRING_SORT_KEYS_CLASS =
   gtk_string_sort_keys_is_compatible,
   gtk_string_sort_keys_init_key,
   gtk_string_sort_keys_clear_key,
+  gtk_sort_keys_threadsafe,
+  gtk_string_sort_keys_prepare_key,
+  gtk_string_sort_keys_finish_key,
 };
 
 static GtkSortKeys *
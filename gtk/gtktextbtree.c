@@ -1099,6 +1099,8 @@ _gtk_text_btree_insert (GtkTextIter *iter,
                                        * one in current chunk.
                                        */
   int delim;                          /* index of paragraph delimiter */
+  int piece;                          /* start of the current segment */
+  int piece_len;                      /* length of the current segment */
   int line_count_delta;                /* Counts change to total number of
                                         * lines in file.
                                         */
@@ -1165,19 +1167,38 @@ _gtk_text_btree_insert (GtkTextIter *iter,
       chunk_len = eol - sol;
 
       g_assert (g_utf8_validate (&text[sol], chunk_len, NULL));
-      seg = _gtk_char_segment_new (&text[sol], chunk_len);
 
-      char_count_delta += seg->char_count;
-
-      if (cur_seg == NULL)
-        {
-          seg->next = line->segments;
-          line->segments = seg;
-        }
-      else
+      /* Split long lines into several segments, so that editing them
+       * later doesn't need to copy the whole line. The paragraph
+       * delimiter always stays in the last segment.
+       */
+      for (piece = sol; ; piece += piece_len)
         {
-          seg->next = cur_seg->next;
-          cur_seg->next = seg;
+          if (delim - piece > GTK_TEXT_CHAR_SEGMENT_MAX_BYTES)
+            piece_len = g_utf8_find_prev_char (&text[piece],
+                                               &text[piece + GTK_TEXT_CHAR_SEGMENT_MAX_BYTES + 1])
+                        - &text[piece];
+          else
+            piece_len = eol - piece;
+
+          seg = _gtk_char_segment_new (&text[piece], piece_len);
+
+          char_count_delta += seg->char_count;
+
+          if (cur_seg == NULL)
+            {
+              seg->next = line->segments;
+              line->segments = seg;
+            }
+          else
+            {
+              seg->next = cur_seg->next;
+              cur_seg->next = seg;
+            }
+          cur_seg = seg;
+
+          if (piece + piece_len >= eol)
+            break;
         }
 
       if (delim == eol)
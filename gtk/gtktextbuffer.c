@@ -1180,6 +1180,71 @@ gtk_text_buffer_set_text (GtkTextBuffer *buffer,
   gtk_text_history_end_irreversible_action (buffer->priv->history);
 }
 
+/**
+ * gtk_text_buffer_set_text_with_tags:
+ * @buffer: a `GtkTextBuffer`
+ * @text: UTF-8 text to insert
+ * @len: length of @text in bytes, or -1
+ * @tags: (array length=n_tags): the tags to apply
+ * @starts: (array length=n_tags): character offsets into @text where
+ *   the corresponding tag in @tags starts
+ * @ends: (array length=n_tags): character offsets into @text where
+ *   the corresponding tag in @tags ends
+ * @n_tags: the number of tag ranges
+ *
+ * Replaces the contents of @buffer with @text and applies each tag
+ * in @tags to the range from the matching offset in @starts to the
+ * matching offset in @ends.
+ *
+ * This is meant for loading large, already highlighted documents.
+ * It is a lot faster than inserting the text piece by piece with
+ * [method@Gtk.TextBuffer.insert_with_tags], because the text is
+ * inserted in one go and the tags are applied directly, without
+ * emitting the [signal@Gtk.TextBuffer::apply-tag] signal.
+ * Like [method@Gtk.TextBuffer.set_text], this can not be undone.
+ *
+ * All tags must be in the tag table of @buffer.
+ *
+ * Since: 4.14
+ */
+void
+gtk_text_buffer_set_text_with_tags (GtkTextBuffer      *buffer,
+                                    const char         *text,
+                                    int                 len,
+                                    GtkTextTag * const *tags,
+                                    const int          *starts,
+                                    const int          *ends,
+                                    guint               n_tags)
+{
+  GtkTextIter start, end;
+  guint i;
+
+  g_return_if_fail (GTK_IS_TEXT_BUFFER (buffer));
+  g_return_if_fail (text != NULL);
+  g_return_if_fail (n_tags == 0 || (tags != NULL && starts != NULL && ends != NULL));
+
+  gtk_text_buffer_set_text (buffer, text, len);
+
+  for (i = 0; i < n_tags; i++)
+    {
+      g_return_if_fail (GTK_IS_TEXT_TAG (tags[i]));
+
+      if (tags[i]->priv->table != buffer->priv->tag_table)
+        {
+          g_warning ("Can only apply tags that are in the tag table for the buffer");
+          continue;
+        }
+
+      if (starts[i] == ends[i])
+        continue;
+
+      gtk_text_buffer_get_iter_at_offset (buffer, &start, starts[i]);
+      gtk_text_buffer_get_iter_at_offset (buffer, &end, ends[i]);
+
+      _gtk_text_btree_tag (&start, &end, tags[i], TRUE);
+    }
+}
+
 /*
  * Insertion
  */
@@ -156,6 +156,14 @@ GDK_AVAILABLE_IN_ALL
 void gtk_text_buffer_set_text          (GtkTextBuffer *buffer,
                                         const char    *text,
                                         int            len);
+GDK_AVAILABLE_IN_4_14
+void gtk_text_buffer_set_text_with_tags (GtkTextBuffer      *buffer,
+                                         const char         *text,
+                                         int                 len,
+                                         GtkTextTag * const *tags,
+                                         const int          *starts,
+                                         const int          *ends,
+                                         guint               n_tags);
 
 /* Insert into the buffer */
 GDK_AVAILABLE_IN_ALL
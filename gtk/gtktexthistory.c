@@ -38,6 +38,11 @@
  * changes tracked by the GtkTextHistory to be discarded.
  */
 
+/* When the number of undo levels is unlimited, the oldest actions are
+ * dropped once the text they hold adds up to more than this.
+ */
+#define MAX_UNLIMITED_UNDO_BYTES (64 * 1024 * 1024)
+
 typedef struct _Action     Action;
 typedef enum   _ActionKind ActionKind;
 
@@ -99,6 +104,9 @@ struct _GtkTextHistory
   guint               in_user;
   guint               max_undo_levels;
 
+  /* Bytes of text held by the actions in both queues */
+  gsize               n_bytes;
+
   guint               can_undo : 1;
   guint               can_redo : 1;
   guint               is_modified : 1;
@@ -308,6 +316,33 @@ action_free (Action *action)
   g_free (action);
 }
 
+static gsize
+action_get_n_bytes (const Action *action)
+{
+  gsize n_bytes = 0;
+
+  switch (action->kind)
+    {
+    case ACTION_KIND_INSERT:
+      return action->u.insert.istr.n_bytes;
+
+    case ACTION_KIND_DELETE_BACKSPACE:
+    case ACTION_KIND_DELETE_KEY:
+    case ACTION_KIND_DELETE_PROGRAMMATIC:
+    case ACTION_KIND_DELETE_SELECTION:
+      return action->u.delete.istr.n_bytes;
+
+    case ACTION_KIND_GROUP:
+      for (const GList *iter = action->u.group.actions.head; iter; iter = iter->next)
+        n_bytes += action_get_n_bytes (iter->data);
+      return n_bytes;
+
+    case ACTION_KIND_BARRIER:
+    default:
+      return 0;
+    }
+}
+
 static gboolean
 action_group_is_empty (const Action *action)
 {
@@ -331,6 +366,39 @@ action_group_is_empty (const Action *action)
   return TRUE;
 }
 
+static gboolean
+action_chain (Action   *action,
+              Action   *other,
+              gboolean  in_user_action);
+
+/* Deletes within a group are always undone together, so adjacent
+ * ones can be merged without changing what undo does. This keeps
+ * scripted edits that delete piece by piece from creating an action
+ * for every piece.
+ */
+static gboolean
+action_chain_delete (Action *action,
+                     Action *other)
+{
+  if (other->u.delete.end == action->u.delete.begin)
+    {
+      istring_prepend (&action->u.delete.istr, &other->u.delete.istr);
+      action->u.delete.begin = other->u.delete.begin;
+      action_free (other);
+      return TRUE;
+    }
+
+  if (other->u.delete.begin == action->u.delete.begin)
+    {
+      istring_append (&action->u.delete.istr, &other->u.delete.istr);
+      action->u.delete.end += other->u.delete.istr.n_chars;
+      action_free (other);
+      return TRUE;
+    }
+
+  return FALSE;
+}
+
 static gboolean
 action_chain (Action   *action,
               Action   *other,
@@ -371,6 +439,10 @@ action_chain (Action   *action,
         {
           if (action_chain (tail, other, in_user_action))
             return TRUE;
+
+          if (tail->kind == ACTION_KIND_DELETE_PROGRAMMATIC &&
+              action_chain_delete (tail, other))
+            return TRUE;
         }
 
       g_queue_push_tail_link (&action->u.group.actions, &other->link);
@@ -534,21 +606,40 @@ gtk_text_history_do_select (GtkTextHistory *self,
   self->funcs.select (self->funcs_data, selection_insert, selection_bound);
 }
 
+static void
+gtk_text_history_drop (GtkTextHistory *self,
+                       GQueue         *queue,
+                       Action         *action)
+{
+  g_assert (self->n_bytes >= action_get_n_bytes (action));
+
+  self->n_bytes -= action_get_n_bytes (action);
+  g_queue_unlink (queue, &action->link);
+  action_free (action);
+}
+
+static void
+gtk_text_history_clear (GtkTextHistory *self)
+{
+  clear_action_queue (&self->undo_queue);
+  clear_action_queue (&self->redo_queue);
+  self->n_bytes = 0;
+}
+
+static void
+gtk_text_history_clear_redo (GtkTextHistory *self)
+{
+  while (self->redo_queue.length > 0)
+    gtk_text_history_drop (self, &self->redo_queue, g_queue_peek_head (&self->redo_queue));
+}
+
 static void
 gtk_text_history_truncate_one (GtkTextHistory *self)
 {
   if (self->undo_queue.length > 0)
-    {
-      Action *action = g_queue_peek_head (&self->undo_queue);
-      g_queue_unlink (&self->undo_queue, &action->link);
-      action_free (action);
-    }
+    gtk_text_history_drop (self, &self->undo_queue, g_queue_peek_head (&self->undo_queue));
   else if (self->redo_queue.length > 0)
-    {
-      Action *action = g_queue_peek_tail (&self->redo_queue);
-      g_queue_unlink (&self->redo_queue, &action->link);
-      action_free (action);
-    }
+    gtk_text_history_drop (self, &self->redo_queue, g_queue_peek_tail (&self->redo_queue));
   else
     {
       g_assert_not_reached ();
@@ -561,7 +652,15 @@ gtk_text_history_truncate (GtkTextHistory *self)
   g_assert (GTK_IS_TEXT_HISTORY (self));
 
   if (self->max_undo_levels == 0)
-    return;
+    {
+      /* Keep the most recent action, it may be the group of
+       * the current user action.
+       */
+      while (self->n_bytes > MAX_UNLIMITED_UNDO_BYTES && self->undo_queue.length > 1)
+        gtk_text_history_truncate_one (self);
+
+      return;
+    }
 
   while (self->undo_queue.length + self->redo_queue.length > self->max_undo_levels)
     gtk_text_history_truncate_one (self);
@@ -572,8 +671,7 @@ gtk_text_history_finalize (GObject *object)
 {
   GtkTextHistory *self = (GtkTextHistory *)object;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear (self);
 
   G_OBJECT_CLASS (gtk_text_history_parent_class)->finalize (object);
 }
@@ -650,12 +748,9 @@ gtk_text_history_push (GtkTextHistory *self,
   g_assert (self->enabled);
   g_assert (action != NULL);
 
-  while (self->redo_queue.length > 0)
-    {
-      peek = g_queue_peek_head (&self->redo_queue);
-      g_queue_unlink (&self->redo_queue, &peek->link);
-      action_free (peek);
-    }
+  gtk_text_history_clear_redo (self);
+
+  self->n_bytes += action_get_n_bytes (action);
 
   peek = g_queue_peek_tail (&self->undo_queue);
   in_user_action = self->in_user > 0;
@@ -951,7 +1046,7 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
   return_if_applying (self);
   return_if_irreversible (self);
 
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear_redo (self);
 
   peek = g_queue_peek_tail (&self->undo_queue);
 
@@ -990,8 +1085,10 @@ gtk_text_history_end_user_action (GtkTextHistory *self)
       replaced->is_modified_set = peek->is_modified_set;
 
       g_queue_unlink (&peek->u.group.actions, link_);
-      g_queue_unlink (&self->undo_queue, &peek->link);
-      action_free (peek);
+      gtk_text_history_drop (self, &self->undo_queue, peek);
+
+      /* Pushing it accounts for its text again */
+      self->n_bytes -= action_get_n_bytes (replaced);
 
       gtk_text_history_push (self, replaced);
 
@@ -1023,8 +1120,7 @@ gtk_text_history_begin_irreversible_action (GtkTextHistory *self)
 
   self->irreversible++;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear (self);
 
   gtk_text_history_update_state (self);
 }
@@ -1045,8 +1141,7 @@ gtk_text_history_end_irreversible_action (GtkTextHistory *self)
 
   self->irreversible--;
 
-  clear_action_queue (&self->undo_queue);
-  clear_action_queue (&self->redo_queue);
+  gtk_text_history_clear (self);
 
   gtk_text_history_update_state (self);
 }
@@ -1222,8 +1317,7 @@ gtk_text_history_set_enabled (GtkTextHistory *self,
         {
           self->irreversible = 0;
           self->in_user = 0;
-          clear_action_queue (&self->undo_queue);
-          clear_action_queue (&self->redo_queue);
+          gtk_text_history_clear (self);
         }
 
       gtk_text_history_update_state (self);
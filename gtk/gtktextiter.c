@@ -4873,6 +4873,50 @@ lines_match (const GtkTextIter *start,
   return lines_match (&next, lines, visible_only, slice, case_insensitive, NULL, match_end);
 }
 
+/* Checks whether the text of @line may contain @needle, looking at the
+ * segments directly instead of copying the text. Only returns FALSE
+ * if the line certainly can't contain a match starting in it.
+ */
+static gboolean
+line_may_contain (GtkTextLine *line,
+                  const char  *needle)
+{
+  GtkTextLineSegment *seg;
+  GtkTextLineSegment *text_seg = NULL;
+  guint n_text_segs = 0;
+
+  for (seg = line->segments; seg != NULL; seg = seg->next)
+    {
+      if (seg->byte_count == 0)
+        continue;
+
+      /* Paintables and child anchors show up as U+FFFC in slices */
+      if (seg->type != &gtk_text_char_type)
+        return TRUE;
+
+      text_seg = seg;
+      n_text_segs++;
+    }
+
+  if (n_text_segs == 0)
+    return FALSE;
+
+  /* The common case of a line without tags, the whole
+   * match has to be in this segment */
+  if (n_text_segs == 1)
+    return g_strstr_len (text_seg->body.chars, text_seg->byte_count, needle) != NULL;
+
+  /* Otherwise, at least the first byte of a match must be there */
+  for (seg = line->segments; seg != NULL; seg = seg->next)
+    {
+      if (seg->type == &gtk_text_char_type &&
+          memchr (seg->body.chars, needle[0], seg->byte_count) != NULL)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 /* strsplit() that retains the delimiter as part of the string. */
 static char **
 strbreakup (const char *string,
@@ -5041,6 +5085,14 @@ gtk_text_iter_forward_search (const GtkTextIter *iter,
           gtk_text_iter_compare (&search, limit) >= 0)
         break;
 
+      /* Skip lines that can't match without copying their text.
+       * Casefolding can change the text, so this only works for
+       * case sensitive searches.
+       */
+      if (!case_insensitive &&
+          !line_may_contain (_gtk_text_iter_get_text_line (&search), lines[0]))
+        continue;
+
       if (lines_match (&search, (const char **)lines,
                        visible_only, slice, case_insensitive, &match, &end))
         {
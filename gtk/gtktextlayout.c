@@ -86,6 +86,7 @@
 #include "gtktextiterprivate.h"
 #include "gtktextlinedisplaycacheprivate.h"
 #include "gtktextutilprivate.h"
+#include "gtkpangoprivate.h"
 #include "gskpangoprivate.h"
 #include "gtksnapshotprivate.h"
 #include "gtkwidgetprivate.h"
@@ -109,8 +110,15 @@ struct _GtkTextLayoutPrivate
 
   /* Cache for GtkTextLineDisplay to reduce overhead creating layouts */
   GtkTextLineDisplayCache *cache;
+
+  /* Combined attributes for each set of tags seen, keyed by
+   * a GPtrArray of the tags in priority order */
+  GHashTable *style_cache;
 };
 
+/* Buffers with many tags typically use a few hundred combinations */
+#define MAX_STYLE_CACHE_SIZE 1024
+
 static void gtk_text_layout_invalidated     (GtkTextLayout     *layout);
 
 static void gtk_text_layout_invalidate_cache       (GtkTextLayout     *layout,
@@ -197,6 +205,8 @@ gtk_text_layout_dispose (GObject *object)
 
   gtk_text_layout_set_buffer (layout, NULL);
 
+  g_clear_pointer (&priv->style_cache, g_hash_table_unref);
+
   if (layout->default_style != NULL)
     {
       gtk_text_attributes_unref (layout->default_style);
@@ -291,6 +301,39 @@ gtk_text_layout_new (void)
   return g_object_new (GTK_TYPE_TEXT_LAYOUT, NULL);
 }
 
+static guint
+tags_hash (gconstpointer data)
+{
+  const GPtrArray *tags = data;
+  guint hash = tags->len;
+  guint i;
+
+  for (i = 0; i < tags->len; i++)
+    hash = (hash * 31) + g_direct_hash (g_ptr_array_index (tags, i));
+
+  return hash;
+}
+
+static gboolean
+tags_equal (gconstpointer a,
+            gconstpointer b)
+{
+  const GPtrArray *tags_a = a;
+  const GPtrArray *tags_b = b;
+
+  return tags_a->len == tags_b->len &&
+         memcmp (tags_a->pdata, tags_b->pdata, tags_a->len * sizeof (gpointer)) == 0;
+}
+
+static void
+clear_style_cache (GtkTextLayout *layout)
+{
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
+
+  if (priv->style_cache)
+    g_hash_table_remove_all (priv->style_cache);
+}
+
 static void
 free_style_cache (GtkTextLayout *text_layout)
 {
@@ -316,12 +359,17 @@ gtk_text_layout_set_buffer (GtkTextLayout *layout,
     return;
 
   free_style_cache (layout);
+  clear_style_cache (layout);
 
   if (layout->buffer)
     {
       _gtk_text_btree_remove_view (_gtk_text_buffer_get_btree (layout->buffer),
                                   layout);
 
+      g_signal_handlers_disconnect_by_func (gtk_text_buffer_get_tag_table (layout->buffer),
+                                            G_CALLBACK (clear_style_cache),
+                                            layout);
+
       g_signal_handlers_disconnect_by_func (layout->buffer,
                                             G_CALLBACK (gtk_text_layout_after_mark_set_handler),
                                             layout);
@@ -369,6 +417,13 @@ gtk_text_layout_set_buffer (GtkTextLayout *layout,
       g_signal_connect (layout->buffer, "delete-range",
                         G_CALLBACK (gtk_text_layout_before_buffer_delete_range), layout);
 
+      /* Cached styles are stale once a tag changes, and a removed
+       * tag's address may be reused for a new one */
+      g_signal_connect_swapped (gtk_text_buffer_get_tag_table (layout->buffer), "tag-changed",
+                                G_CALLBACK (clear_style_cache), layout);
+      g_signal_connect_swapped (gtk_text_buffer_get_tag_table (layout->buffer), "tag-removed",
+                                G_CALLBACK (clear_style_cache), layout);
+
       gtk_text_layout_update_cursor_line (layout);
     }
 }
@@ -719,6 +774,9 @@ gtk_text_layout_invalidate_all (GtkTextLayout *layout)
   if (layout->buffer == NULL)
     return;
 
+  /* This is also how changes to the default style are handled */
+  clear_style_cache (layout);
+
   gtk_text_buffer_get_bounds (layout->buffer, &start, &end);
 
   gtk_text_layout_invalidate (layout, &start, &end);
@@ -1093,6 +1151,7 @@ static GtkTextAttributes*
 get_style (GtkTextLayout *layout,
 	   GPtrArray     *tags)
 {
+  GtkTextLayoutPrivate *priv = GTK_TEXT_LAYOUT_GET_PRIVATE (layout);
   GtkTextAttributes *style;
 
   /* If we have the one-style cache, then it means
@@ -1119,21 +1178,44 @@ get_style (GtkTextLayout *layout,
       return layout->default_style;
     }
 
-  style = gtk_text_attributes_new ();
+  if (priv->style_cache == NULL)
+    priv->style_cache = g_hash_table_new_full (tags_hash, tags_equal,
+                                               (GDestroyNotify) g_ptr_array_unref,
+                                               (GDestroyNotify) gtk_text_attributes_unref);
 
-  gtk_text_attributes_copy_values (layout->default_style,
-                                   style);
+  style = g_hash_table_lookup (priv->style_cache, tags);
 
-  _gtk_text_attributes_fill_from_tags (style, tags);
+  if (style != NULL)
+    {
+      gtk_text_attributes_ref (style);
+    }
+  else
+    {
+      style = gtk_text_attributes_new ();
+
+      gtk_text_attributes_copy_values (layout->default_style,
+                                       style);
+
+      _gtk_text_attributes_fill_from_tags (style, tags);
+
+      g_assert (style->refcount == 1);
 
-  g_assert (style->refcount == 1);
+      if (g_hash_table_size (priv->style_cache) >= MAX_STYLE_CACHE_SIZE)
+        g_hash_table_remove_all (priv->style_cache);
+
+      /* The hash table keeps the initial ref */
+      g_hash_table_insert (priv->style_cache,
+                           g_ptr_array_copy (tags, NULL, NULL),
+                           style);
+      gtk_text_attributes_ref (style);
+    }
 
   /* Leave this style as the last one seen */
   g_assert (layout->one_style_cache == NULL);
-  gtk_text_attributes_ref (style); /* ref held by layout->one_style_cache */
-  layout->one_style_cache = style;
+  layout->one_style_cache = style; /* takes the ref we got above */
 
   /* Returning yet another refcount */
+  gtk_text_attributes_ref (style);
   return style;
 }
 
@@ -2622,6 +2704,9 @@ gtk_text_layout_create_display (GtkTextLayout *layout,
 
   display->has_children = saw_widget;
 
+  if (!size_only)
+    gtk_pango_layout_prefetch_glyphs (display->layout, layout->glyph_prefetch_scale);
+
   if (saw_widget)
     allocate_child_widgets (layout, display);
 
@@ -153,6 +153,10 @@ struct _GtkTextLayout
   PangoAttrList *preedit_attrs;
   int preedit_len;
   int preedit_cursor;
+
+  /* If > 0, the scale to render glyphs of new lines
+   * at in the background. */
+  float glyph_prefetch_scale;
 };
 
 struct _GtkTextLayoutClass
@@ -202,6 +206,9 @@ struct _GtkTextLineDisplay
   int bottom_margin;
   int insert_index;		/* Byte index of insert cursor within para or -1 */
 
+  /* Estimated memory use, accounted by the display cache */
+  gsize cache_size;
+
   GtkTextLine *line;
 
   GdkRectangle block_cursor;
@@ -28,6 +28,15 @@
 #define DEFAULT_MRU_SIZE         250
 #define BLOW_CACHE_TIMEOUT_SEC   20
 #define DEBUG_LINE_DISPLAY_CACHE 0
+/* Lines that are expensive enough to lay out that we always create
+ * and keep a full display, even when only the size is needed */
+#define LONG_LINE_BYTES          (16 * 1024)
+/* Upper bound for the estimated memory use of all cached displays,
+ * so that a few very wide wrapped lines can't use all of the MRU */
+#define MAX_CACHE_BYTES          (32 * 1024 * 1024)
+/* Rough estimate of what Pango keeps per byte of text: the text
+ * itself, glyph infos, log clusters and log attrs */
+#define BYTES_PER_TEXT_BYTE      32
 
 struct _GtkTextLineDisplayCache
 {
@@ -37,11 +46,13 @@ struct _GtkTextLineDisplayCache
   GQueue       mru;
   GSource     *evict_source;
   guint        mru_size;
+  gsize        n_bytes;
 
 #if DEBUG_LINE_DISPLAY_CACHE
   guint       log_source;
   int         hits;
   int         misses;
+  int         evict_by_size;
   int         inval;
   int         inval_cursors;
   int         inval_by_line;
@@ -50,6 +61,9 @@ struct _GtkTextLineDisplayCache
 #endif
 };
 
+/* All live caches, so they can be dropped under memory pressure */
+static GSList *all_caches;
+
 #if DEBUG_LINE_DISPLAY_CACHE
 # define STAT_ADD(val,n) ((val) += n)
 # define STAT_INC(val)   STAT_ADD(val,1)
@@ -57,11 +71,13 @@ static gboolean
 dump_stats (gpointer data)
 {
   GtkTextLineDisplayCache *cache = data;
-  g_printerr ("%p: size=%u hits=%d misses=%d inval_total=%d "
+  g_printerr ("%p: size=%u bytes=%" G_GSIZE_FORMAT " hits=%d misses=%d "
+              "evict_by_size=%d inval_total=%d "
               "inval_cursors=%d inval_by_line=%d "
               "inval_by_range=%d inval_by_y_range=%d\n",
               cache, g_hash_table_size (cache->line_to_display),
-              cache->hits, cache->misses,
+              cache->n_bytes, cache->hits, cache->misses,
+              cache->evict_by_size,
               cache->inval, cache->inval_cursors,
               cache->inval_by_line, cache->inval_by_range,
               cache->inval_by_y_range);
@@ -82,6 +98,8 @@ gtk_text_line_display_cache_new (void)
   ret->line_to_display = g_hash_table_new (NULL, NULL);
   ret->mru_size = DEFAULT_MRU_SIZE;
 
+  all_caches = g_slist_prepend (all_caches, ret);
+
 #if DEBUG_LINE_DISPLAY_CACHE
   ret->log_source = g_timeout_add_seconds (1, dump_stats, ret);
 #endif
@@ -96,6 +114,8 @@ gtk_text_line_display_cache_free (GtkTextLineDisplayCache *cache)
   g_clear_handle_id (&cache->log_source, g_source_remove);
 #endif
 
+  all_caches = g_slist_remove (all_caches, cache);
+
   gtk_text_line_display_cache_invalidate (cache);
 
   g_clear_pointer (&cache->evict_source, g_source_destroy);
@@ -176,6 +196,40 @@ check_disposition (GtkTextLineDisplayCache *cache,
 }
 #endif
 
+static gsize
+estimate_display_size (GtkTextLineDisplay *display)
+{
+  gsize size = sizeof (GtkTextLineDisplay);
+
+  if (display->layout != NULL)
+    size += (gsize) pango_layout_get_line_count (display->layout) * sizeof (PangoLayoutLine) +
+            strlen (pango_layout_get_text (display->layout)) * BYTES_PER_TEXT_BYTE;
+
+  return size;
+}
+
+static void
+gtk_text_line_display_cache_shrink (GtkTextLineDisplayCache *cache)
+{
+  GtkTextLineDisplay *display;
+
+  while (cache->mru.length > cache->mru_size)
+    {
+      display = g_queue_peek_tail (&cache->mru);
+
+      gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
+    }
+
+  /* Always keep the most recently used display, even if it is huge */
+  while (cache->n_bytes > MAX_CACHE_BYTES && cache->mru.length > 1)
+    {
+      display = g_queue_peek_tail (&cache->mru);
+
+      STAT_INC (cache->evict_by_size);
+      gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
+    }
+}
+
 static void
 gtk_text_line_display_cache_take_display (GtkTextLineDisplayCache *cache,
                                           GtkTextLineDisplay      *display,
@@ -202,13 +256,11 @@ gtk_text_line_display_cache_take_display (GtkTextLineDisplayCache *cache,
   g_hash_table_insert (cache->line_to_display, display->line, display);
   g_queue_push_head_link (&cache->mru, &display->mru_link);
 
-  /* Cull the cache if we're at capacity */
-  while (cache->mru.length > cache->mru_size)
-    {
-      display = g_queue_peek_tail (&cache->mru);
+  display->cache_size = estimate_display_size (display);
+  cache->n_bytes += display->cache_size;
 
-      gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
-    }
+  /* Cull the cache if we're at capacity */
+  gtk_text_line_display_cache_shrink (cache);
 }
 
 /*
@@ -249,6 +301,10 @@ gtk_text_line_display_cache_invalidate_display (GtkTextLineDisplayCache *cache,
       g_hash_table_remove (cache->line_to_display, display->line);
       g_queue_unlink (&cache->mru, &display->mru_link);
 
+      g_assert (cache->n_bytes >= display->cache_size);
+      cache->n_bytes -= display->cache_size;
+      display->cache_size = 0;
+
       if (iter != NULL)
         g_sequence_remove (iter);
     }
@@ -284,6 +340,13 @@ gtk_text_line_display_cache_get (GtkTextLineDisplayCache *cache,
   g_assert (layout != NULL);
   g_assert (line != NULL);
 
+  /* Sizing displays are not cached, so a long line would be shaped
+   * once for validation and once more for drawing. Shaping is what is
+   * expensive, so create the full display right away and keep it.
+   */
+  if (size_only && _gtk_text_line_byte_count (line) > LONG_LINE_BYTES)
+    size_only = FALSE;
+
   display = g_hash_table_lookup (cache->line_to_display, line);
 
   if (display != NULL)
@@ -358,6 +421,32 @@ gtk_text_line_display_cache_invalidate (GtkTextLineDisplayCache *cache)
   g_assert (g_hash_table_size (cache->line_to_display) == 0);
   g_assert (g_sequence_get_length (cache->sorted_by_line) == 0);
   g_assert (cache->mru.length == 0);
+  g_assert (cache->n_bytes == 0);
+}
+
+/*< private >
+ * gtk_text_line_display_cache_trim_all:
+ * @level: how urgently memory should be freed
+ *
+ * Drops the cached displays of all caches. Low warnings are
+ * ignored, the caches only hold the displays of recently shown
+ * lines and get dropped after a timeout anyway.
+ */
+void
+gtk_text_line_display_cache_trim_all (GMemoryMonitorWarningLevel level)
+{
+  GSList *l;
+
+  if (level < G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM)
+    return;
+
+  for (l = all_caches; l; l = l->next)
+    {
+      GtkTextLineDisplayCache *cache = l->data;
+
+      g_clear_pointer (&cache->evict_source, g_source_destroy);
+      gtk_text_line_display_cache_invalidate (cache);
+    }
 }
 
 void
@@ -743,8 +832,6 @@ void
 gtk_text_line_display_cache_set_mru_size (GtkTextLineDisplayCache *cache,
                                           guint                    mru_size)
 {
-  GtkTextLineDisplay *display;
-
   g_assert (cache != NULL);
 
   if (mru_size == 0)
@@ -753,12 +840,6 @@ gtk_text_line_display_cache_set_mru_size (GtkTextLineDisplayCache *cache,
   if (mru_size != cache->mru_size)
     {
       cache->mru_size = mru_size;
-
-      while (cache->mru.length > cache->mru_size)
-        {
-          display = g_queue_peek_tail (&cache->mru);
-
-          gtk_text_line_display_cache_invalidate_display (cache, display, FALSE);
-        }
+      gtk_text_line_display_cache_shrink (cache);
     }
 }
@@ -55,6 +55,7 @@ void                     gtk_text_line_display_cache_invalidate_y_range (GtkText
                                                                          gboolean                 cursors_only);
 void                     gtk_text_line_display_cache_set_mru_size       (GtkTextLineDisplayCache *cache,
                                                                          guint                    mru_size);
+void                     gtk_text_line_display_cache_trim_all           (GMemoryMonitorWarningLevel level);
 
 G_END_DECLS
 
@@ -149,6 +149,11 @@ struct _GtkTextLineSegment {
 };
 
 
+/* Character segments are not merged beyond this size, so that editing
+ * very long lines only needs to copy small segments.
+ */
+#define GTK_TEXT_CHAR_SEGMENT_MAX_BYTES 4096
+
 GtkTextLineSegment  *gtk_text_line_segment_split (const GtkTextIter *iter);
 
 GtkTextLineSegment *_gtk_char_segment_new                  (const char     *text,
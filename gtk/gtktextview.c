@@ -153,6 +153,9 @@
 
 #define SPACE_FOR_CURSOR 1
 
+/* Time per iteration spent on validating offscreen lines */
+#define GTK_TEXT_VIEW_VALIDATE_TIME (5 * G_TIME_SPAN_MILLISECOND)
+
 typedef struct _GtkTextWindow GtkTextWindow;
 typedef struct _GtkTextPendingScroll GtkTextPendingScroll;
 
@@ -4669,6 +4672,9 @@ gtk_text_view_size_allocate (GtkWidget *widget,
       gtk_widget_size_allocate (GTK_WIDGET (priv->bottom_child), &bottom_rect, -1);
     }
 
+  if (priv->layout)
+    priv->layout->glyph_prefetch_scale = gtk_pango_get_glyph_prefetch_scale (widget);
+
   gtk_text_view_update_layout_width (text_view);
 
   /* Note that this will do some layout validation */
@@ -4832,10 +4838,21 @@ incremental_validate_callback (gpointer data)
 {
   GtkTextView *text_view = data;
   gboolean result = TRUE;
+  gint64 end_time;
 
   DV(g_print(G_STRLOC"\n"));
 
-  gtk_text_layout_validate (text_view->priv->layout, 2000);
+  /* Validate in steps until the time is used up, so that huge buffers
+   * get validated in fewer main loop iterations while each iteration
+   * still stays short enough to not delay the next frame.
+   */
+  end_time = g_get_monotonic_time () + GTK_TEXT_VIEW_VALIDATE_TIME;
+  do
+    {
+      gtk_text_layout_validate (text_view->priv->layout, 2000);
+    }
+  while (!gtk_text_layout_is_valid (text_view->priv->layout) &&
+         g_get_monotonic_time () < end_time);
 
   gtk_text_view_update_adjustments (text_view);
 
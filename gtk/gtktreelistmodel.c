@@ -30,6 +30,11 @@
  * `GtkTreeListModel` is a list model that can create child models on demand.
  */
 
+/* Number of child models of collapsed rows that are kept around,
+ * so that expanding those rows again doesn't need to create them.
+ */
+#define MAX_RETAINED_MODELS 16
+
 enum {
   PROP_0,
   PROP_AUTOEXPAND,
@@ -45,10 +50,13 @@ typedef struct _TreeAugment TreeAugment;
 
 struct _TreeNode
 {
-  gpointer item;
+  gpointer item; /* NULL until it is needed */
   GListModel *model;
   GtkTreeListRow *row;
   GtkRbTree *children;
+  /* model kept while collapsed, and its link in the list's retained queue */
+  GListModel *retained_model;
+  GList *retained_link;
   union {
     TreeNode *parent;
     GtkTreeListModel *list;
@@ -69,6 +77,9 @@ struct _GtkTreeListModel
   GObject parent_instance;
 
   TreeNode root_node;
+  /* TreeNode, most recently used first. Nodes that were
+   * removed leave a link with NULL data behind. */
+  GQueue retained;
 
   GtkTreeListModelCreateModelFunc create_func;
   gpointer user_data;
@@ -217,6 +228,62 @@ tree_node_get_position (TreeNode *node)
   return n;
 }
 
+static guint
+tree_node_get_local_position (GtkRbTree *tree,
+                              TreeNode  *node)
+{
+  TreeNode *left, *parent;
+  TreeAugment *left_aug;
+  guint n;
+
+  left = gtk_rb_tree_node_get_left (node);
+  if (left)
+    {
+      left_aug = gtk_rb_tree_get_augment (tree, left);
+      n = left_aug->n_local;
+    }
+  else
+    n = 0;
+
+  for (parent = gtk_rb_tree_node_get_parent (node);
+       parent;
+       parent = gtk_rb_tree_node_get_parent (node))
+    {
+      left = gtk_rb_tree_node_get_left (parent);
+      if (left != node)
+        {
+          /* we are the right node */
+          n++;
+          if (left)
+            {
+              left_aug = gtk_rb_tree_get_augment (tree, left);
+              n += left_aug->n_local;
+            }
+        }
+      node = parent;
+    }
+
+  return n;
+}
+
+/* Items are only queried from the model when they are needed, so that
+ * expanding a row with lots of children doesn't query all of them.
+ */
+static gpointer
+tree_node_get_item (TreeNode *node)
+{
+  if (node->item == NULL)
+    {
+      TreeNode *parent = node->parent;
+
+      node->item = g_list_model_get_item (parent->model,
+                                          tree_node_get_local_position (parent->children, node));
+      g_assert (node->item);
+    }
+
+  return node->item;
+}
+
 static void
 tree_node_mark_dirty (TreeNode *node)
 {
@@ -283,7 +350,7 @@ tree_node_create_model (GtkTreeListModel *self,
 {
   GListModel *model;
 
-  model = self->create_func (node->item, self->user_data);
+  model = self->create_func (tree_node_get_item (node), self->user_data);
   if (model == NULL)
     node->empty = TRUE;
 
@@ -301,7 +368,7 @@ tree_node_get_row (TreeNode *node)
     {
       node->row = g_object_new (GTK_TYPE_TREE_LIST_ROW, NULL);
       node->row->node = node;
-      node->row->item = g_object_ref (node->item);
+      node->row->item = g_object_ref (tree_node_get_item (node));
 
       return node->row;
     }
@@ -371,8 +438,6 @@ gtk_tree_list_model_items_changed_cb (GListModel *model,
     {
       child = gtk_rb_tree_insert_before (node->children, child);
       child->parent = node;
-      child->item = g_list_model_get_item (model, position + i);
-      g_assert (child->item);
     }
   if (self->autoexpand)
     {
@@ -409,6 +474,42 @@ gtk_tree_list_model_clear_node_children (TreeNode *node)
   g_clear_pointer (&node->children, gtk_rb_tree_unref);
 }
 
+static void
+gtk_tree_list_model_retain_model (GtkTreeListModel *self,
+                                  TreeNode         *node,
+                                  GListModel       *model)
+{
+  g_assert (node->retained_model == NULL);
+
+  node->retained_model = model;
+  g_queue_push_head (&self->retained, node);
+  node->retained_link = self->retained.head;
+
+  while (self->retained.length > MAX_RETAINED_MODELS)
+    {
+      TreeNode *oldest = g_queue_pop_tail (&self->retained);
+
+      if (oldest == NULL)
+        continue;
+
+      oldest->retained_link = NULL;
+      g_clear_object (&oldest->retained_model);
+    }
+}
+
+static GListModel *
+gtk_tree_list_model_steal_retained_model (GtkTreeListModel *self,
+                                          TreeNode         *node)
+{
+  if (node->retained_model == NULL)
+    return NULL;
+
+  g_queue_delete_link (&self->retained, node->retained_link);
+  node->retained_link = NULL;
+
+  return g_steal_pointer (&node->retained_model);
+}
+
 static void
 gtk_tree_list_model_clear_node (gpointer data)
 {
@@ -422,6 +523,14 @@ gtk_tree_list_model_clear_node (gpointer data)
 
   gtk_tree_list_model_clear_node_children (node);
 
+  if (node->retained_link)
+    {
+      /* The list may be gone already, so leave the link for it to clean up */
+      node->retained_link->data = NULL;
+      node->retained_link = NULL;
+    }
+  g_clear_object (&node->retained_model);
+
   if (node->row)
     g_object_thaw_notify (G_OBJECT (node->row));
 
@@ -480,8 +589,6 @@ gtk_tree_list_model_init_node (GtkTreeListModel *list,
     {
       node = gtk_rb_tree_insert_after (self->children, node);
       node->parent = self;
-      node->item = g_list_model_get_item (model, i);
-      g_assert (node ->item);
       if (list->autoexpand)
         gtk_tree_list_model_expand_node (list, node);
     }
@@ -499,7 +606,9 @@ gtk_tree_list_model_expand_node (GtkTreeListModel *self,
   if (node->model != NULL)
     return 0;
 
-  model = tree_node_create_model (self, node);
+  model = gtk_tree_list_model_steal_retained_model (self, node);
+  if (model == NULL)
+    model = tree_node_create_model (self, node);
 
   if (model == NULL)
     return 0;
@@ -514,7 +623,8 @@ gtk_tree_list_model_expand_node (GtkTreeListModel *self,
 static guint
 gtk_tree_list_model_collapse_node (GtkTreeListModel *self,
                                    TreeNode         *node)
-{      
+{
+  GListModel *model;
   guint n_items;
 
   if (node->model == NULL)
@@ -522,7 +632,9 @@ gtk_tree_list_model_collapse_node (GtkTreeListModel *self,
 
   n_items = tree_node_get_n_children (node);
 
+  model = g_object_ref (node->model);
   gtk_tree_list_model_clear_node_children (node);
+  gtk_tree_list_model_retain_model (self, node, model);
 
   tree_node_mark_dirty (node);
 
@@ -562,7 +674,7 @@ gtk_tree_list_model_get_item (GListModel *list,
 
   if (self->passthrough)
     {
-      return g_object_ref (node->item);
+      return g_object_ref (tree_node_get_item (node));
     }
   else
     {
@@ -647,6 +759,7 @@ gtk_tree_list_model_finalize (GObject *object)
   GtkTreeListModel *self = GTK_TREE_LIST_MODEL (object);
 
   gtk_tree_list_model_clear_node (&self->root_node);
+  g_queue_clear (&self->retained);
   if (self->user_destroy)
     self->user_destroy (self->user_data);
 
@@ -1265,17 +1378,18 @@ gtk_tree_list_row_is_expandable (GtkTreeListRow *self)
   if (self->node->empty)
     return FALSE;
 
-  if (self->node->model)
+  if (self->node->model || self->node->retained_model)
     return TRUE;
 
   list = tree_node_get_tree_list_model (self->node);
   if (list == NULL)
     return FALSE;
 
+  /* Keep the model, rows are usually expanded right after this check */
   model = tree_node_create_model (list, self->node);
   if (model)
     {
-      g_object_unref (model);
+      gtk_tree_list_model_retain_model (list, self->node, model);
       return TRUE;
     }
 
@@ -0,0 +1,184 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtktrimprivate.h"
+
+#include "gtkcssproviderprivate.h"
+#include "gtkiconthemeprivate.h"
+#include "gtknative.h"
+#include "gtkprivate.h"
+#include "gtktextlinedisplaycacheprivate.h"
+#include "gtkwindow.h"
+
+#include "gdk/gdkprofilerprivate.h"
+#include "gsk/gskrendererprivate.h"
+
+/* GTK keeps a lot of caches around that can be recreated when
+ * needed: recently used icons, parsed themes, text layouts and
+ * the textures and atlases of the renderers.
+ *
+ * They are trimmed when the system warns about low memory, and
+ * when the application has had no mapped windows for a while,
+ * since it is probably in the background then. The higher the
+ * warning level, the more of the caches are dropped.
+ */
+
+/* How long to wait after the last window was unmapped before
+ * trimming, so that hiding and showing a window again is cheap
+ */
+#define UNMAPPED_TRIM_TIMEOUT_SEC 5
+
+static GMemoryMonitor *memory_monitor;
+static guint unmapped_trim_id;
+
+static void
+trim_renderers (void)
+{
+  GList *toplevels, *l;
+
+  toplevels = gtk_window_list_toplevels ();
+
+  for (l = toplevels; l; l = l->next)
+    {
+      GskRenderer *renderer = gtk_native_get_renderer (GTK_NATIVE (l->data));
+
+      if (renderer)
+        gsk_renderer_trim (renderer);
+    }
+
+  g_list_free (toplevels);
+}
+
+static void
+trim_icon_themes (GMemoryMonitorWarningLevel level)
+{
+  GSList *displays, *l;
+
+  displays = gdk_display_manager_list_displays (gdk_display_manager_get ());
+
+  for (l = displays; l; l = l->next)
+    {
+      /* Don't use gtk_icon_theme_get_for_display(), that would
+       * create the icon theme if there is none
+       */
+      GtkIconTheme *theme = g_object_get_data (l->data, "gtk-icon-theme");
+
+      if (theme)
+        gtk_icon_theme_trim (theme, level);
+    }
+
+  g_slist_free (displays);
+}
+
+/*< private >
+ * gtk_trim_caches:
+ * @level: how urgently memory should be freed
+ *
+ * Releases memory held by caches. Parsed themes that are not in
+ * use and some of the recently used icons are always dropped. From
+ * %G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM on, text layouts and the
+ * caches of the renderers are dropped too, and at
+ * %G_MEMORY_MONITOR_WARNING_LEVEL_CRITICAL, all cached icons are.
+ */
+void
+gtk_trim_caches (GMemoryMonitorWarningLevel level)
+{
+  gint64 before G_GNUC_UNUSED;
+
+  before = GDK_PROFILER_CURRENT_TIME;
+
+  gtk_css_provider_trim_theme_cache ();
+  trim_icon_themes (level);
+  gtk_text_line_display_cache_trim_all (level);
+
+  if (level >= G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM)
+    trim_renderers ();
+
+  gdk_profiler_end_mark (before, "Trim caches", NULL);
+}
+
+static void
+low_memory_warning (GMemoryMonitor             *monitor,
+                    GMemoryMonitorWarningLevel  level)
+{
+  gtk_trim_caches (level);
+}
+
+static gboolean
+has_mapped_windows (void)
+{
+  GList *toplevels, *l;
+  gboolean result = FALSE;
+
+  toplevels = gtk_window_list_toplevels ();
+
+  for (l = toplevels; l; l = l->next)
+    {
+      if (gtk_widget_get_mapped (l->data))
+        {
+          result = TRUE;
+          break;
+        }
+    }
+
+  g_list_free (toplevels);
+
+  return result;
+}
+
+static gboolean
+unmapped_trim_cb (gpointer data)
+{
+  unmapped_trim_id = 0;
+
+  if (!has_mapped_windows ())
+    gtk_trim_caches (G_MEMORY_MONITOR_WARNING_LEVEL_MEDIUM);
+
+  return G_SOURCE_REMOVE;
+}
+
+/*< private >
+ * gtk_trim_window_unmapped:
+ *
+ * Called when a window is unmapped. If no window is mapped
+ * anymore after a few seconds, the caches are trimmed.
+ */
+void
+gtk_trim_window_unmapped (void)
+{
+  if (unmapped_trim_id != 0)
+    g_source_remove (unmapped_trim_id);
+
+  unmapped_trim_id = g_timeout_add_seconds (UNMAPPED_TRIM_TIMEOUT_SEC, unmapped_trim_cb, NULL);
+  gdk_source_set_static_name_by_id (unmapped_trim_id, "[gtk] unmapped_trim_cb");
+}
+
+/*< private >
+ * gtk_trim_init:
+ *
+ * Starts listening for low memory warnings. This is called
+ * from gtk_init().
+ */
+void
+gtk_trim_init (void)
+{
+  memory_monitor = g_memory_monitor_dup_default ();
+  g_signal_connect (memory_monitor, "low-memory-warning",
+                    G_CALLBACK (low_memory_warning), NULL);
+}
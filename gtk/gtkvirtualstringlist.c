@@ -0,0 +1,467 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include "gtkvirtualstringlist.h"
+
+#include "gtkstringlist.h"
+#include "gtkprivate.h"
+
+#include <string.h>
+
+/**
+ * GtkVirtualStringList:
+ *
+ * `GtkVirtualStringList` is a list model for very large numbers of
+ * strings that are not kept in memory.
+ *
+ * The strings are either the lines of a memory-mapped file, see
+ * [ctor@Gtk.VirtualStringList.new_for_mapped_file], or provided by
+ * a callback, see [ctor@Gtk.VirtualStringList.new].
+ *
+ * The items of the model are [class@Gtk.StringObject]s. They are only
+ * created when they are requested, which a list view only does for the
+ * rows it shows. A small number of recently requested items is kept, so
+ * that asking again for the same position returns the same object.
+ * All other memory use is independent of the number of items.
+ *
+ * Since: 4.14
+ */
+
+/* Number of items kept around, this should be more than the number of
+ * rows a list view shows at once.
+ */
+#define CACHE_SIZE 256
+
+/* One line offset is kept per this many lines of a mapped file */
+#define LINE_INDEX_STRIDE 256
+
+enum {
+  PROP_0,
+  PROP_ITEM_TYPE,
+  PROP_N_ITEMS,
+  NUM_PROPERTIES
+};
+
+typedef struct
+{
+  guint position;
+  GtkStringObject *item; /* NULL if unused */
+} CacheSlot;
+
+struct _GtkVirtualStringList
+{
+  GObject parent_instance;
+
+  guint n_items;
+
+  GtkVirtualStringListFunc func;
+  gpointer user_data;
+  GDestroyNotify user_destroy;
+
+  GMappedFile *file;
+  gsize *line_index; /* offset of every LINE_INDEX_STRIDE'th line */
+
+  CacheSlot cache[CACHE_SIZE];
+};
+
+struct _GtkVirtualStringListClass
+{
+  GObjectClass parent_class;
+};
+
+static GParamSpec *properties[NUM_PROPERTIES] = { NULL, };
+
+static GType
+gtk_virtual_string_list_get_item_type (GListModel *list)
+{
+  return GTK_TYPE_STRING_OBJECT;
+}
+
+static guint
+gtk_virtual_string_list_get_n_items (GListModel *list)
+{
+  GtkVirtualStringList *self = GTK_VIRTUAL_STRING_LIST (list);
+
+  return self->n_items;
+}
+
+static gpointer
+gtk_virtual_string_list_get_item (GListModel *list,
+                                  guint       position)
+{
+  GtkVirtualStringList *self = GTK_VIRTUAL_STRING_LIST (list);
+  CacheSlot *slot;
+  char *string;
+
+  if (position >= self->n_items)
+    return NULL;
+
+  slot = &self->cache[position % CACHE_SIZE];
+  if (slot->item == NULL || slot->position != position)
+    {
+      g_clear_object (&slot->item);
+
+      string = gtk_virtual_string_list_get_string (self, position);
+      slot->item = gtk_string_object_new (string);
+      slot->position = position;
+      g_free (string);
+    }
+
+  return g_object_ref (slot->item);
+}
+
+static void
+gtk_virtual_string_list_model_init (GListModelInterface *iface)
+{
+  iface->get_item_type = gtk_virtual_string_list_get_item_type;
+  iface->get_n_items = gtk_virtual_string_list_get_n_items;
+  iface->get_item = gtk_virtual_string_list_get_item;
+}
+
+G_DEFINE_TYPE_WITH_CODE (GtkVirtualStringList, gtk_virtual_string_list, G_TYPE_OBJECT,
+                         G_IMPLEMENT_INTERFACE (G_TYPE_LIST_MODEL, gtk_virtual_string_list_model_init))
+
+static void
+gtk_virtual_string_list_get_property (GObject    *object,
+                                      guint       prop_id,
+                                      GValue     *value,
+                                      GParamSpec *pspec)
+{
+  GtkVirtualStringList *self = GTK_VIRTUAL_STRING_LIST (object);
+
+  switch (prop_id)
+    {
+    case PROP_ITEM_TYPE:
+      g_value_set_gtype (value, GTK_TYPE_STRING_OBJECT);
+      break;
+
+    case PROP_N_ITEMS:
+      g_value_set_uint (value, self->n_items);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
+      break;
+    }
+}
+
+static void
+gtk_virtual_string_list_clear_cache (GtkVirtualStringList *self,
+                                     guint                 position,
+                                     guint                 n_items)
+{
+  guint i;
+
+  for (i = 0; i < CACHE_SIZE; i++)
+    {
+      CacheSlot *slot = &self->cache[i];
+
+      if (slot->item != NULL &&
+          slot->position >= position &&
+          slot->position - position < n_items)
+        g_clear_object (&slot->item);
+    }
+}
+
+static void
+gtk_virtual_string_list_dispose (GObject *object)
+{
+  GtkVirtualStringList *self = GTK_VIRTUAL_STRING_LIST (object);
+
+  gtk_virtual_string_list_clear_cache (self, 0, G_MAXUINT);
+
+  if (self->user_destroy)
+    self->user_destroy (self->user_data);
+  self->func = NULL;
+  self->user_data = NULL;
+  self->user_destroy = NULL;
+
+  g_clear_pointer (&self->file, g_mapped_file_unref);
+  g_clear_pointer (&self->line_index, g_free);
+
+  G_OBJECT_CLASS (gtk_virtual_string_list_parent_class)->dispose (object);
+}
+
+static void
+gtk_virtual_string_list_class_init (GtkVirtualStringListClass *class)
+{
+  GObjectClass *gobject_class = G_OBJECT_CLASS (class);
+
+  gobject_class->get_property = gtk_virtual_string_list_get_property;
+  gobject_class->dispose = gtk_virtual_string_list_dispose;
+
+  /**
+   * GtkVirtualStringList:item-type:
+   *
+   * The type of items. See [method@Gio.ListModel.get_item_type].
+   *
+   * Since: 4.14
+   **/
+  properties[PROP_ITEM_TYPE] =
+    g_param_spec_gtype ("item-type", NULL, NULL,
+                        GTK_TYPE_STRING_OBJECT,
+                        G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  /**
+   * GtkVirtualStringList:n-items:
+   *
+   * The number of items. See [method@Gio.ListModel.get_n_items].
+   *
+   * Since: 4.14
+   **/
+  properties[PROP_N_ITEMS] =
+    g_param_spec_uint ("n-items", NULL, NULL,
+                       0, G_MAXUINT, 0,
+                       G_PARAM_READABLE | G_PARAM_STATIC_STRINGS);
+
+  g_object_class_install_properties (gobject_class, NUM_PROPERTIES, properties);
+}
+
+static void
+gtk_virtual_string_list_init (GtkVirtualStringList *self)
+{
+}
+
+/**
+ * gtk_virtual_string_list_new:
+ * @n_items: the number of strings
+ * @func: (scope notified) (closure user_data) (destroy user_destroy): function
+ *   returning the string for a position
+ * @user_data: user data passed to @func
+ * @user_destroy: destroy notify for @user_data
+ *
+ * Creates a new `GtkVirtualStringList` with @n_items strings
+ * that are returned by @func when they are needed.
+ *
+ * If the strings change, call [method@Gtk.VirtualStringList.items_changed]
+ * or [method@Gtk.VirtualStringList.set_n_items].
+ *
+ * Returns: a new `GtkVirtualStringList`
+ *
+ * Since: 4.14
+ */
+GtkVirtualStringList *
+gtk_virtual_string_list_new (guint                    n_items,
+                             GtkVirtualStringListFunc func,
+                             gpointer                 user_data,
+                             GDestroyNotify           user_destroy)
+{
+  GtkVirtualStringList *self;
+
+  g_return_val_if_fail (func != NULL, NULL);
+
+  self = g_object_new (GTK_TYPE_VIRTUAL_STRING_LIST, NULL);
+
+  self->n_items = n_items;
+  self->func = func;
+  self->user_data = user_data;
+  self->user_destroy = user_destroy;
+
+  return self;
+}
+
+/**
+ * gtk_virtual_string_list_new_for_mapped_file:
+ * @file: a `GMappedFile`
+ *
+ * Creates a new `GtkVirtualStringList` containing the lines of @file.
+ *
+ * Lines can be terminated by "\n" or "\r\n". Invalid UTF-8 in the
+ * lines is replaced.
+ *
+ * Creating the list scans the file once to count the lines, but only
+ * a small index of the line positions is kept.
+ *
+ * Returns: a new `GtkVirtualStringList`
+ *
+ * Since: 4.14
+ */
+GtkVirtualStringList *
+gtk_virtual_string_list_new_for_mapped_file (GMappedFile *file)
+{
+  GtkVirtualStringList *self;
+  const char *contents, *end, *line;
+  gsize n_index;
+
+  g_return_val_if_fail (file != NULL, NULL);
+
+  self = g_object_new (GTK_TYPE_VIRTUAL_STRING_LIST, NULL);
+
+  self->file = g_mapped_file_ref (file);
+
+  contents = g_mapped_file_get_contents (file);
+  end = contents + g_mapped_file_get_length (file);
+
+  n_index = 16;
+  self->line_index = g_new (gsize, n_index);
+
+  for (line = contents; line < end; )
+    {
+      const char *next;
+
+      if (self->n_items % LINE_INDEX_STRIDE == 0)
+        {
+          if (self->n_items / LINE_INDEX_STRIDE == n_index)
+            {
+              n_index *= 2;
+              self->line_index = g_renew (gsize, self->line_index, n_index);
+            }
+          self->line_index[self->n_items / LINE_INDEX_STRIDE] = line - contents;
+        }
+
+      if (self->n_items == G_MAXUINT)
+        {
+          g_warning ("File has too many lines, ignoring the rest");
+          break;
+        }
+      self->n_items++;
+
+      next = memchr (line, '\n', end - line);
+      line = next ? next + 1 : end;
+    }
+
+  return self;
+}
+
+static char *
+gtk_virtual_string_list_get_line (GtkVirtualStringList *self,
+                                  guint                 position)
+{
+  const char *contents, *end, *line, *line_end;
+  guint i;
+
+  contents = g_mapped_file_get_contents (self->file);
+  end = contents + g_mapped_file_get_length (self->file);
+
+  line = contents + self->line_index[position / LINE_INDEX_STRIDE];
+  for (i = 0; i < position % LINE_INDEX_STRIDE; i++)
+    line = (const char *) memchr (line, '\n', end - line) + 1;
+
+  line_end = memchr (line, '\n', end - line);
+  if (line_end == NULL)
+    line_end = end;
+  if (line_end > line && line_end[-1] == '\r')
+    line_end--;
+
+  return g_utf8_make_valid (line, line_end - line);
+}
+
+/**
+ * gtk_virtual_string_list_get_string:
+ * @self: a `GtkVirtualStringList`
+ * @position: the position to get the string for
+ *
+ * Gets the string that is at @position in @self.
+ *
+ * This function returns %NULL if @position is greater
+ * than the length of @self.
+ *
+ * Returns: (nullable) (transfer full): the string at the given position
+ *
+ * Since: 4.14
+ */
+char *
+gtk_virtual_string_list_get_string (GtkVirtualStringList *self,
+                                    guint                 position)
+{
+  g_return_val_if_fail (GTK_IS_VIRTUAL_STRING_LIST (self), NULL);
+
+  if (position >= self->n_items)
+    return NULL;
+
+  if (self->file)
+    return gtk_virtual_string_list_get_line (self, position);
+  else
+    return self->func (position, self->user_data);
+}
+
+/**
+ * gtk_virtual_string_list_set_n_items:
+ * @self: a `GtkVirtualStringList`
+ * @n_items: the new number of strings
+ *
+ * Changes the number of strings in @self. Strings are added
+ * or removed at the end.
+ *
+ * This can only be used with lists created with
+ * [ctor@Gtk.VirtualStringList.new].
+ *
+ * Since: 4.14
+ */
+void
+gtk_virtual_string_list_set_n_items (GtkVirtualStringList *self,
+                                     guint                 n_items)
+{
+  guint old_n_items;
+
+  g_return_if_fail (GTK_IS_VIRTUAL_STRING_LIST (self));
+  g_return_if_fail (self->file == NULL);
+
+  if (self->n_items == n_items)
+    return;
+
+  old_n_items = self->n_items;
+  self->n_items = n_items;
+
+  if (n_items > old_n_items)
+    {
+      g_list_model_items_changed (G_LIST_MODEL (self), old_n_items, 0, n_items - old_n_items);
+    }
+  else
+    {
+      gtk_virtual_string_list_clear_cache (self, n_items, G_MAXUINT);
+      g_list_model_items_changed (G_LIST_MODEL (self), n_items, old_n_items - n_items, 0);
+    }
+
+  g_object_notify_by_pspec (G_OBJECT (self), properties[PROP_N_ITEMS]);
+}
+
+/**
+ * gtk_virtual_string_list_items_changed:
+ * @self: a `GtkVirtualStringList`
+ * @position: the first changed string
+ * @n_items: the number of changed strings
+ *
+ * Tells @self that the strings returned for the given range
+ * have changed.
+ *
+ * New items will be created for this range and
+ * [signal@Gio.ListModel::items-changed] is emitted.
+ *
+ * This can only be used with lists created with
+ * [ctor@Gtk.VirtualStringList.new].
+ *
+ * Since: 4.14
+ */
+void
+gtk_virtual_string_list_items_changed (GtkVirtualStringList *self,
+                                       guint                 position,
+                                       guint                 n_items)
+{
+  g_return_if_fail (GTK_IS_VIRTUAL_STRING_LIST (self));
+  g_return_if_fail (self->file == NULL);
+  g_return_if_fail (position <= self->n_items);
+  g_return_if_fail (n_items <= self->n_items - position);
+
+  if (n_items == 0)
+    return;
+
+  gtk_virtual_string_list_clear_cache (self, position, n_items);
+  g_list_model_items_changed (G_LIST_MODEL (self), position, n_items, n_items);
+}
@@ -0,0 +1,72 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+
+#if !defined (__GTK_H_INSIDE__) && !defined (GTK_COMPILATION)
+#error "Only <gtk/gtk.h> can be included directly."
+#endif
+
+#include <gio/gio.h>
+/* for GDK_AVAILABLE_IN_ALL */
+#include <gdk/gdk.h>
+
+
+G_BEGIN_DECLS
+
+/**
+ * GtkVirtualStringListFunc:
+ * @position: the position of the string
+ * @user_data: user data
+ *
+ * Returns the string at @position for a `GtkVirtualStringList`.
+ *
+ * Returns: (transfer full): the string at @position
+ *
+ * Since: 4.14
+ */
+typedef char * (* GtkVirtualStringListFunc) (guint    position,
+                                             gpointer user_data);
+
+#define GTK_TYPE_VIRTUAL_STRING_LIST (gtk_virtual_string_list_get_type ())
+
+GDK_AVAILABLE_IN_4_14
+G_DECLARE_FINAL_TYPE (GtkVirtualStringList, gtk_virtual_string_list, GTK, VIRTUAL_STRING_LIST, GObject)
+
+GDK_AVAILABLE_IN_4_14
+GtkVirtualStringList *  gtk_virtual_string_list_new                     (guint                           n_items,
+                                                                         GtkVirtualStringListFunc        func,
+                                                                         gpointer                        user_data,
+                                                                         GDestroyNotify                  user_destroy);
+GDK_AVAILABLE_IN_4_14
+GtkVirtualStringList *  gtk_virtual_string_list_new_for_mapped_file     (GMappedFile                    *file);
+
+GDK_AVAILABLE_IN_4_14
+void                    gtk_virtual_string_list_set_n_items             (GtkVirtualStringList           *self,
+                                                                         guint                           n_items);
+GDK_AVAILABLE_IN_4_14
+void                    gtk_virtual_string_list_items_changed           (GtkVirtualStringList           *self,
+                                                                         guint                           position,
+                                                                         guint                           n_items);
+
+GDK_AVAILABLE_IN_4_14
+char *                  gtk_virtual_string_list_get_string              (GtkVirtualStringList           *self,
+                                                                         guint                           position);
+
+G_END_DECLS
+
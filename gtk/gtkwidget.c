@@ -61,6 +61,7 @@
 #include "gtkshortcuttrigger.h"
 #include "gtksizegroup-private.h"
 #include "gtksnapshotprivate.h"
+#include "gtkstartupprivate.h"
 #include "deprecated/gtkstylecontextprivate.h"
 #include "gtktooltipprivate.h"
 #include "gsktransformprivate.h"
@@ -76,6 +77,7 @@
 #include "gdk/gdkprofilerprivate.h"
 #include "gsk/gskdebugprivate.h"
 #include "gsk/gskrendererprivate.h"
+#include "gsk/gskrendernodearenaprivate.h"
 
 #include <cairo-gobject.h>
 #include <locale.h>
@@ -541,6 +543,7 @@ enum {
   PROP_CSS_NAME,
   PROP_CSS_CLASSES,
   PROP_LAYOUT_MANAGER,
+  PROP_FIXED_SIZE,
   NUM_PROPERTIES,
 
   /* GtkAccessible */
@@ -596,6 +599,7 @@ static void             gtk_widget_pop_verify_invariants        (GtkWidget
 #endif
 static PangoContext*    gtk_widget_peek_pango_context           (GtkWidget          *widget);
 static void             gtk_widget_update_default_pango_context (GtkWidget          *widget);
+static void             gtk_widget_update_opacity               (GtkWidget          *widget);
 static void             gtk_widget_propagate_state              (GtkWidget          *widget,
                                                                  const GtkStateData *data);
 static gboolean         gtk_widget_real_mnemonic_activate       (GtkWidget          *widget,
@@ -1026,6 +1030,9 @@ gtk_widget_set_property (GObject      *object,
     case PROP_LAYOUT_MANAGER:
       gtk_widget_set_layout_manager (widget, g_value_dup_object (value));
       break;
+    case PROP_FIXED_SIZE:
+      gtk_widget_set_fixed_size (widget, g_value_get_boolean (value));
+      break;
     case PROP_ACCESSIBLE_ROLE:
       gtk_widget_set_accessible_role (widget, g_value_get_enum (value));
       break;
@@ -1159,6 +1166,9 @@ gtk_widget_get_property (GObject    *object,
     case PROP_LAYOUT_MANAGER:
       g_value_set_object (value, gtk_widget_get_layout_manager (widget));
       break;
+    case PROP_FIXED_SIZE:
+      g_value_set_boolean (value, gtk_widget_get_fixed_size (widget));
+      break;
     case PROP_ACCESSIBLE_ROLE:
       g_value_set_enum (value, gtk_widget_get_accessible_role (widget));
       break;
@@ -1636,6 +1646,20 @@ gtk_widget_class_init (GtkWidgetClass *klass)
                          GTK_TYPE_LAYOUT_MANAGER,
                          GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
 
+  /**
+   * GtkWidget:fixed-size: (attributes org.gtk.Property.get=gtk_widget_get_fixed_size org.gtk.Property.set=gtk_widget_set_fixed_size)
+   *
+   * Whether the size of the widget does not depend on its children.
+   *
+   * See [method@Gtk.Widget.set_fixed_size].
+   *
+   * Since: 4.14
+   */
+  widget_props[PROP_FIXED_SIZE] =
+    g_param_spec_boolean ("fixed-size", NULL, NULL,
+                          FALSE,
+                          GTK_PARAM_READWRITE | G_PARAM_EXPLICIT_NOTIFY);
+
   g_object_class_install_properties (gobject_class, NUM_PROPERTIES, widget_props);
 
   g_object_class_override_property (gobject_class, PROP_ACCESSIBLE_ROLE, "accessible-role");
@@ -2624,8 +2648,8 @@ gtk_widget_unparent (GtkWidget *widget)
 
   _gtk_widget_update_parent_muxer (widget);
 
-  if (old_parent->priv->children_observer)
-    gtk_list_list_model_item_removed (old_parent->priv->children_observer, old_prev_sibling);
+  if (old_parent->priv->rare_data && old_parent->priv->rare_data->children_observer)
+    gtk_list_list_model_item_removed (old_parent->priv->rare_data->children_observer, old_prev_sibling);
 
   if (old_parent->priv->layout_manager)
     gtk_layout_manager_remove_layout_child (old_parent->priv->layout_manager, widget);
@@ -3272,6 +3296,17 @@ add_parent_surface_transform_changed_listener (GtkWidget *widget)
   surface_transform_data->tracked_parent = g_object_ref (parent);
 }
 
+static GtkWidgetRareData *
+gtk_widget_ensure_rare_data (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+
+  if (!priv->rare_data)
+    priv->rare_data = g_new0 (GtkWidgetRareData, 1);
+
+  return priv->rare_data;
+}
+
 static GtkWidgetSurfaceTransformData *
 ensure_surface_transform_data (GtkWidget *widget)
 {
@@ -3491,6 +3526,11 @@ gtk_widget_unrealize (GtkWidget *widget)
  *
  * This means @widget's [vfunc@Gtk.Widget.snapshot]
  * implementation will be called.
+ *
+ * Only @widget and its ancestors are snapshot again. The render
+ * nodes of all other widgets are kept from the previous frame and
+ * reused as they are, so the cost of a redraw depends on the depth
+ * of @widget in the hierarchy, not on the size of the window.
  */
 void
 gtk_widget_queue_draw (GtkWidget *widget)
@@ -3501,6 +3541,10 @@ gtk_widget_queue_draw (GtkWidget *widget)
   if (!_gtk_widget_get_mapped (widget))
     return;
 
+  /* Dirty the path up to the root. The render nodes of widgets
+   * outside of it stay valid, and are shared with the previous
+   * frame, so the renderer's node diff skips them by pointer.
+   */
   for (; widget; widget = _gtk_widget_get_parent (widget))
     {
       GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
@@ -3510,6 +3554,7 @@ gtk_widget_queue_draw (GtkWidget *widget)
 
       priv->draw_needed = TRUE;
       g_clear_pointer (&priv->render_node, gsk_render_node_unref);
+      g_clear_pointer (&priv->content_node, gsk_render_node_unref);
       if (GTK_IS_NATIVE (widget) && _gtk_widget_get_realized (widget))
         gdk_surface_queue_render (gtk_native_get_surface (GTK_NATIVE (widget)));
     }
@@ -3588,7 +3633,9 @@ gtk_widget_queue_resize_internal (GtkWidget *widget)
       GtkWidget *parent = _gtk_widget_get_parent (widget);
       if (parent)
         {
-          if (GTK_IS_NATIVE (widget))
+          GtkWidgetPrivate *parent_priv = gtk_widget_get_instance_private (parent);
+
+          if (GTK_IS_NATIVE (widget) || parent_priv->fixed_size)
             gtk_widget_queue_allocate (parent);
           else
             gtk_widget_queue_resize_internal (parent);
@@ -3619,6 +3666,12 @@ gtk_widget_queue_resize (GtkWidget *widget)
 {
   g_return_if_fail (GTK_IS_WIDGET (widget));
 
+  /* Record which widget started a relayout, queueing a resize
+   * on a widget that already needs one has no effect */
+  if (GDK_PROFILER_IS_RUNNING && !gtk_widget_get_resize_needed (widget))
+    gdk_profiler_add_mark (GDK_PROFILER_CURRENT_TIME, 0, "queue resize",
+                           G_OBJECT_TYPE_NAME (widget));
+
   if (_gtk_widget_get_realized (widget))
     gtk_widget_queue_draw (widget);
 
@@ -3943,6 +3996,7 @@ gtk_widget_allocate (GtkWidget    *widget,
   GtkCssStyle *style;
   GtkBorder margin, border, padding;
   GskTransform *css_transform;
+  gint64 before G_GNUC_UNUSED;
 
   g_return_if_fail (GTK_IS_WIDGET (widget));
   g_return_if_fail (baseline >= -1);
@@ -4085,6 +4139,8 @@ gtk_widget_allocate (GtkWidget    *widget,
 
       priv->alloc_needed_on_child = FALSE;
 
+      before = GDK_PROFILER_CURRENT_TIME;
+
       if (priv->layout_manager != NULL)
         {
           gtk_layout_manager_allocate (priv->layout_manager, widget,
@@ -4100,6 +4156,17 @@ gtk_widget_allocate (GtkWidget    *widget,
                                                         baseline);
         }
 
+      if (GDK_PROFILER_IS_RUNNING)
+        {
+          gint64 duration = GDK_PROFILER_CURRENT_TIME - before;
+
+          if (duration > GTK_WIDGET_MIN_PROFILED_DURATION)
+            gdk_profiler_add_markf (before, duration, "size allocate",
+                                    "%s %dx%d",
+                                    G_OBJECT_TYPE_NAME (widget),
+                                    priv->width, priv->height);
+        }
+
       /* Size allocation is god... after consulting god, no further requests or allocations are needed */
 #ifdef G_ENABLE_DEBUG
       if (GTK_DISPLAY_DEBUG_CHECK (_gtk_widget_get_display (widget), GEOMETRY) &&
@@ -4537,6 +4604,30 @@ gtk_widget_real_mnemonic_activate (GtkWidget *widget,
 #define WIDGET_REALIZED_FOR_EVENT(widget, event) \
      (gdk_event_get_event_type (event) == GDK_FOCUS_CHANGE || _gtk_widget_get_realized (widget))
 
+/* Most widgets in a propagation path have no controllers for a
+ * given phase, so check that before doing any per-widget work, in
+ * particular translating the event coordinates, which walks up the
+ * hierarchy again.
+ */
+static gboolean
+gtk_widget_has_controllers_for_phase (GtkWidget           *widget,
+                                      GtkPropagationPhase  phase)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GList *l;
+
+  for (l = priv->event_controllers; l; l = l->next)
+    {
+      GtkEventController *controller = l->data;
+
+      if (controller != NULL &&
+          gtk_event_controller_get_propagation_phase (controller) == phase)
+        return TRUE;
+    }
+
+  return FALSE;
+}
+
 gboolean
 gtk_widget_run_controllers (GtkWidget           *widget,
                             GdkEvent            *event,
@@ -4739,6 +4830,9 @@ _gtk_widget_captured_event (GtkWidget *widget,
   if (!event_surface_is_still_viewable (event))
     return TRUE;
 
+  if (!gtk_widget_has_controllers_for_phase (widget, GTK_PHASE_CAPTURE))
+    return FALSE;
+
   translate_event_coordinates (event, &x, &y, widget);
 
   return_val = gtk_widget_run_controllers (widget, event, target, x, y, GTK_PHASE_CAPTURE);
@@ -4766,6 +4860,10 @@ gtk_widget_event (GtkWidget *widget,
   if (!_gtk_widget_get_mapped (widget))
     return FALSE;
 
+  if (!gtk_widget_has_controllers_for_phase (widget, GTK_PHASE_BUBBLE) &&
+      (widget != target || !gtk_widget_has_controllers_for_phase (widget, GTK_PHASE_TARGET)))
+    return FALSE;
+
   translate_event_coordinates (event, &x, &y, widget);
 
   if (widget == target)
@@ -4995,11 +5093,16 @@ gtk_widget_real_css_changed (GtkWidget         *widget,
               gtk_widget_queue_allocate (priv->parent);
             }
 
-          if (gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_REDRAW) ||
-              (has_text && gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_TEXT_CONTENT)))
+          if (gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_REDRAW & ~GTK_CSS_AFFECTS_POSTEFFECT) ||
+              (has_text && gtk_css_style_change_affects (change, GTK_CSS_AFFECTS_TEXT_CONTENT)) ||
+              gtk_css_style_change_changes_property (change, GTK_CSS_PROPERTY_FILTER))
             {
               gtk_widget_queue_draw (widget);
             }
+          else if (gtk_css_style_change_changes_property (change, GTK_CSS_PROPERTY_OPACITY))
+            {
+              gtk_widget_update_opacity (widget);
+            }
         }
     }
   else
@@ -6080,12 +6183,12 @@ gtk_widget_reposition_after (GtkWidget *widget,
   if (parent->priv->root && priv->root == NULL)
     gtk_widget_root (widget);
 
-  if (parent->priv->children_observer)
+  if (parent->priv->rare_data && parent->priv->rare_data->children_observer)
     {
       if (prev_previous)
-        gtk_list_list_model_item_moved (parent->priv->children_observer, widget, prev_previous);
+        gtk_list_list_model_item_moved (parent->priv->rare_data->children_observer, widget, prev_previous);
       else
-        gtk_list_list_model_item_added (parent->priv->children_observer, widget);
+        gtk_list_list_model_item_added (parent->priv->rare_data->children_observer, widget);
     }
 
   if (prev_parent == NULL)
@@ -7431,10 +7534,13 @@ gtk_widget_dispose (GObject *object)
   if (priv->muxer != NULL)
     g_object_run_dispose (G_OBJECT (priv->muxer));
 
-  if (priv->children_observer)
-    gtk_list_list_model_clear (priv->children_observer);
-  if (priv->controller_observer)
-    gtk_list_list_model_clear (priv->controller_observer);
+  if (priv->rare_data)
+    {
+      if (priv->rare_data->children_observer)
+        gtk_list_list_model_clear (priv->rare_data->children_observer);
+      if (priv->rare_data->controller_observer)
+        gtk_list_list_model_clear (priv->rare_data->controller_observer);
+    }
 
   if (priv->parent)
     {
@@ -7456,7 +7562,8 @@ gtk_widget_dispose (GObject *object)
   if (_gtk_widget_get_realized (widget))
     gtk_widget_unrealize (widget);
 
-  g_clear_object (&priv->cursor);
+  if (priv->rare_data)
+    g_clear_object (&priv->rare_data->cursor);
 
   if (!priv->in_destruction)
     {
@@ -7646,8 +7753,12 @@ gtk_widget_finalize (GObject *object)
   gtk_grab_remove (widget);
 
   g_free (priv->name);
-  g_free (priv->tooltip_markup);
-  g_free (priv->tooltip_text);
+  if (priv->rare_data)
+    {
+      g_free (priv->rare_data->tooltip_markup);
+      g_free (priv->rare_data->tooltip_text);
+      g_free (priv->rare_data);
+    }
 
   g_clear_pointer (&priv->transform, gsk_transform_unref);
   g_clear_pointer (&priv->allocated_transform, gsk_transform_unref);
@@ -9919,7 +10030,7 @@ void
 gtk_widget_set_tooltip_text (GtkWidget  *widget,
                              const char *text)
 {
-  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GtkWidgetRareData *rare_data;
   GObject *object = G_OBJECT (widget);
   char *tooltip_text, *tooltip_markup;
 
@@ -9941,13 +10052,14 @@ gtk_widget_set_tooltip_text (GtkWidget  *widget,
       tooltip_markup = text != NULL ? g_markup_escape_text (text, -1) : NULL;
     }
 
-  g_clear_pointer (&priv->tooltip_markup, g_free);
-  g_clear_pointer (&priv->tooltip_text, g_free);
+  rare_data = gtk_widget_ensure_rare_data (widget);
+  g_clear_pointer (&rare_data->tooltip_markup, g_free);
+  g_clear_pointer (&rare_data->tooltip_text, g_free);
 
-  priv->tooltip_text = tooltip_text;
-  priv->tooltip_markup = tooltip_markup;
+  rare_data->tooltip_text = tooltip_text;
+  rare_data->tooltip_markup = tooltip_markup;
 
-  gtk_widget_set_has_tooltip (widget, priv->tooltip_text != NULL);
+  gtk_widget_set_has_tooltip (widget, rare_data->tooltip_text != NULL);
   if (_gtk_widget_get_visible (widget))
     gtk_widget_trigger_tooltip_query (widget);
 
@@ -9977,7 +10089,7 @@ gtk_widget_get_tooltip_text (GtkWidget *widget)
 
   g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
 
-  return priv->tooltip_text;
+  return priv->rare_data ? priv->rare_data->tooltip_text : NULL;
 }
 
 /**
@@ -9998,7 +10110,7 @@ void
 gtk_widget_set_tooltip_markup (GtkWidget  *widget,
                                const char *markup)
 {
-  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GtkWidgetRareData *rare_data;
   GObject *object = G_OBJECT (widget);
   char *tooltip_markup;
 
@@ -10014,24 +10126,25 @@ gtk_widget_set_tooltip_markup (GtkWidget  *widget,
   else
     tooltip_markup = g_strdup (markup);
 
-  g_clear_pointer (&priv->tooltip_text, g_free);
-  g_clear_pointer (&priv->tooltip_markup, g_free);
+  rare_data = gtk_widget_ensure_rare_data (widget);
+  g_clear_pointer (&rare_data->tooltip_text, g_free);
+  g_clear_pointer (&rare_data->tooltip_markup, g_free);
 
-  priv->tooltip_markup = tooltip_markup;
+  rare_data->tooltip_markup = tooltip_markup;
 
   /* Store the tooltip without markup, as we might end up using
    * it for widget descriptions in the accessibility layer
    */
-  if (priv->tooltip_markup != NULL)
+  if (rare_data->tooltip_markup != NULL)
     {
-      pango_parse_markup (priv->tooltip_markup, -1, 0, NULL,
-                          &priv->tooltip_text,
+      pango_parse_markup (rare_data->tooltip_markup, -1, 0, NULL,
+                          &rare_data->tooltip_text,
                           NULL,
                           NULL);
     }
 
   gtk_accessible_update_property (GTK_ACCESSIBLE (widget),
-                                  GTK_ACCESSIBLE_PROPERTY_DESCRIPTION, priv->tooltip_text,
+                                  GTK_ACCESSIBLE_PROPERTY_DESCRIPTION, rare_data->tooltip_text,
                                   -1);
 
   gtk_widget_set_has_tooltip (widget, tooltip_markup != NULL);
@@ -10064,7 +10177,7 @@ gtk_widget_get_tooltip_markup (GtkWidget *widget)
 
   g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
 
-  return priv->tooltip_markup;
+  return priv->rare_data ? priv->rare_data->tooltip_markup : NULL;
 }
 
 /**
@@ -10608,7 +10721,7 @@ gtk_widget_set_opacity (GtkWidget *widget,
 
   priv->user_alpha = alpha;
 
-  gtk_widget_queue_draw (widget);
+  gtk_widget_update_opacity (widget);
 
   g_object_notify_by_pspec (G_OBJECT (widget), widget_props[PROP_OPACITY]);
 }
@@ -11735,8 +11848,8 @@ gtk_widget_add_controller (GtkWidget          *widget,
 
   priv->event_controllers = g_list_prepend (priv->event_controllers, controller);
 
-  if (priv->controller_observer)
-    gtk_list_list_model_item_added_at (priv->controller_observer, 0);
+  if (priv->rare_data && priv->rare_data->controller_observer)
+    gtk_list_list_model_item_added_at (priv->rare_data->controller_observer, 0);
 }
 
 /**
@@ -11770,8 +11883,8 @@ gtk_widget_remove_controller (GtkWidget          *widget,
   priv->event_controllers = g_list_delete_link (priv->event_controllers, list);
   g_object_unref (controller);
 
-  if (priv->controller_observer)
-    gtk_list_list_model_item_removed (priv->controller_observer, before);
+  if (priv->rare_data && priv->rare_data->controller_observer)
+    gtk_list_list_model_item_removed (priv->rare_data->controller_observer, before);
 }
 
 void
@@ -11816,25 +11929,66 @@ gtk_widget_list_controllers (GtkWidget           *widget,
   return (GtkEventController **)g_ptr_array_free (controllers, FALSE);
 }
 
+static double
+gtk_widget_get_render_opacity (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GtkCssStyle *style;
+  double css_opacity;
+
+  style = gtk_css_node_get_style (priv->cssnode);
+
+  css_opacity = _gtk_css_number_value_get (style->other->opacity, 100);
+
+  return CLAMP (css_opacity, 0.0, 1.0) * priv->user_alpha / 255.0;
+}
+
 static GskRenderNode *
-gtk_widget_create_render_node (GtkWidget   *widget,
-                               GtkSnapshot *snapshot)
+gtk_widget_wrap_content_node (GtkWidget     *widget,
+                              GskRenderNode *content)
+{
+  double opacity;
+
+  opacity = gtk_widget_get_render_opacity (widget);
+
+  if (opacity <= 0.0)
+    return NULL;
+  else if (opacity < 1.0)
+    return gsk_opacity_node_new (content, opacity);
+  else
+    return gsk_render_node_ref (content);
+}
+
+/* Without a filter, the opacity is applied on top of everything
+ * else, so the node is created without it and returned in
+ * @out_content, and the opacity applied afterwards.
+ */
+static GskRenderNode *
+gtk_widget_create_render_node (GtkWidget      *widget,
+                               GtkSnapshot    *snapshot,
+                               GskRenderNode **out_content)
 {
   GtkWidgetClass *klass = GTK_WIDGET_GET_CLASS (widget);
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
   GtkCssBoxes boxes;
   GtkCssValue *filter_value;
-  double css_opacity, opacity;
+  GskRenderNode *result;
+  double opacity;
+  gboolean separate_opacity;
   GtkCssStyle *style;
 
+  *out_content = NULL;
+
   style = gtk_css_node_get_style (priv->cssnode);
 
-  css_opacity = _gtk_css_number_value_get (style->other->opacity, 100);
-  opacity = CLAMP (css_opacity, 0.0, 1.0) * priv->user_alpha / 255.0;
+  opacity = gtk_widget_get_render_opacity (widget);
 
   if (opacity <= 0.0)
     return NULL;
 
+  filter_value = style->other->filter;
+  separate_opacity = gtk_css_filter_value_is_none (filter_value);
+
   gtk_css_boxes_init (&boxes, widget);
 
   gtk_snapshot_push_collect (snapshot);
@@ -11842,10 +11996,9 @@ gtk_widget_create_render_node (GtkWidget   *widget,
                            "RenderNode for %s %p",
                            G_OBJECT_TYPE_NAME (widget), widget);
 
-  filter_value = style->other->filter;
   gtk_css_filter_value_push_snapshot (filter_value, snapshot);
 
-  if (opacity < 1.0)
+  if (!separate_opacity && opacity < 1.0)
     gtk_snapshot_push_opacity (snapshot, opacity);
 
   gtk_css_style_snapshot_background (&boxes, snapshot);
@@ -11864,14 +12017,56 @@ gtk_widget_create_render_node (GtkWidget   *widget,
 
   gtk_css_style_snapshot_outline (&boxes, snapshot);
 
-  if (opacity < 1.0)
+  if (!separate_opacity && opacity < 1.0)
     gtk_snapshot_pop (snapshot);
 
   gtk_css_filter_value_pop_snapshot (filter_value, snapshot);
 
   gtk_snapshot_pop (snapshot);
 
-  return gtk_snapshot_pop_collect (snapshot);
+  result = gtk_snapshot_pop_collect (snapshot);
+
+  if (!separate_opacity || result == NULL)
+    return result;
+
+  *out_content = result;
+
+  return gtk_widget_wrap_content_node (widget, result);
+}
+
+/*
+ * gtk_widget_update_opacity:
+ * @widget: a `GtkWidget`
+ *
+ * Updates the widget for a change of its opacity.
+ *
+ * When nothing else changed, the previously created content is
+ * kept and only the opacity node around it gets replaced, so the
+ * widget doesn't need to be snapshot again, only its parent.
+ * This keeps fading animations cheap.
+ */
+static void
+gtk_widget_update_opacity (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+
+  if (!_gtk_widget_get_mapped (widget))
+    return;
+
+  if (priv->draw_needed ||
+      priv->content_node == NULL ||
+      priv->parent == NULL ||
+      GTK_IS_NATIVE (widget))
+    {
+      gtk_widget_queue_draw (widget);
+      return;
+    }
+
+  g_clear_pointer (&priv->render_node, gsk_render_node_unref);
+  priv->render_node = gtk_widget_wrap_content_node (widget, priv->content_node);
+
+  gtk_widget_queue_draw (priv->parent);
+  gtk_widget_update_paintables (widget);
 }
 
 static void
@@ -11879,7 +12074,7 @@ gtk_widget_do_snapshot (GtkWidget *widget,
                         GtkSnapshot *snapshot)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
-  GskRenderNode *render_node;
+  GskRenderNode *render_node, *content_node;
 
   if (!priv->draw_needed)
     return;
@@ -11894,12 +12089,14 @@ gtk_widget_do_snapshot (GtkWidget *widget,
 
   gtk_widget_push_paintables (widget);
 
-  render_node = gtk_widget_create_render_node (widget, snapshot);
+  render_node = gtk_widget_create_render_node (widget, snapshot, &content_node);
   /* This can happen when nested drawing happens and a widget contains itself
    * or when we replace a clipped area
    */
   g_clear_pointer (&priv->render_node, gsk_render_node_unref);
+  g_clear_pointer (&priv->content_node, gsk_render_node_unref);
   priv->render_node = render_node;
+  priv->content_node = content_node;
 
   priv->draw_needed = FALSE;
 
@@ -11945,11 +12142,16 @@ gtk_widget_render (GtkWidget            *widget,
   if (renderer == NULL)
     return;
 
+  if (G_UNLIKELY (!gtk_startup_is_finished ()))
+    gtk_startup_phase_begin ("first frame");
+
+  gsk_render_node_arena_push ();
   snapshot = gtk_snapshot_new ();
   gtk_native_get_surface_transform (GTK_NATIVE (widget), &x, &y);
   gtk_snapshot_translate (snapshot, &GRAPHENE_POINT_INIT (x, y));
   gtk_widget_snapshot (widget, snapshot);
   root = gtk_snapshot_free_to_node (snapshot);
+  gsk_render_node_arena_pop ();
 
   if (GDK_PROFILER_IS_RUNNING)
     {
@@ -11972,6 +12174,12 @@ gtk_widget_render (GtkWidget            *widget,
 
       gdk_profiler_end_mark (before_render, "widget render", "");
     }
+
+  if (G_UNLIKELY (!gtk_startup_is_finished ()))
+    {
+      gtk_startup_phase_end (NULL);
+      gtk_startup_finish ();
+    }
 }
 
 static void
@@ -11979,7 +12187,7 @@ gtk_widget_child_observer_destroyed (gpointer widget)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
 
-  priv->children_observer = NULL;
+  priv->rare_data->children_observer = NULL;
 }
 
 /**
@@ -12001,22 +12209,23 @@ gtk_widget_child_observer_destroyed (gpointer widget)
 GListModel *
 gtk_widget_observe_children (GtkWidget *widget)
 {
-  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GtkWidgetRareData *rare_data;
 
   g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
 
-  if (priv->children_observer)
-    return g_object_ref (G_LIST_MODEL (priv->children_observer));
+  rare_data = gtk_widget_ensure_rare_data (widget);
+  if (rare_data->children_observer)
+    return g_object_ref (G_LIST_MODEL (rare_data->children_observer));
 
-  priv->children_observer = gtk_list_list_model_new ((gpointer) gtk_widget_get_first_child,
-                                                     (gpointer) gtk_widget_get_next_sibling,
-                                                     (gpointer) gtk_widget_get_prev_sibling,
-                                                     (gpointer) gtk_widget_get_last_child,
-                                                     (gpointer) g_object_ref,
-                                                     widget,
-                                                     gtk_widget_child_observer_destroyed);
+  rare_data->children_observer = gtk_list_list_model_new ((gpointer) gtk_widget_get_first_child,
+                                                          (gpointer) gtk_widget_get_next_sibling,
+                                                          (gpointer) gtk_widget_get_prev_sibling,
+                                                          (gpointer) gtk_widget_get_last_child,
+                                                          (gpointer) g_object_ref,
+                                                          widget,
+                                                          gtk_widget_child_observer_destroyed);
 
-  return G_LIST_MODEL (priv->children_observer);
+  return G_LIST_MODEL (rare_data->children_observer);
 }
 
 static void
@@ -12024,7 +12233,7 @@ gtk_widget_controller_observer_destroyed (gpointer widget)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
 
-  priv->controller_observer = NULL;
+  priv->rare_data->controller_observer = NULL;
 }
 
 static gpointer
@@ -12074,22 +12283,23 @@ gtk_widget_controller_list_get_item (gpointer item,
 GListModel *
 gtk_widget_observe_controllers (GtkWidget *widget)
 {
-  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+  GtkWidgetRareData *rare_data;
 
   g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
 
-  if (priv->controller_observer)
-    return g_object_ref (G_LIST_MODEL (priv->controller_observer));
+  rare_data = gtk_widget_ensure_rare_data (widget);
+  if (rare_data->controller_observer)
+    return g_object_ref (G_LIST_MODEL (rare_data->controller_observer));
 
-  priv->controller_observer = gtk_list_list_model_new (gtk_widget_controller_list_get_first,
-                                                       gtk_widget_controller_list_get_next,
-                                                       gtk_widget_controller_list_get_prev,
-                                                       NULL,
-                                                       gtk_widget_controller_list_get_item,
-                                                       widget,
-                                                       gtk_widget_controller_observer_destroyed);
+  rare_data->controller_observer = gtk_list_list_model_new (gtk_widget_controller_list_get_first,
+                                                            gtk_widget_controller_list_get_next,
+                                                            gtk_widget_controller_list_get_prev,
+                                                            NULL,
+                                                            gtk_widget_controller_list_get_item,
+                                                            widget,
+                                                            gtk_widget_controller_observer_destroyed);
 
-  return G_LIST_MODEL (priv->controller_observer);
+  return G_LIST_MODEL (rare_data->controller_observer);
 }
 
 /**
@@ -12305,6 +12515,7 @@ gtk_widget_snapshot_child (GtkWidget   *widget,
                            GtkSnapshot *snapshot)
 {
   GtkWidgetPrivate *priv = gtk_widget_get_instance_private (child);
+  graphene_rect_t clip, bounds;
 
   g_return_if_fail (_gtk_widget_get_parent (child) == widget);
   g_return_if_fail (snapshot != NULL);
@@ -12320,6 +12531,18 @@ gtk_widget_snapshot_child (GtkWidget   *widget,
   if (!priv->render_node)
     return;
 
+  /* Leave out children that are clipped away completely, like the
+   * ones scrolled out of view. Only clips of @widget itself are
+   * considered, and moving a child redraws @widget, so the render
+   * node of @widget stays valid.
+   */
+  if (gtk_snapshot_get_clip_bounds (snapshot, &clip))
+    {
+      gsk_transform_transform_bounds (priv->transform, &priv->render_node->bounds, &bounds);
+      if (!graphene_rect_intersection (&clip, &bounds, NULL))
+        return;
+    }
+
   if (priv->transform)
     {
       GskRenderNode *transform_node = gsk_transform_node_new (priv->render_node,
@@ -12410,7 +12633,10 @@ gtk_widget_set_cursor (GtkWidget *widget,
   g_return_if_fail (GTK_IS_WIDGET (widget));
   g_return_if_fail (cursor == NULL || GDK_IS_CURSOR (cursor));
 
-  if (!g_set_object (&priv->cursor, cursor))
+  if (cursor == NULL && priv->rare_data == NULL)
+    return;
+
+  if (!g_set_object (&gtk_widget_ensure_rare_data (widget)->cursor, cursor))
     return;
 
   root = _gtk_widget_get_root (widget);
@@ -12475,7 +12701,7 @@ gtk_widget_get_cursor (GtkWidget *widget)
 
   g_return_val_if_fail (GTK_IS_WIDGET (widget), NULL);
 
-  return priv->cursor;
+  return priv->rare_data ? priv->rare_data->cursor : NULL;
 }
 
 /**
@@ -12713,6 +12939,68 @@ gtk_widget_get_layout_manager (GtkWidget *widget)
   return priv->layout_manager;
 }
 
+/**
+ * gtk_widget_set_fixed_size: (attributes org.gtk.Method.set_property=fixed-size)
+ * @widget: a `GtkWidget`
+ * @fixed_size: whether the size of @widget does not depend on its children
+ *
+ * Declares whether the size of @widget depends only on its own
+ * properties and style, and not on its children.
+ *
+ * This is the case for example if @widget has a size request set
+ * with [method@Gtk.Widget.set_size_request] that is always larger
+ * than its contents.
+ *
+ * If @fixed_size is %TRUE, resizes queued by the children of @widget
+ * stop at @widget: it is allocated again, but neither @widget nor its
+ * ancestors are measured again. Resizes queued on @widget itself still
+ * propagate as usual.
+ *
+ * Since: 4.14
+ */
+void
+gtk_widget_set_fixed_size (GtkWidget *widget,
+                           gboolean   fixed_size)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+
+  g_return_if_fail (GTK_IS_WIDGET (widget));
+
+  fixed_size = !!fixed_size;
+
+  if (priv->fixed_size == fixed_size)
+    return;
+
+  priv->fixed_size = fixed_size;
+
+  gtk_widget_queue_resize (widget);
+
+  g_object_notify_by_pspec (G_OBJECT (widget), widget_props[PROP_FIXED_SIZE]);
+}
+
+/**
+ * gtk_widget_get_fixed_size: (attributes org.gtk.Method.get_property=fixed-size)
+ * @widget: a `GtkWidget`
+ *
+ * Returns whether the size of @widget has been declared as not
+ * depending on its children.
+ *
+ * See [method@Gtk.Widget.set_fixed_size].
+ *
+ * Returns: %TRUE if the size of @widget does not depend on its children
+ *
+ * Since: 4.14
+ */
+gboolean
+gtk_widget_get_fixed_size (GtkWidget *widget)
+{
+  GtkWidgetPrivate *priv = gtk_widget_get_instance_private (widget);
+
+  g_return_val_if_fail (GTK_IS_WIDGET (widget), FALSE);
+
+  return priv->fixed_size;
+}
+
 /**
  * gtk_widget_should_layout:
  * @widget: a widget
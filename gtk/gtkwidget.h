@@ -519,6 +519,11 @@ GDK_AVAILABLE_IN_ALL
 void       gtk_widget_get_size_request    (GtkWidget           *widget,
                                            int                 *width,
                                            int                 *height);
+GDK_AVAILABLE_IN_4_14
+void       gtk_widget_set_fixed_size      (GtkWidget           *widget,
+                                           gboolean             fixed_size);
+GDK_AVAILABLE_IN_4_14
+gboolean   gtk_widget_get_fixed_size      (GtkWidget           *widget);
 GDK_AVAILABLE_IN_ALL
 void       gtk_widget_set_opacity         (GtkWidget           *widget,
                                            double               opacity);
@@ -47,6 +47,10 @@ typedef gboolean (*GtkSurfaceTransformChangedCallback) (GtkWidget
 
 #define GTK_STATE_FLAGS_BITS 15
 
+/* measure() and size_allocate() calls taking less than this (in ns)
+ * are not reported to the profiler */
+#define GTK_WIDGET_MIN_PROFILED_DURATION 100000
+
 typedef struct _GtkWidgetSurfaceTransformData
 {
   GtkWidget *tracked_parent;
@@ -58,6 +62,21 @@ typedef struct _GtkWidgetSurfaceTransformData
   GList *callbacks;
 } GtkWidgetSurfaceTransformData;
 
+/* State that most widgets never use, allocated on demand
+ * by gtk_widget_ensure_rare_data() */
+typedef struct _GtkWidgetRareData
+{
+  /* Pointer cursor */
+  GdkCursor *cursor;
+
+  /* Tooltip */
+  char *tooltip_markup;
+  char *tooltip_text;
+
+  GtkListListModel *children_observer;
+  GtkListListModel *controller_observer;
+} GtkWidgetRareData;
+
 struct _GtkWidgetPrivate
 {
   /* The state of the widget. Needs to be able to hold all GtkStateFlags bits
@@ -86,6 +105,7 @@ struct _GtkWidgetPrivate
   guint resize_needed         : 1; /* queue_resize() has been called but no get_preferred_size() yet */
   guint alloc_needed          : 1; /* this widget needs a size_allocate() call */
   guint alloc_needed_on_child : 1; /* 0 or more children - or this widget - need a size_allocate() call */
+  guint fixed_size            : 1; /* resizes of children don't change our size */
 
   /* Queue-draw related flags */
   guint draw_needed           : 1;
@@ -166,6 +186,9 @@ struct _GtkWidgetPrivate
 
   /* The render node we draw or %NULL if not yet created.*/
   GskRenderNode *render_node;
+  /* What render_node contains without the opacity applied, or %NULL
+   * if that isn't separable, see gtk_widget_update_opacity(). */
+  GskRenderNode *content_node;
 
   /* The layout manager, or %NULL */
   GtkLayoutManager *layout_manager;
@@ -182,19 +205,11 @@ struct _GtkWidgetPrivate
   GtkWidget *last_child;
 
   /* only created on-demand */
-  GtkListListModel *children_observer;
-  GtkListListModel *controller_observer;
   GtkActionMuxer *muxer;
+  GtkWidgetRareData *rare_data;
 
   GtkWidget *focus_child;
 
-  /* Pointer cursor */
-  GdkCursor *cursor;
-
-  /* Tooltip */
-  char *tooltip_markup;
-  char *tooltip_text;
-
   /* Accessibility */
   GtkATContext *at_context;
   GtkAccessibleRole accessible_role;
@@ -409,6 +424,12 @@ _gtk_widget_get_realized (GtkWidget *widget)
   return widget->priv->realized;
 }
 
+static inline gboolean
+_gtk_widget_get_draw_needed (GtkWidget *widget)
+{
+  return widget->priv->draw_needed;
+}
+
 static inline GtkStateFlags
 _gtk_widget_get_state_flags (GtkWidget *widget)
 {
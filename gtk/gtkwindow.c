@@ -60,6 +60,7 @@
 #include "gtkpopovermenubarprivate.h"
 #include "gtkcssboxesimplprivate.h"
 #include "gtktooltipprivate.h"
+#include "gtktrimprivate.h"
 #include "gtkmenubutton.h"
 
 #include "inspector/window.h"
@@ -4041,6 +4042,8 @@ gtk_window_unmap (GtkWidget *widget)
 
   if (child != NULL)
     gtk_widget_unmap (child);
+
+  gtk_trim_window_unmapped ();
 }
 
 static void
@@ -40,6 +40,7 @@
 #include "gtksingleselection.h"
 #include "gtkcolumnview.h"
 #include "gtkcolumnviewcolumn.h"
+#include "gtkcssnodeprivate.h"
 
 #include <glib/gi18n-lib.h>
 #include <gtk/css/gtkcss.h>
@@ -160,6 +161,161 @@ css_property_new (const char *name,
   return self;
 }
 
+/* }}} */
+/* {{{ CssNodeStats object */
+
+typedef struct _CssNodeStats CssNodeStats;
+
+G_DECLARE_FINAL_TYPE (CssNodeStats, css_node_stats, CSS, NODE_STATS, GObject);
+
+struct _CssNodeStats
+{
+  GObject parent;
+
+  char *name;
+  guint restyles;
+  guint changes;
+  gint64 time;
+  char *causes;
+};
+
+enum {
+  CSS_NODE_STATS_PROP_NAME = 1,
+  CSS_NODE_STATS_PROP_RESTYLES,
+  CSS_NODE_STATS_PROP_CHANGES,
+  CSS_NODE_STATS_PROP_TIME,
+  CSS_NODE_STATS_PROP_CAUSES,
+  CSS_NODE_STATS_NUM_PROPERTIES
+};
+
+G_DEFINE_TYPE (CssNodeStats, css_node_stats, G_TYPE_OBJECT);
+
+static void
+css_node_stats_init (CssNodeStats *self)
+{
+}
+
+static void
+css_node_stats_finalize (GObject *object)
+{
+  CssNodeStats *self = CSS_NODE_STATS (object);
+
+  g_free (self->name);
+  g_free (self->causes);
+
+  G_OBJECT_CLASS (css_node_stats_parent_class)->finalize (object);
+}
+
+static void
+css_node_stats_get_property (GObject    *object,
+                             guint       property_id,
+                             GValue     *value,
+                             GParamSpec *pspec)
+{
+  CssNodeStats *self = CSS_NODE_STATS (object);
+
+  switch (property_id)
+    {
+    case CSS_NODE_STATS_PROP_NAME:
+      g_value_set_string (value, self->name);
+      break;
+
+    case CSS_NODE_STATS_PROP_RESTYLES:
+      g_value_set_uint (value, self->restyles);
+      break;
+
+    case CSS_NODE_STATS_PROP_CHANGES:
+      g_value_set_uint (value, self->changes);
+      break;
+
+    case CSS_NODE_STATS_PROP_TIME:
+      g_value_set_int64 (value, self->time);
+      break;
+
+    case CSS_NODE_STATS_PROP_CAUSES:
+      g_value_set_string (value, self->causes);
+      break;
+
+    default:
+      G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
+      break;
+    }
+}
+
+static void
+css_node_stats_class_init (CssNodeStatsClass *class)
+{
+  GObjectClass *object_class = G_OBJECT_CLASS (class);
+
+  object_class->finalize = css_node_stats_finalize;
+  object_class->get_property = css_node_stats_get_property;
+
+  g_object_class_install_property (object_class, CSS_NODE_STATS_PROP_NAME,
+      g_param_spec_string ("name", NULL, NULL,
+                           NULL,
+                           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, CSS_NODE_STATS_PROP_RESTYLES,
+      g_param_spec_uint ("restyles", NULL, NULL,
+                         0, G_MAXUINT, 0,
+                         G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, CSS_NODE_STATS_PROP_CHANGES,
+      g_param_spec_uint ("changes", NULL, NULL,
+                         0, G_MAXUINT, 0,
+                         G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, CSS_NODE_STATS_PROP_TIME,
+      g_param_spec_int64 ("time", NULL, NULL,
+                          0, G_MAXINT64, 0,
+                          G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class, CSS_NODE_STATS_PROP_CAUSES,
+      g_param_spec_string ("causes", NULL, NULL,
+                           NULL,
+                           G_PARAM_READABLE | G_PARAM_STATIC_STRINGS));
+}
+
+static char *
+describe_node (GtkCssNode *node)
+{
+  GString *str;
+  const char *name;
+  const GQuark *classes;
+  guint i, n_classes;
+
+  str = g_string_new (NULL);
+
+  name = g_quark_to_string (gtk_css_node_get_name (node));
+  g_string_append (str, name ? name : "*");
+
+  if (gtk_css_node_get_id (node))
+    g_string_append_printf (str, "#%s", g_quark_to_string (gtk_css_node_get_id (node)));
+
+  classes = gtk_css_node_list_classes (node, &n_classes);
+  for (i = 0; i < n_classes; i++)
+    g_string_append_printf (str, ".%s", g_quark_to_string (classes[i]));
+
+  return g_string_free (str, FALSE);
+}
+
+static CssNodeStats *
+css_node_stats_new (GtkCssNode            *node,
+                    const GtkCssNodeStats *stats)
+{
+  CssNodeStats *self;
+
+  self = g_object_new (css_node_stats_get_type (), NULL);
+
+  self->name = describe_node (node);
+  self->restyles = stats->n_restyles;
+  self->changes = stats->n_changes;
+  self->time = stats->time;
+  self->causes = gtk_css_change_to_string (stats->causes);
+
+  return self;
+}
+
 /* }}} */
 
 enum
@@ -178,6 +334,9 @@ struct _GtkInspectorCssNodeTreePrivate
   GtkWidget *node_tree;
   GListStore *prop_model;
   GtkWidget *prop_tree;
+  GListStore *stats_model;
+  GtkWidget *stats_tree;
+  gboolean recording;
   GtkCssNode *node;
 };
 
@@ -267,9 +426,95 @@ gtk_inspector_css_node_tree_finalize (GObject *object)
 
   gtk_inspector_css_node_tree_unset_node (cnt);
 
+  if (cnt->priv->recording)
+    gtk_css_node_set_stats_enabled (FALSE);
+
   G_OBJECT_CLASS (gtk_inspector_css_node_tree_parent_class)->finalize (object);
 }
 
+static GtkCssNode *
+get_root_node (GtkInspectorCssNodeTree *cnt)
+{
+  GtkCssNode *root;
+
+  root = g_list_model_get_item (G_LIST_MODEL (cnt->priv->root_model), 0);
+  if (root)
+    g_object_unref (root);
+
+  return root;
+}
+
+static void
+collect_stats (GListStore *store,
+               GtkCssNode *node)
+{
+  const GtkCssNodeStats *stats;
+  GtkCssNode *child;
+
+  stats = gtk_css_node_get_stats (node);
+  if (stats)
+    {
+      CssNodeStats *item = css_node_stats_new (node, stats);
+      g_list_store_append (store, item);
+      g_object_unref (item);
+    }
+
+  for (child = gtk_css_node_get_first_child (node);
+       child;
+       child = gtk_css_node_get_next_sibling (child))
+    collect_stats (store, child);
+}
+
+static void
+reset_node_stats (GtkCssNode *node)
+{
+  GtkCssNode *child;
+
+  gtk_css_node_reset_stats (node);
+
+  for (child = gtk_css_node_get_first_child (node);
+       child;
+       child = gtk_css_node_get_next_sibling (child))
+    reset_node_stats (child);
+}
+
+static void
+refresh_stats (GtkButton               *button,
+               GtkInspectorCssNodeTree *cnt)
+{
+  GtkCssNode *root;
+
+  g_list_store_remove_all (cnt->priv->stats_model);
+
+  root = get_root_node (cnt);
+  if (root)
+    collect_stats (cnt->priv->stats_model, root);
+}
+
+static void
+reset_stats (GtkButton               *button,
+             GtkInspectorCssNodeTree *cnt)
+{
+  GtkCssNode *root;
+
+  root = get_root_node (cnt);
+  if (root)
+    reset_node_stats (root);
+
+  g_list_store_remove_all (cnt->priv->stats_model);
+}
+
+static void
+record_toggled (GtkToggleButton         *button,
+                GtkInspectorCssNodeTree *cnt)
+{
+  cnt->priv->recording = gtk_toggle_button_get_active (button);
+  gtk_css_node_set_stats_enabled (cnt->priv->recording);
+
+  if (!cnt->priv->recording)
+    refresh_stats (NULL, cnt);
+}
+
 static void
 gtk_inspector_css_node_tree_class_init (GtkInspectorCssNodeTreeClass *klass)
 {
@@ -290,6 +535,10 @@ gtk_inspector_css_node_tree_class_init (GtkInspectorCssNodeTreeClass *klass)
   gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/css-node-tree.ui");
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorCssNodeTree, node_tree);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorCssNodeTree, prop_tree);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorCssNodeTree, stats_tree);
+  gtk_widget_class_bind_template_callback (widget_class, record_toggled);
+  gtk_widget_class_bind_template_callback (widget_class, refresh_stats);
+  gtk_widget_class_bind_template_callback (widget_class, reset_stats);
 }
 
 static int
@@ -582,6 +831,60 @@ unbind_node_classes (GtkSignalListItemFactory *factory,
   g_signal_handlers_disconnect_by_func (label, G_CALLBACK (classes_changed), node);
 }
 
+static void
+bind_stats_name (GtkSignalListItemFactory *factory,
+                 GtkListItem              *list_item)
+{
+  CssNodeStats *stats = gtk_list_item_get_item (list_item);
+
+  gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (list_item)), stats->name);
+}
+
+static void
+bind_stats_restyles (GtkSignalListItemFactory *factory,
+                     GtkListItem              *list_item)
+{
+  CssNodeStats *stats = gtk_list_item_get_item (list_item);
+  char *text;
+
+  text = g_strdup_printf ("%u", stats->restyles);
+  gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (list_item)), text);
+  g_free (text);
+}
+
+static void
+bind_stats_changes (GtkSignalListItemFactory *factory,
+                    GtkListItem              *list_item)
+{
+  CssNodeStats *stats = gtk_list_item_get_item (list_item);
+  char *text;
+
+  text = g_strdup_printf ("%u", stats->changes);
+  gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (list_item)), text);
+  g_free (text);
+}
+
+static void
+bind_stats_time (GtkSignalListItemFactory *factory,
+                 GtkListItem              *list_item)
+{
+  CssNodeStats *stats = gtk_list_item_get_item (list_item);
+  char *text;
+
+  text = g_strdup_printf ("%.2f ms", stats->time / 1000.);
+  gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (list_item)), text);
+  g_free (text);
+}
+
+static void
+bind_stats_causes (GtkSignalListItemFactory *factory,
+                   GtkListItem              *list_item)
+{
+  CssNodeStats *stats = gtk_list_item_get_item (list_item);
+
+  gtk_label_set_text (GTK_LABEL (gtk_list_item_get_child (list_item)), stats->causes);
+}
+
 static void
 bind_node_state (GtkSignalListItemFactory *factory,
                  GtkListItem              *list_item)
@@ -709,6 +1012,68 @@ gtk_inspector_css_node_tree_init (GtkInspectorCssNodeTree *cnt)
 
       g_list_store_append (priv->prop_model, css_property_new (name, NULL, NULL));
     }
+
+  priv->stats_model = g_list_store_new (css_node_stats_get_type ());
+
+  sort_model = gtk_sort_list_model_new (G_LIST_MODEL (priv->stats_model),
+                                        g_object_ref (gtk_column_view_get_sorter (GTK_COLUMN_VIEW (priv->stats_tree))));
+
+  selection_model = GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (sort_model)));
+  gtk_column_view_set_model (GTK_COLUMN_VIEW (priv->stats_tree), selection_model);
+  g_object_unref (selection_model);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (priv->stats_tree)), 0);
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_value), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_stats_name), NULL);
+  gtk_column_view_column_set_factory (column, factory);
+  sorter = GTK_SORTER (gtk_string_sorter_new (gtk_property_expression_new (css_node_stats_get_type (), NULL, "name")));
+  gtk_column_view_column_set_sorter (column, sorter);
+  g_object_unref (sorter);
+  g_object_unref (factory);
+  g_object_unref (column);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (priv->stats_tree)), 1);
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_stats_restyles), NULL);
+  gtk_column_view_column_set_factory (column, factory);
+  sorter = GTK_SORTER (gtk_numeric_sorter_new (gtk_property_expression_new (css_node_stats_get_type (), NULL, "restyles")));
+  gtk_column_view_column_set_sorter (column, sorter);
+  gtk_column_view_sort_by_column (GTK_COLUMN_VIEW (priv->stats_tree), column, GTK_SORT_DESCENDING);
+  g_object_unref (sorter);
+  g_object_unref (factory);
+  g_object_unref (column);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (priv->stats_tree)), 2);
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_stats_changes), NULL);
+  gtk_column_view_column_set_factory (column, factory);
+  sorter = GTK_SORTER (gtk_numeric_sorter_new (gtk_property_expression_new (css_node_stats_get_type (), NULL, "changes")));
+  gtk_column_view_column_set_sorter (column, sorter);
+  g_object_unref (sorter);
+  g_object_unref (factory);
+  g_object_unref (column);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (priv->stats_tree)), 3);
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_stats_time), NULL);
+  gtk_column_view_column_set_factory (column, factory);
+  sorter = GTK_SORTER (gtk_numeric_sorter_new (gtk_property_expression_new (css_node_stats_get_type (), NULL, "time")));
+  gtk_column_view_column_set_sorter (column, sorter);
+  g_object_unref (sorter);
+  g_object_unref (factory);
+  g_object_unref (column);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (priv->stats_tree)), 4);
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_stats_causes), NULL);
+  gtk_column_view_column_set_factory (column, factory);
+  g_object_unref (factory);
+  g_object_unref (column);
 }
 
 void
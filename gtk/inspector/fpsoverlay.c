@@ -71,6 +71,58 @@ gtk_fps_overlay_get_fps (GtkWidget *widget)
   return gdk_frame_clock_get_fps (frame_clock);
 }
 
+/* Computes the average and maximum time between the start of a
+ * frame and it being presented, over the recent frame history.
+ * Returns FALSE if the backend doesn't report presentation times.
+ */
+static gboolean
+gtk_fps_overlay_get_latency (GtkWidget *widget,
+                             double    *avg_ms,
+                             double    *max_ms)
+{
+  GdkFrameClock *frame_clock;
+  gint64 start, end, i;
+  gint64 sum, max;
+  guint n;
+
+  frame_clock = gtk_widget_get_frame_clock (widget);
+  if (frame_clock == NULL)
+    return FALSE;
+
+  start = gdk_frame_clock_get_history_start (frame_clock);
+  end = gdk_frame_clock_get_frame_counter (frame_clock);
+  sum = max = 0;
+  n = 0;
+
+  for (i = start; i <= end; i++)
+    {
+      GdkFrameTimings *timings;
+      gint64 latency;
+
+      timings = gdk_frame_clock_get_timings (frame_clock, i);
+      if (timings == NULL ||
+          !gdk_frame_timings_get_complete (timings) ||
+          gdk_frame_timings_get_presentation_time (timings) == 0)
+        continue;
+
+      latency = gdk_frame_timings_get_presentation_time (timings) - gdk_frame_timings_get_frame_time (timings);
+      if (latency < 0)
+        continue;
+
+      sum += latency;
+      max = MAX (max, latency);
+      n++;
+    }
+
+  if (n == 0)
+    return FALSE;
+
+  *avg_ms = (double) sum / n / 1000.;
+  *max_ms = (double) max / 1000.;
+
+  return TRUE;
+}
+
 static gboolean
 gtk_fps_overlay_force_redraw (GtkWidget     *widget,
                               GdkFrameClock *clock,
@@ -92,8 +144,8 @@ gtk_fps_overlay_snapshot (GtkInspectorOverlay *overlay,
   PangoLayout *layout;
   PangoAttrList *attrs;
   gint64 now;
-  double fps;
-  char *fps_string;
+  double fps, latency_avg, latency_max;
+  GString *fps_string;
   graphene_rect_t bounds;
   gboolean has_bounds;
   int width, height;
@@ -132,10 +184,14 @@ gtk_fps_overlay_snapshot (GtkInspectorOverlay *overlay,
     }
 
   fps = gtk_fps_overlay_get_fps (widget);
+  fps_string = g_string_new (NULL);
   if (fps == 0.0)
-    fps_string = g_strdup ("--- fps");
+    g_string_append (fps_string, "--- fps");
   else
-    fps_string = g_strdup_printf ("%.2f fps", fps);
+    g_string_append_printf (fps_string, "%.2f fps", fps);
+
+  if (gtk_fps_overlay_get_latency (widget, &latency_avg, &latency_max))
+    g_string_append_printf (fps_string, "\n%.1f / %.1f ms latency", latency_avg, latency_max);
 
   if (GTK_IS_WINDOW (widget))
     {
@@ -151,7 +207,8 @@ gtk_fps_overlay_snapshot (GtkInspectorOverlay *overlay,
       has_bounds = gtk_widget_compute_bounds (widget, widget, &bounds);
     }
 
-  layout = gtk_widget_create_pango_layout (widget, fps_string);
+  layout = gtk_widget_create_pango_layout (widget, fps_string->str);
+  pango_layout_set_alignment (layout, PANGO_ALIGN_RIGHT);
   attrs = pango_attr_list_new ();
   pango_attr_list_insert (attrs, pango_attr_font_features_new ("tnum=1"));
   pango_layout_set_attributes (layout, attrs);
@@ -172,7 +229,7 @@ gtk_fps_overlay_snapshot (GtkInspectorOverlay *overlay,
   if (overlay_opacity < 1.0)
     gtk_snapshot_pop (snapshot);
   gtk_snapshot_restore (snapshot);
-  g_free (fps_string);
+  g_string_free (fps_string, TRUE);
 
   gtk_widget_add_tick_callback (widget, gtk_fps_overlay_force_redraw, NULL, NULL);
 }
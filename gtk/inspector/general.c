@@ -34,6 +34,7 @@
 #include "gtkbinlayout.h"
 #include "gtkmediafileprivate.h"
 #include "gtkimmoduleprivate.h"
+#include "gtkiconthemeprivate.h"
 
 #include "gdk/gdkdebugprivate.h"
 
@@ -90,6 +91,7 @@ struct _GtkInspectorGeneral
   GtkWidget *pango_fontmap;
   GtkWidget *media_backend;
   GtkWidget *im_module;
+  GtkWidget *icon_cache;
   GtkWidget *gl_version;
   GtkWidget *gl_error;
   GtkWidget *gl_error_row;
@@ -865,6 +867,28 @@ init_im_module (GtkInspectorGeneral *gen)
                            gen, 0);
 }
 
+/* The counters change all the time, so this is updated
+ * whenever the page is shown.
+ */
+static void
+update_icon_cache (GtkInspectorGeneral *gen)
+{
+  GtkIconCacheStats stats;
+  char *size, *budget, *text;
+
+  gtk_icon_theme_get_cache_stats (gtk_icon_theme_get_for_display (gen->display), &stats);
+
+  size = g_format_size (stats.size);
+  budget = g_format_size (stats.budget);
+  text = g_strdup_printf (_("%s of %s, %u hits, %u misses, %u evictions"),
+                          size, budget,
+                          stats.n_hits, stats.n_misses, stats.n_evictions);
+  gtk_label_set_label (GTK_LABEL (gen->icon_cache), text);
+
+  g_free (text);
+  g_free (budget);
+  g_free (size);
+}
 
 static void populate_seats (GtkInspectorGeneral *gen);
 
@@ -1145,6 +1169,17 @@ gtk_inspector_general_constructed (GObject *object)
    g_signal_connect (gen->device_box, "keynav-failed", G_CALLBACK (keynav_failed), gen);
 }
 
+static void
+gtk_inspector_general_map (GtkWidget *widget)
+{
+  GtkInspectorGeneral *gen = GTK_INSPECTOR_GENERAL (widget);
+
+  GTK_WIDGET_CLASS (gtk_inspector_general_parent_class)->map (widget);
+
+  if (gen->display)
+    update_icon_cache (gen);
+}
+
 static void
 gtk_inspector_general_dispose (GObject *object)
 {
@@ -1175,6 +1210,8 @@ gtk_inspector_general_class_init (GtkInspectorGeneralClass *klass)
   object_class->constructed = gtk_inspector_general_constructed;
   object_class->dispose = gtk_inspector_general_dispose;
 
+  widget_class->map = gtk_inspector_general_map;
+
   gtk_widget_class_set_template_from_resource (widget_class, "/org/gtk/libgtk/inspector/general.ui");
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, swin);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, box);
@@ -1190,6 +1227,7 @@ gtk_inspector_general_class_init (GtkInspectorGeneralClass *klass)
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, pango_fontmap);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, media_backend);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, im_module);
+  gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, icon_cache);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, gl_version);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, gl_error);
   gtk_widget_class_bind_template_child (widget_class, GtkInspectorGeneral, gl_error_row);
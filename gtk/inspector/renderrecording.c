@@ -56,6 +56,7 @@ collect_profiler_info (GtkInspectorRenderRecording *recording,
   string = g_string_new (NULL);
   gsk_profiler_append_timers (profiler, string);
   gsk_profiler_append_counters (profiler, string);
+  gsk_profiler_append_details (profiler, string);
   recording->profiler_info = g_string_free (string, FALSE);
 }
 
@@ -37,6 +37,8 @@
 #include "gtksortlistmodel.h"
 #include "gtksearchentry.h"
 
+#include "gsk/gskgpumemoryprivate.h"
+
 #include <glib/gi18n-lib.h>
 
 /* {{{ TypeData object */
@@ -61,6 +63,7 @@ enum {
   TYPE_DATA_PROP_CUMULATIVE2,
   TYPE_DATA_PROP_SELF,
   TYPE_DATA_PROP_CUMULATIVE,
+  TYPE_DATA_PROP_MEMORY,
 };
 
 G_DEFINE_TYPE (TypeData, type_data, G_TYPE_OBJECT);
@@ -81,6 +84,24 @@ type_data_finalize (GObject *object)
   G_OBJECT_CLASS (type_data_parent_class)->finalize (object);
 }
 
+/* The size of an instance, including the private data of all its types */
+static gsize
+type_data_get_instance_size (TypeData *self)
+{
+  GTypeQuery query;
+  gpointer klass;
+  gsize size;
+
+  g_type_query (self->type, &query);
+  size = query.instance_size;
+
+  klass = g_type_class_peek (self->type);
+  if (klass)
+    size += -g_type_class_get_instance_private_offset (klass);
+
+  return size;
+}
+
 static void
 type_data_get_property (GObject    *object,
                         guint       property_id,
@@ -119,6 +140,10 @@ type_data_get_property (GObject    *object,
       g_value_set_object (value, self->cumulative);
       break;
 
+    case TYPE_DATA_PROP_MEMORY:
+      g_value_set_uint64 (value, (guint64) graph_data_get_value (self->self, 0) * type_data_get_instance_size (self));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, property_id, pspec);
       break;
@@ -181,6 +206,13 @@ type_data_class_init (TypeDataClass *class)
                                                         graph_data_get_type (),
                                                         G_PARAM_READABLE |
                                                         G_PARAM_STATIC_STRINGS));
+
+  g_object_class_install_property (object_class,
+                                   TYPE_DATA_PROP_MEMORY,
+                                   g_param_spec_uint64 ("memory", NULL, NULL,
+                                                        0, G_MAXUINT64, 0,
+                                                        G_PARAM_READABLE |
+                                                        G_PARAM_STATIC_STRINGS));
 }
 
 static TypeData *
@@ -208,7 +240,10 @@ type_data_update (TypeData *data,
 
   value = graph_data_get_value (data->self, 0);
   if (value != self)
-    g_object_notify (G_OBJECT (data), "self2");
+    {
+      g_object_notify (G_OBJECT (data), "self2");
+      g_object_notify (G_OBJECT (data), "memory");
+    }
   if (value != graph_data_get_value (data->self, 1))
     g_object_notify (G_OBJECT (data), "self1");
 
@@ -247,6 +282,8 @@ struct _GtkInspectorStatisticsPrivate
   guint update_source_id;
   GtkWidget *search_entry;
   GtkWidget *search_bar;
+  GtkWidget *gpu_memory;
+  guint gpu_memory_source_id;
 };
 
 G_DEFINE_TYPE_WITH_PRIVATE (GtkInspectorStatistics, gtk_inspector_statistics, GTK_TYPE_BOX)
@@ -307,6 +344,38 @@ update_type_counts (gpointer data)
   return TRUE;
 }
 
+static gboolean
+update_gpu_memory (gpointer data)
+{
+  GtkInspectorStatistics *sl = data;
+  GString *string;
+  gsize total = 0;
+  char *size;
+
+  string = g_string_new (NULL);
+
+  for (guint i = 0; i < GSK_GPU_MEMORY_N_CATEGORIES; i++)
+    {
+      gsize value = gsk_gpu_memory_get (i);
+
+      size = g_format_size (value);
+      g_string_append_printf (string, ", %s: %s", gsk_gpu_memory_get_category_name (i), size);
+      g_free (size);
+
+      total += value;
+    }
+
+  size = g_format_size (total);
+  g_string_prepend (string, size);
+  g_string_prepend (string, _("GPU memory: "));
+  g_free (size);
+
+  gtk_label_set_text (GTK_LABEL (sl->priv->gpu_memory), string->str);
+  g_string_free (string, TRUE);
+
+  return G_SOURCE_CONTINUE;
+}
+
 static void
 toggle_record (GtkToggleButton        *button,
                GtkInspectorStatistics *sl)
@@ -613,6 +682,47 @@ setup_graph (GtkSignalListItemFactory *factory,
   gtk_list_item_set_child (list_item, GTK_WIDGET (graph_renderer_new ()));
 }
 
+static void
+set_memory (TypeData   *data,
+            GParamSpec *pspec,
+            GtkWidget  *label)
+{
+  guint64 memory;
+  char *text;
+
+  g_object_get (data, "memory", &memory, NULL);
+  text = g_format_size (memory);
+  gtk_label_set_text (GTK_LABEL (label), text);
+  g_free (text);
+}
+
+static void
+bind_memory (GtkSignalListItemFactory *factory,
+             GtkListItem              *list_item)
+{
+  GtkWidget *label;
+  TypeData *data;
+
+  label = gtk_list_item_get_child (list_item);
+  data = gtk_list_item_get_item (list_item);
+
+  set_memory (data, NULL, label);
+  g_signal_connect (data, "notify::memory", G_CALLBACK (set_memory), label);
+}
+
+static void
+unbind_memory (GtkSignalListItemFactory *factory,
+               GtkListItem              *list_item)
+{
+  GtkWidget *label;
+  TypeData *data;
+
+  label = gtk_list_item_get_child (list_item);
+  data = gtk_list_item_get_item (list_item);
+
+  g_signal_handlers_disconnect_by_func (data, G_CALLBACK (set_memory), label);
+}
+
 static void
 set_graph_self (TypeData   *data,
                 GParamSpec *pspec,
@@ -778,6 +888,20 @@ gtk_inspector_statistics_init (GtkInspectorStatistics *sl)
 
   column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (sl->priv->view)), 5);
 
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_memory), NULL);
+  g_signal_connect (factory, "unbind", G_CALLBACK (unbind_memory), NULL);
+
+  gtk_column_view_column_set_factory (column, factory);
+  sorter = GTK_SORTER (gtk_numeric_sorter_new (gtk_property_expression_new (type_data_get_type (), NULL, "memory")));
+  gtk_column_view_column_set_sorter (column, sorter);
+  g_object_unref (sorter);
+  g_object_unref (factory);
+  g_object_unref (column);
+
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (sl->priv->view)), 6);
+
   factory = gtk_signal_list_item_factory_new ();
   g_signal_connect (factory, "setup", G_CALLBACK (setup_graph), NULL);
   g_signal_connect (factory, "bind", G_CALLBACK (bind_graph_self), NULL);
@@ -787,7 +911,7 @@ gtk_inspector_statistics_init (GtkInspectorStatistics *sl)
   g_object_unref (factory);
   g_object_unref (column);
 
-  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (sl->priv->view)), 6);
+  column = g_list_model_get_item (gtk_column_view_get_columns (GTK_COLUMN_VIEW (sl->priv->view)), 7);
 
   factory = gtk_signal_list_item_factory_new ();
   g_signal_connect (factory, "setup", G_CALLBACK (setup_graph), NULL);
@@ -806,6 +930,9 @@ constructed (GObject *object)
 
   g_signal_connect (sl->priv->button, "toggled", G_CALLBACK (toggle_record), sl);
 
+  update_gpu_memory (sl);
+  sl->priv->gpu_memory_source_id = g_timeout_add_seconds (1, update_gpu_memory, sl);
+
   if (has_instance_counts ())
     update_type_counts (sl);
   else
@@ -824,6 +951,7 @@ finalize (GObject *object)
 
   if (sl->priv->update_source_id)
     g_source_remove (sl->priv->update_source_id);
+  g_source_remove (sl->priv->gpu_memory_source_id);
 
   g_hash_table_unref (sl->priv->types);
 
@@ -894,6 +1022,7 @@ gtk_inspector_statistics_class_init (GtkInspectorStatisticsClass *klass)
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, search_entry);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, search_bar);
   gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, excuse);
+  gtk_widget_class_bind_template_child_private (widget_class, GtkInspectorStatistics, gpu_memory);
   gtk_widget_class_bind_template_callback (widget_class, search_changed);
 }
 
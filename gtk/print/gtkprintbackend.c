@@ -80,18 +80,22 @@ gtk_print_backend_error_quark (void)
   return quark;
 }
 
-void
-gtk_print_backends_init (void)
+/* Scanning the module directories is deferred until a print
+ * backend is needed, most processes never print.
+ */
+static void
+gtk_print_backends_ensure_modules (void)
 {
+  static gsize scanned = 0;
   GIOExtensionPoint *ep;
   GIOModuleScope *scope;
   char **paths;
   int i;
 
-  GTK_DEBUG (MODULES, "Registering extension point %s", GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
+  if (!g_once_init_enter (&scanned))
+    return;
 
-  ep = g_io_extension_point_register (GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
-  g_io_extension_point_set_required_type (ep, GTK_TYPE_PRINT_BACKEND);
+  ep = g_io_extension_point_lookup (GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
 
   scope = g_io_module_scope_new (G_IO_MODULE_SCOPE_BLOCK_DUPLICATES);
 
@@ -118,6 +122,22 @@ gtk_print_backends_init (void)
                    g_type_name (g_io_extension_get_type (ext)));
         }
     }
+
+  g_once_init_leave (&scanned, 1);
+}
+
+void
+gtk_print_backends_init (void)
+{
+  GIOExtensionPoint *ep;
+
+  GTK_DEBUG (MODULES, "Registering extension point %s", GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
+
+  ep = g_io_extension_point_register (GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
+  g_io_extension_point_set_required_type (ep, GTK_TYPE_PRINT_BACKEND);
+
+  if (GTK_DEBUG_CHECK (MODULES))
+    gtk_print_backends_ensure_modules ();
 }
 
 /**
@@ -138,6 +158,7 @@ gtk_print_backend_load_modules (void)
 
   result = NULL;
 
+  gtk_print_backends_ensure_modules ();
   ep = g_io_extension_point_lookup (GTK_PRINT_BACKEND_EXTENSION_POINT_NAME);
 
   settings = gtk_settings_get_default ();
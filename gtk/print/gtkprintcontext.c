@@ -540,6 +540,17 @@ _gtk_print_context_set_hard_margins (GtkPrintContext *context,
   context->has_hard_margins   = TRUE;
 }
 
+void
+_gtk_print_context_copy_hard_margins (GtkPrintContext *context,
+				      GtkPrintContext *source)
+{
+  context->hard_margin_top    = source->hard_margin_top;
+  context->hard_margin_bottom = source->hard_margin_bottom;
+  context->hard_margin_left   = source->hard_margin_left;
+  context->hard_margin_right  = source->hard_margin_right;
+  context->has_hard_margins   = source->has_hard_margins;
+}
+
 /**
  * gtk_print_context_get_pango_fontmap:
  * @context: a `GtkPrintContext`
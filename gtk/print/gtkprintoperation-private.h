@@ -54,6 +54,7 @@ struct _GtkPrintOperationPrivate
   guint support_selection  : 1;
   guint has_selection      : 1;
   guint embed_page_setup   : 1;
+  guint parallel_drawing   : 1;
 
   GtkPageDrawingState      page_drawing_state;
 
@@ -143,6 +144,8 @@ void             _gtk_print_context_set_hard_margins                (GtkPrintCon
 								     double             bottom,
 								     double             left,
 								     double             right);
+void             _gtk_print_context_copy_hard_margins               (GtkPrintContext   *context,
+								     GtkPrintContext   *source);
 
 G_END_DECLS
 
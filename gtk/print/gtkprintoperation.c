@@ -138,20 +138,25 @@ enum
   PROP_EMBED_PAGE_SETUP,
   PROP_HAS_SELECTION,
   PROP_SUPPORT_SELECTION,
-  PROP_N_PAGES_TO_PRINT
+  PROP_N_PAGES_TO_PRINT,
+  PROP_PARALLEL_DRAWING
 };
 
 static guint signals[LAST_SIGNAL] = { 0 };
 static int job_nr = 0;
 typedef struct _PrintPagesData PrintPagesData;
+typedef struct _PrintPagesThreads PrintPagesThreads;
+typedef struct _PrintPageJob PrintPageJob;
 
 static void          preview_iface_init      (GtkPrintOperationPreviewIface *iface);
 static GtkPageSetup *create_page_setup       (GtkPrintOperation             *op);
 static void          common_render_page      (GtkPrintOperation             *op,
-					      int                            page_nr);
+					      int                            page_nr,
+					      PrintPageJob                  *job);
 static void          increment_page_sequence (PrintPagesData *data);
 static void          prepare_data            (PrintPagesData *data);
 static void          clamp_page_ranges       (PrintPagesData *data);
+static void          stop_page_threads       (PrintPagesData *data);
 
 
 G_DEFINE_TYPE_WITH_CODE (GtkPrintOperation, gtk_print_operation, G_TYPE_OBJECT,
@@ -261,7 +266,7 @@ preview_iface_render_page (GtkPrintOperationPreview *preview,
   GtkPrintOperation *op;
 
   op = GTK_PRINT_OPERATION (preview);
-  common_render_page (op, page_nr);
+  common_render_page (op, page_nr, NULL);
 }
 
 static void
@@ -417,6 +422,9 @@ gtk_print_operation_set_property (GObject      *object,
     case PROP_SUPPORT_SELECTION:
       gtk_print_operation_set_support_selection (op, g_value_get_boolean (value));
       break;
+    case PROP_PARALLEL_DRAWING:
+      gtk_print_operation_set_parallel_drawing (op, g_value_get_boolean (value));
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -488,6 +496,9 @@ gtk_print_operation_get_property (GObject    *object,
     case PROP_N_PAGES_TO_PRINT:
       g_value_set_int (value, priv->nr_of_pages_to_print);
       break;
+    case PROP_PARALLEL_DRAWING:
+      g_value_set_boolean (value, priv->parallel_drawing);
+      break;
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -517,6 +528,46 @@ struct _PrintPagesData
   gboolean initialized;
   gboolean is_preview;
   gboolean done;
+
+  PrintPagesThreads *threads;
+};
+
+/* With parallel drawing, the pages that come next in the page
+ * sequence are drawn into recording surfaces by a thread pool,
+ * and replayed into the real cairo context in order.
+ */
+struct _PrintPagesThreads
+{
+  GThreadPool *pool;
+  GMutex lock;
+  GCond cond;
+
+  /* jobs in the order of the page sequence, the head
+   * is the page that is printed next
+   */
+  GQueue jobs;
+  guint max_jobs;
+
+  /* the page sequence, ahead of the one being printed */
+  PrintPagesData sequence;
+  int page_position;
+};
+
+struct _PrintPageJob
+{
+  PrintPagesThreads *threads;
+  GtkPrintOperation *op;
+  int page_nr;
+  GtkPageSetup *page_setup;
+  GtkPrintContext *print_context;
+  cairo_surface_t *surface;
+  /* the unit scale of print_context, which is already
+   * applied to the cairo context of the operation
+   */
+  cairo_matrix_t matrix;
+
+  gboolean done; /* protected by the lock */
+  int cancelled; /* atomic */
 };
 
 typedef struct
@@ -1380,6 +1431,21 @@ gtk_print_operation_class_init (GtkPrintOperationClass *class)
 						     G_MAXINT,
 						     -1,
 						     G_PARAM_READABLE|G_PARAM_EXPLICIT_NOTIFY));
+
+  /**
+   * GtkPrintOperation:parallel-drawing: (attributes org.gtk.Property.get=gtk_print_operation_get_parallel_drawing org.gtk.Property.set=gtk_print_operation_set_parallel_drawing)
+   *
+   * If %TRUE, pages are drawn in worker threads.
+   *
+   * See [method@Gtk.PrintOperation.set_parallel_drawing].
+   *
+   * Since: 4.14
+   */
+  g_object_class_install_property (gobject_class,
+				   PROP_PARALLEL_DRAWING,
+				   g_param_spec_boolean ("parallel-drawing", NULL, NULL,
+							 FALSE,
+							 G_PARAM_READWRITE|G_PARAM_EXPLICIT_NOTIFY));
 }
 
 /**
@@ -2205,6 +2271,8 @@ print_pages_idle_done (gpointer user_data)
 
   priv->print_pages_idle_id = 0;
 
+  stop_page_threads (data);
+
   if (priv->show_progress_timeout_id > 0)
     {
       g_source_remove (priv->show_progress_timeout_id);
@@ -2360,9 +2428,92 @@ gtk_print_operation_draw_page_finish (GtkPrintOperation *op)
   priv->page_drawing_state = GTK_PAGE_DRAWING_STATE_READY;
 }
 
+static void
+print_page_job_free (PrintPageJob *job)
+{
+  g_object_unref (job->page_setup);
+  g_object_unref (job->print_context);
+  cairo_surface_destroy (job->surface);
+  g_free (job);
+}
+
+static void
+draw_page_thread (gpointer job_data,
+                  gpointer user_data)
+{
+  PrintPageJob *job = job_data;
+  PrintPagesThreads *threads = job->threads;
+
+  if (!g_atomic_int_get (&job->cancelled))
+    g_signal_emit (job->op, signals[DRAW_PAGE], 0,
+                   job->print_context, job->page_nr);
+
+  g_mutex_lock (&threads->lock);
+  job->done = TRUE;
+  g_cond_broadcast (&threads->cond);
+  g_mutex_unlock (&threads->lock);
+}
+
+static void
+queue_page_job (PrintPagesData *data,
+                int             page_nr)
+{
+  GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (data->op);
+  PrintPagesThreads *threads = data->threads;
+  PrintPageJob *job;
+  cairo_t *cr;
+
+  job = g_new0 (PrintPageJob, 1);
+  job->threads = threads;
+  job->op = data->op;
+  job->page_nr = page_nr;
+
+  job->page_setup = create_page_setup (data->op);
+  g_signal_emit (data->op, signals[REQUEST_PAGE_SETUP], 0,
+                 priv->print_context, page_nr, job->page_setup);
+
+  job->print_context = _gtk_print_context_new (data->op);
+  _gtk_print_context_set_page_setup (job->print_context, job->page_setup);
+  _gtk_print_context_copy_hard_margins (job->print_context, priv->print_context);
+
+  job->surface = cairo_recording_surface_create (CAIRO_CONTENT_COLOR_ALPHA, NULL);
+  cr = cairo_create (job->surface);
+  gtk_print_context_set_cairo_context (job->print_context, cr,
+                                       gtk_print_context_get_dpi_x (priv->print_context),
+                                       gtk_print_context_get_dpi_y (priv->print_context));
+  cairo_get_matrix (cr, &job->matrix);
+  cairo_destroy (cr);
+
+  g_queue_push_tail (&threads->jobs, job);
+  g_thread_pool_push (threads->pool, job, NULL);
+}
+
+static void
+replay_page_job (PrintPageJob *job,
+                 cairo_t      *cr)
+{
+  PrintPagesThreads *threads = job->threads;
+  cairo_matrix_t matrix;
+
+  g_mutex_lock (&threads->lock);
+  while (!job->done)
+    g_cond_wait (&threads->cond, &threads->lock);
+  g_mutex_unlock (&threads->lock);
+
+  /* The recording already contains the unit scale */
+  cairo_save (cr);
+  matrix = job->matrix;
+  if (cairo_matrix_invert (&matrix) == CAIRO_STATUS_SUCCESS)
+    cairo_transform (cr, &matrix);
+  cairo_set_source_surface (cr, job->surface, 0, 0);
+  cairo_paint (cr);
+  cairo_restore (cr);
+}
+
 static void
 common_render_page (GtkPrintOperation *op,
-		    int                page_nr)
+		    int                page_nr,
+		    PrintPageJob      *job)
 {
   GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (op);
   GtkPageSetup *page_setup;
@@ -2370,12 +2521,20 @@ common_render_page (GtkPrintOperation *op,
   cairo_t *cr;
 
   print_context = priv->print_context;
-  
-  page_setup = create_page_setup (op);
-  
-  g_signal_emit (op, signals[REQUEST_PAGE_SETUP], 0, 
-		 print_context, page_nr, page_setup);
-  
+
+  if (job)
+    {
+      /* The page setup was requested when the job was queued */
+      page_setup = g_object_ref (job->page_setup);
+    }
+  else
+    {
+      page_setup = create_page_setup (op);
+
+      g_signal_emit (op, signals[REQUEST_PAGE_SETUP], 0,
+                     print_context, page_nr, page_setup);
+    }
+
   _gtk_print_context_set_page_setup (print_context, page_setup);
   
   priv->start_page (op, print_context, page_setup);
@@ -2580,8 +2739,11 @@ common_render_page (GtkPrintOperation *op,
   
   priv->page_drawing_state = GTK_PAGE_DRAWING_STATE_DRAWING;
 
-  g_signal_emit (op, signals[DRAW_PAGE], 0, 
-		 print_context, page_nr);
+  if (job)
+    replay_page_job (job, cr);
+  else
+    g_signal_emit (op, signals[DRAW_PAGE], 0,
+                   print_context, page_nr);
 
   if (priv->page_drawing_state == GTK_PAGE_DRAWING_STATE_DRAWING)
     gtk_print_operation_draw_page_finish (op);
@@ -2754,6 +2916,105 @@ prepare_data (PrintPagesData *data)
                                    NULL);
 }
 
+/* Advances the copy of the page sequence in @threads. The page
+ * sequence uses the page position of the operation, so that is
+ * swapped while doing so.
+ */
+static gboolean
+advance_page_sequence (PrintPagesThreads *threads)
+{
+  GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (threads->sequence.op);
+  int page_position;
+
+  if (threads->sequence.done)
+    return FALSE;
+
+  page_position = priv->page_position;
+  priv->page_position = threads->page_position;
+  increment_page_sequence (&threads->sequence);
+  threads->page_position = priv->page_position;
+  priv->page_position = page_position;
+
+  return !threads->sequence.done;
+}
+
+static void
+start_page_threads (PrintPagesData *data)
+{
+  GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (data->op);
+  PrintPagesThreads *threads;
+  guint n_threads;
+
+  n_threads = MAX (g_get_num_processors (), 1);
+
+  threads = g_new0 (PrintPagesThreads, 1);
+  g_mutex_init (&threads->lock);
+  g_cond_init (&threads->cond);
+  g_queue_init (&threads->jobs);
+  /* Limit the number of recordings that are kept around */
+  threads->max_jobs = 2 * n_threads;
+  threads->pool = g_thread_pool_new (draw_page_thread, NULL, n_threads, FALSE, NULL);
+
+  threads->sequence = *data;
+  threads->sequence.threads = NULL;
+  threads->page_position = priv->page_position;
+
+  data->threads = threads;
+}
+
+static void
+stop_page_threads (PrintPagesData *data)
+{
+  PrintPagesThreads *threads = data->threads;
+  GList *l;
+
+  if (threads == NULL)
+    return;
+
+  for (l = threads->jobs.head; l; l = l->next)
+    {
+      PrintPageJob *job = l->data;
+
+      g_atomic_int_set (&job->cancelled, TRUE);
+    }
+
+  /* Waits for the jobs that are still queued */
+  g_thread_pool_free (threads->pool, FALSE, TRUE);
+
+  g_queue_clear_full (&threads->jobs, (GDestroyNotify) print_page_job_free);
+  g_mutex_clear (&threads->lock);
+  g_cond_clear (&threads->cond);
+  g_free (threads);
+
+  data->threads = NULL;
+}
+
+static void
+render_page_threaded (PrintPagesData *data)
+{
+  PrintPagesThreads *threads;
+  PrintPageJob *job;
+
+  if (data->threads == NULL)
+    {
+      start_page_threads (data);
+      queue_page_job (data, data->page);
+    }
+
+  threads = data->threads;
+
+  while (threads->jobs.length < threads->max_jobs &&
+         advance_page_sequence (threads))
+    queue_page_job (data, threads->sequence.page);
+
+  job = g_queue_pop_head (&threads->jobs);
+  g_assert (job->page_nr == data->page);
+
+  common_render_page (data->op, data->page, job);
+
+  print_page_job_free (job);
+}
+
 static gboolean
 print_pages_idle (gpointer user_data)
 {
@@ -2780,7 +3041,12 @@ print_pages_idle (gpointer user_data)
       increment_page_sequence (data);
 
       if (!data->done)
-        common_render_page (data->op, data->page);
+        {
+          if (priv->parallel_drawing)
+            render_page_threaded (data);
+          else
+            common_render_page (data->op, data->page, NULL);
+        }
       else
         done = priv->page_drawing_state == GTK_PAGE_DRAWING_STATE_READY;
 
@@ -2796,6 +3062,7 @@ print_pages_idle (gpointer user_data)
 
       if (done && !data->is_preview)
         {
+          stop_page_threads (data);
           g_signal_emit (data->op, signals[END_PRINT], 0, priv->print_context);
           priv->end_run (data->op, priv->is_sync, priv->cancelled);
         }
@@ -3278,3 +3545,61 @@ gtk_print_operation_get_n_pages_to_print (GtkPrintOperation *op)
 
   return priv->nr_of_pages_to_print;
 }
+
+/**
+ * gtk_print_operation_set_parallel_drawing: (attributes org.gtk.Method.set_property=parallel-drawing)
+ * @op: a `GtkPrintOperation`
+ * @parallel_drawing: %TRUE to draw pages in worker threads
+ *
+ * Sets whether pages are drawn in worker threads.
+ *
+ * When printing or exporting, the [signal@Gtk.PrintOperation::draw-page]
+ * signal is then emitted in worker threads for several pages at once,
+ * each with its own `GtkPrintContext` that records the drawing. The
+ * recordings are added to the output in order. The
+ * [signal@Gtk.PrintOperation::request-page-setup] signal is still
+ * emitted in the main thread, but before the page is drawn.
+ *
+ * Only use this if the handlers of the ::draw-page signal are
+ * thread-safe. They must not call
+ * [method@Gtk.PrintOperation.set_defer_drawing].
+ *
+ * Previews are always drawn in the main thread.
+ *
+ * Since: 4.14
+ */
+void
+gtk_print_operation_set_parallel_drawing (GtkPrintOperation *op,
+                                          gboolean           parallel_drawing)
+{
+  GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (op);
+
+  g_return_if_fail (GTK_IS_PRINT_OPERATION (op));
+
+  parallel_drawing = parallel_drawing != FALSE;
+  if (priv->parallel_drawing != parallel_drawing)
+    {
+      priv->parallel_drawing = parallel_drawing;
+      g_object_notify (G_OBJECT (op), "parallel-drawing");
+    }
+}
+
+/**
+ * gtk_print_operation_get_parallel_drawing: (attributes org.gtk.Method.get_property=parallel-drawing)
+ * @op: a `GtkPrintOperation`
+ *
+ * Gets whether pages are drawn in worker threads.
+ *
+ * Returns: whether pages are drawn in worker threads
+ *
+ * Since: 4.14
+ */
+gboolean
+gtk_print_operation_get_parallel_drawing (GtkPrintOperation *op)
+{
+  GtkPrintOperationPrivate *priv = gtk_print_operation_get_instance_private (op);
+
+  g_return_val_if_fail (GTK_IS_PRINT_OPERATION (op), FALSE);
+
+  return priv->parallel_drawing;
+}
@@ -35,6 +35,12 @@ struct _GtkGstPaintable
   double pixel_aspect_ratio;
 
   GdkGLContext *context;
+
+  /* Written from the streaming thread */
+  GMutex pending_lock;
+  GdkTexture *pending_texture;
+  double pending_pixel_aspect_ratio;
+  gboolean pending_scheduled;
 };
 
 struct _GtkGstPaintableClass
@@ -173,20 +179,36 @@ gtk_gst_paintable_dispose (GObject *object)
   
   g_clear_object (&self->image);
 
+  g_mutex_lock (&self->pending_lock);
+  g_clear_object (&self->pending_texture);
+  g_mutex_unlock (&self->pending_lock);
+
   G_OBJECT_CLASS (gtk_gst_paintable_parent_class)->dispose (object);
 }
 
+static void
+gtk_gst_paintable_finalize (GObject *object)
+{
+  GtkGstPaintable *self = GTK_GST_PAINTABLE (object);
+
+  g_mutex_clear (&self->pending_lock);
+
+  G_OBJECT_CLASS (gtk_gst_paintable_parent_class)->finalize (object);
+}
+
 static void
 gtk_gst_paintable_class_init (GtkGstPaintableClass *klass)
 {
   GObjectClass *object_class = G_OBJECT_CLASS (klass);
 
   object_class->dispose = gtk_gst_paintable_dispose;
+  object_class->finalize = gtk_gst_paintable_finalize;
 }
 
 static void
 gtk_gst_paintable_init (GtkGstPaintable *self)
 {
+  g_mutex_init (&self->pending_lock);
 }
 
 GdkPaintable *
@@ -264,51 +286,58 @@ gtk_gst_paintable_set_paintable (GtkGstPaintable *self,
   gdk_paintable_invalidate_contents (GDK_PAINTABLE (self));
 }
 
-typedef struct _SetTextureInvocation SetTextureInvocation;
-
-struct _SetTextureInvocation {
-  GtkGstPaintable *paintable;
-  GdkTexture      *texture;
-  double           pixel_aspect_ratio;
-};
-
-static void
-set_texture_invocation_free (SetTextureInvocation *invoke)
-{
-  g_object_unref (invoke->paintable);
-  g_object_unref (invoke->texture);
-
-  g_free (invoke);
-}
-
 static gboolean
 gtk_gst_paintable_set_texture_invoke (gpointer data)
 {
-  SetTextureInvocation *invoke = data;
+  GtkGstPaintable *self = data;
+  GdkTexture *texture;
+  double pixel_aspect_ratio;
 
-  gtk_gst_paintable_set_paintable (invoke->paintable,
-                                   GDK_PAINTABLE (invoke->texture),
-                                   invoke->pixel_aspect_ratio);
+  g_mutex_lock (&self->pending_lock);
+  texture = g_steal_pointer (&self->pending_texture);
+  pixel_aspect_ratio = self->pending_pixel_aspect_ratio;
+  self->pending_scheduled = FALSE;
+  g_mutex_unlock (&self->pending_lock);
+
+  if (texture)
+    {
+      gtk_gst_paintable_set_paintable (self,
+                                       GDK_PAINTABLE (texture),
+                                       pixel_aspect_ratio);
+      g_object_unref (texture);
+    }
 
   return G_SOURCE_REMOVE;
 }
 
+/* Called from the streaming thread when a frame is due. The
+ * texture wraps the mapped frame, so it is handed over as is.
+ *
+ * If the main loop is busy, frames that arrive before the previous
+ * one was shown replace it, so the paintable always shows the most
+ * recent frame instead of working through a backlog of stale ones.
+ */
 void
 gtk_gst_paintable_queue_set_texture (GtkGstPaintable *self,
                                      GdkTexture      *texture,
                                      double           pixel_aspect_ratio)
 {
-  SetTextureInvocation *invoke;
-
-  invoke = g_new0 (SetTextureInvocation, 1);
-  invoke->paintable = g_object_ref (self);
-  invoke->texture = g_object_ref (texture);
-  invoke->pixel_aspect_ratio = pixel_aspect_ratio;
-
-  g_main_context_invoke_full (NULL,
-                              G_PRIORITY_DEFAULT,
-                              gtk_gst_paintable_set_texture_invoke,
-                              invoke,
-                              (GDestroyNotify) set_texture_invocation_free);
-}
+  gboolean schedule;
+
+  g_mutex_lock (&self->pending_lock);
+
+  g_set_object (&self->pending_texture, texture);
+  self->pending_pixel_aspect_ratio = pixel_aspect_ratio;
 
+  schedule = !self->pending_scheduled;
+  self->pending_scheduled = TRUE;
+
+  g_mutex_unlock (&self->pending_lock);
+
+  if (schedule)
+    g_main_context_invoke_full (NULL,
+                                G_PRIORITY_DEFAULT,
+                                gtk_gst_paintable_set_texture_invoke,
+                                g_object_ref (self),
+                                g_object_unref);
+}
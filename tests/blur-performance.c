@@ -2,6 +2,8 @@
 
 #include <gsk/gskcairoblurprivate.h>
 
+#include <string.h>
+
 static void
 init_surface (cairo_t *cr)
 {
@@ -16,6 +18,69 @@ init_surface (cairo_t *cr)
   cairo_fill (cr);
 }
 
+static const struct {
+  const char *name;
+  GskBlurFlags flags;
+} variants[] = {
+  { "scalar", GSK_BLUR_NO_SIMD | GSK_BLUR_NO_THREADS },
+  { "simd", GSK_BLUR_NO_THREADS },
+  { "threaded", 0 },
+};
+
+static const struct {
+  const char *name;
+  GskBlurFlags flags;
+} directions[] = {
+  { "x+y", GSK_BLUR_X | GSK_BLUR_Y },
+  { "x", GSK_BLUR_X },
+  { "y", GSK_BLUR_Y },
+};
+
+static gboolean
+check_same_result (int          size,
+                   int          radius,
+                   GskBlurFlags flags)
+{
+  cairo_surface_t *expected = NULL;
+  gboolean result = TRUE;
+  guint v;
+
+  for (v = 0; v < G_N_ELEMENTS (variants); v++)
+    {
+      cairo_surface_t *surface;
+      cairo_t *cr;
+
+      surface = cairo_image_surface_create (CAIRO_FORMAT_A8, size, size);
+      cr = cairo_create (surface);
+      init_surface (cr);
+      cairo_destroy (cr);
+
+      gsk_cairo_blur_surface (surface, radius, flags | variants[v].flags);
+      cairo_surface_flush (surface);
+
+      if (expected == NULL)
+        {
+          expected = surface;
+          continue;
+        }
+
+      if (memcmp (cairo_image_surface_get_data (surface),
+                  cairo_image_surface_get_data (expected),
+                  cairo_image_surface_get_stride (surface) * size) != 0)
+        {
+          g_print ("Size %d, radius %d: %s result differs from %s\n",
+                   size, radius, variants[v].name, variants[0].name);
+          result = FALSE;
+        }
+
+      cairo_surface_destroy (surface);
+    }
+
+  cairo_surface_destroy (expected);
+
+  return result;
+}
+
 int
 main (int argc, char **argv)
 {
@@ -23,8 +88,22 @@ main (int argc, char **argv)
   cairo_t *cr;
   GTimer *timer;
   double msec;
+  guint v, dir;
   int i, j;
   int size;
+  gboolean success = TRUE;
+
+  /* Make sure all implementations agree, including sizes that
+   * are not multiples of the SIMD width and large radii
+   */
+  for (i = 2; i < 150; i += 13)
+    {
+      success &= check_same_result (15, i, GSK_BLUR_X | GSK_BLUR_Y);
+      success &= check_same_result (123, i, GSK_BLUR_X | GSK_BLUR_Y);
+      success &= check_same_result (123, i, GSK_BLUR_X);
+      success &= check_same_result (123, i, GSK_BLUR_Y);
+      success &= check_same_result (1000, i, GSK_BLUR_X | GSK_BLUR_Y);
+    }
 
   timer = g_timer_new ();
 
@@ -34,21 +113,31 @@ main (int argc, char **argv)
 
   cr = cairo_create (surface);
 
-  /* We do everything three times, first two as warmup */
-  for (j = 0; j < 2; j++)
+  for (v = 0; v < G_N_ELEMENTS (variants); v++)
     {
-      for (i = 1; i < 16; i++)
-	{
-	  init_surface (cr);
-	  g_timer_start (timer);
-	  gsk_cairo_blur_surface (surface, i, GSK_BLUR_X | GSK_BLUR_Y);
-	  msec = g_timer_elapsed (timer, NULL) * 1000;
-	  if (j == 1)
-	    g_print ("Radius %2d: %.2f msec, %.2f kpixels/msec:\n", i, msec, size*size/(msec*1000));
-	}
+      for (dir = 0; dir < G_N_ELEMENTS (directions); dir++)
+        {
+          g_print ("%s, %s:\n", variants[v].name, directions[dir].name);
+
+          /* We do everything twice, first as warmup */
+          for (j = 0; j < 2; j++)
+            {
+              for (i = 1; i < 16; i++)
+                {
+                  init_surface (cr);
+                  g_timer_start (timer);
+                  gsk_cairo_blur_surface (surface, i, directions[dir].flags | variants[v].flags);
+                  msec = g_timer_elapsed (timer, NULL) * 1000;
+                  if (j == 1)
+                    g_print ("Radius %2d: %.2f msec, %.2f kpixels/msec:\n", i, msec, size*size/(msec*1000));
+                }
+            }
+        }
     }
 
+  cairo_destroy (cr);
+  cairo_surface_destroy (surface);
   g_timer_destroy (timer);
 
-  return 0;
+  return success ? 0 : 1;
 }
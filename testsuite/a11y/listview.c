@@ -0,0 +1,81 @@
+#include <gtk/gtk.h>
+
+static void
+setup_item (GtkSignalListItemFactory *factory,
+            GtkListItem              *item)
+{
+  gtk_list_item_set_child (item, gtk_label_new (NULL));
+}
+
+static GtkWidget *
+create_list_view (guint n_items)
+{
+  GtkStringList *strings;
+  GtkListItemFactory *factory;
+  char buffer[64];
+
+  strings = gtk_string_list_new (NULL);
+  for (guint i = 0; i < n_items; i++)
+    {
+      g_snprintf (buffer, sizeof (buffer), "%u", i);
+      gtk_string_list_append (strings, buffer);
+    }
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_item), NULL);
+
+  return gtk_list_view_new (GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (strings))),
+                            factory);
+}
+
+static void
+listview_role (void)
+{
+  GtkWidget *widget = create_list_view (3);
+
+  g_object_ref_sink (widget);
+
+  gtk_test_accessible_assert_role (GTK_ACCESSIBLE (widget), GTK_ACCESSIBLE_ROLE_LIST);
+  gtk_test_accessible_assert_role (GTK_ACCESSIBLE (gtk_widget_get_first_child (widget)), GTK_ACCESSIBLE_ROLE_LIST_ITEM);
+
+  g_object_unref (widget);
+}
+
+static void
+listview_position (void)
+{
+  GtkWidget *widget = create_list_view (3);
+  GtkWidget *child;
+  GListModel *model;
+
+  g_object_ref_sink (widget);
+
+  child = gtk_widget_get_first_child (widget);
+  gtk_test_accessible_assert_relation (GTK_ACCESSIBLE (child), GTK_ACCESSIBLE_RELATION_POS_IN_SET, 1);
+  gtk_test_accessible_assert_relation (GTK_ACCESSIBLE (child), GTK_ACCESSIBLE_RELATION_SET_SIZE, 3);
+
+  child = gtk_widget_get_next_sibling (child);
+  gtk_test_accessible_assert_relation (GTK_ACCESSIBLE (child), GTK_ACCESSIBLE_RELATION_POS_IN_SET, 2);
+
+  /* Items keep their accessible when the model changes,
+   * but the position and set size are updated
+   */
+  model = gtk_no_selection_get_model (GTK_NO_SELECTION (gtk_list_view_get_model (GTK_LIST_VIEW (widget))));
+  gtk_string_list_splice (GTK_STRING_LIST (model), 0, 0, (const char *[]) { "new", NULL });
+
+  gtk_test_accessible_assert_relation (GTK_ACCESSIBLE (child), GTK_ACCESSIBLE_RELATION_POS_IN_SET, 3);
+  gtk_test_accessible_assert_relation (GTK_ACCESSIBLE (child), GTK_ACCESSIBLE_RELATION_SET_SIZE, 4);
+
+  g_object_unref (widget);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/a11y/listview/role", listview_role);
+  g_test_add_func ("/a11y/listview/position", listview_position);
+
+  return g_test_run ();
+}
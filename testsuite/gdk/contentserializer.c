@@ -212,6 +212,35 @@ test_content_text_plain (void)
   g_value_unset (&value);
 }
 
+static void
+test_content_text_plain_large (void)
+{
+  GValue value = G_VALUE_INIT;
+  GString *text;
+
+  /* Larger than the chunks the serializer writes, with
+   * multibyte characters crossing the chunk boundaries
+   */
+  text = g_string_new (NULL);
+  while (text->len < 300 * 1024)
+    g_string_append (text, "ABCDEF12345äöü€");
+
+  g_value_init (&value, G_TYPE_STRING);
+  g_value_take_string (&value, g_string_free (text, FALSE));
+  test_content_roundtrip (&value, "text/plain;charset=utf-8", compare_string_values);
+  g_value_unset (&value);
+
+  /* text/plain is ASCII, and goes through a charset converter */
+  text = g_string_new (NULL);
+  while (text->len < 300 * 1024)
+    g_string_append (text, "ABCDEF12345");
+
+  g_value_init (&value, G_TYPE_STRING);
+  g_value_take_string (&value, g_string_free (text, FALSE));
+  test_content_roundtrip (&value, "text/plain", compare_string_values);
+  g_value_unset (&value);
+}
+
 static void
 test_content_color (void)
 {
@@ -472,9 +501,11 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/content/text_plain_utf8", test_content_text_plain_utf8);
   g_test_add_func ("/content/text_plain", test_content_text_plain);
+  g_test_add_func ("/content/text_plain_large", test_content_text_plain_large);
   g_test_add_func ("/content/color", test_content_color);
   g_test_add_data_func ("/content/texture/png", "image/png", test_content_texture);
   g_test_add_data_func ("/content/texture/tiff", "image/tiff", test_content_texture);
+  g_test_add_data_func ("/content/texture/raw", "application/x-gtk-memory-texture", test_content_texture);
   g_test_add_func ("/content/file", test_content_file);
   g_test_add_func ("/content/files", test_content_files);
   g_test_add_func ("/content/custom", test_custom_format);
@@ -0,0 +1,115 @@
+#include <gtk/gtk.h>
+#include "gdk/gdkdmabuftextureprivate.h"
+
+#include <glib/gstdio.h>
+#include <string.h>
+#include <unistd.h>
+
+static int
+make_dmabuf_fd (const guchar *data,
+                gsize         size)
+{
+  char *path;
+  int fd;
+
+  fd = g_file_open_tmp ("dmabufXXXXXX", &path, NULL);
+  g_assert_cmpint (fd, >=, 0);
+  g_unlink (path);
+  g_free (path);
+
+  g_assert_cmpint (write (fd, data, size), ==, size);
+
+  return fd;
+}
+
+static void
+close_fd (gpointer data)
+{
+  close (GPOINTER_TO_INT (data));
+}
+
+static GdkTexture *
+make_texture (guint32       fourcc,
+              const guchar *data)
+{
+  GdkDmabufTextureBuilder *builder;
+  GdkTexture *texture;
+  GError *error = NULL;
+  int fd;
+
+  fd = make_dmabuf_fd (data, 2 * 2 * 4);
+
+  builder = gdk_dmabuf_texture_builder_new ();
+  g_object_set (builder,
+                "display", gdk_display_get_default (),
+                "width", 2,
+                "height", 2,
+                "fourcc", fourcc,
+                "modifier", DRM_FORMAT_MOD_LINEAR,
+                "n-planes", 1,
+                NULL);
+  gdk_dmabuf_texture_builder_set_fd (builder, 0, fd);
+  gdk_dmabuf_texture_builder_set_stride (builder, 0, 2 * 4);
+  gdk_dmabuf_texture_builder_set_offset (builder, 0, 0);
+
+  texture = gdk_dmabuf_texture_builder_build (builder, close_fd, GINT_TO_POINTER (fd), &error);
+  g_assert_no_error (error);
+  g_assert_true (GDK_IS_DMABUF_TEXTURE (texture));
+
+  g_object_unref (builder);
+
+  return texture;
+}
+
+static void
+test_dmabuftexture_mmap (void)
+{
+  const guchar data[16] = {
+    0x00, 0x00, 0xff, 0xff,   0x00, 0xff, 0x00, 0xff,
+    0xff, 0x00, 0x00, 0xff,   0x00, 0x00, 0x00, 0x00,
+  };
+  guchar out[16];
+  GdkTexture *texture;
+
+  texture = make_texture (DRM_FORMAT_ARGB8888, data);
+  g_assert_true (gdk_texture_get_format (texture) == GDK_MEMORY_B8G8R8A8_PREMULTIPLIED);
+
+  gdk_texture_download (texture, out, 2 * 4);
+  g_assert_true (memcmp (data, out, sizeof (data)) == 0);
+
+  g_object_unref (texture);
+}
+
+static void
+test_dmabuftexture_xrgb (void)
+{
+  const guchar data[16] = {
+    0x00, 0x00, 0xff, 0x00,   0x00, 0xff, 0x00, 0x12,
+    0xff, 0x00, 0x00, 0x34,   0x00, 0x00, 0x00, 0x56,
+  };
+  guchar out[16];
+  GdkTexture *texture;
+  int i;
+
+  texture = make_texture (DRM_FORMAT_XRGB8888, data);
+
+  gdk_texture_download (texture, out, 2 * 4);
+  for (i = 0; i < 4; i++)
+    {
+      g_assert_cmpmem (&data[4 * i], 3, &out[4 * i], 3);
+      g_assert_cmpint (out[4 * i + 3], ==, 0xff);
+    }
+
+  g_object_unref (texture);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  g_test_add_func ("/dmabuftexture/mmap", test_dmabuftexture_mmap);
+  g_test_add_func ("/dmabuftexture/xrgb", test_dmabuftexture_xrgb);
+
+  return g_test_run ();
+}
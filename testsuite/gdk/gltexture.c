@@ -237,6 +237,84 @@ G_GNUC_END_IGNORE_DEPRECATIONS
   g_object_unref (context);
 }
 
+static void
+download_done (GObject      *source,
+               GAsyncResult *result,
+               gpointer      data)
+{
+  GAsyncResult **out = data;
+
+  *out = g_object_ref (result);
+}
+
+static void
+test_gltexture_download_async (void)
+{
+  GdkDisplay *display;
+  GdkGLContext *context;
+  GdkGLTextureBuilder *builder;
+  GdkTextureDownloader *downloader;
+  GdkTexture *texture;
+  cairo_surface_t *surface;
+  GAsyncResult *result = NULL;
+  GError *error = NULL;
+  GBytes *bytes;
+  gsize stride;
+  unsigned int id;
+
+  display = gdk_display_get_default ();
+  if (!gdk_display_prepare_gl (display, &error))
+    {
+      g_test_message ("no GL support: %s", error->message);
+      g_test_skip ("no GL support");
+      g_clear_error (&error);
+      return;
+    }
+
+  context = gdk_display_create_gl_context (display, &error);
+  g_assert_nonnull (context);
+  g_assert_no_error (error);
+
+  gdk_gl_context_realize (context, &error);
+  g_assert_no_error (error);
+
+  surface = make_surface ();
+
+  gdk_gl_context_make_current (context);
+
+  id = make_gl_texture (context, surface);
+
+  builder = gdk_gl_texture_builder_new ();
+  gdk_gl_texture_builder_set_id (builder, id);
+  gdk_gl_texture_builder_set_context (builder, context);
+  gdk_gl_texture_builder_set_width (builder, 64);
+  gdk_gl_texture_builder_set_height (builder, 64);
+  texture = gdk_gl_texture_builder_build (builder, NULL, NULL);
+
+  downloader = gdk_texture_downloader_new (texture);
+  gdk_texture_downloader_download_bytes_async (downloader, NULL, download_done, &result);
+
+  while (result == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  bytes = gdk_texture_downloader_download_bytes_finish (downloader, result, &stride, &error);
+  g_assert_no_error (error);
+  g_assert_nonnull (bytes);
+  g_assert_cmpuint (stride, ==, 64 * 4);
+  g_assert_cmpuint (g_bytes_get_size (bytes), ==, 64 * 64 * 4);
+  g_assert_true (memcmp (g_bytes_get_data (bytes, NULL), cairo_image_surface_get_data (surface), 64 * 64 * 4) == 0);
+
+  g_bytes_unref (bytes);
+  g_object_unref (result);
+  gdk_texture_downloader_free (downloader);
+  g_object_unref (texture);
+  g_object_unref (builder);
+
+  cairo_surface_destroy (surface);
+
+  g_object_unref (context);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -246,6 +324,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/gltexture/no-context", test_gltexture_no_context);
   g_test_add_func ("/gltexture/shared-context", test_gltexture_shared_context);
   g_test_add_func ("/gltexture/updates", test_gltexture_updates);
+  g_test_add_func ("/gltexture/download-async", test_gltexture_download_async);
 
   return g_test_run ();
 }
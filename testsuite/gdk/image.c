@@ -2,6 +2,7 @@
 #include "gdk/loaders/gdkpngprivate.h"
 #include "gdk/loaders/gdktiffprivate.h"
 #include "gdk/loaders/gdkjpegprivate.h"
+#include "gdk/gdktextureprivate.h"
 
 static void
 assert_texture_equal (GdkTexture *t1,
@@ -117,6 +118,146 @@ test_save_image (gconstpointer test_data)
   g_free (path);
 }
 
+static void
+count_progress (GdkTexture *texture,
+                gpointer    data)
+{
+  guint *n_progress = data;
+
+  g_assert_true (GDK_IS_TEXTURE (texture));
+
+  (*n_progress)++;
+}
+
+static void
+stream_loaded (GObject      *source,
+               GAsyncResult *result,
+               gpointer      data)
+{
+  GdkTexture **texture = data;
+  GError *error = NULL;
+
+  *texture = gdk_texture_new_from_stream_finish (result, &error);
+  g_assert_no_error (error);
+  g_assert_true (GDK_IS_TEXTURE (*texture));
+}
+
+static void
+test_load_image_stream (gconstpointer data)
+{
+  const char *filename = data;
+  GdkTexture *texture;
+  GdkTexture *texture2 = NULL;
+  GFileInputStream *stream;
+  guint n_progress = 0;
+  char *path;
+  GFile *file;
+  GError *error = NULL;
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", filename, NULL);
+  texture = gdk_texture_new_from_filename (path, &error);
+  g_assert_no_error (error);
+
+  file = g_file_new_for_path (path);
+  stream = g_file_read (file, NULL, &error);
+  g_assert_no_error (error);
+
+  gdk_texture_new_from_stream_async (G_INPUT_STREAM (stream), NULL,
+                                     count_progress, &n_progress, NULL,
+                                     stream_loaded, &texture2);
+
+  while (texture2 == NULL)
+    g_main_context_iteration (NULL, TRUE);
+
+  assert_texture_equal (texture, texture2);
+
+  g_object_unref (texture2);
+  g_object_unref (texture);
+  g_object_unref (stream);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+stream_cancelled (GObject      *source,
+                  GAsyncResult *result,
+                  gpointer      data)
+{
+  gboolean *done = data;
+  GdkTexture *texture;
+  GError *error = NULL;
+
+  texture = gdk_texture_new_from_stream_finish (result, &error);
+  g_assert_error (error, G_IO_ERROR, G_IO_ERROR_CANCELLED);
+  g_assert_null (texture);
+  g_error_free (error);
+
+  *done = TRUE;
+}
+
+static void
+test_load_image_stream_cancel (void)
+{
+  GFileInputStream *stream;
+  GCancellable *cancellable;
+  gboolean done = FALSE;
+  char *path;
+  GFile *file;
+  GError *error = NULL;
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", "image.png", NULL);
+  file = g_file_new_for_path (path);
+  stream = g_file_read (file, NULL, &error);
+  g_assert_no_error (error);
+
+  cancellable = g_cancellable_new ();
+  g_cancellable_cancel (cancellable);
+
+  gdk_texture_new_from_stream_async (G_INPUT_STREAM (stream), cancellable,
+                                     NULL, NULL, NULL,
+                                     stream_cancelled, &done);
+
+  while (!done)
+    g_main_context_iteration (NULL, TRUE);
+
+  g_object_unref (cancellable);
+  g_object_unref (stream);
+  g_object_unref (file);
+  g_free (path);
+}
+
+static void
+test_load_jpeg_at_size (void)
+{
+  GdkTexture *texture;
+  char *path;
+  GError *error = NULL;
+
+  path = g_test_build_filename (G_TEST_DIST, "image-data", "image.jpeg", NULL);
+
+  /* image.jpeg is 32x32, so this can use a scale of 1/4 */
+  texture = gdk_texture_new_from_filename_at_size (path, 7, 8, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 8);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 8);
+  g_object_unref (texture);
+
+  /* Never decode smaller than requested */
+  texture = gdk_texture_new_from_filename_at_size (path, 9, 9, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 16);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 16);
+  g_object_unref (texture);
+
+  texture = gdk_texture_new_from_filename_at_size (path, 64, 64, &error);
+  g_assert_no_error (error);
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 32);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 32);
+  g_object_unref (texture);
+
+  g_free (path);
+}
+
 static void
 test_load_image_fail (gconstpointer data)
 {
@@ -155,6 +296,10 @@ main (int argc, char *argv[])
      char *test = g_strconcat ("/image/load/", name, NULL);
      g_test_add_data_func (test, name, test_load_image);
      g_free (test);
+
+     test = g_strconcat ("/image/stream/", name, NULL);
+     g_test_add_data_func (test, name, test_load_image_stream);
+     g_free (test);
    }
 
   path = g_test_build_filename (G_TEST_DIST, "bad-image-data", NULL);
@@ -169,6 +314,9 @@ main (int argc, char *argv[])
      g_free (test);
    }
 
+  g_test_add_func ("/image/stream/cancel", test_load_image_stream_cancel);
+  g_test_add_func ("/image/load/jpeg-at-size", test_load_jpeg_at_size);
+
   g_test_add_data_func ("/image/save/image.png", "image.png", test_save_image);
   g_test_add_data_func ("/image/save/image.tiff", "image.tiff", test_save_image);
   g_test_add_data_func ("/image/save/image.jpeg", "image.jpeg", test_save_image);
@@ -0,0 +1,159 @@
+#include <gtk/gtk.h>
+#include "gdk/gdkmemoryformatprivate.h"
+
+typedef struct {
+  GdkMemoryFormat src_format;
+  GdkMemoryFormat dest_format;
+} ConvertTest;
+
+/* The conversions with dedicated fast paths */
+static const ConvertTest tests[] = {
+  { GDK_MEMORY_R8G8B8A8, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED },
+  { GDK_MEMORY_R8G8B8A8, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED },
+  { GDK_MEMORY_R8G8B8A8, GDK_MEMORY_A8R8G8B8_PREMULTIPLIED },
+  { GDK_MEMORY_B8G8R8A8, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED },
+  { GDK_MEMORY_B8G8R8A8, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED },
+  { GDK_MEMORY_B8G8R8A8, GDK_MEMORY_A8R8G8B8_PREMULTIPLIED },
+  { GDK_MEMORY_R8G8B8A8_PREMULTIPLIED, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED },
+  { GDK_MEMORY_B8G8R8A8_PREMULTIPLIED, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED },
+  { GDK_MEMORY_A8R8G8B8_PREMULTIPLIED, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED },
+  { GDK_MEMORY_A8R8G8B8_PREMULTIPLIED, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED },
+  { GDK_MEMORY_R8G8B8A8, GDK_MEMORY_B8G8R8A8 },
+  { GDK_MEMORY_R8G8B8A8, GDK_MEMORY_A8B8G8R8 },
+  { GDK_MEMORY_A8B8G8R8, GDK_MEMORY_B8G8R8A8 },
+  { GDK_MEMORY_R8G8B8, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED },
+  { GDK_MEMORY_B8G8R8, GDK_MEMORY_B8G8R8A8_PREMULTIPLIED },
+  { GDK_MEMORY_R8G8B8, GDK_MEMORY_A8R8G8B8 },
+};
+
+static guchar *
+make_random_data (gsize size)
+{
+  guchar *data = g_malloc (size);
+
+  for (gsize i = 0; i < size; i++)
+    data[i] = g_test_rand_int_range (0, 256);
+
+  return data;
+}
+
+static void
+test_convert (gconstpointer data)
+{
+  const ConvertTest *test = data;
+  gsize src_bpp = gdk_memory_format_bytes_per_pixel (test->src_format);
+  gsize dest_bpp = gdk_memory_format_bytes_per_pixel (test->dest_format);
+  GdkMemoryFormat float_format;
+  gsize width, height, src_stride, dest_stride, x, y, i;
+  guchar *src, *fast, *slow;
+  float *tmp;
+
+  if (gdk_memory_format_alpha (test->src_format) == GDK_MEMORY_ALPHA_PREMULTIPLIED)
+    float_format = GDK_MEMORY_R32G32B32A32_FLOAT_PREMULTIPLIED;
+  else
+    float_format = GDK_MEMORY_R32G32B32A32_FLOAT;
+
+  /* Odd widths exercise the leftovers after the SIMD blocks */
+  for (width = 1; width < 70; width += g_test_rand_int_range (1, 8))
+    {
+      height = g_test_rand_int_range (1, 5);
+      src_stride = width * src_bpp + g_test_rand_int_range (0, 8);
+      dest_stride = width * dest_bpp + g_test_rand_int_range (0, 8);
+
+      src = make_random_data (src_stride * height);
+      fast = g_malloc0 (dest_stride * height);
+      slow = g_malloc0 (dest_stride * height);
+      tmp = g_new (float, width * height * 4);
+
+      gdk_memory_convert (fast, dest_stride, test->dest_format,
+                          src, src_stride, test->src_format,
+                          width, height);
+
+      /* Going through float picks the generic path */
+      gdk_memory_convert ((guchar *) tmp, width * 4 * sizeof (float), float_format,
+                          src, src_stride, test->src_format,
+                          width, height);
+      gdk_memory_convert (slow, dest_stride, test->dest_format,
+                          (guchar *) tmp, width * 4 * sizeof (float), float_format,
+                          width, height);
+
+      for (y = 0; y < height; y++)
+        for (x = 0; x < width; x++)
+          for (i = 0; i < dest_bpp; i++)
+            {
+              int a = fast[y * dest_stride + x * dest_bpp + i];
+              int b = slow[y * dest_stride + x * dest_bpp + i];
+
+              if (ABS (a - b) > 1)
+                g_error ("%ux%u: pixel %u,%u channel %u differs: %d vs %d",
+                         (guint) width, (guint) height, (guint) x, (guint) y, (guint) i, a, b);
+            }
+
+      g_free (src);
+      g_free (fast);
+      g_free (slow);
+      g_free (tmp);
+    }
+}
+
+#define PERF_SIZE 2048
+#define PERF_RUNS 10
+
+static void
+test_convert_perf (gconstpointer data)
+{
+  const ConvertTest *test = data;
+  gsize src_bpp = gdk_memory_format_bytes_per_pixel (test->src_format);
+  gsize dest_bpp = gdk_memory_format_bytes_per_pixel (test->dest_format);
+  guchar *src, *dest;
+  double best = G_MAXDOUBLE;
+
+  src = make_random_data (PERF_SIZE * PERF_SIZE * src_bpp);
+  dest = g_malloc (PERF_SIZE * PERF_SIZE * dest_bpp);
+
+  for (int run = 0; run < PERF_RUNS; run++)
+    {
+      g_test_timer_start ();
+      gdk_memory_convert (dest, PERF_SIZE * dest_bpp, test->dest_format,
+                          src, PERF_SIZE * src_bpp, test->src_format,
+                          PERF_SIZE, PERF_SIZE);
+      best = MIN (best, g_test_timer_elapsed ());
+    }
+
+  g_test_minimized_result (best * 1000, "%.2f ms for %dx%d pixels", best * 1000, PERF_SIZE, PERF_SIZE);
+
+  g_free (src);
+  g_free (dest);
+}
+
+static void
+add_tests (const char    *prefix,
+           GTestDataFunc  func)
+{
+  GEnumClass *enum_class = g_type_class_ref (GDK_TYPE_MEMORY_FORMAT);
+
+  for (gsize i = 0; i < G_N_ELEMENTS (tests); i++)
+    {
+      char *path;
+
+      path = g_strdup_printf ("%s/%s/%s", prefix,
+                              g_enum_get_value (enum_class, tests[i].src_format)->value_nick,
+                              g_enum_get_value (enum_class, tests[i].dest_format)->value_nick);
+      g_test_add_data_func (path, &tests[i], func);
+      g_free (path);
+    }
+
+  g_type_class_unref (enum_class);
+}
+
+int
+main (int argc, char *argv[])
+{
+  gtk_test_init (&argc, &argv, NULL);
+
+  add_tests ("/memoryconvert/correctness", test_convert);
+  if (g_test_perf ())
+    add_tests ("/memoryconvert/performance", test_convert_perf);
+
+  return g_test_run ();
+}
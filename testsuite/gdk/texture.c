@@ -397,6 +397,72 @@ test_texture_downloader (void)
   g_object_unref (texture);
 }
 
+static void
+test_texture_compressed_bc1 (void)
+{
+  static const guchar blocks[] = {
+    /* red and blue endpoints, the first row uses all 4 colors */
+    0x00, 0xf8, 0x1f, 0x00, 0xe4, 0x00, 0x00, 0x00,
+    /* equal endpoints, so the 4th color is transparent */
+    0x00, 0xf8, 0x00, 0xf8, 0xff, 0xff, 0xff, 0xff,
+  };
+  GdkTextureDownloader *downloader;
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar data[6 * 4 * 4];
+
+  bytes = g_bytes_new_static (blocks, sizeof (blocks));
+  texture = gdk_compressed_texture_new (6, 4, GDK_COMPRESSED_BC1, bytes);
+  g_bytes_unref (bytes);
+
+  g_assert_cmpint (gdk_texture_get_width (texture), ==, 6);
+  g_assert_cmpint (gdk_texture_get_height (texture), ==, 4);
+  g_assert_cmpint (gdk_texture_get_format (texture), ==, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
+
+  downloader = gdk_texture_downloader_new (texture);
+  gdk_texture_downloader_set_format (downloader, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
+  gdk_texture_downloader_download_into (downloader, data, 6 * 4);
+  gdk_texture_downloader_free (downloader);
+
+  g_assert_cmpmem (data, 16,
+                   ((guchar[]) { 255, 0, 0, 255,  0, 0, 255, 255,  170, 0, 85, 255,  85, 0, 170, 255 }), 16);
+  /* second row uses color 0 everywhere */
+  g_assert_cmpmem (data + 6 * 4, 4, ((guchar[]) { 255, 0, 0, 255 }), 4);
+  /* the second block is cut off after 2 columns */
+  g_assert_cmpmem (data + 4 * 4, 8, ((guchar[]) { 0, 0, 0, 0,  0, 0, 0, 0 }), 8);
+
+  g_object_unref (texture);
+}
+
+static void
+test_texture_compressed_bc3 (void)
+{
+  static const guchar blocks[] = {
+    /* alpha endpoints 255 and 0, pixels 0-2 use indices 0, 1 and 2 */
+    0xff, 0x00, 0x88, 0x00, 0x00, 0x00, 0x00, 0x00,
+    /* white */
+    0xff, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+  };
+  GdkTextureDownloader *downloader;
+  GdkTexture *texture;
+  GBytes *bytes;
+  guchar data[4 * 4 * 4];
+
+  bytes = g_bytes_new_static (blocks, sizeof (blocks));
+  texture = gdk_compressed_texture_new (4, 4, GDK_COMPRESSED_BC3, bytes);
+  g_bytes_unref (bytes);
+
+  downloader = gdk_texture_downloader_new (texture);
+  gdk_texture_downloader_set_format (downloader, GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
+  gdk_texture_downloader_download_into (downloader, data, 4 * 4);
+  gdk_texture_downloader_free (downloader);
+
+  g_assert_cmpmem (data, 16,
+                   ((guchar[]) { 255, 255, 255, 255,  0, 0, 0, 0,  218, 218, 218, 218,  255, 255, 255, 255 }), 16);
+
+  g_object_unref (texture);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -413,6 +479,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/texture/icon/serialize", test_texture_icon_serialize);
   g_test_add_func ("/texture/diff", test_texture_diff);
   g_test_add_func ("/texture/downloader", test_texture_downloader);
+  g_test_add_func ("/texture/compressed/bc1", test_texture_compressed_bc1);
+  g_test_add_func ("/texture/compressed/bc3", test_texture_compressed_bc3);
 
   return g_test_run ();
 }
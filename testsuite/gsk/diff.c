@@ -95,6 +95,138 @@ test_can_diff_transform (void)
   gsk_transform_unref (t2);
 }
 
+static void
+test_diff_equal_content (void)
+{
+  GskRenderNode *children1[2], *children2[2];
+  GskRenderNode *container1, *container2;
+  GskRenderNode *clip1, *clip2, *clip3;
+  cairo_region_t *region;
+
+  children1[0] = gsk_color_node_new (&(GdkRGBA){0, 1, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  children1[1] = gsk_color_node_new (&(GdkRGBA){1, 0, 0, 1 }, &GRAPHENE_RECT_INIT (90, 90, 10, 10));
+  children2[0] = gsk_color_node_new (&(GdkRGBA){0, 1, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  children2[1] = gsk_color_node_new (&(GdkRGBA){1, 0, 0, 1 }, &GRAPHENE_RECT_INIT (90, 90, 10, 10));
+
+  container1 = gsk_container_node_new (children1, 2);
+  container2 = gsk_container_node_new (children2, 2);
+  clip1 = gsk_clip_node_new (container1, &GRAPHENE_RECT_INIT (0, 0, 50, 100));
+  clip2 = gsk_clip_node_new (container2, &GRAPHENE_RECT_INIT (0, 0, 50, 100));
+  clip3 = gsk_clip_node_new (container2, &GRAPHENE_RECT_INIT (0, 0, 100, 100));
+
+  /* Separately created nodes with the same content have no damage */
+  g_assert_true (gsk_render_node_get_hash (clip1) != 0);
+  g_assert_true (gsk_render_node_get_hash (clip1) == gsk_render_node_get_hash (clip2));
+
+  region = cairo_region_create ();
+  gsk_render_node_diff (clip1, clip2, region);
+  g_assert_true (cairo_region_is_empty (region));
+
+  /* The changed clip still shows up */
+  g_assert_true (gsk_render_node_get_hash (clip1) != gsk_render_node_get_hash (clip3));
+  gsk_render_node_diff (clip1, clip3, region);
+  g_assert_false (cairo_region_is_empty (region));
+  cairo_region_destroy (region);
+
+  gsk_render_node_unref (clip1);
+  gsk_render_node_unref (clip2);
+  gsk_render_node_unref (clip3);
+  gsk_render_node_unref (container1);
+  gsk_render_node_unref (container2);
+  for (int i = 0; i < 2; i++)
+    {
+      gsk_render_node_unref (children1[i]);
+      gsk_render_node_unref (children2[i]);
+    }
+}
+
+static void
+test_diff_equal_path (void)
+{
+  GskRenderNode *color;
+  GskRenderNode *fill1, *fill2, *fill3;
+  GskRenderNode *stroke1, *stroke2;
+  GskPath *path1, *path2;
+  GskStroke *stroke;
+  cairo_region_t *region;
+
+  color = gsk_color_node_new (&(GdkRGBA){0, 1, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 100, 100));
+  path1 = gsk_path_parse ("M 10 10 L 90 10 Q 90 90 50 90 Z");
+  path2 = gsk_path_parse ("M 10 10 L 90 10 Q 90 90 50 90 Z");
+
+  /* Paths are compared by content, not by identity */
+  fill1 = gsk_fill_node_new (color, path1, GSK_FILL_RULE_WINDING);
+  fill2 = gsk_fill_node_new (color, path2, GSK_FILL_RULE_WINDING);
+  fill3 = gsk_fill_node_new (color, path2, GSK_FILL_RULE_EVEN_ODD);
+
+  g_assert_true (gsk_render_node_get_hash (fill1) != 0);
+  g_assert_true (gsk_render_node_get_hash (fill1) == gsk_render_node_get_hash (fill2));
+  g_assert_true (gsk_render_node_get_hash (fill1) != gsk_render_node_get_hash (fill3));
+
+  region = cairo_region_create ();
+  gsk_render_node_diff (fill1, fill2, region);
+  g_assert_true (cairo_region_is_empty (region));
+
+  stroke = gsk_stroke_new (2);
+  stroke1 = gsk_stroke_node_new (color, path1, stroke);
+  gsk_stroke_set_line_width (stroke, 3);
+  stroke2 = gsk_stroke_node_new (color, path2, stroke);
+
+  g_assert_true (gsk_render_node_get_hash (stroke1) != 0);
+  g_assert_true (gsk_render_node_get_hash (stroke1) != gsk_render_node_get_hash (stroke2));
+  gsk_render_node_diff (stroke1, stroke2, region);
+  g_assert_false (cairo_region_is_empty (region));
+  cairo_region_destroy (region);
+
+  gsk_render_node_unref (fill1);
+  gsk_render_node_unref (fill2);
+  gsk_render_node_unref (fill3);
+  gsk_render_node_unref (stroke1);
+  gsk_render_node_unref (stroke2);
+  gsk_stroke_free (stroke);
+  gsk_path_unref (path1);
+  gsk_path_unref (path2);
+  gsk_render_node_unref (color);
+}
+
+static void
+test_path_mask_translate (void)
+{
+  GskRenderNode *color1, *color2;
+  GskRenderNode *stroke1, *stroke2, *stroke3;
+  GskPath *path1, *path2;
+  GskStroke *stroke;
+
+  color1 = gsk_color_node_new (&(GdkRGBA){0, 1, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 200, 200));
+  color2 = gsk_color_node_new (&(GdkRGBA){1, 0, 0, 1 }, &GRAPHENE_RECT_INIT (20, 30, 200, 200));
+  path1 = gsk_path_parse ("M 10 10 L 90 10 Q 90 90 50 90 Z");
+  path2 = gsk_path_parse ("M 30 40 L 110 40 Q 110 120 70 120 Z");
+
+  stroke = gsk_stroke_new (4);
+  gsk_stroke_set_dash (stroke, (float[]) { 5, 3 }, 2);
+  stroke1 = gsk_stroke_node_new (color1, path1, stroke);
+  stroke2 = gsk_stroke_node_new (color2, path2, stroke);
+  gsk_stroke_set_dash_offset (stroke, 1);
+  stroke3 = gsk_stroke_node_new (color2, path2, stroke);
+
+  /* Masks ignore the child and are keyed relative to their origin */
+  g_assert_true (gsk_render_node_get_path_mask_hash (stroke1, &stroke1->bounds.origin) ==
+                 gsk_render_node_get_path_mask_hash (stroke2, &stroke2->bounds.origin));
+  g_assert_true (gsk_render_node_get_path_mask_hash (stroke1, &stroke1->bounds.origin) !=
+                 gsk_render_node_get_path_mask_hash (stroke2, &stroke1->bounds.origin));
+  g_assert_true (gsk_render_node_get_path_mask_hash (stroke2, &stroke2->bounds.origin) !=
+                 gsk_render_node_get_path_mask_hash (stroke3, &stroke3->bounds.origin));
+
+  gsk_render_node_unref (stroke1);
+  gsk_render_node_unref (stroke2);
+  gsk_render_node_unref (stroke3);
+  gsk_stroke_free (stroke);
+  gsk_path_unref (path1);
+  gsk_path_unref (path2);
+  gsk_render_node_unref (color1);
+  gsk_render_node_unref (color2);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -103,6 +235,9 @@ main (int   argc,
 
   g_test_add_func ("/node/can-diff/basic", test_can_diff_basic);
   g_test_add_func ("/node/can-diff/transform", test_can_diff_transform);
+  g_test_add_func ("/node/diff/equal-content", test_diff_equal_content);
+  g_test_add_func ("/node/diff/equal-path", test_diff_equal_path);
+  g_test_add_func ("/node/path-mask/translate", test_path_mask_translate);
 
   return g_test_run ();
 }
@@ -1,5 +1,9 @@
 #include <gtk/gtk.h>
 #include "gsk/gskrendernodeprivate.h"
+#include "gsk/gskrendernodearenaprivate.h"
+#include "gsk/gskdebugprivate.h"
+#include "gsk/gskshadowcacheprivate.h"
+#include "gsk/gsktransformprivate.h"
 
 #ifdef GDK_RENDERING_GL
 #include <gsk/gl/gskglrenderer.h>
@@ -153,6 +157,82 @@ test_container_disjoint (void)
   gsk_render_node_unref (nodes[1]);
 }
 
+static void
+test_container_opaque (void)
+{
+  GskRenderNode *node, *nodes[3];
+  graphene_rect_t opaque;
+
+  /* Two halves combine into one opaque rect */
+  nodes[0] = gsk_color_node_new (&(GdkRGBA){0,1,1,1}, &GRAPHENE_RECT_INIT (0, 0, 50, 50));
+  nodes[1] = gsk_color_node_new (&(GdkRGBA){0,1,1,1}, &GRAPHENE_RECT_INIT (50, 0, 50, 50));
+  nodes[2] = gsk_color_node_new (&(GdkRGBA){0,1,1,0.5}, &GRAPHENE_RECT_INIT (0, 0, 200, 200));
+  node = gsk_container_node_new (nodes, 3);
+
+  g_assert_true (gsk_render_node_get_opaque_rect (node, &opaque));
+  g_assert_true (graphene_rect_equal (&opaque, &GRAPHENE_RECT_INIT (0, 0, 100, 50)));
+  g_assert_false (gsk_render_node_get_opaque_rect (nodes[2], &opaque));
+
+  gsk_render_node_unref (node);
+  gsk_render_node_unref (nodes[0]);
+  gsk_render_node_unref (nodes[1]);
+  gsk_render_node_unref (nodes[2]);
+
+  /* Clips shrink the opaque rect, translucency removes it */
+  nodes[0] = gsk_color_node_new (&(GdkRGBA){0,1,1,1}, &GRAPHENE_RECT_INIT (0, 0, 100, 100));
+  node = gsk_clip_node_new (nodes[0], &GRAPHENE_RECT_INIT (10, 10, 20, 20));
+  g_assert_true (gsk_render_node_get_opaque_rect (node, &opaque));
+  g_assert_true (graphene_rect_equal (&opaque, &GRAPHENE_RECT_INIT (10, 10, 20, 20)));
+  gsk_render_node_unref (node);
+
+  node = gsk_opacity_node_new (nodes[0], 0.5);
+  g_assert_false (gsk_render_node_get_opaque_rect (node, &opaque));
+  gsk_render_node_unref (node);
+
+  gsk_render_node_unref (nodes[0]);
+}
+
+static void
+test_node_arena (void)
+{
+  GskDebugFlags flags = gsk_get_debug_flags ();
+  GskRenderNode *nodes[100], *node, *retained;
+  guint i;
+
+  /* make sure the classes exist, only those are allocated from the arena */
+  node = gsk_color_node_new (&(GdkRGBA){1,0,0,1}, &GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  gsk_render_node_unref (node);
+  node = gsk_container_node_new (NULL, 0);
+  gsk_render_node_unref (node);
+
+  gsk_set_debug_flags (flags | GSK_DEBUG_NODE_ARENA);
+
+  gsk_render_node_arena_push ();
+  for (i = 0; i < G_N_ELEMENTS (nodes); i++)
+    nodes[i] = gsk_color_node_new (&(GdkRGBA){1,0,0,1}, &GRAPHENE_RECT_INIT (i, 0, 10, 10));
+  node = gsk_container_node_new (nodes, G_N_ELEMENTS (nodes));
+  g_assert_true (node->arena_allocated);
+  g_assert_true (nodes[0]->arena_allocated);
+  retained = gsk_render_node_ref (nodes[42]);
+  for (i = 0; i < G_N_ELEMENTS (nodes); i++)
+    gsk_render_node_unref (nodes[i]);
+  gsk_render_node_arena_pop ();
+
+  /* Nodes stay valid after the frame ends */
+  g_assert_true (graphene_rect_equal (&node->bounds, &GRAPHENE_RECT_INIT (0, 0, 109, 10)));
+  gsk_render_node_unref (node);
+  g_assert_true (graphene_rect_equal (&retained->bounds, &GRAPHENE_RECT_INIT (42, 0, 10, 10)));
+
+  /* Outside of an arena, nodes are allocated normally */
+  node = gsk_color_node_new (&(GdkRGBA){1,0,0,1}, &GRAPHENE_RECT_INIT (0, 0, 10, 10));
+  g_assert_false (node->arena_allocated);
+  gsk_render_node_unref (node);
+
+  gsk_render_node_unref (retained);
+
+  gsk_set_debug_flags (flags);
+}
+
 const char shader1[] =
 "uniform float progress;\n"
 "uniform sampler2D u_texture1;\n"
@@ -257,6 +337,54 @@ test_cairo_renderer (void)
   g_clear_object (&renderer);
 }
 
+static void
+test_cairo_renderer_tiled (void)
+{
+  GskRenderer *renderer;
+  GskRenderNode *nodes[2], *node;
+  GskColorStop stops[2] = {
+    { 0, { 1, 0, 0, 1 } },
+    { 1, { 0, 0, 1, 0.5 } },
+  };
+  cairo_surface_t *surface;
+  GdkTexture *texture;
+  guchar *data;
+  cairo_t *cr;
+
+  /* Large enough to be split into tiles */
+  nodes[0] = gsk_linear_gradient_node_new (&GRAPHENE_RECT_INIT (0, 0, 1000, 700),
+                                           &GRAPHENE_POINT_INIT (0, 0),
+                                           &GRAPHENE_POINT_INIT (1000, 700),
+                                           stops, G_N_ELEMENTS (stops));
+  nodes[1] = gsk_border_node_new (&GSK_ROUNDED_RECT_INIT (100, 100, 800, 500),
+                                  (float[4]) { 5, 5, 5, 5 },
+                                  (GdkRGBA[4]) { { 0, 1, 0, 1 }, { 0, 1, 0, 1 }, { 0, 1, 0, 1 }, { 0, 1, 0, 1 } });
+  node = gsk_container_node_new (nodes, G_N_ELEMENTS (nodes));
+
+  surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, 1000, 700);
+  cr = cairo_create (surface);
+  gsk_render_node_draw (node, cr);
+  cairo_destroy (cr);
+  cairo_surface_flush (surface);
+
+  renderer = gsk_cairo_renderer_new ();
+  g_assert_true (gsk_renderer_realize (renderer, NULL, NULL));
+  texture = gsk_renderer_render_texture (renderer, node, NULL);
+  data = g_malloc (1000 * 700 * 4);
+  gdk_texture_download (texture, data, 1000 * 4);
+  g_assert_cmpmem (data, 1000 * 700 * 4,
+                   cairo_image_surface_get_data (surface), 1000 * 700 * 4);
+
+  g_free (data);
+  g_object_unref (texture);
+  cairo_surface_destroy (surface);
+  gsk_renderer_unrealize (renderer);
+  g_object_unref (renderer);
+  gsk_render_node_unref (node);
+  gsk_render_node_unref (nodes[0]);
+  gsk_render_node_unref (nodes[1]);
+}
+
 static void
 test_gl_renderer (void)
 {
@@ -271,6 +399,208 @@ test_gl_renderer (void)
 #endif
 }
 
+static void
+test_render_textures (GskRenderer *renderer)
+{
+  GskRenderNode *nodes[3];
+  GdkTexture *textures[3];
+  graphene_rect_t viewports[3];
+  guint i;
+
+  if (!gsk_renderer_realize (renderer, NULL, NULL))
+    {
+      g_test_skip ("renderer could not be realized");
+      return;
+    }
+
+  nodes[0] = gsk_color_node_new (&(GdkRGBA) { 1, 0, 0, 1 }, &GRAPHENE_RECT_INIT (0, 0, 20, 10));
+  nodes[1] = gsk_color_node_new (&(GdkRGBA) { 0, 1, 0, 1 }, &GRAPHENE_RECT_INIT (10, 10, 7, 33));
+  nodes[2] = gsk_border_node_new (&GSK_ROUNDED_RECT_INIT (0, 0, 50, 50),
+                                  (float[4]) { 5, 5, 5, 5 },
+                                  (GdkRGBA[4]) { { 0, 0, 1, 1 }, { 0, 0, 1, 1 }, { 0, 0, 1, 1 }, { 0, 0, 1, 1 } });
+  for (i = 0; i < G_N_ELEMENTS (nodes); i++)
+    gsk_render_node_get_bounds (nodes[i], &viewports[i]);
+  /* Viewports apply to their own node */
+  viewports[2] = GRAPHENE_RECT_INIT (-5, -5, 30, 20);
+
+  gsk_renderer_render_textures (renderer, nodes, viewports, G_N_ELEMENTS (nodes), textures);
+
+  for (i = 0; i < G_N_ELEMENTS (nodes); i++)
+    {
+      GdkTexture *expected;
+      gsize stride;
+      guchar *data, *expected_data;
+
+      expected = gsk_renderer_render_texture (renderer, nodes[i], &viewports[i]);
+
+      g_assert_cmpint (gdk_texture_get_width (textures[i]), ==, gdk_texture_get_width (expected));
+      g_assert_cmpint (gdk_texture_get_height (textures[i]), ==, gdk_texture_get_height (expected));
+
+      stride = gdk_texture_get_width (expected) * 4;
+      data = g_malloc (stride * gdk_texture_get_height (expected));
+      expected_data = g_malloc (stride * gdk_texture_get_height (expected));
+      gdk_texture_download (textures[i], data, stride);
+      gdk_texture_download (expected, expected_data, stride);
+      g_assert_cmpmem (data, stride * gdk_texture_get_height (expected),
+                       expected_data, stride * gdk_texture_get_height (expected));
+
+      g_free (data);
+      g_free (expected_data);
+      g_object_unref (expected);
+      g_object_unref (textures[i]);
+      gsk_render_node_unref (nodes[i]);
+    }
+
+  gsk_renderer_unrealize (renderer);
+}
+
+static void
+test_cairo_renderer_render_textures (void)
+{
+  GskRenderer *renderer;
+
+  renderer = gsk_cairo_renderer_new ();
+  test_render_textures (renderer);
+  g_object_unref (renderer);
+}
+
+static void
+test_gl_renderer_render_textures (void)
+{
+#ifdef GDK_RENDERING_GL
+  GskRenderer *renderer;
+
+  renderer = gsk_gl_renderer_new ();
+  test_render_textures (renderer);
+  g_object_unref (renderer);
+#else
+  g_test_skip ("no GL support");
+#endif
+}
+
+static void
+test_gl_renderer_texture_depth (void)
+{
+#ifdef GDK_RENDERING_GL
+  GskRenderer *renderer;
+  GskRenderNode *node;
+  GdkTexture *texture, *result;
+  GBytes *bytes;
+  guint16 pixels[4 * 4];
+  guint i;
+
+  renderer = gsk_gl_renderer_new ();
+  if (!gsk_renderer_realize (renderer, NULL, NULL))
+    {
+      g_test_skip ("renderer could not be realized");
+      g_object_unref (renderer);
+      return;
+    }
+
+  /* 1.0 as a half float */
+  for (i = 0; i < G_N_ELEMENTS (pixels); i++)
+    pixels[i] = 0x3c00;
+
+  bytes = g_bytes_new (pixels, sizeof (pixels));
+  texture = gdk_memory_texture_new (2, 2, GDK_MEMORY_R16G16B16A16_FLOAT_PREMULTIPLIED, bytes, 2 * 4 * 2);
+  g_bytes_unref (bytes);
+  node = gsk_texture_node_new (texture, &GRAPHENE_RECT_INIT (0, 0, 2, 2));
+
+  result = gsk_renderer_render_texture (renderer, node, NULL);
+
+  /* Half float content must not be rendered to 32 bit floats,
+   * nor claim to be 8 bit when it isn't.
+   */
+  g_assert_true (gdk_texture_get_format (result) == GDK_MEMORY_R16G16B16A16_FLOAT_PREMULTIPLIED ||
+                 gdk_texture_get_format (result) == GDK_MEMORY_R8G8B8A8_PREMULTIPLIED);
+
+  g_object_unref (result);
+  gsk_render_node_unref (node);
+  g_object_unref (texture);
+  gsk_renderer_unrealize (renderer);
+  g_object_unref (renderer);
+#else
+  g_test_skip ("no GL support");
+#endif
+}
+
+static void
+test_transform_untransform_bounds (void)
+{
+  GskTransform *t;
+  graphene_rect_t out;
+
+  t = gsk_transform_rotate (gsk_transform_translate (NULL, &GRAPHENE_POINT_INIT (100, 0)), 90);
+  g_assert_true (gsk_transform_untransform_bounds (t, &GRAPHENE_RECT_INIT (50, 0, 50, 20), &out));
+  g_assert_cmpfloat_with_epsilon (out.origin.x, 0, 0.001);
+  g_assert_cmpfloat_with_epsilon (out.origin.y, 0, 0.001);
+  g_assert_cmpfloat_with_epsilon (out.size.width, 20, 0.001);
+  g_assert_cmpfloat_with_epsilon (out.size.height, 50, 0.001);
+  gsk_transform_unref (t);
+
+  /* Flattening a 3D rotation only scales the plane */
+  t = gsk_transform_rotate_3d (NULL, 60, graphene_vec3_x_axis ());
+  g_assert_true (gsk_transform_untransform_bounds (t, &GRAPHENE_RECT_INIT (0, 0, 100, 50), &out));
+  g_assert_cmpfloat_with_epsilon (out.size.width, 100, 0.001);
+  g_assert_cmpfloat_with_epsilon (out.size.height, 100, 0.001);
+  gsk_transform_unref (t);
+
+  t = gsk_transform_rotate_3d (NULL, 90, graphene_vec3_x_axis ());
+  g_assert_false (gsk_transform_untransform_bounds (t, &GRAPHENE_RECT_INIT (0, 0, 100, 50), &out));
+  gsk_transform_unref (t);
+
+  t = gsk_transform_perspective (NULL, 100);
+  t = gsk_transform_rotate_3d (t, 30, graphene_vec3_y_axis ());
+  g_assert_false (gsk_transform_untransform_bounds (t, &GRAPHENE_RECT_INIT (0, 0, 100, 50), &out));
+  gsk_transform_unref (t);
+}
+
+static void
+test_shadow_cache (void)
+{
+  GskRoundedRect outline;
+  GskRenderNode *node1, *node2, *node3;
+  GskShadowSlice slices[GSK_SHADOW_CACHE_MAX_SLICES];
+  GdkTexture *texture1, *texture2, *texture3;
+  graphene_rect_t bounds;
+  guint i, n_slices;
+
+  gsk_rounded_rect_init_from_rect (&outline, &GRAPHENE_RECT_INIT (10, 10, 200, 100), 8);
+  node1 = gsk_outset_shadow_node_new (&outline, &(GdkRGBA) { 0, 0, 0, 0.5 }, 2, 3, 1, 10);
+  gsk_rounded_rect_init_from_rect (&outline, &GRAPHENE_RECT_INIT (50, 20, 300, 60), 8);
+  node2 = gsk_outset_shadow_node_new (&outline, &(GdkRGBA) { 1, 0, 0, 1 }, 2, 3, 1, 10);
+  gsk_rounded_rect_init_from_rect (&outline, &GRAPHENE_RECT_INIT (10, 10, 10, 10), 2);
+  node3 = gsk_outset_shadow_node_new (&outline, &(GdkRGBA) { 0, 0, 0, 0.5 }, 2, 3, 1, 10);
+
+  texture1 = gsk_shadow_cache_lookup (node1, 1, 1, NULL, slices, &n_slices);
+  g_assert_cmpuint (n_slices, ==, 9);
+  bounds = slices[0].rect;
+  for (i = 1; i < n_slices; i++)
+    graphene_rect_union (&bounds, &slices[i].rect, &bounds);
+  g_assert_true (graphene_rect_equal (&bounds, &node1->bounds));
+
+  /* Same style, different size */
+  texture2 = gsk_shadow_cache_lookup (node2, 1, 1, NULL, slices, &n_slices);
+  g_assert_cmpuint (n_slices, ==, 9);
+  g_assert_true (texture1 == texture2);
+
+  /* Too small to be sliced */
+  texture3 = gsk_shadow_cache_lookup (node3, 1, 1, NULL, slices, &n_slices);
+  g_assert_cmpuint (n_slices, ==, 1);
+  g_assert_true (graphene_rect_equal (&slices[0].rect, &node3->bounds));
+  g_assert_true (graphene_rect_equal (&slices[0].tex_rect, &GRAPHENE_RECT_INIT (node3->bounds.origin.x,
+                                                                                node3->bounds.origin.y,
+                                                                                gdk_texture_get_width (texture3),
+                                                                                gdk_texture_get_height (texture3))));
+
+  g_object_unref (texture1);
+  g_object_unref (texture2);
+  g_object_unref (texture3);
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  gsk_render_node_unref (node3);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -282,8 +612,16 @@ main (int argc, char *argv[])
   g_test_add_func ("/rendernode/border/uniform", test_bordernode_uniform);
   g_test_add_func ("/rendernode/conic-gradient/angle", test_conic_gradient_angle);
   g_test_add_func ("/rendernode/container/disjoint", test_container_disjoint);
+  g_test_add_func ("/rendernode/container/opaque", test_container_opaque);
+  g_test_add_func ("/rendernode/arena", test_node_arena);
+  g_test_add_func ("/transform/untransform-bounds", test_transform_untransform_bounds);
+  g_test_add_func ("/shadow-cache/slices", test_shadow_cache);
   g_test_add_func ("/renderer/cairo", test_cairo_renderer);
+  g_test_add_func ("/renderer/cairo/tiled", test_cairo_renderer_tiled);
   g_test_add_func ("/renderer/gl", test_gl_renderer);
+  g_test_add_func ("/renderer/cairo/render-textures", test_cairo_renderer_render_textures);
+  g_test_add_func ("/renderer/gl/render-textures", test_gl_renderer_render_textures);
+  g_test_add_func ("/renderer/gl/texture-depth", test_gl_renderer_texture_depth);
 
   return g_test_run ();
 }
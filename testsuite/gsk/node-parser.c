@@ -156,6 +156,42 @@ deserialize_error_func (const GskParseLocation *start,
   g_string_append_c (errors, '\n');
 }
 
+/* Checks that the binary format preserves everything the text format has */
+static gboolean
+check_binary_roundtrip (GskRenderNode *node,
+                        GBytes        *text)
+{
+  GskRenderNode *loaded;
+  GBytes *binary, *loaded_text;
+  gboolean result;
+
+  /* Cairo nodes are stored rasterized, their text form is different */
+  if (strstr (g_bytes_get_data (text, NULL), "cairo {") != NULL)
+    return TRUE;
+
+  binary = gsk_render_node_serialize_binary (node);
+  loaded = gsk_render_node_deserialize (binary, NULL, NULL);
+  g_bytes_unref (binary);
+
+  if (loaded == NULL)
+    {
+      g_print ("Failed to load binary serialization\n");
+      return FALSE;
+    }
+
+  loaded_text = gsk_render_node_serialize (loaded);
+  gsk_render_node_unref (loaded);
+
+  result = g_bytes_equal (text, loaded_text);
+  if (!result)
+    g_print ("Binary serialization doesn't roundtrip:\n%s\n",
+             (const char *) g_bytes_get_data (loaded_text, NULL));
+
+  g_bytes_unref (loaded_text);
+
+  return result;
+}
+
 static gboolean
 parse_node_file (GFile *file, gboolean generate)
 {
@@ -180,6 +216,10 @@ parse_node_file (GFile *file, gboolean generate)
   node = gsk_render_node_deserialize (bytes, deserialize_error_func, errors);
   g_bytes_unref (bytes);
   bytes = gsk_render_node_serialize (node);
+
+  if (!generate && errors->str[0] == '\0' && !check_binary_roundtrip (node, bytes))
+    result = FALSE;
+
   gsk_render_node_unref (node);
 
   if (generate)
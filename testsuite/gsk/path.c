@@ -774,6 +774,97 @@ test_in_fill_rotated (void)
 #undef N_FILL_RULES
 }
 
+static void
+test_measure_rect (void)
+{
+  GskPathBuilder *builder;
+  GskPath *path;
+  GskPathMeasure *measure;
+  GskPathPoint point;
+  graphene_point_t pos;
+
+  builder = gsk_path_builder_new ();
+  gsk_path_builder_add_rect (builder, &GRAPHENE_RECT_INIT (10, 20, 100, 50));
+  path = gsk_path_builder_free_to_path (builder);
+  measure = gsk_path_measure_new (path);
+
+  g_assert_cmpfloat_with_epsilon (gsk_path_measure_get_length (measure), 300, 0.001);
+
+  g_assert_true (gsk_path_measure_get_point (measure, 125, &point));
+  gsk_path_point_get_position (&point, path, &pos);
+  g_assert_cmpfloat_with_epsilon (pos.x, 110, 0.001);
+  g_assert_cmpfloat_with_epsilon (pos.y, 45, 0.001);
+
+  /* Out of range distances are clamped */
+  g_assert_true (gsk_path_measure_get_point (measure, -10, &point));
+  gsk_path_point_get_position (&point, path, &pos);
+  g_assert_cmpfloat_with_epsilon (pos.x, 10, 0.001);
+  g_assert_cmpfloat_with_epsilon (pos.y, 20, 0.001);
+
+  g_assert_true (gsk_path_measure_get_point (measure, 1000, &point));
+  gsk_path_point_get_position (&point, path, &pos);
+  g_assert_cmpfloat_with_epsilon (pos.x, 10, 0.001);
+  g_assert_cmpfloat_with_epsilon (pos.y, 20, 0.001);
+
+  gsk_path_measure_unref (measure);
+  gsk_path_unref (path);
+
+  /* Empty paths have no points */
+  builder = gsk_path_builder_new ();
+  path = gsk_path_builder_free_to_path (builder);
+  measure = gsk_path_measure_new (path);
+  g_assert_cmpfloat (gsk_path_measure_get_length (measure), ==, 0);
+  g_assert_false (gsk_path_measure_get_point (measure, 0, &point));
+  gsk_path_measure_unref (measure);
+  gsk_path_unref (path);
+}
+
+static void
+test_measure_points (void)
+{
+  GskPath *path;
+  GskPathMeasure *measure;
+  GskPathPoint point, last_point;
+  float length, tolerance, distance;
+  guint i, j;
+
+  for (i = 0; i < 100; i++)
+    {
+      path = create_random_path (G_MAXUINT);
+      tolerance = g_test_rand_double_range (0.1, 1);
+      measure = gsk_path_measure_new_with_tolerance (path, tolerance);
+
+      if (gsk_path_is_empty (path))
+        {
+          g_assert_false (gsk_path_measure_get_point (measure, 0, &point));
+          gsk_path_measure_unref (measure);
+          gsk_path_unref (path);
+          continue;
+        }
+
+      /* Query before the length is known, so contours get
+       * measured lazily */
+      g_assert_true (gsk_path_measure_get_point (measure, 0, &last_point));
+
+      length = gsk_path_measure_get_length (measure);
+      g_assert_cmpfloat (length, >=, 0);
+
+      /* Points are ordered along the path */
+      for (j = 1; j <= 100; j++)
+        {
+          distance = length * j / 100;
+
+          g_assert_true (gsk_path_measure_get_point (measure, distance, &point));
+          g_assert_cmpint (gsk_path_point_compare (&last_point, &point), <=, 0);
+
+          last_point = point;
+        }
+
+      gsk_path_measure_unref (measure);
+      gsk_path_unref (path);
+    }
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -784,6 +875,8 @@ main (int   argc,
   g_test_add_func ("/path/parse", test_parse);
   g_test_add_func ("/path/in-fill-union", test_in_fill_union);
   g_test_add_func ("/path/in-fill-rotated", test_in_fill_rotated);
+  g_test_add_func ("/path/measure/rect", test_measure_rect);
+  g_test_add_func ("/path/measure/points", test_measure_points);
 
   return g_test_run ();
 }
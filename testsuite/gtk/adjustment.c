@@ -139,6 +139,66 @@ test_clamp_page (void)
   g_object_unref (a);
 }
 
+static gboolean
+quit_loop (gpointer data)
+{
+  gboolean *timed_out = data;
+
+  *timed_out = TRUE;
+  g_main_context_wakeup (NULL);
+
+  return G_SOURCE_REMOVE;
+}
+
+static void
+test_coalesce (void)
+{
+  GtkAdjustment *a;
+  GtkWidget *window;
+  GdkFrameClock *clock;
+  gboolean timed_out = FALSE;
+  guint timeout_id;
+
+  a = gtk_adjustment_new (0.0, 0.0, 100.0, 1.0, 5.0, 0.0);
+  g_signal_connect (a, "value-changed", G_CALLBACK (value_changed_cb), NULL);
+
+  window = gtk_window_new ();
+  gtk_window_present (GTK_WINDOW (window));
+  clock = gtk_widget_get_frame_clock (window);
+  g_assert_nonnull (clock);
+
+  gtk_adjustment_set_coalesce_clock (a, clock);
+  g_assert_true (gtk_adjustment_get_coalesce_clock (a) == clock);
+
+  /* the value is updated right away, the signal waits for the frame */
+  value_changed_count = 0;
+  gtk_adjustment_set_value (a, 10.0);
+  gtk_adjustment_set_value (a, 20.0);
+  gtk_adjustment_set_value (a, 30.0);
+  g_assert_cmpfloat (gtk_adjustment_get_value (a), ==, 30.0);
+  g_assert_cmpint (value_changed_count, ==, 0);
+
+  timeout_id = g_timeout_add_seconds (5, quit_loop, &timed_out);
+  while (value_changed_count == 0 && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+  g_assert_false (timed_out);
+  g_source_remove (timeout_id);
+  g_assert_cmpint (value_changed_count, ==, 1);
+
+  /* turning it off emits pending changes */
+  value_changed_count = 0;
+  gtk_adjustment_set_value (a, 40.0);
+  g_assert_cmpint (value_changed_count, ==, 0);
+  gtk_adjustment_set_coalesce_clock (a, NULL);
+  g_assert_cmpint (value_changed_count, ==, 1);
+
+  gtk_adjustment_set_value (a, 50.0);
+  g_assert_cmpint (value_changed_count, ==, 2);
+
+  gtk_window_destroy (GTK_WINDOW (window));
+  g_object_unref (a);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -149,6 +209,7 @@ main (int   argc,
   g_test_add_func ("/adjustment/signals", test_signals);
   g_test_add_func ("/adjustment/clamp", test_clamp);
   g_test_add_func ("/adjustment/clamp_page", test_clamp_page);
+  g_test_add_func ("/adjustment/coalesce", test_coalesce);
 
   return g_test_run();
 }
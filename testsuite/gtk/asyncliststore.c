@@ -0,0 +1,158 @@
+/* GtkAsyncListStore tests
+ *
+ * Copyright (C) 2023, Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+
+#define N_THREADS 4
+#define N_ITEMS_PER_THREAD 1000
+
+static void
+items_changed (GListModel *model,
+               guint       position,
+               guint       removed,
+               guint       added,
+               guint      *n_changes)
+{
+  g_assert_cmpuint (removed, ==, 0);
+  g_assert_cmpuint (position + added, ==, g_list_model_get_n_items (model));
+
+  (*n_changes)++;
+}
+
+static void
+test_push (void)
+{
+  GtkAsyncListStore *store;
+  GtkStringObject *item;
+  guint n_changes = 0;
+  guint i;
+
+  store = gtk_async_list_store_new (GTK_TYPE_STRING_OBJECT);
+  g_signal_connect (store, "items-changed", G_CALLBACK (items_changed), &n_changes);
+
+  for (i = 0; i < 10; i++)
+    {
+      char *s = g_strdup_printf ("%u", i);
+      item = gtk_string_object_new (s);
+      gtk_async_list_store_push (store, item);
+      g_object_unref (item);
+      g_free (s);
+    }
+
+  /* nothing shows up before the flush */
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (store)), ==, 0);
+
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (store)), ==, 10);
+  g_assert_cmpuint (n_changes, ==, 1);
+
+  for (i = 0; i < 10; i++)
+    {
+      char *s = g_strdup_printf ("%u", i);
+      item = g_list_model_get_item (G_LIST_MODEL (store), i);
+      g_assert_cmpstr (gtk_string_object_get_string (item), ==, s);
+      g_object_unref (item);
+      g_free (s);
+    }
+
+  /* flushing without pending items does nothing */
+  gtk_async_list_store_flush (store);
+  g_assert_cmpuint (n_changes, ==, 1);
+
+  g_object_unref (store);
+}
+
+static gpointer
+push_thread (gpointer data)
+{
+  GtkAsyncListStore *store = data;
+  guint i;
+
+  for (i = 0; i < N_ITEMS_PER_THREAD; i++)
+    {
+      GtkStringObject *item = gtk_string_object_new ("item");
+      gtk_async_list_store_push (store, item);
+      g_object_unref (item);
+    }
+
+  return NULL;
+}
+
+static void
+test_threads (void)
+{
+  GtkAsyncListStore *store;
+  GThread *threads[N_THREADS];
+  guint n_changes = 0;
+  guint i;
+
+  store = gtk_async_list_store_new (GTK_TYPE_STRING_OBJECT);
+  g_signal_connect (store, "items-changed", G_CALLBACK (items_changed), &n_changes);
+
+  for (i = 0; i < N_THREADS; i++)
+    threads[i] = g_thread_new ("push", push_thread, store);
+
+  for (i = 0; i < N_THREADS; i++)
+    g_thread_join (threads[i]);
+
+  gtk_async_list_store_flush (store);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (store)), ==, N_THREADS * N_ITEMS_PER_THREAD);
+  g_assert_cmpuint (n_changes, ==, 1);
+
+  /* the queued flush finds nothing left to do */
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  g_assert_cmpuint (n_changes, ==, 1);
+
+  g_object_unref (store);
+}
+
+static void
+test_unflushed (void)
+{
+  GtkAsyncListStore *store;
+  GtkStringObject *item;
+
+  store = gtk_async_list_store_new (GTK_TYPE_STRING_OBJECT);
+  item = gtk_string_object_new ("item");
+  gtk_async_list_store_push (store, item);
+  g_object_unref (item);
+
+  /* the queued flush keeps the store alive */
+  g_object_add_weak_pointer (G_OBJECT (store), (gpointer *) &store);
+  g_object_unref (store);
+  g_assert_nonnull (store);
+
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  g_assert_null (store);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_func ("/asyncliststore/push", test_push);
+  g_test_add_func ("/asyncliststore/threads", test_threads);
+  g_test_add_func ("/asyncliststore/unflushed", test_unflushed);
+
+  return g_test_run ();
+}
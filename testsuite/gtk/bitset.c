@@ -559,6 +559,66 @@ test_splice_overflow (void)
   gtk_bitset_unref (set);
 }
 
+static void
+check_nth (GtkBitset *set)
+{
+  GtkBitsetIter iter;
+  guint value, n;
+  gboolean loop;
+
+  for (n = 0, loop = gtk_bitset_iter_init_first (&iter, set, &value);
+       loop;
+       n++, loop = gtk_bitset_iter_next (&iter, &value))
+    {
+      g_assert_cmpuint (gtk_bitset_get_nth (set, n), ==, value);
+    }
+
+  g_assert_cmpuint (gtk_bitset_get_size (set), ==, n);
+  g_assert_cmpuint (gtk_bitset_get_nth (set, n), ==, 0);
+}
+
+static void
+test_nth (void)
+{
+  GtkBitset *set, *copy;
+  guint i;
+
+  set = gtk_bitset_new_empty ();
+  check_nth (set);
+
+  /* a run, a dense and a sparse container */
+  gtk_bitset_add_range (set, 10, 100000);
+  for (i = 200000; i < 260000; i += 3)
+    gtk_bitset_add (set, i);
+  for (i = 300000; i < 500000; i += 1000)
+    gtk_bitset_add (set, i);
+  check_nth (set);
+
+  copy = gtk_bitset_copy (set);
+  check_nth (copy);
+
+  /* values must be found after every kind of change */
+  gtk_bitset_remove (set, 10);
+  check_nth (set);
+  gtk_bitset_remove_range (set, 50000, 1000);
+  check_nth (set);
+  gtk_bitset_add (set, G_MAXUINT);
+  check_nth (set);
+  gtk_bitset_splice (set, 100, 70000, 3);
+  check_nth (set);
+  gtk_bitset_intersect (set, copy);
+  check_nth (set);
+  gtk_bitset_subtract (copy, set);
+  check_nth (copy);
+  gtk_bitset_union (copy, set);
+  check_nth (copy);
+  gtk_bitset_remove_all (set);
+  check_nth (set);
+
+  gtk_bitset_unref (copy);
+  gtk_bitset_unref (set);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -579,6 +639,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/bitset/rectangle", test_rectangle);
   g_test_add_func ("/bitset/iter", test_iter);
   g_test_add_func ("/bitset/splice-overflow", test_splice_overflow);
+  g_test_add_func ("/bitset/nth", test_nth);
 
   return g_test_run ();
 }
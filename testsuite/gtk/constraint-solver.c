@@ -360,6 +360,139 @@ constraint_solver_paper (void)
   g_object_unref (solver);
 }
 
+static void
+constraint_solver_freeze (void)
+{
+  GtkConstraintSolver *solver = gtk_constraint_solver_new ();
+
+  GtkConstraintVariable *x = gtk_constraint_solver_create_variable (solver, NULL, "x", 0.0);
+  GtkConstraintVariable *y = gtk_constraint_solver_create_variable (solver, NULL, "y", 0.0);
+
+  gtk_constraint_solver_add_stay_variable (solver, x, GTK_CONSTRAINT_STRENGTH_WEAK);
+  gtk_constraint_solver_add_stay_variable (solver, y, GTK_CONSTRAINT_STRENGTH_WEAK);
+
+  gtk_constraint_solver_freeze (solver);
+
+  gtk_constraint_solver_add_constraint (solver,
+                                        x, GTK_CONSTRAINT_RELATION_EQ,
+                                        gtk_constraint_expression_new (30.0),
+                                        GTK_CONSTRAINT_STRENGTH_MEDIUM);
+  gtk_constraint_solver_add_constraint (solver,
+                                        y, GTK_CONSTRAINT_RELATION_EQ,
+                                        gtk_constraint_expression_new_from_variable (x),
+                                        GTK_CONSTRAINT_STRENGTH_REQUIRED);
+
+  gtk_constraint_solver_thaw (solver);
+
+  g_test_message ("Check values after thawing");
+
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (x), 30.0, 0.001);
+  g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (y), 30.0, 0.001);
+
+  gtk_constraint_variable_unref (x);
+  gtk_constraint_variable_unref (y);
+
+  g_object_unref (solver);
+}
+
+static void
+constraint_solver_resize (void)
+{
+  GtkConstraintSolver *solver = gtk_constraint_solver_new ();
+  guint n_boxes = g_test_perf () ? 200 : 20;
+  guint n_resizes = g_test_perf () ? 1000 : 10;
+  GtkConstraintVariable **left, **width;
+  GtkConstraintVariable *total;
+  GtkConstraintExpressionBuilder builder;
+  GtkConstraintExpression *expr;
+  double elapsed;
+  guint i;
+
+  /* A row of boxes of the same width, filling the total width */
+  left = g_new (GtkConstraintVariable *, n_boxes);
+  width = g_new (GtkConstraintVariable *, n_boxes);
+  total = gtk_constraint_solver_create_variable (solver, NULL, "total", 0.0);
+
+  gtk_constraint_solver_freeze (solver);
+
+  for (i = 0; i < n_boxes; i++)
+    {
+      left[i] = gtk_constraint_solver_create_variable (solver, NULL, "left", 0.0);
+      width[i] = gtk_constraint_solver_create_variable (solver, NULL, "width", 0.0);
+
+      if (i == 0)
+        {
+          expr = gtk_constraint_expression_new (0.0);
+        }
+      else
+        {
+          gtk_constraint_expression_builder_init (&builder, solver);
+          gtk_constraint_expression_builder_term (&builder, left[i - 1]);
+          gtk_constraint_expression_builder_plus (&builder);
+          gtk_constraint_expression_builder_term (&builder, width[i - 1]);
+          expr = gtk_constraint_expression_builder_finish (&builder);
+
+          gtk_constraint_solver_add_constraint (solver,
+                                                width[i], GTK_CONSTRAINT_RELATION_EQ,
+                                                gtk_constraint_expression_new_from_variable (width[i - 1]),
+                                                GTK_CONSTRAINT_STRENGTH_MEDIUM);
+        }
+
+      gtk_constraint_solver_add_constraint (solver,
+                                            left[i], GTK_CONSTRAINT_RELATION_EQ, expr,
+                                            GTK_CONSTRAINT_STRENGTH_REQUIRED);
+      gtk_constraint_solver_add_constraint (solver,
+                                            width[i], GTK_CONSTRAINT_RELATION_GE,
+                                            gtk_constraint_expression_new (10.0),
+                                            GTK_CONSTRAINT_STRENGTH_REQUIRED);
+    }
+
+  gtk_constraint_expression_builder_init (&builder, solver);
+  gtk_constraint_expression_builder_term (&builder, left[n_boxes - 1]);
+  gtk_constraint_expression_builder_plus (&builder);
+  gtk_constraint_expression_builder_term (&builder, width[n_boxes - 1]);
+  expr = gtk_constraint_expression_builder_finish (&builder);
+  gtk_constraint_solver_add_constraint (solver,
+                                        total, GTK_CONSTRAINT_RELATION_EQ, expr,
+                                        GTK_CONSTRAINT_STRENGTH_REQUIRED);
+
+  gtk_constraint_solver_thaw (solver);
+
+  /* Resizing only suggests new values for the edit variable */
+  gtk_constraint_solver_add_edit_variable (solver, total, GTK_CONSTRAINT_STRENGTH_STRONG);
+  gtk_constraint_solver_begin_edit (solver);
+
+  g_test_timer_start ();
+
+  for (i = 0; i < n_resizes; i++)
+    {
+      double value = 10.0 * n_boxes + i;
+
+      gtk_constraint_solver_suggest_value (solver, total, value);
+      gtk_constraint_solver_resolve (solver);
+
+      g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width[0]), value / n_boxes, 0.001);
+      g_assert_cmpfloat_with_epsilon (gtk_constraint_variable_get_value (width[n_boxes - 1]), value / n_boxes, 0.001);
+    }
+
+  elapsed = g_test_timer_elapsed ();
+  if (g_test_perf ())
+    g_test_minimized_result (elapsed, "resizing %u boxes %u times: %gsec", n_boxes, n_resizes, elapsed);
+
+  gtk_constraint_solver_end_edit (solver);
+
+  for (i = 0; i < n_boxes; i++)
+    {
+      gtk_constraint_variable_unref (left[i]);
+      gtk_constraint_variable_unref (width[i]);
+    }
+  gtk_constraint_variable_unref (total);
+  g_free (left);
+  g_free (width);
+
+  g_object_unref (solver);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -376,6 +509,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/constraint-solver/cassowary", constraint_solver_cassowary);
   g_test_add_func ("/constraint-solver/edit/required", constraint_solver_edit_var_required);
   g_test_add_func ("/constraint-solver/edit/suggest", constraint_solver_edit_var_suggest);
+  g_test_add_func ("/constraint-solver/freeze", constraint_solver_freeze);
+  g_test_add_func ("/constraint-solver/resize", constraint_solver_resize);
 
   return g_test_run ();
 }
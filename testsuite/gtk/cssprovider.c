@@ -33,6 +33,77 @@ test_section_load_nonexisting_file (void)
   g_object_unref (provider);
 }
 
+static void
+test_load_named_twice (void)
+{
+  GtkCssProvider *provider1, *provider2;
+  char *str1, *str2;
+
+  provider1 = gtk_css_provider_new ();
+  gtk_css_provider_load_named (provider1, "Default", NULL);
+  provider2 = gtk_css_provider_new ();
+  gtk_css_provider_load_named (provider2, "Default", NULL);
+
+  str1 = gtk_css_provider_to_string (provider1);
+  str2 = gtk_css_provider_to_string (provider2);
+  g_assert_cmpstr (str1, !=, "");
+  g_assert_cmpstr (str1, ==, str2);
+  g_free (str2);
+
+  /* Loading something else must not affect the other provider */
+  gtk_css_provider_load_from_string (provider2, "label { color: red; }");
+  str2 = gtk_css_provider_to_string (provider1);
+  g_assert_cmpstr (str1, ==, str2);
+
+  g_free (str1);
+  g_free (str2);
+  g_object_unref (provider1);
+  g_object_unref (provider2);
+}
+
+static void
+test_set_color (void)
+{
+  GtkCssProvider *provider1, *provider2;
+  GdkRGBA color = { 0, 0, 1, 1 };
+  char *str1, *str2;
+
+  provider1 = gtk_css_provider_new ();
+  gtk_css_provider_load_from_string (provider1,
+                                     "@define-color accent red;\n"
+                                     "label { color: @accent; }");
+  gtk_css_provider_set_color (provider1, "accent", &color);
+  str1 = gtk_css_provider_to_string (provider1);
+  g_assert_nonnull (strstr (str1, "@define-color accent rgb(0,0,255);"));
+  g_assert_nonnull (strstr (str1, "color: @accent;"));
+  g_free (str1);
+
+  /* Setting a color on a provider sharing a theme must not
+   * affect the other providers
+   */
+  provider2 = gtk_css_provider_new ();
+  gtk_css_provider_load_named (provider2, "Default", NULL);
+  str2 = gtk_css_provider_to_string (provider2);
+  gtk_css_provider_load_named (provider1, "Default", NULL);
+  gtk_css_provider_set_color (provider1, "accent", &color);
+  str1 = gtk_css_provider_to_string (provider1);
+  g_assert_nonnull (strstr (str1, "@define-color accent rgb(0,0,255);"));
+  g_free (str1);
+  str1 = gtk_css_provider_to_string (provider2);
+  g_assert_cmpstr (str1, ==, str2);
+  g_free (str1);
+  g_free (str2);
+
+  /* Loading again drops the color */
+  gtk_css_provider_load_from_string (provider1, "label { color: @accent; }");
+  str1 = gtk_css_provider_to_string (provider1);
+  g_assert_null (strstr (str1, "@define-color"));
+  g_free (str1);
+
+  g_object_unref (provider1);
+  g_object_unref (provider2);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -41,6 +112,8 @@ main (int argc, char *argv[])
 
   g_test_add_func ("/cssprovider/section-in-load-from-data", test_section_in_load_from_data);
   g_test_add_func ("/cssprovider/load-nonexisting-file", test_section_load_nonexisting_file);
+  g_test_add_func ("/cssprovider/load-named-twice", test_load_named_twice);
+  g_test_add_func ("/cssprovider/set-color", test_set_color);
 
   return g_test_run ();
 }
@@ -0,0 +1,176 @@
+/* GtkDirectoryList tests
+ *
+ * Copyright (C) 2023, Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+#define N_FILES 200
+
+static char *
+create_directory (void)
+{
+  GError *error = NULL;
+  char *dir;
+  guint i;
+
+  dir = g_dir_make_tmp ("directorylist-XXXXXX", &error);
+  g_assert_no_error (error);
+
+  for (i = 0; i < N_FILES; i++)
+    {
+      char *name = g_strdup_printf ("file%u", i);
+      char *path = g_build_filename (dir, name, NULL);
+
+      g_file_set_contents (path, name, -1, &error);
+      g_assert_no_error (error);
+
+      g_free (path);
+      g_free (name);
+    }
+
+  return dir;
+}
+
+static void
+remove_directory (const char *dir)
+{
+  guint i;
+
+  for (i = 0; i < N_FILES; i++)
+    {
+      char *name = g_strdup_printf ("file%u", i);
+      char *path = g_build_filename (dir, name, NULL);
+
+      g_unlink (path);
+
+      g_free (path);
+      g_free (name);
+    }
+
+  g_rmdir (dir);
+}
+
+static void
+items_changed (GListModel *model,
+               guint       position,
+               guint       removed,
+               guint       added,
+               guint      *counter)
+{
+  *counter += 1;
+}
+
+static void
+wait_for_loading (GtkDirectoryList *list)
+{
+  while (gtk_directory_list_is_loading (list))
+    g_main_context_iteration (NULL, TRUE);
+}
+
+static void
+test_batch_size (void)
+{
+  GtkDirectoryList *list;
+  GFile *file;
+  char *dir;
+  guint counter = 0;
+
+  dir = create_directory ();
+  file = g_file_new_for_path (dir);
+
+  list = gtk_directory_list_new ("standard::*", NULL);
+  g_assert_cmpuint (gtk_directory_list_get_batch_size (list), ==, 0);
+  gtk_directory_list_set_batch_size (list, 3);
+  g_assert_cmpuint (gtk_directory_list_get_batch_size (list), ==, 3);
+  gtk_directory_list_set_monitored (list, FALSE);
+  g_signal_connect (list, "items-changed", G_CALLBACK (items_changed), &counter);
+
+  gtk_directory_list_set_file (list, file);
+  wait_for_loading (list);
+
+  g_assert_no_error (gtk_directory_list_get_error (list));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, N_FILES);
+  /* changes are coalesced, so we must not see one per batch */
+  g_assert_cmpuint (counter, <, (N_FILES + 2) / 3);
+
+  g_object_unref (list);
+  g_object_unref (file);
+  remove_directory (dir);
+  g_free (dir);
+}
+
+static void
+test_lazy_attributes (void)
+{
+  GtkDirectoryList *list;
+  GFileInfo *info;
+  GFile *file;
+  char *dir;
+  guint counter = 0;
+
+  dir = create_directory ();
+  file = g_file_new_for_path (dir);
+
+  list = gtk_directory_list_new (G_FILE_ATTRIBUTE_STANDARD_TYPE, NULL);
+  gtk_directory_list_set_lazy_attributes (list, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  g_assert_cmpstr (gtk_directory_list_get_lazy_attributes (list), ==, G_FILE_ATTRIBUTE_STANDARD_SIZE);
+  gtk_directory_list_set_monitored (list, FALSE);
+  gtk_directory_list_set_file (list, file);
+  wait_for_loading (list);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, N_FILES);
+
+  g_signal_connect (list, "items-changed", G_CALLBACK (items_changed), &counter);
+
+  info = g_list_model_get_item (G_LIST_MODEL (list), 5);
+  g_assert_true (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_TYPE));
+  g_assert_false (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_SIZE));
+  g_object_unref (info);
+
+  while (counter == 0)
+    g_main_context_iteration (NULL, TRUE);
+
+  /* only the requested item was queried */
+  g_assert_cmpuint (counter, ==, 1);
+
+  info = g_list_model_get_item (G_LIST_MODEL (list), 5);
+  g_assert_true (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_TYPE));
+  g_assert_true (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_SIZE));
+  g_assert_true (g_file_info_has_attribute (info, "standard::file"));
+  g_object_unref (info);
+
+  info = g_list_model_get_item (G_LIST_MODEL (list), 6);
+  g_assert_false (g_file_info_has_attribute (info, G_FILE_ATTRIBUTE_STANDARD_SIZE));
+  g_object_unref (info);
+
+  g_object_unref (list);
+  g_object_unref (file);
+  remove_directory (dir);
+  g_free (dir);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_func ("/directorylist/batch-size", test_batch_size);
+  g_test_add_func ("/directorylist/lazy-attributes", test_lazy_attributes);
+
+  return g_test_run ();
+}
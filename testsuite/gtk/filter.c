@@ -324,6 +324,102 @@ test_string_properties (void)
   g_object_unref (filter);
 }
 
+/* The filter caches prepared strings per item, make sure it notices
+ * when the item's string changes and when items go away.
+ */
+static void
+test_string_changed_item (void)
+{
+  GtkFilter *filter;
+  GObject *object, *other;
+
+  filter = GTK_FILTER (gtk_string_filter_new (
+               gtk_cclosure_expression_new (G_TYPE_STRING,
+                                            NULL,
+                                            0, NULL,
+                                            G_CALLBACK (get_string),
+                                            NULL, NULL)));
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+
+  object = g_object_new (G_TYPE_OBJECT, NULL);
+  other = g_object_new (G_TYPE_OBJECT, NULL);
+  g_object_set_qdata (object, number_quark, GUINT_TO_POINTER (12));
+  g_object_set_qdata (other, number_quark, GUINT_TO_POINTER (23));
+
+  g_assert_true (gtk_filter_match (filter, object));
+  g_assert_false (gtk_filter_match (filter, other));
+
+  g_object_set_qdata (object, number_quark, GUINT_TO_POINTER (22));
+  g_object_set_qdata (other, number_quark, GUINT_TO_POINTER (31));
+  g_assert_false (gtk_filter_match (filter, object));
+  g_assert_true (gtk_filter_match (filter, other));
+
+  g_object_unref (object);
+  g_assert_true (gtk_filter_match (filter, other));
+
+  g_object_unref (filter);
+  g_object_unref (other);
+}
+
+static guint n_evaluations;
+
+static char *
+get_string_counted (gpointer object)
+{
+  n_evaluations++;
+
+  return get_string (object);
+}
+
+/* Going back to a previous search must not look at the items again */
+static void
+test_string_history (void)
+{
+  GtkFilterListModel *model;
+  GtkFilter *filter, *every;
+
+  filter = GTK_FILTER (gtk_string_filter_new (
+               gtk_cclosure_expression_new (G_TYPE_STRING,
+                                            NULL,
+                                            0, NULL,
+                                            G_CALLBACK (get_string_counted),
+                                            NULL, NULL)));
+  every = GTK_FILTER (gtk_every_filter_new ());
+  gtk_multi_filter_append (GTK_MULTI_FILTER (every), g_object_ref (filter));
+
+  model = new_model (100, every);
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+  assert_model (model, "1 10 11 12 13 14 15 16 17 18 19 21 31 41 51 61 71 81 91 100");
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "12");
+  assert_model (model, "12");
+
+  n_evaluations = 0;
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+  assert_model (model, "1 10 11 12 13 14 15 16 17 18 19 21 31 41 51 61 71 81 91 100");
+  g_assert_cmpuint (n_evaluations, ==, 0);
+
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), NULL);
+  assert_model (model, "1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20 21 22 23 24 25 26 27 28 29 30 31 32 33 34 35 36 37 38 39 40 41 42 43 44 45 46 47 48 49 50 51 52 53 54 55 56 57 58 59 60 61 62 63 64 65 66 67 68 69 70 71 72 73 74 75 76 77 78 79 80 81 82 83 84 85 86 87 88 89 90 91 92 93 94 95 96 97 98 99 100");
+
+  n_evaluations = 0;
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+  assert_model (model, "1 10 11 12 13 14 15 16 17 18 19 21 31 41 51 61 71 81 91 100");
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "12");
+  assert_model (model, "12");
+  g_assert_cmpuint (n_evaluations, ==, 0);
+
+  /* a different filter must not reuse old results */
+  gtk_string_filter_set_match_mode (GTK_STRING_FILTER (filter), GTK_STRING_FILTER_MATCH_MODE_EXACT);
+  gtk_string_filter_set_search (GTK_STRING_FILTER (filter), "1");
+  assert_model (model, "1");
+  g_assert_cmpuint (n_evaluations, >, 0);
+
+  g_object_unref (model);
+  g_object_unref (every);
+  g_object_unref (filter);
+}
+
 static void
 test_bool_simple (void)
 {
@@ -405,6 +501,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/filter/any/simple", test_any_simple);
   g_test_add_func ("/filter/string/simple", test_string_simple);
   g_test_add_func ("/filter/string/properties", test_string_properties);
+  g_test_add_func ("/filter/string/changed-item", test_string_changed_item);
+  g_test_add_func ("/filter/string/history", test_string_history);
   g_test_add_func ("/filter/bool/simple", test_bool_simple);
   g_test_add_func ("/filter/every/dispose", test_every_dispose);
 
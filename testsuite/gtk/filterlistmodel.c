@@ -398,6 +398,73 @@ test_incremental (void)
   g_object_unref (filter);
 }
 
+static void
+assert_same_items (GListModel *model1,
+                   GListModel *model2)
+{
+  guint i, n;
+
+  n = g_list_model_get_n_items (model1);
+  g_assert_cmpuint (g_list_model_get_n_items (model2), ==, n);
+
+  for (i = 0; i < n; i++)
+    {
+      gpointer item1 = g_list_model_get_item (model1, i);
+      gpointer item2 = g_list_model_get_item (model2, i);
+
+      g_assert_true (item1 == item2);
+
+      g_object_unref (item1);
+      g_object_unref (item2);
+    }
+}
+
+static void
+test_parallel (void)
+{
+  GtkStringList *list;
+  GtkStringFilter *string_filter;
+  GtkFilter *every;
+  GtkFilterListModel *serial, *parallel;
+  guint i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 100000; i++)
+    {
+      char *s = g_strdup_printf ("%u", i);
+      gtk_string_list_take (list, s);
+    }
+
+  string_filter = gtk_string_filter_new (gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string"));
+  every = GTK_FILTER (gtk_every_filter_new ());
+  gtk_multi_filter_append (GTK_MULTI_FILTER (every), GTK_FILTER (string_filter));
+
+  serial = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), g_object_ref (every));
+  parallel = gtk_filter_list_model_new (g_object_ref (G_LIST_MODEL (list)), NULL);
+  gtk_filter_list_model_set_parallel (parallel, TRUE);
+  g_assert_true (gtk_filter_list_model_get_parallel (parallel));
+  gtk_filter_list_model_set_filter (parallel, every);
+
+  gtk_string_filter_set_search (string_filter, "1");
+  assert_same_items (G_LIST_MODEL (serial), G_LIST_MODEL (parallel));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (parallel)), ==, 40951);
+
+  gtk_string_filter_set_search (string_filter, "12");
+  assert_same_items (G_LIST_MODEL (serial), G_LIST_MODEL (parallel));
+
+  gtk_string_filter_set_search (string_filter, "2");
+  assert_same_items (G_LIST_MODEL (serial), G_LIST_MODEL (parallel));
+
+  gtk_string_filter_set_match_mode (string_filter, GTK_STRING_FILTER_MATCH_MODE_PREFIX);
+  assert_same_items (G_LIST_MODEL (serial), G_LIST_MODEL (parallel));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (parallel)), ==, 11111);
+
+  g_object_unref (serial);
+  g_object_unref (parallel);
+  g_object_unref (every);
+  g_object_unref (list);
+}
+
 static void
 test_empty (void)
 {
@@ -577,6 +644,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/filterlistmodel/empty", test_empty);
   g_test_add_func ("/filterlistmodel/add_remove_item", test_add_remove_item);
   g_test_add_func ("/filterlistmodel/sections", test_sections);
+  g_test_add_func ("/filterlistmodel/parallel", test_parallel);
 
   return g_test_run ();
 }
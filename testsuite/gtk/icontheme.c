@@ -752,6 +752,88 @@ test_nonsquare_symbolic (void)
   g_object_unref (info);
 }
 
+static GskRenderNode *
+snapshot_icon (const char *icon_name,
+               int         size)
+{
+  GtkIconPaintable *info;
+  GtkSnapshot *snapshot;
+
+  info = gtk_icon_theme_lookup_icon (get_test_icontheme (TRUE), icon_name, NULL, size, 1, GTK_TEXT_DIR_NONE, 0);
+  snapshot = gtk_snapshot_new ();
+  gdk_paintable_snapshot (GDK_PAINTABLE (info), snapshot, size, size);
+  g_object_unref (info);
+
+  return gtk_snapshot_free_to_node (snapshot);
+}
+
+static void
+test_raster_cache (void)
+{
+  GskRenderNode *node1, *node2;
+  graphene_rect_t bounds1, bounds2;
+  const char *name;
+  char *path;
+  GDir *dir;
+  guint n_files;
+
+  node1 = snapshot_icon ("twosize-fixed", 40);
+
+  /* the rendering ended up on disk */
+  path = g_build_filename (g_get_user_cache_dir (), "gtk-4.0", "icons", NULL);
+  dir = g_dir_open (path, 0, NULL);
+  g_assert_nonnull (dir);
+  n_files = 0;
+  while ((name = g_dir_read_name (dir)) != NULL)
+    n_files++;
+  g_assert_cmpuint (n_files, >, 0);
+  g_dir_close (dir);
+
+  /* and a fresh theme can use it */
+  node2 = snapshot_icon ("twosize-fixed", 40);
+  gsk_render_node_get_bounds (node1, &bounds1);
+  gsk_render_node_get_bounds (node2, &bounds2);
+  g_assert_true (graphene_rect_equal (&bounds1, &bounds2));
+
+  gsk_render_node_unref (node1);
+  gsk_render_node_unref (node2);
+  g_free (path);
+}
+
+static void
+test_cache_budget (void)
+{
+  GtkIconTheme *icon_theme;
+  GtkSettings *settings;
+  GtkIconPaintable *info;
+  const char *current_dir[2];
+
+  icon_theme = gtk_icon_theme_get_for_display (gdk_display_get_default ());
+  gtk_icon_theme_set_theme_name (icon_theme, "icons");
+  current_dir[0] = g_test_get_dir (G_TEST_DIST);
+  current_dir[1] = NULL;
+  gtk_icon_theme_set_search_path (icon_theme, current_dir);
+  settings = gtk_settings_get_for_display (gdk_display_get_default ());
+
+  /* recently used icons are kept alive */
+  info = gtk_icon_theme_lookup_icon (icon_theme, "twosize-fixed", NULL, 16, 1, GTK_TEXT_DIR_NONE, 0);
+  g_object_add_weak_pointer (G_OBJECT (info), (gpointer *) &info);
+  g_object_unref (info);
+  g_assert_nonnull (info);
+
+  /* until the budget shrinks */
+  g_object_set (settings, "gtk-icon-cache-size", 0, NULL);
+  g_assert_null (info);
+
+  /* and without a budget, nothing is kept */
+  info = gtk_icon_theme_lookup_icon (icon_theme, "twosize-fixed", NULL, 16, 1, GTK_TEXT_DIR_NONE, 0);
+  g_object_add_weak_pointer (G_OBJECT (info), (gpointer *) &info);
+  g_object_unref (info);
+  g_assert_null (info);
+
+  gtk_settings_reset_property (settings, "gtk-icon-cache-size");
+}
+
 static void
 require_env (const char *var)
 {
@@ -762,8 +844,14 @@ require_env (const char *var)
 int
 main (int argc, char *argv[])
 {
+  char *cache_dir;
+
   require_env ("G_TEST_SRCDIR");
 
+  /* Don't leave rasterized icons in the user's cache */
+  cache_dir = g_dir_make_tmp ("icontheme-XXXXXX", NULL);
+  g_setenv ("XDG_CACHE_HOME", cache_dir, TRUE);
+
   gtk_test_init (&argc, &argv);
 
   g_test_add_func ("/icontheme/basics", test_basics);
@@ -773,6 +861,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/icontheme/rtl", test_rtl);
   g_test_add_func ("/icontheme/symbolic-single-size", test_symbolic_single_size);
   g_test_add_func ("/icontheme/svg-size", test_svg_size);
+  g_test_add_func ("/icontheme/raster-cache", test_raster_cache);
+  g_test_add_func ("/icontheme/cache-budget", test_cache_budget);
   g_test_add_func ("/icontheme/size", test_size);
   g_test_add_func ("/icontheme/list", test_list);
   g_test_add_func ("/icontheme/inherit", test_inherit);
@@ -37,6 +37,89 @@ test_font_dialog_button_new (void)
   g_object_unref (button);
 }
 
+static void
+test_widget_fixed_size (void)
+{
+  GtkWidget *box, *label;
+  int nat, label_nat, new_nat;
+
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 0);
+  g_object_ref_sink (box);
+  label = gtk_label_new ("a");
+  gtk_box_append (GTK_BOX (box), label);
+
+  gtk_widget_set_fixed_size (box, TRUE);
+  g_assert_true (gtk_widget_get_fixed_size (box));
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &nat, NULL, NULL);
+
+  /* resizes of the child stop at the box */
+  gtk_label_set_text (GTK_LABEL (label), "a much longer text");
+  gtk_widget_measure (label, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &label_nat, NULL, NULL);
+  g_assert_cmpint (label_nat, >, nat);
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &new_nat, NULL, NULL);
+  g_assert_cmpint (new_nat, ==, nat);
+
+  gtk_widget_set_fixed_size (box, FALSE);
+  gtk_widget_measure (box, GTK_ORIENTATION_HORIZONTAL, -1, NULL, &new_nat, NULL, NULL);
+  g_assert_cmpint (new_nat, ==, label_nat);
+
+  g_object_unref (box);
+}
+
+static GtkWidget *
+create_label (GtkStack   *stack,
+              const char *name,
+              gpointer    data)
+{
+  guint *n_created = data;
+
+  (*n_created)++;
+
+  return gtk_label_new (name);
+}
+
+static void
+test_stack_lazy (void)
+{
+  GtkWidget *stack;
+  GtkStackPage *page;
+  guint n_created = 0;
+  char name[10];
+  guint i;
+
+  stack = gtk_stack_new ();
+  g_object_ref_sink (stack);
+
+  for (i = 0; i < 5; i++)
+    {
+      g_snprintf (name, sizeof (name), "page%u", i);
+      gtk_stack_add_lazy (GTK_STACK (stack), name, NULL, create_label, &n_created, NULL);
+    }
+
+  /* the first page is visible, so it is created right away */
+  g_assert_cmpuint (n_created, ==, 1);
+  page = gtk_stack_get_page (GTK_STACK (stack), gtk_stack_get_visible_child (GTK_STACK (stack)));
+  g_assert_cmpstr (gtk_stack_page_get_name (page), ==, "page0");
+  g_assert_true (GTK_IS_LABEL (gtk_widget_get_first_child (gtk_stack_page_get_child (page))));
+
+  /* its neighbour is created when idle */
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  g_assert_cmpuint (n_created, ==, 2);
+
+  /* showing a page creates it, and only once */
+  gtk_stack_set_visible_child_name (GTK_STACK (stack), "page3");
+  g_assert_cmpuint (n_created, ==, 3);
+  while (g_main_context_pending (NULL))
+    g_main_context_iteration (NULL, FALSE);
+  g_assert_cmpuint (n_created, ==, 5);
+
+  gtk_stack_set_visible_child_name (GTK_STACK (stack), "page1");
+  g_assert_cmpuint (n_created, ==, 5);
+
+  g_object_unref (stack);
+}
+
 int
 main (int   argc,
       char *argv[])
@@ -45,6 +128,8 @@ main (int   argc,
 
   g_test_add_func ("/colordialogbutton/new", test_color_dialog_button_new);
   g_test_add_func ("/fontdialogbutton/new", test_font_dialog_button_new);
+  g_test_add_func ("/widget/fixed-size", test_widget_fixed_size);
+  g_test_add_func ("/stack/lazy", test_stack_lazy);
 
   return g_test_run();
 }
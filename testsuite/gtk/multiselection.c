@@ -555,6 +555,37 @@ test_readd (void)
   g_object_unref (selection);
 }
 
+static void
+test_select_all_large (void)
+{
+  GtkSelectionModel *selection;
+  GtkBitset *selected;
+  GListStore *store;
+
+  store = new_store (1, 200000, 1);
+  selection = GTK_SELECTION_MODEL (gtk_multi_selection_new (g_object_ref (G_LIST_MODEL (store))));
+
+  g_assert_true (gtk_selection_model_select_all (selection));
+  selected = gtk_selection_model_get_selection (selection);
+  g_assert_cmpuint (gtk_bitset_get_size (selected), ==, 200000);
+  gtk_bitset_unref (selected);
+
+  g_assert_true (gtk_selection_model_unselect_all (selection));
+  selected = gtk_selection_model_get_selection (selection);
+  g_assert_true (gtk_bitset_is_empty (selected));
+  gtk_bitset_unref (selected);
+
+  /* small selections remember their items again */
+  g_assert_true (gtk_selection_model_select_range (selection, 2, 2, FALSE));
+  g_list_model_items_changed (G_LIST_MODEL (store), 1, 3, 3);
+  g_assert_true (gtk_selection_model_is_selected (selection, 2));
+  g_assert_true (gtk_selection_model_is_selected (selection, 3));
+  g_assert_false (gtk_selection_model_is_selected (selection, 1));
+
+  g_object_unref (store);
+  g_object_unref (selection);
+}
+
 static void
 test_set_selection (void)
 {
@@ -879,6 +910,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/multiselection/selection", test_selection);
   g_test_add_func ("/multiselection/select-range", test_select_range);
   g_test_add_func ("/multiselection/readd", test_readd);
+  g_test_add_func ("/multiselection/select-all-large", test_select_all_large);
   g_test_add_func ("/multiselection/set_selection", test_set_selection);
   g_test_add_func ("/multiselection/selection-filter", test_selection_filter);
   g_test_add_func ("/multiselection/set-model", test_set_model);
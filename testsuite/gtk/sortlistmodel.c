@@ -707,6 +707,78 @@ test_sections (void)
   g_object_unref (model);
 }
 
+static void
+test_item_changed (void)
+{
+  GtkSortListModel *sort;
+  GListStore *store;
+  GObject *object;
+
+  store = new_store ((guint[]) { 4, 8, 2, 6, 10, 0 });
+  sort = new_model (store);
+  assert_model (sort, "2 4 6 8 10");
+  assert_changes (sort, "");
+
+  object = g_list_model_get_item (G_LIST_MODEL (store), 0);
+  g_object_set_qdata (object, number_quark, GUINT_TO_POINTER (9));
+  gtk_sorter_item_changed (gtk_sort_list_model_get_sorter (sort), object);
+  g_object_unref (object);
+  assert_model (sort, "2 6 8 9 10");
+  assert_changes (sort, "1-3+3");
+
+  g_object_unref (store);
+  g_object_unref (sort);
+}
+
+/* Large models with threadsafe sort keys get sorted in parallel
+ * runs that are merged afterwards. Make sure the result is still
+ * correct and only announced once.
+ */
+static void
+test_parallel (void)
+{
+  GtkStringList *list;
+  GtkSortListModel *model;
+  GtkStringSorter *sorter;
+  GString *changes;
+  guint i, n_items;
+
+  n_items = 200000;
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < n_items; i++)
+    {
+      char *s = g_strdup_printf ("%08u", g_random_int_range (0, n_items / 2));
+      gtk_string_list_take (list, s);
+    }
+
+  sorter = gtk_string_sorter_new (gtk_property_expression_new (GTK_TYPE_STRING_OBJECT, NULL, "string"));
+  gtk_string_sorter_set_collation (sorter, GTK_COLLATION_NONE);
+  model = gtk_sort_list_model_new (NULL, GTK_SORTER (sorter));
+
+  changes = g_string_new ("");
+  g_signal_connect (model, "items-changed", G_CALLBACK (items_changed), changes);
+
+  gtk_sort_list_model_set_model (model, G_LIST_MODEL (list));
+  g_assert_cmpstr (changes->str, ==, "0+200000");
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (model)), ==, n_items);
+
+  for (i = 1; i < n_items; i++)
+    {
+      GtkStringObject *a = g_list_model_get_item (G_LIST_MODEL (model), i - 1);
+      GtkStringObject *b = g_list_model_get_item (G_LIST_MODEL (model), i);
+
+      g_assert_cmpstr (gtk_string_object_get_string (a), <=, gtk_string_object_get_string (b));
+
+      g_object_unref (a);
+      g_object_unref (b);
+    }
+
+  g_signal_handlers_disconnect_by_func (model, items_changed, changes);
+  g_string_free (changes, TRUE);
+  g_object_unref (list);
+  g_object_unref (model);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -727,6 +799,8 @@ main (int argc, char *argv[])
   g_test_add_func ("/sortlistmodel/oob-access", test_out_of_bounds_access);
   g_test_add_func ("/sortlistmodel/add-remove-item", test_add_remove_item);
   g_test_add_func ("/sortlistmodel/sections", test_sections);
+  g_test_add_func ("/sortlistmodel/item-changed", test_item_changed);
+  g_test_add_func ("/sortlistmodel/parallel", test_parallel);
 
   return g_test_run ();
 }
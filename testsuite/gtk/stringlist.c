@@ -261,6 +261,41 @@ test_take (void)
   g_object_unref (list);
 }
 
+static void
+test_splice_bytes (void)
+{
+  GtkStringList *list;
+  GBytes *bytes;
+  gpointer item;
+
+  list = new_model ((const char *[]){ "a", "b", "c", NULL });
+
+  item = g_list_model_get_item (G_LIST_MODEL (list), 2);
+
+  bytes = g_bytes_new_static ("x\0\0yy\0", 6);
+  gtk_string_list_splice_bytes (list, 1, 1, bytes);
+  g_bytes_unref (bytes);
+  assert_model (list, "a x  yy c");
+  assert_changes (list, "1-1+3");
+
+  /* objects stay the same */
+  g_assert_true (g_list_model_get_item (G_LIST_MODEL (list), 4) == item);
+  g_object_unref (item);
+  g_object_unref (item);
+
+  bytes = g_bytes_new_static ("", 0);
+  gtk_string_list_splice_bytes (list, 0, 2, bytes);
+  g_bytes_unref (bytes);
+  assert_model (list, " yy c");
+  assert_changes (list, "0-2");
+
+  gtk_string_list_splice (list, 0, 3, NULL);
+  assert_model (list, "");
+  assert_changes (list, "0-3");
+
+  g_object_unref (list);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -277,6 +312,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/stringlist/splice", test_splice);
   g_test_add_func ("/stringlist/add_remove", test_add_remove);
   g_test_add_func ("/stringlist/take", test_take);
+  g_test_add_func ("/stringlist/splice-bytes", test_splice_bytes);
 
   return g_test_run ();
 }
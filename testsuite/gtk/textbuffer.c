@@ -1956,6 +1956,105 @@ test_serialize_wrap_mode (void)
   g_assert_finalize_object (buffer);
 }
 
+static void
+test_long_line (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextIter start, end;
+  GString *expected;
+  char *text;
+  guint i;
+
+  /* long enough to be split into several segments, with multibyte
+   * characters so that the splits can't be at fixed offsets */
+  expected = g_string_new (NULL);
+  for (i = 0; i < 5000; i++)
+    g_string_append (expected, i % 7 ? "ab" : "\xc3\xa4\xe2\x82\xac");
+
+  buffer = gtk_text_buffer_new (NULL);
+  gtk_text_buffer_set_text (buffer, expected->str, expected->len);
+  g_assert_cmpint (gtk_text_buffer_get_line_count (buffer), ==, 1);
+  g_assert_cmpint (gtk_text_buffer_get_char_count (buffer), ==, g_utf8_strlen (expected->str, -1));
+
+  /* edit in the middle */
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 6000);
+  gtk_text_buffer_insert (buffer, &start, "xyz", 3);
+  g_string_insert (expected, g_utf8_offset_to_pointer (expected->str, 6000) - expected->str, "xyz");
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &start, 100);
+  gtk_text_buffer_get_iter_at_offset (buffer, &end, 9000);
+  gtk_text_buffer_delete (buffer, &start, &end);
+  g_string_erase (expected,
+                  g_utf8_offset_to_pointer (expected->str, 100) - expected->str,
+                  g_utf8_offset_to_pointer (expected->str, 9000) - g_utf8_offset_to_pointer (expected->str, 100));
+
+  gtk_text_buffer_get_bounds (buffer, &start, &end);
+  text = gtk_text_buffer_get_text (buffer, &start, &end, TRUE);
+  g_assert_cmpstr (text, ==, expected->str);
+
+  g_free (text);
+  g_string_free (expected, TRUE);
+  g_object_unref (buffer);
+}
+
+static void
+count_apply_tag (GtkTextBuffer     *buffer,
+                 GtkTextTag        *tag,
+                 const GtkTextIter *start,
+                 const GtkTextIter *end,
+                 guint             *count)
+{
+  (*count)++;
+}
+
+static void
+test_set_text_with_tags (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextTag *tags[3];
+  const int starts[] = { 0, 4, 6 };
+  const int ends[] = { 3, 9, 6 };
+  GtkTextIter iter, end;
+  guint signals = 0;
+  char *text;
+
+  buffer = gtk_text_buffer_new (NULL);
+  tags[0] = gtk_text_buffer_create_tag (buffer, "bold", "weight", PANGO_WEIGHT_BOLD, NULL);
+  tags[1] = gtk_text_buffer_create_tag (buffer, "italic", "style", PANGO_STYLE_ITALIC, NULL);
+  tags[2] = tags[0];
+
+  gtk_text_buffer_set_text (buffer, "old", -1);
+  g_signal_connect (buffer, "apply-tag", G_CALLBACK (count_apply_tag), &signals);
+
+  gtk_text_buffer_set_text_with_tags (buffer, "foo bar\nbaz", -1, tags, starts, ends, 3);
+
+  g_assert_cmpuint (signals, ==, 0);
+  gtk_text_buffer_get_bounds (buffer, &iter, &end);
+  text = gtk_text_buffer_get_text (buffer, &iter, &end, TRUE);
+  g_assert_cmpstr (text, ==, "foo bar\nbaz");
+  g_free (text);
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 1);
+  g_assert_true (gtk_text_iter_has_tag (&iter, tags[0]));
+  g_assert_false (gtk_text_iter_has_tag (&iter, tags[1]));
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 3);
+  g_assert_false (gtk_text_iter_has_tag (&iter, tags[0]));
+  g_assert_false (gtk_text_iter_has_tag (&iter, tags[1]));
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 8);
+  g_assert_true (gtk_text_iter_has_tag (&iter, tags[1]));
+  g_assert_true (gtk_text_iter_starts_line (&iter));
+
+  gtk_text_buffer_get_iter_at_offset (buffer, &iter, 9);
+  g_assert_false (gtk_text_iter_has_tag (&iter, tags[1]));
+
+  /* this can't be undone */
+  g_assert_false (gtk_text_buffer_get_can_undo (buffer));
+
+  g_object_unref (buffer);
+}
+
 int
 main (int argc, char** argv)
 {
@@ -1984,6 +2083,8 @@ main (int argc, char** argv)
   g_test_add_func ("/TextBuffer/Undo 4", test_undo4);
   g_test_add_func ("/TextBuffer/Undo 5", test_undo5);
   g_test_add_func ("/TextBuffer/Serialize wrap-mode", test_serialize_wrap_mode);
+  g_test_add_func ("/TextBuffer/Long line", test_long_line);
+  g_test_add_func ("/TextBuffer/Set text with tags", test_set_text_with_tags);
 
   return g_test_run();
 }
@@ -602,6 +602,26 @@ test14 (void)
   g_free (fill_after_2);
 }
 
+static void
+test15 (void)
+{
+  /* Programmatic deletes in a user action are merged */
+  static const Command commands[] = {
+    { INSERT, 0, -1, "aabbccdd", "aabbccdd", SET, UNSET, UNSET },
+    { BEGIN_USER, -1, -1, NULL, NULL, UNSET, UNSET, UNSET },
+    { DELETE_KEY, 2, 4, "bb", "aaccdd", UNSET, UNSET, UNSET },
+    { DELETE_KEY, 2, 4, "cc", "aadd", UNSET, UNSET, UNSET },
+    { DELETE_KEY, 0, 2, "aa", "dd", UNSET, UNSET, UNSET },
+    { END_USER, -1, -1, NULL, NULL, SET, UNSET, UNSET },
+    { UNDO, -1, -1, NULL, "aabbccdd", SET, SET, UNSET },
+    { REDO, -1, -1, NULL, "dd", SET, UNSET, UNSET },
+    { UNDO, -1, -1, NULL, "aabbccdd", SET, SET, UNSET },
+    { UNDO, -1, -1, NULL, "", UNSET, SET, UNSET },
+  };
+
+  run_test (commands, G_N_ELEMENTS (commands), 0);
+}
+
 static void
 test_issue_4276 (void)
 {
@@ -684,6 +704,7 @@ main (int   argc,
   g_test_add_func ("/Gtk/TextHistory/test12", test12);
   g_test_add_func ("/Gtk/TextHistory/test13", test13);
   g_test_add_func ("/Gtk/TextHistory/test14", test14);
+  g_test_add_func ("/Gtk/TextHistory/test15", test15);
   g_test_add_func ("/Gtk/TextHistory/issue_4276", test_issue_4276);
   g_test_add_func ("/Gtk/TextHistory/issue_4575", test_issue_4575);
   g_test_add_func ("/Gtk/TextHistory/issue_5777", test_issue_5777);
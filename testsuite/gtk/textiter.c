@@ -194,6 +194,42 @@ test_search (void)
   check_found_backward ("aa \303\200", "aa", 0, 0, 2, "aa");
 }
 
+static void
+test_search_tagged (void)
+{
+  GtkTextBuffer *buffer;
+  GtkTextTag *tag;
+  GtkTextIter i, s, e;
+  gboolean res;
+
+  buffer = gtk_text_buffer_new (NULL);
+  tag = gtk_text_buffer_create_tag (buffer, NULL, "weight", PANGO_WEIGHT_BOLD, NULL);
+
+  gtk_text_buffer_set_text (buffer, "no match here\nsome foo text\n", -1);
+
+  /* split the match over several segments */
+  gtk_text_buffer_get_iter_at_offset (buffer, &s, 19);
+  gtk_text_buffer_get_iter_at_offset (buffer, &e, 20);
+  gtk_text_buffer_apply_tag (buffer, tag, &s, &e);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "foo", 0, &s, &e, NULL);
+  g_assert_true (res);
+  g_assert_cmpint (gtk_text_iter_get_offset (&s), ==, 19);
+  g_assert_cmpint (gtk_text_iter_get_offset (&e), ==, 22);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "text\n", 0, &s, &e, NULL);
+  g_assert_true (res);
+  g_assert_cmpint (gtk_text_iter_get_offset (&s), ==, 23);
+
+  gtk_text_buffer_get_start_iter (buffer, &i);
+  res = gtk_text_iter_forward_search (&i, "bar", 0, &s, &e, NULL);
+  g_assert_false (res);
+
+  g_object_unref (buffer);
+}
+
 static void
 test_search_caseless (void)
 {
@@ -841,6 +877,7 @@ main (int argc, char** argv)
   g_test_add_func ("/TextIter/Search Full Buffer", test_search_full_buffer);
   g_test_add_func ("/TextIter/Search", test_search);
   g_test_add_func ("/TextIter/Search Caseless", test_search_caseless);
+  g_test_add_func ("/TextIter/Search Tagged", test_search_tagged);
   g_test_add_func ("/TextIter/Forward To Tag Toggle", test_forward_to_tag_toggle);
   g_test_add_func ("/TextIter/Forward To Line End", test_forward_to_line_end);
   g_test_add_func ("/TextIter/Word Boundaries", test_word_boundaries);
@@ -613,6 +613,51 @@ test_same_child_model (void)
     g_object_unref (models[i]);
 }
 
+static guint n_created;
+
+static GListModel *
+counting_children (gpointer item,
+                   gpointer unused)
+{
+  n_created++;
+
+  return demo_node_children (item, unused);
+}
+
+static void
+test_retain_models (void)
+{
+  GListStore *model;
+  GtkTreeListModel *treemodel;
+  GtkTreeListRow *row;
+
+  model = create_model ();
+  treemodel = gtk_tree_list_model_new (G_LIST_MODEL (model),
+                                       FALSE,
+                                       FALSE,
+                                       counting_children,
+                                       NULL,
+                                       NULL);
+
+  n_created = 0;
+  row = gtk_tree_list_model_get_row (treemodel, 0);
+
+  /* checking expandability keeps the model for expanding */
+  g_assert_true (gtk_tree_list_row_is_expandable (row));
+  gtk_tree_list_row_set_expanded (row, TRUE);
+  g_assert_cmpuint (n_created, ==, 1);
+
+  /* collapsed rows keep their model */
+  gtk_tree_list_row_set_expanded (row, FALSE);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (treemodel)), ==, g_list_model_get_n_items (G_LIST_MODEL (model)));
+  gtk_tree_list_row_set_expanded (row, TRUE);
+  g_assert_cmpuint (n_created, ==, 1);
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (treemodel)), >, g_list_model_get_n_items (G_LIST_MODEL (model)));
+
+  g_object_unref (row);
+  g_object_unref (treemodel);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -627,6 +672,7 @@ main (int argc, char *argv[])
   g_test_add_func ("/treelistmodel/remove_splice", test_splice);
   g_test_add_func ("/treelistmodel/collapse-change", test_collapse_change);
   g_test_add_func ("/treelistmodel/same-child-model", test_same_child_model);
+  g_test_add_func ("/treelistmodel/retain-models", test_retain_models);
 
   return g_test_run ();
 }
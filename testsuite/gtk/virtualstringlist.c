@@ -0,0 +1,222 @@
+/* GtkVirtualStringList tests
+ *
+ * Copyright (C) 2023, Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+
+static char *
+get_item_string (GListModel *model,
+                 guint       position)
+{
+  GtkStringObject *item;
+  char *result;
+
+  item = g_list_model_get_item (model, position);
+  result = g_strdup (gtk_string_object_get_string (item));
+  g_object_unref (item);
+
+  return result;
+}
+
+static char *
+model_to_string (GListModel *model)
+{
+  GString *string = g_string_new (NULL);
+  guint i;
+
+  for (i = 0; i < g_list_model_get_n_items (model); i++)
+    {
+      char *s = get_item_string (model, i);
+
+      if (i > 0)
+        g_string_append (string, " ");
+      g_string_append (string, s);
+      g_free (s);
+    }
+
+  return g_string_free (string, FALSE);
+}
+
+#define assert_model(model, expected) G_STMT_START{ \
+  char *s = model_to_string (G_LIST_MODEL (model)); \
+  if (!g_str_equal (s, expected)) \
+     g_assertion_message_cmpstr (G_LOG_DOMAIN, __FILE__, __LINE__, G_STRFUNC, \
+         #model " == " #expected, s, "==", expected); \
+  g_free (s); \
+}G_STMT_END
+
+static guint n_calls;
+static guint offset;
+
+static char *
+number_func (guint    position,
+             gpointer user_data)
+{
+  n_calls++;
+
+  return g_strdup_printf ("%u", position + offset);
+}
+
+static void
+test_func (void)
+{
+  GtkVirtualStringList *list;
+  gpointer item1, item2;
+  char *s;
+
+  list = gtk_virtual_string_list_new (5, number_func, NULL, NULL);
+
+  g_assert_true (g_list_model_get_item_type (G_LIST_MODEL (list)) == GTK_TYPE_STRING_OBJECT);
+  assert_model (list, "0 1 2 3 4");
+  g_assert_null (g_list_model_get_item (G_LIST_MODEL (list), 5));
+
+  s = gtk_virtual_string_list_get_string (list, 3);
+  g_assert_cmpstr (s, ==, "3");
+  g_free (s);
+
+  /* recently used items are reused */
+  item1 = g_list_model_get_item (G_LIST_MODEL (list), 2);
+  n_calls = 0;
+  item2 = g_list_model_get_item (G_LIST_MODEL (list), 2);
+  g_assert_true (item1 == item2);
+  g_assert_cmpuint (n_calls, ==, 0);
+  g_object_unref (item2);
+
+  offset = 10;
+  gtk_virtual_string_list_items_changed (list, 1, 2);
+  item2 = g_list_model_get_item (G_LIST_MODEL (list), 2);
+  g_assert_true (item1 != item2);
+  g_assert_cmpstr (gtk_string_object_get_string (item2), ==, "12");
+  g_object_unref (item2);
+  g_object_unref (item1);
+  assert_model (list, "0 11 12 3 4");
+
+  offset = 0;
+  gtk_virtual_string_list_set_n_items (list, 2);
+  assert_model (list, "0 11");
+  gtk_virtual_string_list_set_n_items (list, 4);
+  assert_model (list, "0 11 2 3");
+
+  g_object_unref (list);
+}
+
+static void
+test_many (void)
+{
+  GtkVirtualStringList *list;
+  char *s;
+
+  list = gtk_virtual_string_list_new (G_MAXUINT, number_func, NULL, NULL);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, G_MAXUINT);
+  s = get_item_string (G_LIST_MODEL (list), G_MAXUINT - 1);
+  g_assert_cmpstr (s, ==, "4294967294");
+  g_free (s);
+
+  g_object_unref (list);
+}
+
+static GtkVirtualStringList *
+new_for_contents (const char *contents,
+                  gssize      len)
+{
+  GtkVirtualStringList *list;
+  GMappedFile *file;
+  GError *error = NULL;
+  char *filename;
+  int fd;
+
+  fd = g_file_open_tmp ("virtualstringlist-XXXXXX", &filename, &error);
+  g_assert_no_error (error);
+  g_close (fd, NULL);
+
+  g_file_set_contents (filename, contents, len, &error);
+  g_assert_no_error (error);
+
+  file = g_mapped_file_new (filename, FALSE, &error);
+  g_assert_no_error (error);
+
+  list = gtk_virtual_string_list_new_for_mapped_file (file);
+
+  g_mapped_file_unref (file);
+  g_unlink (filename);
+  g_free (filename);
+
+  return list;
+}
+
+static void
+test_mapped_file (void)
+{
+  GtkVirtualStringList *list;
+
+  list = new_for_contents ("a\nb\r\n\nc", -1);
+  assert_model (list, "a b  c");
+  g_object_unref (list);
+
+  list = new_for_contents ("a\nb\n", -1);
+  assert_model (list, "a b");
+  g_object_unref (list);
+
+  list = new_for_contents ("a\nb\xff\n", -1);
+  assert_model (list, "a b\xef\xbf\xbd");
+  g_object_unref (list);
+}
+
+static void
+test_mapped_file_many (void)
+{
+  GtkVirtualStringList *list;
+  GString *contents;
+  guint i;
+
+  contents = g_string_new (NULL);
+  for (i = 0; i < 10000; i++)
+    g_string_append_printf (contents, "line %u\n", i);
+
+  list = new_for_contents (contents->str, contents->len);
+  g_string_free (contents, TRUE);
+
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (list)), ==, 10000);
+
+  for (i = 0; i < 10000; i += 7)
+    {
+      char *s = gtk_virtual_string_list_get_string (list, i);
+      char *expected = g_strdup_printf ("line %u", i);
+
+      g_assert_cmpstr (s, ==, expected);
+
+      g_free (expected);
+      g_free (s);
+    }
+
+  g_object_unref (list);
+}
+
+int
+main (int argc, char *argv[])
+{
+  (g_test_init) (&argc, &argv, NULL);
+
+  g_test_add_func ("/virtualstringlist/func", test_func);
+  g_test_add_func ("/virtualstringlist/many", test_many);
+  g_test_add_func ("/virtualstringlist/mapped-file", test_mapped_file);
+  g_test_add_func ("/virtualstringlist/mapped-file-many", test_mapped_file_many);
+
+  return g_test_run ();
+}
@@ -0,0 +1,448 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs interactive scenarios in a window and prints one JSON object
+ * per scenario with percentiles of the frame times, so results can
+ * be collected and compared by scripts.
+ *
+ * The scenarios don't depend on the wall clock: every frame advances
+ * them by one fixed step, and the next step is only taken once that
+ * frame has been painted. So every run does the same work, and the
+ * frame time is the time the frame clock spent from ::before-paint
+ * to ::after-paint, ie in update, layout and paint.
+ */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+static int n_frames = 200;
+static int timeout = 1000;
+
+static const GOptionEntry options[] = {
+  { "frames", 'n', 0, G_OPTION_ARG_INT, &n_frames, "Number of frames to run each scenario for", "COUNT" },
+  { "timeout", 't', 0, G_OPTION_ARG_INT, &timeout, "Time to wait for a frame, in milliseconds", "MSEC" },
+  { NULL }
+};
+
+typedef struct {
+  const char *name;
+  GtkWidget * (* create) (void);
+  void (* step) (GtkWidget *window,
+                 GtkWidget *child,
+                 int        frame);
+} Scenario;
+
+/* list-fling: scroll a long list view in fixed steps */
+
+static void
+setup_label (GtkSignalListItemFactory *factory,
+             GtkListItem              *item)
+{
+  gtk_list_item_set_child (item, gtk_label_new (NULL));
+}
+
+static void
+bind_label (GtkSignalListItemFactory *factory,
+            GtkListItem              *item)
+{
+  GtkStringObject *string = gtk_list_item_get_item (item);
+
+  gtk_label_set_label (GTK_LABEL (gtk_list_item_get_child (item)),
+                       gtk_string_object_get_string (string));
+}
+
+static GtkWidget *
+list_create (void)
+{
+  GtkStringList *list;
+  GtkListItemFactory *factory;
+  GtkWidget *sw, *view;
+  int i;
+
+  list = gtk_string_list_new (NULL);
+  for (i = 0; i < 100000; i++)
+    {
+      char *s = g_strdup_printf ("Item %d", i);
+      gtk_string_list_take (list, s);
+    }
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_label), NULL);
+  g_signal_connect (factory, "bind", G_CALLBACK (bind_label), NULL);
+
+  view = gtk_list_view_new (GTK_SELECTION_MODEL (gtk_no_selection_new (G_LIST_MODEL (list))), factory);
+
+  sw = gtk_scrolled_window_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), view);
+
+  return sw;
+}
+
+static void
+scroll_step (GtkWidget *child,
+             double     step)
+{
+  GtkAdjustment *adjustment;
+  double value, upper;
+
+  adjustment = gtk_scrolled_window_get_vadjustment (GTK_SCROLLED_WINDOW (child));
+  upper = gtk_adjustment_get_upper (adjustment) - gtk_adjustment_get_page_size (adjustment);
+  value = gtk_adjustment_get_value (adjustment) + step;
+  if (value > upper)
+    value = 0;
+
+  gtk_adjustment_set_value (adjustment, value);
+}
+
+static void
+list_step (GtkWidget *window,
+           GtkWidget *child,
+           int        frame)
+{
+  scroll_step (child, 200);
+}
+
+/* text-scroll: scroll a long text view in fixed steps */
+
+static GtkWidget *
+text_create (void)
+{
+  GtkWidget *sw, *view;
+  GtkTextBuffer *buffer;
+  GtkTextIter iter;
+  int i;
+
+  view = gtk_text_view_new ();
+  buffer = gtk_text_view_get_buffer (GTK_TEXT_VIEW (view));
+  gtk_text_buffer_get_start_iter (buffer, &iter);
+  for (i = 0; i < 10000; i++)
+    {
+      char *s = g_strdup_printf ("Line %d: The quick brown fox jumps over the lazy dog.\n", i);
+      gtk_text_buffer_insert (buffer, &iter, s, -1);
+      g_free (s);
+    }
+
+  sw = gtk_scrolled_window_new ();
+  gtk_scrolled_window_set_child (GTK_SCROLLED_WINDOW (sw), view);
+
+  return sw;
+}
+
+static void
+text_step (GtkWidget *window,
+           GtkWidget *child,
+           int        frame)
+{
+  scroll_step (child, 100);
+}
+
+/* theme-switch: toggle between the light and dark theme */
+
+static GtkWidget *
+widgets_create (void)
+{
+  GtkWidget *grid;
+  int i;
+
+  grid = gtk_grid_new ();
+  for (i = 0; i < 60; i++)
+    {
+      GtkWidget *widget;
+
+      switch (i % 4)
+        {
+        case 0:
+          widget = gtk_button_new_with_label ("Button");
+          break;
+        case 1:
+          widget = gtk_entry_new ();
+          break;
+        case 2:
+          widget = gtk_check_button_new_with_label ("Check");
+          break;
+        default:
+          widget = gtk_scale_new_with_range (GTK_ORIENTATION_HORIZONTAL, 0, 100, 1);
+          break;
+        }
+
+      gtk_grid_attach (GTK_GRID (grid), widget, i % 6, i / 6, 1, 1);
+    }
+
+  return grid;
+}
+
+static void
+theme_step (GtkWidget *window,
+            GtkWidget *child,
+            int        frame)
+{
+  g_object_set (gtk_widget_get_settings (window),
+                "gtk-application-prefer-dark-theme", frame % 2 == 0,
+                NULL);
+}
+
+/* window-resize: cycle through a fixed set of window sizes */
+
+static void
+resize_step (GtkWidget *window,
+             GtkWidget *child,
+             int        frame)
+{
+  gtk_window_set_default_size (GTK_WINDOW (window),
+                               400 + (frame % 10) * 40,
+                               300 + (frame % 10) * 30);
+}
+
+/* popover-open: open and close a popover */
+
+static GtkWidget *
+popover_create (void)
+{
+  GtkWidget *button, *popover, *box;
+  int i;
+
+  box = gtk_box_new (GTK_ORIENTATION_VERTICAL, 0);
+  for (i = 0; i < 10; i++)
+    gtk_box_append (GTK_BOX (box), gtk_button_new_with_label ("Menu item"));
+
+  popover = gtk_popover_new ();
+  gtk_popover_set_child (GTK_POPOVER (popover), box);
+
+  button = gtk_menu_button_new ();
+  gtk_menu_button_set_popover (GTK_MENU_BUTTON (button), popover);
+  gtk_widget_set_halign (button, GTK_ALIGN_CENTER);
+  gtk_widget_set_valign (button, GTK_ALIGN_CENTER);
+
+  return button;
+}
+
+static void
+popover_step (GtkWidget *window,
+              GtkWidget *child,
+              int        frame)
+{
+  if (frame % 2 == 0)
+    gtk_menu_button_popup (GTK_MENU_BUTTON (child));
+  else
+    gtk_menu_button_popdown (GTK_MENU_BUTTON (child));
+}
+
+static const Scenario scenarios[] = {
+  { "list-fling", list_create, list_step },
+  { "text-scroll", text_create, text_step },
+  { "theme-switch", widgets_create, theme_step },
+  { "window-resize", widgets_create, resize_step },
+  { "popover-open", popover_create, popover_step },
+};
+
+typedef struct {
+  gint64 frame_start;
+  gint64 frame_time;
+  gboolean painted;
+} FrameData;
+
+static void
+frame_before_paint (GdkFrameClock *clock,
+                    FrameData     *data)
+{
+  if (data->frame_start == 0)
+    data->frame_start = g_get_monotonic_time ();
+}
+
+static void
+frame_after_paint (GdkFrameClock *clock,
+                   FrameData     *data)
+{
+  if (data->frame_start == 0)
+    return;
+
+  data->frame_time = g_get_monotonic_time () - data->frame_start;
+  data->painted = TRUE;
+}
+
+static gboolean
+frame_timeout (gpointer user_data)
+{
+  gboolean *timed_out = user_data;
+
+  *timed_out = TRUE;
+
+  return G_SOURCE_REMOVE;
+}
+
+/* Returns FALSE if no frame was painted in time */
+static gboolean
+wait_for_frame (GtkWidget *window,
+                FrameData *data)
+{
+  gboolean timed_out = FALSE;
+  guint id;
+
+  data->frame_start = 0;
+  data->painted = FALSE;
+
+  /* Make sure the frame clock runs all phases, even if the step
+   * only changed something that needs no redraw
+   */
+  gtk_widget_queue_draw (window);
+
+  id = g_timeout_add (timeout, frame_timeout, &timed_out);
+  while (!data->painted && !timed_out)
+    g_main_context_iteration (NULL, TRUE);
+
+  if (!timed_out)
+    g_source_remove (id);
+
+  return data->painted;
+}
+
+static int
+compare_times (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static gint64
+percentile (GArray *times,
+            int     p)
+{
+  return g_array_index (times, gint64, (times->len - 1) * p / 100);
+}
+
+static void
+print_times (const char *name,
+             GArray     *times,
+             int         missed)
+{
+  g_array_sort (times, compare_times);
+
+  g_print ("{ \"benchmark\": \"%s\", \"frames\": %u, \"missed\": %d"
+           ", \"p50\": %" G_GINT64_FORMAT
+           ", \"p95\": %" G_GINT64_FORMAT
+           ", \"p99\": %" G_GINT64_FORMAT
+           ", \"max\": %" G_GINT64_FORMAT " }\n",
+           name, times->len, missed,
+           percentile (times, 50),
+           percentile (times, 95),
+           percentile (times, 99),
+           g_array_index (times, gint64, times->len - 1));
+}
+
+static gboolean
+run_scenario (const Scenario *scenario)
+{
+  GtkWidget *window, *child;
+  GdkFrameClock *clock;
+  FrameData data = { 0, };
+  GArray *times;
+  int missed = 0;
+  int i;
+
+  child = scenario->create ();
+
+  window = gtk_window_new ();
+  gtk_window_set_default_size (GTK_WINDOW (window), 600, 400);
+  gtk_window_set_child (GTK_WINDOW (window), child);
+  gtk_window_present (GTK_WINDOW (window));
+
+  while (!gtk_widget_get_mapped (window))
+    g_main_context_iteration (NULL, TRUE);
+
+  clock = gtk_widget_get_frame_clock (window);
+  g_signal_connect (clock, "before-paint", G_CALLBACK (frame_before_paint), &data);
+  g_signal_connect (clock, "after-paint", G_CALLBACK (frame_after_paint), &data);
+
+  /* Let the first frame settle, it is not part of the scenario */
+  if (!wait_for_frame (window, &data))
+    {
+      g_printerr ("%s: No frames are being drawn\n", scenario->name);
+      g_signal_handlers_disconnect_by_data (clock, &data);
+      gtk_window_destroy (GTK_WINDOW (window));
+      return FALSE;
+    }
+
+  times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), n_frames);
+
+  for (i = 0; i < n_frames; i++)
+    {
+      scenario->step (window, child, i);
+
+      if (wait_for_frame (window, &data))
+        g_array_append_val (times, data.frame_time);
+      else
+        missed++;
+    }
+
+  g_signal_handlers_disconnect_by_data (clock, &data);
+  gtk_window_destroy (GTK_WINDOW (window));
+
+  if (times->len > 0)
+    print_times (scenario->name, times, missed);
+  else
+    g_printerr ("%s: No frames were painted\n", scenario->name);
+
+  g_array_unref (times);
+
+  return missed < n_frames;
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  gboolean success = TRUE;
+  guint i;
+
+  context = g_option_context_new ("[SCENARIO…] - benchmark frame times");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Runs the given scenarios, or all of them, and prints percentiles\n"
+                                "of the frame times in microseconds as one JSON object per line.\n"
+                                "With GDK_DEBUG=fixed-frame-time, frames run back-to-back, so the\n"
+                                "results measure throughput instead of being paced by the display.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (n_frames < 1 || timeout < 1)
+    {
+      g_printerr ("Counts must be positive\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (scenarios); i++)
+    {
+      if (argc > 1 && !g_strv_contains ((const char * const *) argv + 1, scenarios[i].name))
+        continue;
+
+      success &= run_scenario (&scenarios[i]);
+    }
+
+  return success ? 0 : 1;
+}
@@ -0,0 +1,249 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Creates list item widgets with a GtkBuilderListItemFactory and with
+ * the equivalent hand-written GtkSignalListItemFactory, and prints one
+ * JSON object per benchmark, so results can be collected and compared
+ * by scripts.
+ */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+#include <string.h>
+
+#include "gtk/gtklistitemprivate.h"
+#include "gtk/gtklistitemfactoryprivate.h"
+
+static int runs = 5;
+static int n_items = 1000;
+
+static const GOptionEntry options[] = {
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &runs, "Number of times to run each benchmark", "COUNT" },
+  { "items", 'n', 0, G_OPTION_ARG_INT, &n_items, "Number of list items to create per run", "COUNT" },
+  { NULL }
+};
+
+static const char *template =
+"<interface>"
+"  <template class='GtkListItem'>"
+"    <property name='child'>"
+"      <object class='GtkBox'>"
+"        <property name='spacing'>6</property>"
+"        <child>"
+"          <object class='GtkImage'>"
+"            <property name='icon-name'>folder</property>"
+"          </object>"
+"        </child>"
+"        <child>"
+"          <object class='GtkLabel'>"
+"            <property name='xalign'>0</property>"
+"            <property name='hexpand'>1</property>"
+"            <property name='ellipsize'>end</property>"
+"          </object>"
+"        </child>"
+"        <child>"
+"          <object class='GtkButton'>"
+"            <property name='icon-name'>edit-delete-symbolic</property>"
+"            <property name='has-frame'>0</property>"
+"            <signal name='clicked' handler='benchmark_button_clicked'/>"
+"          </object>"
+"        </child>"
+"      </object>"
+"    </property>"
+"  </template>"
+"</interface>";
+
+G_MODULE_EXPORT void
+benchmark_button_clicked (GtkButton *button)
+{
+}
+
+static void
+setup_item (GtkSignalListItemFactory *factory,
+            GtkListItem              *item)
+{
+  GtkWidget *box, *image, *label, *button;
+
+  box = gtk_box_new (GTK_ORIENTATION_HORIZONTAL, 6);
+
+  image = gtk_image_new_from_icon_name ("folder");
+  gtk_box_append (GTK_BOX (box), image);
+
+  label = gtk_label_new (NULL);
+  gtk_label_set_xalign (GTK_LABEL (label), 0);
+  gtk_widget_set_hexpand (label, TRUE);
+  gtk_label_set_ellipsize (GTK_LABEL (label), PANGO_ELLIPSIZE_END);
+  gtk_box_append (GTK_BOX (box), label);
+
+  button = gtk_button_new_from_icon_name ("edit-delete-symbolic");
+  gtk_button_set_has_frame (GTK_BUTTON (button), FALSE);
+  g_signal_connect (button, "clicked", G_CALLBACK (benchmark_button_clicked), NULL);
+  gtk_box_append (GTK_BOX (box), button);
+
+  gtk_list_item_set_child (item, box);
+}
+
+static GtkListItemFactory *
+create_builder_factory (void)
+{
+  GBytes *bytes;
+  GtkListItemFactory *factory;
+
+  bytes = g_bytes_new_static (template, strlen (template));
+  factory = gtk_builder_list_item_factory_new_from_bytes (NULL, bytes);
+  g_bytes_unref (bytes);
+
+  return factory;
+}
+
+static GtkListItemFactory *
+create_signal_factory (void)
+{
+  GtkListItemFactory *factory;
+
+  factory = gtk_signal_list_item_factory_new ();
+  g_signal_connect (factory, "setup", G_CALLBACK (setup_item), NULL);
+
+  return factory;
+}
+
+static gint64
+run_factory (GtkListItemFactory *factory)
+{
+  GtkListItem **items;
+  gint64 start, value;
+  int i;
+
+  items = g_new (GtkListItem *, n_items);
+  for (i = 0; i < n_items; i++)
+    items[i] = gtk_list_item_new ();
+
+  start = g_get_monotonic_time ();
+  for (i = 0; i < n_items; i++)
+    gtk_list_item_factory_setup (factory, G_OBJECT (items[i]), FALSE, NULL, NULL);
+  value = g_get_monotonic_time () - start;
+
+  for (i = 0; i < n_items; i++)
+    {
+      gtk_list_item_factory_teardown (factory, G_OBJECT (items[i]), FALSE, NULL, NULL);
+      g_object_unref (items[i]);
+    }
+  g_free (items);
+
+  return value;
+}
+
+static int
+compare_times (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static void
+print_times (const char *name,
+             GArray     *times)
+{
+  gint64 sum = 0;
+  guint i;
+
+  g_array_sort (times, compare_times);
+  for (i = 0; i < times->len; i++)
+    sum += g_array_index (times, gint64, i);
+
+  g_print ("{ \"benchmark\": \"%s\", \"items\": %d"
+           ", \"min\": %" G_GINT64_FORMAT
+           ", \"median\": %" G_GINT64_FORMAT
+           ", \"mean\": %" G_GINT64_FORMAT
+           ", \"max\": %" G_GINT64_FORMAT
+           ", \"samples\": %u }\n",
+           name, n_items,
+           g_array_index (times, gint64, 0),
+           g_array_index (times, gint64, times->len / 2),
+           sum / times->len,
+           g_array_index (times, gint64, times->len - 1),
+           times->len);
+}
+
+typedef struct {
+  const char *name;
+  GtkListItemFactory * (* create) (void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+  { "builder", create_builder_factory },
+  { "signal", create_signal_factory },
+};
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  guint i;
+  int j;
+
+  context = g_option_context_new ("[BENCHMARK…] - benchmark list item factories");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Runs the given benchmarks, or all of them, and prints the time\n"
+                                "to set up the list items in microseconds as one JSON object per line.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (runs < 1 || n_items < 1)
+    {
+      g_printerr ("Counts must be positive\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  for (i = 0; i < G_N_ELEMENTS (benchmarks); i++)
+    {
+      GtkListItemFactory *factory;
+      GArray *times;
+
+      if (argc > 1 && !g_strv_contains ((const char * const *) argv + 1, benchmarks[i].name))
+        continue;
+
+      times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), runs);
+      factory = benchmarks[i].create ();
+
+      for (j = 0; j < runs; j++)
+        {
+          gint64 value = run_factory (factory);
+          g_array_append_val (times, value);
+        }
+
+      g_object_unref (factory);
+      print_times (benchmarks[i].name, times);
+      g_array_unref (times);
+    }
+
+  return 0;
+}
@@ -0,0 +1,373 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Runs common operations on stacks of list models and prints one
+ * JSON object per benchmark, so results can be collected and compared
+ * by scripts.
+ */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+#include <stdlib.h>
+
+static int runs = 5;
+static int size = 1000000;
+static int n_sections = 100000;
+static int n_lookups = 100000;
+
+static const GOptionEntry options[] = {
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &runs, "Number of times to run each benchmark", "COUNT" },
+  { "size", 's', 0, G_OPTION_ARG_INT, &size, "Number of items in the base model", "COUNT" },
+  { "sections", 0, 0, G_OPTION_ARG_INT, &n_sections, "Number of submodels for the flatten benchmarks", "COUNT" },
+  { "lookups", 0, 0, G_OPTION_ARG_INT, &n_lookups, "Number of random item lookups", "COUNT" },
+  { NULL }
+};
+
+static int
+compare_times (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static void
+print_times (const char *name,
+             GArray     *times)
+{
+  gint64 sum = 0;
+  guint i;
+
+  g_array_sort (times, compare_times);
+  for (i = 0; i < times->len; i++)
+    sum += g_array_index (times, gint64, i);
+
+  g_print ("{ \"benchmark\": \"%s\", \"size\": %d"
+           ", \"min\": %" G_GINT64_FORMAT
+           ", \"median\": %" G_GINT64_FORMAT
+           ", \"mean\": %" G_GINT64_FORMAT
+           ", \"max\": %" G_GINT64_FORMAT
+           ", \"samples\": %u }\n",
+           name, size,
+           g_array_index (times, gint64, 0),
+           g_array_index (times, gint64, times->len / 2),
+           sum / times->len,
+           g_array_index (times, gint64, times->len - 1),
+           times->len);
+}
+
+static GListModel *
+create_string_list (guint n_items)
+{
+  GtkStringList *list;
+  char **strings;
+  guint i;
+
+  strings = g_new (char *, n_items + 1);
+  for (i = 0; i < n_items; i++)
+    strings[i] = g_strdup_printf ("%u", g_random_int_range (0, G_MAXINT));
+  strings[n_items] = NULL;
+
+  list = gtk_string_list_new ((const char * const *) strings);
+  g_strfreev (strings);
+
+  return G_LIST_MODEL (list);
+}
+
+static guint
+get_number (gpointer item)
+{
+  return strtoul (gtk_string_object_get_string (item), NULL, 10);
+}
+
+static gboolean
+filter_even (gpointer item,
+             gpointer data)
+{
+  return get_number (item) % 2 == 0;
+}
+
+static int
+compare_numbers (gconstpointer a,
+                 gconstpointer b,
+                 gpointer      data)
+{
+  guint na = get_number ((gpointer) a);
+  guint nb = get_number ((gpointer) b);
+
+  return na < nb ? -1 : (na > nb ? 1 : 0);
+}
+
+static gpointer
+map_identity (gpointer item,
+              gpointer data)
+{
+  return item;
+}
+
+static void
+lookup_random (GListModel *model)
+{
+  guint i, n_items;
+
+  n_items = g_list_model_get_n_items (model);
+  if (n_items == 0)
+    return;
+
+  for (i = 0; i < n_lookups; i++)
+    {
+      gpointer item = g_list_model_get_item (model, g_random_int_range (0, n_items));
+      g_object_unref (item);
+    }
+}
+
+static GListModel *
+create_sections (void)
+{
+  GListStore *sections;
+  gpointer *models;
+  guint i;
+
+  sections = g_list_store_new (G_TYPE_LIST_MODEL);
+  models = g_new (gpointer, n_sections);
+  for (i = 0; i < n_sections; i++)
+    models[i] = create_string_list (1);
+
+  g_list_store_splice (sections, 0, 0, models, n_sections);
+
+  for (i = 0; i < n_sections; i++)
+    g_object_unref (models[i]);
+  g_free (models);
+
+  return G_LIST_MODEL (sections);
+}
+
+typedef struct {
+  const char *name;
+  gpointer (* setup) (void);
+  void (* run) (gpointer data);
+  void (* teardown) (gpointer data);
+} Benchmark;
+
+/* flatten: insert many small models at once */
+
+static gpointer
+flatten_splice_setup (void)
+{
+  return create_sections ();
+}
+
+static void
+flatten_splice_run (gpointer data)
+{
+  GListModel *sections = data;
+  GtkFlattenListModel *flatten;
+  GListStore *store;
+  gpointer *models;
+  guint i;
+
+  store = g_list_store_new (G_TYPE_LIST_MODEL);
+  flatten = gtk_flatten_list_model_new (G_LIST_MODEL (g_object_ref (store)));
+
+  models = g_new (gpointer, n_sections);
+  for (i = 0; i < n_sections; i++)
+    models[i] = g_list_model_get_item (sections, i);
+
+  g_list_store_splice (store, 0, 0, models, n_sections);
+  /* replace them all, to hit the replacing path */
+  g_list_store_splice (store, 0, n_sections, models, n_sections);
+
+  for (i = 0; i < n_sections; i++)
+    g_object_unref (models[i]);
+  g_free (models);
+  g_object_unref (flatten);
+  g_object_unref (store);
+}
+
+/* flatten: look up items in many small models */
+
+typedef struct {
+  GListModel *sections;
+  GtkFlattenListModel *flatten;
+} FlattenData;
+
+static gpointer
+flatten_lookup_setup (void)
+{
+  FlattenData *data = g_new (FlattenData, 1);
+
+  data->sections = create_sections ();
+  data->flatten = gtk_flatten_list_model_new (g_object_ref (data->sections));
+
+  return data;
+}
+
+static void
+flatten_lookup_run (gpointer data)
+{
+  FlattenData *fdata = data;
+
+  lookup_random (G_LIST_MODEL (fdata->flatten));
+}
+
+static void
+flatten_lookup_teardown (gpointer data)
+{
+  FlattenData *fdata = data;
+
+  g_object_unref (fdata->flatten);
+  g_object_unref (fdata->sections);
+  g_free (fdata);
+}
+
+/* map: map and look up items */
+
+static gpointer
+base_setup (void)
+{
+  return create_string_list (size);
+}
+
+static void
+map_run (gpointer data)
+{
+  GtkMapListModel *map;
+
+  map = gtk_map_list_model_new (g_object_ref (data), map_identity, NULL, NULL);
+  lookup_random (G_LIST_MODEL (map));
+  g_object_unref (map);
+}
+
+/* filter: filter the whole model */
+
+static void
+filter_run (gpointer data)
+{
+  GtkFilterListModel *filter;
+
+  filter = gtk_filter_list_model_new (g_object_ref (data),
+                                      GTK_FILTER (gtk_custom_filter_new (filter_even, NULL, NULL)));
+  g_assert (g_list_model_get_n_items (G_LIST_MODEL (filter)) <= (guint) size);
+  g_object_unref (filter);
+}
+
+/* sort: sort the whole model */
+
+static void
+sort_run (gpointer data)
+{
+  GtkSortListModel *sort;
+
+  sort = gtk_sort_list_model_new (g_object_ref (data),
+                                  GTK_SORTER (gtk_custom_sorter_new (compare_numbers, NULL, NULL)));
+  g_assert_cmpuint (g_list_model_get_n_items (G_LIST_MODEL (sort)), ==, (guint) size);
+  g_object_unref (sort);
+}
+
+/* chain: sort (filter (map (base))), then change the base model */
+
+static void
+chain_run (gpointer data)
+{
+  GListModel *model;
+  guint i;
+
+  model = G_LIST_MODEL (gtk_map_list_model_new (g_object_ref (data), map_identity, NULL, NULL));
+  model = G_LIST_MODEL (gtk_filter_list_model_new (model, GTK_FILTER (gtk_custom_filter_new (filter_even, NULL, NULL))));
+  model = G_LIST_MODEL (gtk_sort_list_model_new (model, GTK_SORTER (gtk_custom_sorter_new (compare_numbers, NULL, NULL))));
+
+  lookup_random (model);
+
+  /* changes at the start of the base model have to go through the whole chain */
+  for (i = 0; i < 100; i++)
+    {
+      gtk_string_list_splice (data, 0, 0, (const char * const []) { "1", "2", NULL });
+      gtk_string_list_remove (data, 0);
+      gtk_string_list_remove (data, 0);
+    }
+
+  g_object_unref (model);
+}
+
+static const Benchmark benchmarks[] = {
+  { "flatten-splice", flatten_splice_setup, flatten_splice_run, g_object_unref },
+  { "flatten-lookup", flatten_lookup_setup, flatten_lookup_run, flatten_lookup_teardown },
+  { "map", base_setup, map_run, g_object_unref },
+  { "filter", base_setup, filter_run, g_object_unref },
+  { "sort", base_setup, sort_run, g_object_unref },
+  { "chain", base_setup, chain_run, g_object_unref },
+};
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  guint i;
+  int j;
+
+  context = g_option_context_new ("[BENCHMARK…] - benchmark list models");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Runs the given benchmarks, or all of them, and prints timings\n"
+                                "in microseconds as one JSON object per line.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (runs < 1 || size < 1 || n_sections < 1 || n_lookups < 0)
+    {
+      g_printerr ("Counts must be positive\n");
+      return 1;
+    }
+
+  for (i = 0; i < G_N_ELEMENTS (benchmarks); i++)
+    {
+      GArray *times;
+      gpointer data;
+
+      if (argc > 1 && !g_strv_contains ((const char * const *) argv + 1, benchmarks[i].name))
+        continue;
+
+      times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), runs);
+      data = benchmarks[i].setup ();
+
+      for (j = 0; j < runs; j++)
+        {
+          gint64 start, value;
+
+          start = g_get_monotonic_time ();
+          benchmarks[i].run (data);
+          value = g_get_monotonic_time () - start;
+          g_array_append_val (times, value);
+        }
+
+      benchmarks[i].teardown (data);
+      print_times (benchmarks[i].name, times);
+      g_array_unref (times);
+    }
+
+  return 0;
+}
@@ -0,0 +1,311 @@
+/*
+ * Copyright © 2023 Red Hat, Inc.
+ *
+ * This library is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU Lesser General Public
+ * License as published by the Free Software Foundation; either
+ * version 2.1 of the License, or (at your option) any later version.
+ *
+ * This library is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with this library. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/* Replays serialized render nodes through the renderers and prints
+ * one JSON object per file and renderer, so results can be collected
+ * and compared by scripts.
+ */
+
+#include "config.h"
+
+#include <gtk/gtk.h>
+
+#include "gsk/gskrendererprivate.h"
+#include "gsk/gskprofilerprivate.h"
+#include "gsk/gl/gskglrenderer.h"
+#ifdef GDK_RENDERING_VULKAN
+#include "gsk/vulkan/gskvulkanrenderer.h"
+#endif
+
+#ifdef G_OS_UNIX
+#include <sys/resource.h>
+#endif
+
+static int runs = 20;
+static char **renderers = NULL;
+
+static const GOptionEntry options[] = {
+  { "runs", 'r', 0, G_OPTION_ARG_INT, &runs, "Number of times to render each node", "COUNT" },
+  { "renderer", 0, 0, G_OPTION_ARG_STRING_ARRAY, &renderers, "Renderer to use, may be repeated", "RENDERER" },
+  { NULL }
+};
+
+static const struct {
+  const char *name;
+  GskRenderer * (* create_func) (void);
+} all_renderers[] = {
+  { "cairo", gsk_cairo_renderer_new },
+  { "gl", gsk_gl_renderer_new },
+#ifdef GDK_RENDERING_VULKAN
+  { "vulkan", gsk_vulkan_renderer_new },
+#endif
+};
+
+static void
+deserialize_error_func (const GskParseLocation *start,
+                        const GskParseLocation *end,
+                        const GError           *error,
+                        gpointer                user_data)
+{
+  const char *filename = user_data;
+
+  g_printerr ("%s:%zu:%zu: %s\n",
+              filename, start->lines + 1, start->line_chars + 1, error->message);
+}
+
+static GskRenderNode *
+load_node_file (const char *filename)
+{
+  GFile *file;
+  GBytes *bytes;
+  GskRenderNode *node;
+  GError *error = NULL;
+
+  file = g_file_new_for_commandline_arg (filename);
+  bytes = g_file_load_bytes (file, NULL, NULL, &error);
+  g_object_unref (file);
+  if (bytes == NULL)
+    {
+      g_printerr ("Could not load %s: %s\n", filename, error->message);
+      g_error_free (error);
+      return NULL;
+    }
+
+  node = gsk_render_node_deserialize (bytes, deserialize_error_func, (gpointer) filename);
+  g_bytes_unref (bytes);
+
+  return node;
+}
+
+static gint64
+get_max_rss (void)
+{
+#ifdef G_OS_UNIX
+  struct rusage usage;
+
+  if (getrusage (RUSAGE_SELF, &usage) == 0)
+    return usage.ru_maxrss;
+#endif
+
+  return -1;
+}
+
+static int
+compare_times (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static void
+append_times (GString    *string,
+              const char *name,
+              GArray     *times)
+{
+  gint64 sum = 0;
+  guint i;
+
+  g_string_append_printf (string, ", \"%s\": ", name);
+
+  if (times->len == 0)
+    {
+      g_string_append (string, "null");
+      return;
+    }
+
+  g_array_sort (times, compare_times);
+  for (i = 0; i < times->len; i++)
+    sum += g_array_index (times, gint64, i);
+
+  g_string_append_printf (string,
+                          "{ \"min\": %" G_GINT64_FORMAT
+                          ", \"median\": %" G_GINT64_FORMAT
+                          ", \"mean\": %" G_GINT64_FORMAT
+                          ", \"max\": %" G_GINT64_FORMAT
+                          ", \"samples\": %u }",
+                          g_array_index (times, gint64, 0),
+                          g_array_index (times, gint64, times->len / 2),
+                          sum / times->len,
+                          g_array_index (times, gint64, times->len - 1),
+                          times->len);
+}
+
+static gboolean
+benchmark_node (const char    *filename,
+                GskRenderNode *node,
+                const char    *renderer_name,
+                GskRenderer *(*create_func) (void))
+{
+  GskRenderer *renderer;
+  GskProfiler *profiler;
+  GError *error = NULL;
+  GdkTexture *texture;
+  graphene_rect_t bounds;
+  GArray *cpu_times, *gpu_times;
+  GQuark gpu_time;
+  gint64 rss_before;
+  GString *string;
+  char *escaped;
+  int i;
+
+  renderer = create_func ();
+  if (!gsk_renderer_realize (renderer, NULL, &error))
+    {
+      g_printerr ("Could not realize %s renderer: %s\n", renderer_name, error->message);
+      g_error_free (error);
+      g_object_unref (renderer);
+      return FALSE;
+    }
+
+  profiler = gsk_renderer_get_profiler (renderer);
+  gpu_time = g_quark_from_static_string ("gpu-time");
+  if (!gsk_profiler_has_timer (profiler, gpu_time))
+    gpu_time = 0;
+
+  gsk_render_node_get_bounds (node, &bounds);
+  cpu_times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), runs);
+  gpu_times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), runs);
+
+  /* Warm up caches, glyph atlases and shaders before measuring */
+  texture = gsk_renderer_render_texture (renderer, node, &bounds);
+  g_object_unref (texture);
+
+  rss_before = get_max_rss ();
+
+  for (i = 0; i < runs; i++)
+    {
+      gint64 start, value;
+
+      start = g_get_monotonic_time ();
+      texture = gsk_renderer_render_texture (renderer, node, &bounds);
+      value = g_get_monotonic_time () - start;
+      g_array_append_val (cpu_times, value);
+      g_object_unref (texture);
+
+      /* Timer queries lag behind by a frame and report 0 while
+       * the result is not available yet.
+       */
+      if (gpu_time)
+        {
+          value = gsk_profiler_timer_get (profiler, gpu_time);
+          if (value > 0)
+            g_array_append_val (gpu_times, value);
+        }
+    }
+
+  escaped = g_strescape (filename, NULL);
+  string = g_string_new (NULL);
+  g_string_append_printf (string,
+                          "{ \"file\": \"%s\", \"renderer\": \"%s\", \"runs\": %d"
+                          ", \"width\": %g, \"height\": %g",
+                          escaped, renderer_name, runs,
+                          bounds.size.width, bounds.size.height);
+  append_times (string, "cpu-time", cpu_times);
+  append_times (string, "gpu-time", gpu_times);
+  g_string_append_printf (string,
+                          ", \"max-rss\": %" G_GINT64_FORMAT
+                          ", \"max-rss-growth\": %" G_GINT64_FORMAT " }\n",
+                          get_max_rss (),
+                          rss_before >= 0 ? get_max_rss () - rss_before : -1);
+  g_print ("%s", string->str);
+
+  g_string_free (string, TRUE);
+  g_free (escaped);
+  g_array_unref (cpu_times);
+  g_array_unref (gpu_times);
+  gsk_renderer_unrealize (renderer);
+  g_object_unref (renderer);
+
+  return TRUE;
+}
+
+static gboolean
+renderer_selected (const char *name)
+{
+  if (renderers == NULL)
+    return TRUE;
+
+  return g_strv_contains ((const char * const *) renderers, name);
+}
+
+int
+main (int argc, char **argv)
+{
+  GOptionContext *context;
+  GError *error = NULL;
+  gboolean success = TRUE;
+  int i;
+  guint j;
+
+  context = g_option_context_new ("NODEFILE… - replay render nodes");
+  g_option_context_add_main_entries (context, options, NULL);
+  g_option_context_set_summary (context,
+                                "Renders each node file repeatedly with the selected renderers\n"
+                                "and prints timings in microseconds and memory use in kilobytes\n"
+                                "as one JSON object per line.");
+  if (!g_option_context_parse (context, &argc, &argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      return 1;
+    }
+  g_option_context_free (context);
+
+  if (argc < 2)
+    {
+      g_printerr ("Usage: %s [OPTION…] NODEFILE…\n", g_get_prgname ());
+      return 1;
+    }
+
+  if (runs < 1)
+    {
+      g_printerr ("--runs must be positive\n");
+      return 1;
+    }
+
+  gtk_init ();
+
+  for (i = 1; i < argc; i++)
+    {
+      GskRenderNode *node;
+
+      node = load_node_file (argv[i]);
+      if (node == NULL)
+        {
+          success = FALSE;
+          continue;
+        }
+
+      for (j = 0; j < G_N_ELEMENTS (all_renderers); j++)
+        {
+          if (!renderer_selected (all_renderers[j].name))
+            continue;
+
+          if (!benchmark_node (argv[i], node, all_renderers[j].name, all_renderers[j].create_func))
+            success = FALSE;
+        }
+
+      gsk_render_node_unref (node);
+    }
+
+  g_strfreev (renderers);
+
+  return success ? 0 : 1;
+}
@@ -47,6 +47,7 @@ static char *arg_output_dir = NULL;
 static char *arg_base_dir = NULL;
 static char *arg_direction = NULL;
 static char *arg_compare_dir = NULL;
+static int arg_jobs = 1;
 
 static const GOptionEntry test_args[] = {
   { "output",         'o', 0, G_OPTION_ARG_FILENAME, &arg_output_dir,
@@ -57,6 +58,8 @@ static const GOptionEntry test_args[] = {
     "Set text direction", "ltr|rtl" },
   { "compare-with",    0, 0, G_OPTION_ARG_FILENAME, &arg_compare_dir,
     "Directory to compare with", "DIR" },
+  { "jobs",           'j', 0, G_OPTION_ARG_INT, &arg_jobs,
+    "Split the tests across N worker processes, 0 for one per core", "N" },
   { NULL }
 };
 
@@ -413,26 +416,20 @@ compare_files (gconstpointer a, gconstpointer b)
 }
 
 static void
-add_test_for_file (GFile *file)
+collect_test_files (GFile     *file,
+                    GPtrArray *tests)
 {
   GFileEnumerator *enumerator;
   GFileInfo *info;
   GList *files;
   GError *error = NULL;
 
-
   if (g_file_query_file_type (file, 0, NULL) != G_FILE_TYPE_DIRECTORY)
     {
-      g_test_add_vtable (g_file_peek_path (file),
-                         0,
-                         g_object_ref (file),
-                         NULL,
-                         (GTestFixtureFunc) test_ui_file,
-                         (GTestFixtureFunc) g_object_unref);
+      g_ptr_array_add (tests, g_object_ref (file));
       return;
     }
 
-
   enumerator = g_file_enumerate_children (file, G_FILE_ATTRIBUTE_STANDARD_NAME, 0, NULL, &error);
   g_assert_no_error (error);
   files = NULL;
@@ -459,10 +456,112 @@ add_test_for_file (GFile *file)
   g_object_unref (enumerator);
 
   files = g_list_sort (files, compare_files);
-  g_list_foreach (files, (GFunc) add_test_for_file, NULL);
+  for (GList *l = files; l; l = l->next)
+    collect_test_files (l->data, tests);
   g_list_free_full (files, g_object_unref);
 }
 
+static void
+add_test_for_file (GFile *file)
+{
+  g_test_add_vtable (g_file_peek_path (file),
+                     0,
+                     g_object_ref (file),
+                     NULL,
+                     (GTestFixtureFunc) test_ui_file,
+                     (GTestFixtureFunc) g_object_unref);
+}
+
+/* Runs the tests in worker processes, each of which runs its share
+ * of the tests in a single process, so that process startup, theme
+ * loading and shader compilation are only paid once per worker.
+ *
+ * The output of each worker is printed when it is done, so that
+ * it doesn't get interleaved.
+ */
+static int
+run_workers (const char *program,
+             const char *basedir,
+             GPtrArray  *tests)
+{
+  GSubprocess **workers;
+  guint n_workers;
+  int result = 0;
+
+  if (arg_jobs > 0)
+    n_workers = arg_jobs;
+  else
+    n_workers = g_get_num_processors ();
+  n_workers = MIN (n_workers, tests->len);
+
+  workers = g_new0 (GSubprocess *, n_workers);
+
+  for (guint i = 0; i < n_workers; i++)
+    {
+      GPtrArray *args;
+      GError *error = NULL;
+
+      args = g_ptr_array_new_with_free_func (g_free);
+      g_ptr_array_add (args, g_strdup (program));
+      g_ptr_array_add (args, g_strdup ("--jobs=1"));
+      g_ptr_array_add (args, g_strdup_printf ("--directory=%s", basedir));
+      if (arg_output_dir)
+        g_ptr_array_add (args, g_strdup_printf ("--output=%s", arg_output_dir));
+      if (arg_direction)
+        g_ptr_array_add (args, g_strdup_printf ("--direction=%s", arg_direction));
+      if (arg_compare_dir)
+        g_ptr_array_add (args, g_strdup_printf ("--compare-with=%s", arg_compare_dir));
+      if (using_tap)
+        g_ptr_array_add (args, g_strdup ("--tap"));
+
+      /* Interleave the tests, so that slow directories get split up */
+      for (guint j = i; j < tests->len; j += n_workers)
+        g_ptr_array_add (args, g_file_get_path (g_ptr_array_index (tests, j)));
+      g_ptr_array_add (args, NULL);
+
+      workers[i] = g_subprocess_newv ((const char * const *) args->pdata,
+                                      G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDERR_MERGE,
+                                      &error);
+      if (workers[i] == NULL)
+        {
+          g_printerr ("Failed to start worker: %s\n", error->message);
+          g_error_free (error);
+          result = 1;
+        }
+
+      g_ptr_array_unref (args);
+    }
+
+  for (guint i = 0; i < n_workers; i++)
+    {
+      char *output = NULL;
+      GError *error = NULL;
+
+      if (workers[i] == NULL)
+        continue;
+
+      if (!g_subprocess_communicate_utf8 (workers[i], NULL, NULL, &output, NULL, &error))
+        {
+          g_printerr ("Failed to run worker: %s\n", error->message);
+          g_error_free (error);
+          result = 1;
+        }
+      else
+        {
+          g_print ("%s", output);
+          if (!g_subprocess_get_successful (workers[i]))
+            result = 1;
+        }
+
+      g_free (output);
+      g_object_unref (workers[i]);
+    }
+
+  g_free (workers);
+
+  return result;
+}
+
 static GLogWriterOutput
 log_writer (GLogLevelFlags   log_level,
             const GLogField *fields,
@@ -517,6 +616,7 @@ int
 main (int argc, char **argv)
 {
   const char *basedir;
+  GPtrArray *tests;
   int result;
 
   if (!parse_command_line (&argc, &argv))
@@ -534,13 +634,15 @@ main (int argc, char **argv)
   else
     basedir = g_test_get_dir (G_TEST_DIST);
 
+  tests = g_ptr_array_new_with_free_func (g_object_unref);
+
   if (argc < 2)
     {
       GFile *dir;
 
       dir = g_file_new_for_path (basedir);
 
-      add_test_for_file (dir);
+      collect_test_files (dir, tests);
 
       g_object_unref (dir);
     }
@@ -552,12 +654,22 @@ main (int argc, char **argv)
         {
           GFile *file = g_file_new_for_commandline_arg (argv[i]);
 
-          add_test_for_file (file);
+          collect_test_files (file, tests);
 
           g_object_unref (file);
         }
     }
 
+  if (arg_jobs != 1 && tests->len > 1)
+    {
+      result = run_workers (argv[0], basedir, tests);
+      g_ptr_array_unref (tests);
+      return result;
+    }
+
+  g_ptr_array_foreach (tests, (GFunc) add_test_for_file, NULL);
+  g_ptr_array_unref (tests);
+
   /* We need to ensure the process' current working directory
    * is the same as the reftest data, because we're using the
    * "file" property of GtkImage as a relative path in builder files.
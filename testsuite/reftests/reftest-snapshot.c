@@ -219,6 +219,25 @@ reftest_uninhibit_snapshot (void)
   inhibit_count--;
 }
 
+/* All snapshots are rendered with the same renderer, so that its
+ * caches and compiled shaders are reused between tests when many
+ * tests run in one process.
+ */
+static GskRenderer *
+get_renderer (GdkDisplay *display)
+{
+  static GdkSurface *surface;
+  static GskRenderer *renderer;
+
+  if (renderer == NULL)
+    {
+      surface = gdk_surface_new_toplevel (display);
+      renderer = gsk_renderer_new_for_surface (surface);
+    }
+
+  return renderer;
+}
+
 static void
 draw_paintable (GdkPaintable *paintable,
                 gpointer      out_texture)
@@ -244,9 +263,7 @@ draw_paintable (GdkPaintable *paintable,
   if (node == NULL)
     return;
 
-  renderer = gtk_native_get_renderer (
-                 gtk_widget_get_native (
-                     gtk_widget_paintable_get_widget (GTK_WIDGET_PAINTABLE (paintable))));
+  renderer = get_renderer (gtk_widget_get_display (gtk_widget_paintable_get_widget (GTK_WIDGET_PAINTABLE (paintable))));
   texture = gsk_renderer_render_texture (renderer,
                                          node,
                                          &GRAPHENE_RECT_INIT (
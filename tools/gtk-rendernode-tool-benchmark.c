@@ -0,0 +1,217 @@
+/*  Copyright 2023 Red Hat, Inc.
+ *
+ * GTK is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation; either version 2 of the
+ * License, or (at your option) any later version.
+ *
+ * GTK is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public
+ * License along with GTK; see the file COPYING.  If not,
+ * see <http://www.gnu.org/licenses/>.
+ */
+
+#include "config.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <glib/gi18n-lib.h>
+#include <glib/gprintf.h>
+#include <glib/gstdio.h>
+#include <gtk/gtk.h>
+#include "gtk-rendernode-tool.h"
+
+typedef struct {
+  const char *name;
+  GskRenderer * (* create) (void);
+} RendererInfo;
+
+static const RendererInfo renderers[] = {
+  { "cairo", gsk_cairo_renderer_new },
+  { "gl", gsk_gl_renderer_new },
+#ifdef GDK_RENDERING_VULKAN
+  { "vulkan", gsk_vulkan_renderer_new },
+#endif
+};
+
+static int
+compare_times (gconstpointer a,
+               gconstpointer b)
+{
+  gint64 ta = *(const gint64 *) a;
+  gint64 tb = *(const gint64 *) b;
+
+  return ta < tb ? -1 : (ta > tb ? 1 : 0);
+}
+
+static gint64
+render_once (GskRenderer   *renderer,
+             GskRenderNode *node)
+{
+  GdkTexture *texture;
+  gint64 start, value;
+
+  start = g_get_monotonic_time ();
+  texture = gsk_renderer_render_texture (renderer, node, NULL);
+  value = g_get_monotonic_time () - start;
+
+  g_object_unref (texture);
+
+  return value;
+}
+
+static void
+benchmark_renderer (const RendererInfo *info,
+                    GskRenderNode      *node,
+                    GdkSurface         *surface,
+                    int                 warmup,
+                    int                 runs)
+{
+  GskRenderer *renderer;
+  GArray *times;
+  gint64 sum = 0;
+  GError *error = NULL;
+  int i;
+
+  renderer = info->create ();
+  if (!gsk_renderer_realize (renderer, surface, &error))
+    {
+      g_print (_("%s: not available: %s\n"), info->name, error->message);
+      g_error_free (error);
+      g_object_unref (renderer);
+      return;
+    }
+
+  /* The first renders compile shaders and fill caches */
+  for (i = 0; i < warmup; i++)
+    render_once (renderer, node);
+
+  times = g_array_sized_new (FALSE, FALSE, sizeof (gint64), runs);
+  for (i = 0; i < runs; i++)
+    {
+      gint64 value = render_once (renderer, node);
+      g_array_append_val (times, value);
+      sum += value;
+    }
+
+  g_array_sort (times, compare_times);
+
+  g_print (_("%s: min %.3f ms, median %.3f ms, mean %.3f ms, max %.3f ms\n"),
+           info->name,
+           g_array_index (times, gint64, 0) / 1000.,
+           g_array_index (times, gint64, times->len / 2) / 1000.,
+           sum / 1000. / times->len,
+           g_array_index (times, gint64, times->len - 1) / 1000.);
+
+  g_array_unref (times);
+
+  gsk_renderer_unrealize (renderer);
+  g_object_unref (renderer);
+}
+
+static void
+file_benchmark (const char *filename,
+                const char *renderer_name,
+                int         warmup,
+                int         runs)
+{
+  GskRenderNode *node;
+  GdkSurface *surface;
+  gboolean found = FALSE;
+
+  node = load_node_file (filename);
+  if (node == NULL)
+    {
+      g_printerr (_("Could not load %s\n"), filename);
+      exit (1);
+    }
+
+  surface = gdk_surface_new_toplevel (gdk_display_get_default ());
+
+  for (unsigned int i = 0; i < G_N_ELEMENTS (renderers); i++)
+    {
+      if (renderer_name != NULL && g_ascii_strcasecmp (renderer_name, renderers[i].name) != 0)
+        continue;
+
+      found = TRUE;
+      benchmark_renderer (&renderers[i], node, surface, warmup, runs);
+    }
+
+  if (!found)
+    {
+      g_printerr (_("Unknown renderer: %s\n"), renderer_name);
+      exit (1);
+    }
+
+  gdk_surface_destroy (surface);
+  gsk_render_node_unref (node);
+}
+
+void
+do_benchmark (int          *argc,
+              const char ***argv)
+{
+  GOptionContext *context;
+  char **filenames = NULL;
+  char *renderer = NULL;
+  int warmup = 2;
+  int runs = 10;
+  const GOptionEntry entries[] = {
+    { "renderer", 0, 0, G_OPTION_ARG_STRING, &renderer, N_("Only benchmark the given renderer"), N_("RENDERER") },
+    { "warmup", 0, 0, G_OPTION_ARG_INT, &warmup, N_("Number of untimed renders before measuring"), N_("COUNT") },
+    { "runs", 0, 0, G_OPTION_ARG_INT, &runs, N_("Number of timed renders"), N_("COUNT") },
+    { G_OPTION_REMAINING, 0, 0, G_OPTION_ARG_FILENAME_ARRAY, &filenames, NULL, N_("FILE") },
+    { NULL, }
+  };
+  GError *error = NULL;
+
+  if (gdk_display_get_default () == NULL)
+    {
+      g_printerr (_("Could not initialize windowing system\n"));
+      exit (1);
+    }
+
+  g_set_prgname ("gtk4-rendernode-tool benchmark");
+  context = g_option_context_new (NULL);
+  g_option_context_set_translation_domain (context, GETTEXT_PACKAGE);
+  g_option_context_add_main_entries (context, entries, NULL);
+  g_option_context_set_summary (context, _("Benchmark rendering a .node file."));
+
+  if (!g_option_context_parse (context, argc, (char ***)argv, &error))
+    {
+      g_printerr ("%s\n", error->message);
+      g_error_free (error);
+      exit (1);
+    }
+
+  g_option_context_free (context);
+
+  if (filenames == NULL)
+    {
+      g_printerr (_("No .node file specified\n"));
+      exit (1);
+    }
+
+  if (g_strv_length (filenames) > 1)
+    {
+      g_printerr (_("Can only accept a single .node file\n"));
+      exit (1);
+    }
+
+  if (warmup < 0 || runs < 1)
+    {
+      g_printerr (_("Invalid number of renders\n"));
+      exit (1);
+    }
+
+  file_benchmark (filenames[0], renderer, warmup, runs);
+
+  g_strfreev (filenames);
+  g_free (renderer);
+}
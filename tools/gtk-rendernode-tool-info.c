@@ -32,6 +32,7 @@
 static void
 count_nodes (GskRenderNode *node,
              unsigned int  *counts,
+             GHashTable    *textures,
              unsigned int  *depth)
 {
   unsigned int d, dd;
@@ -44,7 +45,7 @@ count_nodes (GskRenderNode *node,
     case GSK_CONTAINER_NODE:
       for (unsigned int i = 0; i < gsk_container_node_get_n_children (node); i++)
         {
-          count_nodes (gsk_container_node_get_child (node, i), counts, &dd);
+          count_nodes (gsk_container_node_get_child (node, i), counts, textures, &dd);
           d = MAX (d, dd);
         }
       break;
@@ -57,85 +58,89 @@ count_nodes (GskRenderNode *node,
     case GSK_REPEATING_RADIAL_GRADIENT_NODE:
     case GSK_CONIC_GRADIENT_NODE:
     case GSK_BORDER_NODE:
-    case GSK_TEXTURE_NODE:
     case GSK_INSET_SHADOW_NODE:
     case GSK_OUTSET_SHADOW_NODE:
       break;
 
     case GSK_TRANSFORM_NODE:
-      count_nodes (gsk_transform_node_get_child (node), counts, &d);
+      count_nodes (gsk_transform_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_OPACITY_NODE:
-      count_nodes (gsk_opacity_node_get_child (node), counts, &d);
+      count_nodes (gsk_opacity_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_COLOR_MATRIX_NODE:
-      count_nodes (gsk_color_matrix_node_get_child (node), counts, &d);
+      count_nodes (gsk_color_matrix_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_REPEAT_NODE:
-      count_nodes (gsk_repeat_node_get_child (node), counts, &d);
+      count_nodes (gsk_repeat_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_CLIP_NODE:
-      count_nodes (gsk_clip_node_get_child (node), counts, &d);
+      count_nodes (gsk_clip_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_ROUNDED_CLIP_NODE:
-      count_nodes (gsk_rounded_clip_node_get_child (node), counts, &d);
+      count_nodes (gsk_rounded_clip_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_SHADOW_NODE:
-      count_nodes (gsk_shadow_node_get_child (node), counts, &d);
+      count_nodes (gsk_shadow_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_BLEND_NODE:
-      count_nodes (gsk_blend_node_get_bottom_child (node), counts, &d);
-      count_nodes (gsk_blend_node_get_top_child (node), counts, &dd);
+      count_nodes (gsk_blend_node_get_bottom_child (node), counts, textures, &d);
+      count_nodes (gsk_blend_node_get_top_child (node), counts, textures, &dd);
       d = MAX (d, dd);
       break;
 
     case GSK_CROSS_FADE_NODE:
-      count_nodes (gsk_cross_fade_node_get_start_child (node), counts, &d);
-      count_nodes (gsk_cross_fade_node_get_end_child (node), counts, &dd);
+      count_nodes (gsk_cross_fade_node_get_start_child (node), counts, textures, &d);
+      count_nodes (gsk_cross_fade_node_get_end_child (node), counts, textures, &dd);
       d = MAX (d, dd);
       break;
 
     case GSK_TEXT_NODE:
       break;
 
+    case GSK_TEXTURE_NODE:
+      g_hash_table_add (textures, gsk_texture_node_get_texture (node));
+      break;
+
     case GSK_BLUR_NODE:
-      count_nodes (gsk_blur_node_get_child (node), counts, &d);
+      count_nodes (gsk_blur_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_DEBUG_NODE:
-      count_nodes (gsk_debug_node_get_child (node), counts, &d);
+      count_nodes (gsk_debug_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_GL_SHADER_NODE:
       for (unsigned int i = 0; i < gsk_gl_shader_node_get_n_children (node); i++)
         {
-          count_nodes (gsk_gl_shader_node_get_child (node, i), counts, &dd);
+          count_nodes (gsk_gl_shader_node_get_child (node, i), counts, textures, &dd);
           d = MAX (d, dd);
         }
       break;
 
     case GSK_TEXTURE_SCALE_NODE:
+      g_hash_table_add (textures, gsk_texture_scale_node_get_texture (node));
       break;
 
     case GSK_MASK_NODE:
-      count_nodes (gsk_mask_node_get_source (node), counts, &d);
-      count_nodes (gsk_mask_node_get_mask (node), counts, &dd);
+      count_nodes (gsk_mask_node_get_source (node), counts, textures, &d);
+      count_nodes (gsk_mask_node_get_mask (node), counts, textures, &dd);
       d = MAX (d, dd);
       break;
 
     case GSK_FILL_NODE:
-      count_nodes (gsk_fill_node_get_child (node), counts, &d);
+      count_nodes (gsk_fill_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_STROKE_NODE:
-      count_nodes (gsk_stroke_node_get_child (node), counts, &d);
+      count_nodes (gsk_stroke_node_get_child (node), counts, textures, &d);
       break;
 
     case GSK_NOT_A_RENDER_NODE:
@@ -161,23 +166,78 @@ get_node_name (GskRenderNodeType type)
   return name;
 }
 
+/* Nodes that the GPU renderers render via an offscreen, at
+ * least in the general case
+ */
+static gboolean
+needs_offscreen (GskRenderNodeType type)
+{
+  switch (type)
+    {
+    case GSK_OPACITY_NODE:
+    case GSK_COLOR_MATRIX_NODE:
+    case GSK_REPEAT_NODE:
+    case GSK_SHADOW_NODE:
+    case GSK_BLEND_NODE:
+    case GSK_CROSS_FADE_NODE:
+    case GSK_BLUR_NODE:
+    case GSK_GL_SHADER_NODE:
+    case GSK_MASK_NODE:
+    case GSK_FILL_NODE:
+    case GSK_STROKE_NODE:
+      return TRUE;
+
+    default:
+      return FALSE;
+    }
+}
+
+/* Assumes 4 bytes per pixel, which is what most textures
+ * get uploaded as
+ */
+static gsize
+get_texture_memory (GHashTable *textures)
+{
+  GHashTableIter iter;
+  gpointer texture;
+  gsize size = 0;
+
+  g_hash_table_iter_init (&iter, textures);
+  while (g_hash_table_iter_next (&iter, &texture, NULL))
+    size += (gsize) gdk_texture_get_width (texture) * gdk_texture_get_height (texture) * 4;
+
+  return size;
+}
+
 static void
 file_info (const char *filename)
 {
   GskRenderNode *node;
-  unsigned int counts[GSK_MASK_NODE + 1] = { 0, };
+  unsigned int counts[GSK_STROKE_NODE + 1] = { 0, };
   unsigned int total = 0;
+  unsigned int offscreens = 0;
   unsigned int namelen = 0;
   unsigned int depth = 0;
+  GHashTable *textures;
   graphene_rect_t bounds;
+  char *size;
 
   node = load_node_file (filename);
+  if (node == NULL)
+    {
+      g_printerr (_("Could not load %s\n"), filename);
+      exit (1);
+    }
+
+  textures = g_hash_table_new (NULL, NULL);
 
-  count_nodes (node, counts, &depth);
+  count_nodes (node, counts, textures, &depth);
 
   for (unsigned int i = 0; i < G_N_ELEMENTS (counts); i++)
     {
       total += counts[i];
+      if (needs_offscreen (i))
+        offscreens += counts[i];
       if (counts[i] > 0)
         namelen = MAX (namelen, strlen (get_node_name (i)));
     }
@@ -191,6 +251,18 @@ file_info (const char *filename)
 
   g_print (_("Depth: %u\n"), depth);
 
+  g_print (_("Nodes that may need offscreens: %u\n"), offscreens);
+  for (unsigned int i = 0; i < G_N_ELEMENTS (counts); i++)
+    {
+      if (counts[i] > 0 && needs_offscreen (i))
+        g_print ("  %*s: %u\n", namelen, get_node_name (i), counts[i]);
+    }
+
+  size = g_format_size (get_texture_memory (textures));
+  g_print (_("Textures: %u, %s\n"), g_hash_table_size (textures), size);
+  g_free (size);
+  g_hash_table_unref (textures);
+
   gsk_render_node_get_bounds (node, &bounds);
   g_print (_("Bounds: %g x %g\n"), bounds.size.width, bounds.size.height);
   g_print (_("Origin: %g %g\n"), bounds.origin.x, bounds.origin.y);